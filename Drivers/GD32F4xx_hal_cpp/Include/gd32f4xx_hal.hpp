@@ -0,0 +1,84 @@
+/*!
+    \file    gd32f4xx_hal.hpp
+    \brief   C++ template layer for the GPIO, USART, SPI, TIMER and DMA
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_HPP
+#define GD32F4XX_HAL_HPP
+
+#include "gd32f4xx_hal_reg.hpp"
+#include "gd32f4xx_hal_map.hpp"
+#include "gd32f4xx_hal_gpio.hpp"
+#include "gd32f4xx_hal_dma.hpp"
+#include "gd32f4xx_hal_usart.hpp"
+#include "gd32f4xx_hal_spi.hpp"
+#include "gd32f4xx_hal_timer.hpp"
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/*!
+    \brief      the pins and DMA channels of an application in one list: it does not compile
+                when a pin is given two functions or a DMA channel two requests
+    \param[in]  Uses: PinSetting<Pin, Mode>, peripheral pins such as Usart<0>::Tx<Pin<PortA, 9>>
+                and DMA channels such as Usart<0>::TxDma<DmaStream<1, 7>>
+*/
+template <typename... Uses>
+struct Resources {
+    static_assert(detail::pins_unique<Uses...>(), "a pin is assigned twice");
+    static_assert(detail::streams_unique<Uses...>(), "a DMA channel is assigned twice");
+
+    /* the GPIO ports of the pins */
+    static constexpr uint32_t port_clocks = (0U | ... | ((0xFFFFFFFFU != detail::PinUse<Uses>::key) ?
+                                                         (1UL << detail::PinUse<Uses>::port) : 0U));
+    /* the DMA controllers of the channels */
+    static constexpr uint32_t dma_clocks = (0U | ... | detail::StreamUse<Uses>::clock.mask);
+
+    /* enable the clocks of the GPIO ports and DMA controllers, one read-modify-write */
+    static void clock_enable()
+    {
+        reg_modify(rcu_base + rcu_reg::ahb1en, 0U, port_clocks | dma_clocks);
+    }
+
+    /* configure all pins, one read-modify-write per register of each port */
+    static void configure()
+    {
+        hal::configure<Uses...>();
+    }
+};
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#endif /* GD32F4XX_HAL_HPP */
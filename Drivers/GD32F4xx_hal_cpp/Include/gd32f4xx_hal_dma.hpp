@@ -0,0 +1,207 @@
+/*!
+    \file    gd32f4xx_hal_dma.hpp
+    \brief   DMA channels of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_DMA_HPP
+#define GD32F4XX_HAL_DMA_HPP
+
+#include "gd32f4xx_hal_reg.hpp"
+#include "gd32f4xx_hal_map.hpp"
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* DMA channel control bits */
+namespace dma_ctl
+{
+constexpr uint32_t chen = 1UL << 0;
+constexpr uint32_t htfie = 1UL << 3;
+constexpr uint32_t ftfie = 1UL << 4;
+constexpr uint32_t periph_to_memory = 0UL << 6;
+constexpr uint32_t memory_to_periph = 1UL << 6;
+constexpr uint32_t cmen = 1UL << 8;
+constexpr uint32_t mnaga = 1UL << 10;
+constexpr uint32_t pwidth_16bit = 1UL << 11;
+constexpr uint32_t pwidth_32bit = 2UL << 11;
+constexpr uint32_t mwidth_16bit = 1UL << 13;
+constexpr uint32_t mwidth_32bit = 2UL << 13;
+constexpr uint32_t prio_low = 0UL << 16;
+constexpr uint32_t prio_medium = 1UL << 16;
+constexpr uint32_t prio_high = 2UL << 16;
+constexpr uint32_t prio_ultra_high = 3UL << 16;
+
+/* the data width fields of an element type */
+template <typename T>
+constexpr uint32_t width()
+{
+    static_assert((1U == sizeof(T)) || (2U == sizeof(T)) || (4U == sizeof(T)), "DMA elements are 8, 16 or 32 bits");
+    return (1U == sizeof(T)) ? 0U : ((2U == sizeof(T)) ? (pwidth_16bit | mwidth_16bit) : (pwidth_32bit | mwidth_32bit));
+}
+}
+
+/* DMA channel flags, shifted to the channel by DmaStream::flag_shift */
+namespace dma_flag
+{
+constexpr uint32_t feeif = 1UL << 0;
+constexpr uint32_t sdeif = 1UL << 2;
+constexpr uint32_t taeif = 1UL << 3;
+constexpr uint32_t htfif = 1UL << 4;
+constexpr uint32_t ftfif = 1UL << 5;
+constexpr uint32_t all = feeif | sdeif | taeif | htfif | ftfif;
+}
+
+/* a DMA channel, DmaStream<1, 7> is DMA1 channel 7 */
+template <unsigned Dma, unsigned Channel>
+struct DmaStream {
+    static_assert(Dma < 2U, "DMA0 or DMA1");
+    static_assert(Channel < 8U, "DMA channels are 0 to 7");
+
+    static constexpr unsigned dma = Dma;
+    static constexpr unsigned channel = Channel;
+    static constexpr uint32_t base = dma_base + 0x400U * Dma;
+    static constexpr ClockGate clock = {rcu_reg::ahb1en, 1UL << (21U + Dma)};
+
+    static constexpr uint32_t chctl = base + 0x10U + 0x18U * Channel;
+    static constexpr uint32_t chcnt = base + 0x14U + 0x18U * Channel;
+    static constexpr uint32_t chpaddr = base + 0x18U + 0x18U * Channel;
+    static constexpr uint32_t chm0addr = base + 0x1CU + 0x18U * Channel;
+    static constexpr uint32_t chm1addr = base + 0x20U + 0x18U * Channel;
+    static constexpr uint32_t chfctl = base + 0x24U + 0x18U * Channel;
+    /* channels 0 to 3 in INTF0/INTC0, 4 to 7 in INTF1/INTC1 */
+    static constexpr uint32_t intf = base + ((Channel < 4U) ? 0x00U : 0x04U);
+    static constexpr uint32_t intc = base + ((Channel < 4U) ? 0x08U : 0x0CU);
+    static constexpr unsigned flag_shift = 6U * (Channel & 3U) + 4U * ((Channel >> 1U) & 1U);
+
+    /*!
+        \brief      start a transfer, the channel must be disabled
+        \param[in]  ctl: CHCTL value without CHEN, a constant built by the peripheral
+        \param[in]  periph_addr: peripheral register address
+        \param[in]  memory: memory address
+        \param[in]  count: number of elements
+        \param[out] none
+        \retval     none
+    */
+    static void start(uint32_t ctl, uint32_t periph_addr, const volatile void *memory, uint16_t count)
+    {
+        reg_write(intc, dma_flag::all << flag_shift);
+        reg_write(chpaddr, periph_addr);
+        reg_write(chm0addr, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(memory)));
+        reg_write(chcnt, count);
+        reg_write(chctl, ctl | dma_ctl::chen);
+    }
+
+    /* disable the channel and wait until a burst in progress has finished */
+    static void stop()
+    {
+        reg_modify(chctl, dma_ctl::chen, 0U);
+        reg_wait_clear(chctl, dma_ctl::chen);
+    }
+
+    static bool enabled()
+    {
+        return 0U != (reg_read(chctl) & dma_ctl::chen);
+    }
+
+    /* elements not transferred yet */
+    static uint16_t remaining()
+    {
+        return static_cast<uint16_t>(reg_read(chcnt));
+    }
+
+    /* get the dma_flag bits of the channel */
+    static uint32_t flags()
+    {
+        return (reg_read(intf) >> flag_shift) & dma_flag::all;
+    }
+
+    static void flags_clear(uint32_t flag)
+    {
+        reg_write(intc, (flag & dma_flag::all) << flag_shift);
+    }
+
+    static void clock_enable()
+    {
+        hal::clock_enable<DmaStream>();
+    }
+};
+
+/*!
+    \brief      a DMA channel serving a request of a peripheral, the sub-peripheral is looked
+                up at compile time and a channel that does not serve the request does not compile
+*/
+template <PeriphId Periph, Signal S, typename StreamT>
+struct DmaBinding {
+    static constexpr int subperi = dma_lookup(Periph, S, StreamT::dma, StreamT::channel);
+    static_assert(subperi >= 0, "the DMA channel does not serve this request of the peripheral");
+
+    using stream = StreamT;
+    static constexpr PeriphId periph = Periph;
+    static constexpr Signal signal = S;
+    /* the PERIEN field of CHCTL */
+    static constexpr uint32_t perien = static_cast<uint32_t>((subperi < 0) ? 0 : subperi) << 25U;
+};
+
+namespace detail
+{
+/* the DMA part of a resource, a resource without a channel has the key ~0 */
+template <typename U, typename = void>
+struct StreamUse {
+    static constexpr uint32_t key = 0xFFFFFFFFU;
+    static constexpr ClockGate clock = {rcu_reg::ahb1en, 0U};
+};
+
+template <typename U>
+struct StreamUse<U, std::void_t<typename U::stream>> {
+    static constexpr uint32_t key = U::stream::dma * 8U + U::stream::channel;
+    static constexpr ClockGate clock = U::stream::clock;
+};
+
+template <typename... Uses>
+constexpr bool streams_unique()
+{
+    constexpr uint32_t key[] = {StreamUse<Uses>::key..., 0xFFFFFFFFU};
+
+    return keys_unique(key);
+}
+} /* namespace detail */
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#ifdef GD32F4XX_H
+static_assert(gd32f4xx::hal::DmaStream<1U, 7U>::chctl == (DMA1 + 0x10U + 0x18U * 7U), "DMA1 channel 7 address");
+#endif /* GD32F4XX_H */
+
+#endif /* GD32F4XX_HAL_DMA_HPP */
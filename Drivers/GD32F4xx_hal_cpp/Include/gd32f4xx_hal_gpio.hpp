@@ -0,0 +1,426 @@
+/*!
+    \file    gd32f4xx_hal_gpio.hpp
+    \brief   GPIO pins and pin groups of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_GPIO_HPP
+#define GD32F4XX_HAL_GPIO_HPP
+
+#include "gd32f4xx_hal_reg.hpp"
+#include "gd32f4xx_hal_map.hpp"
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* GPIO registers */
+namespace gpio_reg
+{
+constexpr uint32_t ctl = 0x00U;
+constexpr uint32_t omode = 0x04U;
+constexpr uint32_t ospd = 0x08U;
+constexpr uint32_t pud = 0x0CU;
+constexpr uint32_t istat = 0x10U;
+constexpr uint32_t octl = 0x14U;
+constexpr uint32_t bop = 0x18U;
+constexpr uint32_t afsel0 = 0x20U;
+constexpr uint32_t afsel1 = 0x24U;
+constexpr uint32_t tg = 0x2CU;
+}
+
+constexpr unsigned gpio_port_num = 9U;
+
+/* GPIO port, 0 for port A to 8 for port I */
+template <unsigned Index>
+struct Port {
+    static_assert(Index < gpio_port_num, "GPIO ports are A to I");
+
+    static constexpr unsigned index = Index;
+    static constexpr uint32_t base = gpio_base + 0x400U * Index;
+    static constexpr ClockGate clock = {rcu_reg::ahb1en, 1UL << Index};
+};
+
+using PortA = Port<0U>;
+using PortB = Port<1U>;
+using PortC = Port<2U>;
+using PortD = Port<3U>;
+using PortE = Port<4U>;
+using PortF = Port<5U>;
+using PortG = Port<6U>;
+using PortH = Port<7U>;
+using PortI = Port<8U>;
+
+/* pin configuration, the values are the register fields */
+enum class Mode : uint32_t { Input = 0U, Output = 1U, Af = 2U, Analog = 3U };
+enum class Pull : uint32_t { None = 0U, Up = 1U, Down = 2U };
+enum class OType : uint32_t { PushPull = 0U, OpenDrain = 1U };
+enum class Speed : uint32_t { Low = 0U, Medium = 1U, High = 2U, Max = 3U };    /*!< 2MHz, 25MHz, 50MHz, 200MHz */
+
+template <Mode M, Pull P = Pull::None, OType OT = OType::PushPull, Speed S = Speed::Low, unsigned Af = 0U>
+struct PinMode {
+    static_assert(Af < 16U, "alternate functions are 0 to 15");
+
+    static constexpr Mode mode = M;
+    static constexpr Pull pull = P;
+    static constexpr OType otype = OT;
+    static constexpr Speed speed = S;
+    static constexpr unsigned af = Af;
+};
+
+using Input = PinMode<Mode::Input>;
+using InputPullUp = PinMode<Mode::Input, Pull::Up>;
+using InputPullDown = PinMode<Mode::Input, Pull::Down>;
+using Analog = PinMode<Mode::Analog>;
+template <Speed S = Speed::High, OType OT = OType::PushPull>
+using Output = PinMode<Mode::Output, Pull::None, OT, S>;
+template <unsigned Af, Pull P = Pull::None, OType OT = OType::PushPull, Speed S = Speed::High>
+using AltFn = PinMode<Mode::Af, P, OT, S, Af>;
+
+/* a pin with the mode it is configured to, the unit of configure() and Resources */
+template <typename PinT, typename ModeT>
+struct PinSetting {
+    using pin = PinT;
+    using mode = ModeT;
+};
+
+namespace detail
+{
+/* the pin part of a resource, a resource without a pin has the key ~0 */
+template <typename U, typename = void>
+struct PinUse {
+    static constexpr uint32_t key = 0xFFFFFFFFU;
+    static constexpr unsigned port = gpio_port_num;
+    static constexpr unsigned number = 0U;
+    static constexpr uint32_t mode = 0U, pull = 0U, otype = 0U, speed = 0U, af = 0U;
+    static constexpr bool drives = false;
+};
+
+template <typename U>
+struct PinUse<U, std::void_t<typename U::pin, typename U::mode>> {
+    static constexpr unsigned port = U::pin::port::index;
+    static constexpr unsigned number = U::pin::number;
+    static constexpr uint32_t key = port * 16U + number;
+    static constexpr uint32_t mode = static_cast<uint32_t>(U::mode::mode);
+    static constexpr uint32_t pull = static_cast<uint32_t>(U::mode::pull);
+    static constexpr uint32_t otype = static_cast<uint32_t>(U::mode::otype);
+    static constexpr uint32_t speed = static_cast<uint32_t>(U::mode::speed);
+    static constexpr uint32_t af = U::mode::af;
+    /* the output type and speed only matter for outputs, inputs leave the registers alone */
+    static constexpr bool drives = (U::mode::mode == Mode::Output) || (U::mode::mode == Mode::Af);
+};
+
+/* the register fields of the pins on one port, constants folded from the list of settings */
+template <unsigned P, typename... Uses>
+struct PortFields {
+    template <typename U>
+    static constexpr bool on = (P == PinUse<U>::port);
+    template <typename U>
+    static constexpr uint32_t field2 = 3UL << (2U * PinUse<U>::number);
+
+    static constexpr uint32_t pins = (0U | ... | (on<Uses> ? (1UL << PinUse<Uses>::number) : 0U));
+
+    static constexpr uint32_t ctl_clear = (0U | ... | (on<Uses> ? field2<Uses> : 0U));
+    static constexpr uint32_t ctl_set = (0U | ... | (on<Uses> ? (PinUse<Uses>::mode << (2U * PinUse<Uses>::number)) : 0U));
+    static constexpr uint32_t pud_set = (0U | ... | (on<Uses> ? (PinUse<Uses>::pull << (2U * PinUse<Uses>::number)) : 0U));
+
+    template <typename U>
+    static constexpr bool drives = on<U> && PinUse<U>::drives;
+    static constexpr uint32_t omode_clear = (0U | ... | (drives<Uses> ? (1UL << PinUse<Uses>::number) : 0U));
+    static constexpr uint32_t omode_set = (0U | ... | (drives<Uses> ? (PinUse<Uses>::otype << PinUse<Uses>::number) : 0U));
+    static constexpr uint32_t ospd_clear = (0U | ... | (drives<Uses> ? field2<Uses> : 0U));
+    static constexpr uint32_t ospd_set = (0U | ... | (drives<Uses> ? (PinUse<Uses>::speed << (2U * PinUse<Uses>::number)) : 0U));
+
+    /* the AF selection is written for alternate function pins only */
+    template <typename U>
+    static constexpr bool alt = on<U> && (static_cast<uint32_t>(Mode::Af) == PinUse<U>::mode);
+    template <typename U>
+    static constexpr unsigned af_shift = 4U * (PinUse<U>::number & 7U);
+    static constexpr uint32_t afsel0_clear = (0U | ... | ((alt<Uses> && (PinUse<Uses>::number < 8U)) ? (0xFUL << af_shift<Uses>) : 0U));
+    static constexpr uint32_t afsel0_set = (0U | ... | ((alt<Uses> && (PinUse<Uses>::number < 8U)) ? (PinUse<Uses>::af << af_shift<Uses>) : 0U));
+    static constexpr uint32_t afsel1_clear = (0U | ... | ((alt<Uses> && (PinUse<Uses>::number >= 8U)) ? (0xFUL << af_shift<Uses>) : 0U));
+    static constexpr uint32_t afsel1_set = (0U | ... | ((alt<Uses> && (PinUse<Uses>::number >= 8U)) ? (PinUse<Uses>::af << af_shift<Uses>) : 0U));
+};
+
+/* call f(std::integral_constant<unsigned, P>) for every GPIO port */
+template <typename F, unsigned... P>
+inline void for_each_port(F &&f, std::integer_sequence<unsigned, P...>)
+{
+    (f(std::integral_constant<unsigned, P>{}), ...);
+}
+
+template <typename F>
+inline void for_each_port(F &&f)
+{
+    for_each_port(static_cast<F &&>(f), std::make_integer_sequence<unsigned, gpio_port_num>{});
+}
+
+template <typename... Uses>
+constexpr bool pins_unique()
+{
+    constexpr uint32_t key[] = {PinUse<Uses>::key..., 0xFFFFFFFFU};
+
+    return keys_unique(key);
+}
+} /* namespace detail */
+
+/*!
+    \brief      configure pins, every register of a port is changed by one read-modify-write
+                with constant masks: the AF selection, output type, speed and pull first, the
+                mode last, so that a pin never drives with the previous alternate function
+    \param[in]  Uses: PinSetting<Pin, Mode> or peripheral pin types, other resources are skipped
+    \param[out] none
+    \retval     none
+*/
+template <typename... Uses>
+inline void configure()
+{
+    static_assert(detail::pins_unique<Uses...>(), "a pin is configured twice");
+
+    detail::for_each_port([](auto port) {
+        using F = detail::PortFields<decltype(port)::value, Uses...>;
+        constexpr uint32_t base = gpio_base + 0x400U * decltype(port)::value;
+
+        if constexpr(0U != F::pins) {
+            reg_modify(base + gpio_reg::afsel0, F::afsel0_clear, F::afsel0_set);
+            reg_modify(base + gpio_reg::afsel1, F::afsel1_clear, F::afsel1_set);
+            reg_modify(base + gpio_reg::omode, F::omode_clear, F::omode_set);
+            reg_modify(base + gpio_reg::ospd, F::ospd_clear, F::ospd_set);
+            reg_modify(base + gpio_reg::pud, F::ctl_clear, F::pud_set);
+            reg_modify(base + gpio_reg::ctl, F::ctl_clear, F::ctl_set);
+        }
+    });
+}
+
+/* a pin, Pin<PortB, 10> */
+template <typename PortT, unsigned Number>
+struct Pin {
+    static_assert(Number < 16U, "pins are 0 to 15");
+
+    using port = PortT;
+    static constexpr unsigned number = Number;
+    static constexpr uint32_t mask = 1UL << Number;
+
+    /* drive the pin high */
+    static void set()
+    {
+        reg_write(PortT::base + gpio_reg::bop, mask);
+    }
+
+    /* drive the pin low */
+    static void clear()
+    {
+        reg_write(PortT::base + gpio_reg::bop, mask << 16U);
+    }
+
+    /* drive the pin high or low */
+    static void write(bool high)
+    {
+        reg_write(PortT::base + gpio_reg::bop, high ? mask : (mask << 16U));
+    }
+
+    /* invert the output */
+    static void toggle()
+    {
+        reg_write(PortT::base + gpio_reg::tg, mask);
+    }
+
+    /* the input level */
+    static bool read()
+    {
+        return 0U != (reg_read(PortT::base + gpio_reg::istat) & mask);
+    }
+
+    /* the driven level */
+    static bool output()
+    {
+        return 0U != (reg_read(PortT::base + gpio_reg::octl) & mask);
+    }
+
+    template <typename ModeT>
+    static void configure()
+    {
+        hal::configure<PinSetting<Pin, ModeT>>();
+    }
+
+    static void clock_enable()
+    {
+        hal::clock_enable<PortT>();
+    }
+};
+
+/* pins handled together, one register access per port for each operation */
+template <typename... Pins>
+struct PinGroup {
+    static_assert(sizeof...(Pins) > 0U, "a group has at least one pin");
+    static_assert(sizeof...(Pins) <= 32U, "a group has at most 32 pins");
+    static_assert(detail::pins_unique<PinSetting<Pins, Input>...>(), "a pin appears twice in the group");
+
+    static constexpr size_t size = sizeof...(Pins);
+
+    /* the pins of the group on a port */
+    template <unsigned P>
+    static constexpr uint32_t port_mask = (0U | ... | ((P == Pins::port::index) ? Pins::mask : 0U));
+
+    /* drive all pins high */
+    static void set()
+    {
+        detail::for_each_port([](auto port) {
+            constexpr unsigned p = decltype(port)::value;
+
+            if constexpr(0U != port_mask<p>) {
+                reg_write(gpio_base + 0x400U * p + gpio_reg::bop, port_mask<p>);
+            }
+        });
+    }
+
+    /* drive all pins low */
+    static void clear()
+    {
+        detail::for_each_port([](auto port) {
+            constexpr unsigned p = decltype(port)::value;
+
+            if constexpr(0U != port_mask<p>) {
+                reg_write(gpio_base + 0x400U * p + gpio_reg::bop, port_mask<p> << 16U);
+            }
+        });
+    }
+
+    /* invert all outputs */
+    static void toggle()
+    {
+        detail::for_each_port([](auto port) {
+            constexpr unsigned p = decltype(port)::value;
+
+            if constexpr(0U != port_mask<p>) {
+                reg_write(gpio_base + 0x400U * p + gpio_reg::tg, port_mask<p>);
+            }
+        });
+    }
+
+    /*!
+        \brief      drive the pins, the pins of a port change in the same cycle
+        \param[in]  value: bit i is the level of the i-th pin of the group
+        \param[out] none
+        \retval     none
+    */
+    static void write(uint32_t value)
+    {
+        write_ports(value, std::make_index_sequence<sizeof...(Pins)>{});
+    }
+
+    /* drive the pins with a constant, one constant BOP write per port */
+    template <uint32_t Value>
+    static void write()
+    {
+        write_ports(Value, std::make_index_sequence<sizeof...(Pins)>{});
+    }
+
+    /*!
+        \brief      read the input levels, one ISTAT read per port
+        \param[in]  none
+        \param[out] none
+        \retval     bit i is the level of the i-th pin of the group
+    */
+    static uint32_t read()
+    {
+        return read_ports(std::make_index_sequence<sizeof...(Pins)>{});
+    }
+
+    template <typename ModeT>
+    static void configure()
+    {
+        hal::configure<PinSetting<Pins, ModeT>...>();
+    }
+
+    static void clock_enable()
+    {
+        hal::clock_enable<typename Pins::port...>();
+    }
+
+private:
+    template <size_t... I>
+    static void write_ports(uint32_t value, std::index_sequence<I...>)
+    {
+        detail::for_each_port([value](auto port) {
+            constexpr unsigned p = decltype(port)::value;
+
+            if constexpr(0U != port_mask<p>) {
+                uint32_t high = (0U | ... | ((p == Pins::port::index) ? (((value >> I) & 1U) << Pins::number) : 0U));
+
+                reg_write(gpio_base + 0x400U * p + gpio_reg::bop, high | ((port_mask<p> & ~high) << 16U));
+            }
+        });
+    }
+
+    template <size_t... I>
+    static uint32_t read_ports(std::index_sequence<I...>)
+    {
+        uint32_t value = 0U;
+
+        detail::for_each_port([&value](auto port) {
+            constexpr unsigned p = decltype(port)::value;
+
+            if constexpr(0U != port_mask<p>) {
+                uint32_t istat = reg_read(gpio_base + 0x400U * p + gpio_reg::istat);
+
+                value |= (0U | ... | ((p == Pins::port::index) ? (((istat >> Pins::number) & 1U) << I) : 0U));
+            }
+        });
+        return value;
+    }
+};
+
+/*!
+    \brief      a pin carrying a signal of a peripheral, the alternate function is looked up at
+                compile time and a pin that cannot carry the signal does not compile
+*/
+template <PeriphId Periph, Signal S, typename PinT, Pull P = Pull::None, OType OT = OType::PushPull, Speed Sp = Speed::High>
+struct AfPin {
+    static constexpr int af_number = af_lookup(Periph, S, PinT::port::index, PinT::number);
+    static_assert(af_number >= 0, "the pin cannot carry this signal of the peripheral");
+
+    using pin = PinT;
+    using mode = AltFn<(af_number < 0) ? 0U : static_cast<unsigned>(af_number), P, OT, Sp>;
+    static constexpr PeriphId periph = Periph;
+    static constexpr Signal signal = S;
+};
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#ifdef GD32F4XX_H
+static_assert(gd32f4xx::hal::PortB::base == GPIOB, "GPIOB base address");
+static_assert(gd32f4xx::hal::PortI::base == GPIOI, "GPIOI base address");
+#endif /* GD32F4XX_H */
+
+#endif /* GD32F4XX_HAL_GPIO_HPP */
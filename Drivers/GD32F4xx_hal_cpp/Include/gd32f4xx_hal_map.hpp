@@ -0,0 +1,256 @@
+/*!
+    \file    gd32f4xx_hal_map.hpp
+    \brief   alternate function and DMA request tables of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_MAP_HPP
+#define GD32F4XX_HAL_MAP_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* peripherals with pins or DMA requests */
+enum class PeriphId : uint8_t {
+    Usart0, Usart1, Usart2, Uart3, Uart4, Usart5, Uart6, Uart7,
+    Spi0, Spi1, Spi2, Spi3, Spi4, Spi5,
+    Timer0, Timer1, Timer2, Timer3, Timer4, Timer5, Timer6, Timer7,
+    Timer8, Timer9, Timer10, Timer11, Timer12, Timer13
+};
+
+/* peripheral signals on pins, and DMA requests */
+enum class Signal : uint8_t {
+    Tx, Rx, Ck, Cts, Rts,                                               /*!< USART */
+    Sck, Miso, Mosi, Nss,                                               /*!< SPI */
+    Ch0, Ch1, Ch2, Ch3, Up                                              /*!< TIMER */
+};
+
+/* alternate function of a signal on a pin */
+struct AfEntry {
+    PeriphId periph;
+    Signal signal;
+    uint8_t port;                                                       /*!< 0 for port A to 8 for port I */
+    uint8_t pin;
+    uint8_t af;
+};
+
+/* DMA channel and sub-peripheral serving a request */
+struct DmaEntry {
+    PeriphId periph;
+    Signal signal;
+    uint8_t dma;
+    uint8_t channel;
+    uint8_t subperi;
+};
+
+namespace detail
+{
+constexpr uint8_t pa = 0U, pb = 1U, pc = 2U, pd = 3U, pe = 4U, pf = 5U, pg = 6U, ph = 7U, pi = 8U;
+} /* namespace detail */
+
+/* alternate functions of the GD32F450 pins, the peripherals of this layer only */
+inline constexpr AfEntry af_table[] = {
+    {PeriphId::Usart0, Signal::Tx, detail::pa, 9U, 7U}, {PeriphId::Usart0, Signal::Tx, detail::pb, 6U, 7U},
+    {PeriphId::Usart0, Signal::Rx, detail::pa, 10U, 7U}, {PeriphId::Usart0, Signal::Rx, detail::pb, 7U, 7U},
+    {PeriphId::Usart0, Signal::Ck, detail::pa, 8U, 7U}, {PeriphId::Usart0, Signal::Cts, detail::pa, 11U, 7U},
+    {PeriphId::Usart0, Signal::Rts, detail::pa, 12U, 7U},
+    {PeriphId::Usart1, Signal::Tx, detail::pa, 2U, 7U}, {PeriphId::Usart1, Signal::Tx, detail::pd, 5U, 7U},
+    {PeriphId::Usart1, Signal::Rx, detail::pa, 3U, 7U}, {PeriphId::Usart1, Signal::Rx, detail::pd, 6U, 7U},
+    {PeriphId::Usart1, Signal::Ck, detail::pa, 4U, 7U}, {PeriphId::Usart1, Signal::Ck, detail::pd, 7U, 7U},
+    {PeriphId::Usart1, Signal::Cts, detail::pa, 0U, 7U}, {PeriphId::Usart1, Signal::Cts, detail::pd, 3U, 7U},
+    {PeriphId::Usart1, Signal::Rts, detail::pa, 1U, 7U}, {PeriphId::Usart1, Signal::Rts, detail::pd, 4U, 7U},
+    {PeriphId::Usart2, Signal::Tx, detail::pb, 10U, 7U}, {PeriphId::Usart2, Signal::Tx, detail::pc, 10U, 7U},
+    {PeriphId::Usart2, Signal::Tx, detail::pd, 8U, 7U},
+    {PeriphId::Usart2, Signal::Rx, detail::pb, 11U, 7U}, {PeriphId::Usart2, Signal::Rx, detail::pc, 11U, 7U},
+    {PeriphId::Usart2, Signal::Rx, detail::pd, 9U, 7U},
+    {PeriphId::Uart3, Signal::Tx, detail::pa, 0U, 8U}, {PeriphId::Uart3, Signal::Tx, detail::pc, 10U, 8U},
+    {PeriphId::Uart3, Signal::Rx, detail::pa, 1U, 8U}, {PeriphId::Uart3, Signal::Rx, detail::pc, 11U, 8U},
+    {PeriphId::Uart4, Signal::Tx, detail::pc, 12U, 8U}, {PeriphId::Uart4, Signal::Rx, detail::pd, 2U, 8U},
+    {PeriphId::Usart5, Signal::Tx, detail::pc, 6U, 8U}, {PeriphId::Usart5, Signal::Tx, detail::pg, 14U, 8U},
+    {PeriphId::Usart5, Signal::Rx, detail::pc, 7U, 8U}, {PeriphId::Usart5, Signal::Rx, detail::pg, 9U, 8U},
+    {PeriphId::Uart6, Signal::Tx, detail::pe, 8U, 8U}, {PeriphId::Uart6, Signal::Tx, detail::pf, 7U, 8U},
+    {PeriphId::Uart6, Signal::Rx, detail::pe, 7U, 8U}, {PeriphId::Uart6, Signal::Rx, detail::pf, 6U, 8U},
+    {PeriphId::Uart7, Signal::Tx, detail::pe, 1U, 8U}, {PeriphId::Uart7, Signal::Rx, detail::pe, 0U, 8U},
+
+    {PeriphId::Spi0, Signal::Sck, detail::pa, 5U, 5U}, {PeriphId::Spi0, Signal::Sck, detail::pb, 3U, 5U},
+    {PeriphId::Spi0, Signal::Miso, detail::pa, 6U, 5U}, {PeriphId::Spi0, Signal::Miso, detail::pb, 4U, 5U},
+    {PeriphId::Spi0, Signal::Mosi, detail::pa, 7U, 5U}, {PeriphId::Spi0, Signal::Mosi, detail::pb, 5U, 5U},
+    {PeriphId::Spi0, Signal::Nss, detail::pa, 4U, 5U}, {PeriphId::Spi0, Signal::Nss, detail::pa, 15U, 5U},
+    {PeriphId::Spi1, Signal::Sck, detail::pb, 10U, 5U}, {PeriphId::Spi1, Signal::Sck, detail::pb, 13U, 5U},
+    {PeriphId::Spi1, Signal::Sck, detail::pd, 3U, 5U}, {PeriphId::Spi1, Signal::Sck, detail::pi, 1U, 5U},
+    {PeriphId::Spi1, Signal::Miso, detail::pb, 14U, 5U}, {PeriphId::Spi1, Signal::Miso, detail::pc, 2U, 5U},
+    {PeriphId::Spi1, Signal::Miso, detail::pi, 2U, 5U},
+    {PeriphId::Spi1, Signal::Mosi, detail::pb, 15U, 5U}, {PeriphId::Spi1, Signal::Mosi, detail::pc, 3U, 5U},
+    {PeriphId::Spi1, Signal::Mosi, detail::pi, 3U, 5U},
+    {PeriphId::Spi1, Signal::Nss, detail::pb, 9U, 5U}, {PeriphId::Spi1, Signal::Nss, detail::pb, 12U, 5U},
+    {PeriphId::Spi1, Signal::Nss, detail::pi, 0U, 5U},
+    {PeriphId::Spi2, Signal::Sck, detail::pb, 3U, 6U}, {PeriphId::Spi2, Signal::Sck, detail::pc, 10U, 6U},
+    {PeriphId::Spi2, Signal::Miso, detail::pb, 4U, 6U}, {PeriphId::Spi2, Signal::Miso, detail::pc, 11U, 6U},
+    {PeriphId::Spi2, Signal::Mosi, detail::pb, 5U, 6U}, {PeriphId::Spi2, Signal::Mosi, detail::pc, 12U, 6U},
+    {PeriphId::Spi2, Signal::Nss, detail::pa, 4U, 6U}, {PeriphId::Spi2, Signal::Nss, detail::pa, 15U, 6U},
+    {PeriphId::Spi3, Signal::Sck, detail::pe, 2U, 5U}, {PeriphId::Spi3, Signal::Sck, detail::pe, 12U, 5U},
+    {PeriphId::Spi3, Signal::Miso, detail::pe, 5U, 5U}, {PeriphId::Spi3, Signal::Miso, detail::pe, 13U, 5U},
+    {PeriphId::Spi3, Signal::Mosi, detail::pe, 6U, 5U}, {PeriphId::Spi3, Signal::Mosi, detail::pe, 14U, 5U},
+    {PeriphId::Spi3, Signal::Nss, detail::pe, 4U, 5U}, {PeriphId::Spi3, Signal::Nss, detail::pe, 11U, 5U},
+    {PeriphId::Spi4, Signal::Sck, detail::pf, 7U, 5U}, {PeriphId::Spi4, Signal::Sck, detail::ph, 6U, 5U},
+    {PeriphId::Spi4, Signal::Miso, detail::pf, 8U, 5U}, {PeriphId::Spi4, Signal::Miso, detail::ph, 7U, 5U},
+    {PeriphId::Spi4, Signal::Mosi, detail::pf, 9U, 5U}, {PeriphId::Spi4, Signal::Mosi, detail::pf, 11U, 5U},
+    {PeriphId::Spi4, Signal::Nss, detail::pf, 6U, 5U}, {PeriphId::Spi4, Signal::Nss, detail::ph, 5U, 5U},
+    {PeriphId::Spi5, Signal::Sck, detail::pg, 13U, 5U}, {PeriphId::Spi5, Signal::Miso, detail::pg, 12U, 5U},
+    {PeriphId::Spi5, Signal::Mosi, detail::pg, 14U, 5U}, {PeriphId::Spi5, Signal::Nss, detail::pg, 8U, 5U},
+
+    {PeriphId::Timer0, Signal::Ch0, detail::pa, 8U, 1U}, {PeriphId::Timer0, Signal::Ch0, detail::pe, 9U, 1U},
+    {PeriphId::Timer0, Signal::Ch1, detail::pa, 9U, 1U}, {PeriphId::Timer0, Signal::Ch1, detail::pe, 11U, 1U},
+    {PeriphId::Timer0, Signal::Ch2, detail::pa, 10U, 1U}, {PeriphId::Timer0, Signal::Ch2, detail::pe, 13U, 1U},
+    {PeriphId::Timer0, Signal::Ch3, detail::pa, 11U, 1U}, {PeriphId::Timer0, Signal::Ch3, detail::pe, 14U, 1U},
+    {PeriphId::Timer1, Signal::Ch0, detail::pa, 0U, 1U}, {PeriphId::Timer1, Signal::Ch0, detail::pa, 5U, 1U},
+    {PeriphId::Timer1, Signal::Ch0, detail::pa, 15U, 1U},
+    {PeriphId::Timer1, Signal::Ch1, detail::pa, 1U, 1U}, {PeriphId::Timer1, Signal::Ch1, detail::pb, 3U, 1U},
+    {PeriphId::Timer1, Signal::Ch2, detail::pa, 2U, 1U}, {PeriphId::Timer1, Signal::Ch2, detail::pb, 10U, 1U},
+    {PeriphId::Timer1, Signal::Ch3, detail::pa, 3U, 1U}, {PeriphId::Timer1, Signal::Ch3, detail::pb, 11U, 1U},
+    {PeriphId::Timer2, Signal::Ch0, detail::pa, 6U, 2U}, {PeriphId::Timer2, Signal::Ch0, detail::pb, 4U, 2U},
+    {PeriphId::Timer2, Signal::Ch0, detail::pc, 6U, 2U},
+    {PeriphId::Timer2, Signal::Ch1, detail::pa, 7U, 2U}, {PeriphId::Timer2, Signal::Ch1, detail::pb, 5U, 2U},
+    {PeriphId::Timer2, Signal::Ch1, detail::pc, 7U, 2U},
+    {PeriphId::Timer2, Signal::Ch2, detail::pb, 0U, 2U}, {PeriphId::Timer2, Signal::Ch2, detail::pc, 8U, 2U},
+    {PeriphId::Timer2, Signal::Ch3, detail::pb, 1U, 2U}, {PeriphId::Timer2, Signal::Ch3, detail::pc, 9U, 2U},
+    {PeriphId::Timer3, Signal::Ch0, detail::pb, 6U, 2U}, {PeriphId::Timer3, Signal::Ch0, detail::pd, 12U, 2U},
+    {PeriphId::Timer3, Signal::Ch1, detail::pb, 7U, 2U}, {PeriphId::Timer3, Signal::Ch1, detail::pd, 13U, 2U},
+    {PeriphId::Timer3, Signal::Ch2, detail::pb, 8U, 2U}, {PeriphId::Timer3, Signal::Ch2, detail::pd, 14U, 2U},
+    {PeriphId::Timer3, Signal::Ch3, detail::pb, 9U, 2U}, {PeriphId::Timer3, Signal::Ch3, detail::pd, 15U, 2U},
+    {PeriphId::Timer4, Signal::Ch0, detail::pa, 0U, 2U}, {PeriphId::Timer4, Signal::Ch0, detail::ph, 10U, 2U},
+    {PeriphId::Timer4, Signal::Ch1, detail::pa, 1U, 2U}, {PeriphId::Timer4, Signal::Ch1, detail::ph, 11U, 2U},
+    {PeriphId::Timer4, Signal::Ch2, detail::pa, 2U, 2U}, {PeriphId::Timer4, Signal::Ch2, detail::ph, 12U, 2U},
+    {PeriphId::Timer4, Signal::Ch3, detail::pa, 3U, 2U}, {PeriphId::Timer4, Signal::Ch3, detail::pi, 0U, 2U},
+    {PeriphId::Timer7, Signal::Ch0, detail::pc, 6U, 3U}, {PeriphId::Timer7, Signal::Ch0, detail::pi, 5U, 3U},
+    {PeriphId::Timer7, Signal::Ch1, detail::pc, 7U, 3U}, {PeriphId::Timer7, Signal::Ch1, detail::pi, 6U, 3U},
+    {PeriphId::Timer7, Signal::Ch2, detail::pc, 8U, 3U}, {PeriphId::Timer7, Signal::Ch2, detail::pi, 7U, 3U},
+    {PeriphId::Timer7, Signal::Ch3, detail::pc, 9U, 3U}, {PeriphId::Timer7, Signal::Ch3, detail::pi, 2U, 3U},
+    {PeriphId::Timer8, Signal::Ch0, detail::pa, 2U, 3U}, {PeriphId::Timer8, Signal::Ch0, detail::pe, 5U, 3U},
+    {PeriphId::Timer8, Signal::Ch1, detail::pa, 3U, 3U}, {PeriphId::Timer8, Signal::Ch1, detail::pe, 6U, 3U}
+};
+
+/* DMA request mapping of the GD32F4xx, the peripherals of this layer only */
+inline constexpr DmaEntry dma_table[] = {
+    {PeriphId::Usart0, Signal::Tx, 1U, 7U, 4U}, {PeriphId::Usart0, Signal::Rx, 1U, 2U, 4U},
+    {PeriphId::Usart0, Signal::Rx, 1U, 5U, 4U},
+    {PeriphId::Usart1, Signal::Tx, 0U, 6U, 4U}, {PeriphId::Usart1, Signal::Rx, 0U, 5U, 4U},
+    {PeriphId::Usart2, Signal::Tx, 0U, 3U, 4U}, {PeriphId::Usart2, Signal::Rx, 0U, 1U, 4U},
+    {PeriphId::Uart3, Signal::Tx, 0U, 4U, 4U}, {PeriphId::Uart3, Signal::Rx, 0U, 2U, 4U},
+    {PeriphId::Uart4, Signal::Tx, 0U, 7U, 4U}, {PeriphId::Uart4, Signal::Rx, 0U, 0U, 4U},
+    {PeriphId::Usart5, Signal::Tx, 1U, 6U, 5U}, {PeriphId::Usart5, Signal::Tx, 1U, 7U, 5U},
+    {PeriphId::Usart5, Signal::Rx, 1U, 1U, 5U}, {PeriphId::Usart5, Signal::Rx, 1U, 2U, 5U},
+
+    {PeriphId::Spi0, Signal::Rx, 1U, 0U, 3U}, {PeriphId::Spi0, Signal::Rx, 1U, 2U, 3U},
+    {PeriphId::Spi0, Signal::Tx, 1U, 3U, 3U}, {PeriphId::Spi0, Signal::Tx, 1U, 5U, 3U},
+    {PeriphId::Spi1, Signal::Rx, 0U, 3U, 0U}, {PeriphId::Spi1, Signal::Tx, 0U, 4U, 0U},
+    {PeriphId::Spi2, Signal::Rx, 0U, 0U, 0U}, {PeriphId::Spi2, Signal::Rx, 0U, 2U, 0U},
+    {PeriphId::Spi2, Signal::Tx, 0U, 5U, 0U}, {PeriphId::Spi2, Signal::Tx, 0U, 7U, 0U},
+    {PeriphId::Spi3, Signal::Rx, 1U, 0U, 4U}, {PeriphId::Spi3, Signal::Rx, 1U, 3U, 5U},
+    {PeriphId::Spi3, Signal::Tx, 1U, 1U, 4U}, {PeriphId::Spi3, Signal::Tx, 1U, 4U, 5U},
+    {PeriphId::Spi4, Signal::Rx, 1U, 3U, 2U}, {PeriphId::Spi4, Signal::Rx, 1U, 5U, 7U},
+    {PeriphId::Spi4, Signal::Tx, 1U, 4U, 2U}, {PeriphId::Spi4, Signal::Tx, 1U, 6U, 7U},
+    {PeriphId::Spi5, Signal::Rx, 1U, 6U, 1U}, {PeriphId::Spi5, Signal::Tx, 1U, 5U, 1U},
+
+    {PeriphId::Timer0, Signal::Up, 1U, 5U, 6U},
+    {PeriphId::Timer0, Signal::Ch0, 1U, 1U, 6U}, {PeriphId::Timer0, Signal::Ch0, 1U, 3U, 6U},
+    {PeriphId::Timer0, Signal::Ch1, 1U, 2U, 6U}, {PeriphId::Timer0, Signal::Ch1, 1U, 6U, 6U},
+    {PeriphId::Timer0, Signal::Ch2, 1U, 6U, 6U}, {PeriphId::Timer0, Signal::Ch3, 1U, 4U, 6U},
+    {PeriphId::Timer1, Signal::Up, 0U, 1U, 3U}, {PeriphId::Timer1, Signal::Up, 0U, 7U, 3U},
+    {PeriphId::Timer1, Signal::Ch0, 0U, 5U, 3U}, {PeriphId::Timer1, Signal::Ch1, 0U, 6U, 3U},
+    {PeriphId::Timer1, Signal::Ch2, 0U, 1U, 3U},
+    {PeriphId::Timer1, Signal::Ch3, 0U, 6U, 3U}, {PeriphId::Timer1, Signal::Ch3, 0U, 7U, 3U},
+    {PeriphId::Timer2, Signal::Up, 0U, 2U, 5U},
+    {PeriphId::Timer2, Signal::Ch0, 0U, 4U, 5U}, {PeriphId::Timer2, Signal::Ch1, 0U, 5U, 5U},
+    {PeriphId::Timer2, Signal::Ch2, 0U, 7U, 5U}, {PeriphId::Timer2, Signal::Ch3, 0U, 2U, 5U},
+    {PeriphId::Timer3, Signal::Up, 0U, 6U, 2U},
+    {PeriphId::Timer3, Signal::Ch0, 0U, 0U, 2U}, {PeriphId::Timer3, Signal::Ch1, 0U, 3U, 2U},
+    {PeriphId::Timer3, Signal::Ch2, 0U, 7U, 2U},
+    {PeriphId::Timer4, Signal::Up, 0U, 0U, 6U}, {PeriphId::Timer4, Signal::Up, 0U, 6U, 6U},
+    {PeriphId::Timer4, Signal::Ch0, 0U, 2U, 6U}, {PeriphId::Timer4, Signal::Ch1, 0U, 4U, 6U},
+    {PeriphId::Timer4, Signal::Ch2, 0U, 0U, 6U},
+    {PeriphId::Timer4, Signal::Ch3, 0U, 1U, 6U}, {PeriphId::Timer4, Signal::Ch3, 0U, 3U, 6U},
+    {PeriphId::Timer5, Signal::Up, 0U, 1U, 7U}, {PeriphId::Timer6, Signal::Up, 0U, 2U, 1U},
+    {PeriphId::Timer6, Signal::Up, 0U, 4U, 1U},
+    {PeriphId::Timer7, Signal::Up, 1U, 1U, 7U},
+    {PeriphId::Timer7, Signal::Ch0, 1U, 2U, 7U}, {PeriphId::Timer7, Signal::Ch1, 1U, 3U, 7U},
+    {PeriphId::Timer7, Signal::Ch2, 1U, 4U, 7U}, {PeriphId::Timer7, Signal::Ch3, 1U, 7U, 7U}
+};
+
+/*!
+    \brief      find the alternate function of a signal on a pin
+    \param[in]  periph: peripheral
+    \param[in]  signal: signal of the peripheral
+    \param[in]  port: 0 for port A to 8 for port I
+    \param[in]  pin: pin number
+    \param[out] none
+    \retval     alternate function number, -1 if the pin cannot carry the signal
+*/
+constexpr int af_lookup(PeriphId periph, Signal signal, unsigned port, unsigned pin)
+{
+    for(size_t i = 0U; i < sizeof(af_table) / sizeof(af_table[0]); i++) {
+        if((periph == af_table[i].periph) && (signal == af_table[i].signal) &&
+                (port == af_table[i].port) && (pin == af_table[i].pin)) {
+            return af_table[i].af;
+        }
+    }
+    return -1;
+}
+
+/*!
+    \brief      find the sub-peripheral of a DMA channel for a request
+    \param[in]  periph: peripheral
+    \param[in]  signal: request of the peripheral
+    \param[in]  dma: 0 or 1
+    \param[in]  channel: DMA channel
+    \param[out] none
+    \retval     sub-peripheral number, -1 if the channel does not serve the request
+*/
+constexpr int dma_lookup(PeriphId periph, Signal signal, unsigned dma, unsigned channel)
+{
+    for(size_t i = 0U; i < sizeof(dma_table) / sizeof(dma_table[0]); i++) {
+        if((periph == dma_table[i].periph) && (signal == dma_table[i].signal) &&
+                (dma == dma_table[i].dma) && (channel == dma_table[i].channel)) {
+            return dma_table[i].subperi;
+        }
+    }
+    return -1;
+}
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#endif /* GD32F4XX_HAL_MAP_HPP */
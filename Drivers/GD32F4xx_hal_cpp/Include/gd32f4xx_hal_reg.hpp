@@ -0,0 +1,232 @@
+/*!
+    \file    gd32f4xx_hal_reg.hpp
+    \brief   register access and clock enables of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_REG_HPP
+#define GD32F4XX_HAL_REG_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+
+#ifdef GD32F4XX_HAL_REG_HOOK
+/* host builds provide these to record the register accesses, the target accesses the registers */
+extern "C" void gd32f4xx_hal_reg_write(uint32_t addr, uint32_t value);
+extern "C" uint32_t gd32f4xx_hal_reg_read(uint32_t addr);
+#endif /* GD32F4XX_HAL_REG_HOOK */
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* bus base addresses */
+constexpr uint32_t apb1_bus_base = 0x40000000U;
+constexpr uint32_t apb2_bus_base = 0x40010000U;
+constexpr uint32_t ahb1_bus_base = 0x40020000U;
+
+/* peripheral base addresses */
+constexpr uint32_t gpio_base = ahb1_bus_base + 0x00000000U;
+constexpr uint32_t rcu_base = ahb1_bus_base + 0x00003800U;
+constexpr uint32_t dma_base = ahb1_bus_base + 0x00006000U;
+
+/* RCU clock enable registers */
+namespace rcu_reg
+{
+constexpr uint32_t ahb1en = 0x30U;
+constexpr uint32_t apb1en = 0x40U;
+constexpr uint32_t apb2en = 0x44U;
+}
+
+/* clock enable bit of a peripheral */
+struct ClockGate {
+    uint32_t reg;                                                       /*!< RCU enable register offset */
+    uint32_t mask;                                                      /*!< enable bit */
+};
+
+/*!
+    \brief      write a register
+    \param[in]  addr: register address
+    \param[in]  value: value to write
+    \param[out] none
+    \retval     none
+*/
+inline void reg_write(uint32_t addr, uint32_t value)
+{
+#ifdef GD32F4XX_HAL_REG_HOOK
+    gd32f4xx_hal_reg_write(addr, value);
+#else
+    *reinterpret_cast<volatile uint32_t *>(addr) = value;
+#endif /* GD32F4XX_HAL_REG_HOOK */
+}
+
+/*!
+    \brief      read a register
+    \param[in]  addr: register address
+    \param[out] none
+    \retval     register value
+*/
+inline uint32_t reg_read(uint32_t addr)
+{
+#ifdef GD32F4XX_HAL_REG_HOOK
+    return gd32f4xx_hal_reg_read(addr);
+#else
+    return *reinterpret_cast<volatile uint32_t *>(addr);
+#endif /* GD32F4XX_HAL_REG_HOOK */
+}
+
+/*!
+    \brief      clear and set bits of a register, the masks are constants after inlining:
+                nothing is accessed when both are 0, and a register that is written as a
+                whole is not read
+    \param[in]  addr: register address
+    \param[in]  clear: bits to clear
+    \param[in]  set: bits to set
+    \param[out] none
+    \retval     none
+*/
+inline void reg_modify(uint32_t addr, uint32_t clear, uint32_t set)
+{
+    if((0U == clear) && (0U == set)) {
+        return;
+    }
+    if(0xFFFFFFFFU == clear) {
+        reg_write(addr, set);
+    } else {
+        reg_write(addr, (reg_read(addr) & ~clear) | set);
+    }
+}
+
+/*!
+    \brief      wait until bits of a register are set
+    \param[in]  addr: register address
+    \param[in]  mask: bits to wait for
+    \param[out] none
+    \retval     none
+*/
+inline void reg_wait_set(uint32_t addr, uint32_t mask)
+{
+    while(mask != (reg_read(addr) & mask)) {
+    }
+}
+
+/*!
+    \brief      wait until bits of a register are cleared
+    \param[in]  addr: register address
+    \param[in]  mask: bits to wait for
+    \param[out] none
+    \retval     none
+*/
+inline void reg_wait_clear(uint32_t addr, uint32_t mask)
+{
+    while(0U != (reg_read(addr) & mask)) {
+    }
+}
+
+namespace detail
+{
+/* the enable bits of the peripherals in one RCU register */
+template <typename... Periphs>
+constexpr uint32_t clock_mask(uint32_t reg)
+{
+    return (0U | ... | ((reg == Periphs::clock.reg) ? Periphs::clock.mask : 0U));
+}
+
+/* the index of a type in a list of types which are all distinct */
+template <typename T, typename... List>
+constexpr size_t type_index()
+{
+    constexpr bool match[] = {std::is_same<T, List>::value..., false};
+    size_t i = 0U;
+
+    while((i < sizeof...(List)) && !match[i]) {
+        i++;
+    }
+    return i;
+}
+
+/* check that the keys of a list of resources are distinct, resources with the key ~0 are not counted */
+template <size_t N>
+constexpr bool keys_unique(const uint32_t (&key)[N])
+{
+    for(size_t i = 0U; i < N; i++) {
+        for(size_t j = i + 1U; j < N; j++) {
+            if((0xFFFFFFFFU != key[i]) && (key[i] == key[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} /* namespace detail */
+
+/*!
+    \brief      enable the clocks of peripherals, one read-modify-write per RCU register
+    \param[in]  Periphs: peripheral types, each has a static ClockGate clock
+    \param[out] none
+    \retval     none
+*/
+template <typename... Periphs>
+inline void clock_enable()
+{
+    reg_modify(rcu_base + rcu_reg::ahb1en, 0U, detail::clock_mask<Periphs...>(rcu_reg::ahb1en));
+    reg_modify(rcu_base + rcu_reg::apb1en, 0U, detail::clock_mask<Periphs...>(rcu_reg::apb1en));
+    reg_modify(rcu_base + rcu_reg::apb2en, 0U, detail::clock_mask<Periphs...>(rcu_reg::apb2en));
+}
+
+/*!
+    \brief      disable the clocks of peripherals, one read-modify-write per RCU register
+    \param[in]  Periphs: peripheral types, each has a static ClockGate clock
+    \param[out] none
+    \retval     none
+*/
+template <typename... Periphs>
+inline void clock_disable()
+{
+    reg_modify(rcu_base + rcu_reg::ahb1en, detail::clock_mask<Periphs...>(rcu_reg::ahb1en), 0U);
+    reg_modify(rcu_base + rcu_reg::apb1en, detail::clock_mask<Periphs...>(rcu_reg::apb1en), 0U);
+    reg_modify(rcu_base + rcu_reg::apb2en, detail::clock_mask<Periphs...>(rcu_reg::apb2en), 0U);
+}
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#ifdef GD32F4XX_H
+/* the addresses must match the device header when both are used */
+static_assert(gd32f4xx::hal::gpio_base == GPIO_BASE, "GPIO base address");
+static_assert(gd32f4xx::hal::rcu_base == RCU_BASE, "RCU base address");
+static_assert(gd32f4xx::hal::dma_base == DMA_BASE, "DMA base address");
+#endif /* GD32F4XX_H */
+
+#endif /* GD32F4XX_HAL_REG_HPP */
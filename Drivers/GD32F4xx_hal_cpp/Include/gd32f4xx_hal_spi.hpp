@@ -0,0 +1,202 @@
+/*!
+    \file    gd32f4xx_hal_spi.hpp
+    \brief   SPI of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_SPI_HPP
+#define GD32F4XX_HAL_SPI_HPP
+
+#include "gd32f4xx_hal_gpio.hpp"
+#include "gd32f4xx_hal_dma.hpp"
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* SPI registers and bits */
+namespace spi_reg
+{
+constexpr uint32_t ctl0 = 0x00U;
+constexpr uint32_t ctl1 = 0x04U;
+constexpr uint32_t stat = 0x08U;
+constexpr uint32_t data = 0x0CU;
+
+constexpr uint32_t ctl0_ckph = 1UL << 0;
+constexpr uint32_t ctl0_ckpl = 1UL << 1;
+constexpr uint32_t ctl0_mstmod = 1UL << 2;
+constexpr uint32_t ctl0_spien = 1UL << 6;
+constexpr uint32_t ctl0_lf = 1UL << 7;
+constexpr uint32_t ctl0_swnss = 1UL << 8;
+constexpr uint32_t ctl0_swnssen = 1UL << 9;
+constexpr uint32_t ctl0_ff16 = 1UL << 11;
+constexpr uint32_t ctl1_dmaren = 1UL << 0;
+constexpr uint32_t ctl1_dmaten = 1UL << 1;
+constexpr uint32_t stat_rbne = 1UL << 0;
+constexpr uint32_t stat_tbe = 1UL << 1;
+constexpr uint32_t stat_trans = 1UL << 7;
+}
+
+/* clock polarity and phase, mode 0 idles low and samples on the first edge */
+enum class SpiMode : uint32_t { Mode0 = 0U, Mode1 = 1U, Mode2 = 2U, Mode3 = 3U };
+
+namespace detail
+{
+/* SPI0 to SPI5 */
+inline constexpr uint32_t spi_base[] = {
+    apb2_bus_base + 0x3000U, apb1_bus_base + 0x3800U, apb1_bus_base + 0x3C00U,
+    apb2_bus_base + 0x3400U, apb2_bus_base + 0x5000U, apb2_bus_base + 0x5400U
+};
+inline constexpr ClockGate spi_clock[] = {
+    {rcu_reg::apb2en, 1UL << 12}, {rcu_reg::apb1en, 1UL << 14}, {rcu_reg::apb1en, 1UL << 15},
+    {rcu_reg::apb2en, 1UL << 13}, {rcu_reg::apb2en, 1UL << 20}, {rcu_reg::apb2en, 1UL << 21}
+};
+
+/* the PSC field of a clock divider, ~0 if the divider is not 2 to 256 in powers of 2 */
+constexpr uint32_t spi_psc(uint32_t divider)
+{
+    uint32_t psc = 0U;
+
+    while((psc < 8U) && ((2UL << psc) != divider)) {
+        psc++;
+    }
+    return (psc < 8U) ? psc : 0xFFFFFFFFU;
+}
+} /* namespace detail */
+
+/* SPI0 to SPI5 in master mode with software NSS */
+template <unsigned N>
+struct Spi {
+    static_assert(N < 6U, "SPI0 to SPI5");
+
+    static constexpr PeriphId id = static_cast<PeriphId>(static_cast<unsigned>(PeriphId::Spi0) + N);
+    static constexpr uint32_t base = detail::spi_base[N];
+    static constexpr ClockGate clock = detail::spi_clock[N];
+
+    /* pins, Spi<5>::Sck<Pin<PortG, 13>> */
+    template <typename PinT>
+    using Sck = AfPin<id, Signal::Sck, PinT>;
+    template <typename PinT>
+    using Miso = AfPin<id, Signal::Miso, PinT>;
+    template <typename PinT>
+    using Mosi = AfPin<id, Signal::Mosi, PinT>;
+
+    /* DMA channels */
+    template <typename StreamT>
+    using TxDma = DmaBinding<id, Signal::Tx, StreamT>;
+    template <typename StreamT>
+    using RxDma = DmaBinding<id, Signal::Rx, StreamT>;
+
+    /*!
+        \brief      configure and enable the SPI as a master, the registers are written with
+                    constants
+        \param[in]  Divider: the SPI clock is the APB clock divided by 2, 4, ... 256
+        \param[in]  M: clock polarity and phase
+        \param[in]  Frame16: 16-bit frames instead of 8-bit ones
+        \param[in]  LsbFirst: send the least significant bit first
+        \param[out] none
+        \retval     none
+    */
+    template <uint32_t Divider, SpiMode M = SpiMode::Mode0, bool Frame16 = false, bool LsbFirst = false>
+    static void configure()
+    {
+        constexpr uint32_t psc = detail::spi_psc(Divider);
+        static_assert(0xFFFFFFFFU != psc, "the divider is 2, 4, 8 ... 256");
+        constexpr uint32_t ctl0 = spi_reg::ctl0_mstmod | spi_reg::ctl0_swnssen | spi_reg::ctl0_swnss |
+                                  ((psc & 7U) << 3U) | static_cast<uint32_t>(M) |
+                                  (Frame16 ? spi_reg::ctl0_ff16 : 0U) | (LsbFirst ? spi_reg::ctl0_lf : 0U);
+
+        reg_write(base + spi_reg::ctl0, ctl0);
+        reg_write(base + spi_reg::ctl1, 0U);
+        reg_write(base + spi_reg::ctl0, ctl0 | spi_reg::ctl0_spien);
+    }
+
+    /* disable the SPI after the last frame */
+    static void disable()
+    {
+        reg_wait_clear(base + spi_reg::stat, spi_reg::stat_trans);
+        reg_modify(base + spi_reg::ctl0, spi_reg::ctl0_spien, 0U);
+    }
+
+    /* exchange a frame */
+    static uint16_t transfer(uint16_t frame)
+    {
+        reg_wait_set(base + spi_reg::stat, spi_reg::stat_tbe);
+        reg_write(base + spi_reg::data, frame);
+        reg_wait_set(base + spi_reg::stat, spi_reg::stat_rbne);
+        return static_cast<uint16_t>(reg_read(base + spi_reg::data));
+    }
+
+    /*!
+        \brief      exchange a buffer with DMA, both channels must be idle: the receive channel
+                    is started first so that no frame is lost
+        \param[in]  TxBinding: TxDma<DmaStream<...>>
+        \param[in]  RxBinding: RxDma<DmaStream<...>>
+        \param[in]  T: uint8_t for 8-bit frames, uint16_t for 16-bit frames
+        \param[in]  tx: frames to send
+        \param[in]  rx: received frames, valid when the receive channel has finished
+        \param[in]  count: number of frames
+        \param[out] none
+        \retval     none
+    */
+    template <typename TxBinding, typename RxBinding, typename T>
+    static void dma_transfer(const T *tx, volatile T *rx, uint16_t count)
+    {
+        static_assert((id == TxBinding::periph) && (Signal::Tx == TxBinding::signal), "not a transmit channel of this SPI");
+        static_assert((id == RxBinding::periph) && (Signal::Rx == RxBinding::signal), "not a receive channel of this SPI");
+        static_assert((1U == sizeof(T)) || (2U == sizeof(T)), "SPI frames are 8 or 16 bits");
+        constexpr uint32_t tx_ctl = TxBinding::perien | dma_ctl::memory_to_periph | dma_ctl::mnaga |
+                                    dma_ctl::width<T>() | dma_ctl::prio_medium;
+        constexpr uint32_t rx_ctl = RxBinding::perien | dma_ctl::periph_to_memory | dma_ctl::mnaga |
+                                    dma_ctl::width<T>() | dma_ctl::prio_high;
+
+        RxBinding::stream::start(rx_ctl, base + spi_reg::data, rx, count);
+        TxBinding::stream::start(tx_ctl, base + spi_reg::data, tx, count);
+        reg_modify(base + spi_reg::ctl1, 0U, spi_reg::ctl1_dmaren | spi_reg::ctl1_dmaten);
+    }
+
+    static void clock_enable()
+    {
+        hal::clock_enable<Spi>();
+    }
+};
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#ifdef GD32F4XX_H
+static_assert(gd32f4xx::hal::Spi<0U>::base == SPI0, "SPI0 base address");
+static_assert(gd32f4xx::hal::Spi<1U>::base == SPI1, "SPI1 base address");
+static_assert(gd32f4xx::hal::Spi<5U>::base == SPI5, "SPI5 base address");
+#endif /* GD32F4XX_H */
+
+#endif /* GD32F4XX_HAL_SPI_HPP */
@@ -0,0 +1,224 @@
+/*!
+    \file    gd32f4xx_hal_timer.hpp
+    \brief   TIMER of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_TIMER_HPP
+#define GD32F4XX_HAL_TIMER_HPP
+
+#include "gd32f4xx_hal_gpio.hpp"
+#include "gd32f4xx_hal_dma.hpp"
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* TIMER registers and bits */
+namespace timer_reg
+{
+constexpr uint32_t ctl0 = 0x00U;
+constexpr uint32_t dmainten = 0x0CU;
+constexpr uint32_t intf = 0x10U;
+constexpr uint32_t swevg = 0x14U;
+constexpr uint32_t chctl0 = 0x18U;
+constexpr uint32_t chctl1 = 0x1CU;
+constexpr uint32_t chctl2 = 0x20U;
+constexpr uint32_t cnt = 0x24U;
+constexpr uint32_t psc = 0x28U;
+constexpr uint32_t car = 0x2CU;
+constexpr uint32_t ch0cv = 0x34U;
+constexpr uint32_t cchp = 0x44U;
+
+constexpr uint32_t ctl0_cen = 1UL << 0;
+constexpr uint32_t ctl0_arse = 1UL << 7;
+constexpr uint32_t dmainten_upden = 1UL << 8;
+constexpr uint32_t swevg_upg = 1UL << 0;
+constexpr uint32_t cchp_poen = 1UL << 15;
+/* the byte of a channel in CHCTL0/CHCTL1 */
+constexpr uint32_t chctl_comsen = 1UL << 3;
+constexpr uint32_t chctl_pwm0 = 6UL << 4;
+constexpr uint32_t chctl_pwm1 = 7UL << 4;
+}
+
+namespace detail
+{
+/* TIMER0 to TIMER13 */
+inline constexpr uint32_t timer_base[] = {
+    apb2_bus_base + 0x0000U, apb1_bus_base + 0x0000U, apb1_bus_base + 0x0400U, apb1_bus_base + 0x0800U,
+    apb1_bus_base + 0x0C00U, apb1_bus_base + 0x1000U, apb1_bus_base + 0x1400U, apb2_bus_base + 0x0400U,
+    apb2_bus_base + 0x4000U, apb2_bus_base + 0x4400U, apb2_bus_base + 0x4800U, apb1_bus_base + 0x1800U,
+    apb1_bus_base + 0x1C00U, apb1_bus_base + 0x2000U
+};
+inline constexpr ClockGate timer_clock[] = {
+    {rcu_reg::apb2en, 1UL << 0}, {rcu_reg::apb1en, 1UL << 0}, {rcu_reg::apb1en, 1UL << 1}, {rcu_reg::apb1en, 1UL << 2},
+    {rcu_reg::apb1en, 1UL << 3}, {rcu_reg::apb1en, 1UL << 4}, {rcu_reg::apb1en, 1UL << 5}, {rcu_reg::apb2en, 1UL << 1},
+    {rcu_reg::apb2en, 1UL << 16}, {rcu_reg::apb2en, 1UL << 17}, {rcu_reg::apb2en, 1UL << 18}, {rcu_reg::apb1en, 1UL << 6},
+    {rcu_reg::apb1en, 1UL << 7}, {rcu_reg::apb1en, 1UL << 8}
+};
+inline constexpr uint8_t timer_channels[] = {4U, 4U, 4U, 4U, 4U, 0U, 0U, 4U, 2U, 1U, 1U, 2U, 1U, 1U};
+} /* namespace detail */
+
+enum class PwmMode : uint32_t { Pwm0 = timer_reg::chctl_pwm0, Pwm1 = timer_reg::chctl_pwm1 };
+
+/* TIMER0 to TIMER13, counting up */
+template <unsigned N>
+struct Timer {
+    static_assert(N < 14U, "TIMER0 to TIMER13");
+
+    static constexpr PeriphId id = static_cast<PeriphId>(static_cast<unsigned>(PeriphId::Timer0) + N);
+    static constexpr uint32_t base = detail::timer_base[N];
+    static constexpr ClockGate clock = detail::timer_clock[N];
+    static constexpr unsigned channels = detail::timer_channels[N];
+    static constexpr bool advanced = (0U == N) || (7U == N);
+    /* TIMER1 and TIMER4 count with 32 bits */
+    static constexpr uint32_t counter_max = ((1U == N) || (4U == N)) ? 0xFFFFFFFFU : 0xFFFFU;
+
+    /* channel pins, Timer<1>::ChPin<2, Pin<PortB, 10>> */
+    template <unsigned C, typename PinT>
+    using ChPin = AfPin<id, static_cast<Signal>(static_cast<unsigned>(Signal::Ch0) + C), PinT>;
+
+    /* DMA channels */
+    template <typename StreamT>
+    using UpDma = DmaBinding<id, Signal::Up, StreamT>;
+    template <unsigned C, typename StreamT>
+    using ChDma = DmaBinding<id, static_cast<Signal>(static_cast<unsigned>(Signal::Ch0) + C), StreamT>;
+
+    /*!
+        \brief      configure the counter with constants, the counter is stopped
+        \param[in]  Prescaler: the counter clock is the timer clock divided by 1 to 65536
+        \param[in]  Period: counter clocks per update period
+        \param[out] none
+        \retval     none
+    */
+    template <uint32_t Prescaler, uint32_t Period>
+    static void configure()
+    {
+        static_assert((Prescaler >= 1U) && (Prescaler <= 0x10000U), "the prescaler is 1 to 65536");
+        static_assert((Period >= 1U) && ((Period - 1U) <= counter_max), "period out of range for the counter");
+
+        reg_write(base + timer_reg::ctl0, timer_reg::ctl0_arse);
+        reg_write(base + timer_reg::psc, Prescaler - 1U);
+        reg_write(base + timer_reg::car, Period - 1U);
+        /* load the prescaler now, and drop the update flag of the load */
+        reg_write(base + timer_reg::swevg, timer_reg::swevg_upg);
+        reg_write(base + timer_reg::intf, 0U);
+    }
+
+    static void start()
+    {
+        reg_modify(base + timer_reg::ctl0, 0U, timer_reg::ctl0_cen);
+    }
+
+    static void stop()
+    {
+        reg_modify(base + timer_reg::ctl0, timer_reg::ctl0_cen, 0U);
+    }
+
+    static uint32_t counter()
+    {
+        return reg_read(base + timer_reg::cnt);
+    }
+
+    /*!
+        \brief      configure a channel as PWM output with compare shadow, starting with a
+                    compare value of 0
+        \param[in]  Ch: channel
+        \param[in]  M: PWM0 is active while the counter is below the compare value
+        \param[in]  ActiveLow: invert the output
+        \param[out] none
+        \retval     none
+    */
+    template <unsigned Ch, PwmMode M = PwmMode::Pwm0, bool ActiveLow = false>
+    static void pwm_configure()
+    {
+        static_assert(Ch < channels, "the timer has no such channel");
+        constexpr uint32_t chctl = (Ch < 2U) ? timer_reg::chctl0 : timer_reg::chctl1;
+        constexpr unsigned shift = 8U * (Ch & 1U);
+
+        reg_write(base + timer_reg::ch0cv + 4U * Ch, 0U);
+        reg_modify(base + chctl, 0xFFUL << shift, (static_cast<uint32_t>(M) | timer_reg::chctl_comsen) << shift);
+        reg_modify(base + timer_reg::chctl2, 0xFUL << (4U * Ch), (1UL | (ActiveLow ? 2UL : 0UL)) << (4U * Ch));
+        if constexpr(advanced) {
+            reg_modify(base + timer_reg::cchp, 0U, timer_reg::cchp_poen);
+        }
+    }
+
+    /* set the compare value of a channel */
+    template <unsigned Ch>
+    static void compare_set(uint32_t value)
+    {
+        static_assert(Ch < channels, "the timer has no such channel");
+
+        reg_write(base + timer_reg::ch0cv + 4U * Ch, value);
+    }
+
+    /*!
+        \brief      feed the compare value of a channel from a buffer with DMA, one value per
+                    update event; the channel must be idle
+        \param[in]  Binding: UpDma<DmaStream<...>>
+        \param[in]  Ch: timer channel
+        \param[in]  Circular: restart at the beginning of the buffer when it is done
+        \param[in]  T: uint16_t, or uint32_t for the 32-bit timers
+        \param[in]  values: compare values
+        \param[in]  count: number of values
+        \param[out] none
+        \retval     none
+    */
+    template <typename Binding, unsigned Ch, bool Circular = true, typename T>
+    static void dma_compare(const T *values, uint16_t count)
+    {
+        static_assert((id == Binding::periph) && (Signal::Up == Binding::signal), "not an update channel of this timer");
+        static_assert(Ch < channels, "the timer has no such channel");
+        constexpr uint32_t ctl = Binding::perien | dma_ctl::memory_to_periph | dma_ctl::mnaga |
+                                 dma_ctl::width<T>() | dma_ctl::prio_high | (Circular ? dma_ctl::cmen : 0U);
+
+        Binding::stream::start(ctl, base + timer_reg::ch0cv + 4U * Ch, values, count);
+        reg_modify(base + timer_reg::dmainten, 0U, timer_reg::dmainten_upden);
+    }
+
+    static void clock_enable()
+    {
+        hal::clock_enable<Timer>();
+    }
+};
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#ifdef GD32F4XX_H
+static_assert(gd32f4xx::hal::Timer<0U>::base == TIMER0, "TIMER0 base address");
+static_assert(gd32f4xx::hal::Timer<8U>::base == TIMER8, "TIMER8 base address");
+static_assert(gd32f4xx::hal::Timer<13U>::base == TIMER13, "TIMER13 base address");
+#endif /* GD32F4XX_H */
+
+#endif /* GD32F4XX_HAL_TIMER_HPP */
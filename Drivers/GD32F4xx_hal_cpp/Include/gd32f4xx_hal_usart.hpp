@@ -0,0 +1,228 @@
+/*!
+    \file    gd32f4xx_hal_usart.hpp
+    \brief   USART of the C++ template layer
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef GD32F4XX_HAL_USART_HPP
+#define GD32F4XX_HAL_USART_HPP
+
+#include "gd32f4xx_hal_gpio.hpp"
+#include "gd32f4xx_hal_dma.hpp"
+
+namespace gd32f4xx
+{
+namespace hal
+{
+
+/* USART registers and bits */
+namespace usart_reg
+{
+constexpr uint32_t stat0 = 0x00U;
+constexpr uint32_t data = 0x04U;
+constexpr uint32_t baud = 0x08U;
+constexpr uint32_t ctl0 = 0x0CU;
+constexpr uint32_t ctl1 = 0x10U;
+constexpr uint32_t ctl2 = 0x14U;
+
+constexpr uint32_t stat0_rbne = 1UL << 5;
+constexpr uint32_t stat0_tc = 1UL << 6;
+constexpr uint32_t stat0_tbe = 1UL << 7;
+constexpr uint32_t ctl0_ren = 1UL << 2;
+constexpr uint32_t ctl0_ten = 1UL << 3;
+constexpr uint32_t ctl0_pm = 1UL << 9;
+constexpr uint32_t ctl0_pcen = 1UL << 10;
+constexpr uint32_t ctl0_wl = 1UL << 12;
+constexpr uint32_t ctl0_uen = 1UL << 13;
+constexpr uint32_t ctl2_denr = 1UL << 6;
+constexpr uint32_t ctl2_dent = 1UL << 7;
+}
+
+enum class Parity : uint32_t { None, Even, Odd };
+enum class StopBits : uint32_t { One = 0U, Half = 1U, Two = 2U, OneHalf = 3U };
+
+namespace detail
+{
+/* USART0, USART1, USART2, UART3, UART4, USART5, UART6, UART7 */
+inline constexpr uint32_t usart_base[] = {
+    apb2_bus_base + 0x1000U, apb1_bus_base + 0x4400U, apb1_bus_base + 0x4800U, apb1_bus_base + 0x4C00U,
+    apb1_bus_base + 0x5000U, apb2_bus_base + 0x1400U, apb1_bus_base + 0x7800U, apb1_bus_base + 0x7C00U
+};
+inline constexpr ClockGate usart_clock[] = {
+    {rcu_reg::apb2en, 1UL << 4}, {rcu_reg::apb1en, 1UL << 17}, {rcu_reg::apb1en, 1UL << 18}, {rcu_reg::apb1en, 1UL << 19},
+    {rcu_reg::apb1en, 1UL << 20}, {rcu_reg::apb2en, 1UL << 5}, {rcu_reg::apb1en, 1UL << 30}, {rcu_reg::apb1en, 1UL << 31}
+};
+} /* namespace detail */
+
+/* USART0 to UART7, Usart<3> is UART3 */
+template <unsigned N>
+struct Usart {
+    static_assert(N < 8U, "USART0 to UART7");
+
+    static constexpr PeriphId id = static_cast<PeriphId>(static_cast<unsigned>(PeriphId::Usart0) + N);
+    static constexpr uint32_t base = detail::usart_base[N];
+    static constexpr ClockGate clock = detail::usart_clock[N];
+
+    /* pins, Usart<0>::Tx<Pin<PortA, 9>> */
+    template <typename PinT>
+    using Tx = AfPin<id, Signal::Tx, PinT>;
+    template <typename PinT>
+    using Rx = AfPin<id, Signal::Rx, PinT, Pull::Up>;
+    template <typename PinT>
+    using Cts = AfPin<id, Signal::Cts, PinT, Pull::Up>;
+    template <typename PinT>
+    using Rts = AfPin<id, Signal::Rts, PinT>;
+
+    /* DMA channels, Usart<0>::TxDma<DmaStream<1, 7>> */
+    template <typename StreamT>
+    using TxDma = DmaBinding<id, Signal::Tx, StreamT>;
+    template <typename StreamT>
+    using RxDma = DmaBinding<id, Signal::Rx, StreamT>;
+
+    /*!
+        \brief      configure and enable the transmitter and receiver, 16 times oversampling:
+                    the baud rate divider is computed at compile time and the registers are
+                    written with constants
+        \param[in]  PclkHz: clock of the APB bus of the USART
+        \param[in]  Baud: baud rate
+        \param[in]  P: parity, the parity bit comes on top of 8 data bits
+        \param[in]  Stop: stop bits
+        \param[out] none
+        \retval     none
+    */
+    template <uint32_t PclkHz, uint32_t Baud, Parity P = Parity::None, StopBits Stop = StopBits::One>
+    static void configure()
+    {
+        constexpr uint32_t div = (PclkHz + Baud / 2U) / Baud;
+        static_assert((div >= 16U) && (div <= 0xFFFFU), "baud rate out of range for the clock");
+        constexpr uint32_t ctl0 = usart_reg::ctl0_ten | usart_reg::ctl0_ren |
+                                  ((Parity::None != P) ? (usart_reg::ctl0_pcen | usart_reg::ctl0_wl) : 0U) |
+                                  ((Parity::Odd == P) ? usart_reg::ctl0_pm : 0U);
+
+        reg_write(base + usart_reg::ctl0, 0U);
+        reg_write(base + usart_reg::baud, div);
+        reg_write(base + usart_reg::ctl1, static_cast<uint32_t>(Stop) << 12U);
+        reg_write(base + usart_reg::ctl2, 0U);
+        reg_write(base + usart_reg::ctl0, ctl0 | usart_reg::ctl0_uen);
+    }
+
+    static void disable()
+    {
+        reg_modify(base + usart_reg::ctl0, usart_reg::ctl0_uen, 0U);
+    }
+
+    /* send a byte, waits for room in the transmit buffer */
+    static void put(uint8_t ch)
+    {
+        reg_wait_set(base + usart_reg::stat0, usart_reg::stat0_tbe);
+        reg_write(base + usart_reg::data, ch);
+    }
+
+    static void write(const uint8_t *data, size_t len)
+    {
+        while(0U != len--) {
+            put(*data++);
+        }
+    }
+
+    /* wait until the last frame has left the shift register */
+    static void flush()
+    {
+        reg_wait_set(base + usart_reg::stat0, usart_reg::stat0_tc);
+    }
+
+    static bool readable()
+    {
+        return 0U != (reg_read(base + usart_reg::stat0) & usart_reg::stat0_rbne);
+    }
+
+    /* receive a byte, waits for one */
+    static uint8_t get()
+    {
+        reg_wait_set(base + usart_reg::stat0, usart_reg::stat0_rbne);
+        return static_cast<uint8_t>(reg_read(base + usart_reg::data));
+    }
+
+    /*!
+        \brief      send a buffer with DMA, the channel must be idle
+        \param[in]  Binding: TxDma<DmaStream<...>>
+        \param[in]  data: bytes to send, valid until the channel has finished
+        \param[in]  len: number of bytes
+        \param[out] none
+        \retval     none
+    */
+    template <typename Binding>
+    static void dma_transmit(const void *data, uint16_t len)
+    {
+        static_assert((id == Binding::periph) && (Signal::Tx == Binding::signal), "not a transmit channel of this USART");
+        constexpr uint32_t ctl = Binding::perien | dma_ctl::memory_to_periph | dma_ctl::mnaga | dma_ctl::prio_medium;
+
+        Binding::stream::start(ctl, base + usart_reg::data, data, len);
+        reg_modify(base + usart_reg::ctl2, 0U, usart_reg::ctl2_dent);
+    }
+
+    /*!
+        \brief      receive into a buffer with DMA, the channel must be idle
+        \param[in]  Binding: RxDma<DmaStream<...>>
+        \param[in]  Circular: restart at the beginning of the buffer when it is full
+        \param[in]  data: buffer, DmaStream::remaining() tells how far it is filled
+        \param[in]  len: buffer size in bytes
+        \param[out] none
+        \retval     none
+    */
+    template <typename Binding, bool Circular = false>
+    static void dma_receive(volatile void *data, uint16_t len)
+    {
+        static_assert((id == Binding::periph) && (Signal::Rx == Binding::signal), "not a receive channel of this USART");
+        constexpr uint32_t ctl = Binding::perien | dma_ctl::periph_to_memory | dma_ctl::mnaga | dma_ctl::prio_high |
+                                 (Circular ? dma_ctl::cmen : 0U);
+
+        Binding::stream::start(ctl, base + usart_reg::data, data, len);
+        reg_modify(base + usart_reg::ctl2, 0U, usart_reg::ctl2_denr);
+    }
+
+    static void clock_enable()
+    {
+        hal::clock_enable<Usart>();
+    }
+};
+
+} /* namespace hal */
+} /* namespace gd32f4xx */
+
+#ifdef GD32F4XX_H
+static_assert(gd32f4xx::hal::Usart<0U>::base == USART0, "USART0 base address");
+static_assert(gd32f4xx::hal::Usart<2U>::base == USART2, "USART2 base address");
+static_assert(gd32f4xx::hal::Usart<5U>::base == USART5, "USART5 base address");
+static_assert(gd32f4xx::hal::Usart<6U>::base == UART6, "UART6 base address");
+#endif /* GD32F4XX_H */
+
+#endif /* GD32F4XX_HAL_USART_HPP */
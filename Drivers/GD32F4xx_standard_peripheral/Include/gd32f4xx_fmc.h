@@ -349,6 +349,12 @@ fmc_state_enum fmc_word_program(uint32_t address, uint32_t data);
 fmc_state_enum fmc_halfword_program(uint32_t address, uint16_t data);
 /* FMC program a byte at the corresponding address */
 fmc_state_enum fmc_byte_program(uint32_t address, uint8_t data);
+/* FMC start erasing a sector without waiting for the end of the operation */
+fmc_state_enum fmc_sector_erase_start(uint32_t fmc_sector);
+/* FMC get the state of a sector erase started by fmc_sector_erase_start() */
+fmc_state_enum fmc_sector_erase_state_get(void);
+/* FMC program consecutive words at the corresponding address */
+fmc_state_enum fmc_word_burst_program(uint32_t address, const uint32_t *data, uint32_t count);
 
 /* FMC option bytes programming functions */
 /* unlock the option byte operation */
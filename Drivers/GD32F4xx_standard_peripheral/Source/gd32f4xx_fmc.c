@@ -436,6 +436,114 @@ fmc_state_enum fmc_byte_program(uint32_t address, uint8_t data)
     return fmc_state;
 }
 
+/*!
+    \brief    FMC start erasing a sector without waiting for the end of the operation
+    \param[in]  fmc_sector: select the sector to erase
+                only one parameter can be selected which is shown as below:
+      \arg        CTL_SECTOR_NUMBER_x: sector x(x = 0,1,2...27)
+    \param[out] none
+    \retval     state of FMC
+      \arg        FMC_BUSY: the erase has been started, poll fmc_sector_erase_state_get()
+      \arg        FMC_RDDERR: read D-bus protection error
+      \arg        FMC_PGSERR: program sequence error
+      \arg        FMC_PGMERR: program size not match error
+      \arg        FMC_WPERR: erase/program protection error
+      \arg        FMC_OPERR: operation error
+*/
+fmc_state_enum fmc_sector_erase_start(uint32_t fmc_sector)
+{
+    fmc_state_enum fmc_state = fmc_state_get();
+
+    if(FMC_READY == fmc_state) {
+        /* start sector erase, the SER bit is reset by fmc_sector_erase_state_get() */
+        FMC_CTL &= ~FMC_CTL_SN;
+        FMC_CTL |= (FMC_CTL_SER | fmc_sector);
+        FMC_CTL |= FMC_CTL_START;
+        fmc_state = FMC_BUSY;
+    }
+
+    /* return the FMC state */
+    return fmc_state;
+}
+
+/*!
+    \brief    FMC get the state of a sector erase started by fmc_sector_erase_start()
+    \param[in]  none
+    \param[out] none
+    \retval     state of FMC
+      \arg        FMC_READY: the erase has been completed
+      \arg        FMC_BUSY: the erase is in progress
+      \arg        FMC_RDDERR: read D-bus protection error
+      \arg        FMC_PGSERR: program sequence error
+      \arg        FMC_PGMERR: program size not match error
+      \arg        FMC_WPERR: erase/program protection error
+      \arg        FMC_OPERR: operation error
+*/
+fmc_state_enum fmc_sector_erase_state_get(void)
+{
+    fmc_state_enum fmc_state = fmc_state_get();
+
+    if(FMC_BUSY != fmc_state) {
+        /* reset the SER bit */
+        FMC_CTL &= (~FMC_CTL_SER);
+        FMC_CTL &= ~FMC_CTL_SN;
+    }
+
+    /* return the FMC state */
+    return fmc_state;
+}
+
+/*!
+    \brief    FMC program consecutive words at the corresponding address
+    \param[in]  address: address of the first word, word aligned
+    \param[in]  data: words to program
+    \param[in]  count: number of words
+    \param[out] none
+    \retval     state of FMC
+      \arg        FMC_READY: the operation has been completed
+      \arg        FMC_RDDERR: read D-bus protection error
+      \arg        FMC_PGSERR: program sequence error
+      \arg        FMC_PGMERR: program size not match error
+      \arg        FMC_WPERR: erase/program protection error
+      \arg        FMC_OPERR: operation error
+      \arg        FMC_TOERR: timeout error
+*/
+fmc_state_enum fmc_word_burst_program(uint32_t address, const uint32_t *data, uint32_t count)
+{
+    fmc_state_enum fmc_state = FMC_READY;
+    uint32_t timeout;
+    /* wait for the FMC ready */
+    fmc_state = fmc_ready_wait(FMC_TIMEOUT_COUNT);
+
+    if(FMC_READY == fmc_state) {
+        /* set the PG bit once for the whole burst */
+        FMC_CTL &= ~FMC_CTL_PSZ;
+        FMC_CTL |= CTL_PSZ_WORD;
+        FMC_CTL |= FMC_CTL_PG;
+
+        for(; (0U != count) && (FMC_READY == fmc_state); count--) {
+            /* erased words need no programming */
+            if(0xFFFFFFFFU != *data) {
+                REG32(address) = *data;
+
+                /* wait for the end of this word only */
+                timeout = FMC_TIMEOUT_COUNT;
+                while((RESET != (FMC_STAT & FMC_FLAG_BUSY)) && (0U != --timeout)) {
+                }
+                fmc_state = (0U == timeout) ? FMC_TOERR : fmc_state_get();
+            }
+            address += 4U;
+            data++;
+        }
+
+        /* reset the PG bit */
+        FMC_CTL &= ~FMC_CTL_PG;
+    }
+
+    /* return the FMC state */
+    return fmc_state;
+}
+
 /*!
     \brief    unlock the option byte operation
     \param[in]  none
@@ -38,12 +38,43 @@ OF SUCH DAMAGE.
 #include "drv_usb_core.h"
 #include "drv_usb_dev.h"
 
+#ifndef USBD_FUNC_MAX_NUM
+#define USBD_FUNC_MAX_NUM            3U      /*!< maximum number of functions of a composite device */
+#endif /* USBD_FUNC_MAX_NUM */
+
+#ifndef USBD_COMPOSITE_DESC_LEN
+#define USBD_COMPOSITE_DESC_LEN      256U    /*!< maximum length of the merged configuration descriptor */
+#endif /* USBD_COMPOSITE_DESC_LEN */
+
 typedef enum {
     USBD_OK = 0U,                            /*!< status OK */
     USBD_BUSY,                               /*!< status busy */
     USBD_FAIL                                /*!< status fail */
 } usbd_status;
 
+/* class driver serving one function of a composite device */
+typedef struct _usbd_func {
+    usb_class_core *class_core;              /*!< class driver */
+    usb_desc       *desc;                    /*!< descriptors of the class as a device of its own */
+    uint8_t         in_packets;              /*!< bandwidth of each bulk or isochronous IN endpoint, packets buffered in its TX FIFO */
+    uint8_t         out_packets;             /*!< bandwidth of each bulk or isochronous OUT endpoint, packets buffered in the RX FIFO */
+    uint8_t         itf_base;                /*!< number of the first interface in the merged configuration */
+    uint8_t         itf_num;                 /*!< number of interfaces */
+    uint16_t        ep_in;                   /*!< IN endpoints of the function, one bit per endpoint number */
+    uint16_t        ep_out;                  /*!< OUT endpoints of the function, one bit per endpoint number */
+} usbd_func;
+
+/* composite device, several class drivers behind one configuration */
+typedef struct _usbd_composite {
+    usbd_func       func[USBD_FUNC_MAX_NUM]; /*!< functions in the order of their interfaces */
+    uint8_t         func_num;                /*!< number of functions */
+    uint8_t         func_ctl;                /*!< function of the running control transfer */
+    uint16_t        rx_fifo;                 /*!< RX FIFO size in words */
+    uint16_t        tx_fifo[USBHS_MAX_EP_COUNT]; /*!< TX FIFO size of each IN endpoint in words */
+    usb_desc        desc;                    /*!< descriptors of the composite device */
+    __ALIGN_BEGIN uint8_t config_desc[USBD_COMPOSITE_DESC_LEN] __ALIGN_END; /*!< merged configuration descriptor */
+} usbd_composite;
+
 enum _usbd_status {
     USBD_DEFAULT    = 1U,                    /*!< default status */
     USBD_ADDRESSED  = 2U,                    /*!< address send status */
@@ -80,6 +111,10 @@ __STATIC_INLINE uint16_t usbd_rxcount_get(usb_core_driver *udev, uint8_t ep_num)
 /* function declarations */
 /* initializes the USB device-mode stack and load the class driver */
 void usbd_init(usb_core_driver *udev, usb_core_enum core, usb_desc *desc, usb_class_core *class_core);
+/* add a class driver to a composite device as its next function */
+usbd_status usbd_func_add(usbd_composite *comp, usb_class_core *class_core, usb_desc *desc, uint8_t in_packets, uint8_t out_packets);
+/* merge the functions of a composite device and initialize the USB device-mode stack with it */
+usbd_status usbd_composite_init(usb_core_driver *udev, usb_core_enum core, usb_desc *desc, usbd_composite *comp);
 /* endpoint initialization */
 uint32_t usbd_ep_setup(usb_core_driver *udev, const usb_desc_ep *ep_desc);
 /* configure the endpoint when it is disabled */
@@ -35,6 +35,14 @@ OF SUCH DAMAGE.
 #include "usbd_core.h"
 #include "usbd_enum.h"
 #include "drv_usb_hw.h"
+#include <string.h>
+
+#define USBD_DESCTYPE_CS_ITF          0x24U    /*!< class-specific interface descriptor type */
+#define USBD_CLASS_AUDIO              0x01U    /*!< audio interface class */
+#define USBD_CLASS_CDC                0x02U    /*!< CDC interface class */
+#define USBD_IAD_LEN                  0x08U    /*!< interface association descriptor length */
+#define USBD_FIFO_MIN_WORDS           16U      /*!< smallest TX FIFO, in words */
+#define USBD_FIFO_WORDS(mps)          ((uint16_t)(((mps) + 3U) / 4U))
 
 /* endpoint type */
 const uint32_t ep_type[] = {
@@ -44,6 +52,40 @@ const uint32_t ep_type[] = {
     [USB_EP_ATTR_ISO]  = (uint32_t)USB_EPTYPE_ISOC
 };
 
+/* local function prototypes ('static') */
+static usbd_status _composite_merge(usbd_composite *comp, uint8_t ep_count, uint8_t *packets);
+static usbd_status _composite_fifo_fit(usbd_composite *comp, uint16_t fifo_words, uint8_t *packets);
+static void _composite_fifo_set(usb_core_driver *udev);
+static void _composite_cs_itf_remap(uint8_t *desc, uint8_t itf_class, uint8_t itf_base);
+static usbd_func *_composite_itf_func(usbd_composite *comp, uint8_t itf);
+static usbd_func *_composite_ep_func(usbd_composite *comp, uint8_t ep_addr);
+static uint8_t _composite_init(usb_dev *udev, uint8_t config_index);
+static uint8_t _composite_deinit(usb_dev *udev, uint8_t config_index);
+static uint8_t _composite_req(usb_dev *udev, usb_req *req);
+static uint8_t _composite_set_intf(usb_dev *udev, usb_req *req);
+static uint8_t _composite_ctlx_in(usb_dev *udev);
+static uint8_t _composite_ctlx_out(usb_dev *udev);
+static uint8_t _composite_data_in(usb_dev *udev, uint8_t ep_num);
+static uint8_t _composite_data_out(usb_dev *udev, uint8_t ep_num);
+static uint8_t _composite_sof(usb_dev *udev);
+static uint8_t _composite_incomplete_isoc_in(usb_dev *udev);
+static uint8_t _composite_incomplete_isoc_out(usb_dev *udev);
+
+/* class driver of a composite device, dispatches to the class drivers of the functions */
+static usb_class_core usbd_composite_class = {
+    .init                = _composite_init,
+    .deinit              = _composite_deinit,
+    .req_proc            = _composite_req,
+    .set_intf            = _composite_set_intf,
+    .ctlx_in             = _composite_ctlx_in,
+    .ctlx_out            = _composite_ctlx_out,
+    .data_in             = _composite_data_in,
+    .data_out            = _composite_data_out,
+    .SOF                 = _composite_sof,
+    .incomplete_isoc_in  = _composite_incomplete_isoc_in,
+    .incomplete_isoc_out = _composite_incomplete_isoc_out
+};
+
 /*!
     \brief      initializes the USB device-mode stack and load the class driver
     \param[in]  udev: pointer to USB core instance
@@ -81,6 +123,11 @@ void usbd_init(usb_core_driver *udev, usb_core_enum core, usb_desc *desc, usb_cl
     /* initializes device mode */
     (void)usb_devcore_init(udev);
 
+    /* size the FIFOs for the endpoints of the functions instead of usb_conf.h */
+    if(&usbd_composite_class == class_core) {
+        _composite_fifo_set(udev);
+    }
+
     usb_globalint_enable(&udev->regs);
 
     /* set device connect */
@@ -89,6 +136,83 @@ void usbd_init(usb_core_driver *udev, usb_core_enum core, usb_desc *desc, usb_cl
     udev->dev.cur_status = (uint8_t)USBD_DEFAULT;
 }
 
+/*!
+    \brief      add a class driver to a composite device as its next function, the interfaces
+                of the functions are numbered in the order they are added
+    \param[in]  comp: composite device
+    \param[in]  class_core: class driver
+    \param[in]  desc: descriptors of the class as a device of its own, only the configuration
+                descriptor is used
+    \param[in]  in_packets: bandwidth of each bulk or isochronous IN endpoint, the max packets
+                its TX FIFO buffers (interrupt endpoints buffer one packet)
+    \param[in]  out_packets: bandwidth of each bulk or isochronous OUT endpoint, the max packets
+                the RX FIFO buffers for it
+    \param[out] none
+    \retval     USBD_OK, USBD_FAIL if the device has USBD_FUNC_MAX_NUM functions already
+*/
+usbd_status usbd_func_add(usbd_composite *comp, usb_class_core *class_core, usb_desc *desc, uint8_t in_packets, uint8_t out_packets)
+{
+    usbd_func *func = NULL;
+
+    if(comp->func_num >= USBD_FUNC_MAX_NUM) {
+        return USBD_FAIL;
+    }
+
+    func = &comp->func[comp->func_num];
+
+    func->class_core = class_core;
+    func->desc = desc;
+    func->in_packets = (0U == in_packets) ? 1U : in_packets;
+    func->out_packets = (0U == out_packets) ? 1U : out_packets;
+
+    comp->func_num++;
+
+    return USBD_OK;
+}
+
+/*!
+    \brief      merge the functions of a composite device into one configuration, size the FIFOs
+                of their endpoints and initialize the USB device-mode stack with it
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  core: USB core type
+    \param[in]  desc: device descriptor and strings of the composite device, the configuration
+                descriptor is built from the functions
+    \param[in]  comp: composite device with its functions added
+    \param[out] none
+    \retval     USBD_OK, USBD_FAIL if the descriptors do not fit in USBD_COMPOSITE_DESC_LEN, two
+                functions use the same endpoint, an endpoint is missing on the core or the
+                endpoints do not fit in the FIFO RAM of the core
+*/
+usbd_status usbd_composite_init(usb_core_driver *udev, usb_core_enum core, usb_desc *desc, usbd_composite *comp)
+{
+    uint8_t packets[USBHS_MAX_EP_COUNT] = {0U};
+    uint8_t ep_count = USBHS_MAX_EP_COUNT;
+    uint16_t fifo_words = USBHS_MAX_FIFO_WORDLEN;
+
+    if(USB_CORE_ENUM_FS == core) {
+        ep_count = USBFS_MAX_EP_COUNT;
+        fifo_words = USBFS_MAX_FIFO_WORDLEN;
+    }
+
+    if(USBD_OK != _composite_merge(comp, ep_count, packets)) {
+        return USBD_FAIL;
+    }
+
+    if(USBD_OK != _composite_fifo_fit(comp, fifo_words, packets)) {
+        return USBD_FAIL;
+    }
+
+    comp->desc = *desc;
+    comp->desc.config_desc = comp->config_desc;
+    comp->func_ctl = 0U;
+
+    udev->dev.composite = (void *)comp;
+
+    usbd_init(udev, core, &comp->desc, &usbd_composite_class);
+
+    return USBD_OK;
+}
+
 /*!
     \brief      endpoint initialization
     \param[in]  udev: pointer to USB core instance
@@ -318,3 +442,560 @@ void usbd_disconnect(usb_core_driver *udev)
     usb_mdelay(3U);
 #endif /* USE_OTG_MODE */
 }
+
+/*!
+    \brief      build the configuration descriptor of a composite device from the configuration
+                descriptors of its functions: the interfaces are renumbered after the interfaces
+                of the functions before, functions with several interfaces get an interface
+                association descriptor, and the endpoints are checked against each other
+    \param[in]  comp: composite device
+    \param[in]  ep_count: endpoints of the core, endpoint 0 included
+    \param[out] packets: packets each IN endpoint asks to buffer
+    \retval     operation status
+*/
+static usbd_status _composite_merge(usbd_composite *comp, uint8_t ep_count, uint8_t *packets)
+{
+    uint8_t *config = comp->config_desc;
+    uint16_t total = USB_CFG_DESC_LEN;
+    uint16_t ep_in = 0x0001U, ep_out = 0x0001U;
+    uint16_t rx_words = USBD_FIFO_WORDS(USB_FS_EP0_MAX_LEN) + 1U;
+    uint8_t itf_num = 0U, out_num = 1U;
+    uint8_t attributes = 0x80U, max_power = 0U;
+
+    memset((void *)comp->tx_fifo, 0, sizeof(comp->tx_fifo));
+
+    /* endpoint 0 */
+    comp->tx_fifo[0] = USBD_FIFO_MIN_WORDS;
+    packets[0] = 1U;
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        usbd_func *func = &comp->func[i];
+        const uint8_t *desc = func->desc->config_desc;
+        uint16_t len = (uint16_t)(desc[2] | (desc[3] << 8));
+        uint8_t itf_class = 0U;
+
+        func->itf_base = itf_num;
+        func->itf_num = desc[4];
+        func->ep_in = 0U;
+        func->ep_out = 0U;
+
+        attributes |= desc[7];
+        max_power = (desc[8] > max_power) ? desc[8] : max_power;
+
+        /* group the interfaces of a function for the host, unless the class does it already */
+        if((func->itf_num > 1U) && (USB_DESCTYPE_IAD != desc[desc[0] + 1U])) {
+            const uint8_t *itf = &desc[desc[0]];
+
+            if((total + USBD_IAD_LEN) > USBD_COMPOSITE_DESC_LEN) {
+                return USBD_FAIL;
+            }
+
+            config[total] = USBD_IAD_LEN;
+            config[total + 1U] = USB_DESCTYPE_IAD;
+            config[total + 2U] = func->itf_base;
+            config[total + 3U] = func->itf_num;
+            config[total + 4U] = itf[5];
+            config[total + 5U] = itf[6];
+            config[total + 6U] = itf[7];
+            config[total + 7U] = 0U;
+
+            total += USBD_IAD_LEN;
+        }
+
+        for(uint16_t pos = desc[0]; pos < len; pos += desc[pos]) {
+            uint8_t *d = &config[total];
+            uint8_t d_len = desc[pos];
+
+            if((d_len < 2U) || ((pos + d_len) > len) || ((total + d_len) > USBD_COMPOSITE_DESC_LEN)) {
+                return USBD_FAIL;
+            }
+
+            memcpy((void *)d, (const void *)&desc[pos], d_len);
+            total += d_len;
+
+            switch(d[1]) {
+            case USB_DESCTYPE_ITF:
+                d[2] += func->itf_base;
+                itf_class = d[5];
+                break;
+
+            case USB_DESCTYPE_IAD:
+                d[2] += func->itf_base;
+                break;
+
+            case USBD_DESCTYPE_CS_ITF:
+                _composite_cs_itf_remap(d, itf_class, func->itf_base);
+                break;
+
+            case USB_DESCTYPE_EP:
+            {
+                uint8_t num = EP_ID(d[2]);
+                uint8_t type = d[3] & (uint8_t)USB_EPTYPE_MASK;
+                uint16_t words = USBD_FIFO_WORDS((d[4] | (d[5] << 8)) & EP_MAX_PACKET_SIZE_MASK);
+
+                if((0U == num) || (num >= ep_count)) {
+                    return USBD_FAIL;
+                }
+
+                if(EP_DIR(d[2])) {
+                    if(ep_in & (1U << num)) {
+                        return USBD_FAIL;
+                    }
+
+                    ep_in |= (uint16_t)(1U << num);
+                    func->ep_in |= (uint16_t)(1U << num);
+
+                    comp->tx_fifo[num] = (words < USBD_FIFO_MIN_WORDS) ? USBD_FIFO_MIN_WORDS : words;
+                    packets[num] = (USB_EP_ATTR_INT == type) ? 1U : func->in_packets;
+                } else {
+                    if(ep_out & (1U << num)) {
+                        return USBD_FAIL;
+                    }
+
+                    ep_out |= (uint16_t)(1U << num);
+                    func->ep_out |= (uint16_t)(1U << num);
+
+                    /* each packet in the RX FIFO carries a status word */
+                    words = (uint16_t)((words + 1U) * ((USB_EP_ATTR_INT == type) ? 1U : func->out_packets));
+                    rx_words = (words > rx_words) ? words : rx_words;
+                    out_num++;
+                }
+            }
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        itf_num += func->itf_num;
+    }
+
+    config[0] = USB_CFG_DESC_LEN;
+    config[1] = USB_DESCTYPE_CONFIG;
+    config[2] = (uint8_t)total;
+    config[3] = (uint8_t)(total >> 8);
+    config[4] = itf_num;
+    config[5] = 0x01U;
+    config[6] = 0x00U;
+    config[7] = attributes;
+    config[8] = max_power;
+
+    /* SETUP packets of the control endpoint, the largest OUT transfer, the transfer complete
+       status of each OUT endpoint and the global OUT NAK */
+    comp->rx_fifo = (uint16_t)((5U + 8U) + rx_words + (2U * out_num) + 1U);
+
+    return USBD_OK;
+}
+
+/*!
+    \brief      fit the FIFOs of a composite device in the FIFO RAM of the core, the IN endpoints
+                that buffer the most give up packets first
+    \param[in]  comp: composite device, tx_fifo holds one packet of each IN endpoint
+    \param[in]  fifo_words: FIFO RAM of the core in words
+    \param[in]  packets: packets each IN endpoint asks to buffer, reduced to what fits
+    \param[out] none
+    \retval     operation status, USBD_FAIL if one packet per endpoint does not fit
+*/
+static usbd_status _composite_fifo_fit(usbd_composite *comp, uint16_t fifo_words, uint8_t *packets)
+{
+    while(1) {
+        uint32_t total = comp->rx_fifo;
+        uint32_t largest = 0U;
+        uint8_t shrink = 0U;
+
+        for(uint8_t i = 0U; i < USBHS_MAX_EP_COUNT; i++) {
+            uint32_t words = (uint32_t)comp->tx_fifo[i] * packets[i];
+
+            total += words;
+
+            if((packets[i] > 1U) && (words > largest)) {
+                largest = words;
+                shrink = i;
+            }
+        }
+
+        if(total <= fifo_words) {
+            break;
+        }
+
+        if(0U == largest) {
+            return USBD_FAIL;
+        }
+
+        packets[shrink]--;
+    }
+
+    for(uint8_t i = 0U; i < USBHS_MAX_EP_COUNT; i++) {
+        comp->tx_fifo[i] = (uint16_t)(comp->tx_fifo[i] * packets[i]);
+    }
+
+    return USBD_OK;
+}
+
+/*!
+    \brief      program the FIFO sizes of a composite device
+    \param[in]  udev: pointer to USB core instance
+    \param[out] none
+    \retval     none
+*/
+static void _composite_fifo_set(usb_core_driver *udev)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+
+    usb_set_rxfifo(&udev->regs, comp->rx_fifo);
+
+    for(uint8_t i = 0U; i < udev->bp.num_ep; i++) {
+        usb_set_txfifo(&udev->regs, i, comp->tx_fifo[i]);
+    }
+
+    (void)usb_txfifo_flush(&udev->regs, 0x10U);
+    (void)usb_rxfifo_flush(&udev->regs);
+}
+
+/*!
+    \brief      renumber the interfaces a class-specific interface descriptor refers to
+    \param[in]  desc: class-specific interface descriptor in the merged configuration
+    \param[in]  itf_class: class of the interface the descriptor belongs to
+    \param[in]  itf_base: number of the first interface of the function
+    \param[out] none
+    \retval     none
+*/
+static void _composite_cs_itf_remap(uint8_t *desc, uint8_t itf_class, uint8_t itf_base)
+{
+    uint8_t i = 0U;
+
+    if(USBD_CLASS_CDC == itf_class) {
+        switch(desc[2]) {
+        /* call management functional descriptor, bDataInterface */
+        case 0x01U:
+            desc[4] += itf_base;
+            break;
+
+        /* union functional descriptor, bControlInterface and bSubordinateInterface */
+        case 0x06U:
+            for(i = 3U; i < desc[0]; i++) {
+                desc[i] += itf_base;
+            }
+            break;
+
+        default:
+            break;
+        }
+    } else if((USBD_CLASS_AUDIO == itf_class) && (0x01U == desc[2]) && (desc[0] > 8U)) {
+        /* audio control header descriptor, baInterfaceNr of the streaming interfaces */
+        for(i = 8U; i < desc[0]; i++) {
+            desc[i] += itf_base;
+        }
+    } else {
+        /* no interface numbers */
+    }
+}
+
+/*!
+    \brief      get the function an interface belongs to
+    \param[in]  comp: composite device
+    \param[in]  itf: interface number in the merged configuration
+    \param[out] none
+    \retval     function, NULL if no function has the interface
+*/
+static usbd_func *_composite_itf_func(usbd_composite *comp, uint8_t itf)
+{
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        usbd_func *func = &comp->func[i];
+
+        if((itf >= func->itf_base) && (itf < (func->itf_base + func->itf_num))) {
+            return func;
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+    \brief      get the function an endpoint belongs to
+    \param[in]  comp: composite device
+    \param[in]  ep_addr: endpoint address
+    \param[out] none
+    \retval     function, NULL if no function has the endpoint
+*/
+static usbd_func *_composite_ep_func(usbd_composite *comp, uint8_t ep_addr)
+{
+    uint16_t ep_bit = (uint16_t)(1U << EP_ID(ep_addr));
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        usbd_func *func = &comp->func[i];
+
+        if(ep_bit & (EP_DIR(ep_addr) ? func->ep_in : func->ep_out)) {
+            return func;
+        }
+    }
+
+    return NULL;
+}
+
+/* the class drivers keep their control request state in udev->dev.class_core, so each one
+   runs with its own class structure there, and the composite class is put back afterwards */
+
+/*!
+    \brief      initialize the functions of a composite device
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  config_index: configuration index
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_init(usb_dev *udev, uint8_t config_index)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+    uint8_t status = USBD_OK;
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        udev->dev.class_core = comp->func[i].class_core;
+        status |= comp->func[i].class_core->init(udev, config_index);
+    }
+
+    udev->dev.class_core = &usbd_composite_class;
+
+    return status;
+}
+
+/*!
+    \brief      deinitialize the functions of a composite device
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  config_index: configuration index
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_deinit(usb_dev *udev, uint8_t config_index)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+    uint8_t status = USBD_OK;
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        udev->dev.class_core = comp->func[i].class_core;
+        status |= comp->func[i].class_core->deinit(udev, config_index);
+    }
+
+    udev->dev.class_core = &usbd_composite_class;
+
+    return status;
+}
+
+/*!
+    \brief      pass a request to the function of its interface or endpoint, the interface
+                number is given to the function as the class driver numbers it on its own
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  req: device class-specific request
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_req(usb_dev *udev, usb_req *req)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+    usbd_func *func = NULL;
+    usb_req func_req = *req;
+    uint8_t status = USBD_FAIL;
+
+    switch(req->bmRequestType & (uint8_t)USB_RECPTYPE_MASK) {
+    case USB_RECPTYPE_ITF:
+        func = _composite_itf_func(comp, BYTE_LOW(req->wIndex));
+
+        if(NULL != func) {
+            func_req.wIndex = (uint16_t)((req->wIndex & 0xFF00U) | (BYTE_LOW(req->wIndex) - func->itf_base));
+        }
+        break;
+
+    case USB_RECPTYPE_EP:
+        func = _composite_ep_func(comp, BYTE_LOW(req->wIndex));
+        break;
+
+    default:
+        break;
+    }
+
+    if((NULL != func) && (NULL != func->class_core->req_proc)) {
+        /* the data stage of the request goes to the same function */
+        comp->func_ctl = (uint8_t)(func - comp->func);
+
+        udev->dev.class_core = func->class_core;
+        status = func->class_core->req_proc(udev, &func_req);
+        udev->dev.class_core = &usbd_composite_class;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      pass a Set_Interface request to the function of the interface
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  req: pointer to USB device request
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_set_intf(usb_dev *udev, usb_req *req)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+    usbd_func *func = _composite_itf_func(comp, BYTE_LOW(req->wIndex));
+    usb_req func_req = *req;
+    uint8_t status = USBD_FAIL;
+
+    if((NULL != func) && (NULL != func->class_core->set_intf)) {
+        func_req.wIndex = (uint16_t)((req->wIndex & 0xFF00U) | (BYTE_LOW(req->wIndex) - func->itf_base));
+
+        udev->dev.class_core = func->class_core;
+        status = func->class_core->set_intf(udev, &func_req);
+        udev->dev.class_core = &usbd_composite_class;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      pass the end of a control IN data stage to the function of the request
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_ctlx_in(usb_dev *udev)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+    usb_class_core *class_core = comp->func[comp->func_ctl].class_core;
+    uint8_t status = USBD_OK;
+
+    if(NULL != class_core->ctlx_in) {
+        udev->dev.class_core = class_core;
+        status = class_core->ctlx_in(udev);
+        udev->dev.class_core = &usbd_composite_class;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      pass the data of a control OUT data stage to the function of the request
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_ctlx_out(usb_dev *udev)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+    usb_class_core *class_core = comp->func[comp->func_ctl].class_core;
+    uint8_t status = USBD_OK;
+
+    if(NULL != class_core->ctlx_out) {
+        udev->dev.class_core = class_core;
+        status = class_core->ctlx_out(udev);
+        udev->dev.class_core = &usbd_composite_class;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      pass a data IN stage to the function of the endpoint
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  ep_num: endpoint identifier
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_data_in(usb_dev *udev, uint8_t ep_num)
+{
+    usbd_func *func = _composite_ep_func((usbd_composite *)udev->dev.composite, EP_IN(ep_num));
+    uint8_t status = USBD_FAIL;
+
+    if((NULL != func) && (NULL != func->class_core->data_in)) {
+        udev->dev.class_core = func->class_core;
+        status = func->class_core->data_in(udev, ep_num);
+        udev->dev.class_core = &usbd_composite_class;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      pass a data OUT stage to the function of the endpoint
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  ep_num: endpoint identifier
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_data_out(usb_dev *udev, uint8_t ep_num)
+{
+    usbd_func *func = _composite_ep_func((usbd_composite *)udev->dev.composite, EP_OUT(ep_num));
+    uint8_t status = USBD_FAIL;
+
+    if((NULL != func) && (NULL != func->class_core->data_out)) {
+        udev->dev.class_core = func->class_core;
+        status = func->class_core->data_out(udev, ep_num);
+        udev->dev.class_core = &usbd_composite_class;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      pass the start of frame to the functions
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_sof(usb_dev *udev)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        if(NULL != comp->func[i].class_core->SOF) {
+            udev->dev.class_core = comp->func[i].class_core;
+            (void)comp->func[i].class_core->SOF(udev);
+        }
+    }
+
+    udev->dev.class_core = &usbd_composite_class;
+
+    return USBD_OK;
+}
+
+/*!
+    \brief      pass an incomplete isochronous IN transfer to the functions
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_incomplete_isoc_in(usb_dev *udev)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        if(NULL != comp->func[i].class_core->incomplete_isoc_in) {
+            udev->dev.class_core = comp->func[i].class_core;
+            (void)comp->func[i].class_core->incomplete_isoc_in(udev);
+        }
+    }
+
+    udev->dev.class_core = &usbd_composite_class;
+
+    return USBD_OK;
+}
+
+/*!
+    \brief      pass an incomplete isochronous OUT transfer to the functions
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     USB device operation status
+*/
+static uint8_t _composite_incomplete_isoc_out(usb_dev *udev)
+{
+    usbd_composite *comp = (usbd_composite *)udev->dev.composite;
+
+    for(uint8_t i = 0U; i < comp->func_num; i++) {
+        if(NULL != comp->func[i].class_core->incomplete_isoc_out) {
+            udev->dev.class_core = comp->func[i].class_core;
+            (void)comp->func[i].class_core->incomplete_isoc_out(udev);
+        }
+    }
+
+    udev->dev.class_core = &usbd_composite_class;
+
+    return USBD_OK;
+}
@@ -41,6 +41,10 @@ OF SUCH DAMAGE.
 #define USB_FS_EP0_MAX_LEN                  64U                                 /*!< maximum packet size of endpoint 0 */
 #define HC_MAX_PACKET_COUNT                 140U                                /*!< maximum packet count */
 
+#ifndef USBH_SCHED_SLOTS
+#define USBH_SCHED_SLOTS                    32U                                 /*!< (micro)frame slots of the periodic schedule, longest interval */
+#endif /* USBH_SCHED_SLOTS */
+
 #define EP_ID(x)                            ((uint8_t)((x) & 0x7FU))            /*!< endpoint number */
 #define EP_DIR(x)                           ((uint8_t)((x) >> 7))               /*!< endpoint direction */
 
@@ -188,6 +192,7 @@ typedef struct _usb_perp_dev {
     void              *class_data[6];                                           /*!< class data pointer */
     void              *user_data;                                               /*!< user data pointer */
     void              *pdata;                                                   /*!< reserved data pointer */
+    void              *composite;                                               /*!< composite device, NULL for a single class driver */
 } usb_perp_dev;
 
 #endif /* USE_DEVICE_MODE */
@@ -221,6 +226,15 @@ typedef enum _usb_urb_state {
     URB_PING                                                                    /*!< USB URB PING state */
 } usb_urb_state;
 
+/* transfer counters of a host pipe */
+typedef struct _usb_pipe_stat {
+    uint32_t             bytes;                                                 /*!< bytes of the completed transfers */
+    uint32_t             xfers;                                                 /*!< completed transfers */
+    uint32_t             naks;                                                  /*!< NAKs reported by the channel */
+    uint32_t             errors;                                                /*!< transaction, data toggle and babble errors */
+    uint32_t             time;                                                  /*!< host timer of a snapshot, not counted by the driver */
+} usb_pipe_stat;
+
 typedef struct _usb_pipe {
     uint8_t              in_used;                                               /*!< pipe used */
     uint8_t              dev_addr;                                              /*!< USB device address */
@@ -247,6 +261,13 @@ typedef struct _usb_pipe {
     __IO uint32_t        err_count;                                             /*!< error count */
     __IO usb_pipe_status pp_status;                                             /*!< USB pipe status */
     __IO usb_urb_state   urb_state;                                             /*!< USB urb state */
+
+    __IO uint8_t         nak_defer;                                             /*!< bulk IN transaction NAKed, retried in the next frame */
+    __IO uint8_t         sched_pending;                                         /*!< transfer programmed, waiting for its (micro)frame */
+    uint16_t             interval;                                              /*!< periodic schedule interval in (micro)frames, 0 if not scheduled */
+    uint16_t             phase;                                                 /*!< (micro)frame of the interval the pipe is started in */
+    uint32_t             xfer_size;                                             /*!< length programmed for the running transfer */
+    usb_pipe_stat        stat;                                                  /*!< transfer counters */
 } usb_pipe;
 
 typedef struct _usb_host_drv {
@@ -255,6 +276,9 @@ typedef struct _usb_host_drv {
     __IO uint32_t            backup_xfercount[USBFS_MAX_TX_FIFOS];              /*!< USB backup transfer data count */
 
     usb_pipe                 pipe[USBFS_MAX_TX_FIFOS];                          /*!< USB host pipe handles */
+    __IO uint32_t            periodic_map;                                      /*!< pipes with an interrupt or isochronous endpoint */
+    __IO uint32_t            sched_num;                                         /*!< pipes on the periodic schedule */
+    uint16_t                 sched_load[USBH_SCHED_SLOTS];                      /*!< periodic bytes reserved in each (micro)frame slot */
     void                     *data;                                             /*!< user data pointer */
 } usb_host_drv;
 
@@ -109,6 +109,12 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num);
 usb_status usb_pipe_halt(usb_core_driver *udev, uint8_t pipe_num);
 /* configure host pipe to do ping operation */
 usb_status usb_pipe_ping(usb_core_driver *udev, uint8_t pipe_num);
+/* reserve a (micro)frame slot of the periodic schedule for a host pipe */
+usb_status usb_pipe_periodic_config(usb_core_driver *udev, uint8_t pipe_num, uint16_t interval);
+/* release the periodic schedule slot of a host pipe */
+void usb_pipe_periodic_release(usb_core_driver *udev, uint8_t pipe_num);
+/* start the scheduled periodic pipes due in the next (micro)frame */
+void usb_pipe_periodic_sched(usb_core_driver *udev);
 /* stop the USB host and clean up FIFO */
 void usb_host_stop(usb_core_driver *udev);
 
@@ -42,6 +42,7 @@ typedef struct _usbh_ev_cb {
     uint8_t (*connect)(usbh_host *uhost);
     uint8_t (*disconnect)(usbh_host *uhost);
     uint8_t (*SOF)(usbh_host *uhost);
+    uint8_t (*pipe_done)(usbh_host *uhost, uint8_t pp_num);
 } usbh_ev_cb;
 
 extern usbh_ev_cb *usbh_int_fop;
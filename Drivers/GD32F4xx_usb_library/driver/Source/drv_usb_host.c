@@ -40,6 +40,9 @@ const uint32_t PIPE_DPID[2] = {
     PIPE_DPID_DATA1
 };
 
+/* local function prototypes ('static') */
+static void usb_pipe_start(usb_core_driver *udev, uint8_t pipe_num);
+
 /*!
     \brief      initializes USB core for host mode
     \param[in]  udev: pointer to selected USB host
@@ -233,8 +236,12 @@ usb_status usb_pipe_init(usb_core_driver *udev, uint8_t pipe_num)
     switch(pp->ep.type) {
     case USB_EPTYPE_CTRL:
     case USB_EPTYPE_BULK:
-        pp_inten |= HCHINTEN_STALLIE | HCHINTEN_USBERIE \
-                    | HCHINTEN_DTERIE | HCHINTEN_NAKIE;
+        pp_inten |= HCHINTEN_STALLIE | HCHINTEN_USBERIE | HCHINTEN_DTERIE;
+
+        /* with DMA the channel retries a NAKed transaction by itself until the transfer completes */
+        if(USB_USE_DMA != udev->bp.transfer_mode) {
+            pp_inten |= HCHINTEN_NAKIE;
+        }
 
         if(!pp->ep.dir) {
             if(PORT_SPEED_HIGH == pp->dev_speed) {
@@ -263,6 +270,15 @@ usb_status usb_pipe_init(usb_core_driver *udev, uint8_t pipe_num)
 
     udev->regs.pr[pipe_num]->HCHINTEN = pp_inten;
 
+    /* bulk pipes give way to periodic pipes when both are open */
+    if((USB_EPTYPE_INTR == pp->ep.type) || (USB_EPTYPE_ISOC == pp->ep.type)) {
+        udev->host.periodic_map |= 1UL << pipe_num;
+    } else {
+        udev->host.periodic_map &= ~(1UL << pipe_num);
+    }
+
+    pp->nak_defer = 0U;
+
     /* enable the top level host channel interrupt */
     udev->regs.hr->HACHINTEN |= 1U << pipe_num;
 
@@ -295,15 +311,21 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num)
 {
     usb_status status = USB_OK;
 
-    uint16_t dword_len = 0U;
     uint16_t packet_count = 0U;
 
-    __IO uint32_t pp_ctl = 0U;
-
     usb_pipe *pp = &udev->host.pipe[pipe_num];
 
     uint16_t max_packet_len = pp->ep.mps;
 
+    pp->nak_defer = 0U;
+
+    /* the channel DMA moves whole words */
+    if((USB_USE_DMA == udev->bp.transfer_mode) && ((uint32_t)pp->xfer_buf & 0x03U)) {
+        pp->urb_state = URB_ERROR;
+
+        return USB_FAIL;
+    }
+
     /* compute the expected number of packets associated to the transfer */
     if(pp->xfer_len > 0U) {
         packet_count = (uint16_t)((pp->xfer_len + max_packet_len - 1U) / max_packet_len);
@@ -320,6 +342,8 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num)
         pp->xfer_len = (uint16_t)(packet_count * max_packet_len);
     }
 
+    pp->xfer_size = pp->xfer_len;
+
     /* initialize the host channel transfer information */
     udev->regs.pr[pipe_num]->HCHLEN = pp->xfer_len | pp->DPID | PIPE_XFER_PCNT(packet_count);
 
@@ -327,6 +351,33 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num)
         udev->regs.pr[pipe_num]->HCHDMAADDR = (unsigned int)pp->xfer_buf;
     }
 
+    /* a scheduled periodic pipe is started by the SOF interrupt in its (micro)frame */
+    if(0U != pp->interval) {
+        pp->sched_pending = 1U;
+
+        return status;
+    }
+
+    usb_pipe_start(udev, pipe_num);
+
+    return status;
+}
+
+/*!
+    \brief      enable a programmed host channel for the next (micro)frame
+    \param[in]  udev: pointer to USB device
+    \param[in]  pipe_num: host pipe number which is in (0..7)
+    \param[out] none
+    \retval     none
+*/
+static void usb_pipe_start(usb_core_driver *udev, uint8_t pipe_num)
+{
+    uint16_t dword_len = 0U;
+
+    __IO uint32_t pp_ctl = 0U;
+
+    usb_pipe *pp = &udev->host.pipe[pipe_num];
+
     pp_ctl = udev->regs.pr[pipe_num]->HCHCTL;
 
     if(usb_frame_even(udev)) {
@@ -376,8 +427,6 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num)
             usb_txfifo_write(&udev->regs, pp->xfer_buf, pipe_num, (uint16_t)pp->xfer_len);
         }
     }
-
-    return status;
 }
 
 /*!
@@ -393,6 +442,9 @@ usb_status usb_pipe_halt(usb_core_driver *udev, uint8_t pipe_num)
 
     uint8_t ep_type = (uint8_t)((pp_ctl & HCHCTL_EPTYPE) >> 18U);
 
+    udev->host.pipe[pipe_num].nak_defer = 0U;
+    udev->host.pipe[pipe_num].sched_pending = 0U;
+
     pp_ctl |= HCHCTL_CEN | HCHCTL_CDIS;
 
     switch(ep_type) {
@@ -442,6 +494,116 @@ usb_status usb_pipe_ping(usb_core_driver *udev, uint8_t pipe_num)
     return USB_OK;
 }
 
+/*!
+    \brief      reserve a (micro)frame slot of the periodic schedule for a host pipe
+    \param[in]  udev: pointer to USB device
+    \param[in]  pipe_num: host pipe number which is in (0..7 or 0..11)
+    \param[in]  interval: polling interval in (micro)frames, rounded down to a power of 2
+    \param[out] none
+    \retval     operation status, USB_FAIL if no slot has the bandwidth left
+*/
+usb_status usb_pipe_periodic_config(usb_core_driver *udev, uint8_t pipe_num, uint16_t interval)
+{
+    usb_pipe *pp = &udev->host.pipe[pipe_num];
+    uint16_t budget, best_load = 0xFFFFU, best_phase = 0U;
+
+    usb_pipe_periodic_release(udev, pipe_num);
+
+    /* periodic transfers may use 90% of a frame and 80% of a micro-frame */
+    budget = (PORT_SPEED_HIGH == pp->dev_speed) ? 6000U : 1350U;
+
+    if(interval > USBH_SCHED_SLOTS) {
+        interval = USBH_SCHED_SLOTS;
+    }
+
+    while(interval & (interval - 1U)) {
+        interval &= interval - 1U;
+    }
+
+    if(0U == interval) {
+        interval = 1U;
+    }
+
+    /* take the phase whose busiest slot is the least loaded */
+    for(uint16_t phase = 0U; phase < interval; phase++) {
+        uint16_t load = 0U;
+
+        for(uint16_t slot = phase; slot < USBH_SCHED_SLOTS; slot += interval) {
+            if(udev->host.sched_load[slot] > load) {
+                load = udev->host.sched_load[slot];
+            }
+        }
+
+        if(load < best_load) {
+            best_load = load;
+            best_phase = phase;
+        }
+    }
+
+    if((best_load + pp->ep.mps) > budget) {
+        return USB_FAIL;
+    }
+
+    for(uint16_t slot = best_phase; slot < USBH_SCHED_SLOTS; slot += interval) {
+        udev->host.sched_load[slot] += pp->ep.mps;
+    }
+
+    pp->phase = best_phase;
+    pp->sched_pending = 0U;
+    pp->interval = interval;
+    udev->host.sched_num++;
+
+    return USB_OK;
+}
+
+/*!
+    \brief      release the periodic schedule slot of a host pipe
+    \param[in]  udev: pointer to USB device
+    \param[in]  pipe_num: host pipe number which is in (0..7 or 0..11)
+    \param[out] none
+    \retval     none
+*/
+void usb_pipe_periodic_release(usb_core_driver *udev, uint8_t pipe_num)
+{
+    usb_pipe *pp = &udev->host.pipe[pipe_num];
+    uint16_t interval = pp->interval;
+
+    if(0U != interval) {
+        /* leave the schedule before the slot is given back */
+        pp->interval = 0U;
+        pp->sched_pending = 0U;
+        udev->host.sched_num--;
+
+        for(uint16_t slot = pp->phase; slot < USBH_SCHED_SLOTS; slot += interval) {
+            udev->host.sched_load[slot] -= pp->ep.mps;
+        }
+
+        pp->phase = 0U;
+    }
+}
+
+/*!
+    \brief      start the scheduled periodic pipes due in the next (micro)frame, called on SOF
+    \param[in]  udev: pointer to USB device
+    \param[out] none
+    \retval     none
+*/
+void usb_pipe_periodic_sched(usb_core_driver *udev)
+{
+    /* the channels enabled now run in the next (micro)frame */
+    uint16_t slot = (uint16_t)((usb_curframe_get(udev) + 1U) % USBH_SCHED_SLOTS);
+
+    for(uint8_t pp_num = 0U; pp_num < udev->bp.num_pipe; pp_num++) {
+        usb_pipe *pp = &udev->host.pipe[pp_num];
+
+        if((0U != pp->sched_pending) && (0U != pp->interval) && ((slot & (pp->interval - 1U)) == pp->phase)) {
+            pp->sched_pending = 0U;
+
+            usb_pipe_start(udev, pp_num);
+        }
+    }
+}
+
 /*!
     \brief      stop the USB host and clean up FIFO
     \param[in]  udev: pointer to USB device
@@ -456,6 +618,17 @@ void usb_host_stop(usb_core_driver *udev)
     udev->regs.hr->HACHINTEN = 0x0U;
     udev->regs.hr->HACHINT = 0xFFFFFFFFU;
 
+    udev->host.sched_num = 0U;
+
+    for(i = 0U; i < USBH_SCHED_SLOTS; i++) {
+        udev->host.sched_load[i] = 0U;
+    }
+
+    for(i = 0U; i < udev->bp.num_pipe; i++) {
+        udev->host.pipe[i].interval = 0U;
+        udev->host.pipe[i].sched_pending = 0U;
+    }
+
     /* flush out any leftover queued requests. */
     for(i = 0U; i < udev->bp.num_pipe; i++) {
         pp_ctl = udev->regs.pr[i]->HCHCTL;
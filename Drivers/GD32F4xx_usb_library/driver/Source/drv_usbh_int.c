@@ -71,6 +71,22 @@ uint32_t usbh_isr(usb_core_driver *udev)
         }
 
         if(intr & GINTF_SOF) {
+            /* retry the bulk IN pipes that were NAKed in the last frame */
+            if(0U != udev->host.periodic_map) {
+                for(uint8_t pp_num = 0U; pp_num < udev->bp.num_pipe; pp_num++) {
+                    if(0U != udev->host.pipe[pp_num].nak_defer) {
+                        udev->host.pipe[pp_num].nak_defer = 0U;
+
+                        udev->regs.pr[pp_num]->HCHCTL = (udev->regs.pr[pp_num]->HCHCTL | HCHCTL_CEN) & ~HCHCTL_CDIS;
+                    }
+                }
+            }
+
+            /* start the periodic pipes due in the next (micro)frame */
+            if(0U != udev->host.sched_num) {
+                usb_pipe_periodic_sched(udev);
+            }
+
             usbh_int_fop->SOF(udev->host.data);
 
             /* clear interrupt */
@@ -288,6 +304,7 @@ static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num)
            will be overwritten by 'NAK' in code below */
         intr_pp &= ~HCHINTF_NAK;
     } else if(intr_pp & HCHINTF_DTER) {
+        pp->stat.errors++;
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_DTER, PIPE_DTGERR);
         pp_reg->HCHINTF = HCHINTF_NAK;
     } else {
@@ -299,8 +316,14 @@ static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num)
     } else if(intr_pp & HCHINTF_TF) {
         if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
             udev->host.backup_xfercount[pp_num] = pp->xfer_len - (pp_reg->HCHLEN & HCHLEN_TLEN);
+
+            pp->stat.bytes += udev->host.backup_xfercount[pp_num];
+        } else {
+            pp->stat.bytes += pp->xfer_count;
         }
 
+        pp->stat.xfers++;
+
         pp->pp_status = PIPE_XF;
         pp->err_count = 0U;
 
@@ -319,6 +342,13 @@ static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num)
             break;
 
         case USB_EPTYPE_INTR:
+            pp_reg->HCHCTL |= HCHCTL_ODDFRM;
+            pp->urb_state = URB_DONE;
+
+            /* the class takes the report and polls again without waiting for the main loop */
+            usbh_int_fop->pipe_done(udev->host.data, (uint8_t)pp_num);
+            break;
+
         case USB_EPTYPE_ISOC:
             pp_reg->HCHCTL |= HCHCTL_ODDFRM;
             pp->urb_state = URB_DONE;
@@ -361,13 +391,32 @@ static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num)
         }
 
         pp_reg->HCHINTF = HCHINTF_CH;
+
+        /* an interrupt IN poll ended with a NAK, STALL or error */
+        if((uint8_t)USB_EPTYPE_INTR == ep_type) {
+            usbh_int_fop->pipe_done(udev->host.data, (uint8_t)pp_num);
+        }
     } else if(intr_pp & HCHINTF_USBER) {
         pp->err_count++;
+        pp->stat.errors++;
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_USBER, PIPE_TRACERR);
     } else if(intr_pp & HCHINTF_NAK) {
+        pp->stat.naks++;
+
         switch(ep_type) {
-        case USB_EPTYPE_CTRL:
         case USB_EPTYPE_BULK:
+            /* with periodic pipes open, a NAKing bulk IN pipe retries once per frame
+               instead of filling the rest of the frame with IN tokens */
+            if(0U != udev->host.periodic_map) {
+                pp->nak_defer = 1U;
+                break;
+            }
+
+            /* re-activate the channel */
+            pp_reg->HCHCTL = (pp_reg->HCHCTL | HCHCTL_CEN) & ~HCHCTL_CDIS;
+            break;
+
+        case USB_EPTYPE_CTRL:
             /* re-activate the channel */
             pp_reg->HCHCTL = (pp_reg->HCHCTL | HCHCTL_CEN) & ~HCHCTL_CDIS;
             break;
@@ -406,6 +455,12 @@ static uint32_t usbh_int_pipe_out(usb_core_driver *udev, uint32_t pp_num)
 {
     usbh_host *uhost = udev->host.data;
     usb_pr *pp_reg = udev->regs.pr[pp_num];
+
+    /* the control pipes may be in use by a device behind a hub */
+    if(NULL != uhost->ctl_owner) {
+        uhost = uhost->ctl_owner;
+    }
+
     usb_pipe *pp = &udev->host.pipe[pp_num];
     uint32_t intr_pp = pp_reg->HCHINTF;
     intr_pp &= pp_reg->HCHINTEN;
@@ -421,14 +476,19 @@ static uint32_t usbh_int_pipe_out(usb_core_driver *udev, uint32_t pp_num)
     } else if(intr_pp & HCHINTF_STALL) {
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_STALL, PIPE_STALL);
     } else if(intr_pp & HCHINTF_DTER) {
+        pp->stat.errors++;
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_DTER, PIPE_DTGERR);
         pp_reg->HCHINTF = HCHINTF_NAK;
     } else if(intr_pp & HCHINTF_REQOVR) {
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_REQOVR, PIPE_REQOVR);
     } else if(intr_pp & HCHINTF_TF) {
         pp->err_count = 0U;
+        pp->stat.bytes += pp->xfer_size;
+        pp->stat.xfers++;
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_TF, PIPE_XF);
     } else if(intr_pp & HCHINTF_NAK) {
+        pp->stat.naks++;
+
         if(0U == udev->host.pipe[pp_num].do_ping) {
             if(1U == udev->host.pipe[pp_num].supp_ping) {
                 udev->host.pipe[pp_num].do_ping = 1U;
@@ -444,8 +504,13 @@ static uint32_t usbh_int_pipe_out(usb_core_driver *udev, uint32_t pp_num)
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_NAK, PIPE_NAK);
     } else if(intr_pp & HCHINTF_USBER) {
         pp->err_count++;
+        pp->stat.errors++;
         usb_pp_halt(udev, (uint8_t)pp_num, HCHINTF_USBER, PIPE_TRACERR);
     } else if(intr_pp & HCHINTF_NYET) {
+        /* the data was accepted, the NYET only asks for a PING before the next packet */
+        pp->stat.bytes += pp->xfer_size;
+        pp->stat.xfers++;
+
         if(CTL_STATUS_OUT != uhost->control.ctl_state) {
             if(0U == udev->host.pipe[pp_num].do_ping) {
                 if(1U == udev->host.pipe[pp_num].supp_ping) {
@@ -38,13 +38,19 @@ OF SUCH DAMAGE.
 #include "usb_hid.h"
 #include "usbh_enum.h"
 #include "usbh_transc.h"
+#include "usbh_hid_parser.h"
 
 #define HID_MIN_POLL                                    10U              /*!< HID minimum polling */
-#define HID_REPORT_SIZE                                 16U              /*!< HID report size */
+#define HID_REPORT_SIZE                                 64U              /*!< HID report size */
 #define HID_QUEUE_SIZE                                  10U              /*!< HID queue size */
 
 #define USB_HID_DESC_SIZE                               9U               /*!< HID descriptor size */
 
+/* HID devices served at the same time, e.g. several devices behind a hub */
+#ifndef USBH_HID_MAX_INSTANCES
+#define USBH_HID_MAX_INSTANCES                          1U
+#endif /* USBH_HID_MAX_INSTANCES */
+
 /* states for HID state machine */
 typedef enum {
     HID_INIT = 0U,                                                       /*!< HID init state */
@@ -91,15 +97,18 @@ typedef struct _hid_process {
     uint8_t              ep_in;                                   /*!< endpoint IN */
     uint8_t              ep_out;                                  /*!< endpoint OUT */
     uint8_t              *pdata;                                  /*!< HID data pointer */
-    __IO uint8_t         data_ready;                              /*!< HID data ready */
     uint16_t             len;                                     /*!< HID data length */
     uint16_t             poll;                                    /*!< HID polling */
-    __IO uint32_t        timer;                                   /*!< HID timer */
+    uint8_t              boot;                                    /*!< device runs the boot protocol */
     usb_desc_hid         hid_desc;                                /*!< HID descriptor */
-    hid_state            state;                                   /*!< HID state structure */
+    __IO hid_state       state;                                   /*!< HID state structure */
     hid_ctlstate         ctl_state;                               /*!< control request state structure */
     usbh_status          (*init)(usb_core_driver *udev, usbh_host *uhost);
-    usbh_status          (*decode)(uint8_t *data);
+    usbh_status          (*decode)(hid_event *event);             /*!< standard decoder taking the events, NULL if the application takes them */
+    usbh_host            *host;                                   /*!< host of the device using the handler, NULL if free */
+    uint32_t             report[HID_REPORT_SIZE / 4U];            /*!< report buffer of the IN pipe */
+    hid_report_map       map;                                     /*!< input fields compiled from the report descriptor */
+    hid_event_ring       events;                                  /*!< events decoded in the IN transfer interrupt */
 } usbh_hid_handler;
 
 extern usbh_class usbh_hid;
@@ -112,5 +121,7 @@ usbh_status usbh_set_report(usb_core_driver *udev, \
                             uint8_t report_ID, \
                             uint8_t report_len, \
                             uint8_t *report_buf);
+/* take the oldest event of a HID device without a standard decoder */
+uint8_t usbh_hid_event_get(usbh_host *uhost, hid_event *event);
 
 #endif /* USBH_HID_CORE_H */
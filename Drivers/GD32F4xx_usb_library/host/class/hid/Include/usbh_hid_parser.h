@@ -0,0 +1,163 @@
+/*!
+    \file    usbh_hid_parser.h
+    \brief   header file for the usbh_hid_parser.c
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef USBH_HID_PARSER_H
+#define USBH_HID_PARSER_H
+
+#include <stdint.h>
+
+/* the parser and the event ring use no USB core or MCU definition, so they also build on a PC */
+
+/* input fields kept from a report descriptor */
+#ifndef HID_MAX_FIELDS
+#define HID_MAX_FIELDS                                  16U
+#endif /* HID_MAX_FIELDS */
+
+/* usages listed one by one (not as a range) by the input fields */
+#ifndef HID_MAX_USAGES
+#define HID_MAX_USAGES                                  32U
+#endif /* HID_MAX_USAGES */
+
+/* values of all input fields, each keeps its last state to report changes only */
+#ifndef HID_MAX_VALUES
+#define HID_MAX_VALUES                                  64U
+#endif /* HID_MAX_VALUES */
+
+/* input reports (report IDs) of a device */
+#ifndef HID_MAX_REPORT_IDS
+#define HID_MAX_REPORT_IDS                              8U
+#endif /* HID_MAX_REPORT_IDS */
+
+/* events buffered between the IN transfer interrupt and the application, a power of 2 */
+#ifndef HID_EVENT_RING_SIZE
+#define HID_EVENT_RING_SIZE                             32U
+#endif /* HID_EVENT_RING_SIZE */
+
+#if (0U != (HID_EVENT_RING_SIZE & (HID_EVENT_RING_SIZE - 1U))) || (HID_MAX_VALUES > 255U)
+#error "HID_EVENT_RING_SIZE must be a power of 2 and HID_MAX_VALUES at most 255"
+#endif
+
+#define HID_MIN(a, b)                                   (((a) < (b)) ? (a) : (b))
+
+#define HID_LOCAL_USAGES                                16U              /*!< usages of one main item collected by the parser */
+#define HID_GLOBAL_STACK                                4U               /*!< depth of the push/pop global item stack */
+
+/* usage pages used by the standard decoders */
+#define HID_PAGE_SYNC                                   0x0000U          /*!< end of report event, usage is the report ID */
+#define HID_PAGE_GENERIC_DESKTOP                        0x0001U          /*!< generic desktop page */
+#define HID_PAGE_KEYBOARD                               0x0007U          /*!< keyboard/keypad page */
+#define HID_PAGE_LED                                    0x0008U          /*!< LED page */
+#define HID_PAGE_BUTTON                                 0x0009U          /*!< button page */
+
+#define HID_USAGE_X                                     0x0030U          /*!< generic desktop X */
+#define HID_USAGE_Y                                     0x0031U          /*!< generic desktop Y */
+#define HID_USAGE_WHEEL                                 0x0038U          /*!< generic desktop wheel */
+
+/* field flags */
+#define HID_FIELD_ARRAY                                 0x01U            /*!< values are usage indexes, not values of fixed usages */
+#define HID_FIELD_RELATIVE                              0x02U            /*!< values are changes since the last report */
+#define HID_FIELD_SIGNED                                0x04U            /*!< values are two's complement */
+#define HID_FIELD_LIST                                  0x08U            /*!< usages are listed in the usage table of the map */
+
+/* status of the report descriptor parser */
+typedef enum {
+    HID_PARSE_OK = 0U,                                                   /*!< descriptor compiled */
+    HID_PARSE_ITEM_ERROR,                                                /*!< truncated or malformed item */
+    HID_PARSE_SIZE_ERROR,                                                /*!< report size 0 or above 32 bits, or report too long */
+    HID_PARSE_STACK_ERROR,                                               /*!< push/pop nested too deep or unbalanced */
+    HID_PARSE_NO_FIELD,                                                  /*!< no input field in the descriptor */
+    HID_PARSE_FULL                                                       /*!< more fields, usages, values or reports than configured */
+} hid_parse_status;
+
+/* extraction rule of one input main item */
+typedef struct {
+    uint16_t             offset;                                         /*!< bit offset of the first value after the report ID */
+    uint8_t              size;                                           /*!< bits of one value, 1..32 */
+    uint8_t              count;                                          /*!< number of values */
+    uint8_t              report_id;                                      /*!< report ID, 0 if the device uses none */
+    uint8_t              flags;                                          /*!< HID_FIELD_xxx */
+    uint8_t              value_index;                                    /*!< first entry of the field in the last value table */
+    uint8_t              reserved;                                       /*!< reserved */
+    uint16_t             page;                                           /*!< usage page of a usage range */
+    uint16_t             usage_min;                                      /*!< first usage, or first entry in the usage table */
+    uint16_t             usage_max;                                      /*!< last usage, or number of entries in the usage table */
+    int32_t              logical_min;                                    /*!< logical minimum */
+    int32_t              logical_max;                                    /*!< logical maximum */
+} hid_field;
+
+/* input report of a report ID */
+typedef struct {
+    uint8_t              id;                                             /*!< report ID, 0 if the device uses none */
+    uint16_t             bits;                                           /*!< report length in bits without the report ID */
+} hid_report_info;
+
+/* compiled report descriptor */
+typedef struct {
+    hid_field            field[HID_MAX_FIELDS];                          /*!< input fields */
+    uint32_t             usage[HID_MAX_USAGES];                          /*!< listed usages, usage page in the upper half word */
+    uint32_t             last[HID_MAX_VALUES];                           /*!< last value, or last usage of an array entry */
+    hid_report_info      report[HID_MAX_REPORT_IDS];                     /*!< input reports */
+    uint8_t              num_fields;                                     /*!< fields in use */
+    uint8_t              num_usages;                                     /*!< usage table entries in use */
+    uint8_t              num_values;                                     /*!< last value entries in use */
+    uint8_t              num_reports;                                    /*!< input reports in use */
+    uint8_t              use_ids;                                        /*!< reports start with a report ID byte */
+} hid_report_map;
+
+/* change of one usage */
+typedef struct {
+    uint16_t             page;                                           /*!< usage page, HID_PAGE_SYNC after the last event of a report */
+    uint16_t             usage;                                          /*!< usage, the report ID for HID_PAGE_SYNC */
+    int32_t              value;                                          /*!< new value, 1/0 for array usages pressed/released */
+} hid_event;
+
+/* single producer, single consumer event ring: the producer only writes head, the consumer only tail */
+typedef struct {
+    volatile hid_event   event[HID_EVENT_RING_SIZE];                     /*!< event buffer */
+    volatile uint16_t    head;                                           /*!< events written, free running */
+    volatile uint16_t    tail;                                           /*!< events read, free running */
+    volatile uint32_t    lost;                                           /*!< events dropped because the ring was full */
+} hid_event_ring;
+
+/* function declarations */
+/* compile a report descriptor into a report map */
+hid_parse_status hid_report_desc_parse(hid_report_map *map, const uint8_t *desc, uint16_t len);
+/* decode an input report into events for the changed usages */
+uint16_t hid_report_decode(hid_report_map *map, const uint8_t *report, uint16_t len, hid_event_ring *ring);
+/* empty an event ring */
+void hid_event_ring_init(hid_event_ring *ring);
+/* take the oldest event from an event ring */
+uint8_t hid_event_get(hid_event_ring *ring, hid_event *event);
+
+#endif /* USBH_HID_PARSER_H */
@@ -82,7 +82,7 @@ void usr_mouse_process_data(mouse_report_data *data);
 /* initialize mouse function */
 usbh_status usbh_hid_mouse_init(usb_core_driver *udev, usbh_host *uhost);
 /* decode mouse information */
-usbh_status usbh_hid_mouse_decode(uint8_t *data);
+usbh_status usbh_hid_mouse_decode(hid_event *event);
 
 /* initialize keyboard */
 void usr_keybrd_init(void);
@@ -91,6 +91,9 @@ void usr_keybrd_process_data(uint8_t pbuf);
 /* initialize the keyboard function */
 usbh_status usbh_hid_keybrd_init(usb_core_driver *udev, usbh_host *uhost);
 /* decode keyboard information */
-usbh_status usbh_hid_keybrd_decode(uint8_t *data);
+usbh_status usbh_hid_keybrd_decode(hid_event *event);
+
+/* compile the boot protocol report of a keyboard or mouse */
+usbh_status usbh_hid_boot_map_get(hid_report_map *map, uint8_t protocol);
 
 #endif /* USBH_STANDARD_HID_H */
@@ -37,6 +37,9 @@ OF SUCH DAMAGE.
 #include "usbh_hid_core.h"
 #include "usbh_standard_hid.h"
 
+/* the class requests go to the selected HID interface */
+#define HID_ITF_NUM(uhost)      ((uhost)->dev_prop.cfg_desc_set.itf_desc_set[(uhost)->dev_prop.cur_itf][0].itf_desc.bInterfaceNumber)
+
 /* local function prototypes ('static') */
 static void usbh_hiddesc_parse(usb_desc_hid *hid_desc, uint8_t *buf);
 static void usbh_hid_itf_deinit(usbh_host *uhost);
@@ -44,7 +47,7 @@ static usbh_status usbh_hid_itf_init(usbh_host *uhost);
 static usbh_status usbh_hid_class_req(usbh_host *uhost);
 static usbh_status usbh_hid_handle(usbh_host *uhost);
 static usbh_status usbh_hid_reportdesc_get(usbh_host *uhost, uint16_t len);
-static usbh_status usbh_hid_sof(usbh_host *uhost);
+static usbh_status usbh_hid_xfer_done(usbh_host *uhost, uint8_t pp_num);
 static usbh_status usbh_hid_desc_get(usbh_host *uhost, uint16_t len);
 static usbh_status usbh_set_idle(usbh_host *uhost, uint8_t duration, uint8_t report_ID);
 static usbh_status usbh_set_protocol(usbh_host *uhost, uint8_t protocol);
@@ -55,7 +58,8 @@ usbh_class usbh_hid = {
     usbh_hid_itf_deinit,
     usbh_hid_class_req,
     usbh_hid_handle,
-    usbh_hid_sof
+    NULL,
+    usbh_hid_xfer_done
 };
 
 /*!
@@ -81,7 +85,7 @@ usbh_status usbh_get_report(usbh_host *uhost, \
             .bmRequestType = USB_TRX_IN | USB_RECPTYPE_ITF | USB_REQTYPE_CLASS,
             .bRequest      = GET_REPORT,
             .wValue        = (report_type << 8) | report_ID,
-            .wIndex        = 0U,
+            .wIndex        = HID_ITF_NUM(uhost),
             .wLength       = report_len
         };
 
@@ -118,7 +122,7 @@ usbh_status usbh_set_report(usb_core_driver *udev, \
             .bmRequestType = USB_TRX_OUT | USB_RECPTYPE_ITF | USB_REQTYPE_CLASS,
             .bRequest      = SET_REPORT,
             .wValue        = (report_type << 8) | report_ID,
-            .wIndex        = 0U,
+            .wIndex        = HID_ITF_NUM(uhost),
             .wLength       = report_len
         };
 
@@ -130,6 +134,30 @@ usbh_status usbh_set_report(usb_core_driver *udev, \
     return status;
 }
 
+/*!
+    \brief      take the oldest event of a HID device without a standard decoder, the events
+                of keyboards and mice go to the standard decoders instead
+    \param[in]  uhost: pointer to USB host of the device
+    \param[out] event: usage change, a HID_PAGE_SYNC event follows the changes of each report
+    \retval     1 if an event was taken, 0 if there is none
+*/
+uint8_t usbh_hid_event_get(usbh_host *uhost, hid_event *event)
+{
+    usbh_hid_handler *hid = NULL;
+
+    if((NULL == uhost->active_class) || (USB_HID_CLASS != uhost->active_class->class_code)) {
+        return 0U;
+    }
+
+    hid = (usbh_hid_handler *)uhost->active_class->class_data;
+
+    if((NULL == hid) || (NULL != hid->decode)) {
+        return 0U;
+    }
+
+    return hid_event_get(&hid->events, event);
+}
+
 /*!
     \brief      deinitialize the host pipes used for the HID class
     \param[in]  uhost: pointer to USB host
@@ -140,6 +168,13 @@ void usbh_hid_itf_deinit(usbh_host *uhost)
 {
     usbh_hid_handler *hid = (usbh_hid_handler *)uhost->active_class->class_data;
 
+    if(NULL == hid) {
+        return;
+    }
+
+    /* keep the IN transfer interrupt from polling again */
+    hid->state = HID_ERROR;
+
     if(0x00U != hid->pipe_in) {
         usb_pipe_halt(uhost->data, hid->pipe_in);
 
@@ -157,6 +192,10 @@ void usbh_hid_itf_deinit(usbh_host *uhost)
         /* reset the channel as free */
         hid->pipe_out = 0U;
     }
+
+    /* give the handler back */
+    hid->host = NULL;
+    uhost->active_class->class_data = NULL;
 }
 
 /*!
@@ -215,45 +254,68 @@ uint8_t usbh_hid_poll_interval_get(usb_core_driver *udev, usbh_host *uhost)
 */
 static usbh_status usbh_hid_itf_init(usbh_host *uhost)
 {
+    static usbh_hid_handler hid_handler[USBH_HID_MAX_INSTANCES];
+
     uint8_t num = 0U, ep_num = 0U, interface = 0U;
     usbh_status status = USBH_BUSY;
+    usbh_hid_handler *hid = NULL;
 
     interface = usbh_interface_find(&uhost->dev_prop, USB_HID_CLASS, USB_HID_SUBCLASS_BOOT_ITF, 0xFFU);
 
+    /* gamepads, scanners and other report protocol only devices have no boot interface */
     if(0xFFU == interface) {
+        interface = usbh_interface_find(&uhost->dev_prop, USB_HID_CLASS, 0xFFU, 0xFFU);
+    }
+
+    /* each HID device takes a handler of its own */
+    for(num = 0U; num < USBH_HID_MAX_INSTANCES; num++) {
+        if(NULL == hid_handler[num].host) {
+            hid = &hid_handler[num];
+            break;
+        }
+    }
+
+    if((0xFFU == interface) || (NULL == hid)) {
         uhost->usr_cb->dev_not_supported();
 
         status = USBH_FAIL;
     } else {
         usbh_interface_select(&uhost->dev_prop, interface);
 
-        static usbh_hid_handler hid_handler;
+        memset((void *)hid, 0U, sizeof(usbh_hid_handler));
 
-        memset((void *)&hid_handler, 0U, sizeof(usbh_hid_handler));
-
-        hid_handler.state = HID_ERROR;
+        hid->state = HID_ERROR;
 
         uint8_t itf_protocol = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].itf_desc.bInterfaceProtocol;
         if(USB_HID_PROTOCOL_KEYBOARD == itf_protocol) {
-            hid_handler.init = usbh_hid_keybrd_init;
-            hid_handler.decode = usbh_hid_keybrd_decode;
+            hid->init = usbh_hid_keybrd_init;
+            hid->decode = usbh_hid_keybrd_decode;
         } else if(USB_HID_PROTOCOL_MOUSE == itf_protocol) {
-            hid_handler.init = usbh_hid_mouse_init;
-            hid_handler.decode = usbh_hid_mouse_decode;
+            hid->init = usbh_hid_mouse_init;
+            hid->decode = usbh_hid_mouse_decode;
         } else {
-            status = USBH_FAIL;
+            /* the application takes the events with usbh_hid_event_get() */
+            hid->init = NULL;
+            hid->decode = NULL;
         }
 
-        hid_handler.state = HID_INIT;
-        hid_handler.ctl_state = HID_REQ_INIT;
-        hid_handler.ep_addr = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0].bEndpointAddress;
-        hid_handler.len = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0].wMaxPacketSize;
-        hid_handler.poll = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0].bInterval;
+        hid->state = HID_INIT;
+        hid->ctl_state = HID_REQ_INIT;
+        hid->ep_addr = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0].bEndpointAddress;
+        hid->len = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0].wMaxPacketSize;
+        hid->poll = uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0].bInterval;
 
-        if(hid_handler.poll < HID_MIN_POLL) {
-            hid_handler.poll = HID_MIN_POLL;
+        if(hid->poll < HID_MIN_POLL) {
+            hid->poll = HID_MIN_POLL;
         }
 
+        if(hid->len > sizeof(hid->report)) {
+            hid->len = sizeof(hid->report);
+        }
+
+        /* reports land in the buffer of the handler, each device has its own */
+        hid->pdata = (uint8_t *)(void *)hid->report;
+
         /* check for available number of endpoints */
         /* find the number of endpoints in the interface descriptor */
         /* choose the lower number in order not to overrun the buffer allocated */
@@ -264,37 +326,66 @@ static usbh_status usbh_hid_itf_init(usbh_host *uhost)
             usb_desc_ep *ep_desc = &uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[num];
 
             uint8_t ep_addr = ep_desc->bEndpointAddress;
+            uint8_t pp_num = usbh_pipe_dev_allocate(uhost, ep_addr, USB_EPTYPE_INTR);
+
+            if((uint8_t)HP_ERROR == pp_num) {
+                break;
+            }
 
             if(ep_addr & 0x80U) {
-                hid_handler.ep_in = ep_addr;
-                hid_handler.pipe_in = usbh_pipe_allocate(uhost->data, ep_addr);
+                hid->ep_in = ep_addr;
+                hid->pipe_in = pp_num;
 
                 /* open channel for IN endpoint */
                 usbh_pipe_create(uhost->data, \
                                  &uhost->dev_prop, \
-                                 hid_handler.pipe_in, \
+                                 hid->pipe_in, \
                                  USB_EPTYPE_INTR, \
-                                 hid_handler.len);
+                                 hid->len);
 
-                usbh_pipe_toggle_set(uhost->data, hid_handler.pipe_in, 0U);
+                usbh_pipe_toggle_set(uhost->data, hid->pipe_in, 0U);
+
+                /* spread the interrupt transfers of the devices over the frames */
+                if(USBH_OK != usbh_pipe_periodic_set(uhost, hid->pipe_in, ep_desc->bInterval)) {
+                    break;
+                }
             } else {
-                hid_handler.ep_out = ep_addr;
-                hid_handler.pipe_out = usbh_pipe_allocate(uhost->data, ep_addr);
+                hid->ep_out = ep_addr;
+                hid->pipe_out = pp_num;
 
                 /* open channel for OUT endpoint */
                 usbh_pipe_create(uhost->data, \
                                  &uhost->dev_prop, \
-                                 hid_handler.pipe_out, \
+                                 hid->pipe_out, \
                                  USB_EPTYPE_INTR, \
-                                 hid_handler.len);
+                                 hid->len);
 
-                usbh_pipe_toggle_set(uhost->data, hid_handler.pipe_out, 0U);
+                usbh_pipe_toggle_set(uhost->data, hid->pipe_out, 0U);
+
+                if(USBH_OK != usbh_pipe_periodic_set(uhost, hid->pipe_out, ep_desc->bInterval)) {
+                    break;
+                }
             }
         }
 
-        uhost->active_class->class_data = (void *)&hid_handler;
+        if(num < ep_num) {
+            /* out of pipes or periodic bandwidth, try again when another device gives them back */
+            if(0U != hid->pipe_in) {
+                usbh_pipe_free(uhost->data, hid->pipe_in);
+            }
 
-        status = USBH_OK;
+            if(0U != hid->pipe_out) {
+                usbh_pipe_free(uhost->data, hid->pipe_out);
+            }
+
+            status = USBH_BUSY;
+        } else {
+            hid->host = uhost;
+
+            uhost->active_class->class_data = (void *)hid;
+
+            status = USBH_OK;
+        }
     }
 
     return status;
@@ -310,8 +401,10 @@ static usbh_status usbh_hid_class_req(usbh_host *uhost)
 {
     usbh_status status = USBH_BUSY;
     usbh_status class_req_status = USBH_BUSY;
+    uint16_t desc_len = 0U;
 
     usbh_hid_handler *hid = (usbh_hid_handler *)uhost->active_class->class_data;
+    usb_desc_itf *itf = &uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].itf_desc;
 
     /* handle HID control state machine */
     switch(hid->ctl_state) {
@@ -327,8 +420,21 @@ static usbh_status usbh_hid_class_req(usbh_host *uhost)
 
     case HID_REQ_GET_REPORT_DESC:
         /* get report descriptor */
-        if(USBH_OK == usbh_hid_reportdesc_get(uhost, hid->hid_desc.wDescriptorLength)) {
-            hid->ctl_state = HID_REQ_SET_IDLE;
+        desc_len = USB_MIN(hid->hid_desc.wDescriptorLength, USBH_DATA_BUF_MAX_LEN);
+
+        if(USBH_OK == usbh_hid_reportdesc_get(uhost, desc_len)) {
+            /* compile the report layout once, the reports are decoded with it in the interrupt */
+            if(HID_PARSE_OK == hid_report_desc_parse(&hid->map, uhost->dev_prop.data, desc_len)) {
+                hid->ctl_state = HID_REQ_SET_IDLE;
+            } else if(USBH_OK == usbh_hid_boot_map_get(&hid->map, itf->bInterfaceProtocol)) {
+                /* keyboards and mice fall back to the fixed reports of the boot protocol */
+                hid->boot = 1U;
+                hid->ctl_state = HID_REQ_SET_IDLE;
+            } else {
+                uhost->usr_cb->dev_not_supported();
+
+                hid->ctl_state = HID_REQ_IDLE;
+            }
         }
         break;
 
@@ -346,8 +452,10 @@ static usbh_status usbh_hid_class_req(usbh_host *uhost)
         break;
 
     case HID_REQ_SET_PROTOCOL:
-        /* set protocol */
-        if(USBH_OK == usbh_set_protocol(uhost, 0U)) {
+        /* set protocol, devices without a boot interface may not support the request */
+        class_req_status = usbh_set_protocol(uhost, hid->boot);
+
+        if((USBH_OK == class_req_status) || (USBH_NOT_SUPPORTED == class_req_status)) {
             hid->ctl_state = HID_REQ_IDLE;
 
             /* all requests performed */
@@ -373,10 +481,14 @@ static usbh_status usbh_hid_handle(usbh_host *uhost)
 {
     usbh_status status = USBH_OK;
     usbh_hid_handler *hid = (usbh_hid_handler *)uhost->active_class->class_data;
+    hid_event event;
 
     switch(hid->state) {
     case HID_INIT:
-        hid->init(uhost->data, uhost);
+        if(NULL != hid->init) {
+            hid->init(uhost->data, uhost);
+        }
+
         hid->state = HID_IDLE;
         break;
 
@@ -393,28 +505,25 @@ static usbh_status usbh_hid_handle(usbh_host *uhost)
         break;
 
     case HID_GET_DATA:
-        usbh_data_recev(uhost->data, hid->pdata, hid->pipe_in, hid->len);
-
+        /* from now on the IN transfer interrupt decodes each report and polls again */
         hid->state = HID_POLL;
-        hid->timer = usb_curframe_get(uhost->data);
-        hid->data_ready = 0U;
+
+        usbh_data_recev(uhost->data, hid->pdata, hid->pipe_in, hid->len);
         break;
 
     case HID_POLL:
-        if(URB_DONE == usbh_urbstate_get(uhost->data, hid->pipe_in)) {
-            if(0U == hid->data_ready) {
-                hid->data_ready = 1U;
-
-                hid->decode(hid->pdata);
+        if(NULL != hid->decode) {
+            while(0U != hid_event_get(&hid->events, &event)) {
+                hid->decode(&event);
             }
-        } else {
-            /* check IN endpoint STALL status */
-            if(URB_STALL == usbh_urbstate_get(uhost->data, hid->pipe_in)) {
-                /* issue clear feature on interrupt IN endpoint */
-                if(USBH_OK == (usbh_clrfeature(uhost, hid->ep_addr, hid->pipe_in))) {
-                    /* change state to issue next IN token */
-                    hid->state = HID_GET_DATA;
-                }
+        }
+
+        /* check IN endpoint STALL status, polling stops until the halt is cleared */
+        if(URB_STALL == usbh_urbstate_get(uhost->data, hid->pipe_in)) {
+            /* issue clear feature on interrupt IN endpoint */
+            if(USBH_OK == (usbh_clrfeature(uhost, hid->ep_addr, hid->pipe_in))) {
+                /* change state to issue next IN token */
+                hid->state = HID_GET_DATA;
             }
         }
         break;
@@ -441,7 +550,7 @@ static usbh_status usbh_hid_reportdesc_get(usbh_host *uhost, uint16_t len)
             .bmRequestType = USB_TRX_IN | USB_RECPTYPE_ITF | USB_REQTYPE_STRD,
             .bRequest      = USB_GET_DESCRIPTOR,
             .wValue        = USBH_DESC(USB_DESCTYPE_REPORT),
-            .wIndex        = 0U,
+            .wIndex        = HID_ITF_NUM(uhost),
             .wLength       = len
         };
 
@@ -454,27 +563,46 @@ static usbh_status usbh_hid_reportdesc_get(usbh_host *uhost, uint16_t len)
 }
 
 /*!
-    \brief      managing the SOF process
+    \brief      handle the end of an IN transfer from the interrupt: decode the report into
+                events and poll again, the periodic schedule starts the poll in the next
+                (micro)frame of the pipe, so reports are not lost when the main loop is busy
     \param[in]  uhost: pointer to USB host
+    \param[in]  pp_num: pipe number
     \param[out] none
     \retval     operation status
 */
-static usbh_status usbh_hid_sof(usbh_host *uhost)
+static usbh_status usbh_hid_xfer_done(usbh_host *uhost, uint8_t pp_num)
 {
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
     usbh_hid_handler *hid = (usbh_hid_handler *)uhost->active_class->class_data;
+    uint32_t len = 0U;
 
-    if(HID_POLL == hid->state) {
-        uint32_t frame_count = usb_curframe_get(uhost->data);
+    if((NULL == hid) || (pp_num != hid->pipe_in) || (HID_POLL != hid->state)) {
+        return USBH_OK;
+    }
 
-        if((frame_count > hid->timer) && ((frame_count - hid->timer) >= hid->poll)) {
-            hid->state = HID_GET_DATA;
-        } else if((frame_count < hid->timer) && ((frame_count + 0x3FFFU - hid->timer) >= hid->poll)) {
-            hid->state = HID_GET_DATA;
+    switch(usbh_urbstate_get(udev, pp_num)) {
+    case URB_DONE:
+        if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
+            len = udev->host.backup_xfercount[pp_num];
         } else {
-            /* no operation */
+            len = udev->host.pipe[pp_num].xfer_count;
         }
+
+        (void)hid_report_decode(&hid->map, hid->pdata, (uint16_t)len, &hid->events);
+        break;
+
+    case URB_STALL:
+        /* the class handler clears the halt and starts polling again */
+        return USBH_OK;
+
+    default:
+        /* NAK or error, no report in this interval */
+        break;
     }
 
+    usbh_data_recev(udev, hid->pdata, hid->pipe_in, hid->len);
+
     return USBH_OK;
 }
 
@@ -494,7 +622,7 @@ static usbh_status usbh_hid_desc_get(usbh_host *uhost, uint16_t len)
             .bmRequestType = USB_TRX_IN | USB_RECPTYPE_ITF | USB_REQTYPE_STRD,
             .bRequest      = USB_GET_DESCRIPTOR,
             .wValue        = USBH_DESC(USB_DESCTYPE_HID),
-            .wIndex        = 0U,
+            .wIndex        = HID_ITF_NUM(uhost),
             .wLength       = len
         };
 
@@ -523,7 +651,7 @@ static usbh_status usbh_set_idle(usbh_host *uhost, uint8_t duration, uint8_t rep
             .bmRequestType = USB_TRX_OUT | USB_RECPTYPE_ITF | USB_REQTYPE_CLASS,
             .bRequest      = SET_IDLE,
             .wValue        = (duration << 8) | report_ID,
-            .wIndex        = 0U,
+            .wIndex        = HID_ITF_NUM(uhost),
             .wLength       = 0U
         };
 
@@ -538,7 +666,7 @@ static usbh_status usbh_set_idle(usbh_host *uhost, uint8_t duration, uint8_t rep
 /*!
     \brief      set protocol state
     \param[in]  uhost: pointer to USB host
-    \param[in]  protocol: boot/report protocol
+    \param[in]  protocol: 1 for the boot protocol, 0 for the report protocol
     \param[out] none
     \retval     operation status
 */
@@ -551,7 +679,7 @@ static usbh_status usbh_set_protocol(usbh_host *uhost, uint8_t protocol)
             .bmRequestType = USB_TRX_OUT | USB_RECPTYPE_ITF | USB_REQTYPE_CLASS,
             .bRequest      = SET_PROTOCOL,
             .wValue        = !protocol,
-            .wIndex        = 0U,
+            .wIndex        = HID_ITF_NUM(uhost),
             .wLength       = 0U
         };
 
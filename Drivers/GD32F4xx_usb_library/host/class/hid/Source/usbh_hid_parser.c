@@ -0,0 +1,638 @@
+/*!
+    \file    usbh_hid_parser.c
+    \brief   USB host HID report descriptor parser and event ring
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include "usbh_hid_parser.h"
+
+/* item prefixes without the size bits */
+#define HID_ITEM_INPUT                  0x80U
+#define HID_ITEM_OUTPUT                 0x90U
+#define HID_ITEM_FEATURE                0xB0U
+#define HID_ITEM_COLLECTION             0xA0U
+#define HID_ITEM_END_COLLECTION         0xC0U
+#define HID_ITEM_USAGE_PAGE             0x04U
+#define HID_ITEM_LOGICAL_MIN            0x14U
+#define HID_ITEM_LOGICAL_MAX            0x24U
+#define HID_ITEM_REPORT_SIZE            0x74U
+#define HID_ITEM_REPORT_ID              0x84U
+#define HID_ITEM_REPORT_COUNT           0x94U
+#define HID_ITEM_PUSH                   0xA4U
+#define HID_ITEM_POP                    0xB4U
+#define HID_ITEM_USAGE                  0x08U
+#define HID_ITEM_USAGE_MIN              0x18U
+#define HID_ITEM_USAGE_MAX              0x28U
+#define HID_ITEM_LONG                   0xFEU
+
+/* main item data bits */
+#define HID_MAIN_CONSTANT               0x01U
+#define HID_MAIN_VARIABLE               0x02U
+#define HID_MAIN_RELATIVE               0x04U
+
+/* keyboard ErrorRollOver, with its usage page */
+#define HID_USAGE_ROLLOVER              (((uint32_t)HID_PAGE_KEYBOARD << 16) | 0x01U)
+
+/* vendor defined usage pages, their fields are left to the application */
+#define HID_PAGE_VENDOR                 0xFF00U
+
+/* global item state, saved by push and restored by pop */
+typedef struct {
+    uint16_t page;
+    uint8_t  size;
+    uint8_t  id;
+    uint16_t count;
+    int32_t  logical_min;
+    int32_t  logical_max;
+    uint32_t logical_max_raw;
+} hid_global;
+
+/* local item state, cleared by each main item */
+typedef struct {
+    uint32_t usage[HID_LOCAL_USAGES];
+    uint8_t  num_usages;
+    uint8_t  range;
+    uint32_t usage_min;
+    uint32_t usage_max;
+} hid_local;
+
+/* local function prototypes ('static') */
+static hid_parse_status hid_input_add(hid_report_map *map, hid_global *global, hid_local *local, uint32_t data);
+static hid_report_info *hid_report_get(hid_report_map *map, uint8_t id);
+static int32_t hid_value_get(const hid_field *field, const uint8_t *data, uint8_t index);
+static uint32_t hid_array_usage_get(const hid_report_map *map, const hid_field *field, int32_t value);
+static uint32_t hid_var_usage_get(const hid_report_map *map, const hid_field *field, uint8_t index);
+static uint8_t hid_array_find(const hid_report_map *map, const hid_field *field, const uint8_t *data, uint8_t num, uint32_t usage);
+static uint8_t hid_usage_find(const uint32_t *usages, uint8_t num, uint32_t usage);
+static uint8_t hid_event_put(hid_event_ring *ring, uint32_t usage, int32_t value);
+
+/*!
+    \brief      compile a report descriptor into a report map, a table of the input fields
+                with their bit positions, which hid_report_decode() uses to extract the values
+    \param[in]  desc: report descriptor
+    \param[in]  len: report descriptor length
+    \param[out] map: report map, cleared first
+    \retval     parser status, HID_PARSE_OK if the map holds at least one input field
+*/
+hid_parse_status hid_report_desc_parse(hid_report_map *map, const uint8_t *desc, uint16_t len)
+{
+    hid_global global, stack[HID_GLOBAL_STACK];
+    hid_local local;
+    hid_parse_status status = HID_PARSE_OK;
+    uint8_t depth = 0U;
+    uint16_t pos = 0U;
+
+    memset((void *)map, 0, sizeof(hid_report_map));
+    memset((void *)&global, 0, sizeof(hid_global));
+    memset((void *)&local, 0, sizeof(hid_local));
+
+    while((pos < len) && (HID_PARSE_OK == status)) {
+        uint8_t prefix = desc[pos];
+        uint8_t size = prefix & 0x03U;
+        uint32_t data = 0U;
+        int32_t sdata = 0;
+
+        if(HID_ITEM_LONG == prefix) {
+            /* long items are reserved, skip them */
+            if((pos + 2U) >= len) {
+                return HID_PARSE_ITEM_ERROR;
+            }
+
+            pos += (uint16_t)(3U + desc[pos + 1U]);
+            continue;
+        }
+
+        if(3U == size) {
+            size = 4U;
+        }
+
+        if((pos + 1U + size) > len) {
+            return HID_PARSE_ITEM_ERROR;
+        }
+
+        for(uint8_t i = 0U; i < size; i++) {
+            data |= (uint32_t)desc[pos + 1U + i] << (8U * i);
+        }
+
+        /* the same data as a signed value of the item size */
+        if((size > 0U) && (size < 4U) && (data & (1UL << (8U * size - 1U)))) {
+            sdata = (int32_t)(data | ~((1UL << (8U * size)) - 1U));
+        } else {
+            sdata = (int32_t)data;
+        }
+
+        pos += (uint16_t)(1U + size);
+
+        switch(prefix & 0xFCU) {
+        case HID_ITEM_INPUT:
+            status = hid_input_add(map, &global, &local, data);
+            memset((void *)&local, 0, sizeof(hid_local));
+            break;
+
+        case HID_ITEM_OUTPUT:
+        case HID_ITEM_FEATURE:
+        case HID_ITEM_COLLECTION:
+        case HID_ITEM_END_COLLECTION:
+            /* only input reports are decoded */
+            memset((void *)&local, 0, sizeof(hid_local));
+            break;
+
+        case HID_ITEM_USAGE_PAGE:
+            global.page = (uint16_t)data;
+            break;
+
+        case HID_ITEM_LOGICAL_MIN:
+            global.logical_min = sdata;
+            break;
+
+        case HID_ITEM_LOGICAL_MAX:
+            global.logical_max = sdata;
+            global.logical_max_raw = data;
+            break;
+
+        case HID_ITEM_REPORT_SIZE:
+            global.size = (uint8_t)HID_MIN(data, 0xFFU);
+            break;
+
+        case HID_ITEM_REPORT_ID:
+            if((0U == data) || (data > 0xFFU)) {
+                status = HID_PARSE_ITEM_ERROR;
+            }
+
+            global.id = (uint8_t)data;
+            map->use_ids = 1U;
+            break;
+
+        case HID_ITEM_REPORT_COUNT:
+            global.count = (uint16_t)HID_MIN(data, 0xFFFFU);
+            break;
+
+        case HID_ITEM_PUSH:
+            if(depth >= HID_GLOBAL_STACK) {
+                status = HID_PARSE_STACK_ERROR;
+            } else {
+                stack[depth++] = global;
+            }
+            break;
+
+        case HID_ITEM_POP:
+            if(0U == depth) {
+                status = HID_PARSE_STACK_ERROR;
+            } else {
+                global = stack[--depth];
+            }
+            break;
+
+        case HID_ITEM_USAGE:
+            if(local.num_usages < HID_LOCAL_USAGES) {
+                /* a 4 byte usage carries its usage page, a short one takes the page of the main item */
+                local.usage[local.num_usages++] = (4U == size) ? data : (data & 0xFFFFU);
+            }
+            break;
+
+        case HID_ITEM_USAGE_MIN:
+            local.usage_min = (4U == size) ? data : (data & 0xFFFFU);
+            local.range |= 0x01U;
+            break;
+
+        case HID_ITEM_USAGE_MAX:
+            local.usage_max = (4U == size) ? data : (data & 0xFFFFU);
+            local.range |= 0x02U;
+            break;
+
+        default:
+            /* physical range, units, designators and strings are not needed to decode */
+            break;
+        }
+    }
+
+    if((HID_PARSE_OK == status) && (0U == map->num_fields)) {
+        status = HID_PARSE_NO_FIELD;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      decode an input report into events for the usages whose value changed, relative
+                values are reported when not zero, array usages as pressed (1) and released (0);
+                the events of a report are followed by a HID_PAGE_SYNC event, called from the
+                IN transfer interrupt
+    \param[in]  map: report map compiled from the report descriptor, keeps the last values
+    \param[in]  report: input report, with the report ID byte if the device uses report IDs
+    \param[in]  len: report length
+    \param[out] ring: event ring the events are added to
+    \retval     number of events, without the HID_PAGE_SYNC event
+*/
+uint16_t hid_report_decode(hid_report_map *map, const uint8_t *report, uint16_t len, hid_event_ring *ring)
+{
+    const uint8_t *data = report;
+    uint32_t bits = (uint32_t)len * 8U;
+    uint16_t events = 0U;
+    uint8_t id = 0U;
+
+    if((0U == len) || ((0U != map->use_ids) && (len < 2U))) {
+        return 0U;
+    }
+
+    if(0U != map->use_ids) {
+        id = report[0];
+        data++;
+        bits -= 8U;
+    }
+
+    for(uint8_t num = 0U; num < map->num_fields; num++) {
+        const hid_field *field = &map->field[num];
+        uint32_t *last = &map->last[field->value_index];
+
+        /* short reports leave the fields they do not cover unchanged */
+        if((field->report_id != id) || ((field->offset + (uint32_t)field->size * field->count) > bits)) {
+            continue;
+        }
+
+        if(0U == (field->flags & HID_FIELD_ARRAY)) {
+            for(uint8_t i = 0U; i < field->count; i++) {
+                int32_t value = hid_value_get(field, data, i);
+
+                if(field->flags & HID_FIELD_RELATIVE) {
+                    if(0 == value) {
+                        continue;
+                    }
+                } else if((uint32_t)value == last[i]) {
+                    continue;
+                } else {
+                    last[i] = (uint32_t)value;
+                }
+
+                events += hid_event_put(ring, hid_var_usage_get(map, field, i), value);
+            }
+        } else {
+            /* a keyboard reporting too many keys at once fills the array with ErrorRollOver,
+               the keys pressed before are kept until a valid report comes */
+            if(0U != hid_array_find(map, field, data, field->count, HID_USAGE_ROLLOVER)) {
+                continue;
+            }
+
+            /* releases: usages of the last report missing from this one */
+            for(uint8_t i = 0U; i < field->count; i++) {
+                if((0U != last[i]) && (0U == hid_usage_find(last, i, last[i])) && \
+                     (0U == hid_array_find(map, field, data, field->count, last[i]))) {
+                    events += hid_event_put(ring, last[i], 0);
+                }
+            }
+
+            /* presses: usages of this report missing from the last one, which becomes this one */
+            for(uint8_t i = 0U; i < field->count; i++) {
+                uint32_t usage = hid_array_usage_get(map, field, hid_value_get(field, data, i));
+
+                if((0U != usage) && (0U == hid_usage_find(last, field->count, usage)) && \
+                     (0U == hid_array_find(map, field, data, i, usage))) {
+                    events += hid_event_put(ring, usage, 1);
+                }
+            }
+
+            for(uint8_t i = 0U; i < field->count; i++) {
+                last[i] = hid_array_usage_get(map, field, hid_value_get(field, data, i));
+            }
+        }
+    }
+
+    if(events > 0U) {
+        (void)hid_event_put(ring, ((uint32_t)HID_PAGE_SYNC << 16) | id, (int32_t)events);
+    }
+
+    return events;
+}
+
+/*!
+    \brief      empty an event ring
+    \param[in]  ring: event ring
+    \param[out] none
+    \retval     none
+*/
+void hid_event_ring_init(hid_event_ring *ring)
+{
+    ring->head = 0U;
+    ring->tail = 0U;
+    ring->lost = 0U;
+}
+
+/*!
+    \brief      take the oldest event from an event ring, the only consumer of the ring
+    \param[in]  ring: event ring
+    \param[out] event: event taken
+    \retval     1 if an event was taken, 0 if the ring is empty
+*/
+uint8_t hid_event_get(hid_event_ring *ring, hid_event *event)
+{
+    uint16_t tail = ring->tail;
+
+    if(tail == ring->head) {
+        return 0U;
+    }
+
+    event->page = ring->event[tail & (HID_EVENT_RING_SIZE - 1U)].page;
+    event->usage = ring->event[tail & (HID_EVENT_RING_SIZE - 1U)].usage;
+    event->value = ring->event[tail & (HID_EVENT_RING_SIZE - 1U)].value;
+
+    /* the entry may be overwritten once tail passes it */
+    ring->tail = (uint16_t)(tail + 1U);
+
+    return 1U;
+}
+
+/*!
+    \brief      add a field of an input main item to the report map
+    \param[in]  map: report map
+    \param[in]  global: global item state
+    \param[in]  local: local item state
+    \param[in]  data: input item data
+    \param[out] none
+    \retval     parser status
+*/
+static hid_parse_status hid_input_add(hid_report_map *map, hid_global *global, hid_local *local, uint32_t data)
+{
+    hid_report_info *report = hid_report_get(map, global->id);
+    uint32_t total = (uint32_t)global->size * global->count;
+    hid_field *field = &map->field[map->num_fields];
+    uint16_t page = 0U;
+
+    if((0U == global->size) || (global->size > 32U)) {
+        return HID_PARSE_SIZE_ERROR;
+    }
+
+    if(NULL == report) {
+        return HID_PARSE_FULL;
+    }
+
+    if((report->bits + total) > 0xFFFFU) {
+        return HID_PARSE_SIZE_ERROR;
+    }
+
+    field->offset = report->bits;
+    report->bits = (uint16_t)(report->bits + total);
+
+    /* padding and constant fields only move the offset */
+    if((data & HID_MAIN_CONSTANT) || (0U == global->count) || \
+         ((0U == local->num_usages) && (0x03U != local->range))) {
+        return HID_PARSE_OK;
+    }
+
+    if(local->num_usages > 0U) {
+        page = (uint16_t)((local->usage[0] > 0xFFFFU) ? (local->usage[0] >> 16) : global->page);
+    } else {
+        page = (uint16_t)((local->usage_min > 0xFFFFU) ? (local->usage_min >> 16) : global->page);
+    }
+
+    if(page >= HID_PAGE_VENDOR) {
+        return HID_PARSE_OK;
+    }
+
+    if((map->num_fields >= HID_MAX_FIELDS) || ((map->num_values + global->count) > HID_MAX_VALUES) || \
+         ((map->num_usages + local->num_usages) > HID_MAX_USAGES)) {
+        return HID_PARSE_FULL;
+    }
+
+    field->size = global->size;
+    field->count = (uint8_t)global->count;
+    field->report_id = global->id;
+    field->page = page;
+    field->value_index = map->num_values;
+    field->logical_min = global->logical_min;
+
+    /* a non-negative minimum makes the maximum unsigned, 0x00..0xFF is coded as 00 and FF */
+    if(global->logical_min >= 0) {
+        field->logical_max = (int32_t)global->logical_max_raw;
+    } else {
+        field->logical_max = global->logical_max;
+        field->flags |= HID_FIELD_SIGNED;
+    }
+
+    if(0U == (data & HID_MAIN_VARIABLE)) {
+        field->flags |= HID_FIELD_ARRAY;
+    }
+
+    if(data & HID_MAIN_RELATIVE) {
+        field->flags |= HID_FIELD_RELATIVE;
+    }
+
+    if(local->num_usages > 0U) {
+        field->flags |= HID_FIELD_LIST;
+        field->usage_min = map->num_usages;
+        field->usage_max = local->num_usages;
+
+        for(uint8_t i = 0U; i < local->num_usages; i++) {
+            uint32_t usage = local->usage[i];
+
+            map->usage[map->num_usages++] = (usage > 0xFFFFU) ? usage : (((uint32_t)global->page << 16) | usage);
+        }
+    } else {
+        field->usage_min = (uint16_t)local->usage_min;
+        field->usage_max = (uint16_t)local->usage_max;
+    }
+
+    map->num_values = (uint8_t)(map->num_values + field->count);
+    map->num_fields++;
+
+    return HID_PARSE_OK;
+}
+
+/*!
+    \brief      get the input report of a report ID, add it if it is new
+    \param[in]  map: report map
+    \param[in]  id: report ID
+    \param[out] none
+    \retval     input report, NULL if the report table is full
+*/
+static hid_report_info *hid_report_get(hid_report_map *map, uint8_t id)
+{
+    for(uint8_t i = 0U; i < map->num_reports; i++) {
+        if(id == map->report[i].id) {
+            return &map->report[i];
+        }
+    }
+
+    if(map->num_reports >= HID_MAX_REPORT_IDS) {
+        return NULL;
+    }
+
+    map->report[map->num_reports].id = id;
+    map->report[map->num_reports].bits = 0U;
+
+    return &map->report[map->num_reports++];
+}
+
+/*!
+    \brief      extract a value of a field from a report, bits are numbered from bit 0 of the first byte
+    \param[in]  field: field
+    \param[in]  data: report without the report ID
+    \param[in]  index: value of the field
+    \param[out] none
+    \retval     value, sign extended for signed fields
+*/
+static int32_t hid_value_get(const hid_field *field, const uint8_t *data, uint8_t index)
+{
+    uint32_t pos = field->offset + (uint32_t)field->size * index;
+    uint32_t value = 0U;
+    uint8_t got = 0U;
+
+    while(got < field->size) {
+        uint8_t shift = (uint8_t)(pos & 0x07U);
+        uint8_t take = (uint8_t)HID_MIN(8U - shift, (uint32_t)field->size - got);
+
+        value |= (((uint32_t)data[pos >> 3] >> shift) & ((1UL << take) - 1U)) << got;
+
+        got = (uint8_t)(got + take);
+        pos += take;
+    }
+
+    if((field->flags & HID_FIELD_SIGNED) && (field->size < 32U) && (value & (1UL << (field->size - 1U)))) {
+        value |= ~((1UL << field->size) - 1U);
+    }
+
+    return (int32_t)value;
+}
+
+/*!
+    \brief      get the usage an array entry selects
+    \param[in]  map: report map
+    \param[in]  field: array field
+    \param[in]  value: value of the array entry
+    \param[out] none
+    \retval     usage with the usage page in the upper half word, 0 if no usage is selected
+*/
+static uint32_t hid_array_usage_get(const hid_report_map *map, const hid_field *field, int32_t value)
+{
+    uint32_t index, usage;
+
+    if((value < field->logical_min) || (value > field->logical_max)) {
+        return 0U;
+    }
+
+    index = (uint32_t)(value - field->logical_min);
+
+    if(field->flags & HID_FIELD_LIST) {
+        usage = (index < field->usage_max) ? map->usage[field->usage_min + index] : 0U;
+    } else {
+        usage = field->usage_min + index;
+        usage = (usage > field->usage_max) ? 0U : (((uint32_t)field->page << 16) | usage);
+    }
+
+    /* usage 0 means no key or button in the entry */
+    return (0U == (usage & 0xFFFFU)) ? 0U : usage;
+}
+
+/*!
+    \brief      get the usage of a value of a variable field
+    \param[in]  map: report map
+    \param[in]  field: variable field
+    \param[in]  index: value of the field
+    \param[out] none
+    \retval     usage with the usage page in the upper half word
+*/
+static uint32_t hid_var_usage_get(const hid_report_map *map, const hid_field *field, uint8_t index)
+{
+    /* the last usage applies to the remaining values */
+    if(field->flags & HID_FIELD_LIST) {
+        return map->usage[field->usage_min + HID_MIN(index, field->usage_max - 1U)];
+    }
+
+    return ((uint32_t)field->page << 16) | HID_MIN((uint32_t)field->usage_min + index, field->usage_max);
+}
+
+/*!
+    \brief      check whether the first entries of an array field of a report select a usage
+    \param[in]  map: report map
+    \param[in]  field: array field
+    \param[in]  data: report without the report ID
+    \param[in]  num: number of entries to check
+    \param[in]  usage: usage with the usage page in the upper half word
+    \param[out] none
+    \retval     1 if one of the entries selects the usage, 0 otherwise
+*/
+static uint8_t hid_array_find(const hid_report_map *map, const hid_field *field, const uint8_t *data, uint8_t num, uint32_t usage)
+{
+    for(uint8_t i = 0U; i < num; i++) {
+        if(usage == hid_array_usage_get(map, field, hid_value_get(field, data, i))) {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/*!
+    \brief      check whether a usage is in a usage list
+    \param[in]  usages: usage list
+    \param[in]  num: number of usages in the list
+    \param[in]  usage: usage with the usage page in the upper half word
+    \param[out] none
+    \retval     1 if the list holds the usage, 0 otherwise
+*/
+static uint8_t hid_usage_find(const uint32_t *usages, uint8_t num, uint32_t usage)
+{
+    for(uint8_t i = 0U; i < num; i++) {
+        if(usage == usages[i]) {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/*!
+    \brief      add an event to an event ring, the only producer of the ring
+    \param[in]  ring: event ring
+    \param[in]  usage: usage with the usage page in the upper half word
+    \param[in]  value: value of the usage
+    \param[out] none
+    \retval     1 if the event was added, 0 if the ring is full and the event was dropped
+*/
+static uint8_t hid_event_put(hid_event_ring *ring, uint32_t usage, int32_t value)
+{
+    uint16_t head = ring->head;
+
+    if((uint16_t)(head - ring->tail) >= HID_EVENT_RING_SIZE) {
+        ring->lost++;
+
+        return 0U;
+    }
+
+    ring->event[head & (HID_EVENT_RING_SIZE - 1U)].page = (uint16_t)(usage >> 16);
+    ring->event[head & (HID_EVENT_RING_SIZE - 1U)].usage = (uint16_t)usage;
+    ring->event[head & (HID_EVENT_RING_SIZE - 1U)].value = value;
+
+    /* publish the entry after it is written, both are volatile accesses and keep their order */
+    ring->head = (uint16_t)(head + 1U);
+
+    return 1U;
+}
@@ -37,8 +37,6 @@ OF SUCH DAMAGE.
 mouse_report_data mouse_info;
 hid_keybd_info keybd_info;
 
-__ALIGN_BEGIN uint8_t hid_mouse_info[8] __ALIGN_END = {0U};
-__ALIGN_BEGIN uint32_t keybd_report_data[2] __ALIGN_END;
 
 /* local constants */
 static const uint8_t kbd_codes[] = {
@@ -141,6 +139,21 @@ static const int8_t kbd_key_shift[] = {
 
 #endif /* QWERTY_KEYBOARD */
 
+/* report descriptors of the boot protocol reports (HID 1.11 appendix B) */
+static const uint8_t boot_keybrd_desc[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01,
+    0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x05, 0x75, 0x01,
+    0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x91, 0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01, 0x95, 0x06,
+    0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0
+};
+
+static const uint8_t boot_mouse_desc[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03,
+    0x15, 0x00, 0x25, 0x01, 0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x01,
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x02, 0x81, 0x06,
+    0xC0, 0xC0
+};
+
 /*!
     \brief      initialize the mouse function
     \param[in]  udev: pointer to USB core instance
@@ -150,44 +163,43 @@ static const int8_t kbd_key_shift[] = {
 */
 usbh_status usbh_hid_mouse_init(usb_core_driver *udev, usbh_host *uhost)
 {
-    usbh_hid_handler *hid = (usbh_hid_handler *)uhost->active_class->class_data;
-
     mouse_info.x = 0U;
     mouse_info.y = 0U;
     mouse_info.buttons[0] = 0U;
     mouse_info.buttons[1] = 0U;
     mouse_info.buttons[2] = 0U;
 
-    if(hid->len > sizeof(hid_mouse_info)) {
-        hid->len = sizeof(hid_mouse_info);
-    }
-
-    hid->pdata = (uint8_t *)(void *)hid_mouse_info;
-
     usr_mouse_init();
 
     return USBH_OK;
 }
 
 /*!
-    \brief      decode mouse information
-    \param[in]  data: pointer to input data
+    \brief      decode mouse information, the changes of a report are collected until its end
+    \param[in]  event: usage change decoded from a report
     \param[out] none
     \retval     operation status
 */
-usbh_status usbh_hid_mouse_decode(uint8_t *data)
+usbh_status usbh_hid_mouse_decode(hid_event *event)
 {
-    mouse_info.buttons[0] = data[0] & MOUSE_BUTTON_1;
-    mouse_info.buttons[1] = data[0] & MOUSE_BUTTON_2;
-    mouse_info.buttons[2] = data[0] & MOUSE_BUTTON_3;
-
-    mouse_info.x = data[1];
-    mouse_info.y = data[2];
-
-    /* handle mouse data position */
-    usr_mouse_process_data(&mouse_info);
+    if((HID_PAGE_BUTTON == event->page) && (event->usage >= 1U) && (event->usage <= 3U)) {
+        mouse_info.buttons[event->usage - 1U] = (uint8_t)((0 != event->value) ? (1U << (event->usage - 1U)) : 0U);
+    } else if((HID_PAGE_GENERIC_DESKTOP == event->page) && (HID_USAGE_X == event->usage)) {
+        mouse_info.x = (uint8_t)event->value;
+    } else if((HID_PAGE_GENERIC_DESKTOP == event->page) && (HID_USAGE_Y == event->usage)) {
+        mouse_info.y = (uint8_t)event->value;
+    } else if(HID_PAGE_SYNC == event->page) {
+        /* handle mouse data position */
+        usr_mouse_process_data(&mouse_info);
+
+        /* X and Y are movements, they only count once */
+        mouse_info.x = 0U;
+        mouse_info.y = 0U;
+    } else {
+        /* wheel and other usages are not used */
+    }
 
-    return USBH_FAIL;
+    return USBH_OK;
 }
 
 /*!
@@ -206,16 +218,10 @@ usbh_status usbh_hid_keybrd_init(usb_core_driver *udev, usbh_host *uhost)
     keybd_info.rctrl = keybd_info.rshift = 0U;
     keybd_info.ralt  = keybd_info.rgui   = 0U;
 
-    for(uint32_t x = 0U; x < (sizeof(keybd_report_data) / sizeof(uint32_t)); x++) {
-        keybd_report_data[x] = 0U;
-    }
-
-    if(hid->len > (sizeof(keybd_report_data) / sizeof(uint32_t))) {
-        hid->len = (sizeof(keybd_report_data) / sizeof(uint32_t));
+    for(uint32_t x = 0U; x < (sizeof(hid->report) / sizeof(uint32_t)); x++) {
+        hid->report[x] = 0U;
     }
 
-    hid->pdata = (uint8_t *)(void *)keybd_report_data;
-
     /* call user initialization*/
     usr_keybrd_init();
 
@@ -242,20 +248,32 @@ uint8_t usbh_hid_ascii_code_get(hid_keybd_info *info)
 }
 
 /*!
-    \brief      decode keyboard information
-    \param[in]  udev: pointer to USB core instance
-    \param[in]  uhost: pointer to USB host
+    \brief      decode keyboard information, each key press gives one character, so the
+                characters of a barcode reader typing faster than the main loop are kept
+    \param[in]  event: usage change decoded from a report
     \param[out] none
     \retval     operation status
 */
-usbh_status usbh_hid_keybrd_decode(uint8_t *data)
+usbh_status usbh_hid_keybrd_decode(hid_event *event)
 {
     uint8_t output = 0U;
 
-    keybd_info.lshift = data[0] & KBD_LEFT_SHIFT;
-    keybd_info.rshift = data[0] & KBD_RIGHT_SHIFT;
+    if(HID_PAGE_KEYBOARD != event->page) {
+        return USBH_OK;
+    }
 
-    keybd_info.keys[0] = data[2];
+    if(0xE1U == event->usage) {
+        keybd_info.lshift = (uint8_t)event->value;
+        return USBH_OK;
+    } else if(0xE5U == event->usage) {
+        keybd_info.rshift = (uint8_t)event->value;
+        return USBH_OK;
+    } else if((0 == event->value) || (event->usage >= sizeof(kbd_codes))) {
+        /* key release, or a key without a character */
+        return USBH_OK;
+    } else {
+        keybd_info.keys[0] = (uint8_t)event->usage;
+    }
 
     if(keybd_info.lshift || keybd_info.rshift) {
         output = kbd_key_shift[kbd_codes[keybd_info.keys[0]]];
@@ -269,3 +287,25 @@ usbh_status usbh_hid_keybrd_decode(uint8_t *data)
 
     return USBH_OK;
 }
+
+/*!
+    \brief      compile the boot protocol report of a keyboard or mouse, for devices whose
+                report descriptor cannot be compiled
+    \param[in]  protocol: interface protocol, USB_HID_PROTOCOL_KEYBOARD or USB_HID_PROTOCOL_MOUSE
+    \param[out] map: report map
+    \retval     operation status, USBH_NOT_SUPPORTED for other devices
+*/
+usbh_status usbh_hid_boot_map_get(hid_report_map *map, uint8_t protocol)
+{
+    hid_parse_status status = HID_PARSE_NO_FIELD;
+
+    if(USB_HID_PROTOCOL_KEYBOARD == protocol) {
+        status = hid_report_desc_parse(map, boot_keybrd_desc, sizeof(boot_keybrd_desc));
+    } else if(USB_HID_PROTOCOL_MOUSE == protocol) {
+        status = hid_report_desc_parse(map, boot_mouse_desc, sizeof(boot_mouse_desc));
+    } else {
+        /* no boot protocol */
+    }
+
+    return (HID_PARSE_OK == status) ? USBH_OK : USBH_NOT_SUPPORTED;
+}
@@ -0,0 +1,159 @@
+/*!
+    \file    usbh_hub.h
+    \brief   header file for the usbh_hub.c
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef USBH_HUB_H
+#define USBH_HUB_H
+
+#include "usbh_enum.h"
+#include "usbh_transc.h"
+
+/* hub ports served, the ports above stay unpowered */
+#ifndef USBH_HUB_MAX_PORTS
+#define USBH_HUB_MAX_PORTS                              4U
+#endif /* USBH_HUB_MAX_PORTS */
+
+#define USB_DESCTYPE_HUB                                0x29U            /*!< hub descriptor type */
+#define USB_HUB_DESC_SIZE                               9U               /*!< hub descriptor size for up to 7 ports */
+#define HUB_RECPTYPE_PORT                               0x03U            /*!< recipient "other" of the port requests */
+
+/* hub class feature selectors */
+#define HUB_FEATURE_PORT_RESET                          4U               /*!< port reset */
+#define HUB_FEATURE_PORT_POWER                          8U               /*!< port power */
+#define HUB_FEATURE_C_PORT_CONNECTION                   16U              /*!< first port change feature, bit n of wPortChange is feature 16 + n */
+
+/* port status bits (wPortStatus) */
+#define HUB_PORT_STAT_CONNECTION                        0x0001U          /*!< a device is connected */
+#define HUB_PORT_STAT_ENABLE                            0x0002U          /*!< port enabled */
+#define HUB_PORT_STAT_OVER_CURRENT                      0x0008U          /*!< over-current on the port */
+#define HUB_PORT_STAT_RESET                             0x0010U          /*!< reset signaling running */
+#define HUB_PORT_STAT_LOW_SPEED                         0x0200U          /*!< low speed device connected */
+#define HUB_PORT_STAT_HIGH_SPEED                        0x0400U          /*!< high speed device connected */
+
+/* port change bits (wPortChange) */
+#define HUB_PORT_C_CONNECTION                           0x0001U          /*!< connection changed */
+#define HUB_PORT_C_ENABLE                               0x0002U          /*!< port disabled by an error */
+#define HUB_PORT_C_OVER_CURRENT                         0x0008U          /*!< over-current indicator changed */
+#define HUB_PORT_C_MASK                                 0x001FU          /*!< change bits cleared by the driver */
+
+/* timing of the port state machines (ms) */
+#define HUB_DEBOUNCE_TIME                               100U             /*!< a connection must be stable this long */
+#define HUB_RESET_TIMEOUT                               500U             /*!< longest port reset */
+#define HUB_RESET_RECOVERY                              10U              /*!< reset recovery time */
+#define HUB_ENUM_TIMEOUT                                5000U            /*!< longest enumeration of a device */
+#define HUB_ENUM_RETRY                                  3U               /*!< enumeration attempts before a port is disabled */
+
+/* states of the hub class requests */
+typedef enum {
+    HUB_REQ_GET_DESC = 0U,                                               /*!< get the hub descriptor */
+    HUB_REQ_PORT_POWER,                                                  /*!< switch the ports on */
+    HUB_REQ_POWER_WAIT,                                                  /*!< wait for the port power to become good */
+    HUB_REQ_IDLE                                                         /*!< requests done */
+} hub_ctlstate;
+
+/* states of the status change endpoint */
+typedef enum {
+    HUB_INT_GET_DATA = 0U,                                               /*!< issue an IN transfer */
+    HUB_INT_POLL                                                         /*!< wait for the transfer or the next poll */
+} hub_int_state;
+
+/* states of a hub port */
+typedef enum {
+    HUB_PORT_IDLE = 0U,                                                  /*!< no device connected */
+    HUB_PORT_DEBOUNCE,                                                   /*!< connection seen, waiting for it to settle and for the reset slot */
+    HUB_PORT_RESET_WAIT,                                                 /*!< port reset running */
+    HUB_PORT_RECOVERY,                                                   /*!< port reset done, reset recovery time */
+    HUB_PORT_ENUM,                                                       /*!< device enumerating */
+    HUB_PORT_RUN,                                                        /*!< device running its class */
+    HUB_PORT_DISABLED                                                    /*!< device failed, waiting for a disconnect */
+} hub_port_state;
+
+/* port request in progress */
+typedef enum {
+    HUB_OP_NONE = 0U,                                                    /*!< no request */
+    HUB_OP_STATUS,                                                       /*!< get the port status */
+    HUB_OP_CLEAR,                                                        /*!< clear the reported change bits */
+    HUB_OP_RESET                                                         /*!< reset the port */
+} hub_port_op;
+
+/* hub descriptor */
+typedef struct {
+    uint8_t  bLength;                                                    /*!< size of the descriptor */
+    uint8_t  bDescriptorType;                                            /*!< type of the descriptor */
+    uint8_t  bNbrPorts;                                                  /*!< number of downstream ports */
+    uint16_t wHubCharacteristics;                                        /*!< power switching and over-current modes */
+    uint8_t  bPwrOn2PwrGood;                                             /*!< port power on time, 2 ms units */
+    uint8_t  bHubContrCurrent;                                           /*!< current of the hub controller (mA) */
+} usb_desc_hub;
+
+/* state of a hub port */
+typedef struct {
+    hub_port_state       state;                                          /*!< port state */
+    hub_port_op          op;                                             /*!< port request in progress */
+    uint16_t             status;                                         /*!< last wPortStatus */
+    uint16_t             change;                                         /*!< last wPortChange */
+    uint16_t             clear;                                          /*!< change bits still to clear */
+    uint8_t              pending;                                        /*!< status change reported, the status has to be read */
+    uint8_t              retry;                                          /*!< failed enumeration attempts */
+    uint32_t             timer;                                          /*!< start of the current wait */
+} usbh_hub_port;
+
+/* structure for hub process */
+typedef struct _hub_process {
+    uint8_t              pipe_in;                                        /*!< status change pipe */
+    uint8_t              ep_in;                                          /*!< status change endpoint */
+    uint16_t             len;                                            /*!< status change transfer length */
+    uint16_t             poll;                                           /*!< status change polling interval (frames) */
+    uint8_t              data_ready;                                     /*!< status change data processed */
+    uint8_t              tick_ms;                                        /*!< frames per ms */
+    uint32_t             timer;                                          /*!< start of the current poll */
+    hub_ctlstate         ctl_state;                                      /*!< class request state */
+    hub_int_state        int_state;                                      /*!< status change endpoint state */
+    usb_desc_hub         hub_desc;                                       /*!< hub descriptor */
+    uint8_t              port_num;                                       /*!< ports served */
+    uint8_t              req_port;                                       /*!< port with a request in progress, 0 if none */
+    uint8_t              enum_port;                                      /*!< port whose device may answer at address 0, 0 if none */
+    uint8_t              next_port;                                      /*!< port served first in the next round */
+    uint32_t             int_buf[2];                                     /*!< status change bitmap, bit n for port n */
+    uint32_t             port_buf[1];                                    /*!< port status and change */
+    usbh_hub_port        port[USBH_HUB_MAX_PORTS];                       /*!< port states */
+    usbh_host            dev[USBH_HUB_MAX_PORTS];                        /*!< hosts of the devices behind the ports */
+} usbh_hub_handler;
+
+extern usbh_class usbh_hub;
+
+/* function declarations */
+/* set the user callbacks of the devices behind the hub */
+void usbh_hub_user_register(usbh_user_cb *user_cb);
+
+#endif /* USBH_HUB_H */
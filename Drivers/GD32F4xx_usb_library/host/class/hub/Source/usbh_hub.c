@@ -0,0 +1,724 @@
+/*!
+    \file    usbh_hub.c
+    \brief   USB host hub class driver
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include "usbh_pipe.h"
+#include "usbh_hub.h"
+
+/* time in frames from a time in ms */
+#define HUB_TICKS(hub, ms)      ((uint32_t)(ms) * (hub)->tick_ms)
+
+/* user callbacks of the devices behind the hub, NULL to use the ones of the hub */
+static usbh_user_cb *hub_dev_cb = NULL;
+
+/* local function prototypes ('static') */
+static usbh_status usbh_hub_itf_init(usbh_host *uhost);
+static void usbh_hub_itf_deinit(usbh_host *uhost);
+static usbh_status usbh_hub_class_req(usbh_host *uhost);
+static usbh_status usbh_hub_handle(usbh_host *uhost);
+static usbh_status usbh_hub_desc_get(usbh_host *uhost, uint16_t len);
+static usbh_status usbh_hub_port_feature(usbh_host *uhost, uint8_t request, uint16_t feature, uint8_t port);
+static usbh_status usbh_hub_port_status_get(usbh_host *uhost, uint8_t port, uint8_t *buf);
+static void usbh_hub_int_process(usbh_host *uhost, usbh_hub_handler *hub);
+static void usbh_hub_ports_process(usbh_host *uhost, usbh_hub_handler *hub);
+static void usbh_hub_port_step(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx);
+static void usbh_hub_port_event(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx);
+static void usbh_hub_port_timer(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx);
+static void usbh_hub_port_stop(usbh_hub_handler *hub, uint8_t idx);
+static void usbh_hub_port_fail(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx);
+
+usbh_class usbh_hub = {
+    HUB_CLASS,
+    usbh_hub_itf_init,
+    usbh_hub_itf_deinit,
+    usbh_hub_class_req,
+    usbh_hub_handle,
+    NULL
+};
+
+/*!
+    \brief      set the user callbacks of the devices behind the hub
+    \param[in]  user_cb: user callbacks, NULL to use the callbacks of the hub
+    \param[out] none
+    \retval     none
+*/
+void usbh_hub_user_register(usbh_user_cb *user_cb)
+{
+    hub_dev_cb = user_cb;
+}
+
+/*!
+    \brief      initialize the hub class
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_itf_init(usbh_host *uhost)
+{
+    static usbh_hub_handler hub_handler;
+
+    usbh_hub_handler *hub = &hub_handler;
+    uint8_t interface = usbh_interface_find(&uhost->dev_prop, HUB_CLASS, 0xFFU, 0xFFU);
+
+    /* a single hub on the root port is supported, not a hub behind a hub */
+    if((0xFFU == interface) || (NULL != uhost->parent)) {
+        uhost->usr_cb->dev_not_supported();
+
+        return USBH_FAIL;
+    }
+
+    usbh_interface_select(&uhost->dev_prop, interface);
+
+    usb_desc_ep *ep_desc = &uhost->dev_prop.cfg_desc_set.itf_desc_set[interface][0].ep_desc[0];
+
+    if((0U == (ep_desc->bEndpointAddress & 0x80U)) || (ep_desc->wMaxPacketSize > sizeof(hub->int_buf))) {
+        uhost->usr_cb->dev_not_supported();
+
+        return USBH_FAIL;
+    }
+
+    memset((void *)hub, 0U, sizeof(usbh_hub_handler));
+
+    hub->ep_in = ep_desc->bEndpointAddress;
+    hub->len = ep_desc->wMaxPacketSize;
+
+    /* the timer counts micro-frames on a high speed port */
+    if(0U == ep_desc->bInterval) {
+        hub->tick_ms = (PORT_SPEED_HIGH == uhost->dev_prop.speed) ? 8U : 1U;
+        hub->poll = 1U;
+    } else if(PORT_SPEED_HIGH == uhost->dev_prop.speed) {
+        hub->tick_ms = 8U;
+        hub->poll = (uint16_t)(1U << (USB_MIN(ep_desc->bInterval, 16U) - 1U));
+    } else {
+        hub->tick_ms = 1U;
+        hub->poll = ep_desc->bInterval;
+    }
+
+    hub->pipe_in = usbh_pipe_dev_allocate(uhost, hub->ep_in, USB_EPTYPE_INTR);
+
+    if((uint8_t)HP_ERROR == hub->pipe_in) {
+        return USBH_BUSY;
+    }
+
+    usbh_pipe_create(uhost->data, \
+                     &uhost->dev_prop, \
+                     hub->pipe_in, \
+                     USB_EPTYPE_INTR, \
+                     hub->len);
+
+    usbh_pipe_toggle_set(uhost->data, hub->pipe_in, 0U);
+
+    if(USBH_OK != usbh_pipe_periodic_set(uhost, hub->pipe_in, ep_desc->bInterval)) {
+        usbh_pipe_free(uhost->data, hub->pipe_in);
+
+        return USBH_FAIL;
+    }
+
+    hub->ctl_state = HUB_REQ_GET_DESC;
+    hub->int_state = HUB_INT_GET_DATA;
+
+    uhost->active_class->class_data = (void *)hub;
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      deinitialize the hub class, the devices behind the hub go with it
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_itf_deinit(usbh_host *uhost)
+{
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+
+    if(NULL == hub) {
+        return;
+    }
+
+    for(uint8_t idx = 0U; idx < hub->port_num; idx++) {
+        usbh_hub_port_stop(hub, idx);
+
+        hub->port[idx].state = HUB_PORT_IDLE;
+    }
+
+    if(0U != hub->pipe_in) {
+        usb_pipe_halt(uhost->data, hub->pipe_in);
+        usbh_pipe_free(uhost->data, hub->pipe_in);
+
+        hub->pipe_in = 0U;
+    }
+
+    uhost->active_class->class_data = NULL;
+}
+
+/*!
+    \brief      handle the hub class requests: read the hub descriptor and power the ports
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_class_req(usbh_host *uhost)
+{
+    usbh_status status = USBH_BUSY;
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+
+    switch(hub->ctl_state) {
+    case HUB_REQ_GET_DESC:
+        if(USBH_OK == usbh_hub_desc_get(uhost, USB_HUB_DESC_SIZE)) {
+            uint8_t *buf = uhost->dev_prop.data;
+
+            hub->hub_desc.bLength = buf[0];
+            hub->hub_desc.bDescriptorType = buf[1];
+            hub->hub_desc.bNbrPorts = buf[2];
+            hub->hub_desc.wHubCharacteristics = (uint16_t)(buf[3] | ((uint16_t)buf[4] << 8U));
+            hub->hub_desc.bPwrOn2PwrGood = buf[5];
+            hub->hub_desc.bHubContrCurrent = buf[6];
+
+            hub->port_num = USB_MIN(hub->hub_desc.bNbrPorts, USBH_HUB_MAX_PORTS);
+            hub->req_port = 1U;
+
+            hub->ctl_state = (0U != hub->port_num) ? HUB_REQ_PORT_POWER : HUB_REQ_IDLE;
+        }
+        break;
+
+    case HUB_REQ_PORT_POWER:
+        if(USBH_OK == usbh_hub_port_feature(uhost, USB_SET_FEATURE, HUB_FEATURE_PORT_POWER, hub->req_port)) {
+            if(++hub->req_port > hub->port_num) {
+                hub->req_port = 0U;
+                hub->timer = uhost->control.timer;
+
+                hub->ctl_state = HUB_REQ_POWER_WAIT;
+            }
+        }
+        break;
+
+    case HUB_REQ_POWER_WAIT:
+        if((uhost->control.timer - hub->timer) >= HUB_TICKS(hub, 2U * hub->hub_desc.bPwrOn2PwrGood)) {
+            /* read every port once, devices present at power on may not raise a change */
+            for(uint8_t idx = 0U; idx < hub->port_num; idx++) {
+                hub->port[idx].pending = 1U;
+            }
+
+            hub->ctl_state = HUB_REQ_IDLE;
+        }
+        break;
+
+    case HUB_REQ_IDLE:
+    default:
+        status = USBH_OK;
+        break;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      manage the hub: status change endpoint, port state machines and the devices behind the ports
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_handle(usbh_host *uhost)
+{
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+
+    usbh_hub_int_process(uhost, hub);
+
+    usbh_hub_ports_process(uhost, hub);
+
+    /* run the devices, each one as if it were alone on the bus */
+    for(uint8_t idx = 0U; idx < hub->port_num; idx++) {
+        if((HUB_PORT_ENUM == hub->port[idx].state) || (HUB_PORT_RUN == hub->port[idx].state)) {
+            usbh_core_task(&hub->dev[idx]);
+        }
+    }
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      poll the status change endpoint of the hub
+    \param[in]  uhost: pointer to USB host
+    \param[in]  hub: pointer to hub handler
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_int_process(usbh_host *uhost, usbh_hub_handler *hub)
+{
+    usb_urb_state urb_state;
+
+    switch(hub->int_state) {
+    case HUB_INT_GET_DATA:
+        usbh_data_recev(uhost->data, (uint8_t *)hub->int_buf, hub->pipe_in, hub->len);
+
+        hub->timer = uhost->control.timer;
+        hub->data_ready = 0U;
+        hub->int_state = HUB_INT_POLL;
+        break;
+
+    case HUB_INT_POLL:
+        urb_state = usbh_urbstate_get(uhost->data, hub->pipe_in);
+
+        if((URB_DONE == urb_state) && (0U == hub->data_ready)) {
+            uint8_t *map = (uint8_t *)hub->int_buf;
+
+            hub->data_ready = 1U;
+
+            /* bit 0 is the hub itself, its local power and over-current changes are not handled */
+            for(uint8_t idx = 0U; idx < hub->port_num; idx++) {
+                if(map[(idx + 1U) >> 3U] & (1U << ((idx + 1U) & 0x07U))) {
+                    hub->port[idx].pending = 1U;
+                }
+            }
+        } else if(URB_STALL == urb_state) {
+            if(USBH_OK == usbh_clrfeature(uhost, hub->ep_in, hub->pipe_in)) {
+                hub->int_state = HUB_INT_GET_DATA;
+            }
+            break;
+        } else {
+            /* NAK or no change, wait for the next poll */
+        }
+
+        if((uhost->control.timer - hub->timer) >= hub->poll) {
+            hub->int_state = HUB_INT_GET_DATA;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*!
+    \brief      step the port state machines, one port request at a time
+    \param[in]  uhost: pointer to USB host
+    \param[in]  hub: pointer to hub handler
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_ports_process(usbh_host *uhost, usbh_hub_handler *hub)
+{
+    /* a port in the middle of a request keeps the control pipe until it is done */
+    if(0U != hub->req_port) {
+        usbh_hub_port_step(uhost, hub, hub->req_port - 1U);
+
+        return;
+    }
+
+    /* the port served first rotates so that a busy port cannot starve the others */
+    for(uint8_t i = 0U; i < hub->port_num; i++) {
+        uint8_t idx = (uint8_t)((hub->next_port + i) % hub->port_num);
+
+        usbh_hub_port_step(uhost, hub, idx);
+
+        if(0U != hub->req_port) {
+            hub->next_port = (uint8_t)((idx + 1U) % hub->port_num);
+            break;
+        }
+    }
+}
+
+/*!
+    \brief      step the state machine of a port
+    \param[in]  uhost: pointer to USB host
+    \param[in]  hub: pointer to hub handler
+    \param[in]  idx: port index, the port number minus 1
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_port_step(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx)
+{
+    usbh_hub_port *port = &hub->port[idx];
+    uint8_t num = idx + 1U;
+    usbh_status status;
+
+    switch(port->op) {
+    case HUB_OP_STATUS:
+        hub->req_port = num;
+
+        status = usbh_hub_port_status_get(uhost, num, (uint8_t *)hub->port_buf);
+
+        if(USBH_OK == status) {
+            uint8_t *buf = (uint8_t *)hub->port_buf;
+
+            port->status = (uint16_t)(buf[0] | ((uint16_t)buf[1] << 8U));
+            port->change = (uint16_t)(buf[2] | ((uint16_t)buf[3] << 8U));
+            port->clear = port->change & HUB_PORT_C_MASK;
+
+            port->op = HUB_OP_CLEAR;
+        } else if(USBH_FAIL == status) {
+            /* read the status again later */
+            port->op = HUB_OP_NONE;
+            port->pending = 1U;
+        } else {
+            /* transfer in progress */
+        }
+
+        if(USBH_BUSY != status) {
+            hub->req_port = 0U;
+        }
+        break;
+
+    case HUB_OP_CLEAR:
+        if(0U != port->clear) {
+            uint8_t bit = 0U;
+
+            while(0U == (port->clear & (1U << bit))) {
+                bit++;
+            }
+
+            hub->req_port = num;
+
+            status = usbh_hub_port_feature(uhost, USB_CLEAR_FEATURE, HUB_FEATURE_C_PORT_CONNECTION + bit, num);
+
+            if(USBH_BUSY != status) {
+                hub->req_port = 0U;
+                port->clear &= (uint16_t)~(1U << bit);
+            }
+        } else {
+            port->op = HUB_OP_NONE;
+
+            usbh_hub_port_event(uhost, hub, idx);
+        }
+        break;
+
+    case HUB_OP_RESET:
+        hub->req_port = num;
+
+        status = usbh_hub_port_feature(uhost, USB_SET_FEATURE, HUB_FEATURE_PORT_RESET, num);
+
+        if(USBH_BUSY != status) {
+            hub->req_port = 0U;
+            port->op = HUB_OP_NONE;
+
+            if(USBH_OK == status) {
+                port->timer = uhost->control.timer;
+                port->state = HUB_PORT_RESET_WAIT;
+            } else {
+                usbh_hub_port_fail(uhost, hub, idx);
+            }
+        }
+        break;
+
+    case HUB_OP_NONE:
+    default:
+        if(0U != port->pending) {
+            port->pending = 0U;
+            port->op = HUB_OP_STATUS;
+        } else {
+            usbh_hub_port_timer(uhost, hub, idx);
+        }
+        break;
+    }
+}
+
+/*!
+    \brief      act on a new port status
+    \param[in]  uhost: pointer to USB host
+    \param[in]  hub: pointer to hub handler
+    \param[in]  idx: port index
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_port_event(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx)
+{
+    usbh_hub_port *port = &hub->port[idx];
+
+    /* connect or disconnect: start over, a new connection is debounced first */
+    if((port->change & HUB_PORT_C_CONNECTION) || (0U == (port->status & HUB_PORT_STAT_CONNECTION))) {
+        usbh_hub_port_stop(hub, idx);
+
+        if(port->status & HUB_PORT_STAT_CONNECTION) {
+            port->retry = 0U;
+            port->timer = uhost->control.timer;
+            port->state = HUB_PORT_DEBOUNCE;
+        } else {
+            port->state = HUB_PORT_IDLE;
+        }
+    } else if((port->change & HUB_PORT_C_OVER_CURRENT) && (port->status & HUB_PORT_STAT_OVER_CURRENT)) {
+        uhost->usr_cb->dev_over_currented();
+
+        usbh_hub_port_stop(hub, idx);
+        port->state = HUB_PORT_DISABLED;
+    } else if(HUB_PORT_RESET_WAIT == port->state) {
+        /* the port is enabled at the end of the reset */
+        if((0U == (port->status & HUB_PORT_STAT_RESET)) && (port->status & HUB_PORT_STAT_ENABLE)) {
+            port->timer = uhost->control.timer;
+            port->state = HUB_PORT_RECOVERY;
+        }
+    } else if((port->change & HUB_PORT_C_ENABLE) && (0U == (port->status & HUB_PORT_STAT_ENABLE))) {
+        /* the hub disabled the port after an error of the device */
+        if((HUB_PORT_ENUM == port->state) || (HUB_PORT_RUN == port->state)) {
+            usbh_hub_port_fail(uhost, hub, idx);
+        }
+    } else {
+        /* no operation */
+    }
+}
+
+/*!
+    \brief      handle the timed transitions of a port
+    \param[in]  uhost: pointer to USB host
+    \param[in]  hub: pointer to hub handler
+    \param[in]  idx: port index
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_port_timer(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx)
+{
+    usbh_hub_port *port = &hub->port[idx];
+    usbh_host *dev = &hub->dev[idx];
+    uint32_t elapsed = uhost->control.timer - port->timer;
+
+    switch(port->state) {
+    case HUB_PORT_DEBOUNCE:
+        /* only one device may answer at the default address, reset one port at a time */
+        if((elapsed >= HUB_TICKS(hub, HUB_DEBOUNCE_TIME)) && (0U == hub->enum_port)) {
+            hub->enum_port = idx + 1U;
+            port->op = HUB_OP_RESET;
+        }
+        break;
+
+    case HUB_PORT_RESET_WAIT:
+        if(elapsed >= HUB_TICKS(hub, HUB_RESET_TIMEOUT)) {
+            usbh_hub_port_fail(uhost, hub, idx);
+        }
+        break;
+
+    case HUB_PORT_RECOVERY:
+        if(elapsed >= HUB_TICKS(hub, HUB_RESET_RECOVERY)) {
+            uint32_t speed = PORT_SPEED_FULL;
+
+            if(port->status & HUB_PORT_STAT_LOW_SPEED) {
+                speed = PORT_SPEED_LOW;
+            } else if(port->status & HUB_PORT_STAT_HIGH_SPEED) {
+                speed = PORT_SPEED_HIGH;
+            } else {
+                /* full speed device */
+            }
+
+            /* full and low speed devices behind a high speed hub need split transactions */
+            if((PORT_SPEED_HIGH == uhost->dev_prop.speed) && (PORT_SPEED_HIGH != speed)) {
+                uhost->usr_cb->dev_not_supported();
+
+                usbh_hub_port_stop(hub, idx);
+                port->state = HUB_PORT_DISABLED;
+            } else if(USBH_OK != usbh_child_init(dev, uhost, idx + 1U, hub_dev_cb)) {
+                usbh_hub_port_stop(hub, idx);
+                port->state = HUB_PORT_DISABLED;
+            } else {
+                usbh_child_attach(dev, speed);
+
+                port->timer = uhost->control.timer;
+                port->state = HUB_PORT_ENUM;
+            }
+        }
+        break;
+
+    case HUB_PORT_ENUM:
+        if(ENUM_DEV_CONFIGURED == dev->enum_state) {
+            /* the device has its address, the next port may be reset */
+            if((idx + 1U) == hub->enum_port) {
+                hub->enum_port = 0U;
+            }
+
+            port->state = HUB_PORT_RUN;
+        } else if((HOST_DEFAULT == dev->cur_state) || (elapsed >= HUB_TICKS(hub, HUB_ENUM_TIMEOUT))) {
+            usbh_hub_port_fail(uhost, hub, idx);
+        } else {
+            /* enumeration in progress */
+        }
+        break;
+
+    case HUB_PORT_RUN:
+        /* the class stopped the device after an error */
+        if(HOST_DEFAULT == dev->cur_state) {
+            usbh_hub_port_fail(uhost, hub, idx);
+        }
+        break;
+
+    case HUB_PORT_IDLE:
+    case HUB_PORT_DISABLED:
+    default:
+        break;
+    }
+}
+
+/*!
+    \brief      stop the device behind a port and give the reset slot back
+    \param[in]  hub: pointer to hub handler
+    \param[in]  idx: port index
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_port_stop(usbh_hub_handler *hub, uint8_t idx)
+{
+    if((HUB_PORT_ENUM == hub->port[idx].state) || (HUB_PORT_RUN == hub->port[idx].state)) {
+        usbh_child_detach(&hub->dev[idx]);
+    }
+
+    if((idx + 1U) == hub->enum_port) {
+        hub->enum_port = 0U;
+    }
+}
+
+/*!
+    \brief      handle a failed reset or enumeration, the port is tried again a few times
+    \param[in]  uhost: pointer to USB host
+    \param[in]  hub: pointer to hub handler
+    \param[in]  idx: port index
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_port_fail(usbh_host *uhost, usbh_hub_handler *hub, uint8_t idx)
+{
+    usbh_hub_port *port = &hub->port[idx];
+
+    usbh_hub_port_stop(hub, idx);
+
+    if(++port->retry < HUB_ENUM_RETRY) {
+        port->timer = uhost->control.timer;
+        port->state = HUB_PORT_DEBOUNCE;
+    } else {
+        uhost->usr_cb->dev_error();
+
+        port->state = HUB_PORT_DISABLED;
+    }
+}
+
+/*!
+    \brief      get the hub descriptor
+    \param[in]  uhost: pointer to USB host
+    \param[in]  len: length of the descriptor
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_desc_get(usbh_host *uhost, uint16_t len)
+{
+    usbh_status status = USBH_BUSY;
+
+    if(CTL_IDLE == uhost->control.ctl_state) {
+        uhost->control.setup.req = (usb_req) {
+            .bmRequestType = USB_TRX_IN | USB_RECPTYPE_DEV | USB_REQTYPE_CLASS,
+            .bRequest      = USB_GET_DESCRIPTOR,
+            .wValue        = USBH_DESC(USB_DESCTYPE_HUB),
+            .wIndex        = 0U,
+            .wLength       = len
+        };
+
+        uhost->control.error_count = 0U;
+
+        usbh_ctlstate_config(uhost, uhost->dev_prop.data, len);
+    }
+
+    status = usbh_ctl_handler(uhost);
+
+    if(USBH_FAIL == status) {
+        /* allow the request to be issued again */
+        uhost->control.ctl_state = CTL_IDLE;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      set or clear a port feature
+    \param[in]  uhost: pointer to USB host
+    \param[in]  request: USB_SET_FEATURE or USB_CLEAR_FEATURE
+    \param[in]  feature: port feature selector
+    \param[in]  port: port number
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_port_feature(usbh_host *uhost, uint8_t request, uint16_t feature, uint8_t port)
+{
+    usbh_status status = USBH_BUSY;
+
+    if(CTL_IDLE == uhost->control.ctl_state) {
+        uhost->control.setup.req = (usb_req) {
+            .bmRequestType = USB_TRX_OUT | HUB_RECPTYPE_PORT | USB_REQTYPE_CLASS,
+            .bRequest      = request,
+            .wValue        = feature,
+            .wIndex        = port,
+            .wLength       = 0U
+        };
+
+        uhost->control.error_count = 0U;
+
+        usbh_ctlstate_config(uhost, NULL, 0U);
+    }
+
+    status = usbh_ctl_handler(uhost);
+
+    if(USBH_FAIL == status) {
+        uhost->control.ctl_state = CTL_IDLE;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      get the status and the change bits of a port
+    \param[in]  uhost: pointer to USB host
+    \param[in]  port: port number
+    \param[out] buf: wPortStatus and wPortChange, 4 bytes
+    \retval     operation status
+*/
+static usbh_status usbh_hub_port_status_get(usbh_host *uhost, uint8_t port, uint8_t *buf)
+{
+    usbh_status status = USBH_BUSY;
+
+    if(CTL_IDLE == uhost->control.ctl_state) {
+        uhost->control.setup.req = (usb_req) {
+            .bmRequestType = USB_TRX_IN | HUB_RECPTYPE_PORT | USB_REQTYPE_CLASS,
+            .bRequest      = USB_GET_STATUS,
+            .wValue        = 0U,
+            .wIndex        = port,
+            .wLength       = 4U
+        };
+
+        uhost->control.error_count = 0U;
+
+        usbh_ctlstate_config(uhost, buf, 4U);
+    }
+
+    status = usbh_ctl_handler(uhost);
+
+    if(USBH_FAIL == status) {
+        uhost->control.ctl_state = CTL_IDLE;
+    }
+
+    return status;
+}
@@ -99,6 +99,7 @@ typedef struct _msc_process {
     bbb_handle      bbb;                                 /*!< MSC BBB correlation parameter handle */
     msc_lun         unit[MSC_MAX_SUPPORTED_LUN];         /*!< MSC LUN unit buff */
     uint32_t        timer;                               /*!< MSC read/write timer */
+    usbh_host       *host;                               /*!< host of the device using the handler, NULL if free */
 } usbh_msc_handler;
 
 extern usbh_class usbh_msc;
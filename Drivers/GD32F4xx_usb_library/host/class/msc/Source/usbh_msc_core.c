@@ -176,6 +176,10 @@ static void usbh_msc_itf_deinit(usbh_host *uhost)
 {
     usbh_msc_handler *msc = (usbh_msc_handler *)uhost->active_class->class_data;
 
+    if(NULL == msc) {
+        return;
+    }
+
     if(msc->pipe_out) {
         usb_pipe_halt(uhost->data, msc->pipe_out);
         usbh_pipe_free(uhost->data, msc->pipe_out);
@@ -189,6 +193,9 @@ static void usbh_msc_itf_deinit(usbh_host *uhost)
 
         msc->pipe_in = 0U;
     }
+
+    msc->host = NULL;
+    uhost->active_class->class_data = NULL;
 }
 
 /*!
@@ -201,19 +208,18 @@ static usbh_status usbh_msc_itf_init(usbh_host *uhost)
 {
     usbh_status status = USBH_OK;
 
+    static usbh_msc_handler msc_handler;
+
     uint8_t interface = usbh_interface_find(&uhost->dev_prop, MSC_CLASS, USB_MSC_SUBCLASS_SCSI, MSC_PROTOCOL);
 
-    if(0xFFU == interface) {
+    /* a single mass storage device is served, a second one behind a hub is not supported */
+    if((0xFFU == interface) || ((NULL != msc_handler.host) && (uhost != msc_handler.host))) {
         uhost->usr_cb->dev_not_supported();
 
         status = USBH_FAIL;
     } else {
-        static usbh_msc_handler msc_handler;
-
         memset((void *)&msc_handler, 0U, sizeof(usbh_msc_handler));
 
-        uhost->active_class->class_data = (void *)&msc_handler;
-
         usbh_interface_select(&uhost->dev_prop, interface);
 
         usb_desc_ep *ep_desc = &uhost->dev_prop.cfg_desc_set.itf_desc_set[interface][0].ep_desc[0];
@@ -239,8 +245,23 @@ static usbh_status usbh_msc_itf_init(usbh_host *uhost)
         msc_handler.state = MSC_INIT;
         msc_handler.error = MSC_OK;
         msc_handler.req_state = MSC_REQ_IDLE;
-        msc_handler.pipe_out = usbh_pipe_allocate(uhost->data, msc_handler.ep_out);
-        msc_handler.pipe_in = usbh_pipe_allocate(uhost->data, msc_handler.ep_in);
+        msc_handler.pipe_out = usbh_pipe_dev_allocate(uhost, msc_handler.ep_out, USB_EPTYPE_BULK);
+
+        if((uint8_t)HP_ERROR == msc_handler.pipe_out) {
+            /* out of pipes, try again when another device gives its pipes back */
+            return USBH_BUSY;
+        }
+
+        msc_handler.pipe_in = usbh_pipe_dev_allocate(uhost, msc_handler.ep_in, USB_EPTYPE_BULK);
+
+        if((uint8_t)HP_ERROR == msc_handler.pipe_in) {
+            usbh_pipe_free(uhost->data, msc_handler.pipe_out);
+
+            return USBH_BUSY;
+        }
+
+        msc_handler.host = uhost;
+        uhost->active_class->class_data = (void *)&msc_handler;
 
         usbh_msc_bbb_init(uhost);
 
@@ -34,11 +34,76 @@ OF SUCH DAMAGE.
 
 #include "diskio.h"
 #include "usbh_msc_core.h"
+#include <string.h>
+
+/* sector buffer of the transfers from and to unaligned FatFs buffers when the channels use DMA */
+#define MSC_DMA_SECTOR_SIZE                 512U
 
 static volatile DSTATUS state = STA_NOINIT; /* disk status */
 
+static uint32_t dma_sector[MSC_DMA_SECTOR_SIZE / 4U];
+
 extern usbh_host usb_host_msc;
 
+/* local function prototypes ('static') */
+static usbh_status disk_sectors_rw(BYTE *buff, DWORD sector, UINT count, uint8_t write);
+
+/*!
+    \brief      read or write sectors, through an aligned sector buffer when the channel DMA cannot use buff
+    \param[in]  buff: pointer to the data buffer
+    \param[in]  sector: start sector number (LBA)
+    \param[in]  count: sector count
+    \param[in]  write: 1 to write, 0 to read
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status disk_sectors_rw(BYTE *buff, DWORD sector, UINT count, uint8_t write)
+{
+    usbh_status status = USBH_OK;
+    usb_core_driver *udev = (usb_core_driver *)usb_host_msc.data;
+
+    if((USB_USE_DMA != udev->bp.transfer_mode) || (0U == ((uint32_t)buff & 0x03U))) {
+        do {
+            if(write) {
+                status = usbh_msc_write(&usb_host_msc, 0U, sector, buff, count);
+            } else {
+                status = usbh_msc_read(&usb_host_msc, 0U, sector, buff, count);
+            }
+
+            if(!udev->host.connect_status) {
+                return USBH_FAIL;
+            }
+        } while(USBH_BUSY == status);
+
+        return status;
+    }
+
+    /* the channel DMA moves whole words, copy the sectors one by one */
+    for(; (USBH_OK == status) && (count > 0U); count--, sector++, buff += MSC_DMA_SECTOR_SIZE) {
+        if(write) {
+            memcpy(dma_sector, buff, MSC_DMA_SECTOR_SIZE);
+        }
+
+        do {
+            if(write) {
+                status = usbh_msc_write(&usb_host_msc, 0U, sector, (uint8_t *)dma_sector, 1U);
+            } else {
+                status = usbh_msc_read(&usb_host_msc, 0U, sector, (uint8_t *)dma_sector, 1U);
+            }
+
+            if(!udev->host.connect_status) {
+                return USBH_FAIL;
+            }
+        } while(USBH_BUSY == status);
+
+        if((USBH_OK == status) && (0U == write)) {
+            memcpy(buff, dma_sector, MSC_DMA_SECTOR_SIZE);
+        }
+    }
+
+    return status;
+}
+
 /*!
     \brief      initialize the disk drive
     \param[in]  drv: physical drive number (0)
@@ -94,13 +159,7 @@ DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
     }
 
     if(udev->host.connect_status) {
-        do {
-            status = usbh_msc_read(&usb_host_msc, drv, sector, buff, count);
-
-            if(!udev->host.connect_status) {
-                return RES_ERROR;
-            }
-        } while(USBH_BUSY == status);
+        status = disk_sectors_rw(buff, sector, count, 0U);
     }
 
     if(USBH_OK == status) {
@@ -139,13 +198,7 @@ DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
     }
 
     if(udev->host.connect_status) {
-        do {
-            status = usbh_msc_write(&usb_host_msc, drv, sector, (BYTE *)buff, count);
-
-            if(!udev->host.connect_status) {
-                return RES_ERROR;
-            }
-        } while(USBH_BUSY == status);
+        status = disk_sectors_rw((BYTE *)buff, sector, count, 1U);
     }
 
     if(USBH_OK == status) {
@@ -34,6 +34,7 @@ OF SUCH DAMAGE.
 
 #include "usbh_msc_core.h"
 #include "usbh_msc_scsi.h"
+#include <string.h>
 
 /*!
     \brief      send 'Inquiry' command to the device
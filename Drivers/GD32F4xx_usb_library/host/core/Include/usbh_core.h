@@ -40,6 +40,7 @@ OF SUCH DAMAGE.
 
 #define MSC_CLASS                                       0x08U                  /*!< USB MSC class */
 #define HID_CLASS                                       0x03U                  /*!< USB HID class */
+#define HUB_CLASS                                       0x09U                  /*!< USB hub class */
 #define MSC_PROTOCOL                                    0x50U                  /*!< USB MSC protocol */
 #define CBI_PROTOCOL                                    0x01U                  /*!< USB CBI protocol */
 
@@ -47,6 +48,7 @@ OF SUCH DAMAGE.
 
 #define USBH_DEV_ADDR_DEFAULT                           0U                     /*!< USBH device address default */
 #define USBH_DEV_ADDR                                   1U                     /*!< USBH device address */
+#define USBH_DEV_ADDR_MAX                               127U                   /*!< USBH highest device address */
 
 typedef enum {
     USBH_OK = 0U,                                      /*!< USB host OK status */
@@ -173,6 +175,7 @@ typedef struct {
     usbh_status (*class_requests)(struct _usbh_host *phost);
     usbh_status (*class_machine)(struct _usbh_host *phost);
     usbh_status (*class_sof)(struct _usbh_host *uhost);
+    usbh_status (*class_xfer_done)(struct _usbh_host *uhost, uint8_t pp_num);  /*!< periodic IN transfer ended, called from the interrupt, may be NULL */
     void         *class_data;                                                       /*!< USB class data pointer */
 } usbh_class;
 
@@ -221,6 +224,17 @@ typedef struct _usbh_host {
     uint8_t                             suspend_flag;                       /*!< host suspend flag */
     uint8_t                             dev_supp_remote_wkup;               /*!< record device remote wakeup function */
     usbh_wakeup_mode                    wakeup_mode;                        /*!< record wakeup mode */
+
+    usbh_class                          class_inst;                         /*!< copy of the active class holding the class data of this device */
+    uint8_t                             dev_addr;                           /*!< address given to the device in enumeration */
+    uint8_t                             hub_port;                           /*!< port of the parent hub, 0 for the root port */
+    struct _usbh_host                   *parent;                            /*!< host of the parent hub, NULL for the root port device */
+    struct _usbh_host                   *next;                              /*!< next downstream device sharing the USB core */
+
+    /* only used by the root port device, shared by the downstream devices */
+    struct _usbh_host                   *ctl_owner;                         /*!< device owning the control pipes between SETUP and the end of the transfer */
+    struct _usbh_host                   *ctl_bound;                         /*!< device the control pipes are programmed for */
+    uint32_t                            addr_map[4];                        /*!< device addresses in use, bit n for address n */
 } usbh_host;
 
 /*!
@@ -247,6 +261,21 @@ static inline uint32_t usbh_xfercount_get(usb_core_driver *udev, uint8_t pp_num)
     return udev->host.backup_xfercount[pp_num];
 }
 
+/*!
+    \brief      get the host of the device on the root port
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     pointer to the root USB host
+*/
+static inline usbh_host *usbh_root_get(usbh_host *uhost)
+{
+    while(NULL != uhost->parent) {
+        uhost = uhost->parent;
+    }
+
+    return uhost;
+}
+
 /* function declarations */
 /* USB host stack initializations */
 void usbh_init(usbh_host *uhost, usb_core_driver *udev, usb_core_enum usb_core, usbh_user_cb *user_cb);
@@ -258,5 +287,17 @@ usbh_status usbh_deinit(usbh_host *uhost);
 void usbh_core_task(usbh_host *uhost);
 /* handle the error on USB host side */
 void usbh_error_handler(usbh_host *uhost, usbh_status err_type);
+/* allocate a free device address */
+uint8_t usbh_addr_alloc(usbh_host *uhost);
+/* release a device address */
+void usbh_addr_free(usbh_host *uhost, uint8_t addr);
+/* initialize the host of a device behind a hub port */
+usbh_status usbh_child_init(usbh_host *child, usbh_host *parent, uint8_t port, usbh_user_cb *user_cb);
+/* start the enumeration of a device behind a hub port after the port reset */
+void usbh_child_attach(usbh_host *child, uint32_t speed);
+/* stop a device behind a hub port and release its resources */
+void usbh_child_detach(usbh_host *child);
+/* find the device running a class on the root port or behind a hub */
+usbh_host *usbh_dev_find(usbh_host *uhost, uint8_t class_code);
 
 #endif /* USBH_CORE_H */
@@ -46,6 +46,16 @@ OF SUCH DAMAGE.
 #define HP_ERROR                0xFFFFU           /*!< host pipe error status */
 #define HP_USED_MASK            0x7FFFU           /*!< host pipe used mask */
 
+/* pipes one device may hold besides the control pipes, lower it to share the pipes between the devices behind a hub */
+#ifndef USBH_DEV_PIPE_MAX
+#define USBH_DEV_PIPE_MAX               HP_MAX
+#endif /* USBH_DEV_PIPE_MAX */
+
+/* free pipes kept for interrupt and isochronous endpoints, bulk endpoints cannot take them */
+#ifndef USBH_PERIODIC_PIPE_RESERVE
+#define USBH_PERIODIC_PIPE_RESERVE      0U
+#endif /* USBH_PERIODIC_PIPE_RESERVE */
+
 /*!
     \brief      set toggle for a pipe
     \param[in]  udev: pointer to USB core instance
@@ -94,9 +104,15 @@ uint8_t usbh_pipe_update(usb_core_driver *udev, \
                          uint16_t ep_mpl);
 /* allocate a new pipe */
 uint8_t usbh_pipe_allocate(usb_core_driver *udev, uint8_t ep_addr);
+/* allocate a new pipe for an endpoint of a device within the pipe budget of the device */
+uint8_t usbh_pipe_dev_allocate(usbh_host *uhost, uint8_t ep_addr, uint8_t ep_type);
 /* free a pipe */
 uint8_t usbh_pipe_free(usb_core_driver *udev, uint8_t pp_num);
 /* delete all USB host pipe */
 uint8_t usbh_pipe_delete(usb_core_driver *udev);
+/* put an interrupt or isochronous pipe on the periodic schedule */
+usbh_status usbh_pipe_periodic_set(usbh_host *uhost, uint8_t pp_num, uint8_t interval);
+/* take a snapshot of the transfer counters of a pipe */
+void usbh_pipe_stat_get(usbh_host *uhost, uint8_t pp_num, usb_pipe_stat *stat);
 
 #endif /* USBH_PIPE_H */
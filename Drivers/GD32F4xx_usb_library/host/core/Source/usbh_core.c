@@ -40,6 +40,7 @@ OF SUCH DAMAGE.
 
 /* local function prototypes ('static') */
 static uint8_t usb_ev_sof(usbh_host *uhost);
+static uint8_t usb_ev_pipe_done(usbh_host *uhost, uint8_t pp_num);
 static uint8_t usb_ev_connect(usbh_host *uhost);
 static uint8_t usb_ev_disconnect(usbh_host *uhost);
 static usbh_status usbh_enum_task(usbh_host *uhost);
@@ -51,7 +52,8 @@ static void usb_hwp_resume(usb_core_driver *udev);
 usbh_ev_cb usbh_int_op = {
     usb_ev_connect,
     usb_ev_disconnect,
-    usb_ev_sof
+    usb_ev_sof,
+    usb_ev_pipe_done
 };
 
 usbh_ev_cb *usbh_int_fop = &usbh_int_op;
@@ -76,6 +78,18 @@ void usbh_init(usbh_host *uhost, usb_core_driver *udev, usb_core_enum usb_core,
 
     uhost->usr_cb = user_cb;
 
+    uhost->parent = NULL;
+    uhost->next = NULL;
+    uhost->hub_port = 0U;
+    uhost->dev_addr = USBH_DEV_ADDR;
+
+    /* the default address and the address of the root port device are never allocated */
+    for(uint8_t i = 0U; i < 4U; i++) {
+        uhost->addr_map[i] = 0U;
+    }
+
+    uhost->addr_map[0] = (1UL << USBH_DEV_ADDR_DEFAULT) | (1UL << USBH_DEV_ADDR);
+
     udev->host.connect_status = 0U;
 
     for(uint8_t i = 0U; i < USBFS_MAX_TX_FIFOS; i++) {
@@ -139,6 +153,7 @@ usbh_status usbh_class_register(usbh_host *uhost, usbh_class *uclass)
 usbh_status usbh_deinit(usbh_host *uhost)
 {
     usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    usbh_host *root = usbh_root_get(uhost);
 
     /* software initialize */
     uhost->cur_state = HOST_DEFAULT;
@@ -152,8 +167,20 @@ usbh_status usbh_deinit(usbh_host *uhost)
     uhost->dev_prop.speed = PORT_SPEED_FULL;
     uhost->dev_prop.cur_itf = 0xFFU;
 
-    usbh_pipe_free(udev, uhost->control.pipe_in_num);
-    usbh_pipe_free(udev, uhost->control.pipe_out_num);
+    /* give up the control pipes if a transfer was cut off */
+    if(uhost == root->ctl_owner) {
+        root->ctl_owner = NULL;
+    }
+
+    if(uhost == root->ctl_bound) {
+        root->ctl_bound = NULL;
+    }
+
+    /* the control pipes belong to the root port device */
+    if(NULL == uhost->parent) {
+        usbh_pipe_free(udev, uhost->control.pipe_in_num);
+        usbh_pipe_free(udev, uhost->control.pipe_out_num);
+    }
 
     return USBH_OK;
 }
@@ -169,8 +196,9 @@ void usbh_core_task(usbh_host *uhost)
     volatile usbh_status status = USBH_FAIL;
     usb_core_driver *udev = (usb_core_driver *)uhost->data;
 
-    /* check for host port events */
-    if(((0U == udev->host.connect_status) || (0U == udev->host.port_enabled)) && (HOST_DEFAULT != uhost->cur_state)) {
+    /* check for host port events, the hub driver handles the ports of downstream devices */
+    if((NULL == uhost->parent) && \
+         ((0U == udev->host.connect_status) || (0U == udev->host.port_enabled)) && (HOST_DEFAULT != uhost->cur_state)) {
         if(HOST_DEV_DETACHED != uhost->cur_state) {
             uhost->cur_state = HOST_DEV_DETACHED;
         }
@@ -178,7 +206,7 @@ void usbh_core_task(usbh_host *uhost)
 
     switch(uhost->cur_state) {
     case HOST_DEFAULT:
-        if(udev->host.connect_status) {
+        if((NULL == uhost->parent) && (udev->host.connect_status)) {
             uhost->cur_state = HOST_DETECT_DEV_SPEED;
 
             usb_mdelay(100U);
@@ -203,22 +231,26 @@ void usbh_core_task(usbh_host *uhost)
 
     case HOST_DEV_CONNECT:
         uhost->usr_cb->dev_attach();
-        uhost->control.pipe_out_num = usbh_pipe_allocate(udev, 0x00U);
-        uhost->control.pipe_in_num = usbh_pipe_allocate(udev, 0x80U);
-
-        /* open IN control pipe */
-        usbh_pipe_create(udev, \
-                         &uhost->dev_prop, \
-                         uhost->control.pipe_in_num, \
-                         USB_EPTYPE_CTRL, \
-                         (uint16_t)uhost->control.max_len);
-
-        /* open OUT control pipe */
-        usbh_pipe_create(udev, \
-                         &uhost->dev_prop, \
-                         uhost->control.pipe_out_num, \
-                         USB_EPTYPE_CTRL, \
-                         (uint16_t)uhost->control.max_len);
+
+        /* downstream devices use the control pipes of the root port device */
+        if(NULL == uhost->parent) {
+            uhost->control.pipe_out_num = usbh_pipe_allocate(udev, 0x00U);
+            uhost->control.pipe_in_num = usbh_pipe_allocate(udev, 0x80U);
+
+            /* open IN control pipe */
+            usbh_pipe_create(udev, \
+                             &uhost->dev_prop, \
+                             uhost->control.pipe_in_num, \
+                             USB_EPTYPE_CTRL, \
+                             (uint16_t)uhost->control.max_len);
+
+            /* open OUT control pipe */
+            usbh_pipe_create(udev, \
+                             &uhost->dev_prop, \
+                             uhost->control.pipe_out_num, \
+                             USB_EPTYPE_CTRL, \
+                             (uint16_t)uhost->control.max_len);
+        }
 
         uhost->cur_state = HOST_DEV_ENUM;
         break;
@@ -266,7 +298,9 @@ void usbh_core_task(usbh_host *uhost)
 
             for(uint8_t index = 0U; index < uhost->class_num; index++) {
                 if((uhost->uclass[index]->class_code == itf_class) || (0xFFU == itf_class)) {
-                    uhost->active_class = uhost->uclass[index];
+                    /* each device keeps its own class data */
+                    uhost->class_inst = *uhost->uclass[index];
+                    uhost->active_class = &uhost->class_inst;
                 }
             }
 
@@ -360,6 +394,7 @@ void usbh_core_task(usbh_host *uhost)
         uhost->usr_cb->dev_deinit();
         if(NULL != uhost->active_class) {
             uhost->active_class->class_deinit(uhost);
+            uhost->active_class = NULL;
         }
         break;
 
@@ -372,8 +407,11 @@ void usbh_core_task(usbh_host *uhost)
         uhost->usr_cb->dev_deinit();
         if(NULL != uhost->active_class) {
             uhost->active_class->class_deinit(uhost);
+            uhost->active_class = NULL;
+        }
+        if(NULL == uhost->parent) {
+            usbh_pipe_delete(udev);
         }
-        usbh_pipe_delete(udev);
         uhost->cur_state = HOST_DEFAULT;
         break;
 
@@ -406,6 +444,160 @@ void usbh_error_handler(usbh_host *uhost, usbh_status err_type)
     }
 }
 
+/*!
+    \brief      allocate a free device address
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     device address, USBH_DEV_ADDR_DEFAULT if all addresses are in use
+*/
+uint8_t usbh_addr_alloc(usbh_host *uhost)
+{
+    usbh_host *root = usbh_root_get(uhost);
+
+    for(uint8_t addr = USBH_DEV_ADDR + 1U; addr <= USBH_DEV_ADDR_MAX; addr++) {
+        if(0U == (root->addr_map[addr >> 5U] & (1UL << (addr & 0x1FU)))) {
+            root->addr_map[addr >> 5U] |= 1UL << (addr & 0x1FU);
+
+            return addr;
+        }
+    }
+
+    return USBH_DEV_ADDR_DEFAULT;
+}
+
+/*!
+    \brief      release a device address
+    \param[in]  uhost: pointer to USB host
+    \param[in]  addr: device address from usbh_addr_alloc()
+    \param[out] none
+    \retval     none
+*/
+void usbh_addr_free(usbh_host *uhost, uint8_t addr)
+{
+    usbh_host *root = usbh_root_get(uhost);
+
+    if((addr > USBH_DEV_ADDR) && (addr <= USBH_DEV_ADDR_MAX)) {
+        root->addr_map[addr >> 5U] &= ~(1UL << (addr & 0x1FU));
+    }
+}
+
+/*!
+    \brief      initialize the host of a device behind a hub port
+    \param[in]  child: pointer to the USB host of the downstream device
+    \param[in]  parent: pointer to the USB host of the hub
+    \param[in]  port: hub port number
+    \param[in]  user_cb: user callbacks of the device, NULL to use the ones of the hub
+    \param[out] none
+    \retval     operation status
+*/
+usbh_status usbh_child_init(usbh_host *child, usbh_host *parent, uint8_t port, usbh_user_cb *user_cb)
+{
+    usbh_host *root = usbh_root_get(parent);
+    uint8_t addr = usbh_addr_alloc(root);
+
+    if(USBH_DEV_ADDR_DEFAULT == addr) {
+        return USBH_FAIL;
+    }
+
+    child->data = parent->data;
+    child->parent = parent;
+    child->hub_port = port;
+    child->dev_addr = addr;
+    child->usr_cb = (NULL != user_cb) ? user_cb : parent->usr_cb;
+    child->active_class = NULL;
+
+    /* downstream devices support the classes registered on the root port */
+    child->class_num = root->class_num;
+
+    for(uint8_t index = 0U; index < root->class_num; index++) {
+        child->uclass[index] = root->uclass[index];
+    }
+
+    usbh_deinit(child);
+
+    /* the frame handler walks the list in the interrupt, link the device when it is complete */
+    child->next = root->next;
+    root->next = child;
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      start the enumeration of a device behind a hub port after the port reset
+    \param[in]  child: pointer to the USB host of the downstream device
+    \param[in]  speed: device speed reported by the hub port
+    \param[out] none
+    \retval     none
+*/
+void usbh_child_attach(usbh_host *child, uint32_t speed)
+{
+    usbh_host *root = usbh_root_get(child);
+
+    child->control.pipe_in_num = root->control.pipe_in_num;
+    child->control.pipe_out_num = root->control.pipe_out_num;
+
+    child->dev_prop.speed = speed;
+
+    child->usr_cb->dev_speed_detected(speed);
+
+    child->cur_state = HOST_DEV_CONNECT;
+}
+
+/*!
+    \brief      stop a device behind a hub port and release its resources
+    \param[in]  child: pointer to the USB host of the downstream device
+    \param[out] none
+    \retval     none
+*/
+void usbh_child_detach(usbh_host *child)
+{
+    usbh_host *root = usbh_root_get(child);
+    usbh_host *prev = root;
+
+    if(HOST_DEFAULT != child->cur_state) {
+        child->usr_cb->dev_detach();
+    }
+
+    usbh_deinit(child);
+    child->usr_cb->dev_deinit();
+
+    if(NULL != child->active_class) {
+        child->active_class->class_deinit(child);
+        child->active_class = NULL;
+    }
+
+    usbh_addr_free(root, child->dev_addr);
+    child->dev_addr = USBH_DEV_ADDR_DEFAULT;
+
+    /* the next pointer of the device stays valid for a frame handler walking the list */
+    while((NULL != prev->next) && (child != prev->next)) {
+        prev = prev->next;
+    }
+
+    if(child == prev->next) {
+        prev->next = child->next;
+    }
+}
+
+/*!
+    \brief      find the device running a class on the root port or behind a hub
+    \param[in]  uhost: pointer to USB host
+    \param[in]  class_code: USB class code
+    \param[out] none
+    \retval     pointer to the USB host of the device, NULL if there is none
+*/
+usbh_host *usbh_dev_find(usbh_host *uhost, uint8_t class_code)
+{
+    for(uhost = usbh_root_get(uhost); NULL != uhost; uhost = uhost->next) {
+        if((HOST_CLASS_HANDLER == uhost->cur_state) && (NULL != uhost->active_class) && \
+             (class_code == uhost->active_class->class_code)) {
+            return uhost;
+        }
+    }
+
+    return NULL;
+}
+
 /*!
     \brief      USB SOF event function from the interrupt
     \param[in]  uhost: pointer to USB host
@@ -414,13 +606,40 @@ void usbh_error_handler(usbh_host *uhost, usbh_status err_type)
 */
 static uint8_t usb_ev_sof(usbh_host *uhost)
 {
-    /* update timer variable */
-    uhost->control.timer++;
+    /* the devices behind a hub run on the frames of the root port */
+    for(; NULL != uhost; uhost = uhost->next) {
+        /* update timer variable */
+        uhost->control.timer++;
+
+        /* this callback could be used to implement a scheduler process */
+        if(NULL != uhost->active_class) {
+            if(NULL != uhost->active_class->class_sof) {
+                uhost->active_class->class_sof(uhost);
+            }
+        }
+    }
+
+    return 0U;
+}
+
+/*!
+    \brief      USB periodic IN transfer end event function from the interrupt, with data,
+                a NAK or an error, passed to the class of the device owning the pipe
+    \param[in]  uhost: pointer to USB host
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     operation status
+*/
+static uint8_t usb_ev_pipe_done(usbh_host *uhost, uint8_t pp_num)
+{
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    uint8_t dev_addr = udev->host.pipe[pp_num].dev_addr;
 
-    /* this callback could be used to implement a scheduler process */
-    if(NULL != uhost->active_class) {
-        if(NULL != uhost->active_class->class_sof) {
-            uhost->active_class->class_sof(uhost);
+    for(; NULL != uhost; uhost = uhost->next) {
+        if((dev_addr == uhost->dev_prop.addr) && (NULL != uhost->active_class)) {
+            if(NULL != uhost->active_class->class_xfer_done) {
+                uhost->active_class->class_xfer_done(uhost, pp_num);
+            }
         }
     }
 
@@ -505,10 +724,10 @@ static usbh_status usbh_enum_task(usbh_host *uhost)
 
     case ENUM_SET_ADDR:
         /* set address */
-        if(USBH_OK == usbh_setaddress(uhost, USBH_DEV_ADDR)) {
+        if(USBH_OK == usbh_setaddress(uhost, uhost->dev_addr)) {
             usb_mdelay(2U);
 
-            uhost->dev_prop.addr = USBH_DEV_ADDR;
+            uhost->dev_prop.addr = uhost->dev_addr;
 
             /* user callback for device address assigned */
             uhost->usr_cb->dev_address_set();
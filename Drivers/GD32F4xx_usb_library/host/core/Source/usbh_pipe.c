@@ -128,6 +128,52 @@ uint8_t usbh_pipe_allocate(usb_core_driver *udev, uint8_t ep_addr)
     return (uint8_t)pp_num;
 }
 
+/*!
+    \brief      allocate a new pipe for an endpoint of a device within the pipe budget of the device
+    \param[in]  uhost: pointer to USB host
+    \param[in]  ep_addr: endpoint address
+    \param[in]  ep_type: endpoint type
+    \param[out] none
+    \retval     pipe number, (uint8_t)HP_ERROR if the device used up its budget or no pipe is free
+*/
+uint8_t usbh_pipe_dev_allocate(usbh_host *uhost, uint8_t ep_addr, uint8_t ep_type)
+{
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    usbh_host *root = usbh_root_get(uhost);
+    uint8_t dev_pipes = 0U, free_pipes = 0U;
+    uint8_t pp_num = 0U;
+
+    for(pp_num = 0U; pp_num < HP_MAX; pp_num++) {
+        if(0U == udev->host.pipe[pp_num].in_used) {
+            free_pipes++;
+        } else if((pp_num != root->control.pipe_in_num) && (pp_num != root->control.pipe_out_num) && \
+                    (uhost->dev_prop.addr == udev->host.pipe[pp_num].dev_addr)) {
+            dev_pipes++;
+        } else {
+            /* pipe of another device */
+        }
+    }
+
+    if(dev_pipes >= USBH_DEV_PIPE_MAX) {
+        return (uint8_t)HP_ERROR;
+    }
+
+    if((USB_EPTYPE_BULK == ep_type) || (USB_EPTYPE_CTRL == ep_type)) {
+        if(free_pipes <= USBH_PERIODIC_PIPE_RESERVE) {
+            return (uint8_t)HP_ERROR;
+        }
+    }
+
+    pp_num = usbh_pipe_allocate(udev, ep_addr);
+
+    if((uint8_t)HP_ERROR != pp_num) {
+        /* count the pipe for the device before usbh_pipe_create() programs it */
+        udev->host.pipe[pp_num].dev_addr = uhost->dev_prop.addr;
+    }
+
+    return pp_num;
+}
+
 /*!
     \brief      free a pipe
     \param[in]  udev: pointer to USB core instance
@@ -138,7 +184,11 @@ uint8_t usbh_pipe_allocate(usb_core_driver *udev, uint8_t ep_addr)
 uint8_t usbh_pipe_free(usb_core_driver *udev, uint8_t pp_num)
 {
     if(pp_num < HP_MAX) {
+        usb_pipe_periodic_release(udev, pp_num);
+
         udev->host.pipe[pp_num].in_used = 0U;
+        udev->host.pipe[pp_num].nak_defer = 0U;
+        udev->host.periodic_map &= ~(1UL << pp_num);
     }
 
     return USBH_OK;
@@ -155,12 +205,65 @@ uint8_t usbh_pipe_delete(usb_core_driver *udev)
     uint8_t pp_num = 0U;
 
     for(pp_num = 2U; pp_num < HP_MAX; pp_num++) {
+        usb_pipe_periodic_release(udev, pp_num);
+
         udev->host.pipe[pp_num] = (usb_pipe) {0};
     }
 
+    udev->host.periodic_map &= 0x3U;
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      put an interrupt or isochronous pipe on the periodic schedule, its transfers
+                are then started in the (micro)frames of its slot instead of at once
+    \param[in]  uhost: pointer to USB host
+    \param[in]  pp_num: pipe number
+    \param[in]  interval: bInterval of the endpoint
+    \param[out] none
+    \retval     operation status, USBH_FAIL if the periodic bandwidth is used up
+*/
+usbh_status usbh_pipe_periodic_set(usbh_host *uhost, uint8_t pp_num, uint8_t interval)
+{
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    usb_pipe *pp = &udev->host.pipe[pp_num];
+    uint16_t frames = interval;
+
+    /* high speed and isochronous endpoints give the interval as 2^(bInterval - 1) (micro)frames */
+    if((PORT_SPEED_HIGH == pp->dev_speed) || (USB_EPTYPE_ISOC == pp->ep.type)) {
+        uint8_t exponent = (0U == interval) ? 1U : USB_MIN(interval, 16U);
+
+        frames = (uint16_t)(1U << (exponent - 1U));
+    }
+
+    if(USB_OK != usb_pipe_periodic_config(udev, pp_num, frames)) {
+        return USBH_FAIL;
+    }
+
     return USBH_OK;
 }
 
+/*!
+    \brief      take a snapshot of the transfer counters of a pipe, the counters only grow:
+                the throughput is the difference of two snapshots over the time between them
+    \param[in]  uhost: pointer to USB host
+    \param[in]  pp_num: pipe number
+    \param[out] stat: counters, and the host timer (frames, micro-frames on a high speed port)
+    \retval     none
+*/
+void usbh_pipe_stat_get(usbh_host *uhost, uint8_t pp_num, usb_pipe_stat *stat)
+{
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    usb_pipe *pp = &udev->host.pipe[pp_num];
+
+    stat->bytes = pp->stat.bytes;
+    stat->xfers = pp->stat.xfers;
+    stat->naks = pp->stat.naks;
+    stat->errors = pp->stat.errors;
+    stat->time = usbh_root_get(uhost)->control.timer;
+}
+
 /*!
     \brief      get a free pipe number for allocation
     \param[in]  udev: pointer to USB core instance
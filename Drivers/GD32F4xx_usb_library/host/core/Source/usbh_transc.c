@@ -43,6 +43,8 @@ static void usbh_data_out_transc(usbh_host *uhost);
 static void usbh_status_in_transc(usbh_host *uhost);
 static void usbh_status_out_transc(usbh_host *uhost);
 static uint32_t usbh_request_submit(usb_core_driver *udev, uint8_t pp_num);
+static usbh_status usbh_ctl_acquire(usbh_host *uhost);
+static void usbh_ctl_release(usbh_host *uhost);
 
 /*!
     \brief      send the SETUP packet to the USB device
@@ -168,7 +170,10 @@ usbh_status usbh_ctl_handler(usbh_host *uhost)
 
     switch(uhost->control.ctl_state) {
     case CTL_SETUP:
-        usbh_setup_transc(uhost);
+        /* the control pipes are shared by the devices behind a hub */
+        if(USBH_OK == usbh_ctl_acquire(uhost)) {
+            usbh_setup_transc(uhost);
+        }
         break;
 
     case CTL_DATA_IN:
@@ -190,6 +195,8 @@ usbh_status usbh_ctl_handler(usbh_host *uhost)
     case CTL_FINISH:
         uhost->control.ctl_state = CTL_IDLE;
 
+        usbh_ctl_release(uhost);
+
         status = USBH_OK;
         break;
 
@@ -198,6 +205,8 @@ usbh_status usbh_ctl_handler(usbh_host *uhost)
             /* do the transmission again, starting from SETUP packet */
             uhost->control.ctl_state = CTL_SETUP;
         } else {
+            usbh_ctl_release(uhost);
+
             status = USBH_FAIL;
         }
         break;
@@ -367,3 +376,56 @@ static uint32_t usbh_request_submit(usb_core_driver *udev, uint8_t pp_num)
 
     return (uint32_t)usb_pipe_xfer(udev, pp_num);
 }
+
+/*!
+    \brief      take the control pipes for a transfer of a device
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     USBH_OK if the pipes are programmed for the device, USBH_BUSY if another device uses them
+*/
+static usbh_status usbh_ctl_acquire(usbh_host *uhost)
+{
+    usbh_host *root = usbh_root_get(uhost);
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+
+    if((NULL != root->ctl_owner) && (uhost != root->ctl_owner)) {
+        return USBH_BUSY;
+    }
+
+    root->ctl_owner = uhost;
+
+    if(uhost != root->ctl_bound) {
+        uint8_t pp_num[2] = {uhost->control.pipe_out_num, uhost->control.pipe_in_num};
+
+        /* point the pipes to the device, address 0 is valid here during enumeration */
+        for(uint8_t i = 0U; i < 2U; i++) {
+            usb_pipe *pp = &udev->host.pipe[pp_num[i]];
+
+            pp->dev_addr = uhost->dev_prop.addr;
+            pp->dev_speed = uhost->dev_prop.speed;
+            pp->ep.mps = uhost->control.max_len;
+            pp->supp_ping = (uint8_t)(PORT_SPEED_HIGH == pp->dev_speed);
+
+            usb_pipe_init(udev, pp_num[i]);
+        }
+
+        root->ctl_bound = uhost;
+    }
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      give the control pipes free at the end of a transfer
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     none
+*/
+static void usbh_ctl_release(usbh_host *uhost)
+{
+    usbh_host *root = usbh_root_get(uhost);
+
+    if(uhost == root->ctl_owner) {
+        root->ctl_owner = NULL;
+    }
+}
@@ -146,6 +146,21 @@ tcpip_thread(void *arg)
       continue;
     }
     tcpip_thread_handle_msg(msg);
+#if TCPIP_MBOX_BATCH > 1
+    {
+      int batch;
+      /* handle the queued messages without unlocking the core for each */
+      for (batch = 1; (batch < TCPIP_MBOX_BATCH) &&
+           (sys_arch_mbox_tryfetch(&tcpip_mbox, (void **)&msg) != SYS_MBOX_EMPTY); batch++) {
+        if (msg == NULL) {
+          LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: NULL\n"));
+          LWIP_ASSERT("tcpip_thread: invalid message", 0);
+          continue;
+        }
+        tcpip_thread_handle_msg(msg);
+      }
+    }
+#endif /* TCPIP_MBOX_BATCH > 1 */
   }
 }
 
@@ -1775,6 +1775,16 @@
 #define TCPIP_MBOX_SIZE                 0
 #endif
 
+/**
+ * TCPIP_MBOX_BATCH: The maximum number of messages the tcpip thread handles
+ * per wakeup. Messages queued behind the first one are fetched with
+ * sys_arch_mbox_tryfetch() while the core stays locked, timeouts are checked
+ * again after the batch.
+ */
+#if !defined TCPIP_MBOX_BATCH || defined __DOXYGEN__
+#define TCPIP_MBOX_BATCH                1
+#endif
+
 /**
  * Define this to something that triggers a watchdog. This is called from
  * tcpip_thread after processing a message.
@@ -37,6 +37,10 @@ OF SUCH DAMAGE.
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* configure systick */
 void systick_config(void);
 /* delay a time in milliseconds */
@@ -44,4 +48,8 @@ void delay_ms(uint32_t count);
 /* delay decrement */
 void delay_decrement(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* SYS_TICK_H */
@@ -1,5 +1,5 @@
 /*!
-    \file    main.c
+    \file    main.cpp
     \brief   GPIO running led demo
 
     \version 2024-12-20, V3.31, demo for GD32F4xx
@@ -33,9 +33,16 @@ OF SUCH DAMAGE.
 */
 
 #include "gd32f4xx.h"
-#include "gd32f450i_eval.h"
+#include "gd32f4xx_hal.hpp"
 #include "systick.h"
-#include <stdio.h>
+
+using namespace gd32f4xx::hal;
+
+/* LED1 on PE2, LED2 on PE3, LED3 on PF10 */
+using Led1 = Pin<PortE, 2U>;
+using Led2 = Pin<PortE, 3U>;
+using Led3 = Pin<PortF, 10U>;
+using Leds = PinGroup<Led1, Led2, Led3>;
 
 /*!
     \brief      main function
@@ -48,44 +55,23 @@ int main(void)
     /* configure systick */
     systick_config();
 
-    /* enable the LEDs GPIO clock */
-    rcu_periph_clock_enable(RCU_GPIOE);
-    rcu_periph_clock_enable(RCU_GPIOF);
-
-    /* configure LED1 GPIO port */
-    gpio_mode_set(GPIOE, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO_PIN_2);
-    gpio_output_options_set(GPIOE, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_2);
-    /* reset LED1 GPIO pin */
-    gpio_bit_reset(GPIOE, GPIO_PIN_2);
-
-    /* enable the LED2 GPIO clock */
-    /* configure LED2 GPIO port */
-    gpio_mode_set(GPIOE, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO_PIN_3);
-    gpio_output_options_set(GPIOE, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_3);
-    /* reset LED2 GPIO pin */
-    gpio_bit_reset(GPIOE, GPIO_PIN_3);
-
-    /* enable the LED3 GPIO clock */
-    /* configure LED3 GPIO port */
-    gpio_mode_set(GPIOF, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO_PIN_10);
-    gpio_output_options_set(GPIOF, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_10);
-    /* reset LED3 GPIO pin */
-    gpio_bit_reset(GPIOF, GPIO_PIN_10);
+    /* enable the LEDs GPIO clocks, one RCU register write for both ports */
+    Leds::clock_enable();
+    /* reset the LEDs and configure them as push-pull outputs, one write per register and port */
+    Leds::clear();
+    Leds::configure<Output<Speed::High>>();
 
     while(1) {
-        /* turn on LED1, turn off LED3 */
-        gpio_bit_set(GPIOE, GPIO_PIN_2);
-        gpio_bit_reset(GPIOF, GPIO_PIN_10);
+        /* turn on LED1, turn off LED2 and LED3: one GPIO_BOP write per port */
+        Leds::write<0x1U>();
         delay_ms(1000);
 
-        /* turn on LED2, turn off LED1 */
-        gpio_bit_set(GPIOE, GPIO_PIN_3);
-        gpio_bit_reset(GPIOE, GPIO_PIN_2);
+        /* turn on LED2, turn off LED1 and LED3 */
+        Leds::write<0x2U>();
         delay_ms(1000);
 
-        /* turn on LED3, turn off LED2 */
-        gpio_bit_set(GPIOF, GPIO_PIN_10);
-        gpio_bit_reset(GPIOE, GPIO_PIN_3);
+        /* turn on LED3, turn off LED1 and LED2 */
+        Leds::write<0x4U>();
         delay_ms(1000);
     }
 }
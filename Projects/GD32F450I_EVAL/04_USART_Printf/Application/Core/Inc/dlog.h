@@ -0,0 +1,109 @@
+/*!
+    \file    dlog.h
+    \brief   the header file of the deferred formatting binary logger
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include "gd32f4xx.h"
+#include "uart_log.h"
+
+/* DLOG(fmt, ...) queues a record instead of formatting the text on the target.
+   the format string is placed in the .dlog_fmt section, which the linker script
+   keeps in the ELF file at address 0 without loading it into FLASH, so its address
+   is the string ID. a record carries the ID, the DWT cycle counter and up to
+   DLOG_MAX_ARGS argument words, and Utilities/dlog_decode/dlog_decode.py formats
+   it on the host with the help of the ELF file.
+
+   arguments are 32-bit: integers and pointers are stored as is, float and double
+   as float, %s works for strings in FLASH only. 64-bit integers are not supported.
+
+   record layout, little endian:
+   byte 0      DLOG_SYNC, never part of printf text
+   byte 1      number of argument words
+   byte 2..3   string ID
+   byte 4..7   DWT cycle counter
+   byte 8..    argument words */
+#define DLOG_SYNC                  0x1EU
+#define DLOG_MAX_ARGS              6U
+
+/* convert one argument to a 32-bit word */
+#define DLOG_ARG(x) _Generic((x), \
+    float: dlog_float_bits(_Generic((x), float: (x), default: 0.0f)), \
+    double: dlog_float_bits((float)_Generic((x), double: (x), default: 0.0)), \
+    default: (uint32_t)(x))
+
+#define DLOG_CAT(a, b)             DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b)            a##b
+#define DLOG_COUNT(...)            DLOG_COUNT_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_COUNT_(z, a, b, c, d, e, f, n, ...) n
+#define DLOG_MAP_0()
+#define DLOG_MAP_1(a)                  , DLOG_ARG(a)
+#define DLOG_MAP_2(a, b)               , DLOG_ARG(a), DLOG_ARG(b)
+#define DLOG_MAP_3(a, b, c)            , DLOG_ARG(a), DLOG_ARG(b), DLOG_ARG(c)
+#define DLOG_MAP_4(a, b, c, d)         , DLOG_ARG(a), DLOG_ARG(b), DLOG_ARG(c), DLOG_ARG(d)
+#define DLOG_MAP_5(a, b, c, d, e)      , DLOG_ARG(a), DLOG_ARG(b), DLOG_ARG(c), DLOG_ARG(d), DLOG_ARG(e)
+#define DLOG_MAP_6(a, b, c, d, e, f)   , DLOG_ARG(a), DLOG_ARG(b), DLOG_ARG(c), DLOG_ARG(d), DLOG_ARG(e), DLOG_ARG(f)
+
+/* queue a log record, safe from any context including interrupts */
+#define DLOG(fmt, ...) do { \
+        static const char dlog_fmt[] __attribute__((section(".dlog_fmt"), used)) = fmt; \
+        const uint32_t dlog_rec[] = { \
+            ((uint32_t)dlog_fmt << 16) | ((uint32_t)DLOG_COUNT(__VA_ARGS__) << 8) | DLOG_SYNC, \
+            DWT->CYCCNT \
+            DLOG_CAT(DLOG_MAP_, DLOG_COUNT(__VA_ARGS__))(__VA_ARGS__) }; \
+        uart_log_write((const char *)dlog_rec, sizeof(dlog_rec)); \
+    } while(0)
+
+/* function declarations */
+/* start the DWT cycle counter used as record timestamp */
+void dlog_init(void);
+
+/*!
+    \brief      get the bit pattern of a float argument
+    \param[in]  value: argument value
+    \param[out] none
+    \retval     IEEE 754 single precision bits
+*/
+static inline uint32_t dlog_float_bits(float value)
+{
+    union {
+        float f;
+        uint32_t u;
+    } bits;
+
+    bits.f = value;
+    return bits.u;
+}
+
+#endif /* DLOG_H */
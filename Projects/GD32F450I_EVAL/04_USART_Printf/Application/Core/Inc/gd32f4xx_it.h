@@ -56,5 +56,7 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 /* this function handles SysTick exception */
 void SysTick_Handler(void);
+/* this function handles DMA1 channel7 (USART0 TX) interrupt request */
+void DMA1_Channel7_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
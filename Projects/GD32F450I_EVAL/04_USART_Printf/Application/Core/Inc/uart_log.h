@@ -0,0 +1,74 @@
+/*!
+    \file    uart_log.h
+    \brief   the header file of the DMA driven USART log transport
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef UART_LOG_H
+#define UART_LOG_H
+
+#include <stdint.h>
+
+/* size of the log ring in bytes, a power of two of at most 4096 */
+#define UART_LOG_BUF_SIZE          2048U
+/* policy when a message does not fit into the ring */
+#define UART_LOG_POLICY_DROP       0U                    /*!< drop the whole message and count it */
+#define UART_LOG_POLICY_BLOCK      1U                    /*!< wait for the DMA to make room, drops when called from an interrupt */
+#define UART_LOG_POLICY            UART_LOG_POLICY_DROP
+/* preemption priority of the TX DMA interrupt */
+#define UART_LOG_DMA_IRQ_PRIO      2U
+
+/* log transport counters */
+typedef struct {
+    uint32_t messages;                                   /*!< messages queued */
+    uint32_t bytes;                                      /*!< bytes queued */
+    uint32_t dropped;                                    /*!< messages dropped for lack of space */
+    uint32_t dropped_bytes;                              /*!< bytes of the dropped messages */
+    uint32_t blocked;                                    /*!< messages which had to wait for space */
+    uint32_t dma_transfers;                              /*!< DMA transfers completed */
+    uint32_t high_water;                                 /*!< most bytes queued at the same time */
+} uart_log_stats_struct;
+
+/* function declarations */
+/* configure the TX DMA of EVAL_COM0 and start the log transport */
+void uart_log_init(void);
+/* queue a message, safe from any context including interrupts */
+uint32_t uart_log_write(const char *data, uint32_t len);
+/* select UART_LOG_POLICY_DROP or UART_LOG_POLICY_BLOCK */
+void uart_log_policy_set(uint32_t policy);
+/* wait until everything queued so far has left the USART */
+void uart_log_flush(void);
+/* read the transport counters */
+void uart_log_stats_get(uart_log_stats_struct *stats);
+/* handle the TX DMA interrupt */
+void uart_log_dma_irq_handler(void);
+
+#endif /* UART_LOG_H */
@@ -34,6 +34,7 @@ OF SUCH DAMAGE.
 
 #include "gd32f4xx_it.h"
 #include "systick.h"
+#include "uart_log.h"
 
 /*!
     \brief      this function handles NMI exception
@@ -149,3 +150,14 @@ void SysTick_Handler(void)
 {
     delay_decrement();
 }
+
+/*!
+    \brief      this function handles DMA1 channel7 (USART0 TX) interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void DMA1_Channel7_IRQHandler(void)
+{
+    uart_log_dma_irq_handler();
+}
@@ -36,6 +36,8 @@ OF SUCH DAMAGE.
 #include "gd32f450i_eval.h"
 #include <stdio.h>
 #include "systick.h"
+#include "uart_log.h"
+#include "dlog.h"
 
 void led_init(void);
 void led_flash(int times);
@@ -48,6 +50,9 @@ void led_flash(int times);
 */
 int main(void)
 {
+    uart_log_stats_struct log_stats;
+    uint32_t start, printf_cycles, dlog_cycles;
+
     /* initialize the LEDs */
     led_init();
     
@@ -60,15 +65,17 @@ int main(void)
     /* configure EVAL_COM0 */
     gd_eval_com_init(EVAL_COM0);
     
+    /* printf output is queued and sent by DMA */
+    uart_log_init();
+    /* DLOG records are stamped with the DWT cycle counter */
+    dlog_init();
+    
     /* configure TAMPER key */
     gd_eval_key_init(KEY_TAMPER, KEY_MODE_GPIO);
     
     /* output a message on hyperterminal using printf function */
     printf("\r\n USART printf example: please press the Tamper key \r\n");
     
-    /* wait for completion of USART transmission */
-    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TC)){
-    }
     while(1){
         /* check if the tamper key is pressed */
         if(RESET == gd_eval_key_state_get(KEY_TAMPER)){
@@ -80,9 +87,21 @@ int main(void)
                     gd_eval_led_on(LED3);
                     /* output a message on hyperterminal using printf function */
                     printf("\r\n USART printf example \r\n");
-                    /* wait for completion of USART transmission */
-                    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TC)){
-                    }
+                    /* printf returned as soon as the text was queued, report the transport counters */
+                    uart_log_stats_get(&log_stats);
+                    start = DWT->CYCCNT;
+                    printf(" log: %lu msgs, %lu bytes, %lu dropped, %lu DMA transfers, high water %lu \r\n",
+                           (unsigned long)log_stats.messages, (unsigned long)log_stats.bytes,
+                           (unsigned long)log_stats.dropped, (unsigned long)log_stats.dma_transfers,
+                           (unsigned long)log_stats.high_water);
+                    printf_cycles = DWT->CYCCNT - start;
+                    /* the same line as a deferred record, formatted by Utilities/dlog_decode on the host */
+                    start = DWT->CYCCNT;
+                    DLOG("log: %lu msgs, %lu bytes, %lu dropped, %lu DMA transfers, high water %lu",
+                         log_stats.messages, log_stats.bytes, log_stats.dropped,
+                         log_stats.dma_transfers, log_stats.high_water);
+                    dlog_cycles = DWT->CYCCNT - start;
+                    DLOG("printf took %lu cycles, DLOG took %lu cycles", printf_cycles, dlog_cycles);
                 }else{
                     /* turn off LED3 */
                     gd_eval_led_off(LED3);
@@ -141,7 +160,14 @@ void led_flash(int times)
 /* retarget the C library printf function to the USART */
 int fputc(int ch, FILE *f)
 {
-    usart_data_transmit(EVAL_COM0, (uint8_t)ch);
-    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TBE));
+    char c = (char)ch;
+
+    uart_log_write(&c, 1U);
     return ch;
 }
+
+/* called by _write() in syscalls.c, newlib hands over whole lines */
+int __io_write(char *ptr, int len)
+{
+    return (int)uart_log_write(ptr, (uint32_t)len);
+}
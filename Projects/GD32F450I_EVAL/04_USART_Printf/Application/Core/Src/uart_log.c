@@ -0,0 +1,342 @@
+/*!
+    \file    uart_log.c
+    \brief   DMA driven USART log transport
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifdef UART_LOG_HOST
+/* built on a PC by Utilities/uart_log_stress with simulated exclusives and DMA */
+#include "uart_log_host.h"
+#else
+#include "gd32f4xx.h"
+#include "gd32f450i_eval.h"
+#endif /* UART_LOG_HOST */
+#include "uart_log.h"
+#include <string.h>
+
+/* USART0 TX is served by DMA1 channel 7, sub-peripheral 4 */
+#define LOG_DMA                    DMA1
+#define LOG_DMA_CH                 DMA_CH7
+#define LOG_DMA_SUBPERI            DMA_SUBPERI4
+#define LOG_DMA_IRQn               DMA1_Channel7_IRQn
+#define LOG_DMA_FLAGS              (DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF)
+
+/* the producer state is one word so that it can be updated with a single LDREX/STREX:
+   bit 0..12 reserve head, bit 13..25 commit index, bit 26..31 producers still copying.
+   indexes run modulo 8192, twice the largest ring, so full and empty differ */
+#define LOG_IDX_MASK               0x1FFFU
+#define LOG_COMMIT_SHIFT           13U
+#define LOG_BUSY_SHIFT             26U
+#define LOG_HEAD(state)            ((state) & LOG_IDX_MASK)
+#define LOG_COMMIT(state)          (((state) >> LOG_COMMIT_SHIFT) & LOG_IDX_MASK)
+#define LOG_BUSY(state)            ((state) >> LOG_BUSY_SHIFT)
+#define LOG_STATE(head, commit, busy) \
+    (((head) & LOG_IDX_MASK) | (((commit) & LOG_IDX_MASK) << LOG_COMMIT_SHIFT) | ((busy) << LOG_BUSY_SHIFT))
+
+#if (0U != (UART_LOG_BUF_SIZE & (UART_LOG_BUF_SIZE - 1U))) || (UART_LOG_BUF_SIZE > 4096U)
+#error "UART_LOG_BUF_SIZE must be a power of two of at most 4096"
+#endif
+
+static uint8_t log_buf[UART_LOG_BUF_SIZE];
+static volatile uint32_t log_state = 0U;
+/* first byte not yet sent, only advanced by the DMA interrupt */
+static volatile uint32_t log_tail = 0U;
+/* set while a DMA transfer of log_dma_len bytes is running */
+static volatile uint32_t log_dma_busy = 0U;
+static uint32_t log_dma_len = 0U;
+static volatile uint32_t log_policy = UART_LOG_POLICY;
+static volatile uart_log_stats_struct log_stats;
+
+static void log_atomic_add(volatile uint32_t *counter, uint32_t value);
+static void log_atomic_max(volatile uint32_t *counter, uint32_t value);
+static void log_kick(void);
+
+/*!
+    \brief      configure the TX DMA of EVAL_COM0 and start the log transport
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void uart_log_init(void)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+
+    rcu_periph_clock_enable(RCU_DMA1);
+    dma_deinit(LOG_DMA, LOG_DMA_CH);
+
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.memory0_addr = (uint32_t)log_buf;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.number = 0U;
+    dma_init_struct.periph_addr = (uint32_t)&USART_DATA(EVAL_COM0);
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_single_data_mode_init(LOG_DMA, LOG_DMA_CH, &dma_init_struct);
+    dma_channel_subperipheral_select(LOG_DMA, LOG_DMA_CH, LOG_DMA_SUBPERI);
+    dma_circulation_disable(LOG_DMA, LOG_DMA_CH);
+
+    /* every finished transfer refills the channel from the interrupt */
+    dma_interrupt_enable(LOG_DMA, LOG_DMA_CH, DMA_INT_FTF);
+    nvic_irq_enable(LOG_DMA_IRQn, UART_LOG_DMA_IRQ_PRIO, 0U);
+
+    usart_dma_transmit_config(EVAL_COM0, USART_TRANSMIT_DMA_ENABLE);
+}
+
+/*!
+    \brief      queue a message, safe from any context including interrupts
+    \param[in]  data: message text, it is sent unmodified and in one piece
+    \param[in]  len: length of the message
+    \param[out] none
+    \retval     number of bytes queued, 0 if the message was dropped
+*/
+uint32_t uart_log_write(const char *data, uint32_t len)
+{
+    uint32_t state, head = 0U, used = 0U, busy, commit, offset, first;
+    uint8_t waited = 0U;
+
+    if(0U == len) {
+        return 0U;
+    }
+
+    /* reserve len bytes at the head */
+    for(;;) {
+        if(len <= UART_LOG_BUF_SIZE) {
+            state = __LDREXW(&log_state);
+            head = LOG_HEAD(state);
+            used = (head - log_tail) & LOG_IDX_MASK;
+            if((used + len) <= UART_LOG_BUF_SIZE) {
+                if(0U == __STREXW(LOG_STATE(head + len, LOG_COMMIT(state), LOG_BUSY(state) + 1U), &log_state)) {
+                    break;
+                }
+                continue;
+            }
+            __CLREX();
+        }
+
+        /* waiting is only possible from thread mode with interrupts enabled,
+           otherwise the DMA interrupt could never free the space */
+        if((UART_LOG_POLICY_BLOCK == log_policy) && (len <= UART_LOG_BUF_SIZE) &&
+                (0U == __get_IPSR()) && (0U == __get_PRIMASK())) {
+            if(0U == waited) {
+                waited = 1U;
+                log_atomic_add(&log_stats.blocked, 1U);
+            }
+            log_kick();
+            continue;
+        }
+
+        log_atomic_add(&log_stats.dropped, 1U);
+        log_atomic_add(&log_stats.dropped_bytes, len);
+        return 0U;
+    }
+
+    log_atomic_max(&log_stats.high_water, used + len);
+
+    /* copy the message, wrapping at the end of the ring */
+    offset = head & (UART_LOG_BUF_SIZE - 1U);
+    first = UART_LOG_BUF_SIZE - offset;
+    if(first >= len) {
+        memcpy(&log_buf[offset], data, len);
+    } else {
+        memcpy(&log_buf[offset], data, first);
+        memcpy(&log_buf[0], data + first, len - first);
+    }
+    __DMB();
+
+    /* the last producer to finish publishes everything reserved so far,
+       so a preempted producer never exposes a half written message */
+    do {
+        state = __LDREXW(&log_state);
+        busy = LOG_BUSY(state) - 1U;
+        commit = (0U == busy) ? LOG_HEAD(state) : LOG_COMMIT(state);
+    } while(0U != __STREXW(LOG_STATE(LOG_HEAD(state), commit, busy), &log_state));
+
+    log_atomic_add(&log_stats.messages, 1U);
+    log_atomic_add(&log_stats.bytes, len);
+
+    log_kick();
+    return len;
+}
+
+/*!
+    \brief      select the policy for messages that do not fit into the ring
+    \param[in]  policy: UART_LOG_POLICY_DROP or UART_LOG_POLICY_BLOCK
+    \param[out] none
+    \retval     none
+*/
+void uart_log_policy_set(uint32_t policy)
+{
+    log_policy = policy;
+}
+
+/*!
+    \brief      wait until everything queued so far has left the USART
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void uart_log_flush(void)
+{
+    /* the DMA interrupt cannot make progress under us in an interrupt */
+    if(0U != __get_IPSR()) {
+        return;
+    }
+
+    while((LOG_COMMIT(log_state) != log_tail) || (0U != log_dma_busy)) {
+        /* with interrupts masked the transfer has to be completed by polling */
+        if(0U != __get_PRIMASK()) {
+            uart_log_dma_irq_handler();
+        }
+    }
+    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TC)) {
+    }
+}
+
+/*!
+    \brief      read the transport counters
+    \param[in]  none
+    \param[out] stats: copy of the counters
+    \retval     none
+*/
+void uart_log_stats_get(uart_log_stats_struct *stats)
+{
+    stats->messages = log_stats.messages;
+    stats->bytes = log_stats.bytes;
+    stats->dropped = log_stats.dropped;
+    stats->dropped_bytes = log_stats.dropped_bytes;
+    stats->blocked = log_stats.blocked;
+    stats->dma_transfers = log_stats.dma_transfers;
+    stats->high_water = log_stats.high_water;
+}
+
+/*!
+    \brief      handle the TX DMA interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void uart_log_dma_irq_handler(void)
+{
+    if(RESET != dma_interrupt_flag_get(LOG_DMA, LOG_DMA_CH, DMA_INT_FLAG_FTF)) {
+        dma_interrupt_flag_clear(LOG_DMA, LOG_DMA_CH, DMA_INT_FLAG_FTF);
+
+        /* release the sent bytes, then chain the next transfer */
+        log_tail = (log_tail + log_dma_len) & LOG_IDX_MASK;
+        log_stats.dma_transfers++;
+        __DMB();
+        log_dma_busy = 0U;
+        log_kick();
+    }
+}
+
+/*!
+    \brief      start a DMA transfer of the committed bytes if the channel is idle
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void log_kick(void)
+{
+    uint32_t tail, len, offset;
+
+    for(;;) {
+        /* whoever sets log_dma_busy owns the channel until the transfer finishes */
+        do {
+            if(0U != __LDREXW(&log_dma_busy)) {
+                __CLREX();
+                return;
+            }
+        } while(0U != __STREXW(1U, &log_dma_busy));
+        __DMB();
+
+        tail = log_tail;
+        len = (LOG_COMMIT(log_state) - tail) & LOG_IDX_MASK;
+        if(0U != len) {
+            /* one transfer never wraps, the rest follows from the interrupt */
+            offset = tail & (UART_LOG_BUF_SIZE - 1U);
+            if(len > (UART_LOG_BUF_SIZE - offset)) {
+                len = UART_LOG_BUF_SIZE - offset;
+            }
+            log_dma_len = len;
+
+            dma_channel_disable(LOG_DMA, LOG_DMA_CH);
+            dma_flag_clear(LOG_DMA, LOG_DMA_CH, LOG_DMA_FLAGS);
+            dma_memory_address_config(LOG_DMA, LOG_DMA_CH, DMA_MEMORY_0, (uint32_t)&log_buf[offset]);
+            dma_transfer_number_config(LOG_DMA, LOG_DMA_CH, len);
+            dma_channel_enable(LOG_DMA, LOG_DMA_CH);
+            return;
+        }
+
+        log_dma_busy = 0U;
+        /* a message committed while the channel was owned here would be stranded */
+        if(LOG_COMMIT(log_state) == log_tail) {
+            return;
+        }
+    }
+}
+
+/*!
+    \brief      add to a counter shared between interrupt levels
+    \param[in]  counter: the counter
+    \param[in]  value: amount to add
+    \param[out] none
+    \retval     none
+*/
+static void log_atomic_add(volatile uint32_t *counter, uint32_t value)
+{
+    uint32_t old;
+
+    do {
+        old = __LDREXW(counter);
+    } while(0U != __STREXW(old + value, counter));
+}
+
+/*!
+    \brief      raise a counter shared between interrupt levels to at least value
+    \param[in]  counter: the counter
+    \param[in]  value: new candidate maximum
+    \param[out] none
+    \retval     none
+*/
+static void log_atomic_max(volatile uint32_t *counter, uint32_t value)
+{
+    uint32_t old;
+
+    do {
+        old = __LDREXW(counter);
+        if(old >= value) {
+            __CLREX();
+            return;
+        }
+    } while(0U != __STREXW(value, counter));
+}
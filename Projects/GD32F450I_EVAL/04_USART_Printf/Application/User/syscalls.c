@@ -21,6 +21,7 @@ extern int errno;
 
 extern int __io_putchar(int ch) __attribute__((weak));
 extern int __io_getchar(void) __attribute__((weak));
+extern int __io_write(char *ptr, int len) __attribute__((weak));
 
 caddr_t _sbrk(int incr)
 {
@@ -73,6 +74,10 @@ int _write(int file, char *ptr, int len)
 {
 	int DataIdx;
 
+	/* hand the whole buffer to a block transport if the application has one */
+	if (__io_write)
+		return __io_write(ptr, len);
+
 		for (DataIdx = 0; DataIdx < len; DataIdx++)
 		{
 		   __io_putchar( *ptr++ );
@@ -0,0 +1,139 @@
+/*!
+    \file    adc_filter.h
+    \brief   the header file of the fixed-point block filters for ADC streams
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef ADC_FILTER_H
+#define ADC_FILTER_H
+
+#include <stdint.h>
+
+/* most FIR taps, even */
+#define ADC_FIR_TAPS_MAX            64U
+/* FIR input samples handled in one pass, longer blocks are split */
+#define ADC_FILTER_BLOCK_MAX        64U
+/* most CIC integrator/comb pairs */
+#define ADC_CIC_ORDER_MAX           4U
+/* most IIR biquad sections */
+#define ADC_IIR_STAGES_MAX          4U
+/* decimated samples buffered per chain, a power of two */
+#define ADC_CHAIN_OUT_SIZE          64U
+
+typedef enum {
+    ADC_FILTER_OK = 0,                              /*!< configuration accepted */
+    ADC_FILTER_PARAM                                /*!< configuration out of range */
+} adc_filter_status;
+
+/* CIC decimator, order 1 is a boxcar average */
+typedef struct {
+    uint8_t order;                                  /*!< integrator/comb pairs */
+    uint8_t shift;                                  /*!< output = sum >> shift, saturated to 16 bits */
+    uint16_t ratio;                                 /*!< decimation ratio */
+    uint16_t phase;                                 /*!< inputs left until the next output */
+    uint32_t integ[ADC_CIC_ORDER_MAX];              /*!< integrators, wrap around by design */
+    uint32_t comb[ADC_CIC_ORDER_MAX];               /*!< comb delays */
+} adc_cic_struct;
+
+/* Q15 FIR filter with decimation */
+typedef struct {
+    uint16_t taps;                                  /*!< taps, rounded up to even */
+    uint16_t decimation;                            /*!< one output per decimation inputs */
+    uint16_t phase;                                 /*!< inputs left until the next output */
+    int16_t coeff[ADC_FIR_TAPS_MAX];                /*!< coefficients in reverse order */
+    int16_t state[ADC_FIR_TAPS_MAX + ADC_FILTER_BLOCK_MAX]; /*!< taps - 1 samples of history, then the input */
+} adc_fir_struct;
+
+/* cascade of Q15 direct form I biquads with Q14 coefficients */
+typedef struct {
+    uint8_t stages;                                 /*!< biquad sections */
+    uint32_t b0[ADC_IIR_STAGES_MAX];                /*!< b0 */
+    uint32_t b12[ADC_IIR_STAGES_MAX];               /*!< b1 | b2 << 16 */
+    uint32_t a12[ADC_IIR_STAGES_MAX];               /*!< -a1 | -a2 << 16 */
+    uint32_t x12[ADC_IIR_STAGES_MAX];               /*!< x[n-1] | x[n-2] << 16 */
+    uint32_t y12[ADC_IIR_STAGES_MAX];               /*!< y[n-1] | y[n-2] << 16 */
+} adc_iir_struct;
+
+/* running statistics of raw samples */
+typedef struct {
+    uint32_t count;                                 /*!< samples */
+    uint16_t min;                                   /*!< smallest sample */
+    uint16_t max;                                   /*!< largest sample */
+    uint64_t sum;                                   /*!< sum of the samples */
+    uint64_t sum_sq;                                /*!< sum of the squared samples */
+} adc_stats_struct;
+
+/* statistics results, in 1/16 LSB */
+typedef struct {
+    uint32_t count;                                 /*!< samples */
+    uint16_t min;                                   /*!< smallest sample, in LSB */
+    uint16_t max;                                   /*!< largest sample, in LSB */
+    uint32_t mean;                                  /*!< mean, in 1/16 LSB */
+    uint32_t rms;                                   /*!< RMS of the deviation from the mean (noise), in 1/16 LSB */
+} adc_stats_result_struct;
+
+/* one channel: statistics of the raw samples, then CIC, FIR and IIR into a decimated stream */
+typedef struct {
+    adc_cic_struct cic;                             /*!< first decimation stage */
+    adc_fir_struct fir;                             /*!< second decimation stage */
+    adc_iir_struct iir;                             /*!< smoothing at the output rate, 0 stages to skip */
+    adc_stats_struct stats;                         /*!< statistics of the raw samples */
+    int16_t out[ADC_CHAIN_OUT_SIZE];                /*!< decimated stream */
+    volatile uint32_t head;                         /*!< written by adc_chain_process() */
+    volatile uint32_t tail;                         /*!< read by adc_chain_read() */
+    uint32_t lost;                                  /*!< decimated samples dropped for lack of space */
+} adc_chain_struct;
+
+/* function declarations */
+/* initialize a CIC decimator */
+adc_filter_status adc_cic_init(adc_cic_struct *cic, uint8_t order, uint16_t ratio, uint8_t shift);
+/* decimate every stride-th sample of a block */
+uint32_t adc_cic_process(adc_cic_struct *cic, const uint16_t *in, uint32_t stride, uint32_t n, int16_t *out);
+/* initialize a FIR filter */
+adc_filter_status adc_fir_init(adc_fir_struct *fir, const int16_t *coeff, uint16_t taps, uint16_t decimation);
+/* filter and decimate a block */
+uint32_t adc_fir_process(adc_fir_struct *fir, const int16_t *in, uint32_t n, int16_t *out);
+/* initialize an IIR cascade from {b0, b1, b2, a1, a2} per section in Q14 */
+adc_filter_status adc_iir_init(adc_iir_struct *iir, const int16_t (*coeff)[5], uint8_t stages);
+/* filter a block in place */
+void adc_iir_process(adc_iir_struct *iir, int16_t *data, uint32_t n);
+/* clear the statistics */
+void adc_stats_reset(adc_stats_struct *stats);
+/* add every stride-th sample of a block to the statistics */
+void adc_stats_update(adc_stats_struct *stats, const uint16_t *in, uint32_t stride, uint32_t n);
+/* compute the mean and the noise RMS */
+void adc_stats_result(const adc_stats_struct *stats, adc_stats_result_struct *result);
+/* run every stride-th sample of a block through a chain */
+void adc_chain_process(adc_chain_struct *chain, const uint16_t *in, uint32_t stride, uint32_t n);
+/* take decimated samples from a chain */
+uint32_t adc_chain_read(adc_chain_struct *chain, int16_t *out, uint32_t max);
+
+#endif /* ADC_FILTER_H */
@@ -56,5 +56,9 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 /* this function handles SysTick exception */
 void SysTick_Handler(void);
+/* this function handles ADC interrupt request */
+void ADC_IRQHandler(void);
+/* this function handles DMA1 channel0 (ADC) interrupt request */
+void DMA1_Channel0_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
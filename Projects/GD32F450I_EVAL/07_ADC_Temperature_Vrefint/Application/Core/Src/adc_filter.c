@@ -0,0 +1,475 @@
+/*!
+    \file    adc_filter.c
+    \brief   fixed-point block filters for ADC streams
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "adc_filter.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "gd32f4xx.h"
+
+/* Cortex-M4 SIMD: two 16x16 multiplies and the accumulation in one cycle */
+#define FLT_SMLAD(x, y, acc)        __SMLAD((x), (y), (acc))
+#define FLT_SSAT16(value)           __SSAT((value), 16)
+#define FLT_BARRIER()               __DMB()
+#else
+/* the same operations in C, bit for bit, so that the host reference tool
+   (Utilities/adc_filter) builds this file unchanged */
+static inline int32_t FLT_SMLAD(uint32_t x, uint32_t y, int32_t acc)
+{
+    uint32_t lo = (uint32_t)((int32_t)(int16_t)x * (int16_t)y);
+    uint32_t hi = (uint32_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+
+    /* SMLAD wraps around on overflow */
+    return (int32_t)((uint32_t)acc + lo + hi);
+}
+
+static inline int32_t FLT_SSAT16(int32_t value)
+{
+    return (value > 32767) ? 32767 : ((value < -32768) ? -32768 : value);
+}
+
+#define FLT_BARRIER()               __sync_synchronize()
+#endif
+
+/* local function prototypes ('static') */
+static inline uint32_t flt_read_q15x2(const int16_t *p);
+static int16_t flt_fir_dot(const int16_t *x, const int16_t *h, uint32_t taps);
+static uint32_t flt_isqrt64(uint64_t value);
+
+/*!
+    \brief      initialize a CIC decimator
+    \param[in]  cic: decimator
+    \param[in]  order: integrator/comb pairs, 1 for a boxcar average
+    \param[in]  ratio: decimation ratio
+    \param[in]  shift: right shift of the output, the gain of the filter is ratio^order
+    \param[out] none
+    \retval     ADC_FILTER_OK, or ADC_FILTER_PARAM if the sum of 16-bit inputs could exceed 32 bits
+*/
+adc_filter_status adc_cic_init(adc_cic_struct *cic, uint8_t order, uint16_t ratio, uint8_t shift)
+{
+    uint32_t bits = 0U;
+
+    while((1UL << bits) < ratio) {
+        bits++;
+    }
+    if((0U == order) || (order > ADC_CIC_ORDER_MAX) || (0U == ratio) || ((16U + (order * bits)) > 32U) ||
+            (shift > 31U)) {
+        return ADC_FILTER_PARAM;
+    }
+
+    memset(cic, 0, sizeof(*cic));
+    cic->order = order;
+    cic->ratio = ratio;
+    cic->shift = shift;
+    cic->phase = ratio;
+
+    return ADC_FILTER_OK;
+}
+
+/*!
+    \brief      decimate every stride-th sample of a block, the integrators run at the
+                input rate and the combs at the output rate
+    \param[in]  cic: decimator
+    \param[in]  in: samples
+    \param[in]  stride: distance between the samples of the channel
+    \param[in]  n: samples of the channel
+    \param[out] out: decimated samples, at most n / ratio + 1
+    \retval     number of decimated samples
+*/
+uint32_t adc_cic_process(adc_cic_struct *cic, const uint16_t *in, uint32_t stride, uint32_t n, int16_t *out)
+{
+    uint32_t i, k, v, d, produced = 0U;
+    uint32_t order = cic->order;
+
+    for(i = 0U; i < n; i++) {
+        /* modulo 2^32 arithmetic, the combs undo the wrap around of the integrators */
+        v = in[i * stride];
+        for(k = 0U; k < order; k++) {
+            cic->integ[k] += v;
+            v = cic->integ[k];
+        }
+
+        if(0U == --cic->phase) {
+            cic->phase = cic->ratio;
+            for(k = 0U; k < order; k++) {
+                d = v - cic->comb[k];
+                cic->comb[k] = v;
+                v = d;
+            }
+            v >>= cic->shift;
+            out[produced++] = (int16_t)((v > 32767U) ? 32767U : v);
+        }
+    }
+
+    return produced;
+}
+
+/*!
+    \brief      initialize a FIR filter
+    \param[in]  fir: filter
+    \param[in]  coeff: Q15 coefficients, coeff[0] weights the newest sample; the sum of
+                their magnitudes has to stay below 2.0 or the accumulator could wrap
+    \param[in]  taps: number of coefficients, at most ADC_FIR_TAPS_MAX
+    \param[in]  decimation: one output per decimation inputs
+    \param[out] none
+    \retval     ADC_FILTER_OK or ADC_FILTER_PARAM
+*/
+adc_filter_status adc_fir_init(adc_fir_struct *fir, const int16_t *coeff, uint16_t taps, uint16_t decimation)
+{
+    uint32_t padded = (taps + 1U) & ~1UL;
+    uint32_t k, j;
+
+    if((0U == taps) || (padded > ADC_FIR_TAPS_MAX) || (0U == decimation)) {
+        return ADC_FILTER_PARAM;
+    }
+
+    memset(fir, 0, sizeof(*fir));
+    fir->taps = (uint16_t)padded;
+    fir->decimation = decimation;
+    fir->phase = decimation;
+
+    /* reversed, so that the dot product walks samples and coefficients in the same
+       direction; an odd filter gets a zero tap at the oldest end */
+    for(k = 0U; k < padded; k++) {
+        j = padded - 1U - k;
+        fir->coeff[k] = (j < taps) ? coeff[j] : 0;
+    }
+
+    return ADC_FILTER_OK;
+}
+
+/*!
+    \brief      filter and decimate a block, only the outputs that are kept are computed
+    \param[in]  fir: filter
+    \param[in]  in: samples
+    \param[in]  n: number of samples
+    \param[out] out: filtered samples, at most n / decimation + 1
+    \retval     number of filtered samples
+*/
+uint32_t adc_fir_process(adc_fir_struct *fir, const int16_t *in, uint32_t n, int16_t *out)
+{
+    uint32_t hist = fir->taps - 1U;
+    uint32_t i, m, produced = 0U;
+
+    while(0U != n) {
+        m = (n > ADC_FILTER_BLOCK_MAX) ? ADC_FILTER_BLOCK_MAX : n;
+        memcpy(&fir->state[hist], in, m * sizeof(int16_t));
+
+        for(i = 0U; i < m; i++) {
+            if(0U == --fir->phase) {
+                fir->phase = fir->decimation;
+                /* the window of input i starts at state[i] and ends at the sample itself */
+                out[produced++] = flt_fir_dot(&fir->state[i], fir->coeff, fir->taps);
+            }
+        }
+
+        memmove(&fir->state[0], &fir->state[m], hist * sizeof(int16_t));
+        in += m;
+        n -= m;
+    }
+
+    return produced;
+}
+
+/*!
+    \brief      initialize an IIR cascade
+    \param[in]  iir: filter
+    \param[in]  coeff: {b0, b1, b2, a1, a2} of each section in Q14, for
+                y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2];
+                a1 = -2.0 is stored as -1.99994
+    \param[in]  stages: number of sections, 0 passes the samples through
+    \param[out] none
+    \retval     ADC_FILTER_OK or ADC_FILTER_PARAM
+*/
+adc_filter_status adc_iir_init(adc_iir_struct *iir, const int16_t (*coeff)[5], uint8_t stages)
+{
+    uint32_t s;
+    int32_t a1, a2;
+
+    if(stages > ADC_IIR_STAGES_MAX) {
+        return ADC_FILTER_PARAM;
+    }
+
+    memset(iir, 0, sizeof(*iir));
+    iir->stages = stages;
+
+    for(s = 0U; s < stages; s++) {
+        a1 = -(int32_t)coeff[s][3];
+        a2 = -(int32_t)coeff[s][4];
+        iir->b0[s] = (uint32_t)(int32_t)coeff[s][0];
+        iir->b12[s] = (uint16_t)coeff[s][1] | ((uint32_t)(uint16_t)coeff[s][2] << 16);
+        iir->a12[s] = (uint16_t)FLT_SSAT16(a1) | ((uint32_t)(uint16_t)FLT_SSAT16(a2) << 16);
+    }
+
+    return ADC_FILTER_OK;
+}
+
+/*!
+    \brief      filter a block in place, two SMLAD per sample and section
+    \param[in]  iir: filter
+    \param[in]  data: samples
+    \param[in]  n: number of samples
+    \param[out] data: filtered samples
+    \retval     none
+*/
+void adc_iir_process(adc_iir_struct *iir, int16_t *data, uint32_t n)
+{
+    uint32_t s, i, x12, y12, b12, a12;
+    int32_t b0, acc, y;
+
+    for(s = 0U; s < iir->stages; s++) {
+        b0 = (int32_t)iir->b0[s];
+        b12 = iir->b12[s];
+        a12 = iir->a12[s];
+        x12 = iir->x12[s];
+        y12 = iir->y12[s];
+
+        for(i = 0U; i < n; i++) {
+            acc = data[i] * b0;
+            acc = FLT_SMLAD(x12, b12, acc);
+            acc = FLT_SMLAD(y12, a12, acc);
+            y = FLT_SSAT16((acc + 0x2000) >> 14);
+
+            /* the newest sample moves into the low half, x[n-1] becomes x[n-2] */
+            x12 = (uint16_t)data[i] | (x12 << 16);
+            y12 = (uint16_t)y | (y12 << 16);
+            data[i] = (int16_t)y;
+        }
+
+        iir->x12[s] = x12;
+        iir->y12[s] = y12;
+    }
+}
+
+/*!
+    \brief      clear the statistics
+    \param[in]  stats: statistics
+    \param[out] none
+    \retval     none
+*/
+void adc_stats_reset(adc_stats_struct *stats)
+{
+    stats->count = 0U;
+    stats->min = 0xFFFFU;
+    stats->max = 0U;
+    stats->sum = 0U;
+    stats->sum_sq = 0U;
+}
+
+/*!
+    \brief      add every stride-th sample of a block to the statistics
+    \param[in]  stats: statistics
+    \param[in]  in: samples
+    \param[in]  stride: distance between the samples of the channel
+    \param[in]  n: samples of the channel
+    \param[out] none
+    \retval     none
+*/
+void adc_stats_update(adc_stats_struct *stats, const uint16_t *in, uint32_t stride, uint32_t n)
+{
+    uint32_t i, v, min = stats->min, max = stats->max, sum = 0U;
+    uint64_t sum_sq = 0U;
+
+    for(i = 0U; i < n; i++) {
+        v = in[i * stride];
+        min = (v < min) ? v : min;
+        max = (v > max) ? v : max;
+        sum += v;
+        sum_sq += v * v;
+    }
+
+    stats->count += n;
+    stats->min = (uint16_t)min;
+    stats->max = (uint16_t)max;
+    stats->sum += sum;
+    stats->sum_sq += sum_sq;
+}
+
+/*!
+    \brief      compute the mean and the noise RMS, valid for up to 2^22 samples
+    \param[in]  stats: statistics
+    \param[out] result: results
+    \retval     none
+*/
+void adc_stats_result(const adc_stats_struct *stats, adc_stats_result_struct *result)
+{
+    uint64_t count = stats->count, mean, rest, dev;
+
+    result->count = stats->count;
+    result->min = stats->min;
+    result->max = stats->max;
+    if(0U == count) {
+        result->mean = 0U;
+        result->rms = 0U;
+        return;
+    }
+
+    /* sum_sq - sum^2 / count without overflow: with sum = mean * count + rest it is
+       sum_sq - mean^2 count - 2 mean rest - rest^2 / count */
+    mean = stats->sum / count;
+    rest = stats->sum - (mean * count);
+    dev = stats->sum_sq - (mean * mean * count) - (2U * mean * rest) - ((rest * rest) / count);
+
+    result->mean = (uint32_t)((stats->sum << 4) / count);
+    result->rms = flt_isqrt64((dev << 8) / count);
+}
+
+/*!
+    \brief      run every stride-th sample of a block through a chain: statistics of the
+                raw samples, CIC, FIR and IIR, the decimated samples go to the output ring
+    \param[in]  chain: chain, its stages initialized and the rest zero
+    \param[in]  in: samples
+    \param[in]  stride: distance between the samples of the channel
+    \param[in]  n: samples of the channel
+    \param[out] none
+    \retval     none
+*/
+void adc_chain_process(adc_chain_struct *chain, const uint16_t *in, uint32_t stride, uint32_t n)
+{
+    int16_t cic_out[ADC_FILTER_BLOCK_MAX + 1U];
+    int16_t fir_out[ADC_FILTER_BLOCK_MAX + 1U];
+    uint32_t m, c, f, i, head;
+    /* inputs that give at most ADC_FILTER_BLOCK_MAX CIC outputs */
+    uint32_t chunk = ADC_FILTER_BLOCK_MAX * (uint32_t)chain->cic.ratio;
+
+    adc_stats_update(&chain->stats, in, stride, n);
+
+    while(0U != n) {
+        m = (n > chunk) ? chunk : n;
+        c = adc_cic_process(&chain->cic, in, stride, m, cic_out);
+        f = adc_fir_process(&chain->fir, cic_out, c, fir_out);
+        adc_iir_process(&chain->iir, fir_out, f);
+
+        head = chain->head;
+        for(i = 0U; i < f; i++) {
+            if((head - chain->tail) >= ADC_CHAIN_OUT_SIZE) {
+                chain->lost += f - i;
+                break;
+            }
+            chain->out[head & (ADC_CHAIN_OUT_SIZE - 1U)] = fir_out[i];
+            head++;
+        }
+        FLT_BARRIER();
+        chain->head = head;
+
+        in += m * stride;
+        n -= m;
+    }
+}
+
+/*!
+    \brief      take decimated samples from a chain
+    \param[in]  chain: chain
+    \param[in]  max: most samples to take
+    \param[out] out: samples, oldest first
+    \retval     number of samples taken
+*/
+uint32_t adc_chain_read(adc_chain_struct *chain, int16_t *out, uint32_t max)
+{
+    uint32_t tail = chain->tail, head = chain->head, n = 0U;
+
+    FLT_BARRIER();
+    while((tail != head) && (n < max)) {
+        out[n++] = chain->out[tail & (ADC_CHAIN_OUT_SIZE - 1U)];
+        tail++;
+    }
+    FLT_BARRIER();
+    chain->tail = tail;
+
+    return n;
+}
+
+/*!
+    \brief      read two Q15 samples as one word, the Cortex-M4 allows unaligned loads
+    \param[in]  p: first sample, it ends up in the low half
+    \param[out] none
+    \retval     the two samples
+*/
+static inline uint32_t flt_read_q15x2(const int16_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*!
+    \brief      Q15 dot product of an even number of taps, two taps per SMLAD
+    \param[in]  x: samples, oldest first
+    \param[in]  h: reversed coefficients
+    \param[in]  taps: number of taps, even
+    \param[out] none
+    \retval     rounded and saturated Q15 result
+*/
+static int16_t flt_fir_dot(const int16_t *x, const int16_t *h, uint32_t taps)
+{
+    int32_t acc = 0;
+    uint32_t k = 0U;
+
+    for(; (k + 4U) <= taps; k += 4U) {
+        acc = FLT_SMLAD(flt_read_q15x2(&x[k]), flt_read_q15x2(&h[k]), acc);
+        acc = FLT_SMLAD(flt_read_q15x2(&x[k + 2U]), flt_read_q15x2(&h[k + 2U]), acc);
+    }
+    if(k < taps) {
+        acc = FLT_SMLAD(flt_read_q15x2(&x[k]), flt_read_q15x2(&h[k]), acc);
+    }
+
+    return (int16_t)FLT_SSAT16((acc + 0x4000) >> 15);
+}
+
+/*!
+    \brief      integer square root
+    \param[in]  value: radicand
+    \param[out] none
+    \retval     floor(sqrt(value))
+*/
+static uint32_t flt_isqrt64(uint64_t value)
+{
+    uint64_t root = 0U, bit = 1ULL << 62;
+
+    while(bit > value) {
+        bit >>= 2;
+    }
+    while(0U != bit) {
+        if(value >= (root + bit)) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
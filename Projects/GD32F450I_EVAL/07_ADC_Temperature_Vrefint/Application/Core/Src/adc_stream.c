@@ -0,0 +1,591 @@
+/*!
+    \file    adc_stream.c
+    \brief   DMA driven continuous ADC acquisition engine
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "adc_stream.h"
+#include <stddef.h>
+
+/* ADC0 and the ADC synchronization data are served by DMA1 channel 0, sub-peripheral 0 */
+#define STREAM_DMA                 DMA1
+#define STREAM_DMA_CH              DMA_CH0
+#define STREAM_DMA_SUBPERI         DMA_SUBPERI0
+#define STREAM_DMA_IRQn            DMA1_Channel0_IRQn
+#define STREAM_DMA_FLAGS           (DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF)
+#define STREAM_DMA_NUMBER_MAX      0xFFFFU
+/* TIMER1 update event is the conversion trigger */
+#define STREAM_TIMER               TIMER1
+
+static const uint32_t stream_adc[3] = {ADC0, ADC1, ADC2};
+/* sampling cycles of ADC_SAMPLETIME_3 .. ADC_SAMPLETIME_480 */
+static const uint16_t stream_sample_cycles[8] = {3U, 15U, 28U, 56U, 84U, 112U, 144U, 480U};
+
+static adc_stream_config_struct stream_cfg;
+/* number of ADCs used by the mode */
+static uint32_t stream_adcs = 0U;
+/* DMA transfers for the whole ring */
+static uint32_t stream_dma_number = 0U;
+/* blocks per bit: complete but not taken, taken but not released, overwritten while taken */
+static volatile uint32_t stream_ready = 0U;
+static volatile uint32_t stream_held = 0U;
+static volatile uint32_t stream_clobbered = 0U;
+/* ADC_STREAM_BLOCK_x flags for the next block handed out */
+static uint32_t stream_pending_flags = 0U;
+static uint32_t stream_sequence = 0U;
+static uint64_t stream_samples = 0U;
+static adc_stream_block_struct stream_block[2];
+static volatile adc_stream_stats_struct stream_stats;
+
+static void stream_adc_config(void);
+static uint32_t stream_timer_clock(void);
+static uint32_t stream_adc_clock(void);
+static void stream_dma_config(void);
+static void stream_block_done(uint32_t index, uint32_t lost, uint32_t cycles);
+static void stream_restart(void);
+
+/*!
+    \brief      configure the ADCs, TIMER1 and DMA1 channel 0 for an acquisition
+    \param[in]  config: acquisition configuration, copied
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the configuration cannot be served
+*/
+ErrStatus adc_stream_init(const adc_stream_config_struct *config)
+{
+    uint32_t per_trigger, timer_clock, period, conversion;
+
+    if((config->mode > ADC_STREAM_MODE_TRIPLE_INTERLEAVED) || (0U == config->channel_num) ||
+            (config->channel_num > ADC_STREAM_CHANNEL_MAX) || (NULL == config->buffer) ||
+            (0U != ((uint32_t)config->buffer & 0xFU)) || (0U == config->block_samples) ||
+            (0U != (config->block_samples % 8U)) || (0U != (config->block_samples % config->channel_num))) {
+        return ERROR;
+    }
+
+    switch(config->mode) {
+    case ADC_STREAM_MODE_SINGLE:
+        stream_adcs = 1U;
+        /* one half word per conversion from ADC_RDATA */
+        stream_dma_number = 2U * config->block_samples;
+        break;
+    case ADC_STREAM_MODE_DUAL_PARALLEL:
+        if(0U != (config->channel_num & 1U)) {
+            return ERROR;
+        }
+        stream_adcs = 2U;
+        /* two half words per word from ADC_SYNCDATA */
+        stream_dma_number = config->block_samples;
+        break;
+    default:
+        if(1U != config->channel_num) {
+            return ERROR;
+        }
+        stream_adcs = (ADC_STREAM_MODE_DUAL_INTERLEAVED == config->mode) ? 2U : 3U;
+        stream_dma_number = config->block_samples;
+        break;
+    }
+    if(stream_dma_number > STREAM_DMA_NUMBER_MAX) {
+        return ERROR;
+    }
+
+    stream_cfg = *config;
+
+    rcu_periph_clock_enable(RCU_DMA1);
+    rcu_periph_clock_enable(RCU_TIMER1);
+    rcu_periph_clock_enable(RCU_ADC0);
+    if(stream_adcs > 1U) {
+        rcu_periph_clock_enable(RCU_ADC1);
+    }
+    if(stream_adcs > 2U) {
+        rcu_periph_clock_enable(RCU_ADC2);
+    }
+
+    stream_adc_config();
+    stream_dma_config();
+
+    /* samples produced by one trigger, all ADCs together */
+    per_trigger = (config->mode <= ADC_STREAM_MODE_DUAL_PARALLEL) ? config->channel_num : stream_adcs;
+
+    timer_deinit(STREAM_TIMER);
+    if(0U != config->trigger_rate) {
+        timer_parameter_struct timer_initpara;
+
+        /* TIMER1 is 32-bit wide, so the prescaler can stay at 1 for every rate */
+        timer_clock = stream_timer_clock();
+        period = (timer_clock + (config->trigger_rate / 2U)) / config->trigger_rate;
+        if(period < 2U) {
+            return ERROR;
+        }
+
+        timer_struct_para_init(&timer_initpara);
+        timer_initpara.prescaler = 0U;
+        timer_initpara.alignedmode = TIMER_COUNTER_EDGE;
+        timer_initpara.counterdirection = TIMER_COUNTER_UP;
+        timer_initpara.period = period - 1U;
+        timer_initpara.clockdivision = TIMER_CKDIV_DIV1;
+        timer_init(STREAM_TIMER, &timer_initpara);
+        timer_master_output_trigger_source_select(STREAM_TIMER, TIMER_TRI_OUT_SRC_UPDATE);
+
+        stream_stats.sample_rate = (timer_clock / period) * per_trigger;
+    } else {
+        /* the ADCs run back to back, a conversion takes the sampling time plus one cycle per bit;
+           the interleaved modes reach this rate only with a matching synchronization delay */
+        conversion = stream_sample_cycles[config->sample_time & 0x7U] + 12U - (2U * (config->resolution >> 24));
+        if(0U != config->oversampling) {
+            conversion <<= ((config->oversample_ratio & ADC_OVSAMPCTL_OVSR) >> 2) + 1U;
+        }
+        stream_stats.sample_rate = (stream_adc_clock() / conversion) * stream_adcs;
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      start the acquisition
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void adc_stream_start(void)
+{
+    /* the blocks are stamped with the DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    stream_ready = 0U;
+    stream_held = 0U;
+    stream_clobbered = 0U;
+    stream_pending_flags = 0U;
+    stream_sequence = 0U;
+    stream_samples = 0U;
+    stream_stats.blocks = 0U;
+    stream_stats.late = 0U;
+    stream_stats.adc_overruns = 0U;
+    stream_stats.irq_cycles_max = 0U;
+
+    stream_restart();
+}
+
+/*!
+    \brief      stop the acquisition
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void adc_stream_stop(void)
+{
+    timer_disable(STREAM_TIMER);
+    adc_special_function_config(ADC0, ADC_CONTINUOUS_MODE, DISABLE);
+
+    dma_channel_disable(STREAM_DMA, STREAM_DMA_CH);
+    while(0U != (DMA_CHCTL(STREAM_DMA, STREAM_DMA_CH) & DMA_CHXCTL_CHEN)) {
+    }
+}
+
+/*!
+    \brief      take the oldest complete block when no callback is used, the block
+                belongs to the caller until adc_stream_block_release()
+    \param[in]  none
+    \param[out] block: the block
+    \retval     ErrStatus: SUCCESS or ERROR if no block is complete
+*/
+ErrStatus adc_stream_block_get(adc_stream_block_struct *block)
+{
+    ErrStatus status = ERROR;
+    uint32_t primask = __get_PRIMASK();
+    uint32_t bit;
+
+    __disable_irq();
+    /* the ring has two blocks, so at most one of them is complete and not taken */
+    if(0U != stream_ready) {
+        bit = stream_ready;
+        stream_ready = 0U;
+        stream_held |= bit;
+        *block = stream_block[bit >> 1];
+        status = SUCCESS;
+    }
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
+/*!
+    \brief      give a block taken with adc_stream_block_get() back to the DMA
+    \param[in]  block: the block
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR if the DMA had to overwrite the block before
+                it was released, results computed from it are not valid then
+*/
+ErrStatus adc_stream_block_release(const adc_stream_block_struct *block)
+{
+    ErrStatus status = SUCCESS;
+    uint32_t primask = __get_PRIMASK();
+    uint32_t bit = (block->data == stream_cfg.buffer) ? 1U : 2U;
+
+    __disable_irq();
+    stream_held &= ~bit;
+    if(0U != (stream_clobbered & bit)) {
+        stream_clobbered &= ~bit;
+        status = ERROR;
+    }
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
+/*!
+    \brief      read the acquisition counters
+    \param[in]  none
+    \param[out] stats: copy of the counters
+    \retval     none
+*/
+void adc_stream_stats_get(adc_stream_stats_struct *stats)
+{
+    stats->blocks = stream_stats.blocks;
+    stats->late = stream_stats.late;
+    stats->adc_overruns = stream_stats.adc_overruns;
+    stats->irq_cycles_max = stream_stats.irq_cycles_max;
+    stats->sample_rate = stream_stats.sample_rate;
+}
+
+/*!
+    \brief      handle the DMA1 channel 0 interrupt, hand out the block the DMA has filled
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void adc_stream_dma_irq_handler(void)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t half, full, cycles;
+
+    half = (uint32_t)dma_interrupt_flag_get(STREAM_DMA, STREAM_DMA_CH, DMA_INT_FLAG_HTF);
+    full = (uint32_t)dma_interrupt_flag_get(STREAM_DMA, STREAM_DMA_CH, DMA_INT_FLAG_FTF);
+    dma_interrupt_flag_clear(STREAM_DMA, STREAM_DMA_CH, DMA_INT_FLAG_HTF | DMA_INT_FLAG_FTF);
+
+    if(half && full) {
+        /* the interrupt was held off for a whole block: the older of the two is being
+           overwritten already, the DMA position tells which one is the newer */
+        if(DMA_CHCNT(STREAM_DMA, STREAM_DMA_CH) > (stream_dma_number / 2U)) {
+            stream_block_done(1U, 1U, start);
+        } else {
+            stream_block_done(0U, 1U, start);
+        }
+    } else if(half) {
+        stream_block_done(0U, 0U, start);
+    } else if(full) {
+        stream_block_done(1U, 0U, start);
+    } else {
+        /* transfer error flags only */
+    }
+
+    cycles = DWT->CYCCNT - start;
+    if(cycles > stream_stats.irq_cycles_max) {
+        stream_stats.irq_cycles_max = cycles;
+    }
+}
+
+/*!
+    \brief      handle the ADC overrun interrupt, the ADC stops its DMA requests on an
+                overrun so the stream is restarted from the first block
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void adc_stream_adc_irq_handler(void)
+{
+    uint32_t i, overrun = 0U;
+
+    for(i = 0U; i < stream_adcs; i++) {
+        if(RESET != adc_interrupt_flag_get(stream_adc[i], ADC_INT_FLAG_ROVF)) {
+            overrun = 1U;
+        }
+    }
+
+    if(0U != overrun) {
+        stream_stats.adc_overruns++;
+        stream_pending_flags |= ADC_STREAM_BLOCK_GAP;
+        adc_stream_stop();
+        stream_restart();
+    }
+}
+
+/*!
+    \brief      configure the ADCs and their synchronization for the selected mode
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void stream_adc_config(void)
+{
+    uint32_t i, rank, length, adc_periph;
+
+    adc_deinit();
+    adc_clock_config(stream_cfg.adc_clock);
+
+    for(i = 0U; i < stream_adcs; i++) {
+        adc_periph = stream_adc[i];
+
+        adc_resolution_config(adc_periph, stream_cfg.resolution);
+        adc_data_alignment_config(adc_periph, ADC_DATAALIGN_RIGHT);
+
+        /* in parallel mode ADC0 takes the even entries of the list and ADC1 the odd ones,
+           the DMA then stores the samples of a rank next to each other in list order */
+        length = (ADC_STREAM_MODE_DUAL_PARALLEL == stream_cfg.mode) ? (stream_cfg.channel_num / 2U) : stream_cfg.channel_num;
+        adc_channel_length_config(adc_periph, ADC_ROUTINE_CHANNEL, length);
+        for(rank = 0U; rank < length; rank++) {
+            adc_routine_channel_config(adc_periph, (uint8_t)rank,
+                                       (ADC_STREAM_MODE_DUAL_PARALLEL == stream_cfg.mode) ?
+                                       stream_cfg.channel[(2U * rank) + i] : stream_cfg.channel[rank],
+                                       stream_cfg.sample_time);
+        }
+        adc_special_function_config(adc_periph, ADC_SCAN_MODE, (length > 1U) ? ENABLE : DISABLE);
+
+        /* the oversampler sums the conversions of a channel in a row before the result is
+           written, so the DMA and the interrupts only see the decimated samples */
+        if(0U != stream_cfg.oversampling) {
+            adc_oversample_mode_config(adc_periph, ADC_OVERSAMPLING_ALL_CONVERT,
+                                       (uint16_t)stream_cfg.oversample_shift, (uint8_t)stream_cfg.oversample_ratio);
+            adc_oversample_mode_enable(adc_periph);
+        }
+
+        /* only ADC0 is triggered, the synchronization modes start the other ADCs */
+        adc_external_trigger_config(adc_periph, ADC_ROUTINE_CHANNEL, EXTERNAL_TRIGGER_DISABLE);
+
+        adc_interrupt_flag_clear(adc_periph, ADC_INT_FLAG_ROVF);
+        adc_interrupt_enable(adc_periph, ADC_INT_ROVF);
+    }
+
+    if(0U != stream_cfg.trigger_rate) {
+        adc_external_trigger_source_config(ADC0, ADC_ROUTINE_CHANNEL, ADC_EXTTRIG_ROUTINE_T1_TRGO);
+        adc_external_trigger_config(ADC0, ADC_ROUTINE_CHANNEL, EXTERNAL_TRIGGER_RISING);
+    }
+
+    switch(stream_cfg.mode) {
+    case ADC_STREAM_MODE_SINGLE:
+        adc_sync_mode_config(ADC_SYNC_MODE_INDEPENDENT);
+        adc_dma_request_after_last_enable(ADC0);
+        break;
+    case ADC_STREAM_MODE_DUAL_PARALLEL:
+        adc_sync_mode_config(ADC_DAUL_ROUTINE_PARALLEL);
+        adc_sync_dma_request_after_last_enable();
+        break;
+    case ADC_STREAM_MODE_DUAL_INTERLEAVED:
+        adc_sync_mode_config(ADC_DAUL_ROUTINE_FOLLOW_UP);
+        adc_sync_delay_config(stream_cfg.sync_delay);
+        adc_sync_dma_request_after_last_enable();
+        break;
+    default:
+        adc_sync_mode_config(ADC_ALL_ROUTINE_FOLLOW_UP);
+        adc_sync_delay_config(stream_cfg.sync_delay);
+        adc_sync_dma_request_after_last_enable();
+        break;
+    }
+
+    nvic_irq_enable(ADC_IRQn, ADC_STREAM_IRQ_PRIO, 0U);
+
+    for(i = 0U; i < stream_adcs; i++) {
+        adc_enable(stream_adc[i]);
+        adc_calibration_enable(stream_adc[i]);
+    }
+}
+
+/*!
+    \brief      configure DMA1 channel 0 for the ring of two blocks
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void stream_dma_config(void)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+
+    dma_deinit(STREAM_DMA, STREAM_DMA_CH);
+
+    /* the FIFO packs the samples into words and writes them to memory in 4-beat bursts,
+       which keeps the bus load of a multi-MSPS stream low */
+    dma_multi_data_para_struct_init(&dma_init_struct);
+    if(ADC_STREAM_MODE_SINGLE == stream_cfg.mode) {
+        dma_init_struct.periph_addr = (uint32_t)&ADC_RDATA(ADC0);
+        dma_init_struct.periph_width = DMA_PERIPH_WIDTH_16BIT;
+    } else {
+        /* DMA mode 1 packs two samples into each word, in conversion order */
+        dma_init_struct.periph_addr = (uint32_t)&ADC_SYNCDATA;
+        dma_init_struct.periph_width = DMA_PERIPH_WIDTH_32BIT;
+    }
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)stream_cfg.buffer;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_4_BEAT;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
+    dma_init_struct.direction = DMA_PERIPH_TO_MEMORY;
+    dma_init_struct.number = stream_dma_number;
+    dma_init_struct.priority = DMA_PRIORITY_ULTRA_HIGH;
+    dma_multi_data_mode_init(STREAM_DMA, STREAM_DMA_CH, &dma_init_struct);
+    dma_channel_subperipheral_select(STREAM_DMA, STREAM_DMA_CH, STREAM_DMA_SUBPERI);
+
+    /* one interrupt per block and none per sample */
+    dma_interrupt_enable(STREAM_DMA, STREAM_DMA_CH, DMA_INT_HTF | DMA_INT_FTF);
+    nvic_irq_enable(STREAM_DMA_IRQn, ADC_STREAM_IRQ_PRIO, 0U);
+}
+
+/*!
+    \brief      get the clock of TIMER1 on APB1
+    \param[in]  none
+    \param[out] none
+    \retval     clock frequency in Hz
+*/
+static uint32_t stream_timer_clock(void)
+{
+    uint32_t apb1psc = (RCU_CFG0 & RCU_CFG0_APB1PSC) >> 10;
+    uint32_t apb1 = rcu_clock_freq_get(CK_APB1);
+
+    /* APB1PSC 0b0xx is CK_AHB, 0b100 is CK_AHB/2, 0b101 is CK_AHB/4 and so on */
+    if(0U != (RCU_CFG1 & RCU_CFG1_TIMERSEL)) {
+        return (apb1psc <= 5U) ? rcu_clock_freq_get(CK_AHB) : (4U * apb1);
+    }
+    return (apb1psc <= 4U) ? rcu_clock_freq_get(CK_AHB) : (2U * apb1);
+}
+
+/*!
+    \brief      get the ADC clock selected by adc_clock_config()
+    \param[in]  none
+    \param[out] none
+    \retval     clock frequency in Hz
+*/
+static uint32_t stream_adc_clock(void)
+{
+    static const uint8_t pclk2_div[4] = {2U, 4U, 6U, 8U};
+    static const uint8_t hclk_div[4] = {5U, 6U, 10U, 20U};
+    uint32_t sel = (stream_cfg.adc_clock & ADC_SYNCCTL_ADCCK) >> 16;
+
+    if(sel < 4U) {
+        return rcu_clock_freq_get(CK_APB2) / pclk2_div[sel];
+    }
+    return rcu_clock_freq_get(CK_AHB) / hclk_div[sel & 0x3U];
+}
+
+/*!
+    \brief      hand out a block the DMA has filled
+    \param[in]  index: block number in the ring, 0 or 1
+    \param[in]  lost: 1 if the other block was overwritten before it could be handed out
+    \param[in]  cycles: DWT cycle counter at the interrupt
+    \param[out] none
+    \retval     none
+*/
+static void stream_block_done(uint32_t index, uint32_t lost, uint32_t cycles)
+{
+    adc_stream_block_struct *block = &stream_block[index];
+    uint32_t next = (0U == index) ? 2U : 1U;
+
+    if(0U != lost) {
+        /* keep the sample clock timestamp exact across the lost block */
+        stream_samples += stream_cfg.block_samples;
+        stream_sequence++;
+        stream_stats.late++;
+        stream_pending_flags |= ADC_STREAM_BLOCK_LATE;
+    }
+
+    /* the DMA writes into the other block from now on */
+    if(0U != (stream_ready & next)) {
+        stream_ready &= ~next;
+        stream_stats.late++;
+        stream_pending_flags |= ADC_STREAM_BLOCK_LATE;
+    }
+    if(0U != (stream_held & next)) {
+        stream_clobbered |= next;
+        stream_stats.late++;
+    }
+
+    block->data = &stream_cfg.buffer[index * stream_cfg.block_samples];
+    block->samples = stream_cfg.block_samples;
+    block->sequence = stream_sequence++;
+    block->first_sample = stream_samples;
+    block->cycles = cycles;
+    block->flags = stream_pending_flags;
+    stream_pending_flags = 0U;
+    stream_samples += stream_cfg.block_samples;
+    stream_stats.blocks++;
+
+    if(NULL != stream_cfg.block_done) {
+        stream_cfg.block_done(block);
+    } else {
+        stream_ready = (0U == index) ? 1U : 2U;
+    }
+}
+
+/*!
+    \brief      rearm the DMA at the first block and start the conversions
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void stream_restart(void)
+{
+    uint32_t i;
+
+    /* the DMA requests of the ADCs have to be rearmed after an overrun */
+    if(ADC_STREAM_MODE_SINGLE == stream_cfg.mode) {
+        adc_dma_mode_disable(ADC0);
+    } else {
+        adc_sync_dma_config(ADC_SYNC_DMA_DISABLE);
+    }
+    for(i = 0U; i < stream_adcs; i++) {
+        adc_flag_clear(stream_adc[i], ADC_FLAG_ROVF);
+    }
+
+    /* the first block is written again, a block still taken there is lost */
+    stream_ready = 0U;
+    if(0U != (stream_held & 1U)) {
+        stream_clobbered |= 1U;
+    }
+
+    dma_flag_clear(STREAM_DMA, STREAM_DMA_CH, STREAM_DMA_FLAGS);
+    dma_memory_address_config(STREAM_DMA, STREAM_DMA_CH, DMA_MEMORY_0, (uint32_t)stream_cfg.buffer);
+    dma_transfer_number_config(STREAM_DMA, STREAM_DMA_CH, stream_dma_number);
+    dma_channel_enable(STREAM_DMA, STREAM_DMA_CH);
+
+    if(ADC_STREAM_MODE_SINGLE == stream_cfg.mode) {
+        adc_dma_mode_enable(ADC0);
+    } else {
+        adc_sync_dma_config(ADC_SYNC_DMA_MODE1);
+    }
+
+    if(0U != stream_cfg.trigger_rate) {
+        timer_counter_value_config(STREAM_TIMER, 0U);
+        timer_enable(STREAM_TIMER);
+    } else {
+        adc_special_function_config(ADC0, ADC_CONTINUOUS_MODE, ENABLE);
+        adc_software_trigger_enable(ADC0, ADC_ROUTINE_CHANNEL);
+    }
+}
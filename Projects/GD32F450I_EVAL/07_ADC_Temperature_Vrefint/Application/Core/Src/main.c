@@ -35,14 +35,47 @@ OF SUCH DAMAGE.
 #include "gd32f4xx.h"
 #include "gd32f450i_eval.h"
 #include "systick.h"
+#include "adc_stream.h"
+#include "adc_filter.h"
 #include <stdio.h>
 
-float temperature;
-float vref_value;
-float battery_value;
+/* channel 16 (temperature), 17 (VREFINT) and 18 (VBAT/4) are converted 1000 times per second,
+   each conversion is the hardware average of 8 */
+#define SEQUENCE_RATE           1000U
+#define CHANNELS                3U
+/* 32 sequences per block */
+#define BLOCK_SAMPLES           (32U * CHANNELS)
+
+/* 1000Hz -> CIC order 3, ratio 8 -> 125Hz -> 16 tap FIR, cut-off 10Hz, decimation 5 -> 25Hz
+   -> Butterworth biquad, cut-off 1Hz. the CIC gain of 512 shifted by 8 turns the 14-bit
+   oversampled samples into 15-bit ones, 32768 is the 3.3V reference */
+#define CIC_ORDER               3U
+#define CIC_RATIO               8U
+#define CIC_SHIFT               8U
+#define FIR_DECIMATION          5U
+
+static const int16_t fir_coeff[16] = {
+    -71, -26, 177, 774, 1876, 3329, 4731, 5594, 5594, 4731, 3329, 1876, 774, 177, -26, -71
+};
+static const int16_t iir_coeff[1][5] = {
+    {219, 437, 219, -26992, 11483}
+};
+
+__ALIGNED(16) static uint16_t adc_ring[2U * BLOCK_SAMPLES];
+static adc_chain_struct adc_chain[CHANNELS];
+
+/* filter benchmark, summed by the block callback */
+static volatile uint32_t filter_cycles;
+static volatile uint32_t filter_samples;
+
+int32_t temperature;
+int32_t vref_value;
+int32_t battery_value;
 
 void rcu_config(void);
 void adc_config(void);
+static void adc_block_done(const adc_stream_block_struct *block);
+static int32_t adc_code_to_uv(int16_t code);
 
 /*!
     \brief      main function
@@ -52,6 +85,11 @@ void adc_config(void);
 */
 int main(void)
 {
+    adc_stats_result_struct result[CHANNELS];
+    int16_t value[CHANNELS] = {0};
+    int16_t out[ADC_CHAIN_OUT_SIZE];
+    uint32_t ch, n, cycles, samples;
+
     /* system clocks configuration */
     rcu_config();
     /* ADC configuration */
@@ -61,19 +99,50 @@ int main(void)
     /* configure systick */
     systick_config();
 
+    adc_stream_start();
+
     while(1){
-        /* ADC software trigger enable */
-        adc_software_trigger_enable(ADC0,ADC_INSERTED_CHANNEL);
         /* delay a time in milliseconds */
         delay_ms(2000);
-        /* value convert  */
-        temperature = (1.42-ADC_IDATA0(ADC0)*3.3/4096)*1000/4.35+25;
-        vref_value = (ADC_IDATA1(ADC0)*3.3/4096);
-        battery_value = (ADC_IDATA2(ADC0)*4*3.3/4096);
+
+        /* the newest filtered value of every channel, and the raw statistics of the window */
+        for(ch = 0U; ch < CHANNELS; ch++) {
+            n = adc_chain_read(&adc_chain[ch], out, ADC_CHAIN_OUT_SIZE);
+            if(0U != n) {
+                value[ch] = out[n - 1U];
+            }
+            __disable_irq();
+            adc_stats_result(&adc_chain[ch].stats, &result[ch]);
+            adc_stats_reset(&adc_chain[ch].stats);
+            __enable_irq();
+        }
+        __disable_irq();
+        cycles = filter_cycles;
+        samples = filter_samples;
+        filter_cycles = 0U;
+        filter_samples = 0U;
+        __enable_irq();
+
+        /* value convert, 4.35mV per degree and 1.42V at 25 degrees */
+        temperature = ((1420000 - adc_code_to_uv(value[0])) * 100) / 435 + 25000;
+        vref_value = adc_code_to_uv(value[1]);
+        battery_value = 4 * adc_code_to_uv(value[2]);
         /* value print */
-        printf(" the temperature data is %2.0f degrees Celsius\r\n",temperature);
-        printf(" the reference voltage data is %5.3fV \r\n",vref_value);
-        printf(" the battery voltage is %5.3fV \r\n",battery_value);
+        printf(" the temperature data is %ld.%01ld degrees Celsius\r\n",
+               (long)(temperature / 1000), (long)((temperature % 1000) / 100));
+        printf(" the reference voltage data is %ld.%03ldV \r\n",
+               (long)(vref_value / 1000000), (long)((vref_value % 1000000) / 1000));
+        printf(" the battery voltage is %ld.%03ldV \r\n",
+               (long)(battery_value / 1000000), (long)((battery_value % 1000000) / 1000));
+        for(ch = 0U; ch < CHANNELS; ch++) {
+            printf(" channel %lu raw: %lu samples, min %u, max %u, noise %lu.%02lu LSB rms \r\n",
+                   (unsigned long)(16U + ch), (unsigned long)result[ch].count, result[ch].min, result[ch].max,
+                   (unsigned long)(result[ch].rms / 16U), (unsigned long)(((result[ch].rms % 16U) * 100U) / 16U));
+        }
+        if(0U != samples) {
+            printf(" filter chain: %lu.%02lu cycles per input sample \r\n",
+                   (unsigned long)(cycles / samples), (unsigned long)(((cycles % samples) * 100U) / samples));
+        }
         printf(" \r\n");
     }
 }
@@ -86,45 +155,82 @@ int main(void)
 */
 void rcu_config(void)
 {
-    /* enable ADC clock */
-    rcu_periph_clock_enable(RCU_ADC0);
-    /* config ADC clock */
-    adc_clock_config(ADC_ADCCK_PCLK2_DIV4);
+    /* TIMER1 runs at CK_AHB, adc_stream_init() enables the ADC, DMA and TIMER clocks */
+    rcu_timer_clock_prescaler_config(RCU_TIMER_PSC_MUL4);
 }
 
 /*!
-    \brief      configure the ADC peripheral
+    \brief      configure the ADC stream and the filter chains
     \param[in]  none
     \param[out] none
     \retval     none
 */
 void adc_config(void)
 {
-    /* ADC channel length config */
-    adc_channel_length_config(ADC0,ADC_INSERTED_CHANNEL,3);
-
-    /* ADC temperature sensor channel config */
-    adc_inserted_channel_config(ADC0,0,ADC_CHANNEL_16,ADC_SAMPLETIME_480);
-    /* ADC internal reference voltage channel config */
-    adc_inserted_channel_config(ADC0,1,ADC_CHANNEL_17,ADC_SAMPLETIME_480);
-    /* ADC 1/4 voltate of external battery config */
-    adc_inserted_channel_config(ADC0,2,ADC_CHANNEL_18,ADC_SAMPLETIME_480);
-
-    /* ADC external trigger enable */
-    adc_external_trigger_config(ADC0,ADC_INSERTED_CHANNEL,DISABLE);
-    /* ADC data alignment config */
-    adc_data_alignment_config(ADC0,ADC_DATAALIGN_RIGHT);
-    /* ADC SCAN function enable */
-    adc_special_function_config(ADC0,ADC_SCAN_MODE,ENABLE);
+    adc_stream_config_struct config = {
+        .mode = ADC_STREAM_MODE_SINGLE,
+        .trigger_rate = SEQUENCE_RATE,
+        .adc_clock = ADC_ADCCK_PCLK2_DIV4,
+        .resolution = ADC_RESOLUTION_12B,
+        .sample_time = ADC_SAMPLETIME_480,
+        /* 8 conversions of 19.7us per channel, 473us per sequence */
+        .oversample_ratio = ADC_OVERSAMPLING_RATIO_MUL8,
+        .oversample_shift = ADC_OVERSAMPLING_SHIFT_1B,
+        .oversampling = 1U,
+        .channel = {ADC_CHANNEL_16, ADC_CHANNEL_17, ADC_CHANNEL_18},
+        .channel_num = CHANNELS,
+        .buffer = adc_ring,
+        .block_samples = BLOCK_SAMPLES,
+        .block_done = adc_block_done
+    };
+    uint32_t ch;
+
+    for(ch = 0U; ch < CHANNELS; ch++) {
+        adc_cic_init(&adc_chain[ch].cic, CIC_ORDER, CIC_RATIO, CIC_SHIFT);
+        adc_fir_init(&adc_chain[ch].fir, fir_coeff, 16U, FIR_DECIMATION);
+        adc_iir_init(&adc_chain[ch].iir, iir_coeff, 1U);
+        adc_stats_reset(&adc_chain[ch].stats);
+    }
+
+    if(ERROR == adc_stream_init(&config)) {
+        while(1) {
+        }
+    }
+
     /* ADC Vbat channel enable */
     adc_channel_16_to_18(ADC_VBAT_CHANNEL_SWITCH,ENABLE);
     /* ADC temperature and Vrefint enable */
     adc_channel_16_to_18(ADC_TEMP_VREF_CHANNEL_SWITCH,ENABLE);
-    
-    /* enable ADC interface */
-    adc_enable(ADC0);
-    /* ADC calibration and reset calibration */
-    adc_calibration_enable(ADC0);
+}
+
+/*!
+    \brief      run the channels of a block through their filter chains, called from the DMA interrupt
+    \param[in]  block: the block, the three channels alternate
+    \param[out] none
+    \retval     none
+*/
+static void adc_block_done(const adc_stream_block_struct *block)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t ch;
+
+    for(ch = 0U; ch < CHANNELS; ch++) {
+        adc_chain_process(&adc_chain[ch], &block->data[ch], CHANNELS, block->samples / CHANNELS);
+    }
+
+    filter_cycles += DWT->CYCCNT - start;
+    filter_samples += block->samples;
+}
+
+/*!
+    \brief      convert a filtered sample to microvolts
+    \param[in]  code: filtered sample, 32768 is the 3.3V reference
+    \param[out] none
+    \retval     voltage in microvolts
+*/
+static int32_t adc_code_to_uv(int16_t code)
+{
+    return (int32_t)(((int64_t)code * 3300000) / 32768);
 }
 
 /* retarget the C library printf function to the USART */
@@ -0,0 +1,110 @@
+/*!
+    \file    adc_stream.h
+    \brief   the header file of the DMA driven continuous ADC acquisition engine
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include "gd32f4xx.h"
+
+/* acquisition modes, the samples of a block always follow the order of the channel list */
+#define ADC_STREAM_MODE_SINGLE              0U      /*!< ADC0 converts the channel list on every trigger */
+#define ADC_STREAM_MODE_DUAL_PARALLEL       1U      /*!< ADC0 and ADC1 convert at the same time, even list entries on ADC0, odd ones on ADC1 */
+#define ADC_STREAM_MODE_DUAL_INTERLEAVED    2U      /*!< ADC0 and ADC1 take turns on one channel, two samples per trigger */
+#define ADC_STREAM_MODE_TRIPLE_INTERLEAVED  3U      /*!< ADC0, ADC1 and ADC2 take turns on one channel, three samples per trigger */
+
+/* longest channel list */
+#define ADC_STREAM_CHANNEL_MAX              16U
+/* preemption priority of the DMA and ADC overrun interrupts */
+#define ADC_STREAM_IRQ_PRIO                 1U
+
+/* block flags */
+#define ADC_STREAM_BLOCK_GAP                0x01U   /*!< samples are missing before this block, the ADC overran and the stream was restarted */
+#define ADC_STREAM_BLOCK_LATE               0x02U   /*!< the blocks before this one were overwritten before they could be handed out */
+
+/* a block of samples handed to the consumer */
+typedef struct {
+    const uint16_t *data;                           /*!< samples, right aligned, in the order of the channel list */
+    uint32_t samples;                               /*!< number of samples */
+    uint32_t sequence;                              /*!< block number since the start */
+    uint64_t first_sample;                          /*!< number of samples delivered before this block, the sample clock timestamp */
+    uint32_t cycles;                                /*!< DWT cycle counter when the block was complete */
+    uint32_t flags;                                 /*!< ADC_STREAM_BLOCK_x */
+} adc_stream_block_struct;
+
+/* acquisition configuration */
+typedef struct {
+    uint32_t mode;                                  /*!< ADC_STREAM_MODE_x */
+    uint32_t trigger_rate;                          /*!< TIMER1 triggers per second, 0 lets ADC0 convert continuously */
+    uint32_t adc_clock;                             /*!< ADC_ADCCK_x, at most 40MHz */
+    uint32_t resolution;                            /*!< ADC_RESOLUTION_x */
+    uint32_t sample_time;                           /*!< ADC_SAMPLETIME_x, for all channels */
+    uint32_t sync_delay;                            /*!< ADC_SYNC_DELAY_x, spacing of the interleaved conversions */
+    uint32_t oversample_ratio;                      /*!< ADC_OVERSAMPLING_RATIO_x, every sample is the sum of this many conversions */
+    uint32_t oversample_shift;                      /*!< ADC_OVERSAMPLING_SHIFT_x, right shift of the sum */
+    uint8_t oversampling;                           /*!< 1 enables the hardware oversampling */
+    uint8_t channel[ADC_STREAM_CHANNEL_MAX];        /*!< channel list */
+    uint8_t channel_num;                            /*!< entries in the channel list, 1 in the interleaved modes */
+    uint16_t *buffer;                               /*!< ring of two blocks, 16-byte aligned */
+    uint32_t block_samples;                         /*!< samples per block, a multiple of 8 and of the channel number */
+    void (*block_done)(const adc_stream_block_struct *block); /*!< called from the DMA interrupt, NULL to poll with adc_stream_block_get() */
+} adc_stream_config_struct;
+
+/* acquisition counters */
+typedef struct {
+    uint32_t blocks;                                /*!< blocks completed by the DMA */
+    uint32_t late;                                  /*!< blocks overwritten before the consumer took or released them */
+    uint32_t adc_overruns;                          /*!< ADC data overruns, each one restarts the stream */
+    uint32_t irq_cycles_max;                        /*!< longest DMA interrupt including the callback, in core cycles */
+    uint32_t sample_rate;                           /*!< samples per second actually produced, all channels together */
+} adc_stream_stats_struct;
+
+/* function declarations */
+/* configure the ADCs, TIMER1 and DMA1 channel 0 for an acquisition */
+ErrStatus adc_stream_init(const adc_stream_config_struct *config);
+/* start the acquisition */
+void adc_stream_start(void);
+/* stop the acquisition */
+void adc_stream_stop(void);
+/* take the oldest complete block when no callback is used */
+ErrStatus adc_stream_block_get(adc_stream_block_struct *block);
+/* give a block taken with adc_stream_block_get() back to the DMA */
+ErrStatus adc_stream_block_release(const adc_stream_block_struct *block);
+/* read the acquisition counters */
+void adc_stream_stats_get(adc_stream_stats_struct *stats);
+/* handle the DMA1 channel 0 interrupt */
+void adc_stream_dma_irq_handler(void);
+/* handle the ADC overrun interrupt */
+void adc_stream_adc_irq_handler(void);
+
+#endif /* ADC_STREAM_H */
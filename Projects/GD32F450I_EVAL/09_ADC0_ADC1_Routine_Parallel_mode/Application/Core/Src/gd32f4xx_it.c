@@ -34,6 +34,7 @@ OF SUCH DAMAGE.
 
 #include "gd32f4xx_it.h"
 #include "systick.h"
+#include "adc_stream.h"
 
 /*!
     \brief      this function handles NMI exception
@@ -149,3 +150,25 @@ void SysTick_Handler(void)
 {
     delay_decrement();
 }
+
+/*!
+    \brief      this function handles ADC interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void ADC_IRQHandler(void)
+{
+    adc_stream_adc_irq_handler();
+}
+
+/*!
+    \brief      this function handles DMA1 channel0 (ADC) interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void DMA1_Channel0_IRQHandler(void)
+{
+    adc_stream_dma_irq_handler();
+}
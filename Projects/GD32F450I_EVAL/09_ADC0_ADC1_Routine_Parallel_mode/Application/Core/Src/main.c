@@ -35,15 +35,25 @@ OF SUCH DAMAGE.
 #include "gd32f4xx.h"
 #include "gd32f450i_eval.h"
 #include "systick.h"
+#include "adc_stream.h"
 #include <stdio.h>
 
+/* PC3 and PC5 are sampled together 500000 times per second, 1 MS/s in total */
+#define SAMPLE_RATE             500000U
+/* 512 pairs per block, one DMA interrupt per millisecond */
+#define BLOCK_SAMPLES           1024U
+
+__ALIGNED(16) static uint16_t adc_ring[2U * BLOCK_SAMPLES];
+
+/* per channel sums of the last two seconds, filled by the block callback */
+static volatile uint32_t adc_sum[2];
+static volatile uint32_t adc_count;
 uint32_t adc_value[2];
 
 void rcu_config(void);
 void gpio_config(void);
-void dma_config(void);
 void adc_config(void);
-void timer_config(void);
+static void adc_block_done(const adc_stream_block_struct *block);
 
 /*!
     \brief      main function
@@ -53,29 +63,70 @@ void timer_config(void);
 */
 int main(void)
 {
+    adc_stream_stats_struct stats;
+    uint32_t sum[2], count;
+
     /* system clocks configuration */
     rcu_config();
     /* GPIO configuration */
     gpio_config();
-    /* TIMER configuration */
-    timer_config();
-    /* DMA configuration */
-    dma_config();
-    /* ADC configuration */
+    /* ADC, TIMER and DMA configuration */
     adc_config();
     /* configure COM port */
     gd_eval_com_init(EVAL_COM0);
     /* configure systick */
     systick_config();
 
+    adc_stream_start();
+
     while(1){
         delay_ms(2000);
+
+        /* take the sums of the window and start the next one */
+        __disable_irq();
+        sum[0] = adc_sum[0];
+        sum[1] = adc_sum[1];
+        count = adc_count;
+        adc_sum[0] = 0U;
+        adc_sum[1] = 0U;
+        adc_count = 0U;
+        __enable_irq();
+
+        if(0U != count) {
+            adc_value[0] = sum[0] / count;
+            adc_value[1] = sum[1] / count;
+        }
+        adc_stream_stats_get(&stats);
+
         printf(" the data adc_value[0] is %08X \r\n",adc_value[0]);
         printf(" the data adc_value[1] is %08X \r\n",adc_value[1]);
+        printf(" %u samples/s, %u blocks, %u late, %u overruns, longest interrupt %u cycles \r\n",
+               (unsigned)stats.sample_rate, (unsigned)stats.blocks, (unsigned)stats.late,
+               (unsigned)stats.adc_overruns, (unsigned)stats.irq_cycles_max);
         printf("\r\n");
     }
 }
 
+/*!
+    \brief      average the pairs of a block into the running sums, called from the DMA interrupt
+    \param[in]  block: the block, ADC0 (PC3) and ADC1 (PC5) samples alternate
+    \param[out] none
+    \retval     none
+*/
+static void adc_block_done(const adc_stream_block_struct *block)
+{
+    uint32_t i, sum0 = 0U, sum1 = 0U;
+
+    for(i = 0U; i < block->samples; i += 2U) {
+        sum0 += block->data[i];
+        sum1 += block->data[i + 1U];
+    }
+    /* the averages of the block keep the two second sums within 32 bits */
+    adc_sum[0] += sum0 / (block->samples / 2U);
+    adc_sum[1] += sum1 / (block->samples / 2U);
+    adc_count++;
+}
+
 /*!
     \brief      configure the different system clocks
     \param[in]  none
@@ -86,17 +137,8 @@ void rcu_config(void)
 {
     /* enable GPIOC clock */
     rcu_periph_clock_enable(RCU_GPIOC);
-    /* enable DMA clock */
-    rcu_periph_clock_enable(RCU_DMA1);
-    /* enable TIMER1 clock */
-    rcu_periph_clock_enable(RCU_TIMER1);
+    /* TIMER1 runs at CK_AHB, adc_stream_init() enables the ADC, DMA and TIMER clocks */
     rcu_timer_clock_prescaler_config(RCU_TIMER_PSC_MUL4);
-    /* enable ADC0 clock */
-    rcu_periph_clock_enable(RCU_ADC0);
-    /* enable ADC1 clock */
-    rcu_periph_clock_enable(RCU_ADC1);
-    /* config ADC clock */
-    adc_clock_config(ADC_ADCCK_PCLK2_DIV4);
 }
 
 /*!
@@ -112,114 +154,33 @@ void gpio_config(void)
 }
 
 /*!
-    \brief      configure the DMA peripheral
-    \param[in]  none
-    \param[out] none
-    \retval     none
-*/
-void dma_config(void)
-{
-    /* ADC_DMA_channel configuration */
-    dma_single_data_parameter_struct dma_single_data_parameter;
-    
-    /* ADC DMA_channel deinit */
-    dma_deinit(DMA1,DMA_CH0);
-    
-    /* initialize DMA single data mode */
-    dma_single_data_parameter.periph_addr = (uint32_t)(&ADC_SYNCDATA);
-    dma_single_data_parameter.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
-    dma_single_data_parameter.memory0_addr = (uint32_t)(adc_value);
-    dma_single_data_parameter.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
-    dma_single_data_parameter.periph_memory_width = DMA_PERIPH_WIDTH_32BIT;
-    dma_single_data_parameter.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
-    dma_single_data_parameter.direction = DMA_PERIPH_TO_MEMORY;
-    dma_single_data_parameter.number = 2;
-    dma_single_data_parameter.priority = DMA_PRIORITY_HIGH;
-    dma_single_data_mode_init(DMA1,DMA_CH0, &dma_single_data_parameter);
-    /* DMA channel 0 peripheral select */
-    dma_channel_subperipheral_select(DMA1,DMA_CH0,DMA_SUBPERI0);
-
-    /* enable DMA channel */
-    dma_channel_enable(DMA1,DMA_CH0);
-}
-
-/*!
-    \brief      configure the ADC peripheral
+    \brief      configure the ADC stream: TIMER1 triggers ADC0 and ADC1 in routine parallel
+                mode and DMA1 channel 0 moves the pairs into adc_ring[]
     \param[in]  none
     \param[out] none
     \retval     none
 */
 void adc_config(void)
 {
-    /* ADC channel length config */
-    adc_channel_length_config(ADC0,ADC_ROUTINE_CHANNEL,2);
-    adc_channel_length_config(ADC1,ADC_ROUTINE_CHANNEL,2);
-    /* ADC routine channel config */
-    adc_routine_channel_config(ADC0,0,ADC_CHANNEL_13,ADC_SAMPLETIME_144);
-    adc_routine_channel_config(ADC0,1,ADC_CHANNEL_15,ADC_SAMPLETIME_144);
-    adc_routine_channel_config(ADC1,1,ADC_CHANNEL_13,ADC_SAMPLETIME_144);
-    adc_routine_channel_config(ADC1,0,ADC_CHANNEL_15,ADC_SAMPLETIME_144);
-    /* ADC external trigger enable */
-    adc_external_trigger_config(ADC0,ADC_ROUTINE_CHANNEL,EXTERNAL_TRIGGER_RISING);
-    adc_external_trigger_config(ADC1,ADC_ROUTINE_CHANNEL,EXTERNAL_TRIGGER_DISABLE);
-    adc_external_trigger_source_config(ADC0,ADC_ROUTINE_CHANNEL,ADC_EXTTRIG_ROUTINE_T1_CH1);
-    
-    /* ADC data alignment config */
-    adc_data_alignment_config(ADC0,ADC_DATAALIGN_RIGHT);
-    adc_data_alignment_config(ADC1,ADC_DATAALIGN_RIGHT);
-    /* configure the ADC sync mode */
-    adc_sync_mode_config(ADC_DAUL_ROUTINE_PARALLEL);
-    adc_sync_dma_config(ADC_SYNC_DMA_MODE1);
-    adc_sync_dma_request_after_last_enable();
-    /* ADC scan mode function enable */
-    adc_special_function_config(ADC0,ADC_SCAN_MODE,ENABLE);
-    adc_special_function_config(ADC1,ADC_SCAN_MODE,ENABLE);
-    
-    /* enable ADC interface */
-    adc_enable(ADC0);
-    /* ADC calibration and reset calibration */
-    adc_calibration_enable(ADC0);
-    /* enable ADC interface */
-    adc_enable(ADC1);
-    /* ADC calibration and reset calibration */
-    adc_calibration_enable(ADC1);
-}
-
-/*!
-    \brief      configure the timer peripheral
-    \param[in]  none
-    \param[out] none
-    \retval     none
-*/
-void timer_config(void)
-{
-    timer_oc_parameter_struct timer_ocintpara;
-    timer_parameter_struct timer_initpara;
-
-    /* TIMER1 configuration */
-    timer_initpara.prescaler         = 19999;
-    timer_initpara.alignedmode       = TIMER_COUNTER_EDGE;
-    timer_initpara.counterdirection  = TIMER_COUNTER_UP;
-    timer_initpara.period            = 9999;
-    timer_initpara.clockdivision     = TIMER_CKDIV_DIV1;
-    timer_initpara.repetitioncounter = 0;
-    timer_init(TIMER1,&timer_initpara);
-
-    /* CH1 configuration in PWM mode0 */
-    timer_ocintpara.ocpolarity  = TIMER_OC_POLARITY_HIGH;
-    timer_ocintpara.ocnpolarity = TIMER_OCN_POLARITY_HIGH;
-    timer_ocintpara.outputnstate = TIMER_CCXN_DISABLE;
-    timer_ocintpara.outputstate = TIMER_CCX_ENABLE;
-    timer_ocintpara.ocidlestate = TIMER_OC_IDLE_STATE_LOW;
-    timer_ocintpara.ocnidlestate = TIMER_OCN_IDLE_STATE_LOW;
-    timer_channel_output_config(TIMER1,TIMER_CH_1,&timer_ocintpara);
-
-    timer_channel_output_pulse_value_config(TIMER1,TIMER_CH_1,3999);
-    timer_channel_output_mode_config(TIMER1,TIMER_CH_1,TIMER_OC_MODE_PWM0);
-    timer_channel_output_shadow_config(TIMER1,TIMER_CH_1,TIMER_OC_SHADOW_DISABLE);
-    
-    /* enable TIMER1 */
-    timer_enable(TIMER1);
+    adc_stream_config_struct config = {
+        .mode = ADC_STREAM_MODE_DUAL_PARALLEL,
+        .trigger_rate = SAMPLE_RATE,
+        .adc_clock = ADC_ADCCK_PCLK2_DIV4,
+        .resolution = ADC_RESOLUTION_12B,
+        .sample_time = ADC_SAMPLETIME_15,
+        .sync_delay = ADC_SYNC_DELAY_5CYCLE,
+        /* PC3 on ADC0, PC5 on ADC1 */
+        .channel = {ADC_CHANNEL_13, ADC_CHANNEL_15},
+        .channel_num = 2U,
+        .buffer = adc_ring,
+        .block_samples = BLOCK_SAMPLES,
+        .block_done = adc_block_done
+    };
+
+    if(ERROR == adc_stream_init(&config)) {
+        while(1) {
+        }
+    }
 }
 
 /* retarget the C library printf function to the USART */
@@ -0,0 +1,111 @@
+/*!
+    \file    dac_wave.h
+    \brief   definitions for the DMA driven DAC waveform generator
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef DAC_WAVE_H
+#define DAC_WAVE_H
+
+#include "gd32f4xx.h"
+
+/* outputs, both together run in the DAC concurrent mode */
+#define DAC_WAVE_OUT0                   0x01U   /*!< DAC0_OUT0 on PA4 */
+#define DAC_WAVE_OUT1                   0x02U   /*!< DAC0_OUT1 on PA5 */
+#define DAC_WAVE_DUAL                   (DAC_WAVE_OUT0 | DAC_WAVE_OUT1)
+
+/* where the DMA takes the samples from */
+#define DAC_WAVE_SOURCE_SYNTH           0U      /*!< the generators fill the buffer the DMA has just played */
+#define DAC_WAVE_SOURCE_TABLE           1U      /*!< the DMA plays tables from memory, no CPU work per sample */
+
+/* generator types */
+#define DAC_WAVE_GEN_DC                 0U      /*!< constant offset */
+#define DAC_WAVE_GEN_SINE               1U      /*!< DDS sine, 256 entry table with linear interpolation */
+#define DAC_WAVE_GEN_TABLE              2U      /*!< DDS over one period of a user table */
+#define DAC_WAVE_GEN_RAMP               3U      /*!< rising saw tooth */
+#define DAC_WAVE_GEN_TRIANGLE           4U      /*!< triangle */
+#define DAC_WAVE_GEN_NOISE              5U      /*!< white noise, uniform distribution */
+#define DAC_WAVE_GEN_NONE               6U      /*!< the channel is left to the fill callback */
+
+/* preemption priority of the DMA and DAC underrun interrupts */
+#define DAC_WAVE_IRQ_PRIO               1U
+/* largest DAC code */
+#define DAC_WAVE_FULL_SCALE             4095U
+
+/* configuration of one output for the synthesis */
+typedef struct {
+    uint32_t type;                              /*!< DAC_WAVE_GEN_x */
+    uint32_t freq_mhz;                          /*!< frequency of the periodic types in mHz, below half the sample rate */
+    uint16_t amplitude;                         /*!< peak deviation from the offset in LSB */
+    uint16_t offset;                            /*!< mid level in LSB */
+    const int16_t *table;                       /*!< DAC_WAVE_GEN_TABLE: one period, full scale is +-32767 */
+    uint8_t table_bits;                         /*!< DAC_WAVE_GEN_TABLE: the table has 2^table_bits entries, 1 to 16 */
+} dac_wave_gen_struct;
+
+/* waveform engine configuration */
+typedef struct {
+    uint32_t outputs;                           /*!< DAC_WAVE_OUTx or DAC_WAVE_DUAL */
+    uint32_t source;                            /*!< DAC_WAVE_SOURCE_x */
+    uint32_t sample_rate;                       /*!< TIMER5 triggers per second, at most 1MHz with the output buffers */
+    uint16_t *buffer;                           /*!< DAC_WAVE_SOURCE_SYNTH: two buffers of frames, 16-byte aligned */
+    uint32_t frames;                            /*!< frames per buffer or table, a multiple of 8; a frame is one sample per output, OUT0 first */
+    uint8_t output_buffer;                      /*!< 1 enables the DAC output buffers */
+    void (*fill)(uint16_t *data, uint32_t frames); /*!< called from the DMA interrupt after the generators filled a buffer, or NULL */
+} dac_wave_config_struct;
+
+/* engine counters */
+typedef struct {
+    uint32_t buffers;                           /*!< buffers the DMA has played */
+    uint32_t late;                              /*!< buffers still being filled when the DMA came back to them */
+    uint32_t underruns;                         /*!< DAC DMA underruns, each one restarts the output */
+    uint32_t irq_cycles_max;                    /*!< longest DMA interrupt including the synthesis, in core cycles */
+    uint32_t sample_rate;                       /*!< frames per second actually played */
+} dac_wave_stats_struct;
+
+/* function declarations */
+/* configure the DAC, TIMER5 and the DMA for a waveform */
+ErrStatus dac_wave_init(const dac_wave_config_struct *config);
+/* start the output */
+ErrStatus dac_wave_start(void);
+/* stop the output, the DACs keep the last sample */
+void dac_wave_stop(void);
+/* set the generator of an output, from the next buffer on */
+ErrStatus dac_wave_gen_set(uint32_t output, const dac_wave_gen_struct *gen);
+/* play a table of frames, from the next buffer boundary on */
+ErrStatus dac_wave_table_play(const uint16_t *table);
+/* read the engine counters */
+void dac_wave_stats_get(dac_wave_stats_struct *stats);
+/* handle the DMA interrupt of the output */
+void dac_wave_dma_irq_handler(void);
+/* handle the DAC underrun interrupt */
+void dac_wave_dac_irq_handler(void);
+
+#endif /* DAC_WAVE_H */
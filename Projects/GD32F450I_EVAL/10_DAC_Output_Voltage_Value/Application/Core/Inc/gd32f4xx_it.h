@@ -56,5 +56,11 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 /* this function handles SysTick exception */
 void SysTick_Handler(void);
+/* this function handles DMA0 channel 5 interrupt request */
+void DMA0_Channel5_IRQHandler(void);
+/* this function handles DMA0 channel 6 interrupt request */
+void DMA0_Channel6_IRQHandler(void);
+/* this function handles TIMER5 and DAC underrun interrupt request */
+void TIMER5_DAC_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
@@ -0,0 +1,612 @@
+/*!
+    \file    dac_wave.c
+    \brief   DMA driven DAC waveform generator: TIMER5 triggers the conversions and
+             a DMA channel in switch-buffer mode feeds the DAC from two buffers
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "dac_wave.h"
+#include <stddef.h>
+
+/* DAC0_OUT0 requests DMA0 channel 5 and DAC0_OUT1 DMA0 channel 6, sub-peripheral 7 both */
+#define WAVE_DMA                    DMA0
+#define WAVE_DMA_SUBPERI            DMA_SUBPERI7
+#define WAVE_DMA_FLAGS              (DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF)
+#define WAVE_DMA_NUMBER_MAX         0xFFFFU
+/* TIMER5 update event is the conversion trigger */
+#define WAVE_TIMER                  TIMER5
+
+/* one period of a sine, full scale is +-32767 */
+static const int16_t wave_sine[256] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285, 32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+    30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683, 27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+    23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868, 18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+    12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179, 6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+    0, -804, -1608, -2410, -3212, -4011, -4808, -5602, -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+    -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+    -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+    -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+    -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179, -6393, -5602, -4808, -4011, -3212, -2410, -1608, -804
+};
+
+/* state of the generator of one output */
+typedef struct {
+    dac_wave_gen_struct gen;
+    const int16_t *table;
+    uint32_t table_bits;
+    uint32_t phase;
+    uint32_t step;
+} wave_channel_struct;
+
+static dac_wave_config_struct wave_cfg;
+/* samples per frame, 1 or 2 */
+static uint32_t wave_stride = 1U;
+static dma_channel_enum wave_dma_ch = DMA_CH5;
+static uint8_t wave_dma_irq = (uint8_t)DMA0_Channel5_IRQn;
+static uint32_t wave_running = 0U;
+static wave_channel_struct wave_channel[2];
+/* generators set with dac_wave_gen_set(), taken over at the next buffer */
+static dac_wave_gen_struct wave_gen_next[2];
+static volatile uint32_t wave_gen_pending = 0U;
+/* table played in DAC_WAVE_SOURCE_TABLE mode, written into the idle memory address of the DMA */
+static const uint16_t *volatile wave_table = NULL;
+static uint32_t wave_noise = 0x2545F491U;
+static volatile dac_wave_stats_struct wave_stats;
+
+static uint32_t wave_timer_clock(void);
+static void wave_dma_config(void);
+static void wave_gen_apply(uint32_t ch);
+static void wave_synth(uint32_t ch, uint16_t *data);
+static void wave_fill(uint16_t *data);
+static inline uint16_t wave_clamp(int32_t v);
+static void wave_restart(void);
+
+/*!
+    \brief      configure the DAC, TIMER5 and the DMA for a waveform
+    \param[in]  config: waveform configuration, copied
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the configuration cannot be served
+*/
+ErrStatus dac_wave_init(const dac_wave_config_struct *config)
+{
+    timer_parameter_struct timer_initpara;
+    uint32_t timer_clock, ticks, prescaler, period, ch;
+
+    if((0U == (config->outputs & DAC_WAVE_DUAL)) || (0U != (config->outputs & ~DAC_WAVE_DUAL)) ||
+            (config->source > DAC_WAVE_SOURCE_TABLE) || (0U == config->sample_rate) ||
+            (0U == config->frames) || (0U != (config->frames % 8U)) || (config->frames > WAVE_DMA_NUMBER_MAX)) {
+        return ERROR;
+    }
+    if((DAC_WAVE_SOURCE_SYNTH == config->source) &&
+            ((NULL == config->buffer) || (0U != ((uint32_t)config->buffer & 0xFU)))) {
+        return ERROR;
+    }
+
+    /* TIMER5 is 16-bit wide, the prescaler takes what the period cannot hold */
+    timer_clock = wave_timer_clock();
+    ticks = (timer_clock + (config->sample_rate / 2U)) / config->sample_rate;
+    prescaler = (ticks + 0xFFFFU) / 0x10000U;
+    if((ticks < 2U) || (prescaler > 0x10000U)) {
+        return ERROR;
+    }
+    period = ((timer_clock / prescaler) + (config->sample_rate / 2U)) / config->sample_rate;
+
+    if(0U != wave_running) {
+        dac_wave_stop();
+    }
+
+    wave_cfg = *config;
+    wave_stride = (DAC_WAVE_DUAL == config->outputs) ? 2U : 1U;
+    if(DAC_WAVE_OUT1 == config->outputs) {
+        wave_dma_ch = DMA_CH6;
+        wave_dma_irq = (uint8_t)DMA0_Channel6_IRQn;
+    } else {
+        wave_dma_ch = DMA_CH5;
+        wave_dma_irq = (uint8_t)DMA0_Channel5_IRQn;
+    }
+    wave_table = NULL;
+    wave_stats.sample_rate = timer_clock / (prescaler * period);
+
+    /* the generators keep their settings and phase over a new configuration, only the
+       steps depend on the sample rate */
+    for(ch = 0U; ch < 2U; ch++) {
+        wave_gen_apply(ch);
+    }
+
+    rcu_periph_clock_enable(RCU_DAC);
+    rcu_periph_clock_enable(RCU_DMA0);
+    rcu_periph_clock_enable(RCU_TIMER5);
+
+    timer_deinit(WAVE_TIMER);
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = (uint16_t)(prescaler - 1U);
+    timer_initpara.alignedmode = TIMER_COUNTER_EDGE;
+    timer_initpara.counterdirection = TIMER_COUNTER_UP;
+    timer_initpara.period = period - 1U;
+    timer_initpara.clockdivision = TIMER_CKDIV_DIV1;
+    timer_init(WAVE_TIMER, &timer_initpara);
+    timer_master_output_trigger_source_select(WAVE_TIMER, TIMER_TRI_OUT_SRC_UPDATE);
+
+    /* both outputs convert on the same trigger, in the concurrent mode from one data register */
+    dac_deinit(DAC0);
+    for(ch = 0U; ch < 2U; ch++) {
+        if(0U != (config->outputs & (1U << ch))) {
+            dac_trigger_source_config(DAC0, (uint8_t)ch, DAC_TRIGGER_T5_TRGO);
+            dac_trigger_enable(DAC0, (uint8_t)ch);
+            dac_wave_mode_config(DAC0, (uint8_t)ch, DAC_WAVE_DISABLE);
+            if(0U != config->output_buffer) {
+                dac_output_buffer_enable(DAC0, (uint8_t)ch);
+            } else {
+                dac_output_buffer_disable(DAC0, (uint8_t)ch);
+            }
+        }
+    }
+    if(DAC_WAVE_DUAL == config->outputs) {
+        dac_concurrent_enable(DAC0);
+    } else {
+        dac_enable(DAC0, (DAC_WAVE_OUT0 == config->outputs) ? DAC_OUT0 : DAC_OUT1);
+    }
+
+    /* the DAC stops its DMA requests on an underrun, the handler restarts the output */
+    dac_interrupt_flag_clear(DAC0, DAC_INT_FLAG_DDUDR0 | DAC_INT_FLAG_DDUDR1);
+    dac_interrupt_enable(DAC0, (DAC_WAVE_OUT1 == config->outputs) ? DAC_INT_DDUDR1 : DAC_INT_DDUDR0);
+    nvic_irq_enable(TIMER5_DAC_IRQn, DAC_WAVE_IRQ_PRIO, 0U);
+
+    wave_dma_config();
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      start the output, in DAC_WAVE_SOURCE_TABLE mode a table must have been
+                given with dac_wave_table_play() before
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if there is nothing to play
+*/
+ErrStatus dac_wave_start(void)
+{
+    if((DAC_WAVE_SOURCE_TABLE == wave_cfg.source) && (NULL == wave_table)) {
+        return ERROR;
+    }
+
+    /* the interrupt time is measured with the DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    wave_stats.buffers = 0U;
+    wave_stats.late = 0U;
+    wave_stats.underruns = 0U;
+    wave_stats.irq_cycles_max = 0U;
+
+    wave_restart();
+    wave_running = 1U;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      stop the output, the DACs keep the last sample
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void dac_wave_stop(void)
+{
+    timer_disable(WAVE_TIMER);
+    dac_dma_disable(DAC0, (DAC_WAVE_OUT1 == wave_cfg.outputs) ? DAC_OUT1 : DAC_OUT0);
+
+    dma_channel_disable(WAVE_DMA, wave_dma_ch);
+    while(0U != (DMA_CHCTL(WAVE_DMA, wave_dma_ch) & DMA_CHXCTL_CHEN)) {
+    }
+    wave_running = 0U;
+}
+
+/*!
+    \brief      set the generator of an output, the DMA interrupt takes it over when it fills
+                the next buffer, so a running waveform changes at a buffer boundary and the
+                periodic types continue with the phase they had
+    \param[in]  output: DAC_WAVE_OUT0 or DAC_WAVE_OUT1
+    \param[in]  gen: generator configuration, copied
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the configuration is not valid
+*/
+ErrStatus dac_wave_gen_set(uint32_t output, const dac_wave_gen_struct *gen)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t ch;
+
+    if(((DAC_WAVE_OUT0 != output) && (DAC_WAVE_OUT1 != output)) || (gen->type > DAC_WAVE_GEN_NONE) ||
+            ((DAC_WAVE_GEN_TABLE == gen->type) &&
+             ((NULL == gen->table) || (0U == gen->table_bits) || (gen->table_bits > 16U)))) {
+        return ERROR;
+    }
+    ch = output >> 1;
+
+    __disable_irq();
+    wave_gen_next[ch] = *gen;
+    wave_gen_pending |= output;
+    __set_PRIMASK(primask);
+
+    /* before the start there is no buffer boundary to wait for */
+    if(0U == wave_running) {
+        wave_gen_apply(ch);
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      play a table of frames in DAC_WAVE_SOURCE_TABLE mode; the table has the frames
+                of one buffer in the buffer format and replaces the table before at a buffer
+                boundary, without a gap or a repeated sample
+    \param[in]  table: frames, 16-byte aligned, must stay valid while it is played
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the engine plays synthesized buffers
+*/
+ErrStatus dac_wave_table_play(const uint16_t *table)
+{
+    if((DAC_WAVE_SOURCE_TABLE != wave_cfg.source) || (NULL == table) || (0U != ((uint32_t)table & 0xFU))) {
+        return ERROR;
+    }
+
+    /* the DMA interrupt writes it into the address of the memory that is not played */
+    wave_table = table;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      read the engine counters
+    \param[in]  none
+    \param[out] stats: copy of the counters
+    \retval     none
+*/
+void dac_wave_stats_get(dac_wave_stats_struct *stats)
+{
+    stats->buffers = wave_stats.buffers;
+    stats->late = wave_stats.late;
+    stats->underruns = wave_stats.underruns;
+    stats->irq_cycles_max = wave_stats.irq_cycles_max;
+    stats->sample_rate = wave_stats.sample_rate;
+}
+
+/*!
+    \brief      handle the DMA interrupt of the output: the DMA has switched to the other
+                memory, the one it has played is refilled or pointed at the current table
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void dac_wave_dma_irq_handler(void)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t playing, idle, cycles;
+    uint16_t *data;
+
+    if(RESET == dma_interrupt_flag_get(WAVE_DMA, wave_dma_ch, DMA_INT_FLAG_FTF)) {
+        return;
+    }
+    dma_interrupt_flag_clear(WAVE_DMA, wave_dma_ch, DMA_INT_FLAG_FTF);
+    wave_stats.buffers++;
+
+    playing = dma_using_memory_get(WAVE_DMA, wave_dma_ch);
+    idle = (DMA_MEMORY_0 == playing) ? DMA_MEMORY_1 : DMA_MEMORY_0;
+
+    if(DAC_WAVE_SOURCE_TABLE == wave_cfg.source) {
+        dma_memory_address_config(WAVE_DMA, wave_dma_ch, (uint8_t)idle, (uint32_t)wave_table);
+    } else {
+        data = &wave_cfg.buffer[(DMA_MEMORY_0 == idle) ? 0U : (wave_cfg.frames * wave_stride)];
+        wave_fill(data);
+
+        /* the DMA is back at the buffer before it was complete */
+        if(dma_using_memory_get(WAVE_DMA, wave_dma_ch) != playing) {
+            wave_stats.late++;
+        }
+    }
+
+    cycles = DWT->CYCCNT - start;
+    if(cycles > wave_stats.irq_cycles_max) {
+        wave_stats.irq_cycles_max = cycles;
+    }
+}
+
+/*!
+    \brief      handle the DAC underrun interrupt, a trigger came before the DMA delivered
+                the sample; the DAC stops its DMA requests then, so the output is restarted
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void dac_wave_dac_irq_handler(void)
+{
+    uint32_t flag = (DAC_WAVE_OUT1 == wave_cfg.outputs) ? DAC_INT_FLAG_DDUDR1 : DAC_INT_FLAG_DDUDR0;
+
+    if(RESET != dac_interrupt_flag_get(DAC0, flag)) {
+        dac_interrupt_flag_clear(DAC0, flag);
+        wave_stats.underruns++;
+        dac_wave_stop();
+        wave_restart();
+        wave_running = 1U;
+    }
+}
+
+/*!
+    \brief      get the clock of TIMER5 on APB1
+    \param[in]  none
+    \param[out] none
+    \retval     clock frequency in Hz
+*/
+static uint32_t wave_timer_clock(void)
+{
+    uint32_t apb1psc = (RCU_CFG0 & RCU_CFG0_APB1PSC) >> 10;
+    uint32_t apb1 = rcu_clock_freq_get(CK_APB1);
+
+    /* APB1PSC 0b0xx is CK_AHB, 0b100 is CK_AHB/2, 0b101 is CK_AHB/4 and so on */
+    if(0U != (RCU_CFG1 & RCU_CFG1_TIMERSEL)) {
+        return (apb1psc <= 5U) ? rcu_clock_freq_get(CK_AHB) : (4U * apb1);
+    }
+    return (apb1psc <= 4U) ? rcu_clock_freq_get(CK_AHB) : (2U * apb1);
+}
+
+/*!
+    \brief      configure the DMA channel of the output in switch-buffer mode
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void wave_dma_config(void)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+
+    dma_deinit(WAVE_DMA, wave_dma_ch);
+
+    /* the FIFO reads the buffers in 4-beat bursts of words and hands out one frame per
+       DAC request, in the concurrent mode both samples of a frame in one word */
+    dma_multi_data_para_struct_init(&dma_init_struct);
+    if(DAC_WAVE_DUAL == wave_cfg.outputs) {
+        dma_init_struct.periph_addr = (uint32_t)&DACC_R12DH(DAC0);
+        dma_init_struct.periph_width = DMA_PERIPH_WIDTH_32BIT;
+    } else if(DAC_WAVE_OUT0 == wave_cfg.outputs) {
+        dma_init_struct.periph_addr = (uint32_t)&DAC_OUT0_R12DH(DAC0);
+        dma_init_struct.periph_width = DMA_PERIPH_WIDTH_16BIT;
+    } else {
+        dma_init_struct.periph_addr = (uint32_t)&DAC_OUT1_R12DH(DAC0);
+        dma_init_struct.periph_width = DMA_PERIPH_WIDTH_16BIT;
+    }
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)wave_cfg.buffer;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_4_BEAT;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.number = wave_cfg.frames;
+    dma_init_struct.priority = DMA_PRIORITY_HIGH;
+    dma_multi_data_mode_init(WAVE_DMA, wave_dma_ch, &dma_init_struct);
+    dma_channel_subperipheral_select(WAVE_DMA, wave_dma_ch, WAVE_DMA_SUBPERI);
+
+    /* memory 0 and memory 1 take turns, each end of a buffer raises one interrupt */
+    dma_switch_buffer_mode_enable(WAVE_DMA, wave_dma_ch, ENABLE);
+    dma_interrupt_enable(WAVE_DMA, wave_dma_ch, DMA_INT_FTF);
+    nvic_irq_enable(wave_dma_irq, DAC_WAVE_IRQ_PRIO, 0U);
+}
+
+/*!
+    \brief      take over the generator set for an output and compute its phase step
+    \param[in]  ch: output number, 0 or 1
+    \param[out] none
+    \retval     none
+*/
+static void wave_gen_apply(uint32_t ch)
+{
+    wave_channel_struct *c = &wave_channel[ch];
+
+    if(0U != (wave_gen_pending & (1U << ch))) {
+        wave_gen_pending &= ~(1U << ch);
+        c->gen = wave_gen_next[ch];
+        if(DAC_WAVE_GEN_TABLE == c->gen.type) {
+            c->table = c->gen.table;
+            c->table_bits = c->gen.table_bits;
+        } else {
+            c->table = wave_sine;
+            c->table_bits = 8U;
+        }
+    }
+
+    /* phase step per sample of the 32-bit accumulator */
+    if(0U != wave_stats.sample_rate) {
+        c->step = (uint32_t)(((uint64_t)c->gen.freq_mhz << 32) / ((uint64_t)wave_stats.sample_rate * 1000U));
+    }
+}
+
+/*!
+    \brief      synthesize one buffer of an output
+    \param[in]  ch: output number, 0 or 1
+    \param[in]  data: first sample of the output in the buffer
+    \param[out] none
+    \retval     none
+*/
+static void wave_synth(uint32_t ch, uint16_t *data)
+{
+    wave_channel_struct *c = &wave_channel[ch];
+    int32_t amplitude = c->gen.amplitude;
+    int32_t offset = c->gen.offset;
+    uint32_t phase = c->phase, step = c->step;
+    uint32_t n = wave_cfg.frames, i;
+    int32_t w;
+
+    /* the type is decided once per buffer, the loops only see their own arithmetic */
+    switch(c->gen.type) {
+    case DAC_WAVE_GEN_SINE:
+    case DAC_WAVE_GEN_TABLE: {
+        const int16_t *table = c->table;
+        uint32_t shift = 32U - c->table_bits, mask = (1UL << c->table_bits) - 1U;
+        uint32_t idx, frac;
+        int32_t a;
+
+        for(i = 0U; i < n; i++) {
+            /* linear interpolation between two entries with the 15 phase bits below the index,
+               15 bits keep the product in range for any step between two entries */
+            idx = phase >> shift;
+            frac = (phase << c->table_bits) >> 17;
+            a = table[idx];
+            w = a + (((table[(idx + 1U) & mask] - a) * (int32_t)frac) >> 15);
+            phase += step;
+            data[i * wave_stride] = wave_clamp(offset + ((amplitude * w) >> 15));
+        }
+        break;
+    }
+    case DAC_WAVE_GEN_RAMP:
+        for(i = 0U; i < n; i++) {
+            w = (int32_t)(phase >> 16) - 32768;
+            phase += step;
+            data[i * wave_stride] = wave_clamp(offset + ((amplitude * w) >> 15));
+        }
+        break;
+    case DAC_WAVE_GEN_TRIANGLE:
+        for(i = 0U; i < n; i++) {
+            w = (int32_t)(phase >> 16);
+            w = (2 * ((w & 0x8000) ? (0xFFFF - w) : w)) - 32767;
+            phase += step;
+            data[i * wave_stride] = wave_clamp(offset + ((amplitude * w) >> 15));
+        }
+        break;
+    case DAC_WAVE_GEN_NOISE: {
+        uint32_t x = wave_noise;
+
+        for(i = 0U; i < n; i++) {
+            /* xorshift32, the upper half is a uniform 16-bit value */
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            w = (int16_t)(x >> 16);
+            data[i * wave_stride] = wave_clamp(offset + ((amplitude * w) >> 15));
+        }
+        wave_noise = x;
+        break;
+    }
+    case DAC_WAVE_GEN_DC:
+        for(i = 0U; i < n; i++) {
+            data[i * wave_stride] = wave_clamp(offset);
+        }
+        break;
+    default:
+        /* DAC_WAVE_GEN_NONE, the fill callback writes the samples */
+        break;
+    }
+
+    c->phase = phase;
+}
+
+/*!
+    \brief      limit a sample to the DAC range
+    \param[in]  v: sample
+    \param[out] none
+    \retval     DAC code
+*/
+static inline uint16_t wave_clamp(int32_t v)
+{
+    if(v < 0) {
+        return 0U;
+    }
+    return (v > (int32_t)DAC_WAVE_FULL_SCALE) ? (uint16_t)DAC_WAVE_FULL_SCALE : (uint16_t)v;
+}
+
+/*!
+    \brief      fill a buffer with the next frames of all outputs
+    \param[in]  data: the buffer
+    \param[out] none
+    \retval     none
+*/
+static void wave_fill(uint16_t *data)
+{
+    uint32_t ch, slot = 0U;
+
+    for(ch = 0U; ch < 2U; ch++) {
+        if(0U != (wave_cfg.outputs & (1U << ch))) {
+            if(0U != (wave_gen_pending & (1U << ch))) {
+                wave_gen_apply(ch);
+            }
+            wave_synth(ch, &data[slot++]);
+        }
+    }
+
+    if(NULL != wave_cfg.fill) {
+        wave_cfg.fill(data, wave_cfg.frames);
+    }
+}
+
+/*!
+    \brief      prepare both memories of the DMA and start the conversions
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void wave_restart(void)
+{
+    uint8_t dac_out = (DAC_WAVE_OUT1 == wave_cfg.outputs) ? DAC_OUT1 : DAC_OUT0;
+    uint32_t memory0, memory1;
+
+    if(DAC_WAVE_SOURCE_TABLE == wave_cfg.source) {
+        memory0 = (uint32_t)wave_table;
+        memory1 = (uint32_t)wave_table;
+    } else {
+        /* the output continues from where the generators are, both buffers are new */
+        wave_fill(wave_cfg.buffer);
+        wave_fill(&wave_cfg.buffer[wave_cfg.frames * wave_stride]);
+        memory0 = (uint32_t)wave_cfg.buffer;
+        memory1 = (uint32_t)&wave_cfg.buffer[wave_cfg.frames * wave_stride];
+    }
+
+    dac_dma_disable(DAC0, dac_out);
+    dac_flag_clear(DAC0, DAC_FLAG_DDUDR0 | DAC_FLAG_DDUDR1);
+
+    dma_flag_clear(WAVE_DMA, wave_dma_ch, WAVE_DMA_FLAGS);
+    dma_memory_address_config(WAVE_DMA, wave_dma_ch, DMA_MEMORY_0, memory0);
+    dma_switch_buffer_mode_config(WAVE_DMA, wave_dma_ch, memory1, DMA_MEMORY_0);
+    dma_transfer_number_config(WAVE_DMA, wave_dma_ch, wave_cfg.frames);
+    dma_channel_enable(WAVE_DMA, wave_dma_ch);
+
+    dac_dma_enable(DAC0, dac_out);
+
+    timer_counter_value_config(WAVE_TIMER, 0U);
+    timer_enable(WAVE_TIMER);
+}
@@ -35,6 +35,7 @@ OF SUCH DAMAGE.
 #include "gd32f4xx_it.h"
 #include "gd32f450i_eval.h"
 #include "systick.h"
+#include "dac_wave.h"
 
 /*!
     \brief      this function handles NMI exception
@@ -150,3 +151,36 @@ void SysTick_Handler(void)
 {
     delay_decrement();
 }
+
+/*!
+    \brief      this function handles DMA0 channel 5 interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void DMA0_Channel5_IRQHandler(void)
+{
+    dac_wave_dma_irq_handler();
+}
+
+/*!
+    \brief      this function handles DMA0 channel 6 interrupt request, used when only DAC0_OUT1 plays
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void DMA0_Channel6_IRQHandler(void)
+{
+    dac_wave_dma_irq_handler();
+}
+
+/*!
+    \brief      this function handles TIMER5 and DAC underrun interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void TIMER5_DAC_IRQHandler(void)
+{
+    dac_wave_dac_irq_handler();
+}
@@ -35,13 +35,34 @@ OF SUCH DAMAGE.
 #include "gd32f4xx.h"
 #include "gd32f450i_eval.h"
 #include "systick.h"
+#include "dac_wave.h"
+#include <stddef.h>
+
+/* 500k frames per second and 256 frames per buffer, one DMA interrupt every 512us */
+#define WAVE_SAMPLE_RATE        500000U
+#define WAVE_FRAMES             256U
+/* the sine on PA4 sweeps from 1kHz to 20kHz in 1kHz steps every 100ms */
+#define SWEEP_START_MHZ         1000000U
+#define SWEEP_STOP_MHZ          20000000U
+#define SWEEP_STEP_MHZ          1000000U
+/* the waveform on PA5 changes every 20 steps */
+#define SWEEP_STEPS_PER_WAVE    20U
+
+/* two buffers of frames, one sample of PA4 and one of PA5 each */
+__ALIGNED(16) static uint16_t wave_buffer[2U * 2U * WAVE_FRAMES];
+
+static const dac_wave_gen_struct out1_gen[3] = {
+    {DAC_WAVE_GEN_RAMP, 1000000U, 2000U, 2048U, NULL, 0U},
+    {DAC_WAVE_GEN_TRIANGLE, 1000000U, 2000U, 2048U, NULL, 0U},
+    {DAC_WAVE_GEN_NOISE, 0U, 1000U, 2048U, NULL, 0U}
+};
 
 /* configure RCU peripheral */
 void rcu_config(void);
 /* configure GPIO peripheral */
 void gpio_config(void);
-/* configure DAC peripheral */
-void dac_config(void);
+/* configure the DAC waveform generator */
+ErrStatus wave_config(void);
 /* led init function */
 void led_init(void);
 /* led flash function */
@@ -55,10 +76,12 @@ void led_flash(uint16_t times);
 */
 int main(void)
 {
-    /* configure the RCU, GPIO, DAC and Systick */
+    dac_wave_gen_struct sine = {DAC_WAVE_GEN_SINE, SWEEP_START_MHZ, 2000U, 2048U, NULL, 0U};
+    uint32_t step = 0U, wave = 0U;
+
+    /* configure the RCU, GPIO and Systick */
     rcu_config();
     gpio_config();
-    dac_config();
     systick_config();
 
     /* led init function */
@@ -66,7 +89,38 @@ int main(void)
     /* led flash function */
     led_flash(1);
 
-    while(1){
+    dac_wave_gen_set(DAC_WAVE_OUT0, &sine);
+    dac_wave_gen_set(DAC_WAVE_OUT1, &out1_gen[0]);
+    if((ERROR == wave_config()) || (ERROR == dac_wave_start())) {
+        gd_eval_led_on(LED1);
+        gd_eval_led_on(LED2);
+        gd_eval_led_on(LED3);
+        while(1) {
+        }
+    }
+    gd_eval_led_on(LED1);
+
+    while(1) {
+        delay_ms(100);
+
+        /* the new frequency starts at the next buffer with the phase the sine has reached */
+        sine.freq_mhz += SWEEP_STEP_MHZ;
+        if(sine.freq_mhz > SWEEP_STOP_MHZ) {
+            sine.freq_mhz = SWEEP_START_MHZ;
+        }
+        dac_wave_gen_set(DAC_WAVE_OUT0, &sine);
+
+        if(++step >= SWEEP_STEPS_PER_WAVE) {
+            step = 0U;
+            wave = (wave + 1U) % 3U;
+            dac_wave_gen_set(DAC_WAVE_OUT1, &out1_gen[wave]);
+
+            /* LED1 ramp, LED2 triangle, LED3 noise */
+            gd_eval_led_off(LED1);
+            gd_eval_led_off(LED2);
+            gd_eval_led_off(LED3);
+            gd_eval_led_on((0U == wave) ? LED1 : ((1U == wave) ? LED2 : LED3));
+        }
     }
 }
 
@@ -91,30 +145,30 @@ void rcu_config(void)
 */
 void gpio_config(void)
 {
-    /* configure PA4 as DAC output */
-    gpio_mode_set(GPIOA, GPIO_MODE_ANALOG, GPIO_PUPD_NONE, GPIO_PIN_4);
+    /* configure PA4 and PA5 as DAC outputs */
+    gpio_mode_set(GPIOA, GPIO_MODE_ANALOG, GPIO_PUPD_NONE, GPIO_PIN_4 | GPIO_PIN_5);
 }
 
 /*!
-    \brief      configure DAC peripheral
+    \brief      configure the DAC waveform generator
     \param[in]  none
     \param[out] none
-    \retval     none
+    \retval     ErrStatus: SUCCESS or ERROR
 */
-void dac_config(void)
+ErrStatus wave_config(void)
 {
-    /* initialize DAC */
-    dac_deinit(DAC0);
-    /* DAC trigger disable */
-    dac_trigger_disable(DAC0, DAC_OUT0);
-    /* DAC wave mode config */
-    dac_wave_mode_config(DAC0, DAC_OUT0, DAC_WAVE_DISABLE);
-
-    /* DAC output buffer enable */
-    dac_output_buffer_enable(DAC0, DAC_OUT0);
-    /* DAC enable */
-    dac_enable(DAC0, DAC_OUT0);
-    dac_data_set(DAC0, DAC_OUT0, DAC_ALIGN_12B_L, 0x7FF0);
+    dac_wave_config_struct config;
+
+    /* both outputs in the concurrent mode, the generators fill the buffer the DMA has played */
+    config.outputs = DAC_WAVE_DUAL;
+    config.source = DAC_WAVE_SOURCE_SYNTH;
+    config.sample_rate = WAVE_SAMPLE_RATE;
+    config.buffer = wave_buffer;
+    config.frames = WAVE_FRAMES;
+    config.output_buffer = 1U;
+    config.fill = NULL;
+
+    return dac_wave_init(&config);
 }
 
 /*!
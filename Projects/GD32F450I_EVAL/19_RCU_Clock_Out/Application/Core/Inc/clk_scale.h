@@ -0,0 +1,100 @@
+/*!
+    \file    clk_scale.h
+    \brief   the header file of the runtime clock frequency scaling service
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef CLK_SCALE_H
+#define CLK_SCALE_H
+
+#include "gd32f4xx.h"
+
+/* registration slots */
+#define CLK_SCALE_NOTIFIERS              8U
+#define CLK_SCALE_USARTS                 4U
+#define CLK_SCALE_TIMERS                 8U
+
+/* operating points, ordered by frequency, all run the PLL from the 25MHz HXTAL */
+typedef enum {
+    CLK_SCALE_48M = 0,                                   /*!< 48MHz, APB1 and APB2 undivided */
+    CLK_SCALE_120M,                                      /*!< 120MHz, APB1 60MHz, APB2 120MHz */
+    CLK_SCALE_168M,                                      /*!< 168MHz, APB1 42MHz, APB2 84MHz */
+    CLK_SCALE_200M,                                      /*!< 200MHz, APB1 50MHz, APB2 100MHz */
+    CLK_SCALE_240M,                                      /*!< 240MHz, APB1 60MHz, APB2 120MHz */
+    CLK_SCALE_POINT_NUM
+} clk_scale_point_enum;
+
+/* settings of an operating point, CK_AHB is always CK_SYS */
+typedef struct {
+    uint32_t sysclk;                                     /*!< CK_SYS in Hz */
+    uint16_t pll_n;                                      /*!< PLL multiplier of the 1MHz PLL input */
+    uint8_t pll_p;                                       /*!< CK_PLLP divider: 2, 4, 6 or 8 */
+    uint8_t pll_q;                                       /*!< CK_PLLQ divider, 48MHz for USB and SDIO where possible */
+    uint32_t apb1_psc;                                   /*!< RCU_APB1_CKAHB_DIVx */
+    uint32_t apb2_psc;                                   /*!< RCU_APB2_CKAHB_DIVx */
+    uint8_t high_drive;                                  /*!< high-drive mode, SystemInit() uses it for all PLL clocks from 120MHz */
+} clk_scale_point_struct;
+
+/* notifier events */
+typedef enum {
+    CLK_SCALE_PRE_CHANGE = 0,                            /*!< before the switch, ERROR refuses it */
+    CLK_SCALE_POST_CHANGE,                               /*!< after the switch, SystemCoreClock is the new clock */
+    CLK_SCALE_ABORT_CHANGE                               /*!< a later notifier refused the switch announced by CLK_SCALE_PRE_CHANGE */
+} clk_scale_event_enum;
+
+/* notifier, called in thread context with the interrupts enabled */
+typedef ErrStatus (*clk_scale_notify_fn)(clk_scale_event_enum event, uint32_t old_hz, uint32_t new_hz, void *arg);
+
+/* function declarations */
+/* take over the clock tree and switch to the floor operating point */
+ErrStatus clk_scale_init(clk_scale_point_enum floor);
+/* switch to an operating point, the notifiers may refuse */
+ErrStatus clk_scale_set(clk_scale_point_enum point);
+/* get the current operating point, CLK_SCALE_POINT_NUM before clk_scale_init() */
+clk_scale_point_enum clk_scale_get(void);
+/* get the settings of an operating point */
+const clk_scale_point_struct *clk_scale_point_get(clk_scale_point_enum point);
+/* request at least an operating point, the highest request wins over the floor */
+ErrStatus clk_scale_request(clk_scale_point_enum point);
+/* drop a request made with clk_scale_request() */
+ErrStatus clk_scale_release(clk_scale_point_enum point);
+/* change the operating point used without requests */
+ErrStatus clk_scale_floor_set(clk_scale_point_enum floor);
+/* register a notifier */
+ErrStatus clk_scale_notifier_register(clk_scale_notify_fn notify, void *arg);
+/* keep the baud rate of a USART across switches */
+ErrStatus clk_scale_usart_register(uint32_t usart_periph, uint32_t baudrate);
+/* keep the counter clock of a TIMER across switches */
+ErrStatus clk_scale_timer_register(uint32_t timer_periph, uint32_t counter_hz);
+/* get the clock of a TIMER before its prescaler */
+uint32_t clk_scale_timer_clock_get(uint32_t timer_periph);
+
+#endif /* CLK_SCALE_H */
@@ -0,0 +1,506 @@
+/*!
+    \file    clk_scale.c
+    \brief   runtime clock frequency scaling service
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "clk_scale.h"
+
+/* the PLL input is divided down to 1MHz */
+#define CLK_SCALE_PLL_PSC           (HXTAL_VALUE / 1000000U)
+/* one flash wait state per 30MHz of CK_AHB */
+#define CLK_SCALE_WS_HZ             30000000U
+
+/* registered USART */
+typedef struct {
+    uint32_t usart_periph;
+    uint32_t baudrate;
+} clk_scale_usart_struct;
+
+/* registered TIMER */
+typedef struct {
+    uint32_t timer_periph;
+    uint32_t counter_hz;
+} clk_scale_timer_struct;
+
+/* registered notifier */
+typedef struct {
+    clk_scale_notify_fn notify;
+    void *arg;
+} clk_scale_notifier_struct;
+
+static const clk_scale_point_struct scale_points[CLK_SCALE_POINT_NUM] = {
+    {48000000U,  192U, 4U, 4U,  RCU_APB1_CKAHB_DIV1, RCU_APB2_CKAHB_DIV1, 0U},
+    {120000000U, 240U, 2U, 5U,  RCU_APB1_CKAHB_DIV2, RCU_APB2_CKAHB_DIV1, 1U},
+    {168000000U, 336U, 2U, 7U,  RCU_APB1_CKAHB_DIV4, RCU_APB2_CKAHB_DIV2, 1U},
+    {200000000U, 400U, 2U, 9U,  RCU_APB1_CKAHB_DIV4, RCU_APB2_CKAHB_DIV2, 1U},
+    {240000000U, 480U, 2U, 10U, RCU_APB1_CKAHB_DIV4, RCU_APB2_CKAHB_DIV2, 1U}
+};
+
+static clk_scale_point_enum scale_current = CLK_SCALE_POINT_NUM;
+static clk_scale_point_enum scale_floor = CLK_SCALE_48M;
+static uint16_t scale_requests[CLK_SCALE_POINT_NUM];
+
+static clk_scale_notifier_struct scale_notifiers[CLK_SCALE_NOTIFIERS];
+static uint32_t scale_notifier_num = 0U;
+static clk_scale_usart_struct scale_usarts[CLK_SCALE_USARTS];
+static uint32_t scale_usart_num = 0U;
+static clk_scale_timer_struct scale_timers[CLK_SCALE_TIMERS];
+static uint32_t scale_timer_num = 0U;
+
+static ErrStatus clk_scale_update(void);
+static void clk_scale_switch(const clk_scale_point_struct *point);
+static void clk_scale_systick_fixup(uint32_t old_hz, uint32_t new_hz);
+static void clk_scale_timer_fixup(const clk_scale_timer_struct *timer);
+
+/*!
+    \brief      take over the clock tree and switch to the floor operating point
+    \param[in]  floor: operating point used without requests
+      \arg        CLK_SCALE_48M, CLK_SCALE_120M, CLK_SCALE_168M, CLK_SCALE_200M, CLK_SCALE_240M
+    \param[out] none
+    \retval     ErrStatus: ERROR if HXTAL does not start or a notifier refused the switch
+*/
+ErrStatus clk_scale_init(clk_scale_point_enum floor)
+{
+    uint32_t i;
+
+    if(floor >= CLK_SCALE_POINT_NUM) {
+        return ERROR;
+    }
+
+    /* the PMU controls the high-drive mode */
+    rcu_periph_clock_enable(RCU_PMU);
+
+    rcu_osci_on(RCU_HXTAL);
+    if(ERROR == rcu_osci_stab_wait(RCU_HXTAL)) {
+        return ERROR;
+    }
+
+    /* adopt the operating point SystemInit() configured, if it is one of the table */
+    SystemCoreClockUpdate();
+    scale_current = CLK_SCALE_POINT_NUM;
+    for(i = 0U; i < (uint32_t)CLK_SCALE_POINT_NUM; i++) {
+        if((RCU_SCSS_PLLP == (RCU_CFG0 & RCU_CFG0_SCSS)) && (scale_points[i].sysclk == SystemCoreClock) &&
+                (scale_points[i].pll_q == GET_BITS(RCU_PLL, 24U, 27U))) {
+            scale_current = (clk_scale_point_enum)i;
+        }
+    }
+
+    scale_floor = floor;
+
+    return clk_scale_update();
+}
+
+/*!
+    \brief      switch to an operating point: the flash wait states, the PLL, the bus prescalers
+                and the high-drive mode change, then SystemCoreClock, the SysTick and the registered
+                USARTs and TIMERs follow, all with the interrupts disabled. the notifiers are called
+                before and after, from the caller's context
+    \param[in]  point: operating point
+      \arg        CLK_SCALE_48M, CLK_SCALE_120M, CLK_SCALE_168M, CLK_SCALE_200M, CLK_SCALE_240M
+    \param[out] none
+    \retval     ErrStatus: ERROR if a notifier refused the switch
+*/
+ErrStatus clk_scale_set(clk_scale_point_enum point)
+{
+    uint32_t old_hz = SystemCoreClock;
+    uint32_t new_hz, i, n;
+    uint32_t primask;
+
+    if(point >= CLK_SCALE_POINT_NUM) {
+        return ERROR;
+    }
+    if(point == scale_current) {
+        return SUCCESS;
+    }
+    new_hz = scale_points[point].sysclk;
+
+    for(n = 0U; n < scale_notifier_num; n++) {
+        if(ERROR == scale_notifiers[n].notify(CLK_SCALE_PRE_CHANGE, old_hz, new_hz, scale_notifiers[n].arg)) {
+            /* take the switch back from the notifiers that agreed */
+            for(i = 0U; i < n; i++) {
+                scale_notifiers[i].notify(CLK_SCALE_ABORT_CHANGE, old_hz, new_hz, scale_notifiers[i].arg);
+            }
+            return ERROR;
+        }
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* a character in flight would be sent with the wrong bit time */
+    for(i = 0U; i < scale_usart_num; i++) {
+        if(0U != (USART_CTL0(scale_usarts[i].usart_periph) & USART_CTL0_TEN)) {
+            while(RESET == usart_flag_get(scale_usarts[i].usart_periph, USART_FLAG_TC)) {
+            }
+        }
+    }
+
+    clk_scale_switch(&scale_points[point]);
+    SystemCoreClockUpdate();
+
+    clk_scale_systick_fixup(old_hz, SystemCoreClock);
+    for(i = 0U; i < scale_usart_num; i++) {
+        usart_baudrate_set(scale_usarts[i].usart_periph, scale_usarts[i].baudrate);
+    }
+    for(i = 0U; i < scale_timer_num; i++) {
+        clk_scale_timer_fixup(&scale_timers[i]);
+    }
+    scale_current = point;
+
+    __set_PRIMASK(primask);
+
+    for(n = 0U; n < scale_notifier_num; n++) {
+        scale_notifiers[n].notify(CLK_SCALE_POST_CHANGE, old_hz, SystemCoreClock, scale_notifiers[n].arg);
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      get the current operating point
+    \param[in]  none
+    \param[out] none
+    \retval     the operating point, CLK_SCALE_POINT_NUM before clk_scale_init() or if the
+                clock tree is not at one of the operating points
+*/
+clk_scale_point_enum clk_scale_get(void)
+{
+    return scale_current;
+}
+
+/*!
+    \brief      get the settings of an operating point
+    \param[in]  point: operating point
+    \param[out] none
+    \retval     the settings, NULL for an invalid point
+*/
+const clk_scale_point_struct *clk_scale_point_get(clk_scale_point_enum point)
+{
+    if(point >= CLK_SCALE_POINT_NUM) {
+        return NULL;
+    }
+
+    return &scale_points[point];
+}
+
+/*!
+    \brief      request at least an operating point, the highest request wins over the floor,
+                a workload requests the point it needs while it runs and releases it afterwards
+    \param[in]  point: operating point
+    \param[out] none
+    \retval     ErrStatus: ERROR if a notifier refused the switch, the request is kept
+*/
+ErrStatus clk_scale_request(clk_scale_point_enum point)
+{
+    if(point >= CLK_SCALE_POINT_NUM) {
+        return ERROR;
+    }
+
+    scale_requests[point]++;
+
+    return clk_scale_update();
+}
+
+/*!
+    \brief      drop a request made with clk_scale_request()
+    \param[in]  point: operating point of the request
+    \param[out] none
+    \retval     ErrStatus: ERROR if a notifier refused the switch
+*/
+ErrStatus clk_scale_release(clk_scale_point_enum point)
+{
+    if((point >= CLK_SCALE_POINT_NUM) || (0U == scale_requests[point])) {
+        return ERROR;
+    }
+
+    scale_requests[point]--;
+
+    return clk_scale_update();
+}
+
+/*!
+    \brief      change the operating point used without requests
+    \param[in]  floor: operating point
+    \param[out] none
+    \retval     ErrStatus: ERROR if a notifier refused the switch
+*/
+ErrStatus clk_scale_floor_set(clk_scale_point_enum floor)
+{
+    if(floor >= CLK_SCALE_POINT_NUM) {
+        return ERROR;
+    }
+
+    scale_floor = floor;
+
+    return clk_scale_update();
+}
+
+/*!
+    \brief      register a notifier, it is called before and after every switch
+    \param[in]  notify: notifier
+    \param[in]  arg: user supplied argument passed to notify
+    \param[out] none
+    \retval     ErrStatus: ERROR if all slots are used
+*/
+ErrStatus clk_scale_notifier_register(clk_scale_notify_fn notify, void *arg)
+{
+    if((NULL == notify) || (scale_notifier_num >= CLK_SCALE_NOTIFIERS)) {
+        return ERROR;
+    }
+
+    scale_notifiers[scale_notifier_num].notify = notify;
+    scale_notifiers[scale_notifier_num].arg = arg;
+    scale_notifier_num++;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      keep the baud rate of a USART across switches, the transmitter is drained
+                before a switch, a character being received is lost
+    \param[in]  usart_periph: USARTx(x=0,1,2,5)/UARTx(x=3,4,6,7)
+    \param[in]  baudrate: baud rate
+    \param[out] none
+    \retval     ErrStatus: ERROR if all slots are used
+*/
+ErrStatus clk_scale_usart_register(uint32_t usart_periph, uint32_t baudrate)
+{
+    if(scale_usart_num >= CLK_SCALE_USARTS) {
+        return ERROR;
+    }
+
+    scale_usarts[scale_usart_num].usart_periph = usart_periph;
+    scale_usarts[scale_usart_num].baudrate = baudrate;
+    scale_usart_num++;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      keep the counter clock of a TIMER across switches, the prescaler is reloaded
+                at once and the counter keeps its value
+    \param[in]  timer_periph: TIMERx(x=0..13)
+    \param[in]  counter_hz: counter clock, should divide the TIMER clock of all operating points
+    \param[out] none
+    \retval     ErrStatus: ERROR if all slots are used
+*/
+ErrStatus clk_scale_timer_register(uint32_t timer_periph, uint32_t counter_hz)
+{
+    if((0U == counter_hz) || (scale_timer_num >= CLK_SCALE_TIMERS)) {
+        return ERROR;
+    }
+
+    scale_timers[scale_timer_num].timer_periph = timer_periph;
+    scale_timers[scale_timer_num].counter_hz = counter_hz;
+    scale_timer_num++;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      get the clock of a TIMER before its prescaler
+    \param[in]  timer_periph: TIMERx(x=0..13)
+    \param[out] none
+    \retval     the TIMER clock in Hz
+*/
+uint32_t clk_scale_timer_clock_get(uint32_t timer_periph)
+{
+    uint32_t ahb = rcu_clock_freq_get(CK_AHB);
+    uint32_t apb;
+
+    /* TIMER0, TIMER7, TIMER8, TIMER9 and TIMER10 are on APB2 */
+    if((TIMER0 == timer_periph) || (TIMER7 == timer_periph) || (TIMER8 == timer_periph) ||
+            (TIMER9 == timer_periph) || (TIMER10 == timer_periph)) {
+        apb = rcu_clock_freq_get(CK_APB2);
+    } else {
+        apb = rcu_clock_freq_get(CK_APB1);
+    }
+
+    /* APB not divided: the TIMERs run from CK_AHB */
+    if(apb == ahb) {
+        return ahb;
+    }
+    /* otherwise twice (TIMERSEL = 0) or four times (TIMERSEL = 1, at most CK_AHB) CK_APBx */
+    if(0U != (RCU_CFG1 & RCU_CFG1_TIMERSEL)) {
+        return ((apb * 4U) > ahb) ? ahb : (apb * 4U);
+    }
+    return apb * 2U;
+}
+
+/*!
+    \brief      switch to the highest requested operating point, or the floor
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: ERROR if a notifier refused the switch
+*/
+static ErrStatus clk_scale_update(void)
+{
+    clk_scale_point_enum target = scale_floor;
+    uint32_t i;
+
+    for(i = (uint32_t)target + 1U; i < (uint32_t)CLK_SCALE_POINT_NUM; i++) {
+        if(0U != scale_requests[i]) {
+            target = (clk_scale_point_enum)i;
+        }
+    }
+
+    return clk_scale_set(target);
+}
+
+/*!
+    \brief      reprogram the clock tree, the system runs from HXTAL while the PLL relocks
+    \param[in]  point: operating point
+    \param[out] none
+    \retval     none
+*/
+static void clk_scale_switch(const clk_scale_point_struct *point)
+{
+    uint32_t ws_old = FMC_WS & FMC_WC_WSCNT;
+    uint32_t ws_new = WC_WSCNT((point->sysclk - 1U) / CLK_SCALE_WS_HZ);
+    uint32_t reg;
+
+    /* more wait states before the clock goes up */
+    if(ws_new > ws_old) {
+        fmc_wscnt_set(ws_new);
+    }
+
+    /* run from HXTAL */
+    reg = RCU_CFG0;
+    reg &= ~RCU_CFG0_SCS;
+    reg |= RCU_CKSYSSRC_HXTAL;
+    RCU_CFG0 = reg;
+    while(RCU_SCSS_HXTAL != (RCU_CFG0 & RCU_CFG0_SCSS)) {
+    }
+
+    /* leave the high-drive mode, it is entered again with the PLL locked */
+    PMU_CTL &= ~PMU_CTL_HDS;
+    PMU_CTL &= ~PMU_CTL_HDEN;
+
+    RCU_CTL &= ~RCU_CTL_PLLEN;
+    while(0U != (RCU_CTL & RCU_CTL_PLLSTB)) {
+    }
+
+    RCU_PLL = (CLK_SCALE_PLL_PSC | ((uint32_t)point->pll_n << 6U) | ((((uint32_t)point->pll_p >> 1U) - 1U) << 16U) |
+               (RCU_PLLSRC_HXTAL) | ((uint32_t)point->pll_q << 24U));
+
+    /* CK_AHB = CK_SYS */
+    reg = RCU_CFG0;
+    reg &= ~(RCU_CFG0_AHBPSC | RCU_CFG0_APB1PSC | RCU_CFG0_APB2PSC);
+    reg |= (RCU_AHB_CKSYS_DIV1 | point->apb1_psc | point->apb2_psc);
+    RCU_CFG0 = reg;
+
+    RCU_CTL |= RCU_CTL_PLLEN;
+    while(0U == (RCU_CTL & RCU_CTL_PLLSTB)) {
+    }
+
+    if(0U != point->high_drive) {
+        PMU_CTL |= PMU_CTL_HDEN;
+        while(0U == (PMU_CS & PMU_CS_HDRF)) {
+        }
+        PMU_CTL |= PMU_CTL_HDS;
+        while(0U == (PMU_CS & PMU_CS_HDSRF)) {
+        }
+    }
+
+    reg = RCU_CFG0;
+    reg &= ~RCU_CFG0_SCS;
+    reg |= RCU_CKSYSSRC_PLLP;
+    RCU_CFG0 = reg;
+    while(RCU_SCSS_PLLP != (RCU_CFG0 & RCU_CFG0_SCSS)) {
+    }
+
+    /* fewer wait states after the clock went down */
+    if(ws_new < ws_old) {
+        fmc_wscnt_set(ws_new);
+    }
+}
+
+/*!
+    \brief      scale the SysTick period with the core clock, the current period is
+                finished at the new rate so no tick is lost or added
+    \param[in]  old_hz: core clock before the switch
+    \param[in]  new_hz: core clock after the switch
+    \param[out] none
+    \retval     none
+*/
+static void clk_scale_systick_fixup(uint32_t old_hz, uint32_t new_hz)
+{
+    uint32_t load, rest;
+
+    if(0U == (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)) {
+        return;
+    }
+
+    load = (uint32_t)((((uint64_t)SysTick->LOAD + 1U) * new_hz) / old_hz);
+    rest = (uint32_t)(((uint64_t)SysTick->VAL * new_hz) / old_hz);
+    if(rest < 2U) {
+        rest = 2U;
+    }
+
+    /* clearing VAL reloads the counter from LOAD at the next SysTick clock, which
+       is CK_AHB / 8 at the slowest */
+    SysTick->LOAD = rest - 1U;
+    SysTick->VAL = 0U;
+    while(0U == SysTick->VAL) {
+    }
+    SysTick->LOAD = load - 1U;
+}
+
+/*!
+    \brief      reprogram the prescaler of a TIMER for its counter clock
+    \param[in]  timer: registered TIMER
+    \param[out] none
+    \retval     none
+*/
+static void clk_scale_timer_fixup(const clk_scale_timer_struct *timer)
+{
+    uint32_t timer_periph = timer->timer_periph;
+    uint32_t psc = (clk_scale_timer_clock_get(timer_periph) + (timer->counter_hz / 2U)) / timer->counter_hz;
+    uint32_t ctl0, cnt;
+
+    if(0U != psc) {
+        psc--;
+    }
+    if(psc > 0xFFFFU) {
+        psc = 0xFFFFU;
+    }
+
+    /* the prescaler only follows at an update event: generate one without an interrupt
+       or DMA request (UPS) and restore the counter it clears */
+    ctl0 = TIMER_CTL0(timer_periph);
+    TIMER_CTL0(timer_periph) = ctl0 | TIMER_CTL0_UPS;
+    cnt = TIMER_CNT(timer_periph);
+    TIMER_PSC(timer_periph) = psc;
+    TIMER_SWEVG(timer_periph) = TIMER_SWEVG_UPG;
+    TIMER_CNT(timer_periph) = cnt;
+    TIMER_CTL0(timer_periph) = ctl0;
+}
@@ -35,8 +35,14 @@ OF SUCH DAMAGE.
 
 #include "gd32f4xx.h"
 #include "gd32f450i_eval.h"
+#include "clk_scale.h"
 #include <stdio.h>
 
+/* TIMER1 counts microseconds at every operating point */
+#define TIME_TIMER              TIMER1
+#define TIME_TIMER_HZ           1000000U
+#define WORKLOAD_ROUNDS         4000000U
+
 typedef enum
 {
     CKOUT0_IRC16M_CKOUT1_SYSTEMCLOCK,
@@ -49,6 +55,11 @@ void all_led_init(void);
 void all_led_off(void);
 void clock_output_select(uint8_t seq);
 void clock_output_config(void);
+void clock_scale_config(void);
+static ErrStatus clock_scale_notify(clk_scale_event_enum event, uint32_t old_hz, uint32_t new_hz, void *arg);
+static void clock_bus_print(void);
+static uint32_t workload_run(void);
+static void delay_us(uint32_t us);
 
 extern uint8_t g_button_press_flag;
 
@@ -61,6 +72,8 @@ extern uint8_t g_button_press_flag;
 int main(void)
 {
     uint8_t func_seq = 0;
+    uint8_t floor = (uint8_t)CLK_SCALE_48M;
+    uint32_t floor_us, boost_us;
     
     /* initialize the USART */
     gd_eval_com_init(EVAL_COM0);
@@ -74,6 +87,11 @@ int main(void)
     clock_output_config();
     /* initialize the tamper key */
     gd_eval_key_init(KEY_TAMPER, KEY_MODE_EXTI);
+    /* the user key changes the operating point, the wakeup key runs the workload */
+    gd_eval_key_init(KEY_USER, KEY_MODE_GPIO);
+    gd_eval_key_init(KEY_WAKEUP, KEY_MODE_GPIO);
+    /* initialize the clock scaling, CK_SYS starts at 48MHz */
+    clock_scale_config();
    
     while (1){
          /* if the button is pressed */
@@ -89,6 +107,31 @@ int main(void)
 
             g_button_press_flag = 0;
         }
+
+        if(RESET == gd_eval_key_state_get(KEY_USER)) {
+            delay_us(20000U);
+            if(RESET == gd_eval_key_state_get(KEY_USER)) {
+                floor = (uint8_t)((floor + 1U) % (uint8_t)CLK_SCALE_POINT_NUM);
+                clk_scale_floor_set((clk_scale_point_enum)floor);
+                while(RESET == gd_eval_key_state_get(KEY_USER)) {
+                }
+            }
+        }
+
+        if(SET == gd_eval_key_state_get(KEY_WAKEUP)) {
+            delay_us(20000U);
+            if(SET == gd_eval_key_state_get(KEY_WAKEUP)) {
+                /* the same workload at the current operating point and boosted to 240MHz */
+                floor_us = workload_run();
+                clk_scale_request(CLK_SCALE_240M);
+                boost_us = workload_run();
+                clk_scale_release(CLK_SCALE_240M);
+                printf("workload: %luus at the current operating point, %luus at 240MHz \r\n",
+                       (unsigned long)floor_us, (unsigned long)boost_us);
+                while(SET == gd_eval_key_state_get(KEY_WAKEUP)) {
+                }
+            }
+        }
     }
 }
 
@@ -152,6 +195,105 @@ void clock_output_config(void)
     gpio_af_set(GPIOC, GPIO_AF_0, GPIO_PIN_9);
 }
 
+/*!
+    \brief      configure the clock scaling, the USART and the time base TIMER
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void clock_scale_config(void)
+{
+    timer_parameter_struct timer_initpara;
+
+    /* TIMER1 is a 32-bit timer, let it run through the full range */
+    rcu_periph_clock_enable(RCU_TIMER1);
+    timer_deinit(TIME_TIMER);
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler         = (uint16_t)((clk_scale_timer_clock_get(TIME_TIMER) / TIME_TIMER_HZ) - 1U);
+    timer_initpara.alignedmode       = TIMER_COUNTER_EDGE;
+    timer_initpara.counterdirection  = TIMER_COUNTER_UP;
+    timer_initpara.period            = 0xFFFFFFFFU;
+    timer_initpara.clockdivision     = TIMER_CKDIV_DIV1;
+    timer_init(TIME_TIMER, &timer_initpara);
+    timer_enable(TIME_TIMER);
+
+    clk_scale_usart_register(EVAL_COM0, 115200U);
+    clk_scale_timer_register(TIME_TIMER, TIME_TIMER_HZ);
+    clk_scale_notifier_register(clock_scale_notify, NULL);
+
+    if(ERROR == clk_scale_init(CLK_SCALE_48M)) {
+        printf("clock scaling initialization failed! \r\n");
+        while(1) {
+        }
+    }
+}
+
+/*!
+    \brief      clock scaling notifier, reports every switch
+    \param[in]  event: CLK_SCALE_PRE_CHANGE, CLK_SCALE_POST_CHANGE or CLK_SCALE_ABORT_CHANGE
+    \param[in]  old_hz: CK_SYS before the switch
+    \param[in]  new_hz: CK_SYS after the switch
+    \param[in]  arg: not used
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, the switch is never refused
+*/
+static ErrStatus clock_scale_notify(clk_scale_event_enum event, uint32_t old_hz, uint32_t new_hz, void *arg)
+{
+    if(CLK_SCALE_POST_CHANGE == event) {
+        printf("CK_SYS: %luMHz -> %luMHz \r\n", (unsigned long)(old_hz / 1000000U), (unsigned long)(new_hz / 1000000U));
+        clock_bus_print();
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      print the bus clocks
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void clock_bus_print(void)
+{
+    printf("CK_AHB: %luMHz, CK_APB1: %luMHz, CK_APB2: %luMHz, TIMER1: %luMHz, flash wait states: %lu \r\n",
+           (unsigned long)(rcu_clock_freq_get(CK_AHB) / 1000000U), (unsigned long)(rcu_clock_freq_get(CK_APB1) / 1000000U),
+           (unsigned long)(rcu_clock_freq_get(CK_APB2) / 1000000U),
+           (unsigned long)(clk_scale_timer_clock_get(TIME_TIMER) / 1000000U), (unsigned long)(FMC_WS & FMC_WC_WSCNT));
+}
+
+/*!
+    \brief      run a CPU bound workload
+    \param[in]  none
+    \param[out] none
+    \retval     the run time in microseconds
+*/
+static uint32_t workload_run(void)
+{
+    volatile uint32_t seed = 1U;
+    uint32_t start = timer_counter_read(TIME_TIMER);
+    uint32_t i;
+
+    for(i = 0U; i < WORKLOAD_ROUNDS; i++) {
+        seed = seed * 1664525U + 1013904223U;
+    }
+
+    return timer_counter_read(TIME_TIMER) - start;
+}
+
+/*!
+    \brief      wait for a number of microseconds
+    \param[in]  us: microseconds
+    \param[out] none
+    \retval     none
+*/
+static void delay_us(uint32_t us)
+{
+    uint32_t start = timer_counter_read(TIME_TIMER);
+
+    while((timer_counter_read(TIME_TIMER) - start) < us) {
+    }
+}
+
 /*!
     \brief      select type of clock output
     \param[in]  seq: sequence of clock output
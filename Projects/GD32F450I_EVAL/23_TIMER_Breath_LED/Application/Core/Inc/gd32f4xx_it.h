@@ -57,5 +57,7 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 /* this function handles SysTick exception */
 void SysTick_Handler(void);
+/* this function handles DMA0 channel 1 interrupt request */
+void DMA0_Channel1_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
@@ -0,0 +1,80 @@
+/*!
+    \file    pwm_seq.h
+    \brief   definitions for the DMA driven PWM sequencer
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef PWM_SEQ_H
+#define PWM_SEQ_H
+
+#include "gd32f4xx.h"
+
+/* preemption priority of the DMA interrupt */
+#define PWM_SEQ_IRQ_PRIO                2U
+/* loops value of pwm_seq_play() for a sequence that repeats until pwm_seq_stop() */
+#define PWM_SEQ_LOOP_FOREVER            0U
+
+/* table entries pwm_seq_bits_encode() writes for a number of bytes and idle periods */
+#define PWM_SEQ_BITS_TABLE_SIZE(bytes, idle)    ((8U * (bytes)) + (idle))
+
+/* timer and DMA of a sequencer; the DMA channel and sub-peripheral are the ones of the
+   update request of the timer, e.g. DMA0 channel 1 sub-peripheral 3 for TIMER1_UP */
+typedef struct {
+    uint32_t timer;                             /*!< TIMERx(x=0..4,7) */
+    uint16_t prescaler;                         /*!< counter clock prescaler - 1 */
+    uint16_t period;                            /*!< counter period - 1, compare values range from 0 to period + 1 */
+    uint16_t repetition;                        /*!< TIMER0 and TIMER7 only: a step lasts repetition + 1 periods */
+    uint16_t first_channel;                     /*!< TIMER_CH_x of the first channel */
+    uint8_t channel_num;                        /*!< consecutive channels updated together, 1 to 4 */
+    uint8_t active_low;                         /*!< 1 inverts the outputs */
+    uint32_t dma_periph;                        /*!< DMAx */
+    dma_channel_enum dma_channel;               /*!< DMA_CHx */
+    dma_subperipheral_enum dma_subperi;         /*!< DMA_SUBPERIx */
+    uint8_t dma_irq;                            /*!< IRQ number of the DMA channel */
+    void (*done)(void);                         /*!< called from the DMA interrupt when a sequence ends, or NULL */
+} pwm_seq_config_struct;
+
+/* function declarations */
+/* configure the timer channels in PWM mode and the DMA channel */
+ErrStatus pwm_seq_init(const pwm_seq_config_struct *config);
+/* play a table of compare values, one step per update event */
+ErrStatus pwm_seq_play(const uint16_t *table, uint32_t steps, uint32_t loops);
+/* stop the sequence, the outputs keep the compare values of the last step */
+void pwm_seq_stop(void);
+/* check whether a sequence is playing */
+FlagStatus pwm_seq_busy(void);
+/* encode bytes as one PWM period per bit for single-wire LED protocols */
+uint32_t pwm_seq_bits_encode(const uint8_t *data, uint32_t bytes, uint16_t zero, uint16_t one,
+                             uint32_t idle, uint16_t *table);
+/* handle the DMA interrupt of the sequencer */
+void pwm_seq_dma_irq_handler(void);
+
+#endif /* PWM_SEQ_H */
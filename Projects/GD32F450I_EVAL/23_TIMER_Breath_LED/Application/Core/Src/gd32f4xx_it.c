@@ -36,6 +36,7 @@ OF SUCH DAMAGE.
 #include "gd32f4xx_it.h"
 #include "gd32f450i_eval.h"
 #include "systick.h"
+#include "pwm_seq.h"
 
 /*!
     \brief      this function handles NMI exception
@@ -152,3 +153,13 @@ void SysTick_Handler(void)
     delay_decrement();
 }
 
+/*!
+    \brief      this function handles DMA0 channel 1 interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void DMA0_Channel1_IRQHandler(void)
+{
+    pwm_seq_dma_irq_handler();
+}
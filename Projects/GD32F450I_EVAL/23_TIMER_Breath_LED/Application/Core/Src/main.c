@@ -37,9 +37,20 @@ OF SUCH DAMAGE.
 #include "gd32f450i_eval.h"
 #include <stdio.h>
 #include "systick.h"
+#include "pwm_seq.h"
+
+/* TIMER1 counts at 200MHz / 120 = 1.667MHz, a PWM period of 3333 counts is 500Hz */
+#define PWM_PRESCALER       119U
+#define PWM_PERIOD          3333U
+/* one breath is 500 steps up and 500 steps down, 2 seconds at one step per period */
+#define BREATH_STEPS        1000U
+
+/* CH2 and CH3 compare values of each step */
+static uint16_t breath_table[BREATH_STEPS][2];
 
 void gpio_config(void);
-void timer_config(void);
+ErrStatus timer_config(void);
+void breath_table_init(void);
 
 /**
     \brief      configure the GPIO ports
@@ -51,59 +62,61 @@ void gpio_config(void)
 {
     rcu_periph_clock_enable(RCU_GPIOB);
     
-    /*Configure PB10(TIMER1_CH2) as alternate function*/
-    gpio_mode_set(GPIOB, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_10);
-    gpio_output_options_set(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ,GPIO_PIN_10);
+    /*Configure PB10(TIMER1_CH2) and PB11(TIMER1_CH3) as alternate function*/
+    gpio_mode_set(GPIOB, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_10 | GPIO_PIN_11);
+    gpio_output_options_set(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_10 | GPIO_PIN_11);
 
-    gpio_af_set(GPIOB, GPIO_AF_1, GPIO_PIN_10);
+    gpio_af_set(GPIOB, GPIO_AF_1, GPIO_PIN_10 | GPIO_PIN_11);
 }
 
 /**
-    \brief      configure the TIMER peripheral
+    \brief      configure the TIMER peripheral and the PWM sequencer
     \param[in]  none
     \param[out] none
-    \retval     none
+    \retval     ErrStatus: SUCCESS or ERROR
   */
-void timer_config(void)
+ErrStatus timer_config(void)
 {
-    /* TIMER1 configuration: generate PWM signals with different duty cycles:
-       TIMER1CLK = SystemCoreClock / 120  */
-    timer_oc_parameter_struct timer_ocintpara;
-    timer_parameter_struct timer_initpara;
+    /* TIMER1 generates PWM signals on CH2 and CH3, the update DMA request of TIMER1
+       is served by DMA0 channel 1, sub-peripheral 3 */
+    pwm_seq_config_struct seq_config;
 
     rcu_periph_clock_enable(RCU_TIMER1);
+    rcu_periph_clock_enable(RCU_DMA0);
     rcu_timer_clock_prescaler_config(RCU_TIMER_PSC_MUL4);
 
-    timer_deinit(TIMER1);
-
-    /* TIMER1 configuration */
-    timer_initpara.prescaler         = 119;
-    timer_initpara.alignedmode       = TIMER_COUNTER_EDGE;
-    timer_initpara.counterdirection  = TIMER_COUNTER_UP;
-    timer_initpara.period            = 500;
-    timer_initpara.clockdivision     = TIMER_CKDIV_DIV1;
-    timer_initpara.repetitioncounter = 0;
-    timer_init(TIMER1,&timer_initpara);
-
-    /* CH2 configuration in PWM mode 0 */
-    timer_ocintpara.ocpolarity  = TIMER_OC_POLARITY_HIGH;
-    timer_ocintpara.outputstate = TIMER_CCX_ENABLE;
-    timer_ocintpara.ocnpolarity  = TIMER_OCN_POLARITY_HIGH;
-    timer_ocintpara.outputnstate = TIMER_CCXN_DISABLE;
-    timer_ocintpara.ocidlestate  = TIMER_OC_IDLE_STATE_LOW;
-    timer_ocintpara.ocnidlestate = TIMER_OCN_IDLE_STATE_LOW;
-
-    timer_channel_output_config(TIMER1,TIMER_CH_2,&timer_ocintpara);
-
-    /* CH2 configuration in PWM mode 0,duty cycle 25% */
-    timer_channel_output_pulse_value_config(TIMER1,TIMER_CH_2,0);
-    timer_channel_output_mode_config(TIMER1,TIMER_CH_2,TIMER_OC_MODE_PWM0);
-    timer_channel_output_shadow_config(TIMER1,TIMER_CH_2,TIMER_OC_SHADOW_DISABLE);
-
-    /* auto-reload preload enable */
-    timer_auto_reload_shadow_enable(TIMER1);
-    /* TIMER1 enable */
-    timer_enable(TIMER1);
+    seq_config.timer = TIMER1;
+    seq_config.prescaler = PWM_PRESCALER;
+    seq_config.period = PWM_PERIOD - 1U;
+    seq_config.repetition = 0U;
+    seq_config.first_channel = TIMER_CH_2;
+    seq_config.channel_num = 2U;
+    seq_config.active_low = 0U;
+    seq_config.dma_periph = DMA0;
+    seq_config.dma_channel = DMA_CH1;
+    seq_config.dma_subperi = DMA_SUBPERI3;
+    seq_config.dma_irq = (uint8_t)DMA0_Channel1_IRQn;
+    seq_config.done = NULL;
+
+    return pwm_seq_init(&seq_config);
+}
+
+/**
+    \brief      compute one breath: the duty cycle follows the square of a triangle, which
+                looks linear to the eye; CH3 breathes in opposite phase to CH2
+    \param[in]  none
+    \param[out] none
+    \retval     none
+  */
+void breath_table_init(void)
+{
+    uint32_t i, x, half = BREATH_STEPS / 2U;
+
+    for(i = 0U; i < BREATH_STEPS; i++) {
+        x = (i < half) ? i : (BREATH_STEPS - 1U - i);
+        breath_table[i][0] = (uint16_t)((PWM_PERIOD * x * x) / ((half - 1U) * (half - 1U)));
+        breath_table[i][1] = (uint16_t)(PWM_PERIOD - breath_table[i][0]);
+    }
 }
 
 /*!
@@ -114,33 +127,22 @@ void timer_config(void)
 */
 int main(void)
 {
-    uint16_t i = 0;
-    FlagStatus breathe_flag = SET;
-
     /* configure the GPIO ports */
     gpio_config();
 
-    /* configure the TIMER peripheral */
-    timer_config();
-
     /* configure systick */
     systick_config();
 
-    while (1){
-        /* delay a time in milliseconds */
-        delay_ms(5);
-        if (SET == breathe_flag){
-            i++;
-        }else{
-            i--;
-        }
-        if(500 < i){
-            breathe_flag = RESET;
-        }
-        if(0 >= i){
-            breathe_flag = SET;
+    /* configure the TIMER peripheral */
+    if(ERROR == timer_config()) {
+        while(1) {
         }
-        /* configure TIMER channel output pulse value */
-        timer_channel_output_pulse_value_config(TIMER1,TIMER_CH_2,i);
+    }
+
+    /* the DMA writes a new step at every update event, the CPU is not involved any more */
+    breath_table_init();
+    pwm_seq_play(&breath_table[0][0], BREATH_STEPS, PWM_SEQ_LOOP_FOREVER);
+
+    while (1){
     }
 }
@@ -0,0 +1,260 @@
+/*!
+    \file    pwm_seq.c
+    \brief   DMA driven PWM sequencer: the update event of a timer requests a DMA burst
+             through TIMER_DMATB that writes the compare values of the next step
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "pwm_seq.h"
+#include <stddef.h>
+
+#define SEQ_DMA_FLAGS               (DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF)
+#define SEQ_DMA_NUMBER_MAX          0xFFFFU
+
+static pwm_seq_config_struct seq_cfg;
+/* loops still to play, 0 for PWM_SEQ_LOOP_FOREVER */
+static volatile uint32_t seq_loops = 0U;
+static volatile uint32_t seq_busy = 0U;
+
+static void seq_end(void);
+
+/*!
+    \brief      configure the timer channels in PWM mode and the DMA channel; the timer
+                runs with all compare values 0 from now on, so a sequence starts at an
+                update event and every step lasts whole PWM periods
+    \param[in]  config: timer, channels and DMA, copied
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the configuration is not valid
+*/
+ErrStatus pwm_seq_init(const pwm_seq_config_struct *config)
+{
+    timer_parameter_struct timer_initpara;
+    timer_oc_parameter_struct timer_ocintpara;
+    uint16_t ch;
+    uint32_t advanced = ((TIMER0 == config->timer) || (TIMER7 == config->timer)) ? 1U : 0U;
+
+    if((0U == config->channel_num) || ((config->first_channel + config->channel_num) > 4U) ||
+            ((0U != config->repetition) && (0U == advanced)) || (config->repetition > 0xFFU)) {
+        return ERROR;
+    }
+
+    pwm_seq_stop();
+    seq_cfg = *config;
+
+    timer_deinit(config->timer);
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = config->prescaler;
+    timer_initpara.alignedmode = TIMER_COUNTER_EDGE;
+    timer_initpara.counterdirection = TIMER_COUNTER_UP;
+    timer_initpara.period = config->period;
+    timer_initpara.clockdivision = TIMER_CKDIV_DIV1;
+    timer_initpara.repetitioncounter = (uint8_t)config->repetition;
+    timer_init(config->timer, &timer_initpara);
+
+    timer_channel_output_struct_para_init(&timer_ocintpara);
+    timer_ocintpara.ocpolarity = (0U != config->active_low) ? TIMER_OC_POLARITY_LOW : TIMER_OC_POLARITY_HIGH;
+    timer_ocintpara.outputstate = TIMER_CCX_ENABLE;
+    timer_ocintpara.ocidlestate = TIMER_OC_IDLE_STATE_LOW;
+
+    for(ch = config->first_channel; ch < (config->first_channel + config->channel_num); ch++) {
+        timer_channel_output_config(config->timer, ch, &timer_ocintpara);
+        timer_channel_output_pulse_value_config(config->timer, ch, 0U);
+        timer_channel_output_mode_config(config->timer, ch, TIMER_OC_MODE_PWM0);
+        /* the DMA writes the shadow registers during a period, all channels take their new
+           values together at the next update event */
+        timer_channel_output_shadow_config(config->timer, ch, TIMER_OC_SHADOW_ENABLE);
+    }
+
+    /* one update event requests a burst of one write per channel, TIMER_DMATB forwards
+       them to CHxCV from the first channel on */
+    timer_dma_transfer_config(config->timer, TIMER_DMACFG_DMATA_CH0CV + DMACFG_DMATA(config->first_channel),
+                              DMACFG_DMATC(config->channel_num - 1U));
+
+    timer_auto_reload_shadow_enable(config->timer);
+    if(0U != advanced) {
+        timer_primary_output_config(config->timer, ENABLE);
+    }
+    timer_enable(config->timer);
+
+    nvic_irq_enable(config->dma_irq, PWM_SEQ_IRQ_PRIO, 0U);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      play a table of compare values; a step has one value per channel, in channel
+                order, and the channels change together at the update event after the step
+                was written, the first step at the next update event
+    \param[in]  table: steps x channel_num compare values, must stay valid while it is played
+    \param[in]  steps: number of steps
+    \param[in]  loops: times the table is played, PWM_SEQ_LOOP_FOREVER repeats it until
+                pwm_seq_stop(); a looping sequence needs the DMA interrupt served within a step
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the table is too long
+*/
+ErrStatus pwm_seq_play(const uint16_t *table, uint32_t steps, uint32_t loops)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+    uint32_t number = steps * seq_cfg.channel_num;
+
+    if((NULL == table) || (0U == steps) || (number > SEQ_DMA_NUMBER_MAX)) {
+        return ERROR;
+    }
+
+    pwm_seq_stop();
+
+    dma_deinit(seq_cfg.dma_periph, seq_cfg.dma_channel);
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.periph_addr = (uint32_t)&TIMER_DMATB(seq_cfg.timer);
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)table;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_16BIT;
+    dma_init_struct.circular_mode = (1U == loops) ? DMA_CIRCULAR_MODE_DISABLE : DMA_CIRCULAR_MODE_ENABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.number = number;
+    dma_init_struct.priority = DMA_PRIORITY_HIGH;
+    dma_single_data_mode_init(seq_cfg.dma_periph, seq_cfg.dma_channel, &dma_init_struct);
+    dma_channel_subperipheral_select(seq_cfg.dma_periph, seq_cfg.dma_channel, seq_cfg.dma_subperi);
+
+    /* an endless loop needs no CPU at all, the others count the passes */
+    dma_flag_clear(seq_cfg.dma_periph, seq_cfg.dma_channel, SEQ_DMA_FLAGS);
+    if(PWM_SEQ_LOOP_FOREVER != loops) {
+        dma_interrupt_enable(seq_cfg.dma_periph, seq_cfg.dma_channel, DMA_INT_FTF);
+    }
+
+    seq_loops = loops;
+    seq_busy = 1U;
+    dma_channel_enable(seq_cfg.dma_periph, seq_cfg.dma_channel);
+    timer_dma_enable(seq_cfg.timer, TIMER_DMA_UPD);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      stop the sequence, the outputs keep the compare values of the last step
+                written and the timer keeps running
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void pwm_seq_stop(void)
+{
+    if(0U == seq_busy) {
+        return;
+    }
+
+    timer_dma_disable(seq_cfg.timer, TIMER_DMA_UPD);
+    dma_channel_disable(seq_cfg.dma_periph, seq_cfg.dma_channel);
+    while(0U != (DMA_CHCTL(seq_cfg.dma_periph, seq_cfg.dma_channel) & DMA_CHXCTL_CHEN)) {
+    }
+    seq_busy = 0U;
+}
+
+/*!
+    \brief      check whether a sequence is playing
+    \param[in]  none
+    \param[out] none
+    \retval     FlagStatus: SET while a sequence plays
+*/
+FlagStatus pwm_seq_busy(void)
+{
+    return (0U != seq_busy) ? SET : RESET;
+}
+
+/*!
+    \brief      encode bytes as one PWM period per bit, most significant bit first, for
+                single-wire LED protocols such as WS2812: a 0 bit is a period with the high
+                time zero and a 1 bit one with the high time one; idle periods with a
+                compare value 0 follow as the reset/latch gap and leave the line low
+    \param[in]  data: bytes, in the order the device expects them (GRB for WS2812)
+    \param[in]  bytes: number of bytes
+    \param[in]  zero: compare value of a 0 bit
+    \param[in]  one: compare value of a 1 bit
+    \param[in]  idle: number of idle periods at the end
+    \param[out] table: PWM_SEQ_BITS_TABLE_SIZE(bytes, idle) compare values
+    \retval     number of steps written
+*/
+uint32_t pwm_seq_bits_encode(const uint8_t *data, uint32_t bytes, uint16_t zero, uint16_t one,
+                             uint32_t idle, uint16_t *table)
+{
+    uint32_t i, n = 0U;
+    uint8_t bit, byte;
+
+    for(i = 0U; i < bytes; i++) {
+        byte = data[i];
+        for(bit = 0x80U; 0U != bit; bit >>= 1) {
+            table[n++] = (0U != (byte & bit)) ? one : zero;
+        }
+    }
+    for(i = 0U; i < idle; i++) {
+        table[n++] = 0U;
+    }
+
+    return n;
+}
+
+/*!
+    \brief      handle the DMA interrupt of the sequencer, count the passes of a looping
+                sequence and end it after the last one
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void pwm_seq_dma_irq_handler(void)
+{
+    if(RESET == dma_interrupt_flag_get(seq_cfg.dma_periph, seq_cfg.dma_channel, DMA_INT_FLAG_FTF)) {
+        return;
+    }
+    dma_interrupt_flag_clear(seq_cfg.dma_periph, seq_cfg.dma_channel, DMA_INT_FLAG_FTF);
+
+    if((0U != seq_loops) && (0U == --seq_loops)) {
+        seq_end();
+    }
+}
+
+/*!
+    \brief      end the sequence after its last step was written
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void seq_end(void)
+{
+    /* a circular DMA would write the first step again at the next update event */
+    timer_dma_disable(seq_cfg.timer, TIMER_DMA_UPD);
+    dma_channel_disable(seq_cfg.dma_periph, seq_cfg.dma_channel);
+    seq_busy = 0U;
+
+    if(NULL != seq_cfg.done) {
+        seq_cfg.done();
+    }
+}
@@ -0,0 +1,99 @@
+/*!
+    \file    boot_init.h
+    \brief   the header file of the boot init registry and the boot trace
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef BOOT_INIT_H
+#define BOOT_INIT_H
+
+#include "gd32f4xx.h"
+
+/* registry and trace sizes */
+#define BOOT_INIT_MAX                16U
+#define BOOT_TRACE_MAX               32U
+
+/* DMA channel for boot_dma_clear_start(), only DMA1 copies memory to memory */
+#define BOOT_DMA                     DMA1
+#define BOOT_DMA_CH                  DMA_CH0
+#define BOOT_DMA_CLK                 RCU_DMA1
+
+/* entry flags */
+#define BOOT_INIT_DEFERRED           0x01U               /*!< not needed for the first output, run by boot_init_run(BOOT_INIT_PHASE_DEFERRED) */
+
+/* phases of boot_init_run() */
+#define BOOT_INIT_PHASE_CRITICAL     0U                  /*!< the entries without BOOT_INIT_DEFERRED */
+#define BOOT_INIT_PHASE_DEFERRED     1U                  /*!< all entries left */
+
+/* dependency mask of entry n, entries depend on entries registered before them */
+#define BOOT_INIT_DEP(n)             (1UL << (n))
+
+/* one initialization step, start() begins it and ready() reports when it completed. an
+   entry without ready() is complete when start() returns, an entry without start() only
+   waits. while an entry is not ready the other entries whose dependencies are met run */
+typedef struct {
+    const char *name;                                    /*!< name in the boot trace */
+    uint32_t depends;                                    /*!< BOOT_INIT_DEP() of the entries needed first */
+    uint32_t flags;                                      /*!< BOOT_INIT_DEFERRED or 0 */
+    void (*start)(void);                                 /*!< begin the initialization, may be NULL */
+    ErrStatus (*ready)(void);                            /*!< SUCCESS once complete, may be NULL */
+} boot_init_struct;
+
+/* one timestamp of the boot trace */
+typedef struct {
+    const char *label;                                   /*!< what happened */
+    uint32_t cycles;                                     /*!< DWT cycle counter, started by Reset_Handler */
+    uint32_t clock;                                      /*!< SystemCoreClock at the mark */
+} boot_trace_struct;
+
+/* register the init table, the entries are numbered in table order */
+ErrStatus boot_init_register(const boot_init_struct *table, uint32_t num);
+/* run the entries of a phase until all are complete */
+ErrStatus boot_init_run(uint32_t phase);
+/* check if an entry is complete */
+FlagStatus boot_init_done(uint32_t index);
+
+/* start clearing a buffer with the DMA, len a multiple of 4 bytes */
+void boot_dma_clear_start(void *addr, uint32_t len);
+/* check if boot_dma_clear_start() finished, moves on to the next chunk of the buffer */
+ErrStatus boot_dma_clear_ready(void);
+
+/* record a timestamp */
+void boot_trace_mark(const char *label);
+/* microseconds from the reset to a mark */
+uint32_t boot_trace_us(uint32_t index);
+/* print the boot trace */
+void boot_trace_print(void);
+
+/* step the deferred switch to the PLL (system_gd32f4xx.c), SUCCESS once it runs from the PLL */
+ErrStatus SystemClockSwitch(void);
+
+#endif /* BOOT_INIT_H */
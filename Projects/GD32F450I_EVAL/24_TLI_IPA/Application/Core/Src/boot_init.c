@@ -0,0 +1,305 @@
+/*!
+    \file    boot_init.c
+    \brief   boot init registry with deferred entries, DMA buffer clearing and boot trace
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "boot_init.h"
+#include <stdio.h>
+
+/* DMA transfers per chunk, a multiple of the 4 word burst below the 65535 limit */
+#define BOOT_DMA_CHUNK              0xFFFCU
+
+static const boot_init_struct *init_table = NULL;
+static uint32_t init_num = 0U;
+static uint32_t init_started = 0U;
+static uint32_t init_done = 0U;
+
+static boot_trace_struct boot_trace[BOOT_TRACE_MAX];
+static uint32_t boot_trace_num = 0U;
+
+/* the DMA reads the zero it writes from flash */
+static const uint32_t clear_zero = 0U;
+static uint32_t clear_addr = 0U;
+static uint32_t clear_left = 0U;
+
+static void boot_dma_clear_next(void);
+
+/*!
+    \brief      register the init table
+    \param[in]  table: entries, entry n may only depend on the entries 0 to n - 1
+    \param[in]  num: number of entries, up to BOOT_INIT_MAX
+    \param[out] none
+    \retval     ErrStatus: ERROR if there are too many entries, or an entry depends on a later
+                entry or a critical entry on a deferred one
+*/
+ErrStatus boot_init_register(const boot_init_struct *table, uint32_t num)
+{
+    uint32_t deferred = 0U;
+    uint32_t i;
+
+    if(num > BOOT_INIT_MAX) {
+        return ERROR;
+    }
+
+    for(i = 0U; i < num; i++) {
+        if(0U != (table[i].depends & ~(BOOT_INIT_DEP(i) - 1U))) {
+            return ERROR;
+        }
+        if(0U != (table[i].flags & BOOT_INIT_DEFERRED)) {
+            deferred |= BOOT_INIT_DEP(i);
+        } else if(0U != (table[i].depends & deferred)) {
+            return ERROR;
+        } else {
+            /* critical entry on critical entries */
+        }
+    }
+
+    init_table = table;
+    init_num = num;
+    init_started = 0U;
+    init_done = 0U;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      run the entries of a phase until all are complete, an entry starts as soon
+                as its dependencies are complete and the entries waiting for their hardware
+                are polled in between, each completion is a mark of the boot trace
+    \param[in]  phase: entries to run
+      \arg        BOOT_INIT_PHASE_CRITICAL: the entries without BOOT_INIT_DEFERRED
+      \arg        BOOT_INIT_PHASE_DEFERRED: all entries not complete yet
+    \param[out] none
+    \retval     ErrStatus: ERROR if no table is registered
+*/
+ErrStatus boot_init_run(uint32_t phase)
+{
+    const boot_init_struct *entry;
+    uint32_t pending = 0U;
+    uint32_t i, bit;
+
+    if(NULL == init_table) {
+        return ERROR;
+    }
+
+    /* the core may still run from the IRC16M, the trace needs the actual frequency */
+    SystemCoreClockUpdate();
+
+    for(i = 0U; i < init_num; i++) {
+        if((BOOT_INIT_PHASE_DEFERRED == phase) || (0U == (init_table[i].flags & BOOT_INIT_DEFERRED))) {
+            pending |= BOOT_INIT_DEP(i);
+        }
+    }
+    pending &= ~init_done;
+
+    /* dependencies point backwards, so every pass completes at least the synchronous entries
+       whose dependencies are complete and the loop ends once the hardware is ready */
+    while(0U != pending) {
+        for(i = 0U; i < init_num; i++) {
+            bit = BOOT_INIT_DEP(i);
+            entry = &init_table[i];
+            if(0U == (pending & bit)) {
+                continue;
+            }
+            if(0U == (init_started & bit)) {
+                if(0U != (entry->depends & ~init_done)) {
+                    continue;
+                }
+                init_started |= bit;
+                if(NULL != entry->start) {
+                    entry->start();
+                }
+            }
+            if((NULL == entry->ready) || (SUCCESS == entry->ready())) {
+                init_done |= bit;
+                pending &= ~bit;
+                boot_trace_mark(entry->name);
+            }
+        }
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      check if an entry is complete
+    \param[in]  index: entry number in the table
+    \param[out] none
+    \retval     FlagStatus: SET if the entry is complete
+*/
+FlagStatus boot_init_done(uint32_t index)
+{
+    if((index < init_num) && (0U != (init_done & BOOT_INIT_DEP(index)))) {
+        return SET;
+    }
+
+    return RESET;
+}
+
+/*!
+    \brief      start clearing a buffer with the DMA, the CPU goes on with the other entries.
+                the 16 byte blocks are cleared by the DMA in 4 word bursts, the rest of the
+                buffer by the CPU
+    \param[in]  addr: buffer, 16 byte aligned
+    \param[in]  len: length in bytes, a multiple of 4
+    \param[out] none
+    \retval     none
+*/
+void boot_dma_clear_start(void *addr, uint32_t len)
+{
+    uint32_t *tail = (uint32_t *)addr + ((len & ~0xFU) / 4U);
+    uint32_t i;
+
+    for(i = 0U; i < ((len & 0xFU) / 4U); i++) {
+        tail[i] = 0U;
+    }
+
+    clear_addr = (uint32_t)addr;
+    clear_left = (len & ~0xFU) / 4U;
+
+    rcu_periph_clock_enable(BOOT_DMA_CLK);
+    dma_flag_clear(BOOT_DMA, BOOT_DMA_CH, DMA_FLAG_FTF);
+    boot_dma_clear_next();
+}
+
+/*!
+    \brief      check if the clearing started by boot_dma_clear_start() finished, starts
+                the next chunk of a buffer of more than 256K
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS once the buffer is zero
+*/
+ErrStatus boot_dma_clear_ready(void)
+{
+    if(RESET == dma_flag_get(BOOT_DMA, BOOT_DMA_CH, DMA_FLAG_FTF)) {
+        return ERROR;
+    }
+    dma_flag_clear(BOOT_DMA, BOOT_DMA_CH, DMA_FLAG_FTF);
+
+    if(0U != clear_left) {
+        boot_dma_clear_next();
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      record a timestamp of the boot trace
+    \param[in]  label: what happened, a string constant
+    \param[out] none
+    \retval     none
+*/
+void boot_trace_mark(const char *label)
+{
+    if(boot_trace_num < BOOT_TRACE_MAX) {
+        boot_trace[boot_trace_num].label = label;
+        boot_trace[boot_trace_num].cycles = DWT->CYCCNT;
+        boot_trace[boot_trace_num].clock = SystemCoreClock;
+        boot_trace_num++;
+    }
+}
+
+/*!
+    \brief      microseconds from the reset to a mark, the cycles between two marks count
+                at the clock of the first of them and the cycles up to the first mark at
+                the IRC16M, which Reset_Handler runs from
+    \param[in]  index: mark number
+    \param[out] none
+    \retval     microseconds
+*/
+uint32_t boot_trace_us(uint32_t index)
+{
+    uint64_t us = 0U;
+    uint32_t from = 0U;
+    uint32_t clock = IRC16M_VALUE;
+    uint32_t i;
+
+    for(i = 0U; (i <= index) && (i < boot_trace_num); i++) {
+        us += ((uint64_t)(boot_trace[i].cycles - from) * 1000000U) / clock;
+        from = boot_trace[i].cycles;
+        clock = boot_trace[i].clock;
+    }
+
+    return (uint32_t)us;
+}
+
+/*!
+    \brief      print the boot trace, one mark per line
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void boot_trace_print(void)
+{
+    uint32_t i;
+
+    printf("\r\nboot trace, microseconds from reset:\r\n");
+    for(i = 0U; i < boot_trace_num; i++) {
+        printf("%8lu  %s\r\n", (unsigned long)boot_trace_us(i), boot_trace[i].label);
+    }
+}
+
+/*!
+    \brief      start the next chunk of the DMA clearing
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void boot_dma_clear_next(void)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+    uint32_t words = (clear_left > BOOT_DMA_CHUNK) ? BOOT_DMA_CHUNK : clear_left;
+
+    dma_deinit(BOOT_DMA, BOOT_DMA_CH);
+    dma_multi_data_para_struct_init(&dma_init_struct);
+    /* memory to memory reads the "peripheral" address */
+    dma_init_struct.periph_addr = (uint32_t)&clear_zero;
+    dma_init_struct.periph_width = DMA_PERIPH_WIDTH_32BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = clear_addr;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_4_BEAT;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_MEMORY;
+    dma_init_struct.number = words;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_multi_data_mode_init(BOOT_DMA, BOOT_DMA_CH, &dma_init_struct);
+
+    clear_addr += words * 4U;
+    clear_left -= words;
+
+    dma_channel_enable(BOOT_DMA, BOOT_DMA_CH);
+}
@@ -36,6 +36,7 @@ OF SUCH DAMAGE.
 #include "systick.h"
 #include <stdio.h>
 #include "gd32f450i_eval.h"
+#include "boot_init.h"
 #include "image1.h"
 #include "image2.h"
 #include "image3.h"
@@ -65,13 +66,40 @@ OF SUCH DAMAGE.
 #define ACTIVE_HEIGHT                 272
 #define VERTICAL_FRONT_PORCH          2
 
-uint8_t blended_address_buffer[58292];
+/* boot init entries, an entry depends on entries before it */
+#define INIT_CLOCK                    0U
+#define INIT_TLI_GPIO                 1U
+#define INIT_BLEND_CLEAR              2U
+#define INIT_PLLSAI                   3U
+#define INIT_LCD                      4U
+#define INIT_SYSTICK                  5U
+#define INIT_COM                      6U
+
+/* cleared by the DMA while the clocks settle, not by the startup code */
+__attribute__((section(".noinit"), aligned(16))) uint8_t blended_address_buffer[58292];
 
 static void ipa_config(uint32_t baseaddress);
 static void tli_config(void);
 static void tli_blend_config(void);
 static void tli_gpio_config(void);
 static void lcd_config(void);
+static void blend_buffer_clear(void);
+static void pllsai_start(void);
+static ErrStatus pllsai_ready(void);
+static void com_config(void);
+static void lcd_frame_wait(void);
+
+/* the LCD comes first, the delay timer and the USART once the first frame is out */
+static const boot_init_struct boot_table[] = {
+    {"PLL is the system clock", 0U, 0U, NULL, SystemClockSwitch},
+    {"TLI GPIO configured", 0U, 0U, tli_gpio_config, NULL},
+    {"blend buffer cleared", 0U, 0U, blend_buffer_clear, boot_dma_clear_ready},
+    {"PLLSAI locked", BOOT_INIT_DEP(INIT_CLOCK), 0U, pllsai_start, pllsai_ready},
+    {"TLI enabled", BOOT_INIT_DEP(INIT_TLI_GPIO) | BOOT_INIT_DEP(INIT_BLEND_CLEAR) | BOOT_INIT_DEP(INIT_PLLSAI), 0U,
+     lcd_config, NULL},
+    {"systick configured", BOOT_INIT_DEP(INIT_CLOCK), BOOT_INIT_DEFERRED, systick_config, NULL},
+    {"USART configured", BOOT_INIT_DEP(INIT_CLOCK), BOOT_INIT_DEFERRED, com_config, NULL}
+};
 
 /*!
     \brief      main program
@@ -81,20 +109,23 @@ static void lcd_config(void);
 */
 int main(void)
 {
-    /* configure the SysTick, TLI */
-    systick_config();
-    lcd_config();
+    boot_trace_mark("main");
 
-    /* enable TLI layers */
-    tli_layer_enable(LAYER0);
-    tli_layer_enable(LAYER1);
-    tli_reload_config(TLI_FRAME_BLANK_RELOAD_EN);
-    /* enable TLI */
-    tli_enable();
+    /* switch to the PLL, clear the blend buffer and bring up the TLI, each step as soon as
+       the steps it needs are done */
+    boot_init_register(boot_table, sizeof(boot_table) / sizeof(boot_table[0]));
+    boot_init_run(BOOT_INIT_PHASE_CRITICAL);
 
-    /* configure TLI and display blend image */
-    tli_blend_config();
-    tli_reload_config(TLI_REQUEST_RELOAD_EN);
+    /* the first image in the blend buffer and the first frame with it on the LCD */
+    ipa_config((uint32_t)&gImage_image1);
+    ipa_transfer_enable();
+    while(RESET == ipa_interrupt_flag_get(IPA_INT_FLAG_FTF));
+    lcd_frame_wait();
+    boot_trace_mark("first frame");
+
+    /* the rest of the drivers */
+    boot_init_run(BOOT_INIT_PHASE_DEFERRED);
+    boot_trace_print();
 
     while(1) {
         /* IPA configuration and display the images one by one */
@@ -157,44 +188,98 @@ int main(void)
 */
 static void lcd_config(void)
 {
-    /* configure the GPIO of TLI */
-    tli_gpio_config();
-    /* configure TLI peripheral */
+    /* configure TLI peripheral with the logo layer and the blend image layer */
     tli_config();
-}
+    tli_blend_config();
 
+    /* enable TLI layers, TLI is off so the registers reload at once */
+    tli_layer_enable(LAYER0);
+    tli_layer_enable(LAYER1);
+    tli_reload_config(TLI_REQUEST_RELOAD_EN);
+    /* enable TLI */
+    tli_enable();
+}
 
 /*!
-    \brief      configure TLI peripheral
+    \brief      start clearing the blend buffer with the DMA
     \param[in]  none
     \param[out] none
     \retval     none
 */
-static void tli_config(void)
+static void blend_buffer_clear(void)
 {
-    tli_parameter_struct               tli_init_struct;
-    tli_layer_parameter_struct         tli_layer_init_struct;
-
-    rcu_periph_clock_enable(RCU_TLI);
-    tli_gpio_config();
+    boot_dma_clear_start(blended_address_buffer, sizeof(blended_address_buffer));
+}
 
-#ifdef __GNUC__
-    /* configure the PLLSAI clock to generate lcd clock */
-    if(ERROR == rcu_pllsai_config(192, 2, 3)) {
-        while(1);
-    }
-#endif /* __GNUC__ */
-#ifdef __IAR_SYSTEMS_ICC__
+/*!
+    \brief      start the PLLSAI for the LCD pixel clock, it shares the input divider of the PLL
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void pllsai_start(void)
+{
     /* configure the PLLSAI clock to generate lcd clock */
     if(ERROR == rcu_pllsai_config(192, 2, 3)) {
         while(1);
     }
-#endif /* __IAR_SYSTEMS_ICC__ */
     rcu_tli_clock_div_config(RCU_PLLSAIR_DIV8);
     rcu_osci_on(RCU_PLLSAI_CK);
-    if(ERROR == rcu_osci_stab_wait(RCU_PLLSAI_CK)) {
-        while(1);
+}
+
+/*!
+    \brief      check if the PLLSAI is locked
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS once the PLLSAI is stable
+*/
+static ErrStatus pllsai_ready(void)
+{
+    return (SET == rcu_flag_get(RCU_FLAG_PLLSAISTB)) ? SUCCESS : ERROR;
+}
+
+/*!
+    \brief      configure the USART for the boot trace
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void com_config(void)
+{
+    gd_eval_com_init(EVAL_COM0);
+}
+
+/*!
+    \brief      wait until the TLI scanned out a complete frame
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void lcd_frame_wait(void)
+{
+    /* the rest of the current active area, the vertical blanking, the next active area */
+    while(SET == tli_flag_get(TLI_FLAG_VDE)) {
     }
+    while(RESET == tli_flag_get(TLI_FLAG_VDE)) {
+    }
+    while(SET == tli_flag_get(TLI_FLAG_VDE)) {
+    }
+}
+
+
+/*!
+    \brief      configure TLI peripheral
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void tli_config(void)
+{
+    tli_parameter_struct               tli_init_struct;
+    tli_layer_parameter_struct         tli_layer_init_struct;
+
+    /* the GPIO and the PLLSAI pixel clock are configured by their boot init entries */
+    rcu_periph_clock_enable(RCU_TLI);
 
     /* configure TLI parameter struct */
     tli_init_struct.signalpolarity_hs = TLI_HSYN_ACTLIVE_LOW;
@@ -285,56 +370,14 @@ static void ipa_config(uint32_t baseaddress)
 }
 
 /*!
-    \brief      configure TLI peripheral and display blend image
+    \brief      configure the TLI layer of the blend image
     \param[in]  none
     \param[out] none
     \retval     none
 */
 static void tli_blend_config(void)
 {
-    tli_parameter_struct               tli_init_struct;
     tli_layer_parameter_struct         tli_layer_init_struct;
-    rcu_periph_clock_enable(RCU_TLI);
-    tli_gpio_config();
-
-#ifdef __GNUC__
-    /* configure the PLLSAI clock to generate lcd clock */
-    if(ERROR == rcu_pllsai_config(192, 2, 3)) {
-        while(1);
-    }
-#endif /* __GNUC__ */
-#ifdef __IAR_SYSTEMS_ICC__
-    /* configure the PLLSAI clock to generate lcd clock */
-    if(ERROR == rcu_pllsai_config(192, 2, 3)) {
-        while(1);
-    }
-#endif /* __IAR_SYSTEMS_ICC__ */
-    rcu_tli_clock_div_config(RCU_PLLSAIR_DIV8);
-    rcu_osci_on(RCU_PLLSAI_CK);
-    if(ERROR == rcu_osci_stab_wait(RCU_PLLSAI_CK)) {
-        while(1);
-    }
-
-    /* configure TLI parameter struct */
-    tli_init_struct.signalpolarity_hs = TLI_HSYN_ACTLIVE_LOW;
-    tli_init_struct.signalpolarity_vs = TLI_VSYN_ACTLIVE_LOW;
-    tli_init_struct.signalpolarity_de = TLI_DE_ACTLIVE_LOW;
-    tli_init_struct.signalpolarity_pixelck = TLI_PIXEL_CLOCK_TLI;
-
-    /* LCD display timing configuration */
-    tli_init_struct.synpsz_hpsz = HORIZONTAL_SYNCHRONOUS_PULSE - 1;
-    tli_init_struct.synpsz_vpsz = VERTICAL_SYNCHRONOUS_PULSE - 1;
-    tli_init_struct.backpsz_hbpsz = HORIZONTAL_SYNCHRONOUS_PULSE + HORIZONTAL_BACK_PORCH - 1;
-    tli_init_struct.backpsz_vbpsz = VERTICAL_SYNCHRONOUS_PULSE + VERTICAL_BACK_PORCH - 1;
-    tli_init_struct.activesz_hasz = HORIZONTAL_SYNCHRONOUS_PULSE + HORIZONTAL_BACK_PORCH + ACTIVE_WIDTH - 1;
-    tli_init_struct.activesz_vasz = VERTICAL_SYNCHRONOUS_PULSE + VERTICAL_BACK_PORCH + ACTIVE_HEIGHT - 1;
-    tli_init_struct.totalsz_htsz = HORIZONTAL_SYNCHRONOUS_PULSE + HORIZONTAL_BACK_PORCH + ACTIVE_WIDTH + HORIZONTAL_FRONT_PORCH - 1;
-    tli_init_struct.totalsz_vtsz = VERTICAL_SYNCHRONOUS_PULSE + VERTICAL_BACK_PORCH + ACTIVE_HEIGHT + VERTICAL_FRONT_PORCH - 1;
-    /* configure LCD background R,G,B values */
-    tli_init_struct.backcolor_red = 0xFF;
-    tli_init_struct.backcolor_green = 0xFF;
-    tli_init_struct.backcolor_blue = 0xFF;
-    tli_init(&tli_init_struct);
 
     /* TLI layer1 configuration */
     tli_layer_init_struct.layer_window_leftpos = 80 + HORIZONTAL_SYNCHRONOUS_PULSE + HORIZONTAL_BACK_PORCH;
@@ -435,3 +478,11 @@ static void tli_gpio_config(void)
     gpio_output_options_set(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_15);
     gpio_bit_set(GPIOB, GPIO_PIN_15);
 }
+
+/* retarget the C library printf function to the USART */
+int fputc(int ch, FILE *f)
+{
+    usart_data_transmit(EVAL_COM0, (uint8_t) ch);
+    while (RESET == usart_flag_get(EVAL_COM0,USART_FLAG_TBE));
+    return ch;
+}
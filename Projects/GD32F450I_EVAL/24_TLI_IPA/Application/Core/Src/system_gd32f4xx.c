@@ -63,6 +63,23 @@
 //#define __SYSTEM_CLOCK_240M_PLL_8M_HXTAL        (uint32_t)(240000000)
 #endif
 
+/* SystemInit only starts the HXTAL and returns on the IRC16M, the startup code initializes the
+   sections while the crystal settles and SystemClockSwitch() moves to the PLL from the 25M HXTAL
+   later on. comment the following line to configure the clock completely in SystemInit */
+#define __SYSTEM_CLOCK_DEFERRED
+
+#ifdef __SYSTEM_CLOCK_DEFERRED
+#if defined (__SYSTEM_CLOCK_168M_PLL_25M_HXTAL)
+/* PSC = 25, PLL_N = 336, PLL_P = 2, PLL_Q = 7 */
+#define SYSTEM_CLOCK_DEFERRED_PLL   (25U | (336U << 6U) | (((2U >> 1U) - 1U) << 16U) | (RCU_PLLSRC_HXTAL) | (7U << 24U))
+#elif defined (__SYSTEM_CLOCK_200M_PLL_25M_HXTAL)
+/* PSC = 25, PLL_N = 400, PLL_P = 2, PLL_Q = 9 */
+#define SYSTEM_CLOCK_DEFERRED_PLL   (25U | (400U << 6U) | (((2U >> 1U) - 1U) << 16U) | (RCU_PLLSRC_HXTAL) | (9U << 24U))
+#else
+#error "__SYSTEM_CLOCK_DEFERRED supports the 168M and 200M PLL from the 25M HXTAL"
+#endif
+#endif /* __SYSTEM_CLOCK_DEFERRED */
+
 /* The following is to prevent Vcore fluctuations caused by frequency switching. 
    It is strongly recommended to include it to avoid issues caused by self-removal. */
 #define RCU_MODIFY_4(__delay)   do{                                     \
@@ -133,8 +150,13 @@ static void system_clock_168m_irc16m(void);
 uint32_t SystemCoreClock = __SYSTEM_CLOCK_168M_PLL_8M_HXTAL;
 static void system_clock_168m_8m_hxtal(void);
 #elif defined (__SYSTEM_CLOCK_168M_PLL_25M_HXTAL)
+#ifdef __SYSTEM_CLOCK_DEFERRED
+/* the core runs from the IRC16M until SystemClockSwitch() moves it to the PLL */
+uint32_t SystemCoreClock = __IRC16M;
+#else
 uint32_t SystemCoreClock = __SYSTEM_CLOCK_168M_PLL_25M_HXTAL;
 static void system_clock_168m_25m_hxtal(void);
+#endif /* __SYSTEM_CLOCK_DEFERRED */
 #elif defined (__SYSTEM_CLOCK_200M_PLL_IRC16M)
 uint32_t SystemCoreClock = __SYSTEM_CLOCK_200M_PLL_IRC16M;
 static void system_clock_200m_irc16m(void);
@@ -142,8 +164,13 @@ static void system_clock_200m_irc16m(void);
 uint32_t SystemCoreClock = __SYSTEM_CLOCK_200M_PLL_8M_HXTAL;
 static void system_clock_200m_8m_hxtal(void);
 #elif defined (__SYSTEM_CLOCK_200M_PLL_25M_HXTAL)
+#ifdef __SYSTEM_CLOCK_DEFERRED
+/* the core runs from the IRC16M until SystemClockSwitch() moves it to the PLL */
+uint32_t SystemCoreClock = __IRC16M;
+#else
 uint32_t SystemCoreClock = __SYSTEM_CLOCK_200M_PLL_25M_HXTAL;
 static void system_clock_200m_25m_hxtal(void);
+#endif /* __SYSTEM_CLOCK_DEFERRED */
 #elif defined (__SYSTEM_CLOCK_240M_PLL_IRC16M)
 uint32_t SystemCoreClock = __SYSTEM_CLOCK_240M_PLL_IRC16M;
 static void system_clock_240m_irc16m(void);
@@ -155,8 +182,10 @@ uint32_t SystemCoreClock = __SYSTEM_CLOCK_240M_PLL_25M_HXTAL;
 static void system_clock_240m_25m_hxtal(void);
 #endif /* __SYSTEM_CLOCK_IRC16M */
 
+#ifndef __SYSTEM_CLOCK_DEFERRED
 /* configure the system clock */
 static void system_clock_config(void);
+#endif /* __SYSTEM_CLOCK_DEFERRED */
 
 /* software delay to prevent the impact of Vcore fluctuations.
    It is strongly recommended to include it to avoid issues caused by self-removal. */
@@ -210,10 +239,87 @@ void SystemInit (void)
     /* Disable all interrupts */
     RCU_INT = 0x00000000U;
          
+#ifdef __SYSTEM_CLOCK_DEFERRED
+    /* start the HXTAL, SystemClockSwitch() configures the PLL once it is stable */
+    RCU_CTL |= RCU_CTL_HXTALEN;
+#else
     /* Configure the System clock source, PLL Multiplier and Divider factors, 
         AHB/APBx prescalers and Flash settings */
     system_clock_config();
+#endif /* __SYSTEM_CLOCK_DEFERRED */
 }
+
+#ifdef __SYSTEM_CLOCK_DEFERRED
+/*!
+    \brief      step the deferred switch to the PLL without waiting: the PLL starts once the
+                HXTAL is stable, the high-drive mode once the PLL is locked, and the PLL becomes
+                the system clock once the high-drive mode is on. call until it returns SUCCESS
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS once the PLL is the system clock, ERROR while waiting
+*/
+ErrStatus SystemClockSwitch(void)
+{
+    static uint32_t step = 0U;
+    __IO uint32_t reg_temp;
+
+    if(0U == step){
+        /* wait until HXTAL is stable */
+        if(0U == (RCU_CTL & RCU_CTL_HXTALSTB)){
+            return ERROR;
+        }
+        RCU_APB1EN |= RCU_APB1EN_PMUEN;
+        PMU_CTL |= PMU_CTL_LDOVS;
+
+        RCU_PLL = SYSTEM_CLOCK_DEFERRED_PLL;
+        /* enable PLL */
+        RCU_CTL |= RCU_CTL_PLLEN;
+        step = 1U;
+    }
+
+    if(1U == step){
+        /* wait until PLL is stable */
+        if(0U == (RCU_CTL & RCU_CTL_PLLSTB)){
+            return ERROR;
+        }
+        /* Enable the high-drive to extend the clock frequency */
+        PMU_CTL |= PMU_CTL_HDEN;
+        step = 2U;
+    }
+
+    if(2U == step){
+        if(0U == (PMU_CS & PMU_CS_HDRF)){
+            return ERROR;
+        }
+        /* select the high-drive mode */
+        PMU_CTL |= PMU_CTL_HDS;
+        step = 3U;
+    }
+
+    if(3U == step){
+        if(0U == (PMU_CS & PMU_CS_HDSRF)){
+            return ERROR;
+        }
+        /* AHB = SYSCLK, APB2 = AHB/2, APB1 = AHB/4 */
+        RCU_CFG0 |= RCU_AHB_CKSYS_DIV1 | RCU_APB2_CKAHB_DIV2 | RCU_APB1_CKAHB_DIV4;
+
+        reg_temp = RCU_CFG0;
+        /* select PLL as system clock */
+        reg_temp &= ~RCU_CFG0_SCS;
+        reg_temp |= RCU_CKSYSSRC_PLLP;
+        RCU_CFG0 = reg_temp;
+
+        /* wait until PLL is selected as system clock */
+        while(0U == (RCU_CFG0 & RCU_SCSS_PLLP)){
+        }
+        SystemCoreClockUpdate();
+        step = 4U;
+    }
+
+    return SUCCESS;
+}
+
+#else
 /*!
     \brief      configure the system clock
     \param[in]  none
@@ -1202,6 +1308,8 @@ static void system_clock_240m_25m_hxtal(void)
     }
 }
 #endif /* __SYSTEM_CLOCK_IRC16M */
+#endif /* __SYSTEM_CLOCK_DEFERRED */
+
 /*!
     \brief      update the SystemCoreClock with current core clock retrieved from cpu registers
     \param[in]  none
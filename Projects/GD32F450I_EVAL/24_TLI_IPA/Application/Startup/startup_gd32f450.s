@@ -18,39 +18,81 @@
 
 /* reset Handler */
 Reset_Handler:
+/* start the DWT cycle counter for the boot trace: TRCENA in DEMCR, then CYCCNTENA */
+  ldr r0, =0xE000EDFC
+  ldr r1, [r0]
+  orr r1, r1, #0x01000000
+  str r1, [r0]
+  ldr r0, =0xE0001000
   movs r1, #0
-  b DataInit
+  str r1, [r0, #4]
+  ldr r1, [r0]
+  orr r1, r1, #1
+  str r1, [r0]
 
-CopyData:
-  ldr r3, =_sidata
-  ldr r3, [r3, r1]
-  str r3, [r0, r1]
-  adds r1, r1, #4
+/* Call SystemInit function, it uses no data and starts the HXTAL, which settles while the
+   sections are initialized */
+  bl  SystemInit
 
-DataInit:
+/* copy the initialized data and zero the bss */
   ldr r0, =_sdata
-  ldr r3, =_edata
-  adds r2, r0, r1
-  cmp r2, r3
-  bcc CopyData
-  ldr r2, =_sbss
-  b Zerobss
-
-FillZerobss:
-  movs r3, #0
-  str r3, [r2], #4
-
-Zerobss:
-  ldr r3, = _ebss
-  cmp r2, r3
-  bcc FillZerobss
-/* Call SystemInit function */
-  bl  SystemInit
+  ldr r1, =_edata
+  ldr r2, =_sidata
+  bl CopySection
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  bl ZeroSection
+
 /* Call static constructors */
   bl __libc_init_array
 /*Call the main function */
   bl main
   bx lr
+
+/* copy r1 - r0 bytes from r2 to r0, the linker script keeps all of them 4 byte aligned.
+   16 bytes per load and store multiple, then single words. uses r3 to r7 */
+CopySection:
+  subs r3, r1, r0
+  bls CopyDone
+CopyBlock:
+  subs r3, r3, #16
+  bcc CopyTail
+  ldmia r2!, {r4-r7}
+  stmia r0!, {r4-r7}
+  b CopyBlock
+CopyTail:
+  adds r3, r3, #16
+  beq CopyDone
+CopyWord:
+  ldr r4, [r2], #4
+  str r4, [r0], #4
+  subs r3, r3, #4
+  bne CopyWord
+CopyDone:
+  bx lr
+
+/* zero r1 - r0 bytes from r0, 4 byte aligned, 16 bytes per store multiple. uses r3 to r7 */
+ZeroSection:
+  movs r4, #0
+  movs r5, #0
+  movs r6, #0
+  movs r7, #0
+  subs r3, r1, r0
+  bls ZeroDone
+ZeroBlock:
+  subs r3, r3, #16
+  bcc ZeroTail
+  stmia r0!, {r4-r7}
+  b ZeroBlock
+ZeroTail:
+  adds r3, r3, #16
+  beq ZeroDone
+ZeroWord:
+  str r4, [r0], #4
+  subs r3, r3, #4
+  bne ZeroWord
+ZeroDone:
+  bx lr
 .size Reset_Handler, .-Reset_Handler
 
     .section .text.Default_Handler,"ax",%progbits
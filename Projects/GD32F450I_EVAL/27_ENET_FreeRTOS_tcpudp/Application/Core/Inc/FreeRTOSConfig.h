@@ -54,19 +54,21 @@
 #define configTICK_RATE_HZ				( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES			( 8 )
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 130 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 30 * 1024 ) )
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 32 * 1024 ) )	/* SRAM region of rtos_heap.c, shared with lwIP, the TCM comes on top */
 #define configMAX_TASK_NAME_LEN			( 16 )
 #define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			0
 #define configIDLE_SHOULD_YIELD			1
 #define configUSE_MUTEXES				1
 #define configQUEUE_REGISTRY_SIZE		8
-#define configCHECK_FOR_STACK_OVERFLOW	0
+#define configCHECK_FOR_STACK_OVERFLOW	2
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configUSE_MALLOC_FAILED_HOOK	0
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+#define configUSE_TASK_NOTIFICATIONS	1
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS	1	/* per task semaphore of lwIP */
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
@@ -123,5 +125,24 @@ standard names. */
 #define xPortPendSVHandler PendSV_Handler
 #define xPortSysTickHandler SysTick_Handler
 
+/* Run-time statistics and trace hooks, implemented in rtos_trace.c.  The
+run-time counter is a free-running 32-bit TIMER, see RTOS_TRACE_TIMER_HZ. */
+#if  defined(__ICCARM__) || defined(__CC_ARM) || defined(__TASKING__) || defined(__GNUC__)
+	#include "rtos_trace.h"
+	#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	rtos_trace_timer_init()
+	#define portGET_RUN_TIME_COUNTER_VALUE()			rtos_trace_timestamp()
+	#define traceTASK_SWITCHED_IN()						rtos_trace_task_switched_in( pxCurrentTCB->uxTCBNumber )
+#endif
+
+/* Tickless idle, implemented in rtos_lowpower.c.  The idle task sleeps or
+deep-sleeps with the RTC wakeup timer instead of the SysTick, which stops in
+deep-sleep. */
+#define configUSE_TICKLESS_IDLE					2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP	2
+#if  defined(__ICCARM__) || defined(__CC_ARM) || defined(__TASKING__) || defined(__GNUC__)
+	#include "rtos_lowpower.h"
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )	rtos_lowpower_idle( xExpectedIdleTime )
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
 
@@ -35,11 +35,14 @@ OF SUCH DAMAGE.
 #ifndef LWIPOPTS_H
 #define LWIPOPTS_H
 
+#include "mem_region.h"
 
 #define ETHARP_TRUST_IP_MAC     0
 #define IP_REASSEMBLY           0
 #define IP_FRAG                 0
 #define ARP_QUEUEING            0
+#define LWIP_SUPPORT_CUSTOM_PBUF 1                       /* custom pbufs carry the application buffers of the
+                                                            zero-copy sends (zc_net.c) */
 
 #define SYS_LIGHTWEIGHT_PROT    1                        /* SYS_LIGHTWEIGHT_PROT==1: if you want inter-task protection 
                                                             for certain critical regions during buffer allocation,
@@ -53,9 +56,16 @@ OF SUCH DAMAGE.
                                                             is compiled. 4 byte alignment -> define MEM_ALIGNMENT 
                                                             to 4, 2 byte alignment -> define MEM_ALIGNMENT to 2 */
 
-#define MEM_SIZE                (5*1024)                /* the size of the heap memory, if the application will 
-                                                            send a lot of data that needs to be copied, this should
-                                                            be set high */
+#define MEM_LIBC_MALLOC         1                        /* mem_malloc() uses the SRAM region of the multi-region
+                                                            heap (mem_region.c) instead of a MEM_SIZE heap of its own,
+                                                            lwIP only runs in tasks, after the heap is set up */
+#define mem_clib_malloc(size)   mem_region_alloc((size), MEM_HINT_DMA)
+#define mem_clib_calloc(count, size) mem_region_calloc((count), (size), MEM_HINT_DMA)
+#define mem_clib_free           mem_region_free
+
+#define MEMP_MEM_MALLOC         1                        /* the memp pools are served by mem_malloc() as well, the
+                                                            small ones from the O(1) size-class pools of the heap,
+                                                            the MEMP_NUM_xxx counts are no longer reserved up front */
 
 #define MEMP_NUM_PBUF           100                       /* the number of memp struct pbufs. If the application
                                                             sends a lot of data out of ROM (or other static memory),
@@ -121,7 +131,7 @@ OF SUCH DAMAGE.
 /* sequential layer options */
 #define LWIP_NETCONN            1                        /* set to 1 to enable netconn API (require to use api_lib.c) */
 
-#define MEMP_NUM_NETCONN        4                        /* the number of struct netconns */
+#define MEMP_NUM_NETCONN        5                        /* the number of struct netconns (one is used by rtos_trace) */
 
 /* socket options */
 #define LWIP_SOCKET             1                        /* set to 1 to enable socket API (require to use sockets.c) */
@@ -172,15 +182,35 @@ OF SUCH DAMAGE.
    ---------------------------------
 */
 #include "FreeRTOSConfig.h"
-#define LWIP_COMPAT_MUTEX_ALLOWED
 #define LWIP_NETIF_STATUS_CALLBACK 1
 
 #define TCPIP_THREAD_NAME              "TCP/IP"
 #define TCPIP_THREAD_STACKSIZE          1000
-#define TCPIP_MBOX_SIZE                 5
+#define TCPIP_MBOX_SIZE                 16
+#define TCPIP_MBOX_BATCH                8       /* messages handled per wakeup of the tcpip thread */
 #define DEFAULT_THREAD_STACKSIZE        500
 #define TCPIP_THREAD_PRIO               (configMAX_PRIORITIES - 2) 
-#define LWIP_COMPAT_MUTEX 1
+#define LWIP_COMPAT_MUTEX               0       /* FreeRTOS mutexes, they inherit priority */
+
+/* core locking: netconn/socket calls and received frames run lwIP in the calling task
+   under lock_tcpip_core instead of a round trip through the tcpip thread mailbox;
+   build with LWIP_TCPIP_CORE_LOCKING=0 to compare with the message passing */
+#ifndef LWIP_TCPIP_CORE_LOCKING
+#define LWIP_TCPIP_CORE_LOCKING         1
+#endif
+#if LWIP_TCPIP_CORE_LOCKING
+#define LWIP_TCPIP_CORE_LOCKING_INPUT   1
+#define LOCK_TCPIP_CORE()               sys_lock_tcpip_core()
+#define UNLOCK_TCPIP_CORE()             sys_unlock_tcpip_core()
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+#define LWIP_MARK_TCPIP_THREAD()        sys_mark_tcpip_thread()
+
+/* SYS_ARCH_PROTECT() is a critical section, not a mutex */
+#define LWIP_FREERTOS_SYS_ARCH_PROTECT_USES_MUTEX   0
+
+/* one semaphore per task for blocking API calls, signalled by task notifications */
+#define LWIP_NETCONN_SEM_PER_THREAD     1
+#define LWIP_FREERTOS_NETCONN_SEM_NOTIFY            1
 #define DEFAULT_TCP_RECVMBOX_SIZE       8
 #define DEFAULT_UDP_RECVMBOX_SIZE       8
 #define DEFAULT_ACCEPTMBOX_SIZE         8
@@ -0,0 +1,104 @@
+/*!
+    \file    mem_region.h
+    \brief   the header file of the multi-region heap with size-class pools
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef MEM_REGION_H
+#define MEM_REGION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* this header is pulled in by lwipopts.h, so it must not include
+   FreeRTOS, lwIP or device headers itself */
+
+/* memory regions, each one is an arena of its own */
+typedef enum {
+    MEM_REGION_SRAM = 0U,                                /*!< main SRAM, reachable by the DMAs and the ENET */
+    MEM_REGION_TCM,                                      /*!< TCM, no wait states, the CPU is the only master */
+    MEM_REGION_SDRAM,                                    /*!< EXMC SDRAM, large and slow */
+    MEM_REGION_NUM
+} mem_region_enum;
+
+/* placement hints, each one tries the regions in its own order */
+typedef enum {
+    MEM_HINT_DMA = 0U,                                   /*!< read or written by a DMA: SRAM, SDRAM */
+    MEM_HINT_CPU,                                        /*!< CPU only, such as stacks: TCM, SRAM, SDRAM */
+    MEM_HINT_BULK,                                       /*!< large and not time critical: SDRAM, SRAM */
+    MEM_HINT_NUM
+} mem_hint_enum;
+
+/* blocks are aligned to MEM_REGION_ALIGN bytes and carry a header word */
+#define MEM_REGION_ALIGN             8U
+/* requests of up to 252 bytes are served in O(1) from the size-class pools of 16, 32, 64,
+   128 and 256 byte blocks, larger ones first fit from the arena */
+#define MEM_REGION_POOL_CLASSES      5U
+#define MEM_REGION_POOL_MAX          (((uint32_t)16U << (MEM_REGION_POOL_CLASSES - 1U)) - 4U)
+/* an empty pool takes this many bytes of blocks from the arena at once, pool blocks
+   never go back to the arena */
+#define MEM_REGION_POOL_REFILL       1024U
+/* the pools of a region take at most this percentage of its arena, further small
+   requests are served first fit from the arena and go back to it */
+#define MEM_REGION_POOL_SHARE        50U
+
+/* statistics of a region */
+typedef struct {
+    uint32_t size;                                       /*!< bytes of the arena, 0 if the region is not added */
+    uint32_t free;                                       /*!< free bytes in the arena and in the pools */
+    uint32_t free_min;                                   /*!< lowest free since the region was added, the high-water mark is size - free_min */
+    uint32_t largest;                                    /*!< largest free arena block */
+    uint32_t free_blocks;                                /*!< number of free arena blocks */
+    uint32_t frag;                                       /*!< arena fragmentation in per mille: 1000 * (1 - largest / free arena bytes) */
+    uint32_t pool_size;                                  /*!< bytes taken by the pools from the arena */
+    uint32_t pool_free;                                  /*!< free bytes in the pools */
+    uint32_t allocs;                                     /*!< successful allocations */
+    uint32_t frees;                                      /*!< blocks given back */
+    uint32_t misses;                                     /*!< requests the region could not serve, they went to the next region of the hint */
+} mem_region_stat_struct;
+
+/* give memory to a region, returns the usable bytes or 0 if the region is already added or too small */
+uint32_t mem_region_add(mem_region_enum region, void *start, uint32_t size);
+/* allocate size bytes from the first region of the hint that has room, NULL if none has */
+void *mem_region_alloc(size_t size, mem_hint_enum hint);
+/* allocate count * size zeroed bytes */
+void *mem_region_calloc(size_t count, size_t size, mem_hint_enum hint);
+/* give a block back to its region, NULL is ignored */
+void mem_region_free(void *mem);
+/* the region that holds a block, MEM_REGION_NUM if none */
+mem_region_enum mem_region_of(const void *mem);
+/* read the statistics of a region */
+void mem_region_stat_get(mem_region_enum region, mem_region_stat_struct *stat);
+/* free bytes of all regions now and at their lowest point */
+uint32_t mem_region_free_get(void);
+uint32_t mem_region_free_min_get(void);
+
+#endif /* MEM_REGION_H */
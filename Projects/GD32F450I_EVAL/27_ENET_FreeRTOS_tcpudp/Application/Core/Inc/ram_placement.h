@@ -0,0 +1,56 @@
+/*!
+    \file    ram_placement.h
+    \brief   attributes that place hot code and data in RAM
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef RAM_PLACEMENT_H
+#define RAM_PLACEMENT_H
+
+/* this header only holds attributes, so any file can include it */
+
+/* PROJECT_RAM_PLACEMENT=ON in cmake/project.cmake defines RAM_PLACEMENT, without it
+   everything stays in flash and .data/.bss, which gives the baseline to compare with */
+#ifdef RAM_PLACEMENT
+/* code run from the SRAM, the startup copies it from the flash, calls from the flash
+   reach it through linker veneers */
+#define __RAMFUNC                    __attribute__((section(".RamFunc"), noinline))
+/* initialized data in the TCM, no DMA reaches it */
+#define __TCM_DATA                   __attribute__((section(".tcmram")))
+/* zeroed data in the TCM, no DMA reaches it */
+#define __TCM_BSS                    __attribute__((section(".tcmbss")))
+#else
+#define __RAMFUNC
+#define __TCM_DATA
+#define __TCM_BSS
+#endif /* RAM_PLACEMENT */
+
+#endif /* RAM_PLACEMENT_H */
@@ -0,0 +1,90 @@
+/*!
+    \file    rtos_lowpower.h
+    \brief   the header file of the FreeRTOS tickless idle with sleep and deep-sleep
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef RTOS_LOWPOWER_H
+#define RTOS_LOWPOWER_H
+
+#include <stdint.h>
+
+/* this header is pulled in by FreeRTOSConfig.h, so it must not include
+   FreeRTOS or device headers itself */
+
+/* the RTC runs from LXTAL with an asynchronous prescaler of 2 and a synchronous one of 16384,
+   the calendar still counts seconds and the sub-second counter gives a 61us time base */
+#define RTOS_LOWPOWER_RTC_HZ             16384U
+/* deep-sleep is only used for idle periods of at least this many milliseconds */
+#define RTOS_LOWPOWER_DEEP_MIN_MS        10U
+/* deep-sleep wakeup latency assumed until the first one has been measured */
+#define RTOS_LOWPOWER_DEEP_LATENCY_US    2000U
+/* number of wakeup latency constraints that can be registered at the same time */
+#define RTOS_LOWPOWER_CONSTRAINTS        4U
+/* run the LDO in low power mode during deep-sleep, this makes the wakeup slower */
+#define RTOS_LOWPOWER_DEEP_LDO_LOWPOWER  1U
+/* no SDRAM device is put into self-refresh */
+#define RTOS_LOWPOWER_SDRAM_NONE         0U
+
+/* low power statistics, the counters only grow */
+typedef struct {
+    uint32_t sleep_count;                                /*!< idle periods spent in sleep mode */
+    uint32_t sleep_ticks;                                /*!< ticks spent in sleep mode */
+    uint32_t deep_count;                                 /*!< idle periods spent in deep-sleep mode */
+    uint32_t deep_ticks;                                 /*!< ticks spent in deep-sleep mode */
+    uint32_t deep_vetoed;                                /*!< idle periods long enough for deep-sleep that were vetoed */
+    uint32_t latency_last_us;                            /*!< deep-sleep wakeup latency measured last */
+    uint32_t latency_max_us;                             /*!< highest deep-sleep wakeup latency measured */
+} rtos_lowpower_stats_struct;
+
+/* function declarations */
+/* configure the RTC time base and wakeup timer, returns 0, or -1 if LXTAL or the RTC does not start */
+int32_t rtos_lowpower_init(void);
+/* sleep for up to expected_ticks ticks with the tick suppressed, called by the idle task */
+void rtos_lowpower_idle(uint32_t expected_ticks);
+/* forbid deep-sleep until the matching rtos_lowpower_deep_allow(), calls nest */
+void rtos_lowpower_deep_veto(void);
+/* allow deep-sleep again */
+void rtos_lowpower_deep_allow(void);
+/* only use deep-sleep while its wakeup latency stays below max_us, returns a handle or -1 */
+int32_t rtos_lowpower_latency_request(uint32_t max_us);
+/* remove a latency constraint */
+void rtos_lowpower_latency_release(int32_t handle);
+/* put an SDRAM device into self-refresh during deep-sleep, EXMC_SDRAM_DEVICE0/1 or RTOS_LOWPOWER_SDRAM_NONE */
+void rtos_lowpower_sdram_set(uint32_t sdram_device);
+/* the current deep-sleep wakeup latency estimate */
+uint32_t rtos_lowpower_latency_get(void);
+/* read the statistics */
+void rtos_lowpower_stats_get(rtos_lowpower_stats_struct *stats);
+/* RTC wakeup interrupt handler */
+void rtos_lowpower_rtc_irq_handler(void);
+
+#endif /* RTOS_LOWPOWER_H */
@@ -0,0 +1,109 @@
+/*!
+    \file    rtos_trace.h
+    \brief   the header file of the FreeRTOS run-time statistics and trace recorder
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef RTOS_TRACE_H
+#define RTOS_TRACE_H
+
+#include <stdint.h>
+
+/* this header is pulled in by FreeRTOSConfig.h, so it must not include
+   FreeRTOS or device headers itself */
+
+/* run-time counter: free-running 32-bit TIMER1, wraps after 2^32 / RTOS_TRACE_TIMER_HZ seconds */
+#define RTOS_TRACE_TIMER_HZ          1000000U
+/* number of events kept in the flight recorder, must be a power of two */
+#define RTOS_TRACE_RING_SIZE         512U
+/* tasks with their own context switch counter, higher task numbers share slot 0 */
+#define RTOS_TRACE_MAX_TASKS         16U
+/* statistics window and export period */
+#define RTOS_TRACE_PERIOD_MS         1000U
+/* size of one export chunk, a chunk only ever holds complete lines */
+#define RTOS_TRACE_CHUNK_SIZE        1024U
+
+/* export channel of the periodic dump */
+#define RTOS_TRACE_EXPORT_NONE       0U
+#define RTOS_TRACE_EXPORT_UART       1U
+#define RTOS_TRACE_EXPORT_UDP        2U
+#define RTOS_TRACE_EXPORT            RTOS_TRACE_EXPORT_UDP
+/* UDP export goes to IP_S_ADDR0.IP_S_ADDR1.IP_S_ADDR2.IP_S_ADDR3 on this port */
+#define RTOS_TRACE_UDP_PORT          5140U
+
+/* trace event types */
+#define RTOS_TRACE_EVT_TASK_IN       0x01U               /*!< a task was switched in, id is the task number */
+#define RTOS_TRACE_EVT_ISR_ENTER     0x02U               /*!< interrupt handler entered, id is the IRQ number */
+#define RTOS_TRACE_EVT_ISR_EXIT      0x03U               /*!< interrupt handler left, id is the IRQ number */
+#define RTOS_TRACE_EVT_MARK          0x04U               /*!< user mark, id and arg are free */
+#define RTOS_TRACE_EVT_OVERFLOW      0x05U               /*!< stack overflow detected, id is the task number */
+
+/* boot mark ids, the time to the first packet counts from the scheduler start */
+#define RTOS_TRACE_MARK_INIT         0x01U               /*!< init task started */
+#define RTOS_TRACE_MARK_NETIF_UP     0x02U               /*!< ENET and lwIP initialized */
+#define RTOS_TRACE_MARK_FIRST_TX     0x03U               /*!< first frame handed to the Tx DMA, arg is its length */
+#define RTOS_TRACE_MARK_FIRST_RX     0x04U               /*!< first frame received, arg is its length */
+
+/* one recorded event */
+typedef struct {
+    volatile uint32_t seq;                               /*!< slot index + 1 once the event is complete, 0 while it is written */
+    uint32_t timestamp;                                  /*!< run-time counter value */
+    uint8_t type;                                        /*!< RTOS_TRACE_EVT_xxx */
+    uint8_t id;                                          /*!< task or IRQ number */
+    uint16_t arg;                                        /*!< event specific argument */
+} rtos_trace_event_struct;
+
+/* export callback, called with chunks of complete text lines */
+typedef void (*rtos_trace_write_fn)(const char *data, uint16_t len, void *arg);
+
+/* points to the counter register of the run-time TIMER */
+extern volatile uint32_t *const rtos_trace_counter;
+
+/* read the run-time counter */
+#define rtos_trace_timestamp()       (*rtos_trace_counter)
+
+/* interrupt handler instrumentation, IRQ numbers are stored as uint8_t so core exceptions appear as 0xF0 and up */
+#define RTOS_TRACE_ISR_ENTER(irqn)   rtos_trace_event(RTOS_TRACE_EVT_ISR_ENTER, (uint8_t)(irqn), 0U)
+#define RTOS_TRACE_ISR_EXIT(irqn)    rtos_trace_event(RTOS_TRACE_EVT_ISR_EXIT, (uint8_t)(irqn), 0U)
+
+/* function declarations */
+/* configure the free-running run-time TIMER, called by the scheduler */
+void rtos_trace_timer_init(void);
+/* record one event, safe from tasks and from interrupts of any priority */
+void rtos_trace_event(uint8_t type, uint8_t id, uint16_t arg);
+/* record a task switch, called from the traceTASK_SWITCHED_IN hook */
+void rtos_trace_task_switched_in(uint32_t task_number);
+/* write the task statistics and all events recorded since the last dump */
+void rtos_trace_dump(rtos_trace_write_fn write, void *arg);
+/* start the task that exports a dump every RTOS_TRACE_PERIOD_MS */
+void rtos_trace_init(void);
+
+#endif /* RTOS_TRACE_H */
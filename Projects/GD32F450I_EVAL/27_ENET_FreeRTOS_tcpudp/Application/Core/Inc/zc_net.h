@@ -0,0 +1,70 @@
+/*!
+    \file    zc_net.h
+    \brief   the header file of the zero-copy netconn helpers
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef ZC_NET_H
+#define ZC_NET_H
+
+#include "lwip/api.h"
+
+/* most buffers of one zero-copy send */
+#define ZC_SEND_MAX_VECTORS         8U
+/* zero-copy UDP sends in flight, only a limit while MEMP_MEM_MALLOC is 0 */
+#define ZC_SEND_NUM                 8U
+/* zero-copy TCP writes waiting for their acknowledgement */
+#define ZC_TCP_WRITE_NUM            8U
+
+/* called once the stack and the ENET DMA no longer read the buffers of a send */
+typedef void (*zc_release_fn)(void *arg);
+
+/* function declarations */
+/* initialize the zero-copy send pool */
+void zc_net_init(void);
+/* wait for a datagram and borrow its pbuf */
+err_t zc_udp_recv(struct netconn *conn, struct pbuf **p, ip_addr_t *addr, u16_t *port);
+/* send a borrowed pbuf in place to addr and port and give it back */
+err_t zc_udp_reply(struct netconn *conn, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+/* give a borrowed pbuf back */
+void zc_release(struct pbuf *p);
+/* send application buffers as one datagram without copying them, buffers outside the SRAM,
+   such as on a task stack in the TCM, are still copied by ethernetif */
+err_t zc_udp_sendv(struct netconn *conn, const struct netvector *vectors, u16_t count,
+                   const ip_addr_t *addr, u16_t port, zc_release_fn release, void *arg);
+/* queue application buffers on a TCP connection without copying them */
+err_t zc_tcp_writev(struct netconn *conn, struct netvector *vectors, u16_t count, zc_release_fn release, void *arg);
+/* release the buffers of the acknowledged TCP writes */
+void zc_tcp_poll(struct netconn *conn);
+/* wait until all TCP writes of a connection are released, call before netconn_close() */
+void zc_tcp_flush(struct netconn *conn);
+
+#endif /* ZC_NET_H */
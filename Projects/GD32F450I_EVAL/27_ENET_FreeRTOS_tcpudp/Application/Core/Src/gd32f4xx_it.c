@@ -38,6 +38,8 @@ OF SUCH DAMAGE.
 #include "semphr.h"
 #include "queue.h"
 #include "lwip/sys.h"
+#include "rtos_lowpower.h"
+#include "ram_placement.h"
 
 extern xSemaphoreHandle g_rx_semaphore;
 
@@ -125,10 +127,12 @@ void DebugMon_Handler(void)
     \param[out] none
     \retval     none
 */
-void ENET_IRQHandler(void)
+__RAMFUNC void ENET_IRQHandler(void)
 {
     portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 
+    RTOS_TRACE_ISR_ENTER(ENET_IRQn);
+
     /* frame received */
     if(SET == enet_interrupt_flag_get(ENET_DMA_INT_FLAG_RS)) {
         /* give the semaphore to wakeup LwIP task */
@@ -139,8 +143,21 @@ void ENET_IRQHandler(void)
     enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_RS_CLR);
     enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_NI_CLR);
 
+    RTOS_TRACE_ISR_EXIT(ENET_IRQn);
+
     /* switch tasks if necessary */
     if(pdFALSE != xHigherPriorityTaskWoken) {
         portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
     }
 }
+
+/*!
+    \brief      this function handles RTC wakeup interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void RTC_WKUP_IRQHandler(void)
+{
+    rtos_lowpower_rtc_irq_handler();
+}
@@ -40,6 +40,9 @@ OF SUCH DAMAGE.
 #include "hello_gigadevice.h"
 #include "tcp_client.h"
 #include "udp_echo.h"
+#include "rtos_trace.h"
+#include "rtos_lowpower.h"
+#include "zc_net.h"
 
 #define INIT_TASK_PRIO   ( tskIDLE_PRIORITY + 1 )
 #define DHCP_TASK_PRIO   ( tskIDLE_PRIORITY + 4 )
@@ -81,6 +84,8 @@ int main(void)
 */
 void init_task(void *pvParameters)
 {
+    rtos_trace_event(RTOS_TRACE_EVT_MARK, RTOS_TRACE_MARK_INIT, 0U);
+
     gd_eval_com_init(EVAL_COM0);
     gd_eval_led_init(LED3);
 
@@ -89,15 +94,23 @@ void init_task(void *pvParameters)
 
     /* initilaize the LwIP stack */
     lwip_stack_init();
+    zc_net_init();
+    rtos_trace_event(RTOS_TRACE_EVT_MARK, RTOS_TRACE_MARK_NETIF_UP, 0U);
 
 #ifdef USE_DHCP
     /* start DHCP client */
     xTaskCreate(dhcp_task, "DHCP", configMINIMAL_STACK_SIZE * 2, NULL, DHCP_TASK_PRIO, NULL);
 #endif /* USE_DHCP */
 
+    /* the idle task sleeps through the idle periods with the tick suppressed */
+    rtos_lowpower_init();
+
     /* start toogle LED task every 250ms */
     xTaskCreate(led_task, "LED", configMINIMAL_STACK_SIZE, NULL, LED_TASK_PRIO, NULL);
 
+    /* start exporting run-time statistics and trace events */
+    rtos_trace_init();
+
     for(;;) {
         vTaskDelete(NULL);
     }
@@ -128,9 +141,26 @@ void lwip_netif_status_callback(struct netif *netif)
 */
 void led_task(void *pvParameters)
 {
+    uint16_t phy_status = 0U;
+    uint8_t link = 1U;
+
+    /* ENET stops in deep-sleep and loses the frames received meanwhile, deep-sleep
+       is only allowed while the link is down */
+    rtos_lowpower_deep_veto();
+
     for(;;) {
         /* toggle LED3 each 250ms */
         gd_eval_led_toggle(LED3);
+
+        if(SUCCESS == enet_phy_write_read(ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BSR, &phy_status)) {
+            if((0U != (phy_status & PHY_LINKED_STATUS)) && (0U == link)) {
+                rtos_lowpower_deep_veto();
+                link = 1U;
+            } else if((0U == (phy_status & PHY_LINKED_STATUS)) && (0U != link)) {
+                rtos_lowpower_deep_allow();
+                link = 0U;
+            }
+        }
         vTaskDelay(250);
     }
 }
@@ -0,0 +1,539 @@
+/*!
+    \file    mem_region.c
+    \brief   multi-region heap with size-class pools for FreeRTOS and lwIP
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "mem_region.h"
+#include <string.h>
+
+#ifdef MEM_REGION_HOST
+/* built on a PC by Utilities/heap_bench, which is single threaded */
+#define MEM_REGION_LOCK()
+#define MEM_REGION_UNLOCK()
+#else
+#include "FreeRTOS.h"
+#include "task.h"
+/* the same protection as heap_4.c: task context only, never from an interrupt */
+#define MEM_REGION_LOCK()            vTaskSuspendAll()
+#define MEM_REGION_UNLOCK()          (void)xTaskResumeAll()
+#endif /* MEM_REGION_HOST */
+
+/* a block is a header word followed by the payload, blocks start 4 bytes before an 8 byte
+   boundary so that the payload is aligned. the header holds the block size, a multiple of 8,
+   and the flags below. a free block keeps the link to the next free one behind its header */
+#define MEM_USED                     0x1U
+#define MEM_POOL                     0x2U
+#define MEM_SIZE_MASK                (~(MEM_REGION_ALIGN - 1U))
+#define MEM_HEAD_SIZE                4U
+/* smallest arena block, a header and a link */
+#define MEM_BLOCK_MIN                16U
+/* the smallest pool block is 1 << MEM_POOL_SHIFT bytes */
+#define MEM_POOL_SHIFT               4U
+/* links are offsets from the region base, they stay 32 bits wide on a 64-bit host and
+   offset 0 never holds a block */
+#define MEM_NIL                      0U
+
+#define MEM_HEAD(r, off)             (*(uint32_t *)(void *)((r)->base + (off)))
+#define MEM_LINK(r, off)             (*(uint32_t *)(void *)((r)->base + (off) + MEM_HEAD_SIZE))
+
+typedef struct {
+    uint8_t *base;                                       /* aligned to MEM_REGION_ALIGN */
+    uint32_t size;                                       /* the arena ends 4 bytes before base + size */
+    uint32_t free_list;                                  /* free arena blocks in address order */
+    uint32_t pool[MEM_REGION_POOL_CLASSES];              /* free pool blocks of each class */
+    uint32_t arena_free;
+    uint32_t pool_size;
+    uint32_t pool_free;
+    uint32_t free_min;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t misses;
+} mem_region_struct;
+
+static mem_region_struct mem_region[MEM_REGION_NUM];
+static uint32_t mem_free_total_min = 0U;
+
+/* the regions each hint tries, MEM_REGION_NUM ends the list */
+static const uint8_t mem_hint_order[MEM_HINT_NUM][MEM_REGION_NUM] = {
+    {MEM_REGION_SRAM, MEM_REGION_SDRAM, MEM_REGION_NUM},
+    {MEM_REGION_TCM, MEM_REGION_SRAM, MEM_REGION_SDRAM},
+    {MEM_REGION_SDRAM, MEM_REGION_SRAM, MEM_REGION_NUM}
+};
+
+static uint32_t mem_pool_class(uint32_t size);
+static uint32_t mem_arena_take(mem_region_struct *r, uint32_t need);
+static void mem_arena_give(mem_region_struct *r, uint32_t off);
+static uint32_t mem_pool_take(mem_region_struct *r, uint32_t cls);
+static uint32_t mem_pool_refill(mem_region_struct *r, uint32_t cls);
+static mem_region_struct *mem_region_find(const void *mem, uint32_t *off);
+static void mem_free_track(mem_region_struct *r);
+
+/*!
+    \brief      give memory to a region
+    \param[in]  region: MEM_REGION_SRAM, MEM_REGION_TCM or MEM_REGION_SDRAM
+    \param[in]  start: start of the memory, any alignment
+    \param[in]  size: bytes of the memory
+    \param[out] none
+    \retval     usable bytes, 0 if the region is already added or the memory is too small
+*/
+uint32_t mem_region_add(mem_region_enum region, void *start, uint32_t size)
+{
+    mem_region_struct *r;
+    uint32_t pad, cls;
+
+    if(region >= MEM_REGION_NUM) {
+        return 0U;
+    }
+    r = &mem_region[region];
+    pad = (uint32_t)((MEM_REGION_ALIGN - ((uintptr_t)start & (MEM_REGION_ALIGN - 1U))) & (MEM_REGION_ALIGN - 1U));
+    if((0U != r->size) || (size < (pad + 2U * MEM_HEAD_SIZE + MEM_BLOCK_MIN))) {
+        return 0U;
+    }
+    size = (size - pad) & MEM_SIZE_MASK;
+
+    MEM_REGION_LOCK();
+    r->base = (uint8_t *)start + pad;
+    r->size = size;
+    /* one free block from offset 4 to 4 bytes before the end */
+    MEM_HEAD(r, MEM_HEAD_SIZE) = size - 2U * MEM_HEAD_SIZE;
+    MEM_LINK(r, MEM_HEAD_SIZE) = MEM_NIL;
+    r->free_list = MEM_HEAD_SIZE;
+    for(cls = 0U; cls < MEM_REGION_POOL_CLASSES; cls++) {
+        r->pool[cls] = MEM_NIL;
+    }
+    r->arena_free = size - 2U * MEM_HEAD_SIZE;
+    r->pool_size = 0U;
+    r->pool_free = 0U;
+    r->free_min = r->arena_free;
+    mem_free_total_min += r->arena_free;
+    MEM_REGION_UNLOCK();
+
+    return size - 2U * MEM_HEAD_SIZE;
+}
+
+/*!
+    \brief      allocate memory from the first region of the hint that has room
+    \param[in]  size: bytes to allocate
+    \param[in]  hint: MEM_HINT_DMA, MEM_HINT_CPU or MEM_HINT_BULK
+    \param[out] none
+    \retval     the memory aligned to MEM_REGION_ALIGN, NULL if no region has room
+*/
+void *mem_region_alloc(size_t size, mem_hint_enum hint)
+{
+    mem_region_struct *r = NULL;
+    uint32_t off = MEM_NIL;
+    uint32_t need = 0U, cls = 0U, i;
+
+    if((0U == size) || (size > (0x7FFFFFFFU - MEM_REGION_ALIGN)) || (hint >= MEM_HINT_NUM)) {
+        return NULL;
+    }
+    if(size <= MEM_REGION_POOL_MAX) {
+        cls = mem_pool_class((uint32_t)size);
+    } else {
+        need = ((uint32_t)size + MEM_HEAD_SIZE + MEM_REGION_ALIGN - 1U) & MEM_SIZE_MASK;
+    }
+
+    MEM_REGION_LOCK();
+    for(i = 0U; (i < MEM_REGION_NUM) && (MEM_REGION_NUM != mem_hint_order[hint][i]); i++) {
+        r = &mem_region[mem_hint_order[hint][i]];
+        if(0U == r->size) {
+            continue;
+        }
+        off = (0U == need) ? mem_pool_take(r, cls) : mem_arena_take(r, need);
+        if(MEM_NIL != off) {
+            r->allocs++;
+            mem_free_track(r);
+            break;
+        }
+        r->misses++;
+    }
+    MEM_REGION_UNLOCK();
+
+    return (MEM_NIL != off) ? (void *)(r->base + off + MEM_HEAD_SIZE) : NULL;
+}
+
+/*!
+    \brief      allocate zeroed memory for count objects of size bytes
+    \param[in]  count: number of objects
+    \param[in]  size: bytes of one object
+    \param[in]  hint: MEM_HINT_DMA, MEM_HINT_CPU or MEM_HINT_BULK
+    \param[out] none
+    \retval     the memory, NULL if no region has room
+*/
+void *mem_region_calloc(size_t count, size_t size, mem_hint_enum hint)
+{
+    void *mem;
+
+    if((0U != count) && (size > ((size_t)0x7FFFFFFFU / count))) {
+        return NULL;
+    }
+    mem = mem_region_alloc(count * size, hint);
+    if(NULL != mem) {
+        memset(mem, 0, count * size);
+    }
+
+    return mem;
+}
+
+/*!
+    \brief      give a block back to its region
+    \param[in]  mem: block from mem_region_alloc() or mem_region_calloc(), NULL is ignored
+    \param[out] none
+    \retval     none
+*/
+void mem_region_free(void *mem)
+{
+    mem_region_struct *r;
+    uint32_t off, head, bsize, cls;
+
+    if(NULL == mem) {
+        return;
+    }
+
+    MEM_REGION_LOCK();
+    r = mem_region_find(mem, &off);
+    /* blocks of no region and blocks given back twice are left alone */
+    if((NULL != r) && (0U != (MEM_HEAD(r, off) & MEM_USED))) {
+        head = MEM_HEAD(r, off);
+        bsize = head & MEM_SIZE_MASK;
+        if(0U != (head & MEM_POOL)) {
+            cls = mem_pool_class(bsize - MEM_HEAD_SIZE);
+            MEM_HEAD(r, off) = bsize | MEM_POOL;
+            MEM_LINK(r, off) = r->pool[cls];
+            r->pool[cls] = off;
+            r->pool_free += bsize;
+        } else {
+            mem_arena_give(r, off);
+        }
+        r->frees++;
+    }
+    MEM_REGION_UNLOCK();
+}
+
+/*!
+    \brief      the region that holds a block
+    \param[in]  mem: the block
+    \param[out] none
+    \retval     MEM_REGION_SRAM, MEM_REGION_TCM, MEM_REGION_SDRAM or MEM_REGION_NUM if none
+*/
+mem_region_enum mem_region_of(const void *mem)
+{
+    mem_region_struct *r;
+    uint32_t off;
+
+    r = mem_region_find(mem, &off);
+
+    return (NULL != r) ? (mem_region_enum)(r - mem_region) : MEM_REGION_NUM;
+}
+
+/*!
+    \brief      read the statistics of a region, walks the free arena blocks
+    \param[in]  region: MEM_REGION_SRAM, MEM_REGION_TCM or MEM_REGION_SDRAM
+    \param[out] stat: the statistics, all 0 for a region that is not added
+    \retval     none
+*/
+void mem_region_stat_get(mem_region_enum region, mem_region_stat_struct *stat)
+{
+    mem_region_struct *r;
+    uint32_t off, bsize;
+
+    memset(stat, 0, sizeof(*stat));
+    if(region >= MEM_REGION_NUM) {
+        return;
+    }
+    r = &mem_region[region];
+    if(0U == r->size) {
+        return;
+    }
+
+    MEM_REGION_LOCK();
+    for(off = r->free_list; MEM_NIL != off; off = MEM_LINK(r, off)) {
+        bsize = MEM_HEAD(r, off);
+        if(bsize > stat->largest) {
+            stat->largest = bsize;
+        }
+        stat->free_blocks++;
+    }
+    /* the largest request the block serves */
+    if(0U != stat->largest) {
+        stat->largest -= MEM_HEAD_SIZE;
+    }
+    if(0U != r->arena_free) {
+        stat->frag = 1000U - (uint32_t)(((uint64_t)(stat->largest + MEM_HEAD_SIZE) * 1000U) / r->arena_free);
+    }
+    stat->size = r->size - 2U * MEM_HEAD_SIZE;
+    stat->free = r->arena_free + r->pool_free;
+    stat->free_min = r->free_min;
+    stat->pool_size = r->pool_size;
+    stat->pool_free = r->pool_free;
+    stat->allocs = r->allocs;
+    stat->frees = r->frees;
+    stat->misses = r->misses;
+    MEM_REGION_UNLOCK();
+}
+
+/*!
+    \brief      free bytes of all regions
+    \param[in]  none
+    \param[out] none
+    \retval     free bytes in the arenas and the pools
+*/
+uint32_t mem_region_free_get(void)
+{
+    uint32_t i, total = 0U;
+
+    for(i = 0U; i < MEM_REGION_NUM; i++) {
+        total += mem_region[i].arena_free + mem_region[i].pool_free;
+    }
+
+    return total;
+}
+
+/*!
+    \brief      lowest free bytes of all regions together since they were added
+    \param[in]  none
+    \param[out] none
+    \retval     the low-water mark
+*/
+uint32_t mem_region_free_min_get(void)
+{
+    return mem_free_total_min;
+}
+
+/*!
+    \brief      the pool class of a request
+    \param[in]  size: bytes requested, at most MEM_REGION_POOL_MAX
+    \param[out] none
+    \retval     the class, its blocks are 16 << class bytes
+*/
+static uint32_t mem_pool_class(uint32_t size)
+{
+    uint32_t need = size + MEM_HEAD_SIZE;
+
+    if(need <= (1U << MEM_POOL_SHIFT)) {
+        return 0U;
+    }
+
+    /* the next power of two */
+    return (32U - (uint32_t)__builtin_clz(need - 1U)) - MEM_POOL_SHIFT;
+}
+
+/*!
+    \brief      take a block from the arena, first fit in address order
+    \param[in]  r: the region
+    \param[in]  need: block size with the header, a multiple of 8
+    \param[out] none
+    \retval     offset of the block, MEM_NIL if no free block is large enough
+*/
+static uint32_t mem_arena_take(mem_region_struct *r, uint32_t need)
+{
+    uint32_t prev = MEM_NIL, off = r->free_list;
+    uint32_t bsize, next, rest;
+
+    while(MEM_NIL != off) {
+        bsize = MEM_HEAD(r, off);
+        if(bsize >= need) {
+            next = MEM_LINK(r, off);
+            /* split, the tail keeps the place of the block in the list */
+            if((bsize - need) >= MEM_BLOCK_MIN) {
+                rest = off + need;
+                MEM_HEAD(r, rest) = bsize - need;
+                MEM_LINK(r, rest) = next;
+                next = rest;
+                bsize = need;
+            }
+            if(MEM_NIL == prev) {
+                r->free_list = next;
+            } else {
+                MEM_LINK(r, prev) = next;
+            }
+            MEM_HEAD(r, off) = bsize | MEM_USED;
+            r->arena_free -= bsize;
+            return off;
+        }
+        prev = off;
+        off = MEM_LINK(r, off);
+    }
+
+    return MEM_NIL;
+}
+
+/*!
+    \brief      give a block back to the arena and merge it with its free neighbours
+    \param[in]  r: the region
+    \param[in]  off: offset of the block
+    \param[out] none
+    \retval     none
+*/
+static void mem_arena_give(mem_region_struct *r, uint32_t off)
+{
+    uint32_t bsize = MEM_HEAD(r, off) & MEM_SIZE_MASK;
+    uint32_t prev = MEM_NIL, next = r->free_list;
+
+    r->arena_free += bsize;
+    while((MEM_NIL != next) && (next < off)) {
+        prev = next;
+        next = MEM_LINK(r, next);
+    }
+
+    if((MEM_NIL != next) && ((off + bsize) == next)) {
+        bsize += MEM_HEAD(r, next);
+        next = MEM_LINK(r, next);
+    }
+    if((MEM_NIL != prev) && ((prev + MEM_HEAD(r, prev)) == off)) {
+        MEM_HEAD(r, prev) += bsize;
+        MEM_LINK(r, prev) = next;
+    } else {
+        MEM_HEAD(r, off) = bsize;
+        MEM_LINK(r, off) = next;
+        if(MEM_NIL == prev) {
+            r->free_list = off;
+        } else {
+            MEM_LINK(r, prev) = off;
+        }
+    }
+}
+
+/*!
+    \brief      take a block from a pool, refill the pool from the arena when it is empty
+    \param[in]  r: the region
+    \param[in]  cls: the pool class
+    \param[out] none
+    \retval     offset of the block, MEM_NIL if neither the pool nor the arena has one
+*/
+static uint32_t mem_pool_take(mem_region_struct *r, uint32_t cls)
+{
+    uint32_t off = r->pool[cls];
+
+    if((MEM_NIL == off) && (0U != mem_pool_refill(r, cls))) {
+        off = r->pool[cls];
+    }
+    if(MEM_NIL == off) {
+        /* the pools reached their share of the arena */
+        return mem_arena_take(r, 1U << (cls + MEM_POOL_SHIFT));
+    }
+    r->pool[cls] = MEM_LINK(r, off);
+    MEM_HEAD(r, off) |= MEM_USED;
+    r->pool_free -= MEM_HEAD(r, off) & MEM_SIZE_MASK;
+
+    return off;
+}
+
+/*!
+    \brief      cut an arena block into blocks of a pool class
+    \param[in]  r: the region
+    \param[in]  cls: the pool class
+    \param[out] none
+    \retval     number of blocks added to the pool
+*/
+static uint32_t mem_pool_refill(mem_region_struct *r, uint32_t cls)
+{
+    uint32_t bsize = 1U << (cls + MEM_POOL_SHIFT);
+    uint32_t count = MEM_REGION_POOL_REFILL / bsize;
+    uint32_t cap = (r->size / 100U) * MEM_REGION_POOL_SHARE;
+    uint32_t slab, slab_size, off, i;
+
+    if((r->pool_size + bsize + 2U * MEM_HEAD_SIZE) > cap) {
+        return 0U;
+    }
+    if((r->pool_size + count * bsize + 2U * MEM_HEAD_SIZE) > cap) {
+        count = (cap - r->pool_size - 2U * MEM_HEAD_SIZE) / bsize;
+    }
+    /* the pool blocks follow the header of the arena block and 4 bytes of padding, which
+       puts them 4 bytes before an 8 byte boundary again */
+    slab = mem_arena_take(r, count * bsize + 2U * MEM_HEAD_SIZE);
+    if(MEM_NIL == slab) {
+        /* a single block when the arena is tight */
+        count = 1U;
+        slab = mem_arena_take(r, bsize + 2U * MEM_HEAD_SIZE);
+        if(MEM_NIL == slab) {
+            return 0U;
+        }
+    }
+    slab_size = MEM_HEAD(r, slab) & MEM_SIZE_MASK;
+    count = (slab_size - 2U * MEM_HEAD_SIZE) / bsize;
+    r->pool_size += slab_size;
+    r->pool_free += count * bsize;
+
+    /* link the blocks in address order */
+    for(i = count; i > 0U; i--) {
+        off = slab + 2U * MEM_HEAD_SIZE + (i - 1U) * bsize;
+        MEM_HEAD(r, off) = bsize | MEM_POOL;
+        MEM_LINK(r, off) = r->pool[cls];
+        r->pool[cls] = off;
+    }
+
+    return count;
+}
+
+/*!
+    \brief      find the region and the block offset of a payload pointer
+    \param[in]  mem: the payload
+    \param[out] off: offset of the block header in the region
+    \retval     the region, NULL if mem is in none
+*/
+static mem_region_struct *mem_region_find(const void *mem, uint32_t *off)
+{
+    uintptr_t addr = (uintptr_t)mem;
+    uint32_t i;
+
+    for(i = 0U; i < MEM_REGION_NUM; i++) {
+        mem_region_struct *r = &mem_region[i];
+
+        if((0U != r->size) && (addr >= ((uintptr_t)r->base + 2U * MEM_HEAD_SIZE)) &&
+           (addr < ((uintptr_t)r->base + r->size))) {
+            *off = (uint32_t)(addr - (uintptr_t)r->base) - MEM_HEAD_SIZE;
+            return r;
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+    \brief      update the low-water marks after an allocation
+    \param[in]  r: the region the allocation came from
+    \param[out] none
+    \retval     none
+*/
+static void mem_free_track(mem_region_struct *r)
+{
+    uint32_t free = r->arena_free + r->pool_free;
+    uint32_t total = mem_region_free_get();
+
+    if(free < r->free_min) {
+        r->free_min = free;
+    }
+    if(total < mem_free_total_min) {
+        mem_free_total_min = total;
+    }
+}
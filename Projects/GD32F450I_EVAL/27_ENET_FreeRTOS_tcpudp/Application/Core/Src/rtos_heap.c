@@ -0,0 +1,139 @@
+/*!
+    \file    rtos_heap.c
+    \brief   FreeRTOS heap on the SRAM and TCM regions of mem_region.c
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "mem_region.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS allocates task stacks, TCBs, queues and semaphores, no DMA reads or writes them,
+   so they go to the TCM first. a buffer on a task stack must therefore not be given to a DMA */
+#define RTOS_HEAP_HINT               MEM_HINT_CPU
+
+/* the SRAM region, the lwIP heap and the lwIP pools come from it as well (lwipopts.h) */
+static uint64_t rtos_heap_sram[configTOTAL_HEAP_SIZE / sizeof(uint64_t)];
+/* the part of the TCM behind the .tcmram section, from the linker script */
+extern uint8_t _stcmheap[];
+extern uint8_t _etcmheap[];
+static uint8_t rtos_heap_ready = 0U;
+
+static void rtos_heap_init(void);
+
+/*!
+    \brief      allocate memory for FreeRTOS, replaces heap_4.c
+    \param[in]  xWantedSize: bytes to allocate
+    \param[out] none
+    \retval     the memory, NULL if no region has room
+*/
+void *pvPortMalloc(size_t xWantedSize)
+{
+    void *mem;
+
+    /* the first call comes from xTaskCreate() in main(), before lwIP runs */
+    if(0U == rtos_heap_ready) {
+        rtos_heap_init();
+    }
+
+    mem = mem_region_alloc(xWantedSize, RTOS_HEAP_HINT);
+    traceMALLOC(mem, xWantedSize);
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+    if(NULL == mem) {
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif /* configUSE_MALLOC_FAILED_HOOK */
+
+    return mem;
+}
+
+/*!
+    \brief      free memory of pvPortMalloc()
+    \param[in]  pv: the memory, NULL is ignored
+    \param[out] none
+    \retval     none
+*/
+void vPortFree(void *pv)
+{
+    if(NULL != pv) {
+        traceFREE(pv, 0U);
+        mem_region_free(pv);
+    }
+}
+
+/*!
+    \brief      free bytes of all regions, lwIP included
+    \param[in]  none
+    \param[out] none
+    \retval     free bytes
+*/
+size_t xPortGetFreeHeapSize(void)
+{
+    return mem_region_free_get();
+}
+
+/*!
+    \brief      lowest free bytes of all regions since the start
+    \param[in]  none
+    \param[out] none
+    \retval     the low-water mark
+*/
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return mem_region_free_min_get();
+}
+
+/*!
+    \brief      nothing to do, the regions are set up by the first pvPortMalloc()
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void vPortInitialiseBlocks(void)
+{
+}
+
+/*!
+    \brief      add the SRAM and TCM regions
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void rtos_heap_init(void)
+{
+    mem_region_add(MEM_REGION_SRAM, rtos_heap_sram, sizeof(rtos_heap_sram));
+    mem_region_add(MEM_REGION_TCM, _stcmheap, (uint32_t)(_etcmheap - _stcmheap));
+    /* the SDRAM of the board shares PC5 with the ENET RMII and is not set up here, a demo
+       that initializes it adds it with mem_region_add(MEM_REGION_SDRAM, ...) */
+    rtos_heap_ready = 1U;
+}
@@ -0,0 +1,551 @@
+/*!
+    \file    rtos_lowpower.c
+    \brief   FreeRTOS tickless idle with RTC wakeup, sleep and deep-sleep
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "rtos_lowpower.h"
+#include "gd32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* the RTC wakeup handler does not call FreeRTOS, any priority works */
+#define LOWPOWER_RTC_IRQ_PRIO       15U
+#define LOWPOWER_RTC_SHIFT          14U
+/* the wakeup timer counts at RTOS_LOWPOWER_RTC_HZ and reloads 16 bits, 4s at most */
+#define LOWPOWER_WAKEUP_MAX         0x10000U
+#define LOWPOWER_MAX_TICKS          ((LOWPOWER_WAKEUP_MAX * configTICK_RATE_HZ) / RTOS_LOWPOWER_RTC_HZ)
+/* the sub-second counter together with the minutes and seconds of the calendar wraps after one hour */
+#define LOWPOWER_RTC_WRAP           (3600U * RTOS_LOWPOWER_RTC_HZ)
+#define LOWPOWER_NO_CONSTRAINT      0xFFFFFFFFU
+
+#if (1U == RTOS_LOWPOWER_DEEP_LDO_LOWPOWER)
+#define LOWPOWER_DEEP_LDO           PMU_LDO_LOWPOWER
+#else
+#define LOWPOWER_DEEP_LDO           PMU_LDO_NORMAL
+#endif /* RTOS_LOWPOWER_DEEP_LDO_LOWPOWER */
+
+/* the idle time is accounted in units of 1 / (RTOS_LOWPOWER_RTC_HZ * configTICK_RATE_HZ) seconds:
+   a tick is RTOS_LOWPOWER_RTC_HZ units and an RTC count configTICK_RATE_HZ units, so converting
+   between the two never rounds */
+
+static uint8_t lowpower_ready = 0U;
+/* deep-sleep vetoes, nested */
+static uint32_t lowpower_veto = 0U;
+/* wakeup latency constraints in us, LOWPOWER_NO_CONSTRAINT marks a free slot */
+static uint32_t lowpower_constraint[RTOS_LOWPOWER_CONSTRAINTS];
+static uint32_t lowpower_sdram = RTOS_LOWPOWER_SDRAM_NONE;
+/* deep-sleep wakeup latency estimate, the highest one measured */
+static uint32_t lowpower_latency_us = RTOS_LOWPOWER_DEEP_LATENCY_US;
+static uint8_t lowpower_latency_measured = 0U;
+static rtos_lowpower_stats_struct lowpower_stats;
+
+static uint32_t lowpower_rtc_counts(void);
+static void lowpower_wakeup_start(uint32_t counts);
+static uint32_t lowpower_constraint_min(void);
+static void lowpower_deep_enter(void);
+static void lowpower_clock_restore(uint32_t ctl, uint32_t cfg0, uint32_t pmu_ctl);
+static void lowpower_sdram_command(uint32_t command, uint32_t status);
+
+/*!
+    \brief      configure the RTC time base and wakeup timer
+    \param[in]  none
+    \param[out] none
+    \retval     0, or -1 if LXTAL or the RTC does not start
+*/
+int32_t rtos_lowpower_init(void)
+{
+    rtc_parameter_struct rtc_initpara;
+    uint32_t i;
+
+    for(i = 0U; i < RTOS_LOWPOWER_CONSTRAINTS; i++) {
+        lowpower_constraint[i] = LOWPOWER_NO_CONSTRAINT;
+    }
+
+    rcu_periph_clock_enable(RCU_PMU);
+    pmu_backup_write_enable();
+
+    rcu_osci_on(RCU_LXTAL);
+    if(ERROR == rcu_osci_stab_wait(RCU_LXTAL)) {
+        return -1;
+    }
+    rcu_rtc_clock_config(RCU_RTCSRC_LXTAL);
+    rcu_periph_clock_enable(RCU_RTC);
+    rtc_register_sync_wait();
+
+    /* a calendar that already runs with these prescalers is kept */
+    if((PSC_FACTOR_A(1U) | PSC_FACTOR_S(RTOS_LOWPOWER_RTC_HZ - 1U)) != RTC_PSC) {
+        rtc_initpara.factor_asyn = 1U;
+        rtc_initpara.factor_syn = (uint16_t)(RTOS_LOWPOWER_RTC_HZ - 1U);
+        rtc_initpara.year = 0x24U;
+        rtc_initpara.day_of_week = RTC_FRIDAY;
+        rtc_initpara.month = RTC_DEC;
+        rtc_initpara.date = 0x20U;
+        rtc_initpara.display_format = RTC_24HOUR;
+        rtc_initpara.am_pm = RTC_AM;
+        rtc_initpara.hour = 0U;
+        rtc_initpara.minute = 0U;
+        rtc_initpara.second = 0U;
+        if(ERROR == rtc_init(&rtc_initpara)) {
+            return -1;
+        }
+    }
+    /* read the counters instead of the shadow registers, which only follow every two RTC clocks */
+    rtc_bypass_shadow_enable();
+
+    /* the wakeup timer counts RTCCLK / 2, the rate of the sub-second counter */
+    rtc_wakeup_disable();
+    rtc_wakeup_clock_set(WAKEUP_RTCCK_DIV2);
+    rtc_flag_clear(RTC_FLAG_WT);
+
+    /* the wakeup event reaches the NVIC through EXTI line 22, which also works in deep-sleep */
+    exti_init(EXTI_22, EXTI_INTERRUPT, EXTI_TRIG_RISING);
+    exti_interrupt_flag_clear(EXTI_22);
+    rtc_interrupt_enable(RTC_INT_WAKEUP);
+    nvic_irq_enable(RTC_WKUP_IRQn, LOWPOWER_RTC_IRQ_PRIO, 0U);
+
+    lowpower_ready = 1U;
+
+    return 0;
+}
+
+/*!
+    \brief      sleep for up to expected_ticks ticks with the tick suppressed, called
+                by the idle task through portSUPPRESS_TICKS_AND_SLEEP() with the scheduler suspended
+    \param[in]  expected_ticks: ticks until the next task has to run
+    \param[out] none
+    \retval     none
+*/
+void rtos_lowpower_idle(uint32_t expected_ticks)
+{
+    uint32_t cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+    uint32_t partial, start, units, counts, latency, elapsed, ticks, load;
+    uint8_t deep = 0U;
+    FlagStatus woken;
+
+    if(0U == lowpower_ready) {
+        /* no time base, sleep until the next tick */
+        __DSB();
+        __WFI();
+        return;
+    }
+
+    if(expected_ticks > LOWPOWER_MAX_TICKS) {
+        expected_ticks = LOWPOWER_MAX_TICKS;
+    }
+
+    /* PRIMASK keeps the interrupts that end the sleep pending until the tick count is corrected */
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    /* a task became ready or a tick is pending, do not sleep */
+    if((eAbortSleep == eTaskConfirmSleepModeStatus()) || (0U != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))) {
+        __enable_irq();
+        return;
+    }
+
+    /* stop the tick, and time stamp the part of the current tick that has passed */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    partial = SysTick->LOAD - SysTick->VAL;
+    start = lowpower_rtc_counts();
+    units = (uint32_t)(((uint64_t)partial << LOWPOWER_RTC_SHIFT) / cycles_per_tick);
+
+    /* RTC counts until the expected tick, rounded down so the sleep never ends late */
+    counts = ((expected_ticks << LOWPOWER_RTC_SHIFT) - units) / configTICK_RATE_HZ;
+    if(0U == counts) {
+        counts = 1U;
+    }
+
+    /* deep-sleep is worth it for long idle periods, and is woken early by the wakeup latency */
+    latency = (uint32_t)(((uint64_t)lowpower_latency_us << LOWPOWER_RTC_SHIFT) / 1000000U) + 1U;
+    if((expected_ticks >= pdMS_TO_TICKS(RTOS_LOWPOWER_DEEP_MIN_MS)) && (counts > 2U * latency)) {
+        if((0U != lowpower_veto) || (lowpower_latency_us > lowpower_constraint_min())) {
+            lowpower_stats.deep_vetoed++;
+        } else {
+            deep = 1U;
+            counts -= latency;
+        }
+    }
+
+    lowpower_wakeup_start(counts);
+
+    if(0U != deep) {
+        lowpower_deep_enter();
+    } else {
+        __DSB();
+        __WFI();
+        __ISB();
+    }
+
+    /* the wakeup timer, or any other interrupt, ended the sleep */
+    woken = rtc_flag_get(RTC_FLAG_WT);
+    rtc_wakeup_disable();
+    rtc_flag_clear(RTC_FLAG_WT);
+    exti_interrupt_flag_clear(EXTI_22);
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
+    elapsed = lowpower_rtc_counts() + LOWPOWER_RTC_WRAP - start;
+    if(elapsed >= LOWPOWER_RTC_WRAP) {
+        elapsed -= LOWPOWER_RTC_WRAP;
+    }
+
+    /* the time from the wakeup timer to here is the deep-sleep wakeup latency, the clock
+       restart included */
+    if((0U != deep) && (RESET != woken) && (elapsed >= counts)) {
+        lowpower_stats.latency_last_us = ((elapsed - counts) * 15625U) >> 8U;
+        if(lowpower_stats.latency_last_us > lowpower_stats.latency_max_us) {
+            lowpower_stats.latency_max_us = lowpower_stats.latency_last_us;
+        }
+        if((0U == lowpower_latency_measured) || (lowpower_stats.latency_last_us > lowpower_latency_us)) {
+            lowpower_latency_us = lowpower_stats.latency_last_us;
+            lowpower_latency_measured = 1U;
+        }
+    }
+
+    units += elapsed * configTICK_RATE_HZ;
+    ticks = units >> LOWPOWER_RTC_SHIFT;
+    units &= RTOS_LOWPOWER_RTC_HZ - 1U;
+
+    if(ticks >= expected_ticks) {
+        /* the expected tick has passed, it is handled by the tick interrupt as soon as
+           the interrupts are enabled. a longer overshoot is lost to the kernel time */
+        ticks = expected_ticks - 1U;
+        load = cycles_per_tick;
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    } else {
+        /* the next tick comes after the rest of the current tick period */
+        load = cycles_per_tick - (uint32_t)(((uint64_t)units * cycles_per_tick) >> LOWPOWER_RTC_SHIFT);
+        if(load < 2U) {
+            load = 2U;
+        }
+    }
+
+    /* restart the tick, the reload value takes effect after the first period */
+    SysTick->LOAD = load - 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = cycles_per_tick - 1U;
+
+    vTaskStepTick(ticks);
+
+    if(0U != deep) {
+        lowpower_stats.deep_count++;
+        lowpower_stats.deep_ticks += ticks;
+    } else {
+        lowpower_stats.sleep_count++;
+        lowpower_stats.sleep_ticks += ticks;
+    }
+
+    __enable_irq();
+}
+
+/*!
+    \brief      forbid deep-sleep until the matching rtos_lowpower_deep_allow(), calls nest
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_lowpower_deep_veto(void)
+{
+    taskENTER_CRITICAL();
+    lowpower_veto++;
+    taskEXIT_CRITICAL();
+}
+
+/*!
+    \brief      allow deep-sleep again
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_lowpower_deep_allow(void)
+{
+    taskENTER_CRITICAL();
+    if(0U != lowpower_veto) {
+        lowpower_veto--;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*!
+    \brief      only use deep-sleep while its wakeup latency stays below max_us
+    \param[in]  max_us: wakeup latency the caller can tolerate, in microseconds
+    \param[out] none
+    \retval     handle of the constraint, or -1 if all slots are used
+*/
+int32_t rtos_lowpower_latency_request(uint32_t max_us)
+{
+    int32_t handle = -1;
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    for(i = 0U; i < RTOS_LOWPOWER_CONSTRAINTS; i++) {
+        if(LOWPOWER_NO_CONSTRAINT == lowpower_constraint[i]) {
+            lowpower_constraint[i] = (LOWPOWER_NO_CONSTRAINT == max_us) ? (max_us - 1U) : max_us;
+            handle = (int32_t)i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return handle;
+}
+
+/*!
+    \brief      remove a latency constraint
+    \param[in]  handle: handle returned by rtos_lowpower_latency_request()
+    \param[out] none
+    \retval     none
+*/
+void rtos_lowpower_latency_release(int32_t handle)
+{
+    if((handle >= 0) && ((uint32_t)handle < RTOS_LOWPOWER_CONSTRAINTS)) {
+        taskENTER_CRITICAL();
+        lowpower_constraint[handle] = LOWPOWER_NO_CONSTRAINT;
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*!
+    \brief      put an SDRAM device into self-refresh during deep-sleep, the idle
+                task stack and the code run until the wakeup must not be in that SDRAM
+    \param[in]  sdram_device: EXMC_SDRAM_DEVICE0, EXMC_SDRAM_DEVICE1 or RTOS_LOWPOWER_SDRAM_NONE
+    \param[out] none
+    \retval     none
+*/
+void rtos_lowpower_sdram_set(uint32_t sdram_device)
+{
+    taskENTER_CRITICAL();
+    lowpower_sdram = sdram_device;
+    taskEXIT_CRITICAL();
+}
+
+/*!
+    \brief      get the deep-sleep wakeup latency estimate
+    \param[in]  none
+    \param[out] none
+    \retval     the highest wakeup latency measured, in microseconds
+*/
+uint32_t rtos_lowpower_latency_get(void)
+{
+    return lowpower_latency_us;
+}
+
+/*!
+    \brief      read the low power statistics
+    \param[in]  none
+    \param[out] stats: the statistics
+    \retval     none
+*/
+void rtos_lowpower_stats_get(rtos_lowpower_stats_struct *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = lowpower_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*!
+    \brief      RTC wakeup interrupt handler, the idle task clears the wakeup itself,
+                so this only runs for a wakeup that raced with its end
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_lowpower_rtc_irq_handler(void)
+{
+    if(RESET != rtc_flag_get(RTC_FLAG_WT)) {
+        rtc_flag_clear(RTC_FLAG_WT);
+    }
+    exti_interrupt_flag_clear(EXTI_22);
+}
+
+/*!
+    \brief      read the RTC time base
+    \param[in]  none
+    \param[out] none
+    \retval     RTC counts since the start of the hour
+*/
+static uint32_t lowpower_rtc_counts(void)
+{
+    uint32_t ss, time, seconds;
+
+    /* the counters are read directly, a count between the two reads of SS makes
+       the time register suspect */
+    do {
+        ss = RTC_SS;
+        time = RTC_TIME;
+    } while(ss != RTC_SS);
+
+    seconds = (((time >> 12U) & 0x7U) * 10U + ((time >> 8U) & 0xFU)) * 60U +
+              ((time >> 4U) & 0x7U) * 10U + (time & 0xFU);
+
+    /* the sub-second counter counts down */
+    return seconds * RTOS_LOWPOWER_RTC_HZ + (RTOS_LOWPOWER_RTC_HZ - 1U - (ss & RTC_SS_SSC));
+}
+
+/*!
+    \brief      start the wakeup timer
+    \param[in]  counts: RTC counts until the wakeup, 1 to LOWPOWER_WAKEUP_MAX
+    \param[out] none
+    \retval     none
+*/
+static void lowpower_wakeup_start(uint32_t counts)
+{
+    if(counts > LOWPOWER_WAKEUP_MAX) {
+        counts = LOWPOWER_WAKEUP_MAX;
+    }
+
+    /* the timer is stopped since the last wakeup, the reload value is counts - 1 */
+    rtc_wakeup_timer_set((uint16_t)(counts - 1U));
+    rtc_flag_clear(RTC_FLAG_WT);
+    exti_interrupt_flag_clear(EXTI_22);
+    rtc_wakeup_enable();
+}
+
+/*!
+    \brief      get the tightest wakeup latency constraint
+    \param[in]  none
+    \param[out] none
+    \retval     the constraint in microseconds, LOWPOWER_NO_CONSTRAINT if there is none
+*/
+static uint32_t lowpower_constraint_min(void)
+{
+    uint32_t min = LOWPOWER_NO_CONSTRAINT;
+    uint32_t i;
+
+    for(i = 0U; i < RTOS_LOWPOWER_CONSTRAINTS; i++) {
+        if(lowpower_constraint[i] < min) {
+            min = lowpower_constraint[i];
+        }
+    }
+
+    return min;
+}
+
+/*!
+    \brief      enter deep-sleep and restore the clocks after the wakeup
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void lowpower_deep_enter(void)
+{
+    uint32_t ctl = RCU_CTL;
+    uint32_t cfg0 = RCU_CFG0;
+    uint32_t pmu_ctl = PMU_CTL;
+
+    /* the SDRAM refreshes itself while the EXMC clock is stopped */
+    if(RTOS_LOWPOWER_SDRAM_NONE != lowpower_sdram) {
+        lowpower_sdram_command(EXMC_SDRAM_SELF_REFRESH, EXMC_SDRAM_DEVICE_SELF_REFRESH);
+    }
+
+    /* masks all interrupts but the wakeup sources in the NVIC until the wakeup */
+    pmu_to_deepsleepmode(LOWPOWER_DEEP_LDO, PMU_LOWDRIVER_DISABLE, WFI_CMD);
+
+    lowpower_clock_restore(ctl, cfg0, pmu_ctl);
+
+    if(RTOS_LOWPOWER_SDRAM_NONE != lowpower_sdram) {
+        lowpower_sdram_command(EXMC_SDRAM_NORMAL_OPERATION, EXMC_SDRAM_DEVICE_NORMAL);
+    }
+}
+
+/*!
+    \brief      restore the clocks stopped by deep-sleep, which leaves the system on IRC16M
+    \param[in]  ctl: RCU_CTL before deep-sleep
+    \param[in]  cfg0: RCU_CFG0 before deep-sleep
+    \param[in]  pmu_ctl: PMU_CTL before deep-sleep
+    \param[out] none
+    \retval     none
+*/
+static void lowpower_clock_restore(uint32_t ctl, uint32_t cfg0, uint32_t pmu_ctl)
+{
+    if(0U != (ctl & RCU_CTL_HXTALEN)) {
+        rcu_osci_on(RCU_HXTAL);
+        while(ERROR == rcu_osci_stab_wait(RCU_HXTAL)) {
+        }
+    }
+    if(0U != (ctl & RCU_CTL_PLLEN)) {
+        rcu_osci_on(RCU_PLL_CK);
+        while(ERROR == rcu_osci_stab_wait(RCU_PLL_CK)) {
+        }
+    }
+    if(0U != (ctl & RCU_CTL_PLLI2SEN)) {
+        rcu_osci_on(RCU_PLLI2S_CK);
+        while(ERROR == rcu_osci_stab_wait(RCU_PLLI2S_CK)) {
+        }
+    }
+    if(0U != (ctl & RCU_CTL_PLLSAIEN)) {
+        rcu_osci_on(RCU_PLLSAI_CK);
+        while(ERROR == rcu_osci_stab_wait(RCU_PLLSAI_CK)) {
+        }
+    }
+
+    /* the high-drive mode is needed above 168MHz */
+    if(0U != (pmu_ctl & PMU_CTL_HDS)) {
+        PMU_CTL |= PMU_CTL_HDEN;
+        while(0U == (PMU_CS & PMU_CS_HDRF)) {
+        }
+        PMU_CTL |= PMU_CTL_HDS;
+        while(0U == (PMU_CS & PMU_CS_HDSRF)) {
+        }
+    }
+
+    /* switch back to the system clock used before */
+    RCU_CFG0 = (RCU_CFG0 & ~RCU_CFG0_SCS) | (cfg0 & RCU_CFG0_SCS);
+    while((RCU_CFG0 & RCU_CFG0_SCSS) != ((cfg0 & RCU_CFG0_SCS) << 2U)) {
+    }
+}
+
+/*!
+    \brief      send a command to the SDRAM device and wait for its new status
+    \param[in]  command: EXMC_SDRAM_SELF_REFRESH or EXMC_SDRAM_NORMAL_OPERATION
+    \param[in]  status: EXMC_SDRAM_DEVICE_SELF_REFRESH or EXMC_SDRAM_DEVICE_NORMAL
+    \param[out] none
+    \retval     none
+*/
+static void lowpower_sdram_command(uint32_t command, uint32_t status)
+{
+    exmc_sdram_command_parameter_struct sdram_command;
+
+    sdram_command.command = command;
+    sdram_command.bank_select = (EXMC_SDRAM_DEVICE0 == lowpower_sdram) ? EXMC_SDRAM_DEVICE0_SELECT : EXMC_SDRAM_DEVICE1_SELECT;
+    sdram_command.auto_refresh_number = EXMC_SDRAM_AUTO_REFLESH_1_SDCLK;
+    sdram_command.mode_register_content = 0U;
+
+    while(RESET != exmc_flag_get(lowpower_sdram, EXMC_SDRAM_FLAG_NREADY)) {
+    }
+    exmc_sdram_command_config(&sdram_command);
+    while(RESET != exmc_flag_get(lowpower_sdram, EXMC_SDRAM_FLAG_NREADY)) {
+    }
+    while(status != exmc_sdram_bankstatus_get(lowpower_sdram)) {
+    }
+}
@@ -0,0 +1,411 @@
+/*!
+    \file    rtos_trace.c
+    \brief   FreeRTOS run-time statistics and trace recorder
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "rtos_trace.h"
+#include "main.h"
+#include "mem_region.h"
+#include "ram_placement.h"
+#include "gd32f450i_eval.h"
+#include "lwip/api.h"
+#include <stdio.h>
+#include <string.h>
+
+#define RTOS_TRACE_TIMER            TIMER1
+#define RTOS_TRACE_TASK_PRIO        ( tskIDLE_PRIORITY + 1 )
+#define RTOS_TRACE_LINE_SIZE        128U
+
+volatile uint32_t *const rtos_trace_counter = &TIMER_CNT(RTOS_TRACE_TIMER);
+
+/* flight recorder, the newest RTOS_TRACE_RING_SIZE events are kept, only the CPU reads it */
+__TCM_BSS static rtos_trace_event_struct trace_ring[RTOS_TRACE_RING_SIZE];
+/* next slot to reserve, only ever incremented */
+static volatile uint32_t trace_head = 0U;
+/* next slot to export */
+static uint32_t trace_tail = 0U;
+/* events overwritten before they were exported */
+static uint32_t trace_lost = 0U;
+
+/* context switches per task number */
+static volatile uint32_t trace_switches[RTOS_TRACE_MAX_TASKS];
+/* run time per task number at the previous dump */
+static uint32_t trace_last_runtime[RTOS_TRACE_MAX_TASKS];
+static uint32_t trace_last_total = 0U;
+
+static TaskStatus_t trace_status[RTOS_TRACE_MAX_TASKS];
+static char trace_chunk[RTOS_TRACE_CHUNK_SIZE];
+static uint16_t trace_chunk_len = 0U;
+
+static uint32_t trace_timer_clock(void);
+static uint32_t trace_task_slot(uint32_t task_number);
+static void trace_put(rtos_trace_write_fn write, void *arg, const char *line, int len);
+static void trace_uart_write(const char *data, uint16_t len, void *arg);
+#if (RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP)
+static void trace_udp_write(const char *data, uint16_t len, void *arg);
+#endif /* RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP */
+static void trace_task(void *pvParameters);
+
+/*!
+    \brief      configure the free-running run-time TIMER
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_trace_timer_init(void)
+{
+    timer_parameter_struct timer_initpara;
+
+    rcu_periph_clock_enable(RCU_TIMER1);
+    timer_deinit(RTOS_TRACE_TIMER);
+
+    /* TIMER1 is a 32-bit timer, let it run through the full range */
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler         = (uint16_t)((trace_timer_clock() / RTOS_TRACE_TIMER_HZ) - 1U);
+    timer_initpara.alignedmode       = TIMER_COUNTER_EDGE;
+    timer_initpara.counterdirection  = TIMER_COUNTER_UP;
+    timer_initpara.period            = 0xFFFFFFFFU;
+    timer_initpara.clockdivision     = TIMER_CKDIV_DIV1;
+    timer_init(RTOS_TRACE_TIMER, &timer_initpara);
+
+    /* do not count the time the core spends halted by the debugger */
+    dbg_periph_enable(DBG_TIMER1_HOLD);
+
+    timer_enable(RTOS_TRACE_TIMER);
+}
+
+/*!
+    \brief      record one event
+    \param[in]  type: RTOS_TRACE_EVT_xxx
+    \param[in]  id: task or IRQ number
+    \param[in]  arg: event specific argument
+    \param[out] none
+    \retval     none
+*/
+__RAMFUNC void rtos_trace_event(uint8_t type, uint8_t id, uint16_t arg)
+{
+    rtos_trace_event_struct *evt;
+    uint32_t idx;
+
+    /* reserve a slot without masking interrupts, an interrupt that nests
+       between LDREX and STREX makes the STREX fail and the loop retry */
+    do {
+        idx = __LDREXW(&trace_head);
+    } while(0U != __STREXW(idx + 1U, &trace_head));
+
+    evt = &trace_ring[idx & (RTOS_TRACE_RING_SIZE - 1U)];
+    evt->seq = 0U;
+    __DMB();
+    evt->timestamp = rtos_trace_timestamp();
+    evt->type = type;
+    evt->id = id;
+    evt->arg = arg;
+    __DMB();
+    /* publish the event */
+    evt->seq = idx + 1U;
+}
+
+/*!
+    \brief      record a task switch
+    \param[in]  task_number: number of the task switched in
+    \param[out] none
+    \retval     none
+*/
+void rtos_trace_task_switched_in(uint32_t task_number)
+{
+    /* runs in the context switch with kernel interrupts masked, so only
+       this function writes the counters */
+    trace_switches[trace_task_slot(task_number)]++;
+    rtos_trace_event(RTOS_TRACE_EVT_TASK_IN, (uint8_t)task_number, 0U);
+}
+
+/*!
+    \brief      write the task statistics and all events recorded since the last dump
+    \param[in]  write: callback which gets the output in chunks of complete lines
+    \param[in]  arg: user supplied argument passed to write
+    \param[out] none
+    \retval     none
+*/
+void rtos_trace_dump(rtos_trace_write_fn write, void *arg)
+{
+    char line[RTOS_TRACE_LINE_SIZE];
+    rtos_trace_event_struct evt;
+    UBaseType_t count, i;
+    uint32_t total, window, delta, slot, permille;
+    uint32_t head, idx, seq;
+    int len;
+    static const char state_char[] = "XRBSD?";
+    static const char *const heap_name[MEM_REGION_NUM] = {"SRAM", "TCM", "SDRAM"};
+
+    /* snapshot of all tasks, run time and stack high water mark included */
+    count = uxTaskGetSystemState(trace_status, RTOS_TRACE_MAX_TASKS, &total);
+    window = total - trace_last_total;
+    trace_last_total = total;
+
+    head = trace_head;
+    if((head - trace_tail) > RTOS_TRACE_RING_SIZE) {
+        trace_lost += head - trace_tail - RTOS_TRACE_RING_SIZE;
+        trace_tail = head - RTOS_TRACE_RING_SIZE;
+    }
+
+    trace_chunk_len = 0U;
+    len = snprintf(line, sizeof(line), "# rtos_trace 1 hz=%lu now=%lu window=%lu tasks=%lu lost=%lu\n",
+                   (unsigned long)RTOS_TRACE_TIMER_HZ, (unsigned long)total, (unsigned long)window,
+                   (unsigned long)count, (unsigned long)trace_lost);
+    trace_put(write, arg, line, len);
+
+    /* T <number> <priority> <state> <cpu per mille> <run time> <free stack words> <switches> <name> */
+    for(i = 0U; i < count; i++) {
+        slot = trace_task_slot(trace_status[i].xTaskNumber);
+        delta = trace_status[i].ulRunTimeCounter - trace_last_runtime[slot];
+        trace_last_runtime[slot] = trace_status[i].ulRunTimeCounter;
+        permille = (0U != window) ? (uint32_t)(((uint64_t)delta * 1000U) / window) : 0U;
+
+        len = snprintf(line, sizeof(line), "T %lu %lu %c %lu %lu %lu %lu %s\n",
+                       (unsigned long)trace_status[i].xTaskNumber,
+                       (unsigned long)trace_status[i].uxCurrentPriority,
+                       state_char[trace_status[i].eCurrentState],
+                       (unsigned long)permille,
+                       (unsigned long)trace_status[i].ulRunTimeCounter,
+                       (unsigned long)trace_status[i].usStackHighWaterMark,
+                       (unsigned long)trace_switches[slot],
+                       trace_status[i].pcTaskName);
+        trace_put(write, arg, line, len);
+    }
+
+    /* H <region> <size> <free> <min free> <largest> <free blocks> <frag per mille> <pool size> <pool free> <misses> */
+    for(i = 0U; i < MEM_REGION_NUM; i++) {
+        mem_region_stat_struct heap;
+
+        mem_region_stat_get((mem_region_enum)i, &heap);
+        if(0U == heap.size) {
+            continue;
+        }
+        len = snprintf(line, sizeof(line), "H %s %lu %lu %lu %lu %lu %lu %lu %lu %lu\n", heap_name[i],
+                       (unsigned long)heap.size, (unsigned long)heap.free, (unsigned long)heap.free_min,
+                       (unsigned long)heap.largest, (unsigned long)heap.free_blocks, (unsigned long)heap.frag,
+                       (unsigned long)heap.pool_size, (unsigned long)heap.pool_free, (unsigned long)heap.misses);
+        trace_put(write, arg, line, len);
+    }
+
+    /* E <sequence> <timestamp> <type> <id> <arg> */
+    for(idx = trace_tail; idx != head; idx++) {
+        rtos_trace_event_struct *src = &trace_ring[idx & (RTOS_TRACE_RING_SIZE - 1U)];
+
+        seq = src->seq;
+        __DMB();
+        evt.timestamp = src->timestamp;
+        evt.type = src->type;
+        evt.id = src->id;
+        evt.arg = src->arg;
+        __DMB();
+        /* skip slots still being written or already reused by a newer event */
+        if((seq != (idx + 1U)) || (seq != src->seq)) {
+            trace_lost++;
+            continue;
+        }
+
+        len = snprintf(line, sizeof(line), "E %lu %lu %u %u %u\n", (unsigned long)idx,
+                       (unsigned long)evt.timestamp, evt.type, evt.id, evt.arg);
+        trace_put(write, arg, line, len);
+    }
+    trace_tail = head;
+
+    trace_put(write, arg, "# end\n", 6);
+    if(0U != trace_chunk_len) {
+        write(trace_chunk, trace_chunk_len, arg);
+        trace_chunk_len = 0U;
+    }
+}
+
+/*!
+    \brief      start the task that exports a dump every RTOS_TRACE_PERIOD_MS
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_trace_init(void)
+{
+#if (RTOS_TRACE_EXPORT != RTOS_TRACE_EXPORT_NONE)
+    xTaskCreate(trace_task, "TRACE", configMINIMAL_STACK_SIZE * 3, NULL, RTOS_TRACE_TASK_PRIO, NULL);
+#endif /* RTOS_TRACE_EXPORT != RTOS_TRACE_EXPORT_NONE */
+}
+
+/*!
+    \brief      called by the kernel when a task overflowed its stack
+    \param[in]  xTask: handle of the offending task
+    \param[in]  pcTaskName: name of the offending task
+    \param[out] none
+    \retval     none
+*/
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    static const char msg[] = "\r\nstack overflow in task ";
+
+    rtos_trace_event(RTOS_TRACE_EVT_OVERFLOW, (uint8_t)uxTaskGetTaskNumber(xTask), 0U);
+
+    /* the kernel state is no longer trustworthy, report by polling the USART and stop */
+    taskDISABLE_INTERRUPTS();
+    trace_uart_write(msg, sizeof(msg) - 1U, NULL);
+    trace_uart_write(pcTaskName, (uint16_t)strlen(pcTaskName), NULL);
+    trace_uart_write("\r\n", 2U, NULL);
+    for(;;) {
+    }
+}
+
+/*!
+    \brief      get the clock of the run-time TIMER
+    \param[in]  none
+    \param[out] none
+    \retval     TIMER1 counter clock in Hz
+*/
+static uint32_t trace_timer_clock(void)
+{
+    uint32_t ahb = rcu_clock_freq_get(CK_AHB);
+    uint32_t apb1 = rcu_clock_freq_get(CK_APB1);
+
+    /* APB1 not divided: the TIMERs run from CK_AHB */
+    if(0U == (RCU_CFG0 & CFG0_APB1PSC(4))) {
+        return ahb;
+    }
+    /* otherwise twice (TIMERSEL = 0) or four times (TIMERSEL = 1, at most CK_AHB) CK_APB1 */
+    if(0U != (RCU_CFG1 & RCU_CFG1_TIMERSEL)) {
+        return ((apb1 * 4U) > ahb) ? ahb : (apb1 * 4U);
+    }
+    return apb1 * 2U;
+}
+
+/*!
+    \brief      map a task number to its statistics slot
+    \param[in]  task_number: task number
+    \param[out] none
+    \retval     slot index, 0 is shared by all tasks numbered RTOS_TRACE_MAX_TASKS and up
+*/
+static uint32_t trace_task_slot(uint32_t task_number)
+{
+    return (task_number < RTOS_TRACE_MAX_TASKS) ? task_number : 0U;
+}
+
+/*!
+    \brief      append a line to the export chunk, flush the chunk when it is full
+    \param[in]  write: export callback
+    \param[in]  arg: user supplied argument passed to write
+    \param[in]  line: text of the line
+    \param[in]  len: length of the line
+    \param[out] none
+    \retval     none
+*/
+static void trace_put(rtos_trace_write_fn write, void *arg, const char *line, int len)
+{
+    if(len <= 0) {
+        return;
+    }
+    if(len > (int)RTOS_TRACE_LINE_SIZE - 1) {
+        len = RTOS_TRACE_LINE_SIZE - 1;
+    }
+    if(((uint32_t)trace_chunk_len + (uint32_t)len) > RTOS_TRACE_CHUNK_SIZE) {
+        write(trace_chunk, trace_chunk_len, arg);
+        trace_chunk_len = 0U;
+    }
+    memcpy(&trace_chunk[trace_chunk_len], line, (size_t)len);
+    trace_chunk_len += (uint16_t)len;
+}
+
+/*!
+    \brief      export callback writing to the USART by polling
+    \param[in]  data: output data
+    \param[in]  len: length of data
+    \param[in]  arg: not used
+    \param[out] none
+    \retval     none
+*/
+static void trace_uart_write(const char *data, uint16_t len, void *arg)
+{
+    while(len--) {
+        usart_data_transmit(EVAL_COM0, (uint8_t)*data++);
+        while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TBE));
+    }
+}
+
+#if (RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP)
+/*!
+    \brief      export callback sending one UDP datagram per chunk
+    \param[in]  data: output data
+    \param[in]  len: length of data
+    \param[in]  arg: the UDP netconn
+    \param[out] none
+    \retval     none
+*/
+static void trace_udp_write(const char *data, uint16_t len, void *arg)
+{
+    struct netconn *conn = (struct netconn *)arg;
+    struct netbuf *buf;
+    ip_addr_t ipaddr;
+
+    if(NULL == conn) {
+        return;
+    }
+
+    IP4_ADDR(&ipaddr, IP_S_ADDR0, IP_S_ADDR1, IP_S_ADDR2, IP_S_ADDR3);
+
+    buf = netbuf_new();
+    if(NULL != buf) {
+        /* netconn_sendto() returns after the stack has taken the data, so the chunk may be reused */
+        netbuf_ref(buf, data, len);
+        netconn_sendto(conn, buf, &ipaddr, RTOS_TRACE_UDP_PORT);
+        netbuf_delete(buf);
+    }
+}
+#endif /* RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP */
+
+/*!
+    \brief      trace export task
+    \param[in]  pvParameters not used
+    \param[out] none
+    \retval     none
+*/
+static void trace_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+#if (RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP)
+    struct netconn *conn = netconn_new(NETCONN_UDP);
+#endif /* RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP */
+
+    for(;;) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(RTOS_TRACE_PERIOD_MS));
+#if (RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP)
+        rtos_trace_dump(trace_udp_write, conn);
+#else
+        rtos_trace_dump(trace_uart_write, NULL);
+#endif /* RTOS_TRACE_EXPORT == RTOS_TRACE_EXPORT_UDP */
+    }
+}
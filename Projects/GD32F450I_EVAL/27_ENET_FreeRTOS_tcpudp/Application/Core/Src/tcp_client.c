@@ -42,11 +42,119 @@ OF SUCH DAMAGE.
 #include "lwip/tcp.h"
 #include "lwip/memp.h"
 #include "lwip/api.h"
+#include "zc_net.h"
 
 #define TCP_CLIENT_TASK_PRIO            ( tskIDLE_PRIORITY + 5)
 #define MAX_BUF_SIZE                    50
 #define TIME_WAITING_FOR_CONNECT        ( ( portTickType ) 500 )
 
+/* set to 1 to echo the received pbufs with the zero-copy helpers (zc_net.c),
+   0 to use the socket or netconn API with copies */
+#ifndef TCP_CLIENT_ZERO_COPY
+#define TCP_CLIENT_ZERO_COPY            1
+#endif /* TCP_CLIENT_ZERO_COPY */
+/* receive timeout (ms) after which acknowledged data is released */
+#define TCP_CLIENT_POLL_TIME            20
+
+#if TCP_CLIENT_ZERO_COPY
+
+/*!
+    \brief      give the received pbuf back once its echo is acknowledged
+    \param[in]  arg: the pbuf
+    \param[out] none
+    \retval     none
+*/
+static void tcp_client_release(void *arg)
+{
+    pbuf_free((struct pbuf *)arg);
+}
+
+/*!
+    \brief      send the received data back, the payloads are queued in place
+    \param[in]  conn: the TCP netconn over which to send data
+    \param[in]  p: the received data
+    \param[out] none
+    \retval     err_t: error value
+*/
+static err_t tcp_client_echo(struct netconn *conn, struct pbuf *p)
+{
+    struct netvector vectors[ZC_SEND_MAX_VECTORS];
+    struct pbuf *q;
+    u16_t count = 0U;
+    err_t err = ERR_OK;
+
+    for(q = p; q != NULL; q = q->next) {
+        vectors[count].ptr = q->payload;
+        vectors[count].len = q->len;
+        count++;
+        if((ZC_SEND_MAX_VECTORS == count) && (NULL != q->next)) {
+            /* the last write covers these buffers */
+            err = zc_tcp_writev(conn, vectors, count, NULL, NULL);
+            if(ERR_OK != err) {
+                break;
+            }
+            count = 0U;
+        }
+    }
+    if(ERR_OK == err) {
+        return zc_tcp_writev(conn, vectors, count, tcp_client_release, p);
+    }
+
+    pbuf_free(p);
+    return err;
+}
+
+/*!
+    \brief      tcp_client task
+    \param[in]  arg: user supplied argument
+    \param[out] none
+    \retval     none
+*/
+static void tcp_client_task(void *arg)
+{
+    struct netconn *conn;
+    ip_addr_t ipaddr;
+    struct pbuf *p;
+    err_t ret, recv_err;
+
+    IP4_ADDR(&ipaddr, IP_S_ADDR0, IP_S_ADDR1, IP_S_ADDR2, IP_S_ADDR3);
+
+    while(1) {
+        /* creat TCP connection */
+        conn = netconn_new(NETCONN_TCP);
+        /* bind the new netconn to any IP address and port 10260 */
+        recv_err = netconn_bind(conn, IP_ADDR_ANY, 10260);
+
+        if((ERR_USE != recv_err) && (ERR_ISCONN != recv_err)) {
+
+            /* connect the new netconn to remote server and port 10260 */
+            ret = netconn_connect(conn, &ipaddr, 10260);
+            if(ERR_OK == ret) {
+                netconn_set_recvtimeout(conn, TCP_CLIENT_POLL_TIME);
+
+                do {
+                    /* release the echoes the server has acknowledged */
+                    zc_tcp_poll(conn);
+
+                    recv_err = netconn_recv_tcp_pbuf(conn, &p);
+                    if(ERR_OK == recv_err) {
+                        recv_err = tcp_client_echo(conn, p);
+                    }
+                } while((ERR_OK == recv_err) || (ERR_TIMEOUT == recv_err));
+
+                /* the queued echoes still reference the received pbufs */
+                zc_tcp_flush(conn);
+            }
+        }
+
+        /* close connection and discard connection identifier */
+        netconn_close(conn);
+        netconn_delete(conn);
+    }
+}
+
+#else
+
 #if ((LWIP_SOCKET == 0) && (LWIP_NETCONN == 1))
 
 struct recev_packet {
@@ -215,6 +323,8 @@ static void tcp_client_task(void *arg)
 
 #endif /* LWIP_SOCKET */
 
+#endif /* TCP_CLIENT_ZERO_COPY */
+
 
 /*!
     \brief      initialize the tcp_client application
@@ -42,10 +42,46 @@ OF SUCH DAMAGE.
 #include "lwip/memp.h"
 #include "main.h"
 #include "lwip/api.h"
+#include "zc_net.h"
 
 #define UDP_TASK_PRIO       ( tskIDLE_PRIORITY + 5)
 #define MAX_BUF_SIZE        50
 
+/* set to 1 to echo the received pbufs in place with the zero-copy helpers (zc_net.c),
+   0 to use the socket or netconn API with copies */
+#ifndef UDP_ECHO_ZERO_COPY
+#define UDP_ECHO_ZERO_COPY  1
+#endif /* UDP_ECHO_ZERO_COPY */
+
+
+#if UDP_ECHO_ZERO_COPY
+
+/*!
+    \brief      udp echo task, sends every datagram back from the pbuf it was received in
+    \param[in]  arg: user supplied argument
+    \param[out] none
+    \retval     none
+*/
+static void udp_task(void *arg)
+{
+    struct netconn *conn;
+    struct pbuf *p;
+    ip_addr_t addr;
+    u16_t port;
+
+    /* creat UDP connection */
+    conn = netconn_new(NETCONN_UDP);
+    netconn_bind(conn, IP_ADDR_ANY, 1025);
+
+    while(1) {
+        if(ERR_OK == zc_udp_recv(conn, &p, &addr, &port)) {
+            /* the whole datagram goes back to its source, no payload is copied */
+            zc_udp_reply(conn, p, &addr, port);
+        }
+    }
+}
+
+#else
 
 #if ((LWIP_SOCKET == 0) && (LWIP_NETCONN == 1))
 
@@ -206,6 +242,8 @@ static void udp_task(void *arg)
 
 #endif /* LWIP_SOCKET */
 
+#endif /* UDP_ECHO_ZERO_COPY */
+
 
 /*!
     \brief      initialize the udp_echo application
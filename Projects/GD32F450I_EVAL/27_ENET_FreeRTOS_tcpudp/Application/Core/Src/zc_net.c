@@ -0,0 +1,400 @@
+/*!
+    \file    zc_net.c
+    \brief   zero-copy netconn helpers
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "zc_net.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "lwip/sys.h"
+#include "lwip/tcp.h"
+#include "lwip/tcpip.h"
+#include "ethernetif.h"
+#include <string.h>
+
+/* one buffer of a zero-copy UDP send */
+typedef struct {
+    struct pbuf_custom pc;
+    struct zc_send *send;
+} zc_segment_struct;
+
+/* a zero-copy UDP send, released when the last of its pbufs is freed */
+typedef struct zc_send {
+    zc_segment_struct segment[ZC_SEND_MAX_VECTORS];
+    u16_t pending;
+    zc_release_fn release;
+    void *arg;
+} zc_send_struct;
+
+/* a zero-copy TCP write waiting for its acknowledgement and for the Tx DMA */
+typedef struct {
+    struct netconn *conn;
+    u32_t end;
+    u32_t mark;
+    u8_t state;
+    zc_release_fn release;
+    void *arg;
+} zc_tcp_write_struct;
+
+#define ZC_WRITE_FREE               0U
+#define ZC_WRITE_QUEUED             1U
+#define ZC_WRITE_ACKED              2U
+#define ZC_WRITE_RESERVED           3U
+
+LWIP_MEMPOOL_DECLARE(ZC_SEND, ZC_SEND_NUM, sizeof(zc_send_struct), "ZC_SEND")
+
+static zc_tcp_write_struct zc_tcp_write[ZC_TCP_WRITE_NUM];
+
+/*!
+    \brief      initialize the zero-copy send pool
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void zc_net_init(void)
+{
+    LWIP_MEMPOOL_INIT(ZC_SEND);
+}
+
+/*!
+    \brief      wait for a datagram and borrow its pbuf, no data is copied
+    \param[in]  conn: the UDP netconn
+    \param[out] p: the received pbuf, give it back with zc_udp_reply() or zc_release()
+    \param[out] addr: source address of the datagram
+    \param[out] port: source port of the datagram
+    \retval     err_t: error value of netconn_recv()
+*/
+err_t zc_udp_recv(struct netconn *conn, struct pbuf **p, ip_addr_t *addr, u16_t *port)
+{
+    struct netbuf *buf;
+    err_t err;
+
+    err = netconn_recv(conn, &buf);
+    if(ERR_OK != err) {
+        return err;
+    }
+
+    /* take the pbuf out of the netbuf, the netbuf goes back to its pool */
+    *p = buf->p;
+    ip_addr_copy(*addr, buf->addr);
+    *port = buf->port;
+    buf->p = NULL;
+    buf->ptr = NULL;
+    netbuf_delete(buf);
+
+    return ERR_OK;
+}
+
+/*!
+    \brief      send a borrowed pbuf to addr and port and give it back
+    \param[in]  conn: the UDP netconn
+    \param[in]  p: pbuf from zc_udp_recv(), its payload may have been changed in place
+    \param[in]  addr: destination address, the source of the datagram for a reply
+    \param[in]  port: destination port
+    \param[out] none
+    \retval     err_t: error value of netconn_sendto()
+*/
+err_t zc_udp_reply(struct netconn *conn, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    struct netbuf buf;
+    err_t err;
+
+    /* the headers are written again in front of the payload of the same pbuf,
+       the Tx DMA keeps its own reference until the frame is sent */
+    memset(&buf, 0, sizeof(buf));
+    buf.p = p;
+    buf.ptr = p;
+    err = netconn_sendto(conn, &buf, addr, port);
+    pbuf_free(p);
+
+    return err;
+}
+
+/*!
+    \brief      give a borrowed pbuf back
+    \param[in]  p: pbuf from zc_udp_recv()
+    \param[out] none
+    \retval     none
+*/
+void zc_release(struct pbuf *p)
+{
+    pbuf_free(p);
+}
+
+/*!
+    \brief      drop one reference of a zero-copy UDP send, the last one releases it
+    \param[in]  send: the send
+    \param[out] none
+    \retval     none
+*/
+static void zc_send_put(zc_send_struct *send)
+{
+    u16_t pending;
+    SYS_ARCH_DECL_PROTECT(old_level);
+
+    SYS_ARCH_PROTECT(old_level);
+    pending = --send->pending;
+    SYS_ARCH_UNPROTECT(old_level);
+
+    if(0U == pending) {
+        if(NULL != send->release) {
+            send->release(send->arg);
+        }
+        LWIP_MEMPOOL_FREE(ZC_SEND, send);
+    }
+}
+
+/*!
+    \brief      free function of the pbufs of a zero-copy UDP send
+    \param[in]  p: the pbuf
+    \param[out] none
+    \retval     none
+*/
+static void zc_segment_free(struct pbuf *p)
+{
+    zc_send_put(((zc_segment_struct *)p)->send);
+}
+
+/*!
+    \brief      send application buffers as one datagram without copying them
+    \param[in]  conn: the UDP netconn
+    \param[in]  vectors: the buffers, in SRAM for the Tx DMA to read them in place
+    \param[in]  count: number of buffers, at most ZC_SEND_MAX_VECTORS
+    \param[in]  addr: destination address
+    \param[in]  port: destination port
+    \param[in]  release: called once with arg when the buffers may be reused, also
+                if the send fails. It may run in the tcpip thread or the ethernetif
+                task and must not block.
+    \param[in]  arg: argument of release
+    \param[out] none
+    \retval     err_t: ERR_OK, ERR_VAL for a bad vector list, ERR_MEM if no send record
+                is left, or the error value of netconn_sendto()
+*/
+err_t zc_udp_sendv(struct netconn *conn, const struct netvector *vectors, u16_t count,
+                   const ip_addr_t *addr, u16_t port, zc_release_fn release, void *arg)
+{
+    zc_send_struct *send;
+    struct pbuf *head = NULL, *q;
+    struct netbuf buf;
+    u32_t total = 0U;
+    u16_t i;
+    err_t err = ERR_VAL;
+
+    for(i = 0U; i < count; i++) {
+        total += vectors[i].len;
+    }
+    send = NULL;
+    if((0U != count) && (count <= ZC_SEND_MAX_VECTORS) && (0U != total) && (total <= 0xFFFFU)) {
+        send = (zc_send_struct *)LWIP_MEMPOOL_ALLOC(ZC_SEND);
+        if(NULL == send) {
+            err = ERR_MEM;
+        }
+    }
+    if(NULL == send) {
+        if(NULL != release) {
+            release(arg);
+        }
+        return err;
+    }
+
+    /* one custom PBUF_REF per buffer, the last one to be freed releases the send */
+    send->pending = 1U;
+    send->release = release;
+    send->arg = arg;
+    for(i = 0U; i < count; i++) {
+        if(0U == vectors[i].len) {
+            continue;
+        }
+        send->segment[i].pc.custom_free_function = zc_segment_free;
+        send->segment[i].send = send;
+        send->pending++;
+        q = pbuf_alloced_custom(PBUF_RAW, (u16_t)vectors[i].len, PBUF_REF, &send->segment[i].pc,
+                                (void *)vectors[i].ptr, (u16_t)vectors[i].len);
+        if(NULL == head) {
+            head = q;
+        } else {
+            pbuf_cat(head, q);
+        }
+    }
+
+    memset(&buf, 0, sizeof(buf));
+    buf.p = head;
+    buf.ptr = head;
+    err = netconn_sendto(conn, &buf, addr, port);
+    pbuf_free(head);
+
+    /* drop the reference held while the chain was built */
+    zc_send_put(send);
+
+    return err;
+}
+
+/*!
+    \brief      queue application buffers on a TCP connection without copying them
+    \param[in]  conn: the connected TCP netconn
+    \param[in]  vectors: the buffers, in SRAM for the Tx DMA to read them in place
+    \param[in]  count: number of buffers
+    \param[in]  release: called once with arg by zc_tcp_poll() or zc_tcp_flush() after
+                the peer acknowledged the data and the Tx DMA is done with it, also if
+                the write fails. NULL if a later write covers the buffers.
+    \param[in]  arg: argument of release
+    \param[out] none
+    \retval     err_t: error value of netconn_write_vectors_partly()
+*/
+err_t zc_tcp_writev(struct netconn *conn, struct netvector *vectors, u16_t count, zc_release_fn release, void *arg)
+{
+#if LWIP_TCPIP_CORE_LOCKING
+    zc_tcp_write_struct *write = NULL;
+    struct tcp_pcb *pcb;
+    u32_t i;
+    err_t err;
+
+    SYS_ARCH_DECL_PROTECT(old_level);
+
+    /* wait for a free slot, the data stays with the application until it is acknowledged */
+    while(NULL != release) {
+        zc_tcp_poll(conn);
+        SYS_ARCH_PROTECT(old_level);
+        for(i = 0U; i < ZC_TCP_WRITE_NUM; i++) {
+            if(ZC_WRITE_FREE == zc_tcp_write[i].state) {
+                write = &zc_tcp_write[i];
+                write->state = ZC_WRITE_RESERVED;
+                break;
+            }
+        }
+        SYS_ARCH_UNPROTECT(old_level);
+        if(NULL != write) {
+            break;
+        }
+        sys_msleep(1);
+    }
+
+    err = netconn_write_vectors_partly(conn, vectors, count, NETCONN_NOCOPY, NULL);
+    if(NULL == write) {
+        return err;
+    }
+
+    write->conn = conn;
+    write->release = release;
+    write->arg = arg;
+    write->mark = ethernetif_tx_mark();
+    LOCK_TCPIP_CORE();
+    pcb = conn->pcb.tcp;
+    if((ERR_OK == err) && (NULL != pcb)) {
+        /* released once the peer acknowledged the last queued byte */
+        write->end = pcb->snd_lbb;
+        write->state = ZC_WRITE_QUEUED;
+    } else {
+        write->state = ZC_WRITE_ACKED;
+    }
+    UNLOCK_TCPIP_CORE();
+
+    return err;
+#else
+    /* without core locking the acknowledged sequence number cannot be read, copy the data */
+    err_t err = netconn_write_vectors_partly(conn, vectors, count, NETCONN_COPY, NULL);
+
+    if(NULL != release) {
+        release(arg);
+    }
+    return err;
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+}
+
+/*!
+    \brief      release the buffers of the acknowledged TCP writes of a connection
+    \param[in]  conn: the TCP netconn
+    \param[out] none
+    \retval     none
+*/
+void zc_tcp_poll(struct netconn *conn)
+{
+#if LWIP_TCPIP_CORE_LOCKING
+    zc_tcp_write_struct *write;
+    struct tcp_pcb *pcb;
+    u32_t i;
+
+    for(i = 0U; i < ZC_TCP_WRITE_NUM; i++) {
+        write = &zc_tcp_write[i];
+        if((ZC_WRITE_QUEUED != write->state) && (ZC_WRITE_ACKED != write->state)) {
+            continue;
+        }
+        if(conn != write->conn) {
+            continue;
+        }
+
+        if(ZC_WRITE_QUEUED == write->state) {
+            LOCK_TCPIP_CORE();
+            pcb = conn->pcb.tcp;
+            /* without pcb the connection failed and its segments are freed */
+            if((NULL == pcb) || ((s32_t)(pcb->lastack - write->end) >= 0)) {
+                write->state = ZC_WRITE_ACKED;
+                write->mark = ethernetif_tx_mark();
+            }
+            UNLOCK_TCPIP_CORE();
+        }
+
+        /* a retransmission may still be read by the Tx DMA */
+        if((ZC_WRITE_ACKED == write->state) && ethernetif_tx_done(write->mark)) {
+            write->state = ZC_WRITE_FREE;
+            write->release(write->arg);
+        }
+    }
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+}
+
+/*!
+    \brief      wait until all TCP writes of a connection are released, the data
+                stays queued after netconn_close(), so call this before
+    \param[in]  conn: the TCP netconn
+    \param[out] none
+    \retval     none
+*/
+void zc_tcp_flush(struct netconn *conn)
+{
+#if LWIP_TCPIP_CORE_LOCKING
+    u32_t i;
+
+    for(;;) {
+        zc_tcp_poll(conn);
+        for(i = 0U; i < ZC_TCP_WRITE_NUM; i++) {
+            if((ZC_WRITE_FREE != zc_tcp_write[i].state) && (conn == zc_tcp_write[i].conn)) {
+                break;
+            }
+        }
+        if(ZC_TCP_WRITE_NUM == i) {
+            return;
+        }
+        sys_msleep(1);
+    }
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+}
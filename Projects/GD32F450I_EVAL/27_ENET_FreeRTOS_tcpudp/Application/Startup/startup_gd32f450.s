@@ -11,6 +11,14 @@
 .word  _edata
 .word  _sbss
 .word  _ebss
+.word  _siramfunc
+.word  _sramfunc
+.word  _eramfunc
+.word  _sitcmram
+.word  _stcmram
+.word  _etcmram
+.word  _stcmbss
+.word  _etcmbss
 
   .section  .text.Reset_Handler
   .weak  Reset_Handler
@@ -18,32 +26,34 @@
 
 /* reset Handler */
 Reset_Handler:
-  movs r1, #0
-  b DataInit
-
-CopyData:
-  ldr r3, =_sidata
-  ldr r3, [r3, r1]
-  str r3, [r0, r1]
-  adds r1, r1, #4
-
-DataInit:
+/* TCMSRAMEN is set at reset, set it again in case a bootloader cleared it */
+  ldr r0, =0x40023830
+  ldr r1, [r0]
+  orr r1, r1, #0x00100000
+  str r1, [r0]
+
+/* copy the code run from RAM, the initialized data and the initialized TCM data */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  bl CopySection
   ldr r0, =_sdata
-  ldr r3, =_edata
-  adds r2, r0, r1
-  cmp r2, r3
-  bcc CopyData
-  ldr r2, =_sbss
-  b Zerobss
-
-FillZerobss:
-  movs r3, #0
-  str r3, [r2], #4
-
-Zerobss:
-  ldr r3, = _ebss
-  cmp r2, r3
-  bcc FillZerobss
+  ldr r1, =_edata
+  ldr r2, =_sidata
+  bl CopySection
+  ldr r0, =_stcmram
+  ldr r1, =_etcmram
+  ldr r2, =_sitcmram
+  bl CopySection
+
+/* zero the bss and the TCM bss */
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  bl ZeroSection
+  ldr r0, =_stcmbss
+  ldr r1, =_etcmbss
+  bl ZeroSection
+
 /* Call SystemInit function */
   bl  SystemInit
 /* Call static constructors */
@@ -51,6 +61,51 @@ Zerobss:
 /*Call the main function */
   bl main
   bx lr
+
+/* copy r1 - r0 bytes from r2 to r0, the linker script keeps all of them 4 byte aligned.
+   16 bytes per load and store multiple, then single words. uses r3 to r7 */
+CopySection:
+  subs r3, r1, r0
+  bls CopyDone
+CopyBlock:
+  subs r3, r3, #16
+  bcc CopyTail
+  ldmia r2!, {r4-r7}
+  stmia r0!, {r4-r7}
+  b CopyBlock
+CopyTail:
+  adds r3, r3, #16
+  beq CopyDone
+CopyWord:
+  ldr r4, [r2], #4
+  str r4, [r0], #4
+  subs r3, r3, #4
+  bne CopyWord
+CopyDone:
+  bx lr
+
+/* zero r1 - r0 bytes from r0, 4 byte aligned, 16 bytes per store multiple. uses r3 to r7 */
+ZeroSection:
+  movs r4, #0
+  movs r5, #0
+  movs r6, #0
+  movs r7, #0
+  subs r3, r1, r0
+  bls ZeroDone
+ZeroBlock:
+  subs r3, r3, #16
+  bcc ZeroTail
+  stmia r0!, {r4-r7}
+  b ZeroBlock
+ZeroTail:
+  adds r3, r3, #16
+  beq ZeroDone
+ZeroWord:
+  str r4, [r0], #4
+  subs r3, r3, #4
+  bne ZeroWord
+ZeroDone:
+  bx lr
 .size Reset_Handler, .-Reset_Handler
 
     .section .text.Default_Handler,"ax",%progbits
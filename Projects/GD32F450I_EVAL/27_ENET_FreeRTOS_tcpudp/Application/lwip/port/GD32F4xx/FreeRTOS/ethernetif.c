@@ -49,6 +49,7 @@
 #include "gd32f4xx_enet.h"
 #include <string.h>
 #include "semphr.h"
+#include "rtos_trace.h"
 
 
 #define ETHERNETIF_INPUT_TASK_STACK_SIZE          (350)
@@ -57,6 +58,17 @@
 /* The time to block waiting for input */
 #define LOWLEVEL_INPUT_WAITING_TIME               ((portTickType )100)
 
+/* Set to 1 to let the Tx DMA read the pbufs of a frame in place instead of
+   copying them to the descriptor buffer. The frame stays referenced until the
+   DMA gives the descriptors back. */
+#ifndef ETHERNETIF_TX_ZERO_COPY
+#define ETHERNETIF_TX_ZERO_COPY                   1
+#endif /* ETHERNETIF_TX_ZERO_COPY */
+
+/* the ENET DMA can only read from the SRAM, not from the TCM SRAM */
+#define ETHERNETIF_DMA_RAM_START                  0x20000000U
+#define ETHERNETIF_DMA_RAM_END                    0x20080000U
+
 /* define those to better describe your network interface */
 #define IFNAME0 'G'
 #define IFNAME1 'D'
@@ -81,6 +93,21 @@ enet_descriptors_struct  ptp_rxstructure[ENET_RXBUF_NUM];
 
 static struct netif *low_netif = NULL;
 xSemaphoreHandle g_rx_semaphore = NULL;
+static xSemaphoreHandle s_tx_semaphore = NULL;
+
+/* frames handed to the Tx DMA and frames the Tx DMA has given back */
+static volatile u32_t tx_frames_queued = 0U;
+static volatile u32_t tx_frames_done = 0U;
+/* set for the last descriptor of each queued frame */
+static u8_t tx_desc_last[ENET_TXBUF_NUM];
+/* the first frame in each direction is marked in the trace */
+static u8_t tx_first_marked = 0U;
+static u8_t rx_first_marked = 0U;
+
+#if ETHERNETIF_TX_ZERO_COPY && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+/* frame read in place by the Tx DMA, kept on its last descriptor */
+static struct pbuf *tx_desc_pbuf[ENET_TXBUF_NUM];
+#endif /* ETHERNETIF_TX_ZERO_COPY && !SELECT_DESCRIPTORS_ENHANCED_MODE */
 
 /**
 * In this function, the hardware should be initialized.
@@ -120,6 +147,11 @@ static void low_level_init(struct netif *netif)
         xSemaphoreTake( g_rx_semaphore, 0);
     }
 
+    /* create binary semaphore used for serializing the access to the Tx descriptors */
+    if (s_tx_semaphore == NULL){
+        vSemaphoreCreateBinary(s_tx_semaphore);
+    }
+
     /* initialize MAC address in ethernet MAC */ 
     enet_mac_address_set(ENET_MAC_ADDRESS0, netif->hwaddr);
   
@@ -162,6 +194,129 @@ static void low_level_init(struct netif *netif)
 }
 
 
+/**
+* Give back the Tx descriptors the DMA is done with. Must be called with
+* s_tx_semaphore taken, the pbufs of the sent frames are returned in freed
+* and have to be freed after s_tx_semaphore is given back.
+*
+* @param freed array of ENET_TXBUF_NUM pbuf pointers
+* @param nfreed number of pbufs in freed, updated
+*/
+static void low_level_tx_reclaim(struct pbuf **freed, u32_t *nfreed)
+{
+    uint32_t i;
+
+    for(i = 0; i < ENET_TXBUF_NUM; i++){
+        if((0U != tx_desc_last[i]) && ((uint32_t)RESET == (txdesc_tab[i].status & ENET_TDES0_DAV))){
+            tx_desc_last[i] = 0U;
+            tx_frames_done++;
+#if ETHERNETIF_TX_ZERO_COPY && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+            if(NULL != tx_desc_pbuf[i]){
+                freed[(*nfreed)++] = tx_desc_pbuf[i];
+                tx_desc_pbuf[i] = NULL;
+            }
+#endif /* ETHERNETIF_TX_ZERO_COPY && !SELECT_DESCRIPTORS_ENHANCED_MODE */
+        }
+    }
+}
+
+#if ETHERNETIF_TX_ZERO_COPY && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+/**
+* Check if the DMA can read a frame in place.
+*
+* PBUF_REF data may change as soon as the sending call returns (lwIP only
+* guarantees it for custom pbufs), so such frames are copied, as well as
+* frames with more segments than descriptors or data outside the SRAM.
+*
+* @param p the frame to send
+* @return number of descriptors needed, 0 if the frame has to be copied
+*/
+static u32_t low_level_output_segments(struct pbuf *p)
+{
+    struct pbuf *q;
+    u32_t count = 0U;
+
+    if(p->tot_len > ENET_MAX_FRAME_SIZE){
+        return 0U;
+    }
+    for(q = p; q != NULL; q = q->next){
+        if(0U == q->len){
+            continue;
+        }
+        if(PBUF_NEEDS_COPY(q) && (0U == (q->flags & PBUF_FLAG_IS_CUSTOM))){
+            return 0U;
+        }
+        if(((uint32_t)q->payload < ETHERNETIF_DMA_RAM_START) ||
+           (((uint32_t)q->payload + q->len) > ETHERNETIF_DMA_RAM_END)){
+            return 0U;
+        }
+        if(++count > ENET_TXBUF_NUM){
+            return 0U;
+        }
+    }
+    return count;
+}
+
+/**
+* Queue a frame with one descriptor per pbuf, the DMA reads the payloads in
+* place. The first descriptor is given to the DMA last, so that it never
+* sees a partly built frame.
+*
+* @param p the frame to send
+* @param count number of descriptors, from low_level_output_segments()
+* @param freed see low_level_tx_reclaim()
+* @param nfreed see low_level_tx_reclaim()
+*/
+static void low_level_output_zero_copy(struct pbuf *p, u32_t count, struct pbuf **freed, u32_t *nfreed)
+{
+    enet_descriptors_struct *desc = dma_current_txdesc;
+    enet_descriptors_struct *first = dma_current_txdesc;
+    enet_descriptors_struct *last = dma_current_txdesc;
+    struct pbuf *q;
+    uint32_t status, index = 0U;
+
+    for(q = p; q != NULL; q = q->next){
+        if(0U == q->len){
+            continue;
+        }
+        /* wait for the DMA to give the descriptor back */
+        while((uint32_t)RESET != (desc->status & ENET_TDES0_DAV)){
+        }
+        low_level_tx_reclaim(freed, nfreed);
+
+        status = desc->status & ~(ENET_TDES0_FSG | ENET_TDES0_LSG);
+        if(desc == first){
+            status |= ENET_TDES0_FSG;
+        }else{
+            status |= ENET_TDES0_DAV;
+        }
+        if(++index == count){
+            status |= ENET_TDES0_LSG;
+        }
+        desc->buffer1_addr = (uint32_t)q->payload;
+        desc->control_buffer_size = q->len;
+        desc->status = status;
+
+        last = desc;
+        desc = (enet_descriptors_struct *)(desc->buffer2_next_desc_addr);
+    }
+
+    /* keep the frame until the DMA gives the last descriptor back */
+    pbuf_ref(p);
+    tx_desc_pbuf[last - txdesc_tab] = p;
+    tx_desc_last[last - txdesc_tab] = 1U;
+    tx_frames_queued++;
+
+    first->status |= ENET_TDES0_DAV;
+    if((uint32_t)RESET != (ENET_DMA_STAT & (ENET_DMA_STAT_TBU | ENET_DMA_STAT_TU))){
+        /* clear TBU and TU flag and resume the DMA transmission */
+        ENET_DMA_STAT = ENET_DMA_STAT & (ENET_DMA_STAT_TBU | ENET_DMA_STAT_TU);
+        ENET_DMA_TPEN = 0U;
+    }
+    dma_current_txdesc = desc;
+}
+#endif /* ETHERNETIF_TX_ZERO_COPY && !SELECT_DESCRIPTORS_ENHANCED_MODE */
+
 /**
 * This function should do the actual transmission of the packet. The packet is
 * contained in the pbuf that is passed to the function. This pbuf
@@ -180,44 +335,69 @@ static void low_level_init(struct netif *netif)
 
 static err_t low_level_output(struct netif *netif, struct pbuf *p)
 {
-    static xSemaphoreHandle s_tx_semaphore = NULL;
     struct pbuf *q;
+    struct pbuf *freed[ENET_TXBUF_NUM];
+    u32_t nfreed = 0U;
     uint8_t *buffer ;
     uint16_t framelength = 0;
     ErrStatus reval = ERROR;
+#if ETHERNETIF_TX_ZERO_COPY && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+    u32_t count;
+#endif /* ETHERNETIF_TX_ZERO_COPY && !SELECT_DESCRIPTORS_ENHANCED_MODE */
   
     SYS_ARCH_DECL_PROTECT(sr);
-    
-    if (s_tx_semaphore == NULL){
-        vSemaphoreCreateBinary (s_tx_semaphore);
-    }
 
     if (xSemaphoreTake(s_tx_semaphore, LOWLEVEL_OUTPUT_WAITING_TIME)){    
         SYS_ARCH_PROTECT(sr);
-      
-        while((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)){
-        }    
-        buffer = (uint8_t *)(enet_desc_information_get(dma_current_txdesc, TXDESC_BUFFER_1_ADDR));
-
-        for(q = p; q != NULL; q = q->next){ 
-            memcpy((uint8_t *)&buffer[framelength], q->payload, q->len);
-            framelength = framelength + q->len;
-        }
 
-       /* transmit descriptors to give to DMA */ 
+#if ETHERNETIF_TX_ZERO_COPY && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+        count = low_level_output_segments(p);
+        if(0U != count){
+            low_level_output_zero_copy(p, count, freed, &nfreed);
+            reval = SUCCESS;
+        }else
+#endif /* ETHERNETIF_TX_ZERO_COPY && !SELECT_DESCRIPTORS_ENHANCED_MODE */
+        {
+            while((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)){
+            }    
+            low_level_tx_reclaim(freed, &nfreed);
+#if ETHERNETIF_TX_ZERO_COPY && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+            /* the descriptor may point to the payload of a frame sent in place */
+            dma_current_txdesc->buffer1_addr = (uint32_t)tx_buff[dma_current_txdesc - txdesc_tab];
+#endif /* ETHERNETIF_TX_ZERO_COPY && !SELECT_DESCRIPTORS_ENHANCED_MODE */
+            buffer = (uint8_t *)(enet_desc_information_get(dma_current_txdesc, TXDESC_BUFFER_1_ADDR));
+
+            for(q = p; q != NULL; q = q->next){ 
+                memcpy((uint8_t *)&buffer[framelength], q->payload, q->len);
+                framelength = framelength + q->len;
+            }
+            tx_desc_last[dma_current_txdesc - txdesc_tab] = 1U;
+            tx_frames_queued++;
+
+           /* transmit descriptors to give to DMA */ 
 #ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-        reval = ENET_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(framelength, NULL);
+            reval = ENET_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(framelength, NULL);
 #else
-        reval = ENET_NOCOPY_FRAME_TRANSMIT(framelength);
+            reval = ENET_NOCOPY_FRAME_TRANSMIT(framelength);
 #endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
+        }
 
         SYS_ARCH_UNPROTECT(sr);
         
         /* give semaphore and exit */
         xSemaphoreGive(s_tx_semaphore);
+
+        /* custom pbufs may call back the application, so free them outside the lock */
+        while(0U != nfreed){
+            pbuf_free(freed[--nfreed]);
+        }
     }
     
     if(SUCCESS == reval){
+        if(0U == tx_first_marked){
+            tx_first_marked = 1U;
+            rtos_trace_event(RTOS_TRACE_EVT_MARK, RTOS_TRACE_MARK_FIRST_TX, p->tot_len);
+        }
         return ERR_OK;
     }else{
         while(1){
@@ -226,6 +406,54 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
     
 }
 
+/**
+* Free the frames the Tx DMA has sent in place.
+*
+* Called periodically by the ethernetif_input task, so that no frame stays
+* referenced when nothing else is sent.
+*/
+void ethernetif_tx_reclaim(void)
+{
+    struct pbuf *freed[ENET_TXBUF_NUM];
+    u32_t nfreed = 0U;
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    if((NULL == s_tx_semaphore) || (pdTRUE != xSemaphoreTake(s_tx_semaphore, 0))){
+        return;
+    }
+    SYS_ARCH_PROTECT(sr);
+    low_level_tx_reclaim(freed, &nfreed);
+    SYS_ARCH_UNPROTECT(sr);
+    xSemaphoreGive(s_tx_semaphore);
+
+    while(0U != nfreed){
+        pbuf_free(freed[--nfreed]);
+    }
+}
+
+/**
+* Get the number of frames handed to the Tx DMA so far.
+*
+* @return mark to pass to ethernetif_tx_done()
+*/
+u32_t ethernetif_tx_mark(void)
+{
+    return tx_frames_queued;
+}
+
+/**
+* Check if all frames queued before a mark were sent, e.g. before reusing
+* data that may be read in place by the DMA.
+*
+* @param mark the value of ethernetif_tx_mark() when the frames were queued
+* @return 1 if the frames were sent, 0 otherwise
+*/
+int ethernetif_tx_done(u32_t mark)
+{
+    ethernetif_tx_reclaim();
+    return ((s32_t)(tx_frames_done - mark) >= 0) ? 1 : 0;
+}
+
 /**
 * Should allocate a pbuf and transfer the bytes of the incoming
 * packet from the interface into the pbuf.
@@ -283,6 +511,9 @@ void ethernetif_input( void * pvParameters )
     SYS_ARCH_DECL_PROTECT(sr);
   
     for( ;; ){   
+        /* free the frames the Tx DMA is done with */
+        ethernetif_tx_reclaim();
+
         if(pdTRUE == xSemaphoreTake(g_rx_semaphore, LOWLEVEL_INPUT_WAITING_TIME)){ 
 TRY_GET_NEXT_FRAME:
             SYS_ARCH_PROTECT(sr);
@@ -290,6 +521,10 @@ TRY_GET_NEXT_FRAME:
             SYS_ARCH_UNPROTECT(sr);
           
             if   (p != NULL){
+                if(0U == rx_first_marked){
+                    rx_first_marked = 1U;
+                    rtos_trace_event(RTOS_TRACE_EVT_MARK, RTOS_TRACE_MARK_FIRST_RX, p->tot_len);
+                }
                 if (ERR_OK != low_netif->input( p, low_netif)){
                     pbuf_free(p);
                 }else{
@@ -7,5 +7,8 @@
 
 err_t ethernetif_init(struct netif *netif);
 void ethernetif_input( void * pvParameters );
+void ethernetif_tx_reclaim(void);
+u32_t ethernetif_tx_mark(void);
+int ethernetif_tx_done(u32_t mark);
 
 #endif 
@@ -86,6 +86,15 @@
 #define LWIP_FREERTOS_SYS_NOW_FROM_FREERTOS           1
 #endif
 
+/** Set this to 1 to implement the per-thread semaphores of LWIP_NETCONN_SEM_PER_THREAD
+ * with the notification value of the owning task instead of a FreeRTOS semaphore.
+ * Tasks calling netconn or socket functions must not use their notification value
+ * for anything else then.
+ */
+#ifndef LWIP_FREERTOS_NETCONN_SEM_NOTIFY
+#define LWIP_FREERTOS_NETCONN_SEM_NOTIFY              0
+#endif
+
 #if !configSUPPORT_DYNAMIC_ALLOCATION
 # error "lwIP FreeRTOS port requires configSUPPORT_DYNAMIC_ALLOCATION"
 #endif
@@ -100,6 +109,9 @@
 # error "lwIP FreeRTOS port requires configUSE_MUTEXES"
 #endif
 #endif
+#if LWIP_FREERTOS_NETCONN_SEM_NOTIFY && !configUSE_TASK_NOTIFICATIONS
+# error "LWIP_FREERTOS_NETCONN_SEM_NOTIFY requires configUSE_TASK_NOTIFICATIONS"
+#endif
 
 #if SYS_LIGHTWEIGHT_PROT && LWIP_FREERTOS_SYS_ARCH_PROTECT_USES_MUTEX
 static SemaphoreHandle_t sys_arch_protect_mutex;
@@ -256,6 +268,7 @@ sys_sem_new(sys_sem_t *sem, u8_t initial_count)
   LWIP_ASSERT("initial_count invalid (not 0 or 1)",
     (initial_count == 0) || (initial_count == 1));
 
+  sem->notify = 0;
   sem->sem = xSemaphoreCreateBinary();
   if(sem->sem == NULL) {
     SYS_STATS_INC(sem.err);
@@ -277,6 +290,14 @@ sys_sem_signal(sys_sem_t *sem)
   LWIP_ASSERT("sem != NULL", sem != NULL);
   LWIP_ASSERT("sem->sem != NULL", sem->sem != NULL);
 
+#if LWIP_FREERTOS_NETCONN_SEM_NOTIFY
+  if (sem->notify) {
+    /* sem->sem is the owning task */
+    xTaskNotifyGive((TaskHandle_t)sem->sem);
+    return;
+  }
+#endif /* LWIP_FREERTOS_NETCONN_SEM_NOTIFY */
+
   ret = xSemaphoreGive(sem->sem);
   /* queue full is OK, this is a signal only... */
   LWIP_ASSERT("sys_sem_signal: sane return value",
@@ -290,6 +311,18 @@ sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout_ms)
   LWIP_ASSERT("sem != NULL", sem != NULL);
   LWIP_ASSERT("sem->sem != NULL", sem->sem != NULL);
 
+#if LWIP_FREERTOS_NETCONN_SEM_NOTIFY
+  if (sem->notify) {
+    LWIP_ASSERT("notification semaphore waited by another task",
+      sem->sem == xTaskGetCurrentTaskHandle());
+    /* taking clears the value like a binary semaphore */
+    if (ulTaskNotifyTake(pdTRUE, timeout_ms ? (timeout_ms / portTICK_RATE_MS) : portMAX_DELAY) == 0) {
+      return SYS_ARCH_TIMEOUT;
+    }
+    return 1;
+  }
+#endif /* LWIP_FREERTOS_NETCONN_SEM_NOTIFY */
+
   if(!timeout_ms) {
     /* wait infinite */
     ret = xSemaphoreTake(sem->sem, portMAX_DELAY);
@@ -316,6 +349,13 @@ sys_sem_free(sys_sem_t *sem)
   LWIP_ASSERT("sem != NULL", sem != NULL);
   LWIP_ASSERT("sem->sem != NULL", sem->sem != NULL);
 
+#if LWIP_FREERTOS_NETCONN_SEM_NOTIFY
+  if (sem->notify) {
+    sem->sem = NULL;
+    return;
+  }
+#endif /* LWIP_FREERTOS_NETCONN_SEM_NOTIFY */
+
   SYS_STATS_DEC(sem.used);
   vSemaphoreDelete(sem->sem);
   sem->sem = NULL;
@@ -500,6 +540,11 @@ sys_arch_netconn_sem_get(void)
   LWIP_ASSERT("task != NULL", task != NULL);
 
   ret = pvTaskGetThreadLocalStoragePointer(task, 0);
+  if(ret == NULL) {
+    /* tasks not created with sys_thread_new() get their semaphore on first use */
+    sys_arch_netconn_sem_alloc();
+    ret = pvTaskGetThreadLocalStoragePointer(task, 0);
+  }
   return ret;
 }
 
@@ -517,8 +562,16 @@ sys_arch_netconn_sem_alloc(void)
     /* need to allocate the memory for this semaphore */
     sem = mem_malloc(sizeof(sys_sem_t));
     LWIP_ASSERT("sem != NULL", sem != NULL);
+#if LWIP_FREERTOS_NETCONN_SEM_NOTIFY
+    LWIP_UNUSED_ARG(err);
+    sem->sem = task;
+    sem->notify = 1;
+    /* drop a notification pending from earlier use */
+    ulTaskNotifyTake(pdTRUE, 0);
+#else /* LWIP_FREERTOS_NETCONN_SEM_NOTIFY */
     err = sys_sem_new(sem, 0);
     LWIP_ASSERT("err == ERR_OK", err == ERR_OK);
+#endif /* LWIP_FREERTOS_NETCONN_SEM_NOTIFY */
     LWIP_ASSERT("sem invalid", sys_sem_valid(sem));
     vTaskSetThreadLocalStoragePointer(task, 0, sem);
   }
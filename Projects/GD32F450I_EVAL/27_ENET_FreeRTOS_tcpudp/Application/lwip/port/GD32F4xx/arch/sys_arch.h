@@ -64,6 +64,7 @@ typedef struct _sys_mut sys_mutex_t;
 
 struct _sys_sem {
   void *sem;
+  u8_t notify;  /* sem is the owning task, signalled by task notifications */
 };
 typedef struct _sys_sem sys_sem_t;
 #define sys_sem_valid_val(sema)   ((sema).sem != NULL)
@@ -92,4 +93,11 @@ void sys_arch_netconn_sem_free(void);
 #define LWIP_NETCONN_THREAD_SEM_FREE()  sys_arch_netconn_sem_free()
 #endif /* LWIP_NETCONN_SEM_PER_THREAD */
 
+#if LWIP_TCPIP_CORE_LOCKING
+void sys_lock_tcpip_core(void);
+void sys_unlock_tcpip_core(void);
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+void sys_mark_tcpip_thread(void);
+void sys_check_core_locking(void);
+
 #endif /* LWIP_ARCH_SYS_ARCH_H */
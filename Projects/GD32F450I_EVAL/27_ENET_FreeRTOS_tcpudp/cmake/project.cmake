@@ -1,8 +1,12 @@
+# run the hot paths of the placement profile from RAM, see project_add_ram_placement()
+option(PROJECT_RAM_PLACEMENT "Run the hot paths listed in the placement profile from RAM" OFF)
+
 function(project_add_target_properties TARGET_NAME)
 
 target_compile_definitions(${TARGET_NAME} PRIVATE
     "$<$<CONFIG:Debug>:DEBUG>"
     "$<$<NOT:$<CONFIG:Debug>>:RELEASE>"
+    "$<$<BOOL:${PROJECT_RAM_PLACEMENT}>:RAM_PLACEMENT>"
 	USE_STDPERIPH_DRIVER
     GD32F450
 	)
@@ -43,3 +47,60 @@ target_link_libraries(${TARGET_NAME} PRIVATE
     )
 
 endfunction()
+
+# Turn a placement profile into the ram_placement_*.ld fragments that gd32f4xx_flash.ld
+# includes, they stay empty while PROJECT_RAM_PLACEMENT is OFF. After every link the
+# target gets a <target>_ram_report.txt with the RAM and flash residency of its code.
+# Profile lines:
+#   text <function>            the function runs from the SRAM
+#   lib <archive>:<object>     all code of a library object runs from the SRAM
+#   data <variable>            the variable moves to the TCM
+function(project_add_ram_placement TARGET_NAME PROFILE)
+
+set(PLACEMENT_DIR ${CMAKE_BINARY_DIR}/ram_placement)
+set(PLACEMENT_TEXT "")
+set(PLACEMENT_DATA "")
+set(PLACEMENT_BSS "")
+
+if(PROJECT_RAM_PLACEMENT)
+    file(STRINGS ${PROFILE} PROFILE_LINES REGEX "^[ \t]*[a-z]")
+    foreach(LINE IN LISTS PROFILE_LINES)
+        if(NOT LINE MATCHES "^[ \t]*([a-z]+)[ \t]+([^ \t#]+)")
+            message(FATAL_ERROR "${PROFILE}: bad line '${LINE}'")
+        endif()
+        if(CMAKE_MATCH_1 STREQUAL "text")
+            string(APPEND PLACEMENT_TEXT "        *(.text.${CMAKE_MATCH_2})\n")
+        elseif(CMAKE_MATCH_1 STREQUAL "lib")
+            string(APPEND PLACEMENT_TEXT "        ${CMAKE_MATCH_2}(.text .text.*)\n")
+        elseif(CMAKE_MATCH_1 STREQUAL "data")
+            string(APPEND PLACEMENT_DATA "        *(.data.${CMAKE_MATCH_2})\n")
+            string(APPEND PLACEMENT_BSS "        *(.bss.${CMAKE_MATCH_2})\n")
+        else()
+            message(FATAL_ERROR "${PROFILE}: unknown entry '${LINE}'")
+        endif()
+    endforeach()
+endif()
+
+# only rewritten when the content changes, so a new configure does not relink
+foreach(PART text data bss)
+    string(TOUPPER ${PART} PART_VAR)
+    file(CONFIGURE OUTPUT ${PLACEMENT_DIR}/ram_placement_${PART}.ld
+        CONTENT "/* generated from ${PROFILE} */\n${PLACEMENT_${PART_VAR}}" @ONLY)
+    set_property(TARGET ${TARGET_NAME} APPEND PROPERTY LINK_DEPENDS ${PLACEMENT_DIR}/ram_placement_${PART}.ld)
+endforeach()
+set_property(DIRECTORY ${CMAKE_SOURCE_DIR} APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${PROFILE})
+
+# ahead of -T, ld looks up the INCLUDE files of the script when it reads the script
+target_link_options(${TARGET_NAME} BEFORE PRIVATE
+    -L${PLACEMENT_DIR}
+    )
+
+add_custom_command(TARGET ${TARGET_NAME}
+    POST_BUILD
+    COMMAND ${CMAKE_COMMAND} -DNM=${CMAKE_NM} -DELF=$<TARGET_FILE:${TARGET_NAME}> -DPROFILE=${PROFILE}
+        -DPLACEMENT=${PROJECT_RAM_PLACEMENT}
+        -DREPORT=$<TARGET_FILE_DIR:${TARGET_NAME}>/$<TARGET_NAME:${TARGET_NAME}>_ram_report.txt
+        -P ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/ram_report.cmake
+    )
+
+endfunction()
@@ -0,0 +1,90 @@
+# Residency report of a linked image: where every entry of the placement profile ended up,
+# and how much code runs from the SRAM and from the flash. project_add_ram_placement()
+# runs it after each link:
+#   cmake -DNM=<nm> -DELF=<image> -DPROFILE=<profile> -DPLACEMENT=<ON|OFF> -DREPORT=<report> -P ram_report.cmake
+
+execute_process(COMMAND ${NM} -S -n --defined-only ${ELF}
+    OUTPUT_VARIABLE SYMBOLS
+    RESULT_VARIABLE RESULT
+    )
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "ram_report: ${NM} failed on ${ELF}")
+endif()
+string(REPLACE "\n" ";" SYMBOLS "${SYMBOLS}")
+
+set(RAM_CODE_NUM 0)
+set(RAM_CODE_SIZE 0)
+set(FLASH_CODE_NUM 0)
+set(FLASH_CODE_SIZE 0)
+set(TCM_DATA_NUM 0)
+set(TCM_DATA_SIZE 0)
+set(RAM_CODE_LIST "")
+set(TCM_DATA_LIST "")
+
+# the leading address digit tells the memory: 0x08 flash, 0x10 TCM, 0x20 SRAM
+foreach(LINE IN LISTS SYMBOLS)
+    if(NOT LINE MATCHES "^([0-9a-f]+) ([0-9a-f]+) ([tTdDbB]) (.+)$")
+        continue()
+    endif()
+    set(ADDR ${CMAKE_MATCH_1})
+    math(EXPR SIZE "0x${CMAKE_MATCH_2}")
+    set(NAME ${CMAKE_MATCH_4})
+    string(SUBSTRING ${ADDR} 0 1 MEMORY)
+    if(CMAKE_MATCH_3 MATCHES "[tT]")
+        if(MEMORY STREQUAL "2")
+            math(EXPR RAM_CODE_NUM "${RAM_CODE_NUM} + 1")
+            math(EXPR RAM_CODE_SIZE "${RAM_CODE_SIZE} + ${SIZE}")
+            string(APPEND RAM_CODE_LIST "    0x${ADDR} ${SIZE}\t${NAME}\n")
+            set(WHERE_${NAME} "SRAM   0x${ADDR} ${SIZE}")
+        else()
+            math(EXPR FLASH_CODE_NUM "${FLASH_CODE_NUM} + 1")
+            math(EXPR FLASH_CODE_SIZE "${FLASH_CODE_SIZE} + ${SIZE}")
+            set(WHERE_${NAME} "flash  0x${ADDR} ${SIZE}")
+        endif()
+    elseif(MEMORY STREQUAL "1")
+        math(EXPR TCM_DATA_NUM "${TCM_DATA_NUM} + 1")
+        math(EXPR TCM_DATA_SIZE "${TCM_DATA_SIZE} + ${SIZE}")
+        string(APPEND TCM_DATA_LIST "    0x${ADDR} ${SIZE}\t${NAME}\n")
+        set(WHERE_${NAME} "TCM    0x${ADDR} ${SIZE}")
+    else()
+        set(WHERE_${NAME} "SRAM   0x${ADDR} ${SIZE}")
+    endif()
+endforeach()
+
+# every profile entry that did not make it into RAM is a finding: misspelt, renamed, inlined
+# into its callers or dropped by the garbage collection of the linker
+set(ENTRIES "")
+set(MISSED 0)
+file(STRINGS ${PROFILE} PROFILE_LINES REGEX "^[ \t]*[a-z]")
+foreach(LINE IN LISTS PROFILE_LINES)
+    if(NOT LINE MATCHES "^[ \t]*([a-z]+)[ \t]+([^ \t#]+)")
+        continue()
+    endif()
+    set(KIND ${CMAKE_MATCH_1})
+    set(NAME ${CMAKE_MATCH_2})
+    if(KIND STREQUAL "lib")
+        string(APPEND ENTRIES "    see the functions in SRAM\t${KIND} ${NAME}\n")
+    elseif(DEFINED WHERE_${NAME})
+        string(APPEND ENTRIES "    ${WHERE_${NAME}}\t${KIND} ${NAME}\n")
+        if(WHERE_${NAME} MATCHES "^flash")
+            math(EXPR MISSED "${MISSED} + 1")
+        endif()
+    else()
+        string(APPEND ENTRIES "    not in the image\t${KIND} ${NAME}\n")
+        math(EXPR MISSED "${MISSED} + 1")
+    endif()
+endforeach()
+
+get_filename_component(IMAGE ${ELF} NAME)
+file(WRITE ${REPORT}
+    "RAM placement of ${IMAGE}, PROJECT_RAM_PLACEMENT ${PLACEMENT}\n\n"
+    "code in SRAM:  ${RAM_CODE_NUM} functions, ${RAM_CODE_SIZE} bytes\n"
+    "code in flash: ${FLASH_CODE_NUM} functions, ${FLASH_CODE_SIZE} bytes\n"
+    "data in TCM:   ${TCM_DATA_NUM} objects, ${TCM_DATA_SIZE} bytes\n\n"
+    "profile entries (memory, address, size):\n${ENTRIES}\n"
+    "functions in SRAM:\n${RAM_CODE_LIST}\n"
+    "data in TCM:\n${TCM_DATA_LIST}"
+    )
+
+message(STATUS "${IMAGE}: ${RAM_CODE_SIZE} bytes of code in SRAM, ${TCM_DATA_SIZE} bytes of data in TCM, "
+    "${MISSED} profile entries not in RAM, see ${REPORT}")
@@ -75,6 +75,28 @@
 #define LWIP_HTTPD_FS_ASYNC_READ      0
 #endif
 
+/** HTTPD_FS_HASHED==1: use the perfect-hash, precompressed file system image
+ * generated by Utilities/makefshash (fsdata_hash.c) instead of the linked
+ * list in fsdata.c. Lookup is one hash plus one string compare, bodies can be
+ * served gzip-encoded and unchanged files are answered with 304.
+ */
+#ifndef HTTPD_FS_HASHED
+#define HTTPD_FS_HASHED               0
+#endif
+
+/* content encodings of a file (index into struct fsdata_hash_file.variant) */
+#define FS_ENCODING_IDENTITY          0
+#define FS_ENCODING_GZIP              1
+#define FS_ENCODING_DEFLATE           2
+#define FS_ENCODING_COUNT             3
+
+/* accept flags passed to fs_open_ex() */
+#define FS_ACCEPT_GZIP                (1U << FS_ENCODING_GZIP)
+#define FS_ACCEPT_DEFLATE             (1U << FS_ENCODING_DEFLATE)
+
+/* tag value of a template chunk that ends without a tag slot */
+#define FS_SSI_NO_TAG                 0xFF
+
 #define FS_READ_EOF     -1
 #define FS_READ_DELAYED -2
 
@@ -86,6 +108,17 @@ struct fsdata_chksum {
 };
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
 
+#if HTTPD_FS_HASHED
+/** Chunk of a precompiled SSI template: 'len' static bytes of the file data
+ * followed by the insert of tag 'tag' (FS_SSI_NO_TAG for none), padded or
+ * truncated to 'width' bytes unless 'width' is 0. */
+struct fsdata_ssi_chunk {
+  u16_t len;
+  u8_t tag;
+  u8_t width;
+};
+#endif /* HTTPD_FS_HASHED */
+
 struct fs_file {
   const char *data;
   int len;
@@ -96,6 +129,10 @@ struct fs_file {
   u16_t chksum_count;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
   u8_t http_header_included;
+#if HTTPD_FS_HASHED
+  u8_t encoding;
+  const void *entry;
+#endif /* HTTPD_FS_HASHED */
 #if LWIP_HTTPD_CUSTOM_FILES
   u8_t is_custom_file;
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
@@ -109,6 +146,12 @@ typedef void (*fs_wait_cb)(void *arg);
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
 err_t fs_open(struct fs_file *file, const char *name);
+#if HTTPD_FS_HASHED
+err_t fs_open_ex(struct fs_file *file, const char *name, u8_t accept);
+u8_t fs_not_modified(struct fs_file *file, const char *inm, u16_t inm_len);
+const struct fsdata_ssi_chunk *fs_get_ssi_template(struct fs_file *file, u16_t *chunk_count);
+const char *fs_get_ssi_tag_name(u8_t tag);
+#endif /* HTTPD_FS_HASHED */
 void fs_close(struct fs_file *file);
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
 #if LWIP_HTTPD_FS_ASYNC_READ
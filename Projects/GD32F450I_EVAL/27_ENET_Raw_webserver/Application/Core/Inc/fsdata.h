@@ -47,4 +47,32 @@ struct fsdata_file {
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
 };
 
+#if HTTPD_FS_HASHED
+/** One pre-rendered response (HTTP header + body) of a hashed file */
+struct fsdata_variant {
+  const unsigned char *data;
+  int len;
+};
+
+/** Entry of the perfect-hash file table generated by makefshash */
+struct fsdata_hash_file {
+  const unsigned char *name;
+  struct fsdata_variant variant[FS_ENCODING_COUNT];
+  const unsigned char *not_modified;   /* pre-rendered 304 response or NULL */
+  int not_modified_len;
+  const char *etag;                    /* quoted entity tag or NULL */
+  u8_t etag_len;
+  const struct fsdata_ssi_chunk *chunks; /* precompiled SSI template or NULL */
+  u16_t chunk_count;
+  u8_t http_header_included;
+};
+
+/* must match fnv1a()/hash_slot() in Utilities/makefshash/makefshash.py */
+#define FS_HASH_FNV_OFFSET    0x811C9DC5UL
+#define FS_HASH_FNV_PRIME     0x01000193UL
+#define FS_HASH_MIX_MULT      0x9E3779B1UL
+#define FS_HASH_SLOT(h, disp, slots) \
+  ((u32_t)((((u32_t)((h) ^ (disp)) * FS_HASH_MIX_MULT) & 0xFFFFFFFFUL) >> 16) % (slots))
+#endif /* HTTPD_FS_HASHED */
+
 #endif /* __FSDATA_H__ */
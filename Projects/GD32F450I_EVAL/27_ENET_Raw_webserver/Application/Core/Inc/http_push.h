@@ -0,0 +1,92 @@
+/*!
+    \file    http_push.h
+    \brief   the header file of the server-push (Server-Sent-Events) channel
+    
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef HTTP_PUSH_H
+#define HTTP_PUSH_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+#include "lwip/tcp.h"
+#include "stdint.h"
+
+/* maximum number of simultaneously connected event-stream clients */
+#ifndef HTTP_PUSH_MAX_SUBSCRIBERS
+#define HTTP_PUSH_MAX_SUBSCRIBERS       4
+#endif
+
+/* per-subscriber coalescing buffer, events are collected into one segment */
+#ifndef HTTP_PUSH_BUF_SIZE
+#define HTTP_PUSH_BUF_SIZE              TCP_MSS
+#endif
+
+/* maximum time (ms) an event waits in the buffer before it is sent */
+#ifndef HTTP_PUSH_FLUSH_MS
+#define HTTP_PUSH_FLUSH_MS              50U
+#endif
+
+/* an SSE comment is sent after this time (ms) without events to keep proxies open */
+#ifndef HTTP_PUSH_KEEPALIVE_MS
+#define HTTP_PUSH_KEEPALIVE_MS          15000U
+#endif
+
+/* client reconnect delay (ms) announced in the stream */
+#ifndef HTTP_PUSH_RETRY_MS
+#define HTTP_PUSH_RETRY_MS              2000U
+#endif
+
+/* writes the complete current state as the payload of a "state" event, returns its length */
+typedef uint16_t (*http_push_snapshot_fn)(char *buf, uint16_t size);
+
+/* counters of the push channel */
+typedef struct {
+    uint32_t events;            /* events queued, counted once per subscriber */
+    uint32_t segments;          /* tcp_write calls */
+    uint32_t bytes;             /* bytes handed to TCP */
+    uint32_t dropped;           /* events dropped because the client did not keep up */
+    uint32_t resyncs;           /* full states sent after drops */
+} http_push_stats_struct;
+
+/* function declarations */
+/* initialize the push channel, the snapshot is sent to new and resynchronized subscribers */
+void http_push_init(http_push_snapshot_fn snapshot);
+/* queue an event for every subscriber */
+void http_push_publish(const char *event, const char *data, uint16_t len);
+/* send buffered events that have waited long enough, call periodically */
+void http_push_periodic(uint32_t curtime);
+/* get the number of connected subscribers */
+uint8_t http_push_subscribers(void);
+/* get the counters of the push channel */
+void http_push_stats_get(http_push_stats_struct *stats);
+
+#endif /* HTTP_PUSH_H */
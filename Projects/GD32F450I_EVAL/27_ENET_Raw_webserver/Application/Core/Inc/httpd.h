@@ -56,6 +56,17 @@
 #define LWIP_HTTPD_SUPPORT_POST   0
 #endif
 
+/** Set this to 1 to hand connections requesting LWIP_HTTPD_PUSH_URI over to
+ * the application (e.g. for a Server-Sent-Events stream) */
+#ifndef LWIP_HTTPD_PUSH
+#define LWIP_HTTPD_PUSH           0
+#endif
+
+/** URI of the push channel */
+#ifndef LWIP_HTTPD_PUSH_URI
+#define LWIP_HTTPD_PUSH_URI       "/events"
+#endif
+
 
 #if LWIP_HTTPD_CGI
 
@@ -172,6 +183,30 @@ void http_set_ssi_handler(tSSIHandler pfnSSIHandler,
 #define LWIP_HTTPD_MAX_TAG_INSERT_LEN 192
 #endif
 
+/** The maximum number of distinct tags used by the precompiled templates of
+ * the hashed file system (HTTPD_FS_HASHED). Templates are split into static
+ * runs and tag slots by makefshash, so they are sent without scanning. */
+#ifndef LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS
+#define LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS 16
+#endif
+
+/** LWIP_HTTPD_SSI_BENCHMARK==1: account the CPU cycles spent sending SSI
+ * responses in httpd_ssi_bench. The application must provide
+ * "u32_t httpd_ssi_cycle_counter(void)" returning a free-running counter. */
+#ifndef LWIP_HTTPD_SSI_BENCHMARK
+#define LWIP_HTTPD_SSI_BENCHMARK    0
+#endif
+
+#if LWIP_HTTPD_SSI_BENCHMARK
+struct httpd_ssi_bench {
+    u32_t responses;  /* SSI responses completed */
+    u32_t cycles;     /* cycles spent in the SSI send routines for them */
+};
+
+extern struct httpd_ssi_bench httpd_ssi_bench;
+u32_t httpd_ssi_cycle_counter(void);
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+
 #endif /* LWIP_HTTPD_SSI */
 
 #if LWIP_HTTPD_SUPPORT_POST
@@ -231,6 +266,19 @@ void httpd_post_data_recved(void *connection, u16_t recved_len);
 
 #endif /* LWIP_HTTPD_SUPPORT_POST */
 
+#if LWIP_HTTPD_PUSH
+struct tcp_pcb;
+
+/** Called when LWIP_HTTPD_PUSH_URI has been requested. httpd has cleared its
+ * callbacks from the pcb; the application sends the response header itself.
+ *
+ * @param pcb the connection
+ * @return ERR_OK: the application owns the connection now
+ *         another err_t: httpd closes the connection
+ */
+err_t httpd_push_subscribe(struct tcp_pcb *pcb);
+#endif /* LWIP_HTTPD_PUSH */
+
 void httpd_init(void);
 
 #endif /* __HTTPD_H__ */
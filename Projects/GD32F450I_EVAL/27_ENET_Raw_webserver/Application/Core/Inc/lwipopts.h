@@ -118,6 +118,30 @@ OF SUCH DAMAGE.
 /* socket options */
 #define LWIP_SOCKET             0                        /* set to 1 to enable socket API (require to use sockets.c) */
 
+/* httpd options */
+#define HTTPD_FS_HASHED         1                        /* serve the perfect-hash, precompressed file system image
+                                                            (fsdata_hash.c, generated by Utilities/makefshash) */
+
+#define LWIP_HTTPD_SUPPORT_11_KEEPALIVE  1               /* HTTP/1.1 persistent connections with pipelined requests,
+                                                            fsdata_hash.c must be generated with "-11" */
+
+#define HTTPD_USE_MEM_POOL      1                        /* allocate connection states from fixed pools, not the heap */
+
+#define MEMP_NUM_HTTPD_STATE    8                        /* the number of simultaneously served HTTP connections,
+                                                            keep it below MEMP_NUM_TCP_PCB for listen/TIME_WAIT PCBs */
+
+#define MEMP_NUM_HTTPD_SSI_STATE 2                       /* the number of connections sending an SSI template
+                                                            (ADC.shtml, adc.json) at once */
+
+#define LWIP_HTTPD_SSI_BENCHMARK 1                       /* count CPU cycles per SSI response (DWT), reported on
+                                                            the USART and in /adc.json */
+
+#define LWIP_HTTPD_PUSH         1                        /* "/events": Server-Sent-Events stream of ADC and LED
+                                                            changes (http_push.c) */
+
+#define LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED 1    /* evict the oldest (idle first) connection when the
+                                                            state pool is exhausted */
+
 /* Lwip debug options */
 //#define LWIP_DEBUG            1
 
@@ -83,5 +83,9 @@ OF SUCH DAMAGE.
 void time_update(void);
 /* insert a delay time */
 void delay_10ms(uint32_t ncount);
+/* start streaming ADC and LED changes to the push channel */
+void http_telemetry_init(void);
+/* sample the ADC and LEDs and publish changes, call periodically */
+void http_telemetry_periodic(uint32_t curtime);
 
 #endif /* MAIN_H */
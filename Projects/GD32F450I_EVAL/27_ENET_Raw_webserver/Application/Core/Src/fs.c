@@ -41,7 +41,9 @@
 #define HTTPD_USE_CUSTOM_FSDATA 0
 #endif
 
-#if HTTPD_USE_CUSTOM_FSDATA
+#if HTTPD_FS_HASHED
+#include "fsdata_hash.c"
+#elif HTTPD_USE_CUSTOM_FSDATA
 #include "fsdata_custom.c"
 #else /* HTTPD_USE_CUSTOM_FSDATA */
 #include "fsdata.c"
@@ -58,6 +60,178 @@ u8_t fs_wait_read_custom(struct fs_file *file, fs_wait_cb callback_fn, void *cal
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
 
+#if HTTPD_FS_HASHED
+/*-----------------------------------------------------------------------------------*/
+/** 32-bit FNV-1a over a NUL-terminated file name */
+static u32_t
+fs_hash_name(const char *name)
+{
+    u32_t h = FS_HASH_FNV_OFFSET;
+
+    while(*name) {
+        h ^= (u8_t)*name++;
+        h *= FS_HASH_FNV_PRIME;
+    }
+    return h;
+}
+
+/** Look up a file in the perfect-hash table: one hash, one compare */
+static const struct fsdata_hash_file *
+fs_hash_lookup(const char *name)
+{
+    const struct fsdata_hash_file *f;
+    u32_t h = fs_hash_name(name);
+
+    f = &fs_hash_files[FS_HASH_SLOT(h, fs_hash_disp[h % FS_HASH_BUCKETS], FS_HASH_SLOTS)];
+    if(strcmp(name, (const char *)f->name)) {
+        return NULL;
+    }
+    return f;
+}
+
+/*-----------------------------------------------------------------------------------*/
+/**
+ * Open a file and select the smallest pre-rendered variant the client accepts.
+ *
+ * @param file file handle to initialize
+ * @param name file name (URI without parameters)
+ * @param accept FS_ACCEPT_* flags parsed from the Accept-Encoding header
+ * @return ERR_OK if the file was found, ERR_VAL otherwise
+ */
+err_t
+fs_open_ex(struct fs_file *file, const char *name, u8_t accept)
+{
+    const struct fsdata_hash_file *f;
+    u8_t enc;
+
+    if((file == NULL) || (name == NULL)) {
+        return ERR_ARG;
+    }
+
+#if LWIP_HTTPD_CUSTOM_FILES
+    if(fs_open_custom(file, name)) {
+        file->is_custom_file = 1;
+        file->encoding = FS_ENCODING_IDENTITY;
+        file->entry = NULL;
+        return ERR_OK;
+    }
+    file->is_custom_file = 0;
+#endif /* LWIP_HTTPD_CUSTOM_FILES */
+
+    f = fs_hash_lookup(name);
+    if(f == NULL) {
+        /* file not found */
+        return ERR_VAL;
+    }
+
+    /* gzip is preferred over deflate, identity always exists */
+    enc = FS_ENCODING_IDENTITY;
+    if((accept & FS_ACCEPT_GZIP) && (f->variant[FS_ENCODING_GZIP].data != NULL)) {
+        enc = FS_ENCODING_GZIP;
+    } else if((accept & FS_ACCEPT_DEFLATE) && (f->variant[FS_ENCODING_DEFLATE].data != NULL)) {
+        enc = FS_ENCODING_DEFLATE;
+    }
+
+    file->data = (const char *)f->variant[enc].data;
+    file->len = f->variant[enc].len;
+    file->index = f->variant[enc].len;
+    file->pextension = NULL;
+    file->http_header_included = f->http_header_included;
+    file->encoding = enc;
+    file->entry = f;
+#if HTTPD_PRECALCULATED_CHECKSUM
+    file->chksum_count = 0;
+    file->chksum = NULL;
+#endif /* HTTPD_PRECALCULATED_CHECKSUM */
+#if LWIP_HTTPD_FILE_STATE
+    file->state = fs_state_init(file, name);
+#endif /* #if LWIP_HTTPD_FILE_STATE */
+    return ERR_OK;
+}
+
+/*-----------------------------------------------------------------------------------*/
+/**
+ * Check an If-None-Match header value against the file's entity tag and, on
+ * a match, replace the response with the pre-rendered 304 Not Modified.
+ *
+ * @param file an opened file
+ * @param inm the header value (not NUL-terminated, may hold a list of tags)
+ * @param inm_len length of the header value
+ * @return 1 if the file now holds the 304 response, 0 otherwise
+ */
+u8_t
+fs_not_modified(struct fs_file *file, const char *inm, u16_t inm_len)
+{
+    const struct fsdata_hash_file *f;
+    u16_t i;
+    u8_t match = 0;
+
+    if((file == NULL) || (file->entry == NULL) || (inm == NULL)) {
+        return 0;
+    }
+    f = (const struct fsdata_hash_file *)file->entry;
+    if((f->etag == NULL) || (f->not_modified == NULL)) {
+        return 0;
+    }
+
+    if((inm_len == 1) && (inm[0] == '*')) {
+        match = 1;
+    } else if(inm_len >= f->etag_len) {
+        for(i = 0; i <= (u16_t)(inm_len - f->etag_len); i++) {
+            if(!memcmp(&inm[i], f->etag, f->etag_len)) {
+                match = 1;
+                break;
+            }
+        }
+    }
+
+    if(match) {
+        file->data = (const char *)f->not_modified;
+        file->len = f->not_modified_len;
+        file->index = f->not_modified_len;
+        file->encoding = FS_ENCODING_IDENTITY;
+    }
+    return match;
+}
+
+/*-----------------------------------------------------------------------------------*/
+/** Get the precompiled SSI template of an opened file.
+ *
+ * @param file opened file
+ * @param chunk_count receives the number of chunks
+ * @return the chunk table or NULL if the file has no SSI tags
+ */
+const struct fsdata_ssi_chunk *
+fs_get_ssi_template(struct fs_file *file, u16_t *chunk_count)
+{
+    const struct fsdata_hash_file *f;
+
+    if((file == NULL) || (file->entry == NULL)) {
+        return NULL;
+    }
+    f = (const struct fsdata_hash_file *)file->entry;
+    *chunk_count = f->chunk_count;
+    return f->chunks;
+}
+
+/*-----------------------------------------------------------------------------------*/
+/** Get the name of a template tag index, NULL if out of range */
+const char *
+fs_get_ssi_tag_name(u8_t tag)
+{
+    if(tag >= FS_SSI_NUMTAGS) {
+        return NULL;
+    }
+    return fs_ssi_tag_names[tag];
+}
+
+/*-----------------------------------------------------------------------------------*/
+err_t
+fs_open(struct fs_file *file, const char *name)
+{
+    return fs_open_ex(file, name, 0);
+}
+#else /* HTTPD_FS_HASHED */
 /*-----------------------------------------------------------------------------------*/
 err_t
 fs_open(struct fs_file *file, const char *name)
@@ -97,6 +271,8 @@ fs_open(struct fs_file *file, const char *name)
     return ERR_VAL;
 }
 
+#endif /* HTTPD_FS_HASHED */
+
 /*-----------------------------------------------------------------------------------*/
 void
 fs_close(struct fs_file *file)
@@ -35,16 +35,70 @@ OF SUCH DAMAGE.
 #include "lwip/debug.h"
 #include "httpd.h"
 #include "lwip/tcp.h"
+#include "lwip/sys.h"
 #include "fs.h"
+#include "http_push.h"
 #include "main.h"
 #include "gd32f450i_eval.h"
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
+/* report the SSI benchmark on the USART every this many responses */
+#define SSI_BENCH_REPORT_INTERVAL   64U
 
-/* ssi handler for ADC monitor check for tag "gd" */
-char const *http_adc_tag = "gd";
-char const **ssi_tag = &http_adc_tag;
+/* ADC sampling period of the push channel (ms) */
+#define TELEMETRY_INTERVAL_MS       100U
+/* smallest ADC change (mV) that is pushed */
+#define TELEMETRY_ADC_DELTA_MV      4U
+
+/* ssi tags: ADC monitor "gd", and the values of the JSON endpoint /adc.json */
+enum {
+    SSI_TAG_ADC = 0,
+    SSI_TAG_LED,
+    SSI_TAG_TICK,
+    SSI_TAG_CYCLES,
+    SSI_TAG_NUM
+};
+char const *ssi_tags[SSI_TAG_NUM] = {"gd", "led", "ms", "cyc"};
+char const **ssi_tag = ssi_tags;
+
+/* LEDs switched on by the last cgi request, bit n for LEDn+1 */
+static uint8_t led_state = 0U;
+
+/* last values published on the push channel */
+static uint32_t telemetry_time = 0U;
+static uint32_t telemetry_adc_mv = 0U;
+static uint8_t telemetry_led = 0U;
+
+/*!
+    \brief      read the ADC voltage
+    \param[in]  none
+    \param[out] none
+    \retval     voltage in mV
+*/
+static uint32_t adc_voltage_get(void)
+{
+    uint32_t adc_val = adc_inserted_data_read(ADC0, ADC_INSERTED_CHANNEL_0);
+
+    return (uint32_t)(adc_val * 3300 / 4096);
+}
+
+/*!
+    \brief      format the LED states as "1,0,0" (LED1..LED3)
+    \param[in]  leds: LED state bits
+    \param[out] buf: at least 5 characters
+    \retval     number of characters written
+*/
+static u16_t led_state_format(uint8_t leds, char *buf)
+{
+    buf[0] = (leds & 0x01U) ? '1' : '0';
+    buf[1] = ',';
+    buf[2] = (leds & 0x02U) ? '1' : '0';
+    buf[3] = ',';
+    buf[4] = (leds & 0x04U) ? '1' : '0';
+    return 5;
+}
 
 /* cgi call table */
 tCGI cgi_table[1];
@@ -61,11 +115,21 @@ u16_t http_adc_monitor(int iIndex, char *pcInsert, int iInsertLen)
 {
     char val_1, val_2, val_3, val_4;
     uint32_t adc_val = 0;
+#if LWIP_HTTPD_SSI_BENCHMARK
+    static uint32_t reported = 0U;
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+
+    if(SSI_TAG_ADC == iIndex) {
+#if LWIP_HTTPD_SSI_BENCHMARK
+        if((httpd_ssi_bench.responses - reported) >= SSI_BENCH_REPORT_INTERVAL) {
+            reported = httpd_ssi_bench.responses;
+            printf("\r\nssi: %lu responses, %lu cycles per response\r\n", (unsigned long)reported,
+                   (unsigned long)(httpd_ssi_bench.cycles / reported));
+        }
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
 
-    if(0 == iIndex) {
         /* get ADC conversion value */
-        adc_val = adc_inserted_data_read(ADC0, ADC_INSERTED_CHANNEL_0);
-        adc_val = (uint32_t)(adc_val * 3300 / 4096);
+        adc_val = adc_voltage_get();
 
         /* get digits to display */
         val_1 = adc_val / 1000;
@@ -81,10 +145,33 @@ u16_t http_adc_monitor(int iIndex, char *pcInsert, int iInsertLen)
 
         /* 4 characters need to be inserted in html*/
         return 4;
+    } else if(SSI_TAG_LED == iIndex) {
+        return led_state_format(led_state, pcInsert);
+    } else if(SSI_TAG_TICK == iIndex) {
+        return (u16_t)snprintf(pcInsert, iInsertLen, "%lu", (unsigned long)sys_now());
+    } else if(SSI_TAG_CYCLES == iIndex) {
+#if LWIP_HTTPD_SSI_BENCHMARK
+        if(0U != httpd_ssi_bench.responses) {
+            return (u16_t)snprintf(pcInsert, iInsertLen, "%lu",
+                                   (unsigned long)(httpd_ssi_bench.cycles / httpd_ssi_bench.responses));
+        }
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+        pcInsert[0] = '0';
+        return 1;
     }
     return 0;
 }
 
+#if LWIP_HTTPD_SSI_BENCHMARK
+/*!
+    \brief      cycle counter for the httpd SSI benchmark
+*/
+u32_t httpd_ssi_cycle_counter(void)
+{
+    return DWT->CYCCNT;
+}
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+
 /*!
     \brief      cgi handler for LED control
 */
@@ -96,6 +183,7 @@ const char *http_led_control(int iIndex, int iNumParams, char *pcParam[], char *
         gd_eval_led_off(LED1);
         gd_eval_led_off(LED2);
         gd_eval_led_off(LED3);
+        led_state = 0U;
 
         /* check cgi parameter */
         for(i = 0; i < iNumParams; i++) {
@@ -104,13 +192,16 @@ const char *http_led_control(int iIndex, int iNumParams, char *pcParam[], char *
 
                 if(0 == strcmp(pcValue[i], "1")) {
                     gd_eval_led_on(LED1);
+                    led_state |= 0x01U;
 
                 } else if(0 == strcmp(pcValue[i], "2")) {
                     gd_eval_led_on(LED2);
+                    led_state |= 0x02U;
 
 
                 } else if(0 == strcmp(pcValue[i], "3")) {
                     gd_eval_led_on(LED3);
+                    led_state |= 0x04U;
 
                 }
             }
@@ -120,12 +211,86 @@ const char *http_led_control(int iIndex, int iNumParams, char *pcParam[], char *
     return "/LED.html";
 }
 
+/*!
+    \brief      write the complete telemetry state for a new event subscriber
+    \param[in]  size: size of buf
+    \param[out] buf: JSON object
+    \retval     number of characters written
+*/
+static uint16_t http_telemetry_snapshot(char *buf, uint16_t size)
+{
+    char leds[5];
+    int len;
+
+    led_state_format(telemetry_led, leds);
+    len = snprintf(buf, size, "{\"adc_mv\":%lu,\"led\":[%.5s]}", (unsigned long)telemetry_adc_mv, leds);
+    if((len < 0) || (len >= size)) {
+        return 0U;
+    }
+    return (uint16_t)len;
+}
+
+/*!
+    \brief      start streaming ADC and LED changes to the push channel
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void http_telemetry_init(void)
+{
+    telemetry_adc_mv = adc_voltage_get();
+    telemetry_led = led_state;
+    http_push_init(http_telemetry_snapshot);
+}
+
+/*!
+    \brief      sample the ADC and LEDs and publish changes as "adc" and "led" events
+    \param[in]  curtime: current time in ms
+    \param[out] none
+    \retval     none
+*/
+void http_telemetry_periodic(uint32_t curtime)
+{
+    char buf[12];
+    uint32_t adc_mv;
+    int len;
+
+    if((curtime - telemetry_time) < TELEMETRY_INTERVAL_MS) {
+        return;
+    }
+    telemetry_time = curtime;
+    if(0U == http_push_subscribers()) {
+        /* nobody listens, the snapshot reads the state on connect */
+        telemetry_adc_mv = adc_voltage_get();
+        telemetry_led = led_state;
+        return;
+    }
+
+    adc_mv = adc_voltage_get();
+    if(((adc_mv > telemetry_adc_mv) ? (adc_mv - telemetry_adc_mv) : (telemetry_adc_mv - adc_mv)) >= TELEMETRY_ADC_DELTA_MV) {
+        telemetry_adc_mv = adc_mv;
+        len = snprintf(buf, sizeof(buf), "%lu", (unsigned long)adc_mv);
+        http_push_publish("adc", buf, (uint16_t)len);
+    }
+    if(led_state != telemetry_led) {
+        telemetry_led = led_state;
+        len = led_state_format(led_state, buf);
+        http_push_publish("led", buf, (uint16_t)len);
+    }
+}
+
 /*!
     \brief      init ssi handler
 */
 void httpd_ssi_init(void)
 {
-    http_set_ssi_handler(http_adc_monitor, (char const **)ssi_tag, 1);
+#if LWIP_HTTPD_SSI_BENCHMARK
+    /* start the DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+    http_set_ssi_handler(http_adc_monitor, (char const **)ssi_tag, SSI_TAG_NUM);
 }
 
 /*!
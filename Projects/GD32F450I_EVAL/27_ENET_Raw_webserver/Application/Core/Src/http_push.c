@@ -0,0 +1,443 @@
+/*!
+    \file    http_push.c
+    \brief   server-push channel: Server-Sent-Events stream for the webserver
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "http_push.h"
+#include "httpd.h"
+#include "lwip/sys.h"
+#include <stdio.h>
+#include <string.h>
+
+/* largest snapshot a "state" event can carry */
+#define HTTP_PUSH_STATE_MAX_LEN     192U
+
+#define SSE_EVENT                   "event: "
+#define SSE_DATA                    "\ndata: "
+#define SSE_END                     "\n\n"
+#define SSE_KEEPALIVE               ":\n\n"
+
+/* response header of the event stream, the stream itself has no length */
+static const char http_push_header[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Server: lwIP/2.1.2 (http://savannah.nongnu.org/projects/lwip)\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+typedef struct {
+    struct tcp_pcb *pcb;                    /* NULL if the slot is free */
+    uint16_t len;                           /* bytes waiting in buf */
+    uint8_t resync;                         /* events were dropped, send the full state next */
+    uint8_t blocked;                        /* the last flush was limited by the send buffer */
+    uint32_t first_time;                    /* time the oldest byte in buf was queued */
+    uint32_t last_time;                     /* time of the last write to TCP */
+    char buf[HTTP_PUSH_BUF_SIZE];           /* coalescing buffer */
+} http_push_subscriber_struct;
+
+static http_push_subscriber_struct push_subscriber[HTTP_PUSH_MAX_SUBSCRIBERS];
+static http_push_snapshot_fn push_snapshot = NULL;
+static http_push_stats_struct push_stats;
+
+static err_t push_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+static err_t push_sent(void *arg, struct tcp_pcb *pcb, u16_t len);
+static void push_err(void *arg, err_t err);
+
+/*!
+    \brief      close a subscriber connection and free its slot
+    \param[in]  sub: subscriber
+    \param[out] none
+    \retval     ERR_ABRT if the connection had to be aborted, ERR_OK otherwise
+*/
+static err_t push_close(http_push_subscriber_struct *sub)
+{
+    struct tcp_pcb *pcb = sub->pcb;
+
+    sub->pcb = NULL;
+    sub->len = 0U;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+    if(ERR_OK != tcp_close(pcb)) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+/*!
+    \brief      hand buffered events to TCP as far as the send buffer allows
+    \param[in]  sub: subscriber
+    \param[out] none
+    \retval     ERR_OK if the buffer is empty now
+*/
+static err_t push_flush(http_push_subscriber_struct *sub)
+{
+    struct tcp_pcb *pcb = sub->pcb;
+    uint16_t len = sub->len;
+    err_t err;
+
+    if(0U == len) {
+        return ERR_OK;
+    }
+    /* backpressure: never queue more than TCP can take right now */
+    if(tcp_sndqueuelen(pcb) >= (TCP_SND_QUEUELEN - 1)) {
+        len = 0U;
+    } else if(len > tcp_sndbuf(pcb)) {
+        len = tcp_sndbuf(pcb);
+    }
+    if(0U == len) {
+        sub->blocked = 1U;
+        return ERR_MEM;
+    }
+
+    err = tcp_write(pcb, sub->buf, len, TCP_WRITE_FLAG_COPY);
+    if(ERR_OK != err) {
+        sub->blocked = 1U;
+        return err;
+    }
+    tcp_output(pcb);
+    push_stats.segments++;
+    push_stats.bytes += len;
+    sub->last_time = sys_now();
+    sub->len -= len;
+    if(0U != sub->len) {
+        memmove(sub->buf, &sub->buf[len], sub->len);
+        sub->first_time = sub->last_time;
+        sub->blocked = 1U;
+        return ERR_MEM;
+    }
+    sub->blocked = 0U;
+    return ERR_OK;
+}
+
+/*!
+    \brief      append raw bytes to the coalescing buffer, a full buffer is flushed first
+    \param[in]  sub: subscriber
+    \param[in]  parts: data pieces to append as one unit
+    \param[in]  lens: lengths of the pieces
+    \param[in]  num: number of pieces
+    \param[out] none
+    \retval     1 if appended, 0 if there is no room (nothing appended)
+*/
+static uint8_t push_append(http_push_subscriber_struct *sub, const char *const *parts,
+                           const uint16_t *lens, uint8_t num)
+{
+    uint32_t total = 0U;
+    uint8_t i;
+
+    for(i = 0U; i < num; i++) {
+        total += lens[i];
+    }
+    if((sub->len + total) > HTTP_PUSH_BUF_SIZE) {
+        /* the segment is full: send it, then start the next one */
+        push_flush(sub);
+        if((sub->len + total) > HTTP_PUSH_BUF_SIZE) {
+            return 0U;
+        }
+    }
+    if(0U == sub->len) {
+        sub->first_time = sys_now();
+    }
+    for(i = 0U; i < num; i++) {
+        memcpy(&sub->buf[sub->len], parts[i], lens[i]);
+        sub->len += lens[i];
+    }
+    return 1U;
+}
+
+/*!
+    \brief      append one event to the coalescing buffer
+    \param[in]  sub: subscriber
+    \param[in]  event: event name
+    \param[in]  data: event payload (one line)
+    \param[in]  len: payload length
+    \param[out] none
+    \retval     1 if appended, 0 if there is no room
+*/
+static uint8_t push_append_event(http_push_subscriber_struct *sub, const char *event,
+                                 const char *data, uint16_t len)
+{
+    const char *parts[5];
+    uint16_t lens[5];
+
+    parts[0] = SSE_EVENT;
+    lens[0] = sizeof(SSE_EVENT) - 1U;
+    parts[1] = event;
+    lens[1] = (uint16_t)strlen(event);
+    parts[2] = SSE_DATA;
+    lens[2] = sizeof(SSE_DATA) - 1U;
+    parts[3] = data;
+    lens[3] = len;
+    parts[4] = SSE_END;
+    lens[4] = sizeof(SSE_END) - 1U;
+
+    return push_append(sub, parts, lens, 5U);
+}
+
+/*!
+    \brief      send the full current state to a subscriber that missed events
+    \param[in]  sub: subscriber
+    \param[out] none
+    \retval     none
+*/
+static void push_resync(http_push_subscriber_struct *sub)
+{
+    char state[HTTP_PUSH_STATE_MAX_LEN];
+    uint16_t len;
+
+    if(NULL == push_snapshot) {
+        sub->resync = 0U;
+        return;
+    }
+    len = push_snapshot(state, sizeof(state));
+    if(push_append_event(sub, "state", state, len)) {
+        sub->resync = 0U;
+        push_stats.resyncs++;
+    }
+}
+
+/*!
+    \brief      initialize the push channel
+    \param[in]  snapshot: writes the complete state for new and resynchronized subscribers, may be NULL
+    \param[out] none
+    \retval     none
+*/
+void http_push_init(http_push_snapshot_fn snapshot)
+{
+    memset(push_subscriber, 0, sizeof(push_subscriber));
+    memset(&push_stats, 0, sizeof(push_stats));
+    push_snapshot = snapshot;
+}
+
+/*!
+    \brief      take over a connection that requested the event stream (called by httpd)
+    \param[in]  pcb: connection, its callbacks have been cleared by httpd
+    \param[out] none
+    \retval     ERR_OK if the connection is a subscriber now, ERR_MEM if all slots are in use
+*/
+err_t httpd_push_subscribe(struct tcp_pcb *pcb)
+{
+    http_push_subscriber_struct *sub = NULL;
+    const char *parts[2];
+    uint16_t lens[2];
+    char retry[24];
+    uint8_t i;
+
+    for(i = 0U; i < HTTP_PUSH_MAX_SUBSCRIBERS; i++) {
+        if(NULL == push_subscriber[i].pcb) {
+            sub = &push_subscriber[i];
+            break;
+        }
+    }
+    if(NULL == sub) {
+        return ERR_MEM;
+    }
+
+    sub->pcb = pcb;
+    sub->len = 0U;
+    sub->blocked = 0U;
+    sub->last_time = sys_now();
+    tcp_arg(pcb, sub);
+    tcp_recv(pcb, push_recv);
+    tcp_sent(pcb, push_sent);
+    tcp_err(pcb, push_err);
+    /* events are coalesced here, Nagle would only add latency */
+    tcp_nagle_disable(pcb);
+
+    parts[0] = http_push_header;
+    lens[0] = sizeof(http_push_header) - 1U;
+    parts[1] = retry;
+    lens[1] = (uint16_t)snprintf(retry, sizeof(retry), "retry: %u\n\n", (unsigned int)HTTP_PUSH_RETRY_MS);
+    push_append(sub, parts, lens, 2U);
+    /* a new subscriber starts with the complete state, then gets deltas */
+    sub->resync = 1U;
+    push_resync(sub);
+    push_flush(sub);
+    return ERR_OK;
+}
+
+/*!
+    \brief      queue an event for every subscriber
+    \param[in]  event: event name
+    \param[in]  data: event payload, must not contain a line break
+    \param[in]  len: payload length
+    \param[out] none
+    \retval     none
+*/
+void http_push_publish(const char *event, const char *data, uint16_t len)
+{
+    http_push_subscriber_struct *sub;
+    uint8_t i;
+
+    for(i = 0U; i < HTTP_PUSH_MAX_SUBSCRIBERS; i++) {
+        sub = &push_subscriber[i];
+        if(NULL == sub->pcb) {
+            continue;
+        }
+        if(sub->resync) {
+            /* the full state includes this change, if it fits now */
+            push_resync(sub);
+            if(sub->resync) {
+                push_stats.dropped++;
+            }
+            continue;
+        }
+        if(push_append_event(sub, event, data, len)) {
+            push_stats.events++;
+        } else {
+            /* the client does not keep up: drop deltas until the state fits again */
+            push_stats.dropped++;
+            sub->resync = 1U;
+        }
+    }
+}
+
+/*!
+    \brief      send events that have waited HTTP_PUSH_FLUSH_MS and keep idle streams open
+    \param[in]  curtime: current time in ms
+    \param[out] none
+    \retval     none
+*/
+void http_push_periodic(uint32_t curtime)
+{
+    http_push_subscriber_struct *sub;
+    const char *parts[1];
+    uint16_t lens[1];
+    uint8_t i;
+
+    for(i = 0U; i < HTTP_PUSH_MAX_SUBSCRIBERS; i++) {
+        sub = &push_subscriber[i];
+        if(NULL == sub->pcb) {
+            continue;
+        }
+        if(sub->resync) {
+            push_resync(sub);
+        }
+        if((0U == sub->len) && ((curtime - sub->last_time) >= HTTP_PUSH_KEEPALIVE_MS)) {
+            parts[0] = SSE_KEEPALIVE;
+            lens[0] = sizeof(SSE_KEEPALIVE) - 1U;
+            push_append(sub, parts, lens, 1U);
+            push_flush(sub);
+        } else if((0U != sub->len) && ((curtime - sub->first_time) >= HTTP_PUSH_FLUSH_MS)) {
+            push_flush(sub);
+        }
+    }
+}
+
+/*!
+    \brief      get the number of connected subscribers
+    \param[in]  none
+    \param[out] none
+    \retval     number of subscribers
+*/
+uint8_t http_push_subscribers(void)
+{
+    uint8_t i, num = 0U;
+
+    for(i = 0U; i < HTTP_PUSH_MAX_SUBSCRIBERS; i++) {
+        if(NULL != push_subscriber[i].pcb) {
+            num++;
+        }
+    }
+    return num;
+}
+
+/*!
+    \brief      get the counters of the push channel
+    \param[in]  none
+    \param[out] stats: copy of the counters
+    \retval     none
+*/
+void http_push_stats_get(http_push_stats_struct *stats)
+{
+    *stats = push_stats;
+}
+
+/*!
+    \brief      subscriber receive callback: requests are ignored, FIN closes the stream
+*/
+static err_t push_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    http_push_subscriber_struct *sub = (http_push_subscriber_struct *)arg;
+
+    if((NULL == p) || (ERR_OK != err)) {
+        if(NULL != p) {
+            tcp_recved(pcb, p->tot_len);
+            pbuf_free(p);
+        }
+        if(NULL != sub) {
+            return push_close(sub);
+        }
+        return ERR_OK;
+    }
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+/*!
+    \brief      subscriber sent callback: send space became available
+*/
+static err_t push_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    http_push_subscriber_struct *sub = (http_push_subscriber_struct *)arg;
+
+    LWIP_UNUSED_ARG(pcb);
+    LWIP_UNUSED_ARG(len);
+    if(NULL == sub) {
+        return ERR_OK;
+    }
+    if(sub->blocked) {
+        push_flush(sub);
+    }
+    if(sub->resync) {
+        push_resync(sub);
+    }
+    return ERR_OK;
+}
+
+/*!
+    \brief      subscriber error callback: the pcb has already been freed
+*/
+static void push_err(void *arg, err_t err)
+{
+    http_push_subscriber_struct *sub = (http_push_subscriber_struct *)arg;
+
+    LWIP_UNUSED_ARG(err);
+    if(NULL != sub) {
+        sub->pcb = NULL;
+        sub->len = 0U;
+    }
+}
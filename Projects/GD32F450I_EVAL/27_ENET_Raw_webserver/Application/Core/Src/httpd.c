@@ -64,6 +64,14 @@
  *    the tag name and between the tag name and the leadout string "-->".
  * 3. The maximum tag name length is LWIP_HTTPD_MAX_TAG_NAME_LEN, currently 8 characters.
  *
+ * With HTTPD_FS_HASHED, makefshash locates the tags at build time (also in
+ * .json files): the tag text is removed from the image and each file gets a
+ * table of static runs and tag slots, which is sent without scanning. Such a
+ * tag replaces rather than follows the marker. A slot may have a fixed width,
+ * <!--#tag:W-->, the insert is then padded with spaces or truncated to W
+ * characters so that the response carries a Content-Length and the
+ * connection can be kept alive.
+ *
  * Notes on CGI usage
  * ------------------
  *
@@ -84,6 +92,7 @@
 #include "lwip/stats.h"
 #include "httpd_structs.h"
 #include "lwip/tcp.h"
+#include "lwip/memp.h"
 #include "fs.h"
 
 #include <string.h>
@@ -95,15 +104,25 @@
 #define HTTPD_DEBUG         LWIP_DBG_OFF
 #endif
 
-/** Set this to 1 and add the next line to lwippools.h to use a memp pool
- * for allocating struct http_state instead of the heap:
- *
- * LWIP_MEMPOOL(HTTPD_STATE, 20, 100, "HTTPD_STATE")
+/** Set this to 1 to allocate struct http_state and struct http_ssi_state
+ * from private memp pools (sized by MEMP_NUM_HTTPD_STATE and
+ * MEMP_NUM_HTTPD_SSI_STATE) instead of the heap.
  */
 #ifndef HTTPD_USE_MEM_POOL
 #define HTTPD_USE_MEM_POOL  0
 #endif
 
+#if HTTPD_USE_MEM_POOL
+/** Number of pooled connection states (at most one per TCP connection) */
+#ifndef MEMP_NUM_HTTPD_STATE
+#define MEMP_NUM_HTTPD_STATE                4
+#endif
+/** Number of pooled SSI parser states (one per connection serving a .shtml) */
+#ifndef MEMP_NUM_HTTPD_SSI_STATE
+#define MEMP_NUM_HTTPD_SSI_STATE            2
+#endif
+#endif /* HTTPD_USE_MEM_POOL */
+
 /** The server port for HTTPD to use */
 #ifndef HTTPD_SERVER_PORT
 #define HTTPD_SERVER_PORT                   80
@@ -166,6 +185,32 @@
 #define LWIP_HTTPD_SUPPORT_REQUESTLIST      1
 #endif
 
+/** Set this to 1 to queue pipelined requests: requests that arrive on a
+ * persistent connection while the previous response is still being sent are
+ * kept and answered in order once that response is finished.
+ */
+#ifndef LWIP_HTTPD_SUPPORT_PIPELINING
+#define LWIP_HTTPD_SUPPORT_PIPELINING       LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+#endif
+
+#if LWIP_HTTPD_SUPPORT_PIPELINING && !(LWIP_HTTPD_SUPPORT_11_KEEPALIVE && LWIP_HTTPD_SUPPORT_REQUESTLIST)
+#error "LWIP_HTTPD_SUPPORT_PIPELINING needs LWIP_HTTPD_SUPPORT_11_KEEPALIVE and LWIP_HTTPD_SUPPORT_REQUESTLIST"
+#endif
+
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+/** Maximum number of bytes of pipelined requests queued per connection;
+    a client exceeding this is disconnected */
+#ifndef LWIP_HTTPD_PIPELINE_BUFSIZE
+#define LWIP_HTTPD_PIPELINE_BUFSIZE         1460
+#endif
+
+/** Maximum number of queued requests answered recursively from the end of
+    the previous response; further ones are answered from http_sent/http_poll */
+#ifndef LWIP_HTTPD_PIPELINE_DEPTH
+#define LWIP_HTTPD_PIPELINE_DEPTH           2
+#endif
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
 /** Number of rx pbufs to enqueue to parse an incoming request (up to the first
     newline) */
@@ -209,17 +254,35 @@
 
 /** Set this to 1 to kill the oldest connection when running out of
  * memory for 'struct http_state' or 'struct http_ssi_state'.
+ * Idle persistent connections are evicted first.
  * ATTENTION: This puts all connections on a linked list, so may be kind of slow.
  */
 #ifndef LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
 #define LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED 0
 #endif
 
+/** TIME_WAIT-aware close policy: when the idle timeout closes a persistent
+ * connection while at least this many connections are open, the connection
+ * is reset instead of closed. Its PCB is then freed at once instead of
+ * spending 2*MSL in TIME_WAIT on our side, so the PCB pool (MEMP_NUM_TCP_PCB)
+ * is not drained by browsers that keep several idle connections open.
+ * Set to 0 to always close gracefully.
+ */
+#ifndef HTTPD_IDLE_RST_THRESHOLD
+#define HTTPD_IDLE_RST_THRESHOLD            (MEMP_NUM_TCP_PCB / 2)
+#endif
+
 /** Minimum length for a valid HTTP/0.9 request: "GET /\r\n" -> 7 bytes */
 #define MIN_REQ_LEN   7
 
 #define CRLF "\r\n"
 #define HTTP11_CONNECTIONKEEPALIVE "Connection: keep-alive"
+#define HTTP11_VERSION "HTTP/1.1"
+#define HTTP_HDR_CONNECTION "Connection:"
+#define HTTP_CONN_KEEPALIVE "keep-alive"
+#define HTTP_CONN_CLOSE "close"
+#define HTTP_HDR_ACCEPT_ENCODING "Accept-Encoding:"
+#define HTTP_HDR_IF_NONE_MATCH "If-None-Match:"
 
 #if LWIP_HTTPD_SSI
 #define LWIP_HTTPD_IS_SSI(hs) ((hs)->ssi)
@@ -227,6 +290,14 @@
 #define LWIP_HTTPD_IS_SSI(hs) 0
 #endif /* LWIP_HTTPD_SSI */
 
+#if LWIP_HTTPD_SSI && HTTPD_FS_HASHED
+/* Precompiled templates whose tags all have a fixed width carry a
+   Content-Length, so the connection can be kept alive after them */
+#define LWIP_HTTPD_SSI_HAS_LENGTH(hs) ((hs)->ssi->fixed_len)
+#else /* LWIP_HTTPD_SSI && HTTPD_FS_HASHED */
+#define LWIP_HTTPD_SSI_HAS_LENGTH(hs) 0
+#endif /* LWIP_HTTPD_SSI && HTTPD_FS_HASHED */
+
 /** These defines check whether tcp_write has to copy data or not */
 
 /** This was TI's check whether to let TCP copy data or not
@@ -261,11 +332,15 @@
 #define HTTP_NO_DATA_TO_SEND       0
 
 #if HTTPD_USE_MEM_POOL
-#define HTTP_ALLOC_SSI_STATE()  (struct http_ssi_state *)memp_malloc(MEMP_HTTPD_SSI_STATE)
-#define HTTP_ALLOC_HTTP_STATE() (struct http_state *)memp_malloc(MEMP_HTTPD_STATE)
+#define HTTP_ALLOC_SSI_STATE()  (struct http_ssi_state *)LWIP_MEMPOOL_ALLOC(HTTPD_SSI_STATE)
+#define HTTP_ALLOC_HTTP_STATE() (struct http_state *)LWIP_MEMPOOL_ALLOC(HTTPD_STATE)
+#define HTTP_FREE_SSI_STATE(x)  LWIP_MEMPOOL_FREE(HTTPD_SSI_STATE, (x))
+#define HTTP_FREE_HTTP_STATE(x) LWIP_MEMPOOL_FREE(HTTPD_STATE, (x))
 #else /* HTTPD_USE_MEM_POOL */
 #define HTTP_ALLOC_SSI_STATE()  (struct http_ssi_state *)mem_malloc(sizeof(struct http_ssi_state))
 #define HTTP_ALLOC_HTTP_STATE() (struct http_state *)mem_malloc(sizeof(struct http_state))
+#define HTTP_FREE_SSI_STATE(x)  mem_free(x)
+#define HTTP_FREE_HTTP_STATE(x) mem_free(x)
 #endif /* HTTPD_USE_MEM_POOL */
 
 typedef struct {
@@ -329,6 +404,18 @@ struct http_ssi_state {
     char tag_name[LWIP_HTTPD_MAX_TAG_NAME_LEN + 1]; /* Last tag name extracted */
     char tag_insert[LWIP_HTTPD_MAX_TAG_INSERT_LEN + 1]; /* Insert string for tag_name */
     enum tag_check_state tag_state; /* State of the tag processor */
+#if HTTPD_FS_HASHED
+    const struct fsdata_ssi_chunk *chunk; /* Current chunk of a precompiled template */
+    u16_t chunks_left;    /* Chunks left including 'chunk', 0 when the template is done */
+    u16_t run_left;       /* Static bytes of 'chunk' not yet sent */
+    u16_t tag_width_left; /* Bytes of a fixed-width tag slot not yet filled */
+    u8_t tag_pending;     /* The tag of 'chunk' still has to be inserted */
+    u8_t precompiled;     /* Sent from a template, the tag scanner is not used */
+    u8_t fixed_len;       /* All tag slots have a fixed width */
+#endif /* HTTPD_FS_HASHED */
+#if LWIP_HTTPD_SSI_BENCHMARK
+    u32_t cycles;         /* Cycles spent sending this response */
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
 };
 #endif /* LWIP_HTTPD_SSI */
 
@@ -344,6 +431,10 @@ struct http_state {
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
     struct pbuf *req;
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+    struct pbuf *pipeline; /* Requests received while a response was being sent */
+    u16_t req_consumed;    /* Bytes of 'req' taken by the request just parsed */
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
 
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
     char *buf;        /* File read buffer. */
@@ -354,9 +445,22 @@ struct http_state {
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
     u8_t keepalive;
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    u8_t conn_pos;    /* Bytes of "close" sent in place of 'conn_value' */
+    const char *conn_value; /* "keep-alive" in the pre-rendered header of a
+                               response that closes the connection, or NULL */
+#endif /* HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if HTTPD_FS_HASHED
+    u8_t accept_enc;  /* FS_ACCEPT_* flags from the Accept-Encoding header */
+    u16_t inm_len;    /* Length of the If-None-Match value */
+    const char *inm;  /* If-None-Match value, only valid while parsing */
+#endif /* HTTPD_FS_HASHED */
 #if LWIP_HTTPD_SSI
     struct http_ssi_state *ssi;
 #endif /* LWIP_HTTPD_SSI */
+#if LWIP_HTTPD_PUSH
+    u8_t push;        /* LWIP_HTTPD_PUSH_URI was requested */
+#endif /* LWIP_HTTPD_PUSH */
 #if LWIP_HTTPD_CGI
     char *params[LWIP_HTTPD_MAX_CGI_PARAMETERS]; /* Params extracted from the request URI */
     char *param_vals[LWIP_HTTPD_MAX_CGI_PARAMETERS]; /* Values for each extracted param */
@@ -380,6 +484,13 @@ struct http_state {
 #endif /* LWIP_HTTPD_SUPPORT_POST*/
 };
 
+#if HTTPD_USE_MEM_POOL
+LWIP_MEMPOOL_DECLARE(HTTPD_STATE, MEMP_NUM_HTTPD_STATE, sizeof(struct http_state), "HTTPD_STATE")
+#if LWIP_HTTPD_SSI
+LWIP_MEMPOOL_DECLARE(HTTPD_SSI_STATE, MEMP_NUM_HTTPD_SSI_STATE, sizeof(struct http_ssi_state), "HTTPD_SSI_STATE")
+#endif /* LWIP_HTTPD_SSI */
+#endif /* HTTPD_USE_MEM_POOL */
+
 #ifdef LWIP_HTTPD_SSI
 extern void httpd_ssi_init(void);
 #endif
@@ -392,7 +503,11 @@ static err_t http_close_conn(struct tcp_pcb *pcb, struct http_state *hs);
 static err_t http_close_or_abort_conn(struct tcp_pcb *pcb, struct http_state *hs, u8_t abort_conn);
 static err_t http_find_file(struct http_state *hs, const char *uri, int is_09);
 static err_t http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const char *uri, u8_t tag_check);
+#if LWIP_HTTPD_SSI
+static err_t http_ssi_init_file(struct http_state *hs, struct fs_file *file, u8_t tag_check);
+#endif /* LWIP_HTTPD_SSI */
 static err_t http_poll(void *arg, struct tcp_pcb *pcb);
+static void http_handle_request(struct tcp_pcb *pcb, struct http_state *hs, struct pbuf *p);
 #if LWIP_HTTPD_FS_ASYNC_READ
 static void http_continue(void *connection);
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
@@ -400,6 +515,13 @@ static void http_continue(void *connection);
 #if LWIP_HTTPD_SSI
 /* SSI insert handler function pointer. */
 tSSIHandler g_pfnSSIHandler = NULL;
+#if HTTPD_FS_HASHED
+/* Template tag index -> index into g_ppcTags, resolved once when the handler is set */
+static u8_t g_ssi_tag_map[LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS];
+#endif /* HTTPD_FS_HASHED */
+#if LWIP_HTTPD_SSI_BENCHMARK
+struct httpd_ssi_bench httpd_ssi_bench;
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
 int g_iNumTags = 0;
 const char **g_ppcTags = NULL;
 
@@ -422,6 +544,26 @@ int g_iNumCGIs;
 static struct http_state *http_connections;
 #endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
 
+/** number of allocated struct http_state (open connections) */
+static u16_t http_conn_count;
+
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+/** nesting of requests answered from the end of a previous response */
+static u8_t http_pipeline_depth;
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/** A persistent connection between two requests: nothing to send, nothing
+    partially received */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+#define HTTP_IS_IDLE(hs) (((hs)->handle == NULL) && ((hs)->req == NULL) && (hs)->keepalive)
+#else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#define HTTP_IS_IDLE(hs) (((hs)->handle == NULL) && (hs)->keepalive)
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#else /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#define HTTP_IS_IDLE(hs) 0
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 #if LWIP_HTTPD_STRNSTR_PRIVATE
 /** Like strstr but does not need 'buffer' to be NULL-terminated */
 static char *
@@ -441,27 +583,183 @@ strnstr(const char *buffer, const char *token, size_t n)
 }
 #endif /* LWIP_HTTPD_STRNSTR_PRIVATE */
 
+#if HTTPD_FS_HASHED || LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/** Like strnstr but ignores the case of ASCII letters */
+static char *
+http_strnistr(const char *buffer, const char *token, size_t n)
+{
+    const char *p;
+    size_t tokenlen = strlen(token);
+    if(tokenlen == 0) {
+        return (char *)buffer;
+    }
+    for(p = buffer; *p && (p + tokenlen <= buffer + n); p++) {
+        if(!lwip_strnicmp(p, token, tokenlen)) {
+            return (char *)p;
+        }
+    }
+    return NULL;
+}
+
+/** Find a request header and return a pointer to its value (leading
+ * whitespace skipped, not NUL-terminated) or NULL if it is not present.
+ * Header names are case-insensitive and start a line, 'data' starts in
+ * front of the CRLF that ends the request line.
+ */
+static char *
+http_get_header_value(char *data, u16_t data_len, const char *hdr, u16_t *value_len)
+{
+    char *val;
+    char *end;
+    size_t hdr_len = strlen(hdr);
+
+    /* skip matches inside other header names or values */
+    val = http_strnistr(data, hdr, data_len);
+    while((val != NULL) && ((val - data < 2) || strncmp(val - 2, CRLF, 2))) {
+        val += hdr_len;
+        val = http_strnistr(val, hdr, data_len - (val - data));
+    }
+    if(val == NULL) {
+        return NULL;
+    }
+    val += hdr_len;
+    end = strnstr(val, CRLF, data_len - (val - data));
+    if(end == NULL) {
+        return NULL;
+    }
+    while((val < end) && ((*val == ' ') || (*val == '\t'))) {
+        val++;
+    }
+    *value_len = (u16_t)(end - val);
+    return val;
+}
+#endif /* HTTPD_FS_HASHED || LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
+#if HTTPD_FS_HASHED
+/** Check if an Accept-Encoding value accepts a content coding: the coding is
+ * listed, or "*" is and the coding is not, with a quality other than q=0.
+ */
+static u8_t
+http_accepts_encoding(const char *val, u16_t val_len, const char *coding)
+{
+    const char *end = val + val_len;
+    size_t coding_len = strlen(coding);
+    u8_t any = 0;
+
+    while(val < end) {
+        const char *name;
+        const char *name_end;
+        const char *item_end;
+        u8_t refused = 0;
+
+        while((val < end) && ((*val == ' ') || (*val == '\t') || (*val == ','))) {
+            val++;
+        }
+        name = val;
+        while((val < end) && (*val != ',') && (*val != ';') && (*val != ' ') && (*val != '\t')) {
+            val++;
+        }
+        name_end = val;
+        for(item_end = val; (item_end < end) && (*item_end != ','); item_end++) {
+        }
+        /* of the parameters only the quality matters: q=0, q=0. or q=0.000 refuse */
+        while(val < item_end) {
+            if(*val++ != ';') {
+                continue;
+            }
+            while((val < item_end) && ((*val == ' ') || (*val == '\t'))) {
+                val++;
+            }
+            if((item_end - val >= 3) && ((*val == 'q') || (*val == 'Q')) && (val[1] == '=') && (val[2] == '0')) {
+                val += 3;
+                if((val < item_end) && (*val == '.')) {
+                    val++;
+                    while((val < item_end) && (*val == '0')) {
+                        val++;
+                    }
+                }
+                refused = (u8_t)((val == item_end) || (*val < '0') || (*val > '9'));
+            }
+        }
+        val = item_end;
+
+        if(((size_t)(name_end - name) == coding_len) && !lwip_strnicmp(name, coding, coding_len)) {
+            return (u8_t)!refused;
+        }
+        if(((name_end - name) == 1) && (*name == '*')) {
+            any = (u8_t)!refused;
+        }
+    }
+    return any;
+}
+
+/** Parse the request headers that select the response variant of a
+ * precompressed file (Accept-Encoding) or allow a 304 (If-None-Match).
+ */
+static void
+http_parse_fs_headers(struct http_state *hs, char *data, u16_t data_len)
+{
+    char *val;
+    u16_t val_len;
+
+    hs->accept_enc = 0;
+    val = http_get_header_value(data, data_len, HTTP_HDR_ACCEPT_ENCODING, &val_len);
+    if(val != NULL) {
+        if(http_accepts_encoding(val, val_len, "gzip")) {
+            hs->accept_enc |= FS_ACCEPT_GZIP;
+        }
+        if(http_accepts_encoding(val, val_len, "deflate")) {
+            hs->accept_enc |= FS_ACCEPT_DEFLATE;
+        }
+    }
+    hs->inm = http_get_header_value(data, data_len, HTTP_HDR_IF_NONE_MATCH, &hs->inm_len);
+}
+
+/** Open a file with the variant negotiated for this request and turn it
+ * into a 304 response if the client's cached copy is still valid.
+ */
+static err_t
+http_fs_open(struct http_state *hs, const char *uri)
+{
+    err_t err = fs_open_ex(&hs->file_handle, uri, hs->accept_enc);
+    if((err == ERR_OK) && (hs->inm != NULL)) {
+        fs_not_modified(&hs->file_handle, hs->inm, hs->inm_len);
+    }
+    return err;
+}
+#else /* HTTPD_FS_HASHED */
+#define http_fs_open(hs, uri) fs_open(&(hs)->file_handle, uri)
+#endif /* HTTPD_FS_HASHED */
+
 #if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
+/** Free the state of the oldest connection to make room for a new one.
+ * Idle persistent connections are evicted before connections that are
+ * still transferring data. The victim is reset, so its PCB is released
+ * immediately instead of lingering in TIME_WAIT.
+ */
 static void
 http_kill_oldest_connection(u8_t ssi_required)
 {
-    struct http_state *hs = http_connections;
-    struct http_state *hs_free_next = NULL;
-    while(hs && hs->next) {
-        if(ssi_required) {
-            if(hs->next->ssi != NULL) {
-                hs_free_next = hs;
-            }
-        } else {
-            hs_free_next = hs;
+    struct http_state *hs;
+    struct http_state *victim = NULL;
+
+    /* the list is ordered oldest first */
+    for(hs = http_connections; hs != NULL; hs = hs->next) {
+        if(ssi_required && !LWIP_HTTPD_IS_SSI(hs)) {
+            continue;
+        }
+        if(HTTP_IS_IDLE(hs)) {
+            victim = hs;
+            break;
+        }
+        if(victim == NULL) {
+            victim = hs;
         }
-        hs = hs->next;
     }
-    if(hs_free_next != NULL) {
-        LWIP_ASSERT("hs_free_next->next != NULL", hs_free_next->next != NULL);
-        LWIP_ASSERT("hs_free_next->next->pcb != NULL", hs_free_next->next->pcb != NULL);
+    if(victim != NULL) {
+        LWIP_ASSERT("victim->pcb != NULL", victim->pcb != NULL);
         /* send RST when killing a connection because of memory shortage */
-        http_close_or_abort_conn(hs_free_next->next->pcb, hs_free_next->next, 1); /* this also unlinks the http_state from the list */
+        http_close_or_abort_conn(victim->pcb, victim, 1); /* this also unlinks the http_state from the list */
     }
 }
 #endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
@@ -489,11 +787,7 @@ static void
 http_ssi_state_free(struct http_ssi_state *ssi)
 {
     if(ssi != NULL) {
-#if HTTPD_USE_MEM_POOL
-        memp_free(MEMP_HTTPD_SSI_STATE, ssi);
-#else /* HTTPD_USE_MEM_POOL */
-        mem_free(ssi);
-#endif /* HTTPD_USE_MEM_POOL */
+        HTTP_FREE_SSI_STATE(ssi);
     }
 }
 #endif /* LWIP_HTTPD_SSI */
@@ -524,6 +818,7 @@ http_state_alloc(void)
 #endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
     if(ret != NULL) {
         http_state_init(ret);
+        http_conn_count++;
 #if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
         /* add the connection to the list */
         if(http_connections == NULL) {
@@ -563,6 +858,10 @@ http_state_eof(struct http_state *hs)
 #endif /* LWIP_HTTPD_DYNAMIC_FILE_READ */
 #if LWIP_HTTPD_SSI
     if(hs->ssi) {
+#if LWIP_HTTPD_SSI_BENCHMARK
+        httpd_ssi_bench.responses++;
+        httpd_ssi_bench.cycles += hs->ssi->cycles;
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
         http_ssi_state_free(hs->ssi);
         hs->ssi = NULL;
     }
@@ -593,11 +892,20 @@ http_state_free(struct http_state *hs)
             }
         }
 #endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
-#if HTTPD_USE_MEM_POOL
-        memp_free(MEMP_HTTPD_STATE, hs);
-#else /* HTTPD_USE_MEM_POOL */
-        mem_free(hs);
-#endif /* HTTPD_USE_MEM_POOL */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+        if(hs->req != NULL) {
+            pbuf_free(hs->req);
+            hs->req = NULL;
+        }
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+        if(hs->pipeline != NULL) {
+            pbuf_free(hs->pipeline);
+            hs->pipeline = NULL;
+        }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+        http_conn_count--;
+        HTTP_FREE_HTTP_STATE(hs);
     }
 }
 
@@ -696,6 +1004,31 @@ http_close_or_abort_conn(struct tcp_pcb *pcb, struct http_state *hs, u8_t abort_
     return err;
 }
 
+#if LWIP_HTTPD_PUSH
+/**
+ * A request for LWIP_HTTPD_PUSH_URI has been parsed: give the connection to
+ * the application and free the http state, httpd does not serve it anymore.
+ *
+ * @param pcb the tcp pcb of the connection
+ * @param hs connection state to free
+ */
+static void
+http_push_handover(struct tcp_pcb *pcb, struct http_state *hs)
+{
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    tcp_sent(pcb, NULL);
+    if(httpd_push_subscribe(pcb) == ERR_OK) {
+        LWIP_DEBUGF(HTTPD_DEBUG, ("Connection %p handed over to push channel\n", (void *)pcb));
+        http_state_free(hs);
+    } else {
+        http_close_conn(pcb, hs);
+    }
+}
+#endif /* LWIP_HTTPD_PUSH */
+
 /**
  * The connection shall be actively closed.
  * Reset the sent- and recv-callbacks.
@@ -709,18 +1042,103 @@ http_close_conn(struct tcp_pcb *pcb, struct http_state *hs)
     return http_close_or_abort_conn(pcb, hs, 0);
 }
 
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+/** Queue request data that arrived while a response is still being sent.
+ *
+ * @return ERR_OK if queued, ERR_MEM if the client sent too much ahead
+ */
+static err_t
+http_pipeline_enqueue(struct http_state *hs, struct pbuf *p)
+{
+    if(hs->pipeline == NULL) {
+        hs->pipeline = p;
+    } else {
+        pbuf_cat(hs->pipeline, p);
+    }
+    if(hs->pipeline->tot_len > LWIP_HTTPD_PIPELINE_BUFSIZE) {
+        LWIP_DEBUGF(HTTPD_DEBUG, ("Pipeline overflow (%"U16_F" bytes)\n", hs->pipeline->tot_len));
+        return ERR_MEM;
+    }
+    return ERR_OK;
+}
+
+/** Keep the bytes that followed the request just parsed: they are the start
+ * of the next pipelined request. Consumes hs->req.
+ */
+static void
+http_pipeline_save_rest(struct http_state *hs)
+{
+    struct pbuf *rest;
+
+    if((hs->req_consumed == 0) || (hs->req->tot_len <= hs->req_consumed)) {
+        pbuf_free(hs->req);
+    } else {
+        rest = pbuf_free_header(hs->req, hs->req_consumed);
+        if(hs->pipeline != NULL) {
+            pbuf_cat(rest, hs->pipeline);
+        }
+        hs->pipeline = rest;
+    }
+    hs->req = NULL;
+    hs->req_consumed = 0;
+}
+
+/** Answer the next queued request of an idle persistent connection.
+ * ATTENTION: hs may be freed when this returns.
+ */
+static void
+http_pipeline_continue(struct tcp_pcb *pcb, struct http_state *hs)
+{
+    struct pbuf *p;
+
+    if((hs->pipeline == NULL) || (hs->handle != NULL) ||
+            (http_pipeline_depth >= LWIP_HTTPD_PIPELINE_DEPTH)) {
+        /* picked up again from http_sent() or http_poll() */
+        return;
+    }
+    p = hs->pipeline;
+    hs->pipeline = NULL;
+    http_pipeline_depth++;
+    http_handle_request(pcb, hs, p);
+    http_pipeline_depth--;
+}
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+
 /** End of file: either close the connection (Connection: close) or
  * close the file (Connection: keep-alive)
  */
 static void
 http_eof(struct tcp_pcb *pcb, struct http_state *hs)
 {
-    /* HTTP/1.1 persistent connection? (Not supported for SSI) */
+    /* HTTP/1.1 persistent connection? (Not supported for SSI unless the
+       response length is known) */
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
-    if(hs->keepalive && !LWIP_HTTPD_IS_SSI(hs)) {
+    if(hs->keepalive && (!LWIP_HTTPD_IS_SSI(hs) || LWIP_HTTPD_SSI_HAS_LENGTH(hs))) {
+        /* keep what belongs to the connection, not to the finished request */
+#if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
+        struct http_state *next = hs->next;
+#endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+        struct pbuf *req = hs->req;
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+        struct pbuf *pipeline = hs->pipeline;
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+
         http_state_eof(hs);
         http_state_init(hs);
         hs->keepalive = 1;
+        hs->pcb = pcb;
+#if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
+        hs->next = next;
+#endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+        hs->req = req;
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+        hs->pipeline = pipeline;
+        http_pipeline_continue(pcb, hs);
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
     } else
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
     {
@@ -1106,6 +1524,87 @@ http_check_eof(struct tcp_pcb *pcb, struct http_state *hs)
     return 1;
 }
 
+#if HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/** The pre-rendered headers of the hashed file system end with
+ * "Connection: keep-alive". Remember where its value is when this response
+ * closes the connection, so that "close" is sent in its place.
+ */
+static void
+http_find_conn_value(struct http_state *hs)
+{
+    const size_t line_len = sizeof(HTTP11_CONNECTIONKEEPALIVE) - 1;
+    char *end;
+
+#if LWIP_HTTPD_SSI
+    if((hs->ssi != NULL) && !hs->ssi->precompiled) {
+        /* the tag scanner sends the header as it is */
+        return;
+    }
+#endif /* LWIP_HTTPD_SSI */
+    end = strnstr(hs->file, CRLF CRLF, hs->left);
+    if((end != NULL) && ((size_t)(end - hs->file) >= line_len) &&
+            !strncmp(end - line_len, HTTP11_CONNECTIONKEEPALIVE, line_len)) {
+        hs->conn_value = end - (sizeof(HTTP_CONN_KEEPALIVE) - 1);
+        hs->conn_pos = 0;
+    }
+}
+
+/** Sub-function of http_send(): send the header in front of the Connection
+ * value from the file, then "close" instead of "keep-alive". The value is
+ * replaced once hs->conn_value is NULL.
+ *
+ * @param run_left static bytes left in the template chunk, NULL for non-ssi files
+ * @returns: - 1: data has been written (so call tcp_ouput)
+ *           - 0: no data has been written (no need to call tcp_output)
+ */
+static u8_t
+http_send_conn_close(struct tcp_pcb *pcb, struct http_state *hs, u16_t *run_left)
+{
+    err_t err = ERR_OK;
+    u16_t len;
+    u8_t data_to_send = 0;
+
+    if(hs->file < hs->conn_value) {
+        len = (u16_t)LWIP_MIN((u32_t)(hs->conn_value - hs->file), LWIP_MIN(tcp_sndbuf(pcb), 2 * tcp_mss(pcb)));
+        if(run_left != NULL) {
+            len = LWIP_MIN(len, *run_left);
+        }
+        if(len == 0) {
+            return 0;
+        }
+        err = http_write(pcb, hs->file, &len, 0);
+        if(err == ERR_OK) {
+            data_to_send = 1;
+            hs->file += len;
+            hs->left -= len;
+            if(run_left != NULL) {
+                *run_left -= len;
+            }
+        }
+    }
+    if((err == ERR_OK) && (hs->file == hs->conn_value)) {
+        len = LWIP_MIN((u16_t)(sizeof(HTTP_CONN_CLOSE) - 1 - hs->conn_pos), tcp_sndbuf(pcb));
+        if(len != 0) {
+            err = http_write(pcb, &HTTP_CONN_CLOSE[hs->conn_pos], &len, 0);
+            if(err == ERR_OK) {
+                data_to_send = 1;
+                hs->conn_pos += (u8_t)len;
+            }
+        }
+        if(hs->conn_pos == sizeof(HTTP_CONN_CLOSE) - 1) {
+            /* skip "keep-alive" in the file */
+            hs->file += sizeof(HTTP_CONN_KEEPALIVE) - 1;
+            hs->left -= sizeof(HTTP_CONN_KEEPALIVE) - 1;
+            if(run_left != NULL) {
+                *run_left -= sizeof(HTTP_CONN_KEEPALIVE) - 1;
+            }
+            hs->conn_value = NULL;
+        }
+    }
+    return data_to_send;
+}
+#endif /* HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 /** Sub-function of http_send(): This is the normal send-routine for non-ssi files
  *
  * @returns: - 1: data has been written (so call tcp_ouput)
@@ -1121,6 +1620,14 @@ http_send_data_nonssi(struct tcp_pcb *pcb, struct http_state *hs)
 
     /* We are not processing an SHTML file so no tag checking is necessary.
      * Just send the data as we received it from the file. */
+#if HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    if(hs->conn_value != NULL) {
+        data_to_send = http_send_conn_close(pcb, hs, NULL);
+        if(hs->conn_value != NULL) {
+            return data_to_send;
+        }
+    }
+#endif /* HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 
     /* We cannot send more data than space available in the send
        buffer. */
@@ -1160,6 +1667,9 @@ http_send_data_ssi(struct tcp_pcb *pcb, struct http_state *hs)
     u8_t data_to_send = 0;
 
     struct http_ssi_state *ssi = hs->ssi;
+#if LWIP_HTTPD_SSI_BENCHMARK
+    u32_t cycles_start = httpd_ssi_cycle_counter();
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
     LWIP_ASSERT("ssi != NULL", ssi != NULL);
     /* We are processing an SHTML file so need to scan for tags and replace
      * them with insert strings. We need to be careful here since a tag may
@@ -1498,8 +2008,150 @@ http_send_data_ssi(struct tcp_pcb *pcb, struct http_state *hs)
             hs->left -= len;
         }
     }
+#if LWIP_HTTPD_SSI_BENCHMARK
+    ssi->cycles += httpd_ssi_cycle_counter() - cycles_start;
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
     return data_to_send;
 }
+
+#if HTTPD_FS_HASHED
+/** Produce the insert for the tag slot of the current template chunk.
+ * The tag index was resolved at build time, so no name lookup is needed. */
+static void
+http_template_tag_insert(struct http_state *hs)
+{
+    struct http_ssi_state *ssi = hs->ssi;
+    u8_t tag = ssi->chunk->tag;
+    const char *name;
+#if LWIP_HTTPD_SSI_MULTIPART
+    u16_t current_tag_part = ssi->tag_part;
+    ssi->tag_part = HTTPD_LAST_TAG_PART;
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+
+    if((tag < LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS) && (g_ssi_tag_map[tag] != FS_SSI_NO_TAG)) {
+        ssi->tag_insert_len = g_pfnSSIHandler(g_ssi_tag_map[tag], ssi->tag_insert,
+                                              LWIP_HTTPD_MAX_TAG_INSERT_LEN
+#if LWIP_HTTPD_SSI_MULTIPART
+                                              , current_tag_part, &ssi->tag_part
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+#if LWIP_HTTPD_FILE_STATE
+                                              , hs->handle->state
+#endif /* LWIP_HTTPD_FILE_STATE */
+                                             );
+    } else {
+        /* no handler for this tag: let get_tag_insert() echo it back */
+        name = fs_get_ssi_tag_name(tag);
+        strncpy(ssi->tag_name, (name != NULL) ? name : "", LWIP_HTTPD_MAX_TAG_NAME_LEN);
+        ssi->tag_name[LWIP_HTTPD_MAX_TAG_NAME_LEN] = 0;
+#if LWIP_HTTPD_SSI_MULTIPART
+        ssi->tag_part = current_tag_part;
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+        get_tag_insert(hs);
+    }
+    ssi->tag_index = 0;
+#if LWIP_HTTPD_SSI_MULTIPART
+    ssi->tag_pending = (ssi->tag_part != HTTPD_LAST_TAG_PART);
+#else /* LWIP_HTTPD_SSI_MULTIPART */
+    ssi->tag_pending = 0;
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+
+    if(ssi->chunk->width != 0) {
+        /* fixed-width slot: truncate here, the rest is padded later */
+        if(ssi->tag_insert_len > ssi->tag_width_left) {
+            ssi->tag_insert_len = ssi->tag_width_left;
+        }
+        ssi->tag_width_left -= ssi->tag_insert_len;
+    }
+}
+
+/** Sub-function of http_send(): This is the send-routine for precompiled
+ * templates of the hashed file system. Static runs are sent directly from
+ * the file data, tag inserts are copied into the send buffer. The file is
+ * never scanned.
+ *
+ * @returns: - 1: data has been written (so call tcp_ouput)
+ *           - 0: no data has been written (no need to call tcp_output)
+ */
+static u8_t
+http_send_data_template(struct tcp_pcb *pcb, struct http_state *hs)
+{
+    err_t err = ERR_OK;
+    u16_t len;
+    u16_t max_len;
+    u8_t data_to_send = 0;
+    struct http_ssi_state *ssi = hs->ssi;
+#if LWIP_HTTPD_SSI_BENCHMARK
+    u32_t cycles_start = httpd_ssi_cycle_counter();
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+
+    while((ssi->chunks_left != 0) && (err == ERR_OK)) {
+        max_len = LWIP_MIN(tcp_sndbuf(pcb), 2 * tcp_mss(pcb));
+        if(ssi->run_left != 0) {
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+            if(hs->conn_value != NULL) {
+                if(http_send_conn_close(pcb, hs, &ssi->run_left)) {
+                    data_to_send = 1;
+                }
+                if(hs->conn_value != NULL) {
+                    break;
+                }
+                continue;
+            }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+            /* static text, it stays valid in the file image: no copy */
+            if(max_len == 0) {
+                break;
+            }
+            len = LWIP_MIN(ssi->run_left, max_len);
+            err = http_write(pcb, hs->file, &len, 0);
+            if(err == ERR_OK) {
+                data_to_send = 1;
+                hs->file += len;
+                hs->left -= len;
+                ssi->run_left -= len;
+            }
+        } else if(ssi->tag_index < ssi->tag_insert_len) {
+            if(max_len == 0) {
+                break;
+            }
+            len = LWIP_MIN(ssi->tag_insert_len - ssi->tag_index, max_len);
+            err = http_write(pcb, &ssi->tag_insert[ssi->tag_index], &len,
+                             HTTP_IS_TAG_VOLATILE(hs));
+            if(err == ERR_OK) {
+                data_to_send = 1;
+                ssi->tag_index += len;
+            }
+        } else if(ssi->tag_pending) {
+            http_template_tag_insert(hs);
+        } else if(ssi->tag_width_left != 0) {
+            /* pad a fixed-width slot so the Content-Length holds */
+            len = LWIP_MIN(ssi->tag_width_left, LWIP_HTTPD_MAX_TAG_INSERT_LEN);
+            memset(ssi->tag_insert, ' ', len);
+            ssi->tag_insert_len = len;
+            ssi->tag_index = 0;
+            ssi->tag_width_left -= len;
+        } else {
+            /* chunk done, continue with the next one */
+            ssi->chunk++;
+            ssi->chunks_left--;
+            if(ssi->chunks_left != 0) {
+                ssi->run_left = ssi->chunk->len;
+                ssi->tag_pending = (ssi->chunk->tag != FS_SSI_NO_TAG);
+                ssi->tag_width_left = ssi->tag_pending ? ssi->chunk->width : 0;
+                ssi->tag_insert_len = 0;
+                ssi->tag_index = 0;
+#if LWIP_HTTPD_SSI_MULTIPART
+                ssi->tag_part = 0;
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+            }
+        }
+    }
+#if LWIP_HTTPD_SSI_BENCHMARK
+    ssi->cycles += httpd_ssi_cycle_counter() - cycles_start;
+#endif /* LWIP_HTTPD_SSI_BENCHMARK */
+    return data_to_send;
+}
+#endif /* HTTPD_FS_HASHED */
 #endif /* LWIP_HTTPD_SSI */
 
 /**
@@ -1545,6 +2197,19 @@ http_send(struct tcp_pcb *pcb, struct http_state *hs)
     }
 #endif /* LWIP_HTTPD_DYNAMIC_HEADERS */
 
+#if LWIP_HTTPD_SSI && HTTPD_FS_HASHED
+    if((hs->ssi != NULL) && hs->ssi->precompiled) {
+        /* a template may end with a tag, so hs->left does not tell the end */
+        data_to_send = http_send_data_template(pcb, hs);
+        if(hs->ssi->chunks_left == 0) {
+            LWIP_DEBUGF(HTTPD_DEBUG, ("End of template.\n"));
+            http_eof(pcb, hs);
+            return 0;
+        }
+        return data_to_send;
+    }
+#endif /* LWIP_HTTPD_SSI && HTTPD_FS_HASHED */
+
     /* Have we run out of file data to send? If so, we need to read the next
      * block from the file. */
     if(hs->left == 0) {
@@ -1976,13 +2641,34 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
             uri_len = sp2 - (sp1 + 1);
             if((sp2 != 0) && (sp2 > sp1)) {
                 /* wait for CRLFCRLF (indicating end of HTTP headers) before parsing anything */
-                if(strnstr(data, CRLF CRLF, data_len) != NULL) {
+                char *crlfcrlf = strnstr(data, CRLF CRLF, data_len);
+                if(crlfcrlf != NULL) {
                     char *uri = sp1 + 1;
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
-                    if(!is_09 && strnstr(data, HTTP11_CONNECTIONKEEPALIVE, data_len)) {
-                        hs->keepalive = 1;
+                    /* HTTP/1.1 is persistent unless the client asks to close,
+                       HTTP/1.0 only if the client asks for keep-alive */
+                    hs->keepalive = 0;
+                    if(!is_09) {
+                        u16_t conn_len = 0;
+                        char *conn = http_get_header_value(sp2, (u16_t)(crlfcrlf + 2 - sp2),
+                                                           HTTP_HDR_CONNECTION, &conn_len);
+                        if((conn == NULL) || !http_strnistr(conn, HTTP_CONN_CLOSE, conn_len)) {
+                            if(!strncmp(sp2 + 1, HTTP11_VERSION, sizeof(HTTP11_VERSION) - 1) ||
+                                    ((conn != NULL) && http_strnistr(conn, HTTP_CONN_KEEPALIVE, conn_len))) {
+                                hs->keepalive = 1;
+                            }
+                        }
                     }
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+                    hs->req_consumed = (u16_t)(crlfcrlf + 4 - data);
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+#if HTTPD_FS_HASHED
+                    if(!is_09) {
+                        /* must be done before the URI is NUL-terminated */
+                        http_parse_fs_headers(hs, sp2, (u16_t)(crlfcrlf + 2 - sp2));
+                    }
+#endif /* HTTPD_FS_HASHED */
                     /* null-terminate the METHOD (pbuf is freed anyway wen returning) */
                     *sp1 = 0;
                     uri[uri_len] = 0;
@@ -2068,7 +2754,7 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
            that exists. */
         for(loop = 0; loop < NUM_DEFAULT_FILENAMES; loop++) {
             LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Looking for %s...\n", g_psDefaultFilenames[loop].name));
-            err = fs_open(&hs->file_handle, (char *)g_psDefaultFilenames[loop].name);
+            err = http_fs_open(hs, g_psDefaultFilenames[loop].name);
             uri = (char *)g_psDefaultFilenames[loop].name;
             if(err == ERR_OK) {
                 file = &hs->file_handle;
@@ -2096,6 +2782,17 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
             params++;
         }
 
+#if LWIP_HTTPD_PUSH
+        if(strcmp(uri, LWIP_HTTPD_PUSH_URI) == 0) {
+            /* no file to send, the connection is handed over after parsing */
+            hs->push = 1;
+#if HTTPD_FS_HASHED
+            hs->inm = NULL;
+#endif /* HTTPD_FS_HASHED */
+            return http_init_file(hs, NULL, is_09, uri, 0);
+        }
+#endif /* LWIP_HTTPD_PUSH */
+
 #if LWIP_HTTPD_CGI
         /* Does the base URI we have isolated correspond to a CGI handler? */
         if(g_iNumCGIs && g_pCGIs) {
@@ -2116,7 +2813,7 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
 
         LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Opening %s\n", uri));
 
-        err = fs_open(&hs->file_handle, uri);
+        err = http_fs_open(hs, uri);
         if(err == ERR_OK) {
             file = &hs->file_handle;
         } else {
@@ -2136,9 +2833,78 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
         }
 #endif /* LWIP_HTTPD_SSI */
     }
+#if HTTPD_FS_HASHED
+    /* the header values point into the request buffer */
+    hs->inm = NULL;
+#endif /* HTTPD_FS_HASHED */
     return http_init_file(hs, file, is_09, uri, tag_check);
 }
 
+#if LWIP_HTTPD_SSI
+/** Allocate the SSI state for a file that is sent with tag processing.
+ * Templates of the hashed file system are sent chunk by chunk from their
+ * precompiled table, all other SSI files are scanned for tags.
+ *
+ * @param hs http connection state
+ * @param file opened file
+ * @param tag_check the URI has an SSI extension
+ * @return ERR_OK, or ERR_MEM if a template got no state
+ */
+static err_t
+http_ssi_init_file(struct http_state *hs, struct fs_file *file, u8_t tag_check)
+{
+    struct http_ssi_state *ssi;
+#if HTTPD_FS_HASHED
+    const struct fsdata_ssi_chunk *chunks = NULL;
+    u16_t chunk_count = 0;
+    u16_t i;
+
+    if(file->entry != NULL) {
+        /* tags of the hashed image were located at build time */
+        chunks = fs_get_ssi_template(file, &chunk_count);
+        tag_check = (chunks != NULL);
+    }
+#endif /* HTTPD_FS_HASHED */
+    if(!tag_check) {
+        return ERR_OK;
+    }
+    ssi = http_ssi_state_alloc();
+    if(ssi == NULL) {
+#if HTTPD_FS_HASHED
+        if(chunks != NULL) {
+            return ERR_MEM;
+        }
+#endif /* HTTPD_FS_HASHED */
+        /* send the file without tag processing */
+        return ERR_OK;
+    }
+    ssi->tag_index = 0;
+    ssi->tag_state = TAG_NONE;
+    ssi->parsed = file->data;
+    ssi->parse_left = file->len;
+    ssi->tag_end = file->data;
+#if HTTPD_FS_HASHED
+    if(chunks != NULL) {
+        ssi->precompiled = 1;
+        ssi->chunk = chunks;
+        ssi->chunks_left = chunk_count;
+        ssi->run_left = chunks->len;
+        ssi->tag_pending = (chunks->tag != FS_SSI_NO_TAG);
+        ssi->tag_width_left = ssi->tag_pending ? chunks->width : 0;
+        ssi->fixed_len = 1;
+        for(i = 0; i < chunk_count; i++) {
+            if((chunks[i].tag != FS_SSI_NO_TAG) && (chunks[i].width == 0)) {
+                ssi->fixed_len = 0;
+                break;
+            }
+        }
+    }
+#endif /* HTTPD_FS_HASHED */
+    hs->ssi = ssi;
+    return ERR_OK;
+}
+#endif /* LWIP_HTTPD_SSI */
+
 /** Initialize a http connection with a file to send (if found).
  * Called by http_find_file and http_find_error_file.
  *
@@ -2153,23 +2919,20 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
 static err_t
 http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const char *uri, u8_t tag_check)
 {
-    if(file != NULL) {
-        /* file opened, initialise struct http_state */
 #if LWIP_HTTPD_SSI
-        if(tag_check) {
-            struct http_ssi_state *ssi = http_ssi_state_alloc();
-            if(ssi != NULL) {
-                ssi->tag_index = 0;
-                ssi->tag_state = TAG_NONE;
-                ssi->parsed = file->data;
-                ssi->parse_left = file->len;
-                ssi->tag_end = file->data;
-                hs->ssi = ssi;
-            }
-        }
+    if((file != NULL) && (http_ssi_init_file(hs, file, tag_check) != ERR_OK)) {
+        /* a template cannot be sent without its state: give up on the request */
+        fs_close(file);
+        file = NULL;
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        hs->keepalive = 0;
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+    }
 #else /* LWIP_HTTPD_SSI */
-        LWIP_UNUSED_ARG(tag_check);
+    LWIP_UNUSED_ARG(tag_check);
 #endif /* LWIP_HTTPD_SSI */
+    if(file != NULL) {
+        /* file opened, initialise struct http_state */
         hs->handle = file;
         hs->file = (char *)file->data;
         LWIP_ASSERT("File length must be positive!", (file->len >= 0));
@@ -2190,9 +2953,20 @@ http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const cha
                 size_t diff = file_start + 4 - hs->file;
                 hs->file += diff;
                 hs->left -= (u32_t)diff;
+#if LWIP_HTTPD_SSI && HTTPD_FS_HASHED
+                if((hs->ssi != NULL) && hs->ssi->precompiled) {
+                    /* the first template run starts with the header */
+                    hs->ssi->run_left -= (u16_t)diff;
+                }
+#endif /* LWIP_HTTPD_SSI && HTTPD_FS_HASHED */
             }
         }
 #endif /* LWIP_HTTPD_SUPPORT_V09*/
+#if HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        if(hs->handle->http_header_included && !is_09 && !hs->keepalive) {
+            http_find_conn_value(hs);
+        }
+#endif /* HTTPD_FS_HASHED && LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
     } else {
         hs->handle = NULL;
         hs->file = NULL;
@@ -2247,6 +3021,17 @@ http_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
 
     hs->retries = 0;
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    if(hs->handle == NULL) {
+        /* persistent connection between two responses: answer a queued
+           request if there is one, otherwise there is nothing to send */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+        http_pipeline_continue(pcb, hs);
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+        return ERR_OK;
+    }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
     http_send(pcb, hs);
 
     return ERR_OK;
@@ -2283,6 +3068,13 @@ http_poll(void *arg, struct tcp_pcb *pcb)
         hs->retries++;
         if(hs->retries == HTTPD_MAX_RETRIES) {
             LWIP_DEBUGF(HTTPD_DEBUG, ("http_poll: too many retries, close\n"));
+#if HTTPD_IDLE_RST_THRESHOLD
+            if(HTTP_IS_IDLE(hs) && (http_conn_count >= HTTPD_IDLE_RST_THRESHOLD)) {
+                /* PCBs are scarce: don't leave this one in TIME_WAIT */
+                http_close_or_abort_conn(pcb, hs, 1);
+                return ERR_ABRT;
+            }
+#endif /* HTTPD_IDLE_RST_THRESHOLD */
             http_close_conn(pcb, hs);
             return ERR_OK;
         }
@@ -2298,11 +3090,73 @@ http_poll(void *arg, struct tcp_pcb *pcb)
                 tcp_output(pcb);
             }
         }
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+        else {
+            http_pipeline_continue(pcb, hs);
+        }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
     }
 
     return ERR_OK;
 }
 
+/**
+ * Parse (part of) a request and, once it is complete, start sending the
+ * response. ATTENTION: hs may be freed when this returns.
+ *
+ * @param pcb the tcp_pcb which received the request
+ * @param hs the connection state
+ * @param p the received request data (ownership is taken)
+ */
+static void
+http_handle_request(struct tcp_pcb *pcb, struct http_state *hs, struct pbuf *p)
+{
+    err_t parsed;
+
+    parsed = http_parse_request(&p, hs, pcb);
+    LWIP_ASSERT("http_parse_request: unexpected return value", parsed == ERR_OK
+                || parsed == ERR_INPROGRESS || parsed == ERR_ARG || parsed == ERR_USE);
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+    if(parsed != ERR_INPROGRESS) {
+        /* request fully parsed or error */
+        if(hs->req != NULL) {
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+            if(parsed == ERR_OK) {
+                /* the next request may already follow this one */
+                http_pipeline_save_rest(hs);
+            } else
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+            {
+                pbuf_free(hs->req);
+                hs->req = NULL;
+            }
+        }
+    }
+#else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+    if(p != NULL) {
+        /* pbuf not passed to application, free it now */
+        pbuf_free(p);
+    }
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+    if(parsed == ERR_OK) {
+#if LWIP_HTTPD_PUSH
+        if(hs->push) {
+            http_push_handover(pcb, hs);
+        } else
+#endif /* LWIP_HTTPD_PUSH */
+#if LWIP_HTTPD_SUPPORT_POST
+        if(hs->post_content_len_left == 0)
+#endif /* LWIP_HTTPD_SUPPORT_POST */
+        {
+            LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("http_recv: data %p len %"S32_F"\n", hs->file, hs->left));
+            http_send(pcb, hs);
+        }
+    } else if(parsed == ERR_ARG) {
+        /* @todo: close on ERR_USE? */
+        http_close_conn(pcb, hs);
+    }
+}
+
 /**
  * Data has been received on this pcb.
  * For HTTP 1.0, this should normally only happen once (if the request fits in one packet).
@@ -2310,7 +3164,6 @@ http_poll(void *arg, struct tcp_pcb *pcb)
 static err_t
 http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 {
-    err_t parsed = ERR_ABRT;
     struct http_state *hs = (struct http_state *)arg;
     LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("http_recv: pcb=%p pbuf=%p err=%s\n", (void *)pcb,
                 (void *)p, lwip_strerr(err)));
@@ -2354,40 +3207,24 @@ http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
         return ERR_OK;
     } else
 #endif /* LWIP_HTTPD_SUPPORT_POST */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+    if((hs->handle != NULL) || (hs->pipeline != NULL)) {
+        /* a response is still being sent (or earlier requests are waiting):
+           keep this one until it is our turn */
+        LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: pipelining request\n"));
+        if(http_pipeline_enqueue(hs, p) != ERR_OK) {
+            http_close_or_abort_conn(pcb, hs, 1);
+            return ERR_ABRT;
+        }
+    } else
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
     {
         if(hs->handle == NULL) {
-            parsed = http_parse_request(&p, hs, pcb);
-            LWIP_ASSERT("http_parse_request: unexpected return value", parsed == ERR_OK
-                        || parsed == ERR_INPROGRESS || parsed == ERR_ARG || parsed == ERR_USE);
+            http_handle_request(pcb, hs, p);
         } else {
             LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: already sending data\n"));
-        }
-#if LWIP_HTTPD_SUPPORT_REQUESTLIST
-        if(parsed != ERR_INPROGRESS) {
-            /* request fully parsed or error */
-            if(hs->req != NULL) {
-                pbuf_free(hs->req);
-                hs->req = NULL;
-            }
-        }
-#else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
-        if(p != NULL) {
-            /* pbuf not passed to application, free it now */
             pbuf_free(p);
         }
-#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
-        if(parsed == ERR_OK) {
-#if LWIP_HTTPD_SUPPORT_POST
-            if(hs->post_content_len_left == 0)
-#endif /* LWIP_HTTPD_SUPPORT_POST */
-            {
-                LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("http_recv: data %p len %"S32_F"\n", hs->file, hs->left));
-                http_send(pcb, hs);
-            }
-        } else if(parsed == ERR_ARG) {
-            /* @todo: close on ERR_USE? */
-            http_close_conn(pcb, hs);
-        }
     }
     return ERR_OK;
 }
@@ -2459,11 +3296,11 @@ void
 httpd_init(void)
 {
 #if HTTPD_USE_MEM_POOL
-    LWIP_ASSERT("memp_sizes[MEMP_HTTPD_STATE] >= sizeof(http_state)",
-                memp_sizes[MEMP_HTTPD_STATE] >= sizeof(http_state));
-    LWIP_ASSERT("memp_sizes[MEMP_HTTPD_SSI_STATE] >= sizeof(http_ssi_state)",
-                memp_sizes[MEMP_HTTPD_SSI_STATE] >= sizeof(http_ssi_state));
-#endif
+    LWIP_MEMPOOL_INIT(HTTPD_STATE);
+#if LWIP_HTTPD_SSI
+    LWIP_MEMPOOL_INIT(HTTPD_SSI_STATE);
+#endif /* LWIP_HTTPD_SSI */
+#endif /* HTTPD_USE_MEM_POOL */
     LWIP_DEBUGF(HTTPD_DEBUG, ("httpd_init\n"));
 
 #if LWIP_HTTPD_SSI
@@ -2497,6 +3334,28 @@ http_set_ssi_handler(tSSIHandler ssi_handler, const char **tags, int num_tags)
     g_pfnSSIHandler = ssi_handler;
     g_ppcTags = tags;
     g_iNumTags = num_tags;
+
+#if HTTPD_FS_HASHED
+    {
+        /* resolve the template tags once instead of per request */
+        const char *name;
+        int loop;
+        u8_t tag;
+
+        for(tag = 0; tag < LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS; tag++) {
+            g_ssi_tag_map[tag] = FS_SSI_NO_TAG;
+            name = fs_get_ssi_tag_name(tag);
+            for(loop = 0; (name != NULL) && (loop < num_tags); loop++) {
+                if(strcmp(name, tags[loop]) == 0) {
+                    g_ssi_tag_map[tag] = (u8_t)loop;
+                    break;
+                }
+            }
+        }
+        LWIP_ASSERT("too many template tags, raise LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS",
+                    fs_get_ssi_tag_name(LWIP_HTTPD_SSI_MAX_TEMPLATE_TAGS) == NULL);
+    }
+#endif /* HTTPD_FS_HASHED */
 }
 #endif /* LWIP_HTTPD_SSI */
 
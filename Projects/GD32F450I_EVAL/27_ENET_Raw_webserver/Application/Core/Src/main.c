@@ -39,6 +39,7 @@ OF SUCH DAMAGE.
 #include "lwip/timeouts.h"
 #include "gd32f450i_eval.h"
 #include "httpd.h"
+#include "http_push.h"
 
 #define SYSTEMTICK_PERIOD_MS  10
 
@@ -70,6 +71,7 @@ int main(void)
 
     /* initilaize the webserver */
     httpd_init();
+    http_telemetry_init();
 
     while(1) {
 
@@ -92,6 +94,10 @@ int main(void)
 #else
         lwip_timeouts_check(g_localtime);
 #endif /* TIMEOUT_CHECK_USE_LWIP */
+
+        /* stream ADC and LED changes to the event subscribers */
+        http_telemetry_periodic(g_localtime);
+        http_push_periodic(g_localtime);
     }
 }
 
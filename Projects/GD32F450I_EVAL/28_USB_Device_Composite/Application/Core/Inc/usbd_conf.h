@@ -0,0 +1,88 @@
+/*!
+    \file    usbd_conf.h
+    \brief   the header file of USB device configuration
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#ifndef __USBD_CONF_H
+#define __USBD_CONF_H
+
+#include "usb_conf.h"
+
+#define USBD_CFG_MAX_NUM                1
+#define USBD_ITF_MAX_NUM                4
+#define USB_STR_DESC_MAX_SIZE           64
+
+/* functions of the composite device, the class drivers keep their data in class_data[] at
+   the number of their first interface in the merged configuration */
+#define USBD_FUNC_MAX_NUM               3U
+
+#define USBD_MSC_INTERFACE              0
+#define CDC_COM_INTERFACE               1
+#define CUSTOM_HID_INTERFACE            3
+
+/* class layer parameter, the endpoints of the functions must not overlap: the composite
+   device has more IN endpoints than the USBFS core, so it runs on the USBHS core */
+#define MSC_IN_EP                       EP1_IN
+#define MSC_OUT_EP                      EP1_OUT
+
+#define CDC_DATA_IN_EP                  EP2_IN
+#define CDC_DATA_OUT_EP                 EP2_OUT
+#define CDC_CMD_EP                      EP3_IN
+
+#define CUSTOMHID_IN_EP                 EP4_IN
+#define CUSTOMHID_OUT_EP                EP4_OUT
+
+#ifdef USE_USB_HS
+    #ifdef USE_ULPI_PHY
+        #define MSC_DATA_PACKET_SIZE    512
+        #define USB_CDC_DATA_PACKET_SIZE 512
+    #else
+        #define MSC_DATA_PACKET_SIZE    64
+        #define USB_CDC_DATA_PACKET_SIZE 64
+    #endif
+#else /*USE_USB_FS*/
+    #define MSC_DATA_PACKET_SIZE        64
+    #define USB_CDC_DATA_PACKET_SIZE    64
+#endif
+
+#define USB_CDC_CMD_PACKET_SIZE         8
+
+#define CUSTOMHID_IN_PACKET             2
+#define CUSTOMHID_OUT_PACKET            2
+
+#define MSC_MEDIA_PACKET_SIZE           4096
+
+#define MEM_LUN_NUM                     1
+
+#define USB_STRING_COUNT                4
+
+#endif /* __USBD_CONF_H */
@@ -0,0 +1,198 @@
+/*!
+    \file    app.c
+    \brief   USB composite device (MSC, CDC ACM and custom HID) main routine
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "drv_usb_hw.h"
+#include "usbd_msc_core.h"
+#include "cdc_acm_core.h"
+#include "custom_hid_core.h"
+#include <stdio.h>
+
+#define USBD_VID                          0x28E9U
+#define USBD_PID                          0x0390U
+
+/* USB standard device descriptor, the functions are grouped by interface association descriptors */
+__ALIGN_BEGIN const usb_desc_dev composite_dev_desc __ALIGN_END = {
+    .header =
+    {
+        .bLength          = USB_DEV_DESC_LEN,
+        .bDescriptorType  = USB_DESCTYPE_DEV
+    },
+    .bcdUSB                = 0x0200U,
+    .bDeviceClass          = 0xEFU,
+    .bDeviceSubClass       = 0x02U,
+    .bDeviceProtocol       = 0x01U,
+    .bMaxPacketSize0       = USB_FS_EP0_MAX_LEN,
+    .idVendor              = USBD_VID,
+    .idProduct             = USBD_PID,
+    .bcdDevice             = 0x0100U,
+    .iManufacturer         = STR_IDX_MFC,
+    .iProduct              = STR_IDX_PRODUCT,
+    .iSerialNumber         = STR_IDX_SERIAL,
+    .bNumberConfigurations = USBD_CFG_MAX_NUM
+};
+
+/* USB language ID descriptor */
+static __ALIGN_BEGIN const usb_desc_LANGID usbd_language_id_desc __ALIGN_END = {
+    .header =
+    {
+        .bLength         = sizeof(usb_desc_LANGID),
+        .bDescriptorType = USB_DESCTYPE_STR
+    },
+    .wLANGID              = ENG_LANGID
+};
+
+/* USB manufacture string */
+static __ALIGN_BEGIN const usb_desc_str manufacturer_string __ALIGN_END = {
+    .header =
+    {
+        .bLength         = USB_STRING_LEN(10U),
+        .bDescriptorType = USB_DESCTYPE_STR
+    },
+    .unicode_string = {'G', 'i', 'g', 'a', 'D', 'e', 'v', 'i', 'c', 'e'}
+};
+
+/* USB product string */
+static __ALIGN_BEGIN const usb_desc_str product_string __ALIGN_END = {
+    .header =
+    {
+        .bLength         = USB_STRING_LEN(14U),
+        .bDescriptorType = USB_DESCTYPE_STR
+    },
+    .unicode_string = {'G', 'D', '3', '2', '-', 'C', 'o', 'm', 'p', 'o', 's', 'i', 't', 'e'}
+};
+
+/* USBD serial string */
+static __ALIGN_BEGIN usb_desc_str serial_string __ALIGN_END = {
+    .header =
+    {
+        .bLength         = USB_STRING_LEN(12U),
+        .bDescriptorType = USB_DESCTYPE_STR
+    }
+};
+
+/* USB string descriptor set */
+void *const usbd_composite_strings[] = {
+    [STR_IDX_LANGID]  = (uint8_t *)&usbd_language_id_desc,
+    [STR_IDX_MFC]     = (uint8_t *)&manufacturer_string,
+    [STR_IDX_PRODUCT] = (uint8_t *)&product_string,
+    [STR_IDX_SERIAL]  = (uint8_t *)&serial_string
+};
+
+/* the configuration descriptor is merged from the functions by usbd_composite_init() */
+usb_desc composite_desc = {
+    .dev_desc    = (uint8_t *)&composite_dev_desc,
+    .strings     = usbd_composite_strings
+};
+
+usb_core_driver usb_composite;
+usbd_composite composite;
+
+unsigned char SRAM[40 * 1024];
+
+/* local function prototypes ('static') */
+static void led_config(void);
+
+hid_fop_handler led_fop = {
+    .periph_config = {led_config}
+};
+
+/*!
+    \brief      main routine will construct a composite device with a USB MSC disk, a CDC
+                telemetry port and a custom HID driving the LEDs
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+int main(void)
+{
+    uint32_t count = 0U;
+
+    /* configure the GPIO */
+    usb_gpio_config();
+    /* configure the USB peripheral clock */
+    usb_rcu_config();
+    /* initialize the USB timer */
+    usb_timer_init();
+
+    custom_hid_itfop_register(&usb_composite, &led_fop);
+
+    /* the interfaces are numbered in the order the functions are added, the bulk endpoints
+       ask for two packets of FIFO, the interrupt endpoints always get one */
+    usbd_func_add(&composite, &msc_class, &msc_desc, 2U, 2U);
+    usbd_func_add(&composite, &cdc_class, &cdc_desc, 2U, 1U);
+    usbd_func_add(&composite, &usbd_custom_hid_cb, &custom_hid_desc, 1U, 1U);
+
+    if(USBD_OK != usbd_composite_init(&usb_composite,
+#ifdef USE_USB_FS
+                                      USB_CORE_ENUM_FS,
+#elif defined(USE_USB_HS)
+                                      USB_CORE_ENUM_HS,
+#endif
+                                      &composite_desc,
+                                      &composite)) {
+        /* the functions do not fit on the core */
+        while(1) {
+        }
+    }
+
+    usb_intr_config();
+
+    while (1) {
+        if((uint8_t)USBD_CONFIGURED == usb_composite.dev.cur_status) {
+            usb_cdc_handler *cdc = (usb_cdc_handler *)usb_composite.dev.class_data[CDC_COM_INTERFACE];
+
+            /* send a telemetry line when the previous one is gone */
+            if(1U == cdc->packet_sent) {
+                cdc->receive_length = (uint32_t)snprintf((char *)cdc->data, USB_CDC_RX_LEN, "telemetry %lu\r\n", (unsigned long)count++);
+
+                cdc_acm_data_send(&usb_composite);
+            }
+
+            usb_mdelay(100U);
+        }
+    }
+}
+
+/*!
+    \brief      configure the LEDs switched by the custom HID reports
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void led_config(void)
+{
+    gd_eval_led_init(LED1);
+    gd_eval_led_init(LED2);
+    gd_eval_led_init(LED3);
+}
@@ -0,0 +1,297 @@
+/*!
+    \file    gd32f4xx_it.c
+    \brief   main interrupt service routines
+
+    \version 2024-12-20, V3.31, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this 
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice, 
+       this list of conditions and the following disclaimer in the documentation 
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors 
+       may be used to endorse or promote products derived from this software without 
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR 
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx_it.h"
+#include "usbd_core.h"
+#include "drv_usbd_int.h"
+
+extern usb_core_driver usb_composite;
+
+void usb_timer_irq (void);
+
+/* local function prototypes ('static') */
+static void resume_mcu_clk(void);
+
+/*!
+    \brief      this function handles NMI exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void NMI_Handler(void)
+{
+    /* if NMI exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles HardFault exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void HardFault_Handler(void)
+{
+    /* if Hard Fault exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles MemManage exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void MemManage_Handler(void)
+{
+    /* if Memory Manage exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles BusFault exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void BusFault_Handler(void)
+{
+    /* if Bus Fault exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles UsageFault exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void UsageFault_Handler(void)
+{
+    /* if Usage Fault exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles SVC exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void SVC_Handler(void)
+{
+    /* if SVC exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles DebugMon exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void DebugMon_Handler(void)
+{
+    /* if DebugMon exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles PendSV exception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void PendSV_Handler(void)
+{
+    /* if PendSV exception occurs, go to infinite loop */
+    while(1) {
+    }
+}
+
+/*!
+    \brief      this function handles timer2 Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void TIMER2_IRQHandler(void)
+{
+    usb_timer_irq();
+}
+
+#ifdef USE_USB_FS
+
+/*!
+    \brief      this function handles USBFS wakeup interrupt handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USBFS_WKUP_IRQHandler(void)
+{
+    if (usb_composite.bp.low_power) {
+        resume_mcu_clk();
+
+        rcu_pll48m_clock_config(RCU_PLL48MSRC_PLLQ);
+        rcu_ck48m_clock_config(RCU_CK48MSRC_PLL48M);
+
+        rcu_periph_clock_enable(RCU_USBFS);
+
+        usb_clock_active(&usb_composite);
+    }
+
+    exti_interrupt_flag_clear(EXTI_18);
+}
+
+#elif defined(USE_USB_HS)
+
+/*!
+    \brief      this function handles USBHS wakeup interrupt handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USBHS_WKUP_IRQHandler(void)
+{
+    if (usb_composite.bp.low_power) {
+        resume_mcu_clk();
+
+        #ifdef USE_EMBEDDED_PHY
+            rcu_pll48m_clock_config(RCU_PLL48MSRC_PLLQ);
+            rcu_ck48m_clock_config(RCU_CK48MSRC_PLL48M);
+        #elif defined(USE_ULPI_PHY)
+            rcu_periph_clock_enable(RCU_USBHSULPI);
+        #endif
+
+        rcu_periph_clock_enable(RCU_USBHS);
+
+        usb_clock_active(&usb_composite);
+    }
+
+    exti_interrupt_flag_clear(EXTI_20);
+}
+
+#endif /* USE_USBFS */
+
+#ifdef USE_USB_FS
+
+/*!
+    \brief      this function handles USBFS IRQ Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USBFS_IRQHandler(void)
+{
+    usbd_isr (&usb_composite);
+}
+
+#elif defined(USE_USB_HS)
+
+/*!
+    \brief      this function handles USBHS IRQ Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USBHS_IRQHandler(void)
+{
+    usbd_isr(&usb_composite);
+}
+
+#endif /* USE_USBFS */
+
+#ifdef USB_HS_DEDICATED_EP1_ENABLED
+
+/*!
+    \brief      this function handles EP1_IN Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USBHS_EP1_In_IRQHandler(void)
+{
+    usbd_int_dedicated_ep1in (&usb_composite);
+}
+
+/*!
+    \brief      this function handles EP1_OUT Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USBHS_EP1_Out_IRQHandler(void)
+{
+    usbd_int_dedicated_ep1out (&usb_composite);
+}
+
+#endif /* USBHS_DEDICATED_EP1_ENABLED */
+
+/*!
+    \brief      resume MCU clock
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void resume_mcu_clk(void)
+{
+    /* enable HXTAL */
+    rcu_osci_on(RCU_HXTAL);
+
+    /* wait till HXTAL is ready */
+    while(RESET == rcu_flag_get(RCU_FLAG_HXTALSTB)){
+    }
+
+    /* enable PLL */
+    rcu_osci_on(RCU_PLL_CK);
+
+    /* wait till PLL is ready */
+    while(RESET == rcu_flag_get(RCU_FLAG_PLLSTB)){
+    }
+
+    /* select PLL as system clock source */
+    rcu_system_clock_source_config(RCU_CKSYSSRC_PLLP);
+
+    /* wait till PLL is used as system clock source */
+    while(RCU_SCSS_PLLP != rcu_system_clock_source_get()){
+    }
+}
@@ -38,7 +38,14 @@ OF SUCH DAMAGE.
 #define USBH_MAX_EP_NUM                         4U
 #define USBH_MAX_INTERFACES_NUM                 4U
 #define USBH_MAX_ALT_SETTING                    2U
-#define USBH_MAX_SUPPORTED_CLASS                2U
+#define USBH_MAX_SUPPORTED_CLASS                3U
+
+/* hub support: a keyboard, a barcode reader (both HID) and a USB stick behind one hub */
+#define USBH_HUB_MAX_PORTS                      4U
+#define USBH_HID_MAX_INSTANCES                  2U
+/* pipes of one device, and pipes kept free for the interrupt endpoints of later devices */
+#define USBH_DEV_PIPE_MAX                       2U
+#define USBH_PERIODIC_PIPE_RESERVE              1U
 
 #define USBH_DATA_BUF_MAX_LEN                   0x200U
 #define USBH_CFGSET_MAX_LEN                     0x200U
@@ -41,6 +41,7 @@ OF SUCH DAMAGE.
 #include <stdio.h>
 
 extern usbh_user_cb usr_cb;
+extern usbh_user_cb usr_hub_dev_cb;
 
 /* function declarations */
 /* user operation for host-mode initialization */
@@ -79,5 +80,13 @@ usbh_user_status usbh_user_userinput(void);
 void usbh_user_device_not_supported(void);
 /* user operation for unrecovered error happens */
 void usbh_user_unrecovered_error(void);
+/* user operation for the disconnect event of a device behind a hub */
+void usbh_user_hub_device_disconnected(void);
+/* user operation when a device behind a hub is enumerated */
+void usbh_user_hub_enumeration_finish(void);
+/* user action for the application state entry of a device behind a hub */
+usbh_user_status usbh_user_hub_userinput(void);
+/* log the usage events of the generic HID devices */
+void usbh_user_hid_event_log(usbh_host *uhost);
 
 #endif /*__USBH_USR_H */
@@ -36,6 +36,8 @@ OF SUCH DAMAGE.
 #include "drv_usb_core.h"
 #include "usbh_usr.h"
 #include "usbh_hid_core.h"
+#include "usbh_msc_core.h"
+#include "usbh_hub.h"
 
 usbh_host usb_host;
 usb_core_driver usbh_core;
@@ -55,8 +57,12 @@ int main(void)
     /* configure GPIO pin used for switching VBUS power and charge pump I/O */
     usb_vbus_config();
 
-    /* register device class */
+    /* register device class, the classes also serve the devices behind a hub */
+    usbh_class_register(&usb_host, &usbh_hub);
     usbh_class_register(&usb_host, &usbh_hid);
+    usbh_class_register(&usb_host, &usbh_msc);
+
+    usbh_hub_user_register(&usr_hub_dev_cb);
 
     usbh_init(&usb_host,
               &usbh_core,
@@ -73,5 +79,8 @@ int main(void)
     while (1) {
         /* Host state handler */
         usbh_core_task(&usb_host);
+
+        /* the generic HID devices are decoded in the interrupt, show their events */
+        usbh_user_hid_event_log(&usb_host);
     }
 }
@@ -35,6 +35,7 @@ OF SUCH DAMAGE.
 #include "lcd_log.h"
 #include "usbh_usr.h"
 #include "usbh_standard_hid.h"
+#include "usbh_hid_core.h"
 #include "usb_lcd_conf.h"
 #include "drv_usb_hw.h"
 #include <string.h>
@@ -71,6 +72,29 @@ usbh_user_cb usr_cb =
     usbh_user_unrecovered_error
 };
 
+/* callbacks of the devices behind a hub, the class starts without waiting for the user key */
+usbh_user_cb usr_hub_dev_cb =
+{
+    usbh_user_init,
+    usbh_user_deinit,
+    usbh_user_device_connected,
+    usbh_user_device_reset,
+    usbh_user_hub_device_disconnected,
+    usbh_user_over_current_detected,
+    usbh_user_device_speed_detected,
+    usbh_user_device_desc_available,
+    usbh_user_device_address_assigned,
+    usbh_user_configuration_descavailable,
+    usbh_user_manufacturer_string,
+    usbh_user_product_string,
+    usbh_user_serialnum_string,
+    usbh_user_hub_enumeration_finish,
+    usbh_user_hub_userinput,
+    NULL,
+    usbh_user_device_not_supported,
+    usbh_user_unrecovered_error
+};
+
 const uint8_t MSG_HOST_HEADER[] = "USBFS & USBHS HID Host";
 const uint8_t MSG_HOST_FOOTER[] = "USB Host Library v3.0.0";
 
@@ -348,6 +372,61 @@ usbh_user_status usbh_user_userinput(void)
     return usbh_usr_status;
 }
 
+/*!
+    \brief      user operation for the disconnect event of a device behind a hub
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void usbh_user_hub_device_disconnected(void)
+{
+    /* the other devices behind the hub keep running, keep their output on the screen */
+    LCD_UsrLog("> Hub device disconnected.\n");
+}
+
+/*!
+    \brief      user operation when a device behind a hub is enumerated
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void usbh_user_hub_enumeration_finish(void)
+{
+    LCD_UsrLog("> Hub device enumeration completed.\n");
+}
+
+/*!
+    \brief      user action for the application state entry of a device behind a hub
+    \param[in]  none
+    \param[out] none
+    \retval     always USR_IN_RESP_OK, the hub was already confirmed with the user key
+*/
+usbh_user_status usbh_user_hub_userinput(void)
+{
+    return USR_IN_RESP_OK;
+}
+
+/*!
+    \brief      log the usage events of the generic HID devices, the devices without a
+                keyboard or mouse decoder, on the root port and behind a hub
+    \param[in]  uhost: pointer to the USB host of the root port
+    \param[out] none
+    \retval     none
+*/
+void usbh_user_hid_event_log(usbh_host *uhost)
+{
+    hid_event event;
+
+    for(; NULL != uhost; uhost = uhost->next) {
+        while(usbh_hid_event_get(uhost, &event)) {
+            if(HID_PAGE_SYNC != event.page) {
+                LCD_UsrLog("> %02X: usage %04X:%04X = %d\n", uhost->dev_prop.addr, \
+                           event.page, event.usage, (int)event.value);
+            }
+        }
+    }
+}
+
 /*!
     \brief      user action for device over current detection event
     \param[in]  none
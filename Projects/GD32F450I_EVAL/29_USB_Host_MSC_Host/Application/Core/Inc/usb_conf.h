@@ -75,7 +75,8 @@ OF SUCH DAMAGE.
         #define USB_EMBEDDED_PHY_ENABLED
     #endif
 
-//    #define USB_HS_INTERNAL_DMA_ENABLED
+    /* the channels move the bulk data by DMA and retry NAKed transactions without the CPU */
+    #define USB_HS_INTERNAL_DMA_ENABLED
 
     #define USBHS_SOF_OUTPUT                               0
     #define USBHS_LOW_POWER                                0
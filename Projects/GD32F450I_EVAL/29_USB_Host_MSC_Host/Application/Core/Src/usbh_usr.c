@@ -38,6 +38,7 @@ OF SUCH DAMAGE.
 #include "usbh_msc_core.h"
 #include "usbh_msc_scsi.h"
 #include "usbh_msc_bbb.h"
+#include "usbh_pipe.h"
 #include "ff.h"
 
 extern usb_core_driver usbh_core;
@@ -46,6 +47,9 @@ extern usbh_host usb_host_msc;
 FATFS fatfs;
 FIL file;
 
+/* bulk pipe counters when the file system was mounted */
+static usb_pipe_stat stat_in_start, stat_out_start;
+
 uint8_t line_idx;
 uint8_t usbh_usr_application_state = USBH_USR_FS_INIT;
 
@@ -78,6 +82,7 @@ const uint8_t MSG_HOST_FOOTER[] = "USB Host Library v3.0.0";
 /* local function prototypes ('static') */
 static uint8_t explore_disk (char* path, uint8_t recu_level);
 static void toggle_leds (void);
+static void pipe_stat_report (const char *name, uint8_t pp_num, usb_pipe_stat *start);
 
 /*!
     \brief      user operation for host-mode initialization
@@ -348,6 +353,9 @@ int usbh_usr_msc_application(void)
             LCD_UsrLog("> Disk capacity: %ud Bytes.\r\n", info.capacity.block_nbr * info.capacity.block_size);
         }
 
+        usbh_pipe_stat_get(&usb_host_msc, ((usbh_msc_handler *)usb_host_msc.active_class->class_data)->pipe_in, &stat_in_start);
+        usbh_pipe_stat_get(&usb_host_msc, ((usbh_msc_handler *)usb_host_msc.active_class->class_data)->pipe_out, &stat_out_start);
+
         usbh_usr_application_state = USBH_USR_FS_READLIST;
         break;
 
@@ -405,6 +413,9 @@ int usbh_usr_msc_application(void)
             LCD_UsrLog("> GD32.TXT created in the disk.\r\n");
         }
 
+        pipe_stat_report("IN", ((usbh_msc_handler *)usb_host_msc.active_class->class_data)->pipe_in, &stat_in_start);
+        pipe_stat_report("OUT", ((usbh_msc_handler *)usb_host_msc.active_class->class_data)->pipe_out, &stat_out_start);
+
         usbh_usr_application_state = USBH_USR_FS_DEMOEND;
         LCD_UsrLog("> The MSC host demo is end.\r\n");
         break;
@@ -419,6 +430,36 @@ int usbh_usr_msc_application(void)
     return(0);
 }
 
+/*!
+    \brief      display the traffic of a bulk pipe since a snapshot of its counters
+    \param[in]  name: pipe name
+    \param[in]  pp_num: pipe number
+    \param[in]  start: counters at the start of the measurement
+    \param[out] none
+    \retval     none
+*/
+static void pipe_stat_report (const char *name, uint8_t pp_num, usb_pipe_stat *start)
+{
+    usb_pipe_stat now;
+    uint32_t ms;
+
+    usbh_pipe_stat_get(&usb_host_msc, pp_num, &now);
+
+    /* the host timer counts micro-frames on a high speed port */
+    ms = now.time - start->time;
+    if (PORT_SPEED_HIGH == usb_host_msc.dev_prop.speed) {
+        ms /= 8U;
+    }
+
+    LCD_UsrLog("> Bulk %s: %u bytes, %u transfers, %u NAKs, %u errors in %u ms.\r\n", name,
+               now.bytes - start->bytes, now.xfers - start->xfers,
+               now.naks - start->naks, now.errors - start->errors, ms);
+
+    if (0U != ms) {
+        LCD_UsrLog("> Bulk %s: %u bytes/s.\r\n", name, (uint32_t)(((uint64_t)(now.bytes - start->bytes) * 1000U) / ms));
+    }
+}
+
 /*!
     \brief      displays disk content
     \param[in]  path: pointer to root path
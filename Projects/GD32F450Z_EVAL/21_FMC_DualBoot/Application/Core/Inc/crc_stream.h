@@ -0,0 +1,94 @@
+/*!
+    \file    crc_stream.h
+    \brief   the header file of the streaming CRC-32 service on the CRC unit
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef CRC_STREAM_H
+#define CRC_STREAM_H
+
+#ifdef DUALBOOT_HOST
+/* built on a PC by the tools in Utilities/fwupdate */
+#include "dualboot_host.h"
+#else
+#include "gd32f4xx.h"
+#endif /* DUALBOOT_HOST */
+
+/* 0: compute every CRC in software, the results are the same */
+#ifndef CRC_STREAM_USE_HW
+#define CRC_STREAM_USE_HW          1
+#endif /* CRC_STREAM_USE_HW */
+
+/* word runs at least this long are fed by the DMA, shorter ones by the CPU */
+#define CRC_STREAM_DMA_MIN         256U
+/* memory to memory transfers need DMA1 */
+#define CRC_STREAM_DMA             DMA1
+#define CRC_STREAM_DMA_CH          DMA_CH0
+
+/* CRC-32 variants, all on the polynomial 0x04C11DB7 of the CRC unit */
+typedef enum {
+    CRC_STREAM_UNIT = 0,                                 /*!< CRC unit result: little endian words MSB first, init 0xFFFFFFFF, no final XOR;
+                                                              a trailing incomplete word is taken bytewise MSB first; DMA fed */
+    CRC_STREAM_MPEG2,                                    /*!< CRC-32/MPEG-2: bytes MSB first, init 0xFFFFFFFF, no final XOR */
+    CRC_STREAM_CRC32                                     /*!< CRC-32 of zlib and Ethernet: reflected, init and final XOR 0xFFFFFFFF */
+} crc_stream_type_enum;
+
+/* CRC of a byte stream passed in chunks */
+typedef struct {
+    uint32_t reg;                                        /*!< CRC register, MSB first polynomial order */
+    crc_stream_type_enum type;                           /*!< CRC variant */
+    uint32_t partial;                                    /*!< CRC_STREAM_UNIT: bytes of an incomplete word */
+    uint32_t partial_len;                                /*!< number of bytes in partial */
+    uint32_t dma_next;                                   /*!< address of the current DMA piece */
+    uint32_t dma_piece;                                  /*!< words in the current DMA piece */
+    uint32_t dma_words;                                  /*!< words after the current DMA piece */
+    const uint8_t *tail;                                 /*!< bytes after the DMA run */
+    uint32_t tail_len;                                   /*!< number of bytes in tail */
+    uint8_t dma_active;                                  /*!< a DMA run is in progress */
+} crc_stream_struct;
+
+/* function declarations */
+/* start a CRC */
+void crc_stream_init(crc_stream_struct *ctx, crc_stream_type_enum type);
+/* add a chunk, start a DMA run for a long CRC_STREAM_UNIT chunk and return 1 while it runs */
+uint32_t crc_stream_update_start(crc_stream_struct *ctx, const void *data, uint32_t len);
+/* advance a DMA run, returns 1 while it runs */
+uint32_t crc_stream_poll(crc_stream_struct *ctx);
+/* add a chunk and wait for the DMA */
+void crc_stream_update(crc_stream_struct *ctx, const void *data, uint32_t len);
+/* add a chunk in software only, the bit exact reference of the hardware paths */
+void crc_stream_sw_update(crc_stream_struct *ctx, const void *data, uint32_t len);
+/* get the CRC of the bytes added so far, the stream may be continued */
+uint32_t crc_stream_final(const crc_stream_struct *ctx);
+/* calculate the CRC of one buffer */
+uint32_t crc_stream_calculate(crc_stream_type_enum type, const void *data, uint32_t len);
+
+#endif /* CRC_STREAM_H */
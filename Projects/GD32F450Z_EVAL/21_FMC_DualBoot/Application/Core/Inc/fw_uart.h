@@ -0,0 +1,65 @@
+/*!
+    \file    fw_uart.h
+    \brief   the header file of the UART firmware update transport
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef FW_UART_H
+#define FW_UART_H
+
+#include "gd32f4xx.h"
+
+/*
+    protocol on EVAL_COM0, the host waits for each reply before it sends on:
+    host: FW_UART_START, 32 byte fw_image_header_struct     device: FW_UART_ACK or FW_UART_ERROR, status
+    host: FW_UART_BLOCK_SIZE image bytes (less for the last) device: FW_UART_ACK once the engine took them
+    device after the last block is verified: FW_UART_DONE, then it resets into the new image,
+    or FW_UART_ERROR, status
+*/
+#define FW_UART_START              'U'
+#define FW_UART_ACK                'K'
+#define FW_UART_ERROR              'E'
+#define FW_UART_DONE               'D'
+
+#define FW_UART_BLOCK_SIZE         256U
+#define FW_UART_RX_SIZE            1024U
+/* a transfer without a byte for this long is dropped */
+#define FW_UART_TIMEOUT_MS         2000U
+
+/* function declarations */
+/* enable the receive interrupt of EVAL_COM0 */
+void fw_uart_init(void);
+/* receive interrupt handler */
+void fw_uart_irq_handler(void);
+/* run the update protocol, call from the main loop; returns 1 while an update is running */
+uint32_t fw_uart_poll(void);
+
+#endif /* FW_UART_H */
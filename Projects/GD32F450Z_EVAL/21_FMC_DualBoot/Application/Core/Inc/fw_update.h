@@ -0,0 +1,123 @@
+/*!
+    \file    fw_update.h
+    \brief   the header file of the A/B firmware update engine
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef FW_UPDATE_H
+#define FW_UPDATE_H
+
+#ifdef DUALBOOT_HOST
+/* built on a PC by the tools in Utilities/fwupdate */
+#include "dualboot_host.h"
+#else
+#include "gd32f4xx.h"
+#endif /* DUALBOOT_HOST */
+
+/* each bank holds one image; the last 128KB sector of a bank holds its bank record,
+   so images are linked for at most FW_IMAGE_MAX_SIZE bytes */
+#define FW_BANK0_BASE              0x08000000U
+#define FW_BANK1_BASE              0x08100000U
+#define FW_RECORD_OFFSET           0x000E0000U
+#define FW_IMAGE_MAX_SIZE          FW_RECORD_OFFSET
+
+/* bytes programmed per burst; FW_PAGE_COUNT pages are buffered while a sector erase runs,
+   16KB cover the ~1s erase of a 128KB sector at 115200 baud */
+#define FW_PAGE_SIZE               1024U
+#define FW_PAGE_COUNT              16U
+/* boots an unconfirmed image gets before it is rolled back */
+#define FW_MAX_BOOT_ATTEMPTS       3U
+/* free watchdog reload while an unconfirmed image runs, about 8s with FWDGT_PSC_DIV64 on the 32KHz IRC */
+#define FW_TRIAL_WATCHDOG_RELOAD   0x0FFFU
+
+#define FW_IMAGE_MAGIC             0x57464447U          /*!< "GDFW" */
+#define FW_RECORD_MAGIC            0x44524342U          /*!< "BCRD" */
+#define FW_MARK                    0x00000000U          /*!< value of a programmed mark word */
+
+/* image header sent in front of the image */
+typedef struct {
+    uint32_t magic;                                      /*!< FW_IMAGE_MAGIC */
+    uint32_t version;                                    /*!< firmware version, informational */
+    uint32_t bank;                                       /*!< bank the image is linked for, 0 or 1 */
+    uint32_t size;                                       /*!< image size in bytes, multiple of 4 */
+    uint32_t crc;                                        /*!< CRC unit checksum of the image words */
+    uint32_t reserved[2];
+    uint32_t header_crc;                                 /*!< CRC unit checksum of the words above */
+} fw_image_header_struct;
+
+/* bank record, every word is programmed at most once after the sector erase */
+typedef struct {
+    uint32_t magic;                                      /*!< FW_RECORD_MAGIC, programmed last after verification */
+    uint32_t version;                                    /*!< firmware version */
+    uint32_t size;                                       /*!< image size in bytes */
+    uint32_t crc;                                        /*!< CRC unit checksum of the image */
+    uint32_t confirmed;                                  /*!< FW_MARK once the image confirmed itself */
+    uint32_t invalid;                                    /*!< FW_MARK once the image was rolled back */
+    uint32_t attempts[FW_MAX_BOOT_ATTEMPTS];             /*!< one FW_MARK per unconfirmed boot */
+} fw_bank_record_struct;
+
+/* state of a bank */
+typedef enum {
+    FW_BANK_EMPTY = 0,                                   /*!< no bank record, e.g. programmed by the debugger */
+    FW_BANK_TRIAL,                                       /*!< verified image which has not confirmed itself yet */
+    FW_BANK_CONFIRMED,                                   /*!< image confirmed after booting */
+    FW_BANK_INVALID                                      /*!< image rolled back */
+} fw_bank_state_enum;
+
+/* state of the update engine */
+typedef enum {
+    FW_UPDATE_IDLE = 0,                                  /*!< no update started */
+    FW_UPDATE_BUSY,                                      /*!< image is being received, erased and programmed */
+    FW_UPDATE_DONE,                                      /*!< image verified, the next reset boots it */
+    FW_UPDATE_ERR_HEADER,                                /*!< header damaged or built for the running bank */
+    FW_UPDATE_ERR_FLASH,                                 /*!< erase or program failed */
+    FW_UPDATE_ERR_CRC                                    /*!< programmed image does not match its checksum */
+} fw_update_status_enum;
+
+/* function declarations */
+/* get the bank the firmware is running from */
+uint32_t fw_bank_running(void);
+/* get the state of a bank */
+fw_bank_state_enum fw_bank_state_get(uint32_t bank);
+/* count the boot attempts and finish interrupted swaps and rollbacks, call first in main */
+void fw_boot_check(void);
+/* mark the running image good, it stays the boot image from now on */
+void fw_update_confirm(void);
+/* start receiving an image into the inactive bank */
+fw_update_status_enum fw_update_begin(const fw_image_header_struct *header);
+/* pass image data, returns the number of bytes accepted */
+uint32_t fw_update_write(const uint8_t *data, uint32_t len);
+/* advance erase, programming and verification, call from the main loop */
+fw_update_status_enum fw_update_poll(void);
+/* cancel the running update */
+void fw_update_abort(void);
+
+#endif /* FW_UPDATE_H */
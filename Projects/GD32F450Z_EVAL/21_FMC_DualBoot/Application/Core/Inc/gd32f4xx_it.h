@@ -56,5 +56,7 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 /* this function handles external lines 10 to 15 interrupt exception */
 void EXTI10_15_IRQHandler(void);
+/* this function handles USART0 interrupt exception */
+void USART0_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
@@ -0,0 +1,469 @@
+/*!
+    \file    crc_stream.c
+    \brief   streaming CRC-32 service on the CRC unit
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "crc_stream.h"
+
+/*
+    all variants keep the CRC register in MSB first order, as the CRC unit does:
+    - a word x changes the register like the unit does with CRC_DATA = x:
+      reg ^= x, then 32 shifts; the unit is loaded with the x of the variant,
+      the word itself, __REV() for MPEG-2 and __RBIT() for the reflected CRC-32
+    - a single byte shifts 8 times, for CRC-32 with the bits of the byte reversed
+    the DMA can only copy words, so it only feeds CRC_STREAM_UNIT runs; the other
+    variants and runs at unaligned addresses are fed by the CPU
+*/
+
+/* DMA transfer number limit */
+#define CRC_STREAM_DMA_PIECE       0xFFFFU
+
+/* MSB first table of the polynomial 0x04C11DB7 */
+static const uint32_t crc_table[256] = {
+    0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU, 0x17C56B6BU,
+    0x1A864DB2U, 0x1E475005U, 0x2608EDB8U, 0x22C9F00FU, 0x2F8AD6D6U, 0x2B4BCB61U,
+    0x350C9B64U, 0x31CD86D3U, 0x3C8EA00AU, 0x384FBDBDU, 0x4C11DB70U, 0x48D0C6C7U,
+    0x4593E01EU, 0x4152FDA9U, 0x5F15ADACU, 0x5BD4B01BU, 0x569796C2U, 0x52568B75U,
+    0x6A1936C8U, 0x6ED82B7FU, 0x639B0DA6U, 0x675A1011U, 0x791D4014U, 0x7DDC5DA3U,
+    0x709F7B7AU, 0x745E66CDU, 0x9823B6E0U, 0x9CE2AB57U, 0x91A18D8EU, 0x95609039U,
+    0x8B27C03CU, 0x8FE6DD8BU, 0x82A5FB52U, 0x8664E6E5U, 0xBE2B5B58U, 0xBAEA46EFU,
+    0xB7A96036U, 0xB3687D81U, 0xAD2F2D84U, 0xA9EE3033U, 0xA4AD16EAU, 0xA06C0B5DU,
+    0xD4326D90U, 0xD0F37027U, 0xDDB056FEU, 0xD9714B49U, 0xC7361B4CU, 0xC3F706FBU,
+    0xCEB42022U, 0xCA753D95U, 0xF23A8028U, 0xF6FB9D9FU, 0xFBB8BB46U, 0xFF79A6F1U,
+    0xE13EF6F4U, 0xE5FFEB43U, 0xE8BCCD9AU, 0xEC7DD02DU, 0x34867077U, 0x30476DC0U,
+    0x3D044B19U, 0x39C556AEU, 0x278206ABU, 0x23431B1CU, 0x2E003DC5U, 0x2AC12072U,
+    0x128E9DCFU, 0x164F8078U, 0x1B0CA6A1U, 0x1FCDBB16U, 0x018AEB13U, 0x054BF6A4U,
+    0x0808D07DU, 0x0CC9CDCAU, 0x7897AB07U, 0x7C56B6B0U, 0x71159069U, 0x75D48DDEU,
+    0x6B93DDDBU, 0x6F52C06CU, 0x6211E6B5U, 0x66D0FB02U, 0x5E9F46BFU, 0x5A5E5B08U,
+    0x571D7DD1U, 0x53DC6066U, 0x4D9B3063U, 0x495A2DD4U, 0x44190B0DU, 0x40D816BAU,
+    0xACA5C697U, 0xA864DB20U, 0xA527FDF9U, 0xA1E6E04EU, 0xBFA1B04BU, 0xBB60ADFCU,
+    0xB6238B25U, 0xB2E29692U, 0x8AAD2B2FU, 0x8E6C3698U, 0x832F1041U, 0x87EE0DF6U,
+    0x99A95DF3U, 0x9D684044U, 0x902B669DU, 0x94EA7B2AU, 0xE0B41DE7U, 0xE4750050U,
+    0xE9362689U, 0xEDF73B3EU, 0xF3B06B3BU, 0xF771768CU, 0xFA325055U, 0xFEF34DE2U,
+    0xC6BCF05FU, 0xC27DEDE8U, 0xCF3ECB31U, 0xCBFFD686U, 0xD5B88683U, 0xD1799B34U,
+    0xDC3ABDEDU, 0xD8FBA05AU, 0x690CE0EEU, 0x6DCDFD59U, 0x608EDB80U, 0x644FC637U,
+    0x7A089632U, 0x7EC98B85U, 0x738AAD5CU, 0x774BB0EBU, 0x4F040D56U, 0x4BC510E1U,
+    0x46863638U, 0x42472B8FU, 0x5C007B8AU, 0x58C1663DU, 0x558240E4U, 0x51435D53U,
+    0x251D3B9EU, 0x21DC2629U, 0x2C9F00F0U, 0x285E1D47U, 0x36194D42U, 0x32D850F5U,
+    0x3F9B762CU, 0x3B5A6B9BU, 0x0315D626U, 0x07D4CB91U, 0x0A97ED48U, 0x0E56F0FFU,
+    0x1011A0FAU, 0x14D0BD4DU, 0x19939B94U, 0x1D528623U, 0xF12F560EU, 0xF5EE4BB9U,
+    0xF8AD6D60U, 0xFC6C70D7U, 0xE22B20D2U, 0xE6EA3D65U, 0xEBA91BBCU, 0xEF68060BU,
+    0xD727BBB6U, 0xD3E6A601U, 0xDEA580D8U, 0xDA649D6FU, 0xC423CD6AU, 0xC0E2D0DDU,
+    0xCDA1F604U, 0xC960EBB3U, 0xBD3E8D7EU, 0xB9FF90C9U, 0xB4BCB610U, 0xB07DABA7U,
+    0xAE3AFBA2U, 0xAAFBE615U, 0xA7B8C0CCU, 0xA379DD7BU, 0x9B3660C6U, 0x9FF77D71U,
+    0x92B45BA8U, 0x9675461FU, 0x8832161AU, 0x8CF30BADU, 0x81B02D74U, 0x857130C3U,
+    0x5D8A9099U, 0x594B8D2EU, 0x5408ABF7U, 0x50C9B640U, 0x4E8EE645U, 0x4A4FFBF2U,
+    0x470CDD2BU, 0x43CDC09CU, 0x7B827D21U, 0x7F436096U, 0x7200464FU, 0x76C15BF8U,
+    0x68860BFDU, 0x6C47164AU, 0x61043093U, 0x65C52D24U, 0x119B4BE9U, 0x155A565EU,
+    0x18197087U, 0x1CD86D30U, 0x029F3D35U, 0x065E2082U, 0x0B1D065BU, 0x0FDC1BECU,
+    0x3793A651U, 0x3352BBE6U, 0x3E119D3FU, 0x3AD08088U, 0x2497D08DU, 0x2056CD3AU,
+    0x2D15EBE3U, 0x29D4F654U, 0xC5A92679U, 0xC1683BCEU, 0xCC2B1D17U, 0xC8EA00A0U,
+    0xD6AD50A5U, 0xD26C4D12U, 0xDF2F6BCBU, 0xDBEE767CU, 0xE3A1CBC1U, 0xE760D676U,
+    0xEA23F0AFU, 0xEEE2ED18U, 0xF0A5BD1DU, 0xF464A0AAU, 0xF9278673U, 0xFDE69BC4U,
+    0x89B8FD09U, 0x8D79E0BEU, 0x803AC667U, 0x84FBDBD0U, 0x9ABC8BD5U, 0x9E7D9662U,
+    0x933EB0BBU, 0x97FFAD0CU, 0xAFB010B1U, 0xAB710D06U, 0xA6322BDFU, 0xA2F33668U,
+    0xBCB4666DU, 0xB8757BDAU, 0xB5365D03U, 0xB1F740B4U
+};
+
+static volatile uint8_t crc_unit_busy = 0U;
+
+/*!
+    \brief      shift a byte through the CRC register
+    \param[in]  reg: CRC register
+    \param[in]  byte: byte, MSB first
+    \param[out] none
+    \retval     CRC register
+*/
+static uint32_t crc_sw_byte(uint32_t reg, uint8_t byte)
+{
+    return (reg << 8) ^ crc_table[(reg >> 24) ^ byte];
+}
+
+/*!
+    \brief      shift a word through the CRC register like the CRC unit
+    \param[in]  reg: CRC register
+    \param[in]  x: word as written to CRC_DATA
+    \param[out] none
+    \retval     CRC register
+*/
+static uint32_t crc_sw_word(uint32_t reg, uint32_t x)
+{
+    reg ^= x;
+    reg = (reg << 8) ^ crc_table[reg >> 24];
+    reg = (reg << 8) ^ crc_table[reg >> 24];
+    reg = (reg << 8) ^ crc_table[reg >> 24];
+    return (reg << 8) ^ crc_table[reg >> 24];
+}
+
+/*!
+    \brief      get the CRC unit input for four stream bytes
+    \param[in]  type: CRC variant
+    \param[in]  p: bytes, any alignment
+    \param[out] none
+    \retval     word for CRC_DATA
+*/
+static uint32_t crc_word_input(crc_stream_type_enum type, const uint8_t *p)
+{
+    uint32_t w = __UNALIGNED_UINT32_READ(p);
+
+    if(CRC_STREAM_MPEG2 == type) {
+        return __REV(w);
+    } else if(CRC_STREAM_CRC32 == type) {
+        return __RBIT(w);
+    }
+    return w;
+}
+
+/*!
+    \brief      shift single bytes of MPEG-2 or CRC-32 through the CRC register
+    \param[in]  ctx: CRC stream
+    \param[in]  p: bytes
+    \param[in]  len: number of bytes
+    \param[out] none
+    \retval     none
+*/
+static void crc_sw_bytes(crc_stream_struct *ctx, const uint8_t *p, uint32_t len)
+{
+    for(; 0U != len; len--, p++) {
+        ctx->reg = crc_sw_byte(ctx->reg, (CRC_STREAM_CRC32 == ctx->type) ? (uint8_t)(__RBIT(*p) >> 24) : *p);
+    }
+}
+
+#if CRC_STREAM_USE_HW
+/*!
+    \brief      shift the inverse of 32 zero bits through a CRC register
+    \param[in]  reg: CRC register
+    \param[out] none
+    \retval     register which 32 shifts turn into reg
+*/
+static uint32_t crc_unshift32(uint32_t reg)
+{
+    uint32_t i;
+
+    /* a shift with the polynomial applied always leaves bit 0 set */
+    for(i = 0U; i < 32U; i++) {
+        reg = (0U != (reg & 1U)) ? (((reg ^ 0x04C11DB7U) >> 1) | 0x80000000U) : (reg >> 1);
+    }
+    return reg;
+}
+
+/*!
+    \brief      claim the CRC unit and load it with a register value
+    \param[in]  reg: CRC register
+    \param[out] none
+    \retval     0 when another user holds the unit
+*/
+static uint32_t crc_unit_claim(uint32_t reg)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(0U != crc_unit_busy) {
+        __set_PRIMASK(primask);
+        return 0U;
+    }
+    crc_unit_busy = 1U;
+    __set_PRIMASK(primask);
+
+    rcu_periph_clock_enable(RCU_CRC);
+    crc_data_register_reset();
+    if(0xFFFFFFFFU != reg) {
+        /* the unit only resets to 0xFFFFFFFF, one word moves it to reg */
+        CRC_DATA = 0xFFFFFFFFU ^ crc_unshift32(reg);
+    }
+    return 1U;
+}
+
+/*!
+    \brief      start the next DMA piece of a run
+    \param[in]  ctx: CRC stream
+    \param[out] none
+    \retval     none
+*/
+static void crc_dma_piece_start(crc_stream_struct *ctx)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+
+    ctx->dma_piece = (ctx->dma_words > CRC_STREAM_DMA_PIECE) ? CRC_STREAM_DMA_PIECE : ctx->dma_words;
+    ctx->dma_words -= ctx->dma_piece;
+
+    dma_deinit(CRC_STREAM_DMA, CRC_STREAM_DMA_CH);
+    /* memory to memory: the peripheral address is the source */
+    dma_init_struct.periph_addr = ctx->dma_next;
+    dma_init_struct.periph_width = DMA_PERIPH_WIDTH_32BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_ENABLE;
+    dma_init_struct.memory0_addr = (uint32_t)&CRC_DATA;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_DISABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_SINGLE;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_MEMORY;
+    dma_init_struct.number = ctx->dma_piece;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_multi_data_mode_init(CRC_STREAM_DMA, CRC_STREAM_DMA_CH, &dma_init_struct);
+    dma_channel_enable(CRC_STREAM_DMA, CRC_STREAM_DMA_CH);
+}
+#endif /* CRC_STREAM_USE_HW */
+
+/*!
+    \brief      shift whole words through the CRC register, on the CRC unit when it is free
+    \param[in]  ctx: CRC stream
+    \param[in]  p: bytes, any alignment
+    \param[in]  words: number of words
+    \param[in]  hw: 0 to stay in software
+    \param[out] none
+    \retval     none
+*/
+static void crc_words(crc_stream_struct *ctx, const uint8_t *p, uint32_t words, uint32_t hw)
+{
+#if CRC_STREAM_USE_HW
+    if((0U != hw) && (0U != words) && crc_unit_claim(ctx->reg)) {
+        for(; 0U != words; words--, p += 4) {
+            CRC_DATA = crc_word_input(ctx->type, p);
+        }
+        ctx->reg = CRC_DATA;
+        crc_unit_busy = 0U;
+        return;
+    }
+#endif /* CRC_STREAM_USE_HW */
+    for(; 0U != words; words--, p += 4) {
+        ctx->reg = crc_sw_word(ctx->reg, crc_word_input(ctx->type, p));
+    }
+}
+
+/*!
+    \brief      add a chunk
+    \param[in]  ctx: CRC stream
+    \param[in]  p: bytes
+    \param[in]  len: number of bytes
+    \param[in]  hw: 0 to stay in software
+    \param[out] none
+    \retval     1 while a DMA run continues the chunk
+*/
+static uint32_t crc_stream_add(crc_stream_struct *ctx, const uint8_t *p, uint32_t len, uint32_t hw)
+{
+    uint32_t words;
+
+    if(CRC_STREAM_UNIT != ctx->type) {
+        crc_words(ctx, p, len / 4U, hw);
+        crc_sw_bytes(ctx, p + (len & ~3U), len & 3U);
+        return 0U;
+    }
+
+    /* complete the word left by the previous chunk */
+    while((0U != ctx->partial_len) && (0U != len)) {
+        ctx->partial |= (uint32_t)*p++ << (8U * ctx->partial_len);
+        len--;
+        if(4U == ++ctx->partial_len) {
+            ctx->reg = crc_sw_word(ctx->reg, ctx->partial);
+            ctx->partial = 0U;
+            ctx->partial_len = 0U;
+        }
+    }
+
+    words = len / 4U;
+#if CRC_STREAM_USE_HW
+    /* the DMA reads aligned words only */
+    if((0U != hw) && (words >= (CRC_STREAM_DMA_MIN / 4U)) && (0U == ((uint32_t)p & 3U)) && crc_unit_claim(ctx->reg)) {
+        rcu_periph_clock_enable(RCU_DMA1);
+        ctx->dma_next = (uint32_t)p;
+        ctx->dma_words = words;
+        ctx->tail = p + (words * 4U);
+        ctx->tail_len = len & 3U;
+        ctx->dma_active = 1U;
+        crc_dma_piece_start(ctx);
+        return 1U;
+    }
+#endif /* CRC_STREAM_USE_HW */
+    crc_words(ctx, p, words, hw);
+    for(p += words * 4U, len &= 3U; 0U != len; len--) {
+        ctx->partial |= (uint32_t)*p++ << (8U * ctx->partial_len++);
+    }
+    return 0U;
+}
+
+/*!
+    \brief      start a CRC
+    \param[in]  ctx: CRC stream
+    \param[in]  type: CRC variant
+      \arg        CRC_STREAM_UNIT: checksum of the CRC unit over words
+      \arg        CRC_STREAM_MPEG2: CRC-32/MPEG-2
+      \arg        CRC_STREAM_CRC32: CRC-32 of zlib and Ethernet
+    \param[out] none
+    \retval     none
+*/
+void crc_stream_init(crc_stream_struct *ctx, crc_stream_type_enum type)
+{
+    ctx->reg = 0xFFFFFFFFU;
+    ctx->type = type;
+    ctx->partial = 0U;
+    ctx->partial_len = 0U;
+    ctx->tail = NULL;
+    ctx->tail_len = 0U;
+    ctx->dma_active = 0U;
+}
+
+/*!
+    \brief      add a chunk, a long CRC_STREAM_UNIT chunk starts a DMA run; the chunk
+                must stay valid until crc_stream_poll() returns 0
+    \param[in]  ctx: CRC stream
+    \param[in]  data: bytes following the previous chunk
+    \param[in]  len: number of bytes
+    \param[out] none
+    \retval     1 while a DMA run continues the chunk
+*/
+uint32_t crc_stream_update_start(crc_stream_struct *ctx, const void *data, uint32_t len)
+{
+    /* finish the previous run first */
+    while(crc_stream_poll(ctx)) {
+    }
+    return crc_stream_add(ctx, (const uint8_t *)data, len, 1U);
+}
+
+/*!
+    \brief      advance a DMA run
+    \param[in]  ctx: CRC stream
+    \param[out] none
+    \retval     1 while the run continues
+*/
+uint32_t crc_stream_poll(crc_stream_struct *ctx)
+{
+#if CRC_STREAM_USE_HW
+    uint32_t done;
+
+    if(0U == ctx->dma_active) {
+        return 0U;
+    }
+    if(SET == dma_flag_get(CRC_STREAM_DMA, CRC_STREAM_DMA_CH, DMA_FLAG_TAE)) {
+        /* the CRC unit holds the words copied before the error, the CPU adds the rest */
+        done = ctx->dma_piece - dma_transfer_number_get(CRC_STREAM_DMA, CRC_STREAM_DMA_CH);
+        dma_channel_disable(CRC_STREAM_DMA, CRC_STREAM_DMA_CH);
+        dma_flag_clear(CRC_STREAM_DMA, CRC_STREAM_DMA_CH, DMA_FLAG_TAE);
+        ctx->reg = CRC_DATA;
+        crc_unit_busy = 0U;
+        ctx->dma_active = 0U;
+        crc_words(ctx, (const uint8_t *)(ctx->dma_next + (done * 4U)), (ctx->dma_piece - done) + ctx->dma_words, 0U);
+    } else if(SET == dma_flag_get(CRC_STREAM_DMA, CRC_STREAM_DMA_CH, DMA_FLAG_FTF)) {
+        dma_flag_clear(CRC_STREAM_DMA, CRC_STREAM_DMA_CH, DMA_FLAG_FTF);
+        if(0U != ctx->dma_words) {
+            ctx->dma_next += ctx->dma_piece * 4U;
+            crc_dma_piece_start(ctx);
+            return 1U;
+        }
+        ctx->reg = CRC_DATA;
+        crc_unit_busy = 0U;
+        ctx->dma_active = 0U;
+    } else {
+        return 1U;
+    }
+
+    /* the bytes after the last word wait for the next chunk */
+    for(; 0U != ctx->tail_len; ctx->tail_len--) {
+        ctx->partial |= (uint32_t)*ctx->tail++ << (8U * ctx->partial_len++);
+    }
+#endif /* CRC_STREAM_USE_HW */
+    return 0U;
+}
+
+/*!
+    \brief      add a chunk and wait for the DMA
+    \param[in]  ctx: CRC stream
+    \param[in]  data: bytes following the previous chunk
+    \param[in]  len: number of bytes
+    \param[out] none
+    \retval     none
+*/
+void crc_stream_update(crc_stream_struct *ctx, const void *data, uint32_t len)
+{
+    if(crc_stream_update_start(ctx, data, len)) {
+        while(crc_stream_poll(ctx)) {
+        }
+    }
+}
+
+/*!
+    \brief      add a chunk in software only, the bit exact reference of the hardware paths
+    \param[in]  ctx: CRC stream
+    \param[in]  data: bytes following the previous chunk
+    \param[in]  len: number of bytes
+    \param[out] none
+    \retval     none
+*/
+void crc_stream_sw_update(crc_stream_struct *ctx, const void *data, uint32_t len)
+{
+    while(crc_stream_poll(ctx)) {
+    }
+    crc_stream_add(ctx, (const uint8_t *)data, len, 0U);
+}
+
+/*!
+    \brief      get the CRC of the bytes added so far, the stream may be continued
+    \param[in]  ctx: CRC stream, no DMA run in progress
+    \param[out] none
+    \retval     CRC value
+*/
+uint32_t crc_stream_final(const crc_stream_struct *ctx)
+{
+    uint32_t reg = ctx->reg;
+    uint32_t i;
+
+    if(CRC_STREAM_CRC32 == ctx->type) {
+        return ~__RBIT(reg);
+    }
+    /* an incomplete last word of CRC_STREAM_UNIT is taken bytewise */
+    for(i = 0U; i < ctx->partial_len; i++) {
+        reg = crc_sw_byte(reg, (uint8_t)(ctx->partial >> (8U * i)));
+    }
+    return reg;
+}
+
+/*!
+    \brief      calculate the CRC of one buffer
+    \param[in]  type: CRC variant
+      \arg        CRC_STREAM_UNIT: checksum of the CRC unit over words
+      \arg        CRC_STREAM_MPEG2: CRC-32/MPEG-2
+      \arg        CRC_STREAM_CRC32: CRC-32 of zlib and Ethernet
+    \param[in]  data: bytes
+    \param[in]  len: number of bytes
+    \param[out] none
+    \retval     CRC value
+*/
+uint32_t crc_stream_calculate(crc_stream_type_enum type, const void *data, uint32_t len)
+{
+    crc_stream_struct ctx;
+
+    crc_stream_init(&ctx, type);
+    crc_stream_update(&ctx, data, len);
+    return crc_stream_final(&ctx);
+}
@@ -0,0 +1,213 @@
+/*!
+    \file    fw_uart.c
+    \brief   UART firmware update transport
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "fw_uart.h"
+#include "fw_update.h"
+#include "gd32f450z_eval.h"
+
+typedef enum {
+    FW_UART_IDLE = 0,                                    /* waiting for FW_UART_START */
+    FW_UART_HEADER,                                      /* receiving the image header */
+    FW_UART_DATA                                         /* receiving image blocks */
+} fw_uart_state_enum;
+
+static volatile uint8_t rx_buf[FW_UART_RX_SIZE];
+static volatile uint32_t rx_head = 0U;                   /* written by the interrupt */
+static volatile uint32_t rx_tail = 0U;                   /* written by fw_uart_poll() */
+
+static fw_uart_state_enum uart_state = FW_UART_IDLE;
+static fw_image_header_struct uart_header;
+static uint8_t uart_block[FW_UART_BLOCK_SIZE];
+static uint32_t uart_fill;                               /* bytes in uart_header or uart_block */
+static uint32_t uart_taken;                              /* bytes of uart_block passed to the engine */
+static uint32_t uart_remaining;                          /* image bytes not yet received */
+static uint32_t uart_last_rx;                            /* cycle count of the last received byte */
+
+/*!
+    \brief      send a byte on EVAL_COM0
+    \param[in]  byte: byte to send
+    \param[out] none
+    \retval     none
+*/
+static void fw_uart_send(uint8_t byte)
+{
+    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TBE)) {
+    }
+    usart_data_transmit(EVAL_COM0, byte);
+}
+
+/*!
+    \brief      reply with an error and return to idle
+    \param[in]  status: engine status
+    \param[out] none
+    \retval     none
+*/
+static void fw_uart_error(fw_update_status_enum status)
+{
+    fw_update_abort();
+    fw_uart_send(FW_UART_ERROR);
+    fw_uart_send((uint8_t)status);
+    uart_state = FW_UART_IDLE;
+}
+
+/*!
+    \brief      enable the receive interrupt of EVAL_COM0
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void fw_uart_init(void)
+{
+    /* the cycle counter times out stalled transfers */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    nvic_irq_enable(USART0_IRQn, 1U, 0U);
+    usart_interrupt_enable(EVAL_COM0, USART_INT_RBNE);
+}
+
+/*!
+    \brief      receive interrupt handler, the host never sends more than one block
+                ahead, so the ring cannot overflow
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void fw_uart_irq_handler(void)
+{
+    uint32_t head;
+
+    if((RESET != usart_interrupt_flag_get(EVAL_COM0, USART_INT_FLAG_RBNE)) ||
+            (RESET != usart_interrupt_flag_get(EVAL_COM0, USART_INT_FLAG_RBNE_ORERR))) {
+        /* reading the data also clears an overrun */
+        head = rx_head;
+        rx_buf[head] = (uint8_t)usart_data_receive(EVAL_COM0);
+        head = (head + 1U) % FW_UART_RX_SIZE;
+        if(head != rx_tail) {
+            rx_head = head;
+        }
+    }
+}
+
+/*!
+    \brief      run the update protocol, call from the main loop
+    \param[in]  none
+    \param[out] none
+    \retval     1 while an update is running
+*/
+uint32_t fw_uart_poll(void)
+{
+    fw_update_status_enum status;
+    uint32_t tail = rx_tail;
+    uint32_t len = 0U;
+    uint8_t byte;
+
+    /* move the received bytes into the header or the block */
+    while(tail != rx_head) {
+        if(FW_UART_DATA == uart_state) {
+            len = (uart_remaining < FW_UART_BLOCK_SIZE) ? uart_remaining : FW_UART_BLOCK_SIZE;
+            if(uart_fill == len) {
+                break;
+            }
+        }
+        byte = rx_buf[tail];
+        tail = (tail + 1U) % FW_UART_RX_SIZE;
+        uart_last_rx = DWT->CYCCNT;
+
+        if(FW_UART_IDLE == uart_state) {
+            if(FW_UART_START == byte) {
+                uart_state = FW_UART_HEADER;
+                uart_fill = 0U;
+            }
+        } else if(FW_UART_HEADER == uart_state) {
+            ((uint8_t *)&uart_header)[uart_fill++] = byte;
+            if(sizeof(uart_header) == uart_fill) {
+                status = fw_update_begin(&uart_header);
+                if(FW_UPDATE_BUSY != status) {
+                    fw_uart_error(status);
+                } else {
+                    uart_state = FW_UART_DATA;
+                    uart_fill = 0U;
+                    uart_taken = 0U;
+                    uart_remaining = uart_header.size;
+                    fw_uart_send(FW_UART_ACK);
+                }
+            }
+        } else {
+            uart_block[uart_fill++] = byte;
+        }
+    }
+    rx_tail = tail;
+
+    if(FW_UART_IDLE == uart_state) {
+        return 0U;
+    }
+    len = (uart_remaining < FW_UART_BLOCK_SIZE) ? uart_remaining : FW_UART_BLOCK_SIZE;
+    /* drop the transfer when the host stops sending, not while the engine is busy */
+    if(((FW_UART_HEADER == uart_state) || (uart_fill < len)) &&
+            ((DWT->CYCCNT - uart_last_rx) > ((SystemCoreClock / 1000U) * FW_UART_TIMEOUT_MS))) {
+        fw_update_abort();
+        uart_state = FW_UART_IDLE;
+        return 0U;
+    }
+    if(FW_UART_HEADER == uart_state) {
+        return 1U;
+    }
+
+    /* pass the completed block to the engine, acknowledge when all of it is taken */
+    if((0U != len) && (uart_fill == len)) {
+        uart_taken += fw_update_write(&uart_block[uart_taken], len - uart_taken);
+        if(uart_taken == len) {
+            uart_remaining -= len;
+            uart_fill = 0U;
+            uart_taken = 0U;
+            if(0U != uart_remaining) {
+                uart_last_rx = DWT->CYCCNT;
+                fw_uart_send(FW_UART_ACK);
+            }
+        }
+    }
+
+    status = fw_update_poll();
+    if(FW_UPDATE_DONE == status) {
+        fw_uart_send(FW_UART_DONE);
+        while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TC)) {
+        }
+        NVIC_SystemReset();
+    } else if(FW_UPDATE_BUSY != status) {
+        fw_uart_error(status);
+        return 0U;
+    }
+    return 1U;
+}
@@ -0,0 +1,490 @@
+/*!
+    \file    fw_update.c
+    \brief   A/B firmware update engine on the FMC dual-bank boot
+
+    \version 2024-12-20, V3.3.1, demo for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "fw_update.h"
+#include "crc_stream.h"
+#include <string.h>
+
+/*
+    power loss analysis, the boot bank is only switched after the new image is complete:
+    - while the inactive bank is erased and programmed, the running bank and the BB bit are
+      untouched; the record sector is erased first, so a half written bank has no record
+    - the record is programmed after the CRC check, magic last; a record without magic is
+      ignored and the bank is written again on the next update
+    - between the magic and the BB bit change, fw_boot_check() of the old image sees the
+      other bank in trial state without boot attempts and completes the switch
+    - a trial boot programs its attempt word before the image runs, a hang ends in a
+      watchdog reset; after FW_MAX_BOOT_ATTEMPTS the image is marked invalid and the old
+      bank boots again, the invalid mark is programmed before the BB bit is changed back
+*/
+
+#define FW_SECTOR_COUNT            12U
+#define FW_RECORD_SECTOR           11U
+
+/* initial stack pointer range of a bootable image: SRAM or TCMRAM */
+#define FW_SRAM_BASE               0x20000000U
+#define FW_SRAM_END                0x20030000U
+#define FW_TCMRAM_BASE             0x10000000U
+#define FW_TCMRAM_END              0x10010000U
+
+#define FW_FMC_FLAGS               (FMC_FLAG_END | FMC_FLAG_OPERR | FMC_FLAG_WPERR | FMC_FLAG_PGMERR | FMC_FLAG_PGSERR)
+
+/* sector offsets from the bank base, the last sector holds the bank record */
+static const uint32_t fw_sector_offset[FW_SECTOR_COUNT + 1U] = {
+    0x00000U, 0x04000U, 0x08000U, 0x0C000U, 0x10000U, 0x20000U,
+    0x40000U, 0x60000U, 0x80000U, 0xA0000U, 0xC0000U, 0xE0000U, 0x100000U
+};
+
+static const uint32_t fw_sector_number[2][FW_SECTOR_COUNT] = {
+    {
+        CTL_SECTOR_NUMBER_0, CTL_SECTOR_NUMBER_1, CTL_SECTOR_NUMBER_2, CTL_SECTOR_NUMBER_3,
+        CTL_SECTOR_NUMBER_4, CTL_SECTOR_NUMBER_5, CTL_SECTOR_NUMBER_6, CTL_SECTOR_NUMBER_7,
+        CTL_SECTOR_NUMBER_8, CTL_SECTOR_NUMBER_9, CTL_SECTOR_NUMBER_10, CTL_SECTOR_NUMBER_11
+    },
+    {
+        CTL_SECTOR_NUMBER_12, CTL_SECTOR_NUMBER_13, CTL_SECTOR_NUMBER_14, CTL_SECTOR_NUMBER_15,
+        CTL_SECTOR_NUMBER_16, CTL_SECTOR_NUMBER_17, CTL_SECTOR_NUMBER_18, CTL_SECTOR_NUMBER_19,
+        CTL_SECTOR_NUMBER_20, CTL_SECTOR_NUMBER_21, CTL_SECTOR_NUMBER_22, CTL_SECTOR_NUMBER_23
+    }
+};
+
+static fw_update_status_enum fwu_status = FW_UPDATE_IDLE;
+static fw_image_header_struct fwu_header;
+static uint32_t fwu_bank;                                /* bank being written */
+static uint32_t fwu_received;                            /* image bytes accepted */
+static uint32_t fwu_programmed;                          /* image bytes programmed */
+static uint32_t fwu_erased;                              /* image bytes in erased sectors */
+static uint32_t fwu_next_sector;                         /* next image sector to erase */
+static uint8_t fwu_record_erased;                        /* record sector erased */
+static uint8_t fwu_erasing;                              /* a sector erase is running */
+static uint8_t fwu_verifying;                            /* the DMA feeds the image to the CRC unit */
+static crc_stream_struct fwu_crc;
+
+/* page queue between fw_update_write() and the programming in fw_update_poll() */
+static uint32_t fwu_page[FW_PAGE_COUNT][FW_PAGE_SIZE / 4U];
+static uint32_t fwu_page_in;                             /* page being filled */
+static uint32_t fwu_page_out;                            /* next page to program */
+static uint32_t fwu_page_fill;                           /* bytes in the page being filled */
+static uint32_t fwu_pages_full;                          /* pages waiting to be programmed */
+
+/*!
+    \brief      get the base address of a bank
+    \param[in]  bank: 0 or 1
+    \param[out] none
+    \retval     base address
+*/
+static uint32_t fw_bank_base(uint32_t bank)
+{
+    return (0U != bank) ? FW_BANK1_BASE : FW_BANK0_BASE;
+}
+
+/*!
+    \brief      get the record of a bank
+    \param[in]  bank: 0 or 1
+    \param[out] none
+    \retval     bank record in flash
+*/
+static const fw_bank_record_struct *fw_record(uint32_t bank)
+{
+    return (const fw_bank_record_struct *)(fw_bank_base(bank) + FW_RECORD_OFFSET);
+}
+
+/*!
+    \brief      program a mark word of a bank record
+    \param[in]  word: mark word in flash
+    \param[out] none
+    \retval     none
+*/
+static void fw_mark(const uint32_t *word)
+{
+    fmc_unlock();
+    fmc_flag_clear(FW_FMC_FLAGS);
+    fmc_word_program((uint32_t)word, FW_MARK);
+    fmc_lock();
+}
+
+/*!
+    \brief      check that a bank holds a vector table
+    \param[in]  bank: 0 or 1
+    \param[out] none
+    \retval     0 when the bank cannot be booted
+*/
+static uint32_t fw_bank_bootable(uint32_t bank)
+{
+    const uint32_t *vector = (const uint32_t *)fw_bank_base(bank);
+    fw_bank_state_enum state = fw_bank_state_get(bank);
+
+    if((FW_BANK_INVALID == state) || (FW_BANK_TRIAL == state)) {
+        return 0U;
+    }
+    if(((vector[0] > FW_SRAM_BASE) && (vector[0] <= FW_SRAM_END)) ||
+            ((vector[0] > FW_TCMRAM_BASE) && (vector[0] <= FW_TCMRAM_END))) {
+        return ((vector[1] >= fw_bank_base(bank)) && (vector[1] < (fw_bank_base(bank) + FW_IMAGE_MAX_SIZE))) ? 1U : 0U;
+    }
+    return 0U;
+}
+
+/*!
+    \brief      select the boot bank in the option bytes, takes effect after a reset
+    \param[in]  bank: 0 or 1
+    \param[out] none
+    \retval     none
+*/
+static void fw_boot_select(uint32_t bank)
+{
+    uint32_t mode = (0U != bank) ? OB_BB_ENABLE : OB_BB_DISABLE;
+
+    if(mode == (FMC_OBCTL0 & FMC_OBCTL0_BB)) {
+        return;
+    }
+    ob_unlock();
+    fmc_flag_clear(FW_FMC_FLAGS);
+    ob_boot_mode_config(mode);
+    ob_start();
+    fmc_ready_wait(FMC_TIMEOUT_COUNT);
+    ob_lock();
+}
+
+/*!
+    \brief      stop the update with an error
+    \param[in]  status: error status
+    \param[out] none
+    \retval     error status
+*/
+static fw_update_status_enum fw_update_fail(fw_update_status_enum status)
+{
+    fmc_lock();
+    fwu_status = status;
+    return status;
+}
+
+/*!
+    \brief      get the bank the firmware is running from
+    \param[in]  none
+    \param[out] none
+    \retval     0 or 1
+*/
+uint32_t fw_bank_running(void)
+{
+#ifdef DUALBOOT_HOST
+    /* the simulator runs the images of both banks from one program */
+    return dualboot_host_bank();
+#else
+    /* the image is linked for its bank, BB only selects where the boot loader jumps */
+    return ((uint32_t)&fw_bank_running >= FW_BANK1_BASE) ? 1U : 0U;
+#endif /* DUALBOOT_HOST */
+}
+
+/*!
+    \brief      get the state of a bank
+    \param[in]  bank: 0 or 1
+    \param[out] none
+    \retval     fw_bank_state_enum
+*/
+fw_bank_state_enum fw_bank_state_get(uint32_t bank)
+{
+    const fw_bank_record_struct *record = fw_record(bank);
+
+    if(FW_RECORD_MAGIC != record->magic) {
+        return FW_BANK_EMPTY;
+    }
+    if(FW_MARK == record->invalid) {
+        return FW_BANK_INVALID;
+    }
+    if(FW_MARK == record->confirmed) {
+        return FW_BANK_CONFIRMED;
+    }
+    return FW_BANK_TRIAL;
+}
+
+/*!
+    \brief      count the boot attempts and finish interrupted swaps and rollbacks,
+                call first in main, before the application can hang
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void fw_boot_check(void)
+{
+    uint32_t bank = fw_bank_running();
+    uint32_t other = bank ^ 1U;
+    const fw_bank_record_struct *record = fw_record(bank);
+    uint32_t n;
+
+    switch(fw_bank_state_get(bank)) {
+    case FW_BANK_TRIAL:
+        for(n = 0U; (n < FW_MAX_BOOT_ATTEMPTS) && (FW_MARK == record->attempts[n]); n++) {
+        }
+        if(n < FW_MAX_BOOT_ATTEMPTS) {
+            /* count the boot before the image runs, a hang ends in a watchdog reset */
+            fw_mark(&record->attempts[n]);
+            fwdgt_config(FW_TRIAL_WATCHDOG_RELOAD, FWDGT_PSC_DIV64);
+            fwdgt_enable();
+            return;
+        }
+        /* out of attempts, roll back */
+        fw_mark(&record->invalid);
+        if(fw_bank_bootable(other)) {
+            fw_boot_select(other);
+            NVIC_SystemReset();
+        }
+        break;
+    case FW_BANK_INVALID:
+        /* reset between the invalid mark and the BB change */
+        if(fw_bank_bootable(other)) {
+            fw_boot_select(other);
+            NVIC_SystemReset();
+        }
+        break;
+    default:
+        /* reset between the record of the new image and the BB change */
+        if((FW_BANK_TRIAL == fw_bank_state_get(other)) && (FW_MARK != fw_record(other)->attempts[0])) {
+            fw_boot_select(other);
+            NVIC_SystemReset();
+        }
+        break;
+    }
+}
+
+/*!
+    \brief      mark the running image good, it stays the boot image from now on;
+                the watchdog started for the trial keeps running
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void fw_update_confirm(void)
+{
+    uint32_t bank = fw_bank_running();
+
+    if(FW_BANK_TRIAL == fw_bank_state_get(bank)) {
+        fw_mark(&fw_record(bank)->confirmed);
+    }
+}
+
+/*!
+    \brief      start receiving an image into the inactive bank
+    \param[in]  header: image header
+    \param[out] none
+    \retval     FW_UPDATE_BUSY or FW_UPDATE_ERR_HEADER
+*/
+fw_update_status_enum fw_update_begin(const fw_image_header_struct *header)
+{
+    fw_update_abort();
+
+    if((FW_IMAGE_MAGIC != header->magic) ||
+            (header->header_crc != crc_stream_calculate(CRC_STREAM_UNIT, header, sizeof(*header) - 4U)) ||
+            (header->bank != (fw_bank_running() ^ 1U)) ||
+            (0U == header->size) || (header->size > FW_IMAGE_MAX_SIZE) || (0U != (header->size & 3U))) {
+        fwu_status = FW_UPDATE_ERR_HEADER;
+        return fwu_status;
+    }
+
+    fwu_header = *header;
+    fwu_bank = header->bank;
+    fwu_received = 0U;
+    fwu_programmed = 0U;
+    fwu_erased = 0U;
+    fwu_next_sector = 0U;
+    fwu_record_erased = 0U;
+    fwu_verifying = 0U;
+    fwu_page_in = 0U;
+    fwu_page_out = 0U;
+    fwu_page_fill = 0U;
+    fwu_pages_full = 0U;
+
+    fmc_unlock();
+    fmc_flag_clear(FW_FMC_FLAGS);
+    fwu_status = FW_UPDATE_BUSY;
+    /* starts the erase of the record sector */
+    return fw_update_poll();
+}
+
+/*!
+    \brief      pass image data, the data which does not fit the page queue is not taken
+    \param[in]  data: image bytes following the previous call
+    \param[in]  len: number of bytes
+    \param[out] none
+    \retval     number of bytes accepted
+*/
+uint32_t fw_update_write(const uint8_t *data, uint32_t len)
+{
+    uint32_t accepted = 0U;
+    uint32_t chunk;
+
+    if(FW_UPDATE_BUSY != fwu_status) {
+        return 0U;
+    }
+    if(len > (fwu_header.size - fwu_received)) {
+        len = fwu_header.size - fwu_received;
+    }
+
+    while((accepted < len) && (fwu_pages_full < FW_PAGE_COUNT)) {
+        chunk = FW_PAGE_SIZE - fwu_page_fill;
+        if(chunk > (len - accepted)) {
+            chunk = len - accepted;
+        }
+        memcpy((uint8_t *)fwu_page[fwu_page_in] + fwu_page_fill, data + accepted, chunk);
+        fwu_page_fill += chunk;
+        fwu_received += chunk;
+        accepted += chunk;
+
+        if((FW_PAGE_SIZE == fwu_page_fill) || (fwu_received == fwu_header.size)) {
+            fwu_page_in = (fwu_page_in + 1U) % FW_PAGE_COUNT;
+            fwu_page_fill = 0U;
+            fwu_pages_full++;
+        }
+    }
+    return accepted;
+}
+
+/*!
+    \brief      advance erase, programming and verification without blocking on a sector
+                erase; erases run ahead of the data while the pages are received
+    \param[in]  none
+    \param[out] none
+    \retval     fw_update_status_enum
+*/
+fw_update_status_enum fw_update_poll(void)
+{
+    const fw_bank_record_struct *record;
+    fmc_state_enum state;
+    uint32_t base, count;
+
+    if(FW_UPDATE_BUSY != fwu_status) {
+        return fwu_status;
+    }
+    base = fw_bank_base(fwu_bank);
+
+    if(0U != fwu_erasing) {
+        state = fmc_sector_erase_state_get();
+        if(FMC_BUSY == state) {
+            return fwu_status;
+        }
+        fwu_erasing = 0U;
+        if(FMC_READY != state) {
+            return fw_update_fail(FW_UPDATE_ERR_FLASH);
+        }
+        if(0U == fwu_record_erased) {
+            fwu_record_erased = 1U;
+        } else {
+            fwu_next_sector++;
+            fwu_erased = fw_sector_offset[fwu_next_sector];
+        }
+    }
+
+    /* program one page per call, pages never cross a sector boundary */
+    if((0U != fwu_pages_full) && (fwu_programmed < fwu_erased)) {
+        count = fwu_header.size - fwu_programmed;
+        if(count > FW_PAGE_SIZE) {
+            count = FW_PAGE_SIZE;
+        }
+        state = fmc_word_burst_program(base + fwu_programmed, fwu_page[fwu_page_out], count / 4U);
+        if(FMC_READY != state) {
+            return fw_update_fail(FW_UPDATE_ERR_FLASH);
+        }
+        fwu_programmed += count;
+        fwu_page_out = (fwu_page_out + 1U) % FW_PAGE_COUNT;
+        fwu_pages_full--;
+        return fwu_status;
+    }
+
+    /* start the next erase: the record sector first, then the sectors the image covers */
+    if((0U == fwu_record_erased) || (fwu_erased < fwu_header.size)) {
+        state = fmc_sector_erase_start((0U == fwu_record_erased) ? fw_sector_number[fwu_bank][FW_RECORD_SECTOR] :
+                                       fw_sector_number[fwu_bank][fwu_next_sector]);
+        if(FMC_BUSY != state) {
+            return fw_update_fail(FW_UPDATE_ERR_FLASH);
+        }
+        fwu_erasing = 1U;
+        return fwu_status;
+    }
+
+    if(fwu_programmed < fwu_header.size) {
+        return fwu_status;
+    }
+
+    /* verify the image as it reads back from flash, the DMA feeds it to the CRC unit */
+    if(0U == fwu_verifying) {
+        fwu_verifying = 1U;
+        crc_stream_init(&fwu_crc, CRC_STREAM_UNIT);
+        if(crc_stream_update_start(&fwu_crc, (const void *)base, fwu_header.size)) {
+            return fwu_status;
+        }
+    } else if(crc_stream_poll(&fwu_crc)) {
+        return fwu_status;
+    }
+    if(fwu_header.crc != crc_stream_final(&fwu_crc)) {
+        return fw_update_fail(FW_UPDATE_ERR_CRC);
+    }
+
+    /* commit: the magic word is programmed last */
+    record = fw_record(fwu_bank);
+    if((FMC_READY != fmc_word_program((uint32_t)&record->version, fwu_header.version)) ||
+            (FMC_READY != fmc_word_program((uint32_t)&record->size, fwu_header.size)) ||
+            (FMC_READY != fmc_word_program((uint32_t)&record->crc, fwu_header.crc)) ||
+            (FMC_READY != fmc_word_program((uint32_t)&record->magic, FW_RECORD_MAGIC))) {
+        return fw_update_fail(FW_UPDATE_ERR_FLASH);
+    }
+    fmc_lock();
+
+    fw_boot_select(fwu_bank);
+    fwu_status = FW_UPDATE_DONE;
+    return fwu_status;
+}
+
+/*!
+    \brief      cancel the running update, the inactive bank is left without record
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void fw_update_abort(void)
+{
+    if(0U != fwu_erasing) {
+        /* a sector erase cannot be stopped */
+        while(FMC_BUSY == fmc_sector_erase_state_get()) {
+        }
+        fwu_erasing = 0U;
+    }
+    if(0U != fwu_verifying) {
+        while(crc_stream_poll(&fwu_crc)) {
+        }
+        fwu_verifying = 0U;
+    }
+    if(FW_UPDATE_BUSY == fwu_status) {
+        fmc_lock();
+    }
+    fwu_status = FW_UPDATE_IDLE;
+}
@@ -33,6 +33,7 @@ OF SUCH DAMAGE.
 */
 
 #include "gd32f4xx_it.h"
+#include "fw_uart.h"
 
 extern volatile uint8_t flag;
 
@@ -153,3 +154,14 @@ void EXTI10_15_IRQHandler(void)
     }
     exti_interrupt_flag_clear(EXTI_13);
 }
+
+/*!
+    \brief      this function handles USART0 interrupt request
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USART0_IRQHandler(void)
+{
+    fw_uart_irq_handler();
+}
@@ -35,10 +35,14 @@ OF SUCH DAMAGE.
 #include "gd32f4xx.h"
 #include "gd32f450z_eval.h"
 #include "gd32f4xx_it.h"
+#include "fw_update.h"
+#include "fw_uart.h"
 #include <stdio.h>
 
 volatile uint8_t flag = 0;
 
+static const char *const bank_state_name[] = {"empty", "trial", "confirmed", "invalid"};
+
 /*!
     \brief      main function
     \param[in]  none
@@ -47,6 +51,9 @@ volatile uint8_t flag = 0;
 */
 int main(void)
 {
+    /* before anything else, an unconfirmed image that hangs must still count its boots */
+    fw_boot_check();
+
 #ifndef BB_ENABLE
     nvic_vector_table_set(NVIC_VECTTAB_FLASH, 0x000000);
     /* configure user key */
@@ -71,7 +78,21 @@ int main(void)
     gd_eval_led_on(LED2);
 #endif /* BB_ENABLE */
 
+    printf("\r\n bank0: %s, bank1: %s \r\n", bank_state_name[fw_bank_state_get(0U)],
+           bank_state_name[fw_bank_state_get(1U)]);
+    /* the demo passes its self test once the peripherals are up */
+    fw_update_confirm();
+    fw_uart_init();
+
     while(1) {
+        /* feed the watchdog once a trial boot has started */
+        fwdgt_counter_reload();
+
+        /* receive an image for the other bank on EVAL_COM0, see fw_uart.h */
+        if(0U != fw_uart_poll()) {
+            continue;
+        }
+
         /* wait for user key is pressed */
         if(flag) {
             flag = 0;
@@ -0,0 +1,371 @@
+/*
+ * adc_filter_ref: runs the ADC stream filter chain on a PC.
+ *
+ * The firmware filters every ADC block with adc_filter.c: statistics of the
+ * raw samples, a CIC decimator, a Q15 FIR with decimation and a cascade of
+ * Q14 biquads, the FIR and biquads on the Cortex-M4 SIMD instructions. This
+ * tool builds the same source for the host, where the SIMD instructions are
+ * C functions with the same results bit for bit, so it prints the decimated
+ * streams the board would produce for a captured or synthetic input.
+ *
+ * With --check every channel also goes through a plain per-sample model of
+ * the chain computed with 64-bit sums (moving sums for the CIC, direct
+ * convolution for the FIR, the difference equation for the biquads), and
+ * every output is compared with the block implementation. The exit status is
+ * 1 on the first difference.
+ *
+ * The input is text with one sequence per line, one column per channel, in
+ * the order of the ADC channel list. The default chain is the one of the
+ * 07_ADC_Temperature_Vrefint demo.
+ *
+ * Build:
+ *     cc -O2 -Wall -I../../Projects/GD32F450I_EVAL/07_ADC_Temperature_Vrefint/Application/Core/Inc \
+ *        -o adc_filter_ref adc_filter_ref.c \
+ *        ../../Projects/GD32F450I_EVAL/07_ADC_Temperature_Vrefint/Application/Core/Src/adc_filter.c
+ *
+ * Example:
+ *     adc_filter_ref capture.txt
+ *     adc_filter_ref --synth 100000 --channels 3 --check
+ *     adc_filter_ref --cic 4,16,12 --fir taps.txt --decimation 4 --biquad 219,437,219,-26992,11483 capture.txt
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "adc_filter.h"
+
+#define MAX_CHANNELS    8
+#define BLOCK_SEQ       32      /* sequences per block, as the demo's DMA blocks */
+
+/* chain configuration */
+static unsigned cic_order = 3, cic_ratio = 8, cic_shift = 8;
+static int16_t fir_coeff[ADC_FIR_TAPS_MAX] = {
+    -71, -26, 177, 774, 1876, 3329, 4731, 5594, 5594, 4731, 3329, 1876, 774, 177, -26, -71
+};
+static unsigned fir_taps = 16, fir_decimation = 5;
+static int16_t iir_coeff[ADC_IIR_STAGES_MAX][5] = {
+    {219, 437, 219, -26992, 11483}
+};
+static unsigned iir_stages = 1;
+static int iir_custom = 0;
+
+/* plain model of one channel */
+typedef struct {
+    int64_t cic_sum[ADC_CIC_ORDER_MAX];
+    uint32_t cic_hist[ADC_CIC_ORDER_MAX][65536 / 16];
+    unsigned cic_pos, cic_phase;
+    int16_t fir_hist[ADC_FIR_TAPS_MAX];
+    unsigned fir_phase;
+    int32_t iir_x[ADC_IIR_STAGES_MAX][2], iir_y[ADC_IIR_STAGES_MAX][2];
+} model;
+
+static int16_t sat16(int64_t v)
+{
+    return (int16_t)((v > 32767) ? 32767 : ((v < -32768) ? -32768 : v));
+}
+
+/* returns 1 and the output when the input completes a decimated sample */
+static int model_step(model *m, uint16_t x, int16_t *out)
+{
+    int64_t v = x;
+    unsigned k, i;
+    int64_t acc;
+    int16_t y;
+
+    /* CIC as order cascaded moving sums of ratio samples */
+    for (k = 0; k < cic_order; k++) {
+        uint32_t *hist = m->cic_hist[k];
+        m->cic_sum[k] += v - hist[m->cic_pos];
+        hist[m->cic_pos] = (uint32_t)v;
+        v = m->cic_sum[k];
+    }
+    m->cic_pos = (m->cic_pos + 1) % cic_ratio;
+    if (++m->cic_phase < cic_ratio) {
+        return 0;
+    }
+    m->cic_phase = 0;
+    v >>= cic_shift;
+    y = (int16_t)((v > 32767) ? 32767 : v);
+
+    /* FIR, fir_hist[0] is the newest sample */
+    memmove(&m->fir_hist[1], &m->fir_hist[0], (ADC_FIR_TAPS_MAX - 1) * sizeof(int16_t));
+    m->fir_hist[0] = y;
+    if (++m->fir_phase < fir_decimation) {
+        return 0;
+    }
+    m->fir_phase = 0;
+    acc = 0;
+    for (i = 0; i < fir_taps; i++) {
+        acc += (int32_t)fir_coeff[i] * m->fir_hist[i];
+    }
+    y = sat16((acc + 0x4000) >> 15);
+
+    /* biquads, with a1 and a2 saturated as the firmware stores them */
+    for (k = 0; k < iir_stages; k++) {
+        const int16_t *c = iir_coeff[k];
+        int32_t na1 = sat16(-(int32_t)c[3]), na2 = sat16(-(int32_t)c[4]);
+
+        acc = (int64_t)c[0] * y + (int64_t)c[1] * m->iir_x[k][0] + (int64_t)c[2] * m->iir_x[k][1] +
+              (int64_t)na1 * m->iir_y[k][0] + (int64_t)na2 * m->iir_y[k][1];
+        m->iir_x[k][1] = m->iir_x[k][0];
+        m->iir_x[k][0] = y;
+        y = sat16((acc + 0x2000) >> 14);
+        m->iir_y[k][1] = m->iir_y[k][0];
+        m->iir_y[k][0] = y;
+    }
+
+    *out = y;
+    return 1;
+}
+
+static int parse_list(const char *text, long *values, int max)
+{
+    int n = 0;
+    char *end;
+
+    while (*text) {
+        if (n >= max) {
+            return -1;
+        }
+        errno = 0;
+        values[n++] = strtol(text, &end, 0);
+        if ((end == text) || errno) {
+            return -1;
+        }
+        text = end;
+        while ((*text == ',') || (*text == ' ') || (*text == '\t') || (*text == '\n') || (*text == '\r')) {
+            text++;
+        }
+    }
+    return n;
+}
+
+static int fir_load(const char *path)
+{
+    static char text[16384];
+    long values[ADC_FIR_TAPS_MAX];
+    size_t len;
+    int n, i;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL) {
+        /* not a file, a list of coefficients */
+        n = parse_list(path, values, ADC_FIR_TAPS_MAX);
+    } else {
+        len = fread(text, 1, sizeof(text) - 1, f);
+        fclose(f);
+        text[len] = 0;
+        n = parse_list(text, values, ADC_FIR_TAPS_MAX);
+    }
+    if (n <= 0) {
+        fprintf(stderr, "adc_filter_ref: %s: expected up to %u coefficients\n", path, ADC_FIR_TAPS_MAX);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        fir_coeff[i] = sat16(values[i]);
+    }
+    fir_taps = (unsigned)n;
+    return 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] [INPUT|-]\n"
+            "  --cic ORDER,RATIO,SHIFT   CIC decimator (default 3,8,8)\n"
+            "  --fir FILE|LIST           Q15 FIR coefficients, newest sample first\n"
+            "  --decimation N            FIR decimation (default 5)\n"
+            "  --biquad B0,B1,B2,A1,A2   Q14 biquad section, repeat for a cascade\n"
+            "  --no-biquad               no biquad sections\n"
+            "  --channels N              channels of --synth (default 3)\n"
+            "  --synth N                 use N sequences of a noisy ramp and sine instead of INPUT\n"
+            "  --check                   compare with the plain model, print nothing else\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    static adc_chain_struct chain[MAX_CHANNELS];
+    static model ref[MAX_CHANNELS];
+    static uint16_t block[BLOCK_SEQ * MAX_CHANNELS];
+    const char *input = "-";
+    unsigned channels = 0, synth_channels = 3, ch, seq = 0, fill = 0;
+    unsigned long synth = 0, outputs = 0, index[MAX_CHANNELS] = {0};
+    int check = 0, i, done = 0, started = 0;
+    FILE *f = NULL;
+    char line[1024];
+    long values[MAX_CHANNELS * 2];
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--cic") && (i + 1 < argc)) {
+            if (parse_list(argv[++i], values, 3) != 3) {
+                usage(argv[0]);
+                return 2;
+            }
+            cic_order = (unsigned)values[0];
+            cic_ratio = (unsigned)values[1];
+            cic_shift = (unsigned)values[2];
+        } else if (!strcmp(argv[i], "--fir") && (i + 1 < argc)) {
+            if (fir_load(argv[++i])) {
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "--decimation") && (i + 1 < argc)) {
+            fir_decimation = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--biquad") && (i + 1 < argc)) {
+            if (!iir_custom) {
+                iir_custom = 1;
+                iir_stages = 0;
+            }
+            if ((iir_stages >= ADC_IIR_STAGES_MAX) || (parse_list(argv[++i], values, 5) != 5)) {
+                usage(argv[0]);
+                return 2;
+            }
+            for (int k = 0; k < 5; k++) {
+                iir_coeff[iir_stages][k] = sat16(values[k]);
+            }
+            iir_stages++;
+        } else if (!strcmp(argv[i], "--no-biquad")) {
+            iir_custom = 1;
+            iir_stages = 0;
+        } else if (!strcmp(argv[i], "--channels") && (i + 1 < argc)) {
+            synth_channels = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--synth") && (i + 1 < argc)) {
+            synth = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--check")) {
+            check = 1;
+        } else if ((argv[i][0] != '-') || !strcmp(argv[i], "-")) {
+            input = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (cic_ratio > (sizeof(ref[0].cic_hist[0]) / sizeof(uint32_t))) {
+        fprintf(stderr, "adc_filter_ref: CIC ratio too large\n");
+        return 2;
+    }
+
+    if (synth) {
+        channels = synth_channels;
+        if ((channels == 0) || (channels > MAX_CHANNELS)) {
+            fprintf(stderr, "adc_filter_ref: 1 to %d channels\n", MAX_CHANNELS);
+            return 2;
+        }
+        srand(1);
+    } else if (!strcmp(input, "-")) {
+        f = stdin;
+    } else if ((f = fopen(input, "r")) == NULL) {
+        fprintf(stderr, "adc_filter_ref: %s: %s\n", input, strerror(errno));
+        return 1;
+    }
+
+    while (!done) {
+        /* read one sequence */
+        if (synth) {
+            if (seq >= synth) {
+                done = 1;
+            } else {
+                for (ch = 0; ch < channels; ch++) {
+                    /* full scale steps, a slow ramp and noise exercise saturation and rounding */
+                    long v = (long)((seq * (ch + 1) * 7) % 16384) + (rand() % 64) - 32;
+                    if ((seq / 5000) % 2) {
+                        v = (ch & 1) ? 65535 : 0;
+                    }
+                    block[fill * channels + ch] = (uint16_t)((v < 0) ? 0 : ((v > 65535) ? 65535 : v));
+                }
+                seq++;
+                fill++;
+            }
+        } else if (fgets(line, sizeof(line), f) == NULL) {
+            done = 1;
+        } else {
+            int n = parse_list(line, values, MAX_CHANNELS);
+
+            if (n <= 0) {
+                continue;
+            }
+            if (channels == 0) {
+                channels = (unsigned)n;
+            }
+            if ((unsigned)n != channels) {
+                fprintf(stderr, "adc_filter_ref: line with %d instead of %u columns\n", n, channels);
+                return 1;
+            }
+            for (ch = 0; ch < channels; ch++) {
+                block[fill * channels + ch] = (uint16_t)values[ch];
+            }
+            fill++;
+        }
+
+        if (!started && fill) {
+            /* first sequence, the channel count is known now */
+            started = 1;
+            for (ch = 0; ch < channels; ch++) {
+                if ((adc_cic_init(&chain[ch].cic, (uint8_t)cic_order, (uint16_t)cic_ratio, (uint8_t)cic_shift) != ADC_FILTER_OK) ||
+                        (adc_fir_init(&chain[ch].fir, fir_coeff, (uint16_t)fir_taps, (uint16_t)fir_decimation) != ADC_FILTER_OK) ||
+                        (adc_iir_init(&chain[ch].iir, (const int16_t (*)[5])iir_coeff, (uint8_t)iir_stages) != ADC_FILTER_OK)) {
+                    fprintf(stderr, "adc_filter_ref: chain configuration out of range\n");
+                    return 2;
+                }
+                adc_stats_reset(&chain[ch].stats);
+            }
+        }
+
+        /* process full blocks, and what is left at the end */
+        if ((fill == BLOCK_SEQ) || (done && fill)) {
+            for (ch = 0; ch < channels; ch++) {
+                int16_t out[ADC_CHAIN_OUT_SIZE];
+                uint32_t n, k, s;
+
+                adc_chain_process(&chain[ch], &block[ch], channels, fill);
+                n = adc_chain_read(&chain[ch], out, ADC_CHAIN_OUT_SIZE);
+
+                if (check) {
+                    /* replay the block through the plain model */
+                    k = 0;
+                    for (s = 0; s < fill; s++) {
+                        int16_t y;
+
+                        if (model_step(&ref[ch], block[s * channels + ch], &y)) {
+                            if ((k >= n) || (out[k] != y)) {
+                                printf("channel %u output %lu: chain %d, model %d\n", ch, index[ch] + k,
+                                       (k < n) ? out[k] : 0, y);
+                                return 1;
+                            }
+                            k++;
+                        }
+                    }
+                    if (k != n) {
+                        printf("channel %u: chain gave %u outputs, model %u\n", ch, (unsigned)n, (unsigned)k);
+                        return 1;
+                    }
+                } else {
+                    for (k = 0; k < n; k++) {
+                        printf("%u %lu %d\n", ch, index[ch] + k, out[k]);
+                    }
+                }
+                index[ch] += n;
+                outputs += n;
+            }
+            fill = 0;
+        }
+    }
+
+    if (f && (f != stdin)) {
+        fclose(f);
+    }
+
+    for (ch = 0; ch < channels; ch++) {
+        adc_stats_result_struct r;
+
+        adc_stats_result(&chain[ch].stats, &r);
+        printf("# channel %u: %lu samples, min %u, max %u, mean %.4f, noise %.4f LSB rms, %lu outputs\n",
+               ch, (unsigned long)r.count, r.min, r.max, r.mean / 16.0, r.rms / 16.0, index[ch]);
+    }
+    if (check) {
+        printf("# %lu outputs identical to the model\n", outputs);
+    }
+    return 0;
+}
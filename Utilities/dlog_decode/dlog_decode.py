@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+dlog_decode: formats the binary DLOG records of a USART log on the host.
+
+DLOG() (dlog.h) does not format text on the target. It queues a record with
+a 16-bit string ID, the DWT cycle counter and the raw 32-bit arguments. The
+format strings are kept in the non-loaded .dlog_fmt section of the ELF file,
+and the ID is the offset of the string in that section. This tool reads the
+ELF file, splits the USART stream into ordinary printf text and records, and
+prints the records as text lines with a timestamp.
+
+Example:
+    dlog_decode.py build/Application.elf capture.bin
+    dlog_decode.py build/Application.elf /dev/ttyUSB0 --baud 115200
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = 0x1E
+MAX_ARGS = 6
+HEADER_SIZE = 8
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+SPEC_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcspn%])")
+
+
+class Elf:
+    """Minimal reader for 32-bit little endian ELF files."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError("%s: not a 32-bit little endian ELF file" % path)
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+        headers = [struct.unpack_from("<10I", self.data, shoff + i * shentsize) for i in range(shnum)]
+        strtab = headers[shstrndx]
+        self.sections = []
+        for h in headers:
+            name_end = self.data.index(b"\0", strtab[4] + h[0])
+            name = self.data[strtab[4] + h[0]:name_end].decode()
+            # name, type, flags, address, file offset, size
+            self.sections.append((name, h[1], h[2], h[3], h[4], h[5]))
+
+    def section(self, name):
+        for s in self.sections:
+            if s[0] == name:
+                return self.data[s[4]:s[4] + s[5]]
+        return None
+
+    def string_at(self, address):
+        """Read a C string from a loaded section, used for %s arguments."""
+        for name, typ, flags, addr, offset, size in self.sections:
+            if typ == SHT_PROGBITS and (flags & SHF_ALLOC) and addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode("latin-1")
+        return None
+
+
+def load_formats(elf):
+    fmt = elf.section(".dlog_fmt")
+    if fmt is None:
+        raise ValueError("no .dlog_fmt section, is the firmware built with DLOG?")
+    formats = {}
+    start = 0
+    while start < len(fmt):
+        end = fmt.find(b"\0", start)
+        if end < 0:
+            end = len(fmt)
+        if end > start:
+            formats[start] = fmt[start:end].decode("latin-1")
+        start = end + 1
+    return formats
+
+
+def format_record(fmt, args, elf):
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def repl(m):
+        flags, width, prec, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(struct.unpack("<i", struct.pack("<I", take()))[0])
+        if prec == "*":
+            prec = str(take())
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        value = take()
+        if conv in "di":
+            return (spec + "d") % struct.unpack("<i", struct.pack("<I", value))[0]
+        if conv in "ouxX":
+            return (spec + conv.replace("u", "d")) % value
+        if conv in "eEfFgGaA":
+            fval = struct.unpack("<f", struct.pack("<I", value))[0]
+            return (spec + conv.replace("a", "e").replace("A", "E")) % fval
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "s":
+            text = elf.string_at(value)
+            return (spec + "s") % (text if text is not None else "<0x%08x>" % value)
+        if conv == "p":
+            return "0x%08x" % value
+        return m.group(0)
+
+    return SPEC_RE.sub(repl, fmt).rstrip("\r\n")
+
+
+class Decoder:
+    def __init__(self, elf, cpu_hz, out):
+        self.elf = elf
+        self.formats = load_formats(elf)
+        self.cpu_hz = cpu_hz
+        self.out = out
+        self.buf = bytearray()
+        self.at_line_start = True
+        self.last_cycles = None
+        self.time = 0
+
+    def timestamp(self, cycles):
+        if self.last_cycles is not None:
+            delta = (cycles - self.last_cycles) & 0xFFFFFFFF
+            # records from nested interrupts may carry a slightly older stamp
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            self.time += delta
+        self.last_cycles = cycles
+        return self.time / float(self.cpu_hz)
+
+    def text(self, data):
+        if data:
+            self.out.write(data.decode("latin-1"))
+            self.at_line_start = data.endswith(b"\n")
+
+    def record(self, line):
+        if not self.at_line_start:
+            self.out.write("\n")
+        self.out.write(line + "\n")
+        self.at_line_start = True
+
+    def feed(self, data, final=False):
+        self.buf += data
+        buf = self.buf
+        i = 0
+        while i < len(buf):
+            sync = buf.find(bytes([SYNC]), i)
+            if sync < 0:
+                self.text(bytes(buf[i:]))
+                i = len(buf)
+                break
+            self.text(bytes(buf[i:sync]))
+            i = sync
+            if len(buf) - i < HEADER_SIZE:
+                if final:
+                    self.text(bytes(buf[i:]))
+                    i = len(buf)
+                break
+            nargs = buf[i + 1]
+            sid, cycles = struct.unpack_from("<HI", buf, i + 2)
+            if nargs > MAX_ARGS or sid not in self.formats:
+                # not a record, pass the byte through and resynchronize
+                self.text(bytes(buf[i:i + 1]))
+                i += 1
+                continue
+            size = HEADER_SIZE + 4 * nargs
+            if len(buf) - i < size:
+                if final:
+                    self.text(bytes(buf[i:]))
+                    i = len(buf)
+                break
+            args = struct.unpack_from("<%dI" % nargs, buf, i + HEADER_SIZE)
+            t = self.timestamp(cycles)
+            self.record("[%12.6f] %s" % (t, format_record(self.formats[sid], args, self.elf)))
+            i += size
+        del self.buf[:i]
+        self.out.flush()
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer
+    f = open(path, "rb", buffering=0)
+    if baud and os.isatty(f.fileno()):
+        import termios
+        import tty
+        tty.setraw(f.fileno())
+        attrs = termios.tcgetattr(f.fileno())
+        speed = getattr(termios, "B%d" % baud)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(f.fileno(), termios.TCSANOW, attrs)
+    return f
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("elf", help="firmware ELF file built with DLOG")
+    parser.add_argument("input", nargs="?", default="-",
+                        help="captured USART output or serial device (default: stdin)")
+    parser.add_argument("--baud", type=int, help="set the serial device to this baud rate")
+    parser.add_argument("--cpu-hz", type=float, default=200e6,
+                        help="core clock, the record timestamps count core cycles (default 200 MHz)")
+    args = parser.parse_args()
+
+    try:
+        decoder = Decoder(Elf(args.elf), args.cpu_hz, sys.stdout)
+    except (OSError, ValueError) as e:
+        sys.exit("dlog_decode: %s" % e)
+
+    f = open_input(args.input, args.baud)
+    try:
+        while True:
+            data = f.read(4096) if f is not sys.stdin.buffer else f.read1(4096)
+            if not data:
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+    decoder.feed(b"", final=True)
+
+
+if __name__ == "__main__":
+    main()
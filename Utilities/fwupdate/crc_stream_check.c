@@ -0,0 +1,306 @@
+/*
+ * crc_stream_check: checks the software CRC path of crc_stream.c on a PC.
+ *
+ * The 21_FMC_DualBoot demo computes the checksum of the CRC unit, the
+ * CRC-32/MPEG-2 and the reflected CRC-32 of zlib with crc_stream.c, from
+ * chunks of any length and alignment. The CRC unit and the DMA are only used
+ * for whole words; the software path gives the same results and is what the
+ * other paths are measured against. This tool builds the source for the host
+ * with the software path only.
+ *
+ * First the catalogue check values ("123456789" gives 0x0376E6E7 for
+ * CRC-32/MPEG-2 and 0xCBF43926 for CRC-32) and the values of the CRC unit
+ * must come out, which takes little endian words MSB first and the bytes of
+ * an incomplete last word one by one. Then random buffers are passed in
+ * random chunks, starting at every alignment, with chunks of 0 to 5 bytes
+ * mixed with long ones, through crc_stream_update() and crc_stream_sw_update()
+ * alternately, and crc_stream_final() is taken in the middle of the stream as
+ * well as at its end. Every result is compared with a bitwise model of the
+ * variant. The exit status is 1 on the first difference.
+ *
+ * Last the throughput of crc_stream_calculate() is measured for every variant
+ * with an aligned and an unaligned buffer, next to the bitwise model.
+ *
+ * Build:
+ *     cc -O2 -Wall -DDUALBOOT_HOST -DCRC_STREAM_USE_HW=0 -I. \
+ *        -I../../Projects/GD32F450Z_EVAL/21_FMC_DualBoot/Application/Core/Inc \
+ *        -o crc_stream_check crc_stream_check.c \
+ *        ../../Projects/GD32F450Z_EVAL/21_FMC_DualBoot/Application/Core/Src/crc_stream.c
+ *
+ * Example:
+ *     crc_stream_check
+ *     crc_stream_check --runs 1000000 --seed 7 --bench 0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc_stream.h"
+
+#define MAX_LEN         70000U          /* longest random buffer, longer than a DMA piece */
+#define MAX_CHUNKS      64
+
+typedef struct {
+    crc_stream_type_enum type;
+    const char *data;
+    uint32_t value;
+} check_value_struct;
+
+static const char *const type_names[] = {"CRC unit", "CRC-32/MPEG-2", "CRC-32"};
+
+static const check_value_struct check_values[] = {
+    {CRC_STREAM_MPEG2, "123456789", 0x0376E6E7U},
+    {CRC_STREAM_CRC32, "123456789", 0xCBF43926U},
+    {CRC_STREAM_UNIT, "123456789", 0xBF99399CU},
+    /* two words are the bytes of each word reversed in MPEG-2 order */
+    {CRC_STREAM_UNIT, "12345678", 0xFEFC54F9U},
+    {CRC_STREAM_MPEG2, "43218765", 0xFEFC54F9U},
+    {CRC_STREAM_MPEG2, "The quick brown fox jumps over the lazy dog", 0xBA62119EU},
+    {CRC_STREAM_CRC32, "The quick brown fox jumps over the lazy dog", 0x414FA339U},
+    {CRC_STREAM_UNIT, "The quick brown fox jumps over the lazy dog", 0x7AAFFB09U},
+    {CRC_STREAM_MPEG2, "", 0xFFFFFFFFU},
+    {CRC_STREAM_CRC32, "", 0x00000000U},
+    {CRC_STREAM_UNIT, "", 0xFFFFFFFFU}
+};
+
+static unsigned long long rng_state = 88172645463325252ULL;
+
+static unsigned rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned)(rng_state >> 16);
+}
+
+/* bit by bit, MSB first */
+static uint32_t model_msb(uint32_t reg, const uint8_t *p, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        reg ^= (uint32_t)p[i] << 24;
+        for (int b = 0; b < 8; b++) {
+            reg = (reg & 0x80000000U) ? (reg << 1) ^ 0x04C11DB7U : reg << 1;
+        }
+    }
+    return reg;
+}
+
+/* bit by bit on the reflected polynomial */
+static uint32_t model_crc32(const uint8_t *p, uint32_t len)
+{
+    uint32_t reg = 0xFFFFFFFFU;
+
+    for (uint32_t i = 0; i < len; i++) {
+        reg ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            reg = (reg & 1U) ? (reg >> 1) ^ 0xEDB88320U : reg >> 1;
+        }
+    }
+    return ~reg;
+}
+
+/* CRC_DATA takes little endian words, so a word is its four bytes backwards */
+static uint32_t model_unit(const uint8_t *p, uint32_t len)
+{
+    uint32_t reg = 0xFFFFFFFFU;
+    uint32_t i;
+
+    for (i = 0; i + 4 <= len; i += 4) {
+        uint8_t w[4] = {p[i + 3], p[i + 2], p[i + 1], p[i]};
+
+        reg = model_msb(reg, w, 4);
+    }
+    return model_msb(reg, p + i, len - i);
+}
+
+static uint32_t model(crc_stream_type_enum type, const uint8_t *p, uint32_t len)
+{
+    if (type == CRC_STREAM_CRC32) {
+        return model_crc32(p, len);
+    }
+    if (type == CRC_STREAM_MPEG2) {
+        return model_msb(0xFFFFFFFFU, p, len);
+    }
+    return model_unit(p, len);
+}
+
+static int check_values_run(void)
+{
+    for (size_t i = 0; i < sizeof(check_values) / sizeof(check_values[0]); i++) {
+        const check_value_struct *c = &check_values[i];
+        uint32_t len = (uint32_t)strlen(c->data);
+        uint32_t value = crc_stream_calculate(c->type, c->data, len);
+        uint32_t bytewise, ref = model(c->type, (const uint8_t *)c->data, len);
+        crc_stream_struct ctx;
+
+        crc_stream_init(&ctx, c->type);
+        for (uint32_t n = 0; n < len; n++) {
+            crc_stream_sw_update(&ctx, c->data + n, 1);
+        }
+        bytewise = crc_stream_final(&ctx);
+        if ((value != c->value) || (bytewise != c->value) || (ref != c->value)) {
+            fprintf(stderr, "crc_stream_check: %s of \"%s\": 0x%08X, byte by byte 0x%08X, model 0x%08X, expected 0x%08X\n",
+                    type_names[c->type], c->data, (unsigned)value, (unsigned)bytewise, (unsigned)ref,
+                    (unsigned)c->value);
+            return -1;
+        }
+    }
+    printf("%u check values match\n", (unsigned)(sizeof(check_values) / sizeof(check_values[0])));
+    return 0;
+}
+
+static uint32_t chunk_len(uint32_t left)
+{
+    uint32_t r = rng() % 8;
+
+    if (r < 6) {
+        /* 0 to 5 bytes: partial words at both ends of a chunk */
+        r = rng() % 6;
+    } else {
+        r = rng() % (left + 1);
+    }
+    return (r > left) ? left : r;
+}
+
+static int random_run(unsigned long runs, uint8_t *buf)
+{
+    unsigned long bytes = 0;
+
+    for (unsigned long r = 0; r < runs; r++) {
+        crc_stream_type_enum type = (crc_stream_type_enum)(r % 3);
+        uint32_t head = rng() % 4, len = (rng() % 16 == 0) ? rng() % MAX_LEN : rng() % 600;
+        uint32_t split = (len != 0) ? rng() % (len + 1) : 0, done = 0, chunks = 0;
+        const uint8_t *p = buf + head;
+        crc_stream_struct ctx;
+        uint32_t value, ref;
+
+        for (uint32_t i = 0; i < len; i++) {
+            buf[head + i] = (uint8_t)rng();
+        }
+
+        crc_stream_init(&ctx, type);
+        while (done < len) {
+            uint32_t n = (chunks < MAX_CHUNKS) ? chunk_len(len - done) : len - done;
+
+            /* the result in the middle of the stream, which then goes on */
+            if ((done <= split) && (done + n > split)) {
+                n = split - done;
+            }
+            if (chunks & 1) {
+                crc_stream_sw_update(&ctx, p + done, n);
+            } else {
+                crc_stream_update(&ctx, p + done, n);
+            }
+            done += n;
+            chunks++;
+            if (done == split) {
+                value = crc_stream_final(&ctx);
+                ref = model(type, p, split);
+                if (value != ref) {
+                    fprintf(stderr, "crc_stream_check: %s of %u bytes at offset %u, first %u bytes: 0x%08X, model 0x%08X\n",
+                            type_names[type], (unsigned)len, (unsigned)head, (unsigned)split, (unsigned)value,
+                            (unsigned)ref);
+                    return -1;
+                }
+                split = len + 1;
+            }
+        }
+        value = crc_stream_final(&ctx);
+        ref = model(type, p, len);
+        if (value != ref) {
+            fprintf(stderr, "crc_stream_check: %s of %u bytes at offset %u in %u chunks: 0x%08X, model 0x%08X\n",
+                    type_names[type], (unsigned)len, (unsigned)head, (unsigned)chunks, (unsigned)value, (unsigned)ref);
+            return -1;
+        }
+        bytes += len;
+    }
+    printf("%lu random streams of %lu bytes in random chunks match the model\n", runs, bytes);
+    return 0;
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench(uint32_t mb, uint8_t *buf)
+{
+    uint32_t size = mb * 1024U * 1024U, model_size = size / 16U;
+    volatile uint32_t sink = 0;
+
+    for (uint32_t i = 0; i < size + 4; i++) {
+        buf[i] = (uint8_t)rng();
+    }
+    printf("throughput of crc_stream_calculate() on %u MB, MB/s:\n", (unsigned)mb);
+    printf("  %-14s %10s %10s %10s\n", "", "aligned", "offset 1", "model");
+    for (int t = 0; t < 3; t++) {
+        double mbs[3];
+
+        for (int k = 0; k < 3; k++) {
+            uint32_t n = (k == 2) ? model_size : size;
+            double t0 = seconds();
+
+            if (k == 2) {
+                sink ^= model((crc_stream_type_enum)t, buf, n);
+            } else {
+                sink ^= crc_stream_calculate((crc_stream_type_enum)t, buf + k, n);
+            }
+            mbs[k] = (double)n / (seconds() - t0) / 1e6;
+        }
+        printf("  %-14s %10.0f %10.0f %10.0f\n", type_names[t], mbs[0], mbs[1], mbs[2]);
+    }
+    (void)sink;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [options]\n"
+            "  --runs N      random streams (100000)\n"
+            "  --bench MB    buffer size for the throughput, 0 to skip (16)\n"
+            "  --seed S      random seed\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long runs = 100000;
+    uint32_t mb = 16;
+    uint8_t *buf;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--runs") && (i + 1 < argc)) {
+            runs = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--bench") && (i + 1 < argc)) {
+            mb = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && (i + 1 < argc)) {
+            rng_state = strtoull(argv[++i], NULL, 0) | 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (mb > 1024) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* word aligned, the runs start at every offset from it */
+    buf = aligned_alloc(4, ((mb * 1024U * 1024U > MAX_LEN) ? mb * 1024U * 1024U : MAX_LEN) + 8);
+    if (buf == NULL) {
+        fprintf(stderr, "crc_stream_check: out of memory\n");
+        return 2;
+    }
+    if ((check_values_run() != 0) || (random_run(runs, buf) != 0)) {
+        return 1;
+    }
+    if (mb != 0) {
+        bench(mb, buf);
+    }
+    free(buf);
+    return 0;
+}
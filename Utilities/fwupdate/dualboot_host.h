@@ -0,0 +1,115 @@
+/*
+ * dualboot_host.h: the part of the GD32F4xx firmware library and CMSIS that
+ * fw_update.c and crc_stream.c of the 21_FMC_DualBoot demo use, for building
+ * them on a PC with -DDUALBOOT_HOST -DCRC_STREAM_USE_HW=0.
+ *
+ * The Cortex-M4 bit instructions are plain C here. The flash controller, the
+ * option bytes, the watchdog and the reset are implemented by fw_update_sim.c.
+ */
+
+#ifndef DUALBOOT_HOST_H
+#define DUALBOOT_HOST_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus;
+typedef enum {ERROR = 0, SUCCESS = !ERROR} ErrStatus;
+
+static inline uint32_t __REV(uint32_t value)
+{
+    return __builtin_bswap32(value);
+}
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+    value = ((value >> 1) & 0x55555555U) | ((value & 0x55555555U) << 1);
+    value = ((value >> 2) & 0x33333333U) | ((value & 0x33333333U) << 2);
+    value = ((value >> 4) & 0x0F0F0F0FU) | ((value & 0x0F0F0F0FU) << 4);
+    return __builtin_bswap32(value);
+}
+
+static inline uint32_t __UNALIGNED_UINT32_READ(const void *addr)
+{
+    uint32_t value;
+
+    memcpy(&value, addr, sizeof(value));
+    return value;
+}
+
+/* flash controller */
+typedef enum {
+    FMC_READY = 0,
+    FMC_BUSY,
+    FMC_RDDERR,
+    FMC_PGSERR,
+    FMC_PGMERR,
+    FMC_WPERR,
+    FMC_OPERR,
+    FMC_TOERR
+} fmc_state_enum;
+
+#define FMC_FLAG_END                0x01U
+#define FMC_FLAG_OPERR              0x02U
+#define FMC_FLAG_WPERR              0x10U
+#define FMC_FLAG_PGMERR             0x40U
+#define FMC_FLAG_PGSERR             0x80U
+#define FMC_TIMEOUT_COUNT           0x4FFFFFFFU
+
+/* the sector field of FMC_CTL, sectors 12 to 23 of bank1 are numbered from 16 */
+#define CTL_SN(regval)              ((uint32_t)(regval) << 3)
+#define CTL_SECTOR_NUMBER_0         CTL_SN(0)
+#define CTL_SECTOR_NUMBER_1         CTL_SN(1)
+#define CTL_SECTOR_NUMBER_2         CTL_SN(2)
+#define CTL_SECTOR_NUMBER_3         CTL_SN(3)
+#define CTL_SECTOR_NUMBER_4         CTL_SN(4)
+#define CTL_SECTOR_NUMBER_5         CTL_SN(5)
+#define CTL_SECTOR_NUMBER_6         CTL_SN(6)
+#define CTL_SECTOR_NUMBER_7         CTL_SN(7)
+#define CTL_SECTOR_NUMBER_8         CTL_SN(8)
+#define CTL_SECTOR_NUMBER_9         CTL_SN(9)
+#define CTL_SECTOR_NUMBER_10        CTL_SN(10)
+#define CTL_SECTOR_NUMBER_11        CTL_SN(11)
+#define CTL_SECTOR_NUMBER_12        CTL_SN(16)
+#define CTL_SECTOR_NUMBER_13        CTL_SN(17)
+#define CTL_SECTOR_NUMBER_14        CTL_SN(18)
+#define CTL_SECTOR_NUMBER_15        CTL_SN(19)
+#define CTL_SECTOR_NUMBER_16        CTL_SN(20)
+#define CTL_SECTOR_NUMBER_17        CTL_SN(21)
+#define CTL_SECTOR_NUMBER_18        CTL_SN(22)
+#define CTL_SECTOR_NUMBER_19        CTL_SN(23)
+#define CTL_SECTOR_NUMBER_20        CTL_SN(24)
+#define CTL_SECTOR_NUMBER_21        CTL_SN(25)
+#define CTL_SECTOR_NUMBER_22        CTL_SN(26)
+#define CTL_SECTOR_NUMBER_23        CTL_SN(27)
+
+/* option bytes, FMC_OBCTL0 holds the value ob_start() programs */
+#define FMC_OBCTL0                  (dualboot_host_obctl0)
+#define FMC_OBCTL0_BB               0x10U
+#define OB_BB_DISABLE               0U
+#define OB_BB_ENABLE                FMC_OBCTL0_BB
+
+#define FWDGT_PSC_DIV64             4U
+
+extern volatile uint32_t dualboot_host_obctl0;
+
+/* bank the simulated boot loader started */
+uint32_t dualboot_host_bank(void);
+
+void fmc_unlock(void);
+void fmc_lock(void);
+void fmc_flag_clear(uint32_t fmc_flag);
+fmc_state_enum fmc_ready_wait(uint32_t timeout);
+fmc_state_enum fmc_word_program(uint32_t address, uint32_t data);
+fmc_state_enum fmc_word_burst_program(uint32_t address, const uint32_t *data, uint32_t count);
+fmc_state_enum fmc_sector_erase_start(uint32_t fmc_sector);
+fmc_state_enum fmc_sector_erase_state_get(void);
+void ob_unlock(void);
+void ob_lock(void);
+void ob_boot_mode_config(uint32_t boot_mode);
+void ob_start(void);
+ErrStatus fwdgt_config(uint16_t reload_value, uint8_t prescaler_div);
+void fwdgt_enable(void);
+void NVIC_SystemReset(void) __attribute__((noreturn));
+
+#endif /* DUALBOOT_HOST_H */
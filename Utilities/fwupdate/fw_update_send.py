@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+fw_update_send: sends a firmware image to the A/B update engine of the FMC dual boot demo.
+
+The image (.bin of the Application target) is padded to whole words and sent
+behind a 32-byte header with the checksum the CRC unit of the target computes:
+CRC-32/MPEG-2 over the little endian words. The protocol is the one of
+fw_uart.h: 'U' and the header, then blocks of 256 bytes, each acknowledged
+with 'K'; 'D' reports the verified image, 'E' and a status byte an error.
+
+Example:
+    fw_update_send.py Application.bin --bank 1 --port /dev/ttyUSB0
+    fw_update_send.py Application.bin --bank 1 --output image.fw
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+IMAGE_MAGIC = 0x57464447
+BLOCK_SIZE = 256
+IMAGE_MAX_SIZE = 0xE0000
+
+START, ACK, ERROR, DONE = b"U", b"K", b"E", b"D"
+
+STATUS_NAMES = {2: "done", 3: "bad header or wrong bank", 4: "flash erase/program error", 5: "CRC mismatch"}
+
+
+def crc32_mpeg2(words, crc=0xFFFFFFFF):
+    """CRC unit of the GD32F4xx: poly 0x04C11DB7, no reflection, no final XOR, one word at a time."""
+    for w in words:
+        crc ^= w
+        for _ in range(32):
+            crc = ((crc << 1) ^ 0x04C11DB7) & 0xFFFFFFFF if crc & 0x80000000 else (crc << 1) & 0xFFFFFFFF
+    return crc
+
+
+def build_header(image, version, bank):
+    words = struct.unpack("<%dI" % (len(image) // 4), image)
+    fields = [IMAGE_MAGIC, version, bank, len(image), crc32_mpeg2(words), 0, 0]
+    return struct.pack("<8I", *(fields + [crc32_mpeg2(fields)]))
+
+
+def open_port(path, baud):
+    import termios
+    import tty
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = getattr(termios, "B%d" % baud)
+    # VMIN 0, VTIME 1: reads return after 100 ms without data
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 1
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+def wait_reply(fd, timeout):
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        c = os.read(fd, 1)
+        if c in (ACK, DONE):
+            return c
+        if c == ERROR:
+            status = b""
+            while not status and time.monotonic() < end:
+                status = os.read(fd, 1)
+            code = status[0] if status else -1
+            raise RuntimeError("target error %d (%s)" % (code, STATUS_NAMES.get(code, "unknown")))
+    raise RuntimeError("no reply from the target")
+
+
+def send(fd, header, image, timeout):
+    os.write(fd, START + header)
+    wait_reply(fd, timeout)
+    start = time.monotonic()
+    for offset in range(0, len(image), BLOCK_SIZE):
+        os.write(fd, image[offset:offset + BLOCK_SIZE])
+        last = offset + BLOCK_SIZE >= len(image)
+        # the last block is answered after the CRC check, the erases may still run
+        reply = wait_reply(fd, timeout * 10 if last else timeout)
+        if last and reply != DONE:
+            reply = wait_reply(fd, timeout * 10)
+        sys.stdout.write("\r%7d / %d bytes" % (min(offset + BLOCK_SIZE, len(image)), len(image)))
+        sys.stdout.flush()
+    elapsed = time.monotonic() - start
+    print("\nimage verified in %.1f s (%.1f KB/s), the target boots it now" % (
+        elapsed, len(image) / 1024.0 / elapsed))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("image", help="binary image linked for the target bank")
+    parser.add_argument("--bank", type=int, choices=(0, 1), required=True,
+                        help="bank the image is linked for, must be the one not running")
+    parser.add_argument("--version", type=lambda v: int(v, 0), default=0, help="version stored in the bank record")
+    parser.add_argument("--port", help="serial device of EVAL_COM0")
+    parser.add_argument("--baud", type=int, default=115200, help="baud rate (default 115200)")
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for a reply (default 5)")
+    parser.add_argument("--output", metavar="FILE", help="write header and image to FILE for other transports")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    image += b"\xff" * (-len(image) % 4)
+    if not image or len(image) > IMAGE_MAX_SIZE:
+        sys.exit("fw_update_send: image size %d out of range" % len(image))
+    header = build_header(image, args.version, args.bank)
+    print("image %d bytes, crc 0x%08x" % (len(image), struct.unpack_from("<I", header, 16)[0]))
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(header + image)
+    if args.port:
+        fd = open_port(args.port, args.baud)
+        try:
+            send(fd, header, image, args.timeout)
+        except RuntimeError as e:
+            sys.exit("\nfw_update_send: %s" % e)
+        finally:
+            os.close(fd)
+    elif not args.output:
+        sys.exit("fw_update_send: give --port or --output")
+
+
+if __name__ == "__main__":
+    main()
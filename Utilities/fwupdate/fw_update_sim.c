@@ -0,0 +1,636 @@
+/*
+ * fw_update_sim: power failure test of the dual bank firmware update on a PC.
+ *
+ * The 21_FMC_DualBoot demo writes a new image into the bank it does not run
+ * from, checks it and only then selects it with the BB option bit; the image
+ * boots in trial state and falls back to the previous bank unless it confirms
+ * itself (fw_update.c). This tool builds the same source for the host with
+ * DUALBOOT_HOST, the CRC in software (bit exact with the CRC unit), and runs
+ * it on a model of the 2MB flash, the option bytes, the watchdog and the boot
+ * loader, which starts bank1 when BB is set unless bank1 is void.
+ *
+ * A run starts from bank0 holding the first image as the debugger leaves it
+ * and updates through a chain of images, alternating between the banks. Every
+ * image confirms itself after booting and sends the next one, the last image
+ * ends the run. With --bad the last image hangs before it confirms, so the run
+ * ends when the previous image is back with the last one marked invalid.
+ *
+ * Every boot runs in a new process, so RAM starts over as after a reset, while
+ * the flash and the option bytes stay in shared memory at their addresses. The
+ * power fails right after one chosen program, sector erase or option byte
+ * write; with --torn it fails during the operation instead, leaving a sector
+ * partly erased, a page partly programmed or a word with only some of its bits
+ * programmed. A run without failure counts the operations, then one run fails
+ * the power at each of them in turn. With --random the power fails at random
+ * operations, several times per run.
+ *
+ * At every boot the boot loader must find a bank holding an intact image, the
+ * flash must never be programmed from 0 to 1, and a hanging trial image must
+ * have the watchdog running. Every run must end with the expected image
+ * confirmed and selected by BB, within a bounded number of boots. The exit
+ * status is 1 on the first error.
+ *
+ * Build:
+ *     cc -O2 -Wall -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -DDUALBOOT_HOST -DCRC_STREAM_USE_HW=0 -I. \
+ *        -I../../Projects/GD32F450Z_EVAL/21_FMC_DualBoot/Application/Core/Inc \
+ *        -o fw_update_sim fw_update_sim.c \
+ *        ../../Projects/GD32F450Z_EVAL/21_FMC_DualBoot/Application/Core/Src/fw_update.c \
+ *        ../../Projects/GD32F450Z_EVAL/21_FMC_DualBoot/Application/Core/Src/crc_stream.c
+ *
+ * Example:
+ *     fw_update_sim
+ *     fw_update_sim --torn --bad
+ *     fw_update_sim --images 5 --size 300 --random 2000 --seed 7
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "fw_update.h"
+#include "crc_stream.h"
+
+#define FLASH_BASE      FW_BANK0_BASE
+#define FLASH_SIZE      0x200000U
+#define BANK_SECTORS    12U
+#define MAX_IMAGES      8
+#define SP_INIT         0x20030000U     /* top of SRAM, the initial stack pointer of the images */
+#define ERASE_POLLS     3               /* fmc_sector_erase_state_get() calls an erase stays busy */
+#define UPDATE_CHUNK    256U            /* bytes per fw_update_write(), as a UART block */
+
+/* how a boot ends */
+#define EXIT_DONE       0               /* the run reached its last image */
+#define EXIT_RESET      1               /* software or watchdog reset */
+#define EXIT_POWER      2               /* power failure */
+#define EXIT_FAIL       3               /* error in shared->error */
+
+/* what survives a reset: flash lives at its own address, the rest here */
+typedef struct {
+    uint32_t ob;                        /* option bytes as programmed */
+    unsigned long ops;                  /* flash and option byte operations so far */
+    unsigned long cut_at;               /* operation the power fails at, 0 never */
+    unsigned long long rng;
+    unsigned boots;
+    int final_image;
+    char error[256];
+} shared_struct;
+
+typedef struct {
+    uint32_t bank;
+    uint32_t size;
+    uint8_t *data;
+    fw_image_header_struct header;
+} image_struct;
+
+volatile uint32_t dualboot_host_obctl0;
+
+static const uint32_t sector_offset[BANK_SECTORS + 1U] = {
+    0x00000U, 0x04000U, 0x08000U, 0x0C000U, 0x10000U, 0x20000U,
+    0x40000U, 0x60000U, 0x80000U, 0xA0000U, 0xC0000U, 0xE0000U, 0x100000U
+};
+
+static shared_struct *sh;
+static uint8_t *flash;
+static image_struct images[MAX_IMAGES];
+static int image_num = 3;
+static uint32_t image_kb = 72;
+static int bad, torn, verbose;
+
+/* state of the running boot only */
+static uint32_t running_bank;
+static int fmc_unlocked, ob_unlocked, wdg_armed;
+static int erase_polls;
+
+static void fail(const char *fmt, ...) __attribute__((format(printf, 1, 2), noreturn));
+
+static void fail(const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(sh->error, sizeof(sh->error), fmt, ap);
+    va_end(ap);
+    fflush(stdout);
+    _exit(EXIT_FAIL);
+}
+
+static unsigned rng(void)
+{
+    sh->rng ^= sh->rng << 13;
+    sh->rng ^= sh->rng >> 7;
+    sh->rng ^= sh->rng << 17;
+    return (unsigned)(sh->rng >> 16);
+}
+
+/* the power fails during the next operation */
+static int op_torn(void)
+{
+    return torn && (sh->ops + 1 == sh->cut_at);
+}
+
+static void power_fail(void)
+{
+    if (verbose) {
+        printf("    power fails at operation %lu\n", sh->ops);
+    }
+    fflush(stdout);
+    _exit(EXIT_POWER);
+}
+
+/* count an operation, the power fails right after the chosen one */
+static void op_done(void)
+{
+    if (++sh->ops == sh->cut_at) {
+        power_fail();
+    }
+}
+
+static uint32_t *flash_word(uint32_t address)
+{
+    if ((address < FLASH_BASE) || (address >= FLASH_BASE + FLASH_SIZE) || (address & 3U)) {
+        fail("program at 0x%08x outside the flash", (unsigned)address);
+    }
+    if (!fmc_unlocked) {
+        fail("program at 0x%08x with the FMC locked", (unsigned)address);
+    }
+    if (erase_polls != 0) {
+        fail("program at 0x%08x during a sector erase", (unsigned)address);
+    }
+    return (uint32_t *)(flash + (address - FLASH_BASE));
+}
+
+static void word_program(uint32_t *word, uint32_t data)
+{
+    if ((*word & data) != data) {
+        fail("program 0x%08x over 0x%08x at 0x%08x", (unsigned)data, (unsigned)*word,
+             (unsigned)(FLASH_BASE + ((uint8_t *)word - flash)));
+    }
+    *word = data;
+}
+
+uint32_t dualboot_host_bank(void)
+{
+    return running_bank;
+}
+
+void fmc_unlock(void)
+{
+    fmc_unlocked = 1;
+}
+
+void fmc_lock(void)
+{
+    fmc_unlocked = 0;
+}
+
+void fmc_flag_clear(uint32_t fmc_flag)
+{
+    (void)fmc_flag;
+}
+
+fmc_state_enum fmc_ready_wait(uint32_t timeout)
+{
+    (void)timeout;
+    return FMC_READY;
+}
+
+fmc_state_enum fmc_word_program(uint32_t address, uint32_t data)
+{
+    uint32_t *word = flash_word(address);
+
+    if (op_torn()) {
+        /* only some of the bits are programmed */
+        *word &= data | rng();
+        sh->ops++;
+        power_fail();
+    }
+    word_program(word, data);
+    op_done();
+    return FMC_READY;
+}
+
+fmc_state_enum fmc_word_burst_program(uint32_t address, const uint32_t *data, uint32_t count)
+{
+    uint32_t n = count;
+
+    if (op_torn()) {
+        n = rng() % count;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        /* the driver skips erased words */
+        if (data[i] != 0xFFFFFFFFU) {
+            word_program(flash_word(address + 4U * i), data[i]);
+        }
+    }
+    if (n != count) {
+        sh->ops++;
+        power_fail();
+    }
+    op_done();
+    return FMC_READY;
+}
+
+fmc_state_enum fmc_sector_erase_start(uint32_t fmc_sector)
+{
+    uint32_t sn = fmc_sector >> 3, bank = (sn >= 16U) ? 1U : 0U, sector = bank ? sn - 16U : sn;
+    uint32_t start, size, part;
+
+    if ((sector >= BANK_SECTORS) || (fmc_sector & 7U)) {
+        fail("erase of sector code 0x%x", (unsigned)fmc_sector);
+    }
+    if (!fmc_unlocked || (erase_polls != 0)) {
+        fail("erase of sector %u with the FMC locked or busy", (unsigned)(bank * 12U + sector));
+    }
+    start = bank * 0x100000U + sector_offset[sector];
+    size = sector_offset[sector + 1U] - sector_offset[sector];
+    if (verbose) {
+        printf("    erase bank%u sector %u\n", (unsigned)bank, (unsigned)sector);
+    }
+
+    if (op_torn()) {
+        /* the erase stops part way, the erased part at either end */
+        part = (rng() % (size / 4U)) * 4U;
+        if (rng() & 1U) {
+            memset(flash + start, 0xFF, part);
+        } else {
+            memset(flash + start + size - part, 0xFF, part);
+        }
+        sh->ops++;
+        power_fail();
+    }
+    memset(flash + start, 0xFF, size);
+    erase_polls = ERASE_POLLS;
+    op_done();
+    return FMC_BUSY;
+}
+
+fmc_state_enum fmc_sector_erase_state_get(void)
+{
+    if (erase_polls == 0) {
+        return FMC_READY;
+    }
+    return (--erase_polls == 0) ? FMC_READY : FMC_BUSY;
+}
+
+void ob_unlock(void)
+{
+    ob_unlocked = 1;
+}
+
+void ob_lock(void)
+{
+    ob_unlocked = 0;
+}
+
+void ob_boot_mode_config(uint32_t boot_mode)
+{
+    if (!ob_unlocked) {
+        fail("option bytes written while locked");
+    }
+    dualboot_host_obctl0 = (dualboot_host_obctl0 & ~FMC_OBCTL0_BB) | boot_mode;
+}
+
+void ob_start(void)
+{
+    if (!ob_unlocked) {
+        fail("option bytes programmed while locked");
+    }
+    if (verbose) {
+        printf("    BB = %u\n", (dualboot_host_obctl0 & FMC_OBCTL0_BB) ? 1U : 0U);
+    }
+    /* the option bytes change completely or not at all */
+    if (op_torn()) {
+        sh->ops++;
+        power_fail();
+    }
+    sh->ob = dualboot_host_obctl0;
+    op_done();
+}
+
+ErrStatus fwdgt_config(uint16_t reload_value, uint8_t prescaler_div)
+{
+    (void)reload_value;
+    (void)prescaler_div;
+    return SUCCESS;
+}
+
+void fwdgt_enable(void)
+{
+    wdg_armed = 1;
+}
+
+void NVIC_SystemReset(void)
+{
+    if (verbose) {
+        printf("    reset\n");
+    }
+    fflush(stdout);
+    _exit(EXIT_RESET);
+}
+
+static int bank_void(uint32_t bank)
+{
+    uint32_t sp;
+
+    memcpy(&sp, flash + bank * 0x100000U, 4);
+    return (sp <= 0x20000000U) || (sp > 0x20030000U);
+}
+
+/* the image a bank holds intact, -1 for none */
+static int image_find(uint32_t bank)
+{
+    for (int i = 0; i < image_num; i++) {
+        if ((images[i].bank == bank) && !memcmp(flash + bank * 0x100000U, images[i].data, images[i].size)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* the next image comes in over the UART while the update runs */
+static void update_send(const image_struct *img)
+{
+    fw_update_status_enum status;
+    uint32_t sent = 0;
+
+    status = fw_update_begin(&img->header);
+    while (FW_UPDATE_BUSY == status) {
+        if (sent < img->size) {
+            uint32_t len = (img->size - sent < UPDATE_CHUNK) ? img->size - sent : UPDATE_CHUNK;
+
+            sent += fw_update_write(img->data + sent, len);
+        }
+        status = fw_update_poll();
+    }
+    if (FW_UPDATE_DONE != status) {
+        fail("update to image %u ended with status %d", (unsigned)img->header.version, (int)status);
+    }
+    NVIC_SystemReset();
+}
+
+static int boot(void)
+{
+    static const char *const state_name[] = {"empty", "trial", "confirmed", "invalid"};
+    uint32_t bb = (sh->ob & FMC_OBCTL0_BB) ? 1U : 0U;
+    int which;
+
+    /* the boot loader: bank1 when BB is set and bank1 is not void, bank0 otherwise */
+    running_bank = (bb && !bank_void(1)) ? 1U : 0U;
+    if (bank_void(running_bank)) {
+        fail("boot with BB = %u: bank%u is void", (unsigned)bb, (unsigned)running_bank);
+    }
+    which = image_find(running_bank);
+    if (which < 0) {
+        fail("boot with BB = %u: bank%u does not hold an intact image", (unsigned)bb, (unsigned)running_bank);
+    }
+    dualboot_host_obctl0 = sh->ob;
+    sh->boots++;
+    if (verbose) {
+        printf("  boot %u: bank%u image %d %s\n", sh->boots, (unsigned)running_bank, which,
+               state_name[fw_bank_state_get(running_bank)]);
+    }
+
+    fw_boot_check();
+
+    if ((which == image_num - 1) && bad) {
+        /* hangs before it confirms itself */
+        if (!wdg_armed) {
+            fail("image %d hangs without the watchdog running", which);
+        }
+        if (verbose) {
+            printf("    hang, watchdog reset\n");
+        }
+        fflush(stdout);
+        _exit(EXIT_RESET);
+    }
+    if (bad && (which == image_num - 2) && (FW_BANK_INVALID == fw_bank_state_get(running_bank ^ 1U))) {
+        /* rolled back */
+        sh->final_image = which;
+        return EXIT_DONE;
+    }
+
+    fw_update_confirm();
+    if (which == image_num - 1) {
+        sh->final_image = which;
+        return EXIT_DONE;
+    }
+    update_send(&images[which + 1]);
+    return EXIT_FAIL;
+}
+
+/* bank0 with the first image as the debugger leaves it, bank1 erased, BB clear */
+static void factory(void)
+{
+    memset(flash, 0xFF, FLASH_SIZE);
+    memcpy(flash, images[0].data, images[0].size);
+    sh->ob = OB_BB_DISABLE;
+    sh->ops = 0;
+    sh->boots = 0;
+    sh->final_image = -1;
+    sh->error[0] = '\0';
+}
+
+static void images_make(unsigned long long seed)
+{
+    unsigned long long s = seed;
+
+    for (int i = 0; i < image_num; i++) {
+        image_struct *img = &images[i];
+        uint32_t base = (i & 1) ? FW_BANK1_BASE : FW_BANK0_BASE;
+        uint32_t v[2] = {SP_INIT, base + 0x1C1U};
+
+        img->bank = (uint32_t)(i & 1);
+        /* sizes differ so that the images end in different sectors */
+        img->size = image_kb * 1024U + (uint32_t)i * 8196U;
+        if (img->size > FW_IMAGE_MAX_SIZE) {
+            img->size = FW_IMAGE_MAX_SIZE - (uint32_t)i * 4U;
+        }
+        img->data = malloc(img->size);
+        for (uint32_t n = 0; n < img->size; n++) {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            img->data[n] = (uint8_t)(s >> 24);
+        }
+        memcpy(img->data, v, sizeof(v));
+
+        memset(&img->header, 0, sizeof(img->header));
+        img->header.magic = FW_IMAGE_MAGIC;
+        img->header.version = (uint32_t)i;
+        img->header.bank = img->bank;
+        img->header.size = img->size;
+        img->header.crc = crc_stream_calculate(CRC_STREAM_UNIT, img->data, img->size);
+        img->header.header_crc = crc_stream_calculate(CRC_STREAM_UNIT, &img->header, sizeof(img->header) - 4U);
+    }
+}
+
+/* boot until the run ends, the power failing at cut_at and, with more_cuts, again later */
+static int run(unsigned long cut_at, int more_cuts, unsigned *boots)
+{
+    int expect = bad ? image_num - 2 : image_num - 1;
+    unsigned max_boots = 8U * (unsigned)image_num + 8U * (unsigned)more_cuts + 8U;
+    int status;
+    pid_t pid;
+
+    factory();
+    sh->cut_at = cut_at;
+    for (;;) {
+        if (sh->boots > max_boots) {
+            snprintf(sh->error, sizeof(sh->error), "still not done after %u boots", sh->boots);
+            return -1;
+        }
+        fflush(stdout);
+        pid = fork();
+        if (pid < 0) {
+            perror("fw_update_sim: fork");
+            exit(2);
+        }
+        if (pid == 0) {
+            status = boot();
+            fflush(stdout);
+            _exit(status);
+        }
+        waitpid(pid, &status, 0);
+        status = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAIL;
+        if (status == EXIT_FAIL) {
+            if (sh->error[0] == '\0') {
+                snprintf(sh->error, sizeof(sh->error), "boot %u crashed", sh->boots);
+            }
+            return -1;
+        }
+        if (status == EXIT_DONE) {
+            break;
+        }
+        if ((status == EXIT_POWER) && (more_cuts > 0)) {
+            more_cuts--;
+            sh->cut_at = sh->ops + 1 + rng() % 64U;
+        }
+    }
+
+    *boots = sh->boots;
+    if (sh->final_image != expect) {
+        snprintf(sh->error, sizeof(sh->error), "ended with image %d instead of %d", sh->final_image, expect);
+        return -1;
+    }
+    if (FW_BANK_CONFIRMED != fw_bank_state_get(images[expect].bank) && (expect != 0)) {
+        snprintf(sh->error, sizeof(sh->error), "image %d not confirmed at the end", expect);
+        return -1;
+    }
+    if (((sh->ob & FMC_OBCTL0_BB) ? 1U : 0U) != images[expect].bank) {
+        snprintf(sh->error, sizeof(sh->error), "BB does not select bank%u at the end", (unsigned)images[expect].bank);
+        return -1;
+    }
+    if (bad && (FW_BANK_INVALID != fw_bank_state_get(images[expect].bank ^ 1U))) {
+        snprintf(sh->error, sizeof(sh->error), "image %d not marked invalid at the end", image_num - 1);
+        return -1;
+    }
+    return 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [options]\n"
+            "  --images N      images in the update chain, 2 to %d (3)\n"
+            "  --size KB       size of the first image, the others grow by 8KB (72)\n"
+            "  --bad           the last image never confirms itself\n"
+            "  --torn          the power fails during the operation, not after it\n"
+            "  --random RUNS   runs with several random power failures instead of one at each operation\n"
+            "  --seed S        random seed\n"
+            "  -v              trace the boots, erases and BB changes\n",
+            name, MAX_IMAGES);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long long seed = 88172645463325252ULL;
+    unsigned long runs = 0, total, r;
+    unsigned boots, boots_sum = 0, boots_max = 0;
+    void *map;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--images") && (i + 1 < argc)) {
+            image_num = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--size") && (i + 1 < argc)) {
+            image_kb = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--bad")) {
+            bad = 1;
+        } else if (!strcmp(argv[i], "--torn")) {
+            torn = 1;
+        } else if (!strcmp(argv[i], "--random") && (i + 1 < argc)) {
+            runs = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && (i + 1 < argc)) {
+            seed = strtoull(argv[++i], NULL, 0) | 1;
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((image_num < 2) || (image_num > MAX_IMAGES) || (image_kb == 0) || (image_kb * 1024U > FW_IMAGE_MAX_SIZE)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* the firmware reads the flash at its own address */
+    map = mmap((void *)(uintptr_t)FLASH_BASE, FLASH_SIZE, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    sh = mmap(NULL, sizeof(*sh), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if ((map != (void *)(uintptr_t)FLASH_BASE) || (sh == MAP_FAILED)) {
+        fprintf(stderr, "fw_update_sim: cannot map the flash at 0x%08x\n", (unsigned)FLASH_BASE);
+        return 2;
+    }
+    flash = map;
+    sh->rng = seed;
+    images_make(seed);
+
+    /* a run without power failure counts the operations */
+    if (run(0, 0, &boots) != 0) {
+        fprintf(stderr, "fw_update_sim: without power failure: %s\n", sh->error);
+        return 1;
+    }
+    total = sh->ops;
+    printf("%d images, %lu flash and option byte operations and %u boots without power failure\n", image_num, total,
+           boots);
+
+    if (runs == 0) {
+        for (r = 1; r <= total; r++) {
+            if (verbose) {
+                printf("power failure %s operation %lu\n", torn ? "during" : "after", r);
+            }
+            if (run(r, 0, &boots) != 0) {
+                fprintf(stderr, "fw_update_sim: power failure %s operation %lu: %s\n", torn ? "during" : "after", r,
+                        sh->error);
+                return 1;
+            }
+            boots_sum += boots;
+            boots_max = (boots > boots_max) ? boots : boots_max;
+        }
+        runs = total;
+    } else {
+        for (r = 1; r <= runs; r++) {
+            unsigned long first = 1 + rng() % total;
+
+            if (verbose) {
+                printf("run %lu, first power failure at operation %lu\n", r, first);
+            }
+            if (run(first, 1 + (int)(rng() % 4U), &boots) != 0) {
+                fprintf(stderr, "fw_update_sim: run %lu, first power failure at operation %lu: %s\n", r, first,
+                        sh->error);
+                return 1;
+            }
+            boots_sum += boots;
+            boots_max = (boots > boots_max) ? boots : boots_max;
+        }
+    }
+
+    printf("%lu runs with power failures %s operations, %.1f boots per run, at most %u\n", runs,
+           torn ? "during" : "after", (double)boots_sum / (double)runs, boots_max);
+    printf("every boot started an intact image, every run ended running image %d%s\n",
+           bad ? image_num - 2 : image_num - 1, bad ? " with the last one invalid" : "");
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * hal_regtrace: runs the C++ template layer of the GPIO, USART, SPI, TIMER and
+ * DMA (Drivers/GD32F4xx_hal_cpp) on a PC and prints its register accesses.
+ *
+ * On the target the layer folds every operation into loads and stores of
+ * constant addresses and values. Built with GD32F4XX_HAL_REG_HOOK, the same
+ * headers call gd32f4xx_hal_reg_write() and gd32f4xx_hal_reg_read() instead,
+ * which this tool implements on a register model: every access is recorded,
+ * reads return the last value written, status registers report ready.
+ *
+ * Each case runs one operation on a fresh model and prints the accesses. With
+ * --check every trace is also compared with the sequence worked out by hand
+ * from the user manual (addresses, bit fields, one access per register and
+ * port); the exit status is 1 on a difference.
+ *
+ * The static checks are compile errors, HAL_REGTRACE_FAIL=1..4 builds a case
+ * that must not compile: a pin without the signal, a pin with two functions,
+ * a DMA channel without the request and a DMA channel with two requests.
+ *
+ * Build:
+ *     c++ -std=c++17 -O2 -Wall -DGD32F4XX_HAL_REG_HOOK -I../../Drivers/GD32F4xx_hal_cpp/Include \
+ *         -o hal_regtrace hal_regtrace.cpp
+ *     for n in 1 2 3 4; do ! c++ -std=c++17 -fsyntax-only -DGD32F4XX_HAL_REG_HOOK -DHAL_REGTRACE_FAIL=$n \
+ *         -I../../Drivers/GD32F4xx_hal_cpp/Include hal_regtrace.cpp 2>/dev/null || echo "case $n compiled"; done
+ *
+ * Example:
+ *     hal_regtrace
+ *     hal_regtrace --check
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#include "gd32f4xx_hal.hpp"
+
+using namespace gd32f4xx::hal;
+
+struct access {
+    char op;            /* 'R' or 'W' */
+    uint32_t addr;
+    uint32_t value;
+};
+
+static std::vector<access> trace;
+static std::map<uint32_t, uint32_t> regs;
+static std::map<uint32_t, uint32_t> ready;
+
+extern "C" void gd32f4xx_hal_reg_write(uint32_t addr, uint32_t value)
+{
+    trace.push_back({'W', addr, value});
+    regs[addr] = value;
+}
+
+extern "C" uint32_t gd32f4xx_hal_reg_read(uint32_t addr)
+{
+    uint32_t value = regs[addr] | ready[addr];
+
+    trace.push_back({'R', addr, value});
+    return value;
+}
+
+/* the eval board: LEDs on PE2, PE3 and PF10, USART0 on PA9/PA10, the SPI flash on SPI5 */
+using Led1 = Pin<PortE, 2>;
+using Led2 = Pin<PortE, 3>;
+using Led3 = Pin<PortF, 10>;
+using Leds = PinGroup<Led1, Led2, Led3>;
+using Com0 = Usart<0>;
+using Flash = Spi<5>;
+
+#if HAL_REGTRACE_FAIL == 1
+/* PA10 is the receive pin of USART0 */
+using Bad = Resources<Com0::Tx<Pin<PortA, 10>>>;
+#elif HAL_REGTRACE_FAIL == 2
+/* PA9 is USART0 TX and TIMER0 CH1 */
+using Bad = Resources<Com0::Tx<Pin<PortA, 9>>, Timer<0>::ChPin<1, Pin<PortA, 9>>>;
+#elif HAL_REGTRACE_FAIL == 3
+/* USART0 TX is DMA1 channel 7 */
+using Bad = Resources<Com0::TxDma<DmaStream<1, 6>>>;
+#elif HAL_REGTRACE_FAIL == 4
+/* DMA1 channel 5 serves USART0 RX and SPI0 TX, not both at once */
+using Bad = Resources<Com0::RxDma<DmaStream<1, 5>>, Spi<0>::TxDma<DmaStream<1, 5>>>;
+#endif
+#ifdef HAL_REGTRACE_FAIL
+static void bad_use(void)
+{
+    Bad::configure();
+}
+#endif
+
+using Board = Resources<
+    Com0::Tx<Pin<PortA, 9>>, Com0::Rx<Pin<PortA, 10>>,
+    Flash::Sck<Pin<PortG, 13>>, Flash::Miso<Pin<PortG, 12>>, Flash::Mosi<Pin<PortG, 14>>,
+    PinSetting<Pin<PortI, 8>, Output<>>,
+    Com0::TxDma<DmaStream<1, 7>>, Timer<1>::UpDma<DmaStream<0, 1>>>;
+
+static const void *const buffer = reinterpret_cast<const void *>(static_cast<uintptr_t>(0x20001000U));
+static const uint16_t *const duty = reinterpret_cast<const uint16_t *>(static_cast<uintptr_t>(0x20002000U));
+
+struct test_case {
+    const char *name;
+    void (*setup)(void);
+    void (*run)(void);
+    std::vector<access> expect;
+};
+
+static void reset_porta(void)
+{
+    /* the debug pins of port A are in AF mode after reset */
+    regs[0x40020000U] = 0xA8000000U;
+    regs[0x40020008U] = 0x0C000000U;
+    regs[0x4002000CU] = 0x64000000U;
+}
+
+static void usart_ready(void)
+{
+    ready[0x40011000U] = 0xC0U;
+}
+
+static const test_case cases[] = {
+    {"pin set", nullptr, [] { Led1::set(); }, {
+        {'W', 0x40021018U, 0x00000004U}}},
+    {"pin clear", nullptr, [] { Led3::clear(); }, {
+        {'W', 0x40021418U, 0x04000000U}}},
+    {"pin toggle", nullptr, [] { Led2::toggle(); }, {
+        {'W', 0x4002102CU, 0x00000008U}}},
+    {"group set", nullptr, [] { Leds::set(); }, {
+        {'W', 0x40021018U, 0x0000000CU},
+        {'W', 0x40021418U, 0x00000400U}}},
+    {"group write", nullptr, [] { Leds::write(0x5U); }, {
+        {'W', 0x40021018U, 0x00080004U},
+        {'W', 0x40021418U, 0x00000400U}}},
+    {"group write constant", nullptr, [] { Leds::write<0x2U>(); }, {
+        {'W', 0x40021018U, 0x00040008U},
+        {'W', 0x40021418U, 0x04000000U}}},
+    {"group configure", nullptr, [] { Leds::configure<Output<Speed::High>>(); }, {
+        {'R', 0x40021004U, 0x00000000U}, {'W', 0x40021004U, 0x00000000U},
+        {'R', 0x40021008U, 0x00000000U}, {'W', 0x40021008U, 0x000000A0U},
+        {'R', 0x4002100CU, 0x00000000U}, {'W', 0x4002100CU, 0x00000000U},
+        {'R', 0x40021000U, 0x00000000U}, {'W', 0x40021000U, 0x00000050U},
+        {'R', 0x40021404U, 0x00000000U}, {'W', 0x40021404U, 0x00000000U},
+        {'R', 0x40021408U, 0x00000000U}, {'W', 0x40021408U, 0x00200000U},
+        {'R', 0x4002140CU, 0x00000000U}, {'W', 0x4002140CU, 0x00000000U},
+        {'R', 0x40021400U, 0x00000000U}, {'W', 0x40021400U, 0x00100000U}}},
+    {"board clocks", nullptr, [] { Board::clock_enable(); }, {
+        {'R', 0x40023830U, 0x00000000U}, {'W', 0x40023830U, 0x00600141U}}},
+    {"board pins", reset_porta, [] { Board::configure(); }, {
+        {'R', 0x40020024U, 0x00000000U}, {'W', 0x40020024U, 0x00000770U},
+        {'R', 0x40020004U, 0x00000000U}, {'W', 0x40020004U, 0x00000000U},
+        {'R', 0x40020008U, 0x0C000000U}, {'W', 0x40020008U, 0x0C280000U},
+        {'R', 0x4002000CU, 0x64000000U}, {'W', 0x4002000CU, 0x64100000U},
+        {'R', 0x40020000U, 0xA8000000U}, {'W', 0x40020000U, 0xA8280000U},
+        {'R', 0x40021824U, 0x00000000U}, {'W', 0x40021824U, 0x05550000U},
+        {'R', 0x40021804U, 0x00000000U}, {'W', 0x40021804U, 0x00000000U},
+        {'R', 0x40021808U, 0x00000000U}, {'W', 0x40021808U, 0x2A000000U},
+        {'R', 0x4002180CU, 0x00000000U}, {'W', 0x4002180CU, 0x00000000U},
+        {'R', 0x40021800U, 0x00000000U}, {'W', 0x40021800U, 0x2A000000U},
+        {'R', 0x40022004U, 0x00000000U}, {'W', 0x40022004U, 0x00000000U},
+        {'R', 0x40022008U, 0x00000000U}, {'W', 0x40022008U, 0x00020000U},
+        {'R', 0x4002200CU, 0x00000000U}, {'W', 0x4002200CU, 0x00000000U},
+        {'R', 0x40022000U, 0x00000000U}, {'W', 0x40022000U, 0x00010000U}}},
+    {"peripheral clocks", nullptr, [] { clock_enable<Com0, Spi<1>, Timer<1>, PortE>(); }, {
+        {'R', 0x40023830U, 0x00000000U}, {'W', 0x40023830U, 0x00000010U},
+        {'R', 0x40023840U, 0x00000000U}, {'W', 0x40023840U, 0x00004001U},
+        {'R', 0x40023844U, 0x00000000U}, {'W', 0x40023844U, 0x00000010U}}},
+    {"usart configure", nullptr, [] { Com0::configure<100000000U, 115200U>(); }, {
+        {'W', 0x4001100CU, 0x00000000U},
+        {'W', 0x40011008U, 0x00000364U},
+        {'W', 0x40011010U, 0x00000000U},
+        {'W', 0x40011014U, 0x00000000U},
+        {'W', 0x4001100CU, 0x0000200CU}}},
+    {"usart put", usart_ready, [] { Com0::put('A'); }, {
+        {'R', 0x40011000U, 0x000000C0U}, {'W', 0x40011004U, 0x00000041U}}},
+    {"usart dma transmit", nullptr, [] { Com0::dma_transmit<Com0::TxDma<DmaStream<1, 7>>>(buffer, 16U); }, {
+        {'W', 0x4002640CU, 0x0F400000U},
+        {'W', 0x400264C0U, 0x40011004U},
+        {'W', 0x400264C4U, 0x20001000U},
+        {'W', 0x400264BCU, 0x00000010U},
+        {'W', 0x400264B8U, 0x08010441U},
+        {'R', 0x40011014U, 0x00000000U}, {'W', 0x40011014U, 0x00000080U}}},
+    {"spi configure", nullptr, [] { Flash::configure<4U, SpiMode::Mode3>(); }, {
+        {'W', 0x40015400U, 0x0000030FU},
+        {'W', 0x40015404U, 0x00000000U},
+        {'W', 0x40015400U, 0x0000034FU}}},
+    {"timer configure", nullptr, [] { Timer<1>::configure<200U, 1000U>(); }, {
+        {'W', 0x40000000U, 0x00000080U},
+        {'W', 0x40000028U, 0x000000C7U},
+        {'W', 0x4000002CU, 0x000003E7U},
+        {'W', 0x40000014U, 0x00000001U},
+        {'W', 0x40000010U, 0x00000000U}}},
+    {"timer pwm", nullptr, [] { Timer<0>::pwm_configure<2>(); }, {
+        {'W', 0x4001003CU, 0x00000000U},
+        {'R', 0x4001001CU, 0x00000000U}, {'W', 0x4001001CU, 0x00000068U},
+        {'R', 0x40010020U, 0x00000000U}, {'W', 0x40010020U, 0x00000100U},
+        {'R', 0x40010044U, 0x00000000U}, {'W', 0x40010044U, 0x00008000U}}},
+    {"timer dma compare", nullptr, [] { Timer<1>::dma_compare<Timer<1>::UpDma<DmaStream<0, 1>>, 2>(duty, 64U); }, {
+        {'W', 0x40026008U, 0x00000F40U},
+        {'W', 0x40026030U, 0x4000003CU},
+        {'W', 0x40026034U, 0x20002000U},
+        {'W', 0x4002602CU, 0x00000040U},
+        {'W', 0x40026028U, 0x06022D41U},
+        {'R', 0x4000000CU, 0x00000000U}, {'W', 0x4000000CU, 0x00000100U}}},
+};
+
+static void trace_print(const std::vector<access> &t)
+{
+    for (const access &a : t) {
+        printf("  %c 0x%08lX 0x%08lX\n", a.op, (unsigned long)a.addr, (unsigned long)a.value);
+    }
+}
+
+static bool trace_equal(const std::vector<access> &a, const std::vector<access> &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if ((a[i].op != b[i].op) || (a[i].addr != b[i].addr) || (a[i].value != b[i].value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int check = 0, failed = 0;
+
+    if ((argc == 2) && !strcmp(argv[1], "--check")) {
+        check = 1;
+    } else if (argc != 1) {
+        fprintf(stderr, "usage: %s [--check]\n", argv[0]);
+        return 2;
+    }
+
+    for (const test_case &c : cases) {
+        trace.clear();
+        regs.clear();
+        ready.clear();
+        if (c.setup != nullptr) {
+            c.setup();
+        }
+        c.run();
+
+        printf("%s: %zu accesses\n", c.name, trace.size());
+        trace_print(trace);
+        if (check && !trace_equal(trace, c.expect)) {
+            printf("  FAILED, expected:\n");
+            trace_print(c.expect);
+            failed = 1;
+        }
+    }
+
+    if (check) {
+        printf("%s\n", failed ? "register sequences differ" : "all register sequences match");
+    }
+    return failed;
+}
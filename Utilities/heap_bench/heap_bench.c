@@ -0,0 +1,351 @@
+/*
+ * heap_bench: stress test and benchmark of the multi-region heap on a PC.
+ *
+ * The 27_ENET_FreeRTOS_tcpudp demo serves FreeRTOS and lwIP from one heap
+ * (mem_region.c) with an arena per memory region, placement hints and O(1)
+ * size-class pools for small blocks. This tool builds the same source for the
+ * host with regions of the board's sizes and runs a random mix of allocations
+ * and frees shaped like the demo's: small lwIP pool objects, pbufs of a frame,
+ * task stacks and kernel objects, with the hints the demo gives them.
+ *
+ * It prints the time per operation next to the C library malloc() running the
+ * same sequence, and the free bytes, high-water mark, largest block and
+ * fragmentation of every region.
+ *
+ * With --check every block is filled with a pattern that is verified when it
+ * is freed, blocks are checked for alignment, overlaps and the region their
+ * hint allows, and once everything is freed the free bytes of each region must
+ * add up with the pool overhead to its size again. The exit status is 1 on the
+ * first error.
+ *
+ * Build:
+ *     cc -O2 -Wall -DMEM_REGION_HOST \
+ *        -I../../Projects/GD32F450I_EVAL/27_ENET_FreeRTOS_tcpudp/Application/Core/Inc \
+ *        -o heap_bench heap_bench.c \
+ *        ../../Projects/GD32F450I_EVAL/27_ENET_FreeRTOS_tcpudp/Application/Core/Src/mem_region.c
+ *
+ * Example:
+ *     heap_bench --ops 1000000
+ *     heap_bench --live 512 --sdram 4096
+ *     heap_bench --ops 200000 --seed 7 --sdram 0 --check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mem_region.h"
+
+#define MAX_LIVE        4096
+#define SRAM_SIZE       (32 * 1024)     /* configTOTAL_HEAP_SIZE of the demo */
+#define TCM_SIZE        (60 * 1024)     /* the TCM behind a small .tcmram section */
+
+typedef struct {
+    unsigned char *mem;
+    size_t size;
+    mem_hint_enum hint;
+    unsigned seed;
+} live_block;
+
+static const char *const region_names[MEM_REGION_NUM] = {"SRAM", "TCM", "SDRAM"};
+static const char *const hint_names[MEM_HINT_NUM] = {"DMA", "CPU", "BULK"};
+
+static live_block live[MAX_LIVE];
+static unsigned live_num;
+static unsigned live_target = 64;
+static unsigned long long rng_state = 88172645463325252ULL;
+
+static unsigned rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned)(rng_state >> 16);
+}
+
+/* sizes and hints of the demo's allocations */
+static void request_pick(size_t *size, mem_hint_enum *hint)
+{
+    unsigned r = rng() % 100;
+
+    if (r < 55) {
+        /* memp objects: pbuf headers, tcp segments, pcbs, netbufs */
+        *size = 16 + rng() % 200;
+        *hint = MEM_HINT_DMA;
+    } else if (r < 80) {
+        /* PBUF_POOL buffers and PBUF_RAM frames */
+        *size = 256 + rng() % 1300;
+        *hint = MEM_HINT_DMA;
+    } else if (r < 92) {
+        /* queues, semaphores and TCBs */
+        *size = 80 + rng() % 180;
+        *hint = MEM_HINT_CPU;
+    } else if (r < 98) {
+        /* task stacks */
+        *size = 520 + rng() % 2600;
+        *hint = MEM_HINT_CPU;
+    } else {
+        /* large application buffers */
+        *size = 4096 + rng() % 12288;
+        *hint = MEM_HINT_BULK;
+    }
+}
+
+static void pattern_fill(live_block *b)
+{
+    unsigned s = b->seed;
+
+    for (size_t i = 0; i < b->size; i++) {
+        s = s * 1103515245U + 12345U;
+        b->mem[i] = (unsigned char)(s >> 16);
+    }
+}
+
+static int pattern_check(const live_block *b)
+{
+    unsigned s = b->seed;
+
+    for (size_t i = 0; i < b->size; i++) {
+        s = s * 1103515245U + 12345U;
+        if (b->mem[i] != (unsigned char)(s >> 16)) {
+            fprintf(stderr, "heap_bench: block %p of %zu bytes overwritten at byte %zu\n",
+                    (void *)b->mem, b->size, i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int hint_allows(mem_hint_enum hint, mem_region_enum region)
+{
+    switch (hint) {
+    case MEM_HINT_DMA:
+    case MEM_HINT_BULK:
+        return (region == MEM_REGION_SRAM) || (region == MEM_REGION_SDRAM);
+    default:
+        return region != MEM_REGION_NUM;
+    }
+}
+
+static int block_check(const live_block *b)
+{
+    mem_region_enum region = mem_region_of(b->mem);
+
+    if (((size_t)b->mem & (MEM_REGION_ALIGN - 1)) != 0) {
+        fprintf(stderr, "heap_bench: block %p is not aligned\n", (void *)b->mem);
+        return -1;
+    }
+    if (!hint_allows(b->hint, region)) {
+        fprintf(stderr, "heap_bench: %s block %p in region %s\n", hint_names[b->hint], (void *)b->mem,
+                (region == MEM_REGION_NUM) ? "none" : region_names[region]);
+        return -1;
+    }
+    for (unsigned i = 0; i < live_num; i++) {
+        const live_block *o = &live[i];
+
+        if ((o != b) && (b->mem < o->mem + o->size) && (o->mem < b->mem + b->size)) {
+            fprintf(stderr, "heap_bench: blocks %p and %p overlap\n", (void *)b->mem, (void *)o->mem);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* the random sequence on the region heap, returns -1 on a check error */
+static int run_region(unsigned long ops, int check, double *ns, unsigned long *fails)
+{
+    double start = now_ns();
+
+    *fails = 0;
+    for (unsigned long n = 0; n < ops; n++) {
+        /* free more often the more blocks are live, about live_target stay live */
+        if ((live_num > 0) && ((live_num == MAX_LIVE) || ((rng() % (2 * live_target)) < live_num))) {
+            unsigned i = rng() % live_num;
+
+            if (check && (pattern_check(&live[i]) != 0)) {
+                return -1;
+            }
+            mem_region_free(live[i].mem);
+            live[i] = live[--live_num];
+        } else {
+            live_block *b = &live[live_num];
+
+            request_pick(&b->size, &b->hint);
+            b->mem = mem_region_alloc(b->size, b->hint);
+            if (b->mem == NULL) {
+                (*fails)++;
+                continue;
+            }
+            b->seed = rng();
+            live_num++;
+            if (check) {
+                if (block_check(b) != 0) {
+                    return -1;
+                }
+                pattern_fill(b);
+            }
+        }
+    }
+    *ns = (now_ns() - start) / (double)ops;
+    return 0;
+}
+
+/* the same decisions with malloc(), the sizes are replayed from the same seed */
+static void run_libc(unsigned long ops, unsigned long long seed, double *ns)
+{
+    static void *ptr[MAX_LIVE];
+    unsigned num = 0;
+    double start;
+
+    rng_state = seed;
+    start = now_ns();
+    for (unsigned long n = 0; n < ops; n++) {
+        if ((num > 0) && ((num == MAX_LIVE) || ((rng() % (2 * live_target)) < num))) {
+            unsigned i = rng() % num;
+
+            free(ptr[i]);
+            ptr[i] = ptr[--num];
+        } else {
+            size_t size;
+            mem_hint_enum hint;
+
+            request_pick(&size, &hint);
+            ptr[num] = malloc(size);
+            if (ptr[num] != NULL) {
+                rng();
+                num++;
+            }
+        }
+    }
+    *ns = (now_ns() - start) / (double)ops;
+    while (num > 0) {
+        free(ptr[--num]);
+    }
+}
+
+static void stats_print(void)
+{
+    printf("  %-6s %9s %9s %10s %9s %7s %6s %7s %9s %7s %7s %7s\n", "region", "size", "free",
+           "high-water", "largest", "blocks", "frag %", "pool", "pool free", "allocs", "frees", "misses");
+    for (int i = 0; i < MEM_REGION_NUM; i++) {
+        mem_region_stat_struct st;
+
+        mem_region_stat_get((mem_region_enum)i, &st);
+        if (st.size == 0) {
+            continue;
+        }
+        printf("  %-6s %9u %9u %10u %9u %7u %6.1f %7u %9u %7u %7u %7u\n", region_names[i], st.size, st.free,
+               st.size - st.free_min, st.largest, st.free_blocks, st.frag / 10.0, st.pool_size, st.pool_free,
+               st.allocs, st.frees, st.misses);
+    }
+}
+
+/* everything is freed: each region holds its size again, less the pool overhead */
+static int empty_check(void)
+{
+    int err = 0;
+
+    for (int i = 0; i < MEM_REGION_NUM; i++) {
+        mem_region_stat_struct st;
+
+        mem_region_stat_get((mem_region_enum)i, &st);
+        if ((st.size != 0) && (st.free + (st.pool_size - st.pool_free) != st.size)) {
+            fprintf(stderr, "heap_bench: %s: %u free and %u pool overhead of %u bytes\n", region_names[i],
+                    st.free, st.pool_size - st.pool_free, st.size);
+            err = -1;
+        }
+        if ((st.size != 0) && (st.frees != st.allocs)) {
+            fprintf(stderr, "heap_bench: %s: %u allocations but %u frees\n", region_names[i], st.allocs, st.frees);
+            err = -1;
+        }
+    }
+    return err;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [options]\n"
+            "  --ops N        random operations (default 1000000)\n"
+            "  --seed N       random seed\n"
+            "  --live N       blocks live on average (default 64)\n"
+            "  --sdram KB     size of the SDRAM region, 0 leaves it out as in the demo (default 1024)\n"
+            "  --check        verify every block and the final statistics\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    static unsigned long long sram[SRAM_SIZE / 8], tcm[TCM_SIZE / 8];
+    unsigned long ops = 1000000, fails;
+    unsigned long long seed = rng_state;
+    unsigned long sdram_kb = 1024;
+    unsigned char *sdram = NULL;
+    double ns_region, ns_libc;
+    int check = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ops") && (i + 1 < argc)) {
+            ops = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && (i + 1 < argc)) {
+            seed = strtoull(argv[++i], NULL, 0) | 1;
+        } else if (!strcmp(argv[i], "--live") && (i + 1 < argc)) {
+            live_target = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--sdram") && (i + 1 < argc)) {
+            sdram_kb = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--check")) {
+            check = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((ops == 0) || (live_target == 0) || (live_target > MAX_LIVE / 2)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mem_region_add(MEM_REGION_SRAM, sram, sizeof(sram));
+    /* an odd start, the region aligns it */
+    mem_region_add(MEM_REGION_TCM, (unsigned char *)tcm + 4, sizeof(tcm) - 4);
+    if (sdram_kb != 0) {
+        sdram = malloc(sdram_kb * 1024);
+        if ((sdram == NULL) || (mem_region_add(MEM_REGION_SDRAM, sdram, (uint32_t)(sdram_kb * 1024)) == 0)) {
+            fprintf(stderr, "heap_bench: no SDRAM region of %lu KB\n", sdram_kb);
+            return 1;
+        }
+    }
+
+    rng_state = seed;
+    if (run_region(ops, check, &ns_region, &fails) != 0) {
+        return 1;
+    }
+    printf("%lu operations, %u blocks live, %lu allocations failed\n", ops, live_num, fails);
+    stats_print();
+
+    while (live_num > 0) {
+        if (check && (pattern_check(&live[live_num - 1]) != 0)) {
+            return 1;
+        }
+        mem_region_free(live[--live_num].mem);
+    }
+    if (check) {
+        if (empty_check() != 0) {
+            return 1;
+        }
+        printf("all blocks intact, all regions whole again\n");
+    } else {
+        run_libc(ops, seed, &ns_libc);
+        printf("region heap %.1f ns per operation, C library malloc %.1f ns\n", ns_region, ns_libc);
+    }
+
+    free(sdram);
+    return 0;
+}
@@ -0,0 +1,231 @@
+/*
+ * hid_parse: runs the USB host HID report descriptor parser on a PC.
+ *
+ * The firmware compiles the report descriptor of a HID device at enumeration
+ * (usbh_hid_parser.c) and decodes every input report with the compiled table
+ * into usage events. This tool builds the same source for the host, prints the
+ * table compiled from a captured descriptor and decodes captured reports, so a
+ * new device can be checked without the board.
+ *
+ * The descriptor is a binary file, such as
+ *     /sys/class/hidraw/hidraw0/device/report_descriptor
+ * or text with hex bytes, such as the output of usbhid-dump -e descriptor.
+ * The reports are text with one hex report per line, or a hidraw device that
+ * is read live.
+ *
+ * Build:
+ *     cc -O2 -Wall -I../../Drivers/GD32F4xx_usb_library/host/class/hid/Include \
+ *        -o hid_parse hid_parse.c ../../Drivers/GD32F4xx_usb_library/host/class/hid/Source/usbh_hid_parser.c
+ *
+ * Example:
+ *     hid_parse /sys/class/hidraw/hidraw0/device/report_descriptor /dev/hidraw0
+ *     hid_parse gamepad_desc.txt gamepad_reports.txt
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "usbh_hid_parser.h"
+
+#define MAX_DESC    4096
+#define MAX_REPORT  1024
+
+static const char *const parse_errors[] = {
+    "ok", "malformed item", "bad report size", "push/pop error", "no input field",
+    "descriptor exceeds the configured table sizes"
+};
+
+/* parse hex bytes ("05 01", "0x05,0x01", "0501") from text, other characters separate bytes */
+static int hex_parse(const char *text, size_t len, uint8_t *out, size_t max)
+{
+    size_t n = 0, i = 0;
+
+    while (i < len) {
+        if ((text[i] == '0') && (i + 1 < len) && ((text[i + 1] == 'x') || (text[i + 1] == 'X'))) {
+            i += 2;
+        }
+        if ((i + 1 < len) && isxdigit((unsigned char)text[i]) && isxdigit((unsigned char)text[i + 1])) {
+            char byte[3] = {text[i], text[i + 1], 0};
+
+            if (n >= max) {
+                return -1;
+            }
+            out[n++] = (uint8_t)strtoul(byte, NULL, 16);
+            i += 2;
+        } else if (isxdigit((unsigned char)text[i])) {
+            return -1;
+        } else {
+            i++;
+        }
+    }
+    return (int)n;
+}
+
+static int desc_load(const char *path, uint8_t *desc)
+{
+    static char raw[MAX_DESC * 4];
+    size_t len, i;
+    int text = 1;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL) {
+        fprintf(stderr, "hid_parse: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    len = fread(raw, 1, sizeof(raw), f);
+    fclose(f);
+
+    for (i = 0; i < len; i++) {
+        if (!isprint((unsigned char)raw[i]) && !isspace((unsigned char)raw[i])) {
+            text = 0;
+            break;
+        }
+    }
+    if (!text) {
+        if (len > MAX_DESC) {
+            fprintf(stderr, "hid_parse: %s: descriptor too long\n", path);
+            return -1;
+        }
+        memcpy(desc, raw, len);
+        return (int)len;
+    }
+    if ((len = (size_t)hex_parse(raw, len, desc, MAX_DESC)) == (size_t)-1) {
+        fprintf(stderr, "hid_parse: %s: not a descriptor\n", path);
+        return -1;
+    }
+    return (int)len;
+}
+
+static void map_print(const hid_report_map *map)
+{
+    printf("%u fields, %u listed usages, %u values, report IDs %s\n", map->num_fields,
+           map->num_usages, map->num_values, map->use_ids ? "used" : "not used");
+    for (uint8_t i = 0; i < map->num_reports; i++) {
+        printf("  input report %u: %u bits\n", map->report[i].id, map->report[i].bits);
+    }
+    printf("  %-4s %-6s %-5s %-5s %-9s %-6s %-23s %s\n",
+           "id", "offset", "size", "count", "type", "page", "usages", "logical range");
+    for (uint8_t i = 0; i < map->num_fields; i++) {
+        const hid_field *f = &map->field[i];
+        char usages[32];
+
+        if (f->flags & HID_FIELD_LIST) {
+            int len = 0;
+
+            for (uint16_t u = 0; (u < f->usage_max) && (len < (int)sizeof(usages) - 6); u++) {
+                len += snprintf(usages + len, sizeof(usages) - len, "%s%X", u ? "," : "",
+                                (unsigned)(map->usage[f->usage_min + u] & 0xFFFFU));
+            }
+        } else {
+            snprintf(usages, sizeof(usages), "%X-%X", f->usage_min, f->usage_max);
+        }
+        printf("  %-4u %-6u %-5u %-5u %-9s 0x%04X %-23s %ld..%ld\n", f->report_id, f->offset, f->size,
+               f->count, (f->flags & HID_FIELD_ARRAY) ? "array" :
+               (f->flags & HID_FIELD_RELATIVE) ? "relative" : "absolute", f->page, usages,
+               (long)f->logical_min, (long)f->logical_max);
+    }
+}
+
+static void events_print(hid_event_ring *ring)
+{
+    hid_event ev;
+
+    while (hid_event_get(ring, &ev)) {
+        if (ev.page == HID_PAGE_SYNC) {
+            printf("  end of report %u, %ld events\n", ev.usage, (long)ev.value);
+        } else {
+            printf("  0x%04X:0x%04X = %ld\n", ev.page, ev.usage, (long)ev.value);
+        }
+    }
+    if (ring->lost) {
+        printf("  %lu events lost\n", (unsigned long)ring->lost);
+        ring->lost = 0;
+    }
+}
+
+static int reports_decode(const char *path, hid_report_map *map)
+{
+    static hid_event_ring ring;
+    uint8_t report[MAX_REPORT];
+    unsigned long num = 0;
+    struct stat st;
+
+    hid_event_ring_init(&ring);
+
+    if ((stat(path, &st) == 0) && S_ISCHR(st.st_mode)) {
+        /* hidraw returns one report per read */
+        int fd = open(path, O_RDONLY);
+        ssize_t len;
+
+        if (fd < 0) {
+            fprintf(stderr, "hid_parse: %s: %s\n", path, strerror(errno));
+            return 1;
+        }
+        while ((len = read(fd, report, sizeof(report))) > 0) {
+            printf("report %lu, %ld bytes\n", ++num, (long)len);
+            hid_report_decode(map, report, (uint16_t)len, &ring);
+            events_print(&ring);
+            fflush(stdout);
+        }
+        close(fd);
+    } else {
+        char line[MAX_REPORT * 4];
+        FILE *f = fopen(path, "r");
+
+        if (f == NULL) {
+            fprintf(stderr, "hid_parse: %s: %s\n", path, strerror(errno));
+            return 1;
+        }
+        while (fgets(line, sizeof(line), f) != NULL) {
+            int len = hex_parse(line, strlen(line), report, sizeof(report));
+
+            if (len <= 0) {
+                continue;
+            }
+            printf("report %lu, %d bytes\n", ++num, len);
+            /* the ring is emptied after each report, as the firmware consumer would */
+            if (hid_report_decode(map, report, (uint16_t)len, &ring) == 0) {
+                printf("  no change\n");
+            }
+            events_print(&ring);
+        }
+        fclose(f);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t desc[MAX_DESC];
+    static hid_report_map map;
+    hid_parse_status status;
+    int len;
+
+    if ((argc < 2) || (argc > 3)) {
+        fprintf(stderr, "usage: %s DESCRIPTOR [REPORTS|/dev/hidrawN]\n", argv[0]);
+        return 2;
+    }
+
+    len = desc_load(argv[1], desc);
+    if (len < 0) {
+        return 1;
+    }
+
+    status = hid_report_desc_parse(&map, desc, (uint16_t)len);
+    printf("%d byte descriptor: %s\n", len, parse_errors[status]);
+    if (status != HID_PARSE_OK) {
+        return 1;
+    }
+    map_print(&map);
+
+    if (argc == 3) {
+        return reports_decode(argv[2], &map);
+    }
+    return 0;
+}
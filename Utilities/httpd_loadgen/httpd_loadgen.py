@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+httpd_loadgen: HTTP/1.1 load generator for the lwIP webserver demos.
+
+Opens a number of concurrent connections to the board, sends GET requests
+over them (optionally pipelined and with keep-alive disabled for comparison)
+and reports requests per second, bytes per second, the number of TCP
+connections used and latency percentiles.
+
+Example:
+    httpd_loadgen.py 192.168.0.10 -c 6 -n 600 -p 4 /home.html /LED.html /gd_bz.gif
+    httpd_loadgen.py 192.168.0.10 -c 6 -n 600 --close /home.html
+
+Responses without Content-Length (SSI pages) are read until the server closes
+the connection, after which a new connection is opened.
+"""
+
+import argparse
+import asyncio
+import itertools
+import sys
+import time
+
+
+class Stats:
+    def __init__(self):
+        self.latencies = []
+        self.bytes = 0
+        self.connections = 0
+        self.errors = 0
+        self.status = {}
+
+
+def build_request(host, path, args):
+    lines = ["GET %s HTTP/1.1" % path, "Host: %s" % host]
+    if args.gzip:
+        lines.append("Accept-Encoding: gzip, deflate")
+    if args.close:
+        lines.append("Connection: close")
+    return ("\r\n".join(lines) + "\r\n\r\n").encode()
+
+
+async def read_response(reader):
+    """Read one response, return (status, body length, server closed)."""
+    header = await reader.readuntil(b"\r\n\r\n")
+    lines = header.decode("latin-1").split("\r\n")
+    status = int(lines[0].split()[1])
+    length = None
+    close = False
+    for line in lines[1:]:
+        name, _, value = line.partition(":")
+        name = name.strip().lower()
+        if name == "content-length":
+            length = int(value.strip())
+        elif name == "connection" and value.strip().lower() == "close":
+            close = True
+    if status == 304 or (status // 100) == 1:
+        length = 0
+    if length is None:
+        body = await reader.read()
+        return status, len(header) + len(body), True
+    await reader.readexactly(length)
+    return status, len(header) + length, close
+
+
+async def worker(args, paths, stats, counter):
+    reader = writer = None
+    pending = []
+    while True:
+        # keep up to 'pipeline' requests in flight on this connection
+        while len(pending) < args.pipeline:
+            n = next(counter)
+            if n >= args.requests:
+                break
+            if reader is None:
+                reader, writer = await asyncio.open_connection(args.host, args.port)
+                stats.connections += 1
+            path = paths[n % len(paths)]
+            writer.write(build_request(args.host, path, args))
+            pending.append(time.perf_counter())
+            if args.close:
+                break
+        if not pending:
+            break
+        try:
+            await writer.drain()
+            status, size, closed = await read_response(reader)
+        except (asyncio.IncompleteReadError, ConnectionError):
+            stats.errors += len(pending)
+            pending = []
+            closed = True
+        else:
+            stats.latencies.append(time.perf_counter() - pending.pop(0))
+            stats.bytes += size
+            stats.status[status] = stats.status.get(status, 0) + 1
+        if closed or args.close:
+            # requests still queued on a closed connection are lost
+            stats.errors += len(pending)
+            pending = []
+            writer.close()
+            reader = writer = None
+    if writer is not None:
+        writer.close()
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    k = min(len(values) - 1, int(round(pct / 100.0 * (len(values) - 1))))
+    return values[k]
+
+
+async def run(args):
+    stats = Stats()
+    counter = itertools.count()
+    start = time.perf_counter()
+    await asyncio.wait_for(
+        asyncio.gather(*(worker(args, args.paths, stats, counter) for _ in range(args.connections))),
+        timeout=args.timeout)
+    elapsed = time.perf_counter() - start
+    return stats, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("host")
+    parser.add_argument("paths", nargs="*", default=["/"])
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("-c", "--connections", type=int, default=4)
+    parser.add_argument("-n", "--requests", type=int, default=400)
+    parser.add_argument("-p", "--pipeline", type=int, default=1,
+                        help="requests in flight per connection")
+    parser.add_argument("--close", action="store_true",
+                        help="one request per connection (HTTP/1.0 style)")
+    parser.add_argument("--gzip", action="store_true", help="send Accept-Encoding: gzip")
+    parser.add_argument("--timeout", type=float, default=120.0)
+    args = parser.parse_intermixed_args()
+
+    try:
+        stats, elapsed = asyncio.run(run(args))
+    except asyncio.TimeoutError:
+        sys.exit("httpd_loadgen: timed out")
+
+    lat = sorted(stats.latencies)
+    done = len(lat)
+    print("requests:     %d ok, %d failed, %d connections" % (done, stats.errors, stats.connections))
+    print("status:       %s" % ", ".join("%d x%d" % kv for kv in sorted(stats.status.items())))
+    print("throughput:   %.1f req/s, %.1f KiB/s" % (done / elapsed, stats.bytes / elapsed / 1024.0))
+    print("latency (ms): p50 %.2f  p90 %.2f  p99 %.2f  max %.2f" % (
+        percentile(lat, 50) * 1e3, percentile(lat, 90) * 1e3,
+        percentile(lat, 99) * 1e3, (lat[-1] if lat else 0.0) * 1e3))
+
+
+if __name__ == "__main__":
+    main()
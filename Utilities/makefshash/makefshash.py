@@ -0,0 +1,375 @@
+#!/usr/bin/env python3
+"""
+makefshash: converts a directory of web assets into a hashed, precompressed
+file system image (fsdata_hash.c) for the lwIP raw-API httpd.
+
+For every file the generator emits:
+  - the identity body with a pre-rendered HTTP header in front of it,
+  - a gzip variant (header + compressed body), and optionally a deflate one,
+    if it shrinks the file by at least --min-gain percent,
+  - a pre-rendered "304 Not Modified" response carrying the file's ETag.
+
+SSI files (and .json files) that contain tags are precompiled into templates:
+the tags are cut out of the body and replaced by a chunk table of
+(static run length, tag slot) pairs, so httpd never scans the file at
+runtime. A tag may carry a fixed width, <!--#name:W-->; the insert is then
+padded or truncated to W bytes. If every tag of a template has a width, the
+response length is known here and the header gets a Content-Length, which
+allows keep-alive; otherwise the template is sent with "Connection: close".
+
+The lookup index is a minimal perfect hash (hash-and-displace): the name is
+hashed once with 32-bit FNV-1a, the bucket's displacement is mixed in and the
+result selects exactly one slot, so fs_open() needs one hash and one strcmp
+regardless of the number of files. The hash functions must match
+fs_hash_name()/FS_HASH_SLOT() in fsdata.h.
+
+Usage: makefshash.py <webdir> [-o fsdata_hash.c] [-11] [--min-gain PCT]
+                     [--no-compress] [--deflate] [--max-age SECONDS]
+"""
+
+import argparse
+import gzip
+import os
+import re
+import sys
+import zlib
+
+FNV_OFFSET = 0x811C9DC5
+FNV_PRIME = 0x01000193
+MIX_MULT = 0x9E3779B1
+
+SERVER_AGENT = "lwIP/2.1.2 (http://savannah.nongnu.org/projects/lwip)"
+
+CONTENT_TYPES = {
+    "html": "text/html",
+    "htm": "text/html",
+    "shtml": "text/html",
+    "shtm": "text/html",
+    "ssi": "text/html",
+    "gif": "image/gif",
+    "png": "image/png",
+    "jpg": "image/jpeg",
+    "jpeg": "image/jpeg",
+    "bmp": "image/bmp",
+    "ico": "image/x-icon",
+    "class": "application/octet-stream",
+    "cls": "application/octet-stream",
+    "js": "application/javascript",
+    "json": "application/json",
+    "css": "text/css",
+    "svg": "image/svg+xml",
+    "xml": "text/xml",
+    "xsl": "text/xml",
+}
+
+SSI_EXTENSIONS = ("shtml", "shtm", "ssi", "xml")
+# files scanned for tags at build time
+TEMPLATE_EXTENSIONS = SSI_EXTENSIONS + ("json",)
+
+SSI_TAG = re.compile(rb"<!--#\s*([A-Za-z0-9_]+)(?::([0-9]+))?\s*-->")
+# limits of httpd (LWIP_HTTPD_MAX_TAG_NAME_LEN, u8_t width, u16_t run length)
+MAX_TAG_NAME_LEN = 8
+MAX_TAG_WIDTH = 255
+MAX_RUN_LEN = 0xFFFF
+# FS_SSI_NO_TAG in fs.h
+NO_TAG = 0xFF
+
+# index order must match FS_ENCODING_* in fs.h
+ENCODINGS = ("identity", "gzip", "deflate")
+
+
+def fnv1a(data):
+    h = FNV_OFFSET
+    for b in data:
+        h = ((h ^ b) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def hash_slot(h, disp, slots):
+    return ((((h ^ disp) * MIX_MULT) & 0xFFFFFFFF) >> 16) % slots
+
+
+def build_perfect_hash(names):
+    """Return (buckets, displacement table, slot -> name index)."""
+    n = len(names)
+    nbuckets = max(1, (n + 1) // 2)
+    hashes = [fnv1a(name.encode()) for name in names]
+    groups = [[] for _ in range(nbuckets)]
+    for i, h in enumerate(hashes):
+        groups[h % nbuckets].append(i)
+
+    disp = [0] * nbuckets
+    slot_of = [None] * n
+    # place the largest buckets first, they are the hardest to fit
+    for b in sorted(range(nbuckets), key=lambda b: -len(groups[b])):
+        if not groups[b]:
+            continue
+        for d in range(0x10000):
+            slots = [hash_slot(hashes[i], d, n) for i in groups[b]]
+            if len(set(slots)) != len(slots):
+                continue
+            if any(slot_of[s] is not None for s in slots):
+                continue
+            for i, s in zip(groups[b], slots):
+                slot_of[s] = i
+            disp[b] = d
+            break
+        else:
+            sys.exit("makefshash: no displacement found for bucket %d" % b)
+    return nbuckets, disp, slot_of
+
+
+def c_ident(name):
+    return "".join(c if c.isalnum() else "_" for c in name)
+
+
+def status_line(name, http11):
+    version = "HTTP/1.1" if http11 else "HTTP/1.0"
+    if "404" in name:
+        return version + " 404 File not found"
+    if "400" in name:
+        return version + " 400 Bad Request"
+    if "501" in name:
+        return version + " 501 Not Implemented"
+    return version + " 200 OK"
+
+
+def render_header(name, ext, body_len, encoding, etag, args, compressible, dynamic):
+    """body_len is None if the length is only known at runtime."""
+    lines = [status_line(name, args.http11), "Server: " + SERVER_AGENT]
+    lines.append("Content-Type: " + CONTENT_TYPES.get(ext, "text/plain"))
+    if body_len is not None:
+        lines.append("Content-Length: %d" % body_len)
+    if encoding != "identity":
+        lines.append("Content-Encoding: " + encoding)
+    if compressible:
+        lines.append("Vary: Accept-Encoding")
+    if dynamic:
+        lines.append("Cache-Control: no-cache")
+    elif etag is not None:
+        lines.append("ETag: " + etag)
+        lines.append("Cache-Control: max-age=%d" % args.max_age)
+    if args.http11:
+        # last line: httpd sends "close" for "keep-alive" if the connection ends with this response
+        lines.append("Connection: close" if body_len is None else "Connection: keep-alive")
+    return ("\r\n".join(lines) + "\r\n\r\n").encode()
+
+
+def tokenize_template(name, body, tag_ids):
+    """Split body into static text and tag slots.
+
+    Returns (static body, [(run length, tag id, width)], runtime length or None).
+    Run lengths count static bytes in front of the slot; the last entry
+    carries NO_TAG. tag_ids maps tag names to indices and is extended here.
+    """
+    static = bytearray()
+    chunks = []
+    fixed = True
+    pos = 0
+    for m in SSI_TAG.finditer(body):
+        tag = m.group(1).decode()
+        if len(tag) > MAX_TAG_NAME_LEN:
+            sys.exit("makefshash: %s: tag '%s' longer than %d characters" % (name, tag, MAX_TAG_NAME_LEN))
+        width = int(m.group(2)) if m.group(2) else 0
+        if width > MAX_TAG_WIDTH:
+            sys.exit("makefshash: %s: width of tag '%s' exceeds %d" % (name, tag, MAX_TAG_WIDTH))
+        if width == 0:
+            fixed = False
+        if tag not in tag_ids:
+            if len(tag_ids) >= NO_TAG:
+                sys.exit("makefshash: too many distinct SSI tags")
+            tag_ids[tag] = len(tag_ids)
+        chunks.append([m.start() - pos, tag_ids[tag], width])
+        static += body[pos:m.start()]
+        pos = m.end()
+    chunks.append([len(body) - pos, NO_TAG, 0])
+    static += body[pos:]
+    length = len(static) + sum(c[2] for c in chunks) if fixed else None
+    return bytes(static), chunks, length
+
+
+def split_long_runs(chunks):
+    """Runs are u16_t; split longer ones with tag-less chunks."""
+    out = []
+    for run, tag, width in chunks:
+        while run > MAX_RUN_LEN:
+            out.append([MAX_RUN_LEN, NO_TAG, 0])
+            run -= MAX_RUN_LEN
+        out.append([run, tag, width])
+    return out
+
+
+def render_not_modified(etag, args):
+    version = "HTTP/1.1" if args.http11 else "HTTP/1.0"
+    lines = [version + " 304 Not Modified", "Server: " + SERVER_AGENT,
+             "ETag: " + etag, "Cache-Control: max-age=%d" % args.max_age]
+    if args.http11:
+        lines.append("Content-Length: 0")
+        # last line, see render_header()
+        lines.append("Connection: keep-alive")
+    return ("\r\n".join(lines) + "\r\n\r\n").encode()
+
+
+def c_array(out, ident, data, comment):
+    out.append("static const unsigned char %s[] = {" % ident)
+    out.append("    /* %s (%d bytes) */" % (comment, len(data)))
+    for i in range(0, len(data), 16):
+        out.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+
+
+def collect_files(webdir):
+    files = []
+    for root, dirs, names in os.walk(webdir):
+        dirs.sort()
+        for fname in sorted(names):
+            path = os.path.join(root, fname)
+            rel = os.path.relpath(path, webdir).replace(os.sep, "/")
+            files.append(("/" + rel, path))
+    return files
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("webdir")
+    parser.add_argument("-o", "--output", default="fsdata_hash.c")
+    parser.add_argument("-11", dest="http11", action="store_true",
+                        help="render HTTP/1.1 keep-alive headers")
+    parser.add_argument("--min-gain", type=int, default=10,
+                        help="minimum size reduction (percent) to keep a compressed variant")
+    parser.add_argument("--no-compress", action="store_true")
+    parser.add_argument("--deflate", action="store_true",
+                        help="also emit zlib/deflate variants (gzip is always preferred)")
+    parser.add_argument("--max-age", type=int, default=3600)
+    args = parser.parse_args()
+
+    files = collect_files(args.webdir)
+    if not files:
+        sys.exit("makefshash: no files in %s" % args.webdir)
+    if len(files) > 0xFFFF:
+        sys.exit("makefshash: too many files")
+
+    names = [name for name, _ in files]
+    nbuckets, disp, slot_of = build_perfect_hash(names)
+
+    out = []
+    out.append("/* Generated by Utilities/makefshash/makefshash.py - do not edit. */")
+    out.append('#include "fs.h"')
+    out.append('#include "lwip/def.h"')
+    out.append('#include "fsdata.h"')
+    out.append("")
+    out.append("")
+
+    entries = {}
+    tag_ids = {}
+    total_identity = 0
+    total_best = 0
+    for index, (name, path) in enumerate(files):
+        with open(path, "rb") as f:
+            body = f.read()
+        ident = c_ident(name)
+        ext = name.rsplit(".", 1)[-1].lower() if "." in name else ""
+        chunks = None
+        length = len(body)
+        if ext in TEMPLATE_EXTENSIONS and SSI_TAG.search(body):
+            body, chunks, length = tokenize_template(name, body, tag_ids)
+        # an .shtml file without tags is served like any static file
+        dynamic = chunks is not None
+        etag = None if (dynamic or "404" in name) else '"%08x"' % (zlib.crc32(body) & 0xFFFFFFFF)
+
+        variants = {"identity": body}
+        # templates are spliced at runtime and must stay uncompressed
+        if not args.no_compress and not dynamic:
+            limit = len(body) * (100 - args.min_gain) // 100
+            gz = gzip.compress(body, 9, mtime=0)
+            if len(gz) < limit:
+                variants["gzip"] = gz
+            df = zlib.compress(body, 9)
+            if args.deflate and len(df) < limit:
+                variants["deflate"] = df
+        compressible = len(variants) > 1
+
+        out.append("static const unsigned char name_%s[] = \"%s\";" % (ident, name))
+        out.append("")
+        arrays = {}
+        for enc in ENCODINGS:
+            if enc not in variants:
+                continue
+            body_len = length if dynamic else len(variants[enc])
+            header = render_header(name, ext, body_len, enc, etag, args, compressible, dynamic)
+            c_array(out, "data_%s_%s" % (ident, enc), header + variants[enc], "%s, %s" % (name, enc))
+            arrays[enc] = "data_%s_%s" % (ident, enc)
+        if etag is not None:
+            c_array(out, "nm_%s" % ident, render_not_modified(etag, args), "%s, 304" % name)
+        if dynamic:
+            # the first run also covers the pre-rendered header
+            chunks[0][0] += len(header)
+            chunks = split_long_runs(chunks)
+            names_by_id = dict((v, k) for k, v in tag_ids.items())
+            out.append("static const struct fsdata_ssi_chunk tmpl_%s[] = {" % ident)
+            for run, tag, width in chunks:
+                if tag == NO_TAG:
+                    out.append("    { %d, FS_SSI_NO_TAG, 0 }," % run)
+                else:
+                    out.append("    { %d, %d, %d }, /* %s */" % (run, tag, width, names_by_id[tag]))
+            out.append("};")
+            out.append("")
+        entries[index] = (ident, arrays, etag, chunks)
+        total_identity += len(body)
+        total_best += min(len(v) for v in variants.values())
+
+    out.append("const struct fsdata_hash_file fs_hash_files[] = {")
+    for slot, index in enumerate(slot_of):
+        ident, arrays, etag, chunks = entries[index]
+        out.append("    /* slot %d: %s */" % (slot, files[index][0]))
+        out.append("    {")
+        out.append("        name_%s," % ident)
+        out.append("        {")
+        for enc in ENCODINGS:
+            if enc in arrays:
+                out.append("            { %s, sizeof(%s) }," % (arrays[enc], arrays[enc]))
+            else:
+                out.append("            { NULL, 0 },")
+        out.append("        },")
+        if etag is not None:
+            out.append("        nm_%s, sizeof(nm_%s)," % (ident, ident))
+            out.append("        \"%s\", %d," % (etag.replace('"', '\\"'), len(etag)))
+        else:
+            out.append("        NULL, 0,")
+            out.append("        NULL, 0,")
+        if chunks is not None:
+            out.append("        tmpl_%s, %d," % (ident, len(chunks)))
+        else:
+            out.append("        NULL, 0,")
+        out.append("        1,")
+        out.append("    },")
+    out.append("};")
+    out.append("")
+    out.append("/* SSI tag names referenced by the templates, indexed by fsdata_ssi_chunk.tag */")
+    out.append("const char *const fs_ssi_tag_names[] = {")
+    for tag in sorted(tag_ids, key=tag_ids.get):
+        out.append("    \"%s\"," % tag)
+    out.append("    NULL")
+    out.append("};")
+    out.append("")
+    out.append("const u16_t fs_hash_disp[] = {")
+    for i in range(0, nbuckets, 8):
+        out.append("    " + ", ".join("%d" % d for d in disp[i:i + 8]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("#define FS_HASH_BUCKETS     %d" % nbuckets)
+    out.append("#define FS_HASH_SLOTS       %d" % len(files))
+    out.append("#define FS_NUMFILES         %d" % len(files))
+    out.append("#define FS_SSI_NUMTAGS      %d" % len(tag_ids))
+    out.append("")
+
+    with open(args.output, "w", newline="\n") as f:
+        f.write("\n".join(out))
+
+    print("makefshash: %d files, %d buckets, %d -> %d bytes on the wire (best encodings)"
+          % (len(files), nbuckets, total_identity, total_best))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""
+rtos_trace_decode: decoder for the FreeRTOS run-time statistics and trace dumps.
+
+The firmware (rtos_trace.c) exports one text dump per statistics window,
+either on the USART or as UDP datagrams:
+
+    # rtos_trace 1 hz=<timer Hz> now=<counter> window=<ticks> tasks=<n> lost=<n>
+    T <number> <priority> <state> <cpu per mille> <run time> <free stack words> <switches> <name>
+    H <region> <size> <free> <min free> <largest> <free blocks> <frag per mille> <pool size> <pool free> <misses>
+    E <sequence> <timestamp> <type> <id> <arg>
+    # end
+
+This tool collects dumps from a capture file or live from UDP, prints the task
+statistics and turns the events into a timeline of task slices and interrupt
+handler runs, as text or as a Chrome trace-event file (chrome://tracing,
+https://ui.perfetto.dev).
+
+Example:
+    rtos_trace_decode.py --udp 5140 --duration 10 --chrome trace.json
+    rtos_trace_decode.py uart_capture.log --timeline --irq 61=ENET
+"""
+
+import argparse
+import json
+import socket
+import sys
+import time
+
+EVT_TASK_IN = 1
+EVT_ISR_ENTER = 2
+EVT_ISR_EXIT = 3
+EVT_MARK = 4
+EVT_OVERFLOW = 5
+
+# IRQ numbers used by the demos, extend with --irq
+IRQ_NAMES = {61: "ENET", 37: "USART0", 28: "TIMER1", 0xFF: "SysTick"}
+
+# RTOS_TRACE_MARK_xxx ids, the boot marks time the first packet from the scheduler start
+MARK_NAMES = {1: "init task started", 2: "netif up", 3: "first packet sent", 4: "first packet received"}
+
+STATE_NAMES = {"X": "running", "R": "ready", "B": "blocked", "S": "suspended", "D": "deleted"}
+
+
+class Task:
+    def __init__(self, fields):
+        self.number = int(fields[1])
+        self.priority = int(fields[2])
+        self.state = fields[3]
+        self.permille = int(fields[4])
+        self.runtime = int(fields[5])
+        self.stack_free = int(fields[6])
+        self.switches = int(fields[7])
+        self.name = fields[8] if len(fields) > 8 else "task%d" % self.number
+
+
+class Heap:
+    def __init__(self, fields):
+        self.region = fields[1]
+        (self.size, self.free, self.free_min, self.largest, self.free_blocks, self.frag,
+         self.pool_size, self.pool_free, self.misses) = (int(x) for x in fields[2:11])
+
+
+class Dump:
+    def __init__(self, header):
+        self.info = dict(kv.split("=", 1) for kv in header.split()[3:] if "=" in kv)
+        self.hz = int(self.info.get("hz", 1000000))
+        self.tasks = []
+        self.heaps = []
+        self.events = []
+
+
+class Parser:
+    """Line oriented parser, tolerates unrelated console output between dumps."""
+
+    def __init__(self):
+        self.dumps = []
+        self.current = None
+        self.partial = ""
+
+    def feed(self, text):
+        text = self.partial + text
+        lines = text.split("\n")
+        self.partial = lines.pop()
+        for line in lines:
+            self.line(line.strip("\r"))
+
+    def line(self, line):
+        if line.startswith("# rtos_trace "):
+            self.current = Dump(line)
+        elif self.current is None:
+            return
+        elif line == "# end":
+            self.dumps.append(self.current)
+            self.current = None
+        elif line.startswith("T "):
+            self.current.tasks.append(Task(line.split(None, 8)))
+        elif line.startswith("H "):
+            f = line.split()
+            if len(f) == 11:
+                self.current.heaps.append(Heap(f))
+        elif line.startswith("E "):
+            f = line.split()
+            if len(f) == 6:
+                self.current.events.append(tuple(int(x) for x in f[1:]))
+
+
+def unwrap(events):
+    """Sort by sequence number and extend the 32-bit timestamps to 64 bits."""
+    events = sorted(set(events))
+    out = []
+    base = 0
+    last = None
+    for seq, ts, typ, ident, arg in events:
+        if last is not None:
+            delta = (ts - last) & 0xFFFFFFFF
+            # nested interrupts may record a slightly older timestamp
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            base += delta
+        last = ts
+        out.append((base, seq, typ, ident, arg))
+    return out
+
+
+def build_timeline(events, hz):
+    """Return (slices, marks, gaps); slices are (kind, id, start_us, duration_us)."""
+    to_us = 1e6 / hz
+    slices = []
+    marks = []
+    gaps = []
+    task = None
+    isr_open = {}
+    prev_seq = None
+    for t, seq, typ, ident, arg in events:
+        if prev_seq is not None and seq != prev_seq + 1:
+            # events were lost, do not stretch anything across the hole
+            gaps.append((t * to_us, seq - prev_seq - 1))
+            task = None
+            isr_open.clear()
+        prev_seq = seq
+        if typ == EVT_TASK_IN:
+            if task is not None:
+                slices.append(("task", task[0], task[1] * to_us, (t - task[1]) * to_us))
+            task = (ident, t)
+        elif typ == EVT_ISR_ENTER:
+            isr_open.setdefault(ident, []).append(t)
+        elif typ == EVT_ISR_EXIT:
+            if isr_open.get(ident):
+                start = isr_open[ident].pop()
+                slices.append(("isr", ident, start * to_us, (t - start) * to_us))
+        else:
+            marks.append((typ, ident, arg, t * to_us))
+    slices.sort(key=lambda s: s[2])
+    return slices, marks, gaps
+
+
+def task_names(dumps):
+    names = {}
+    for d in dumps:
+        for t in d.tasks:
+            names[t.number] = t.name
+    return names
+
+
+def print_stats(dump):
+    print("window %s ticks, %s tasks, %s events lost" % (
+        dump.info.get("window", "?"), dump.info.get("tasks", "?"), dump.info.get("lost", "?")))
+    print("  %-3s %-16s %4s %-9s %7s %12s %10s %9s" % (
+        "#", "name", "prio", "state", "cpu %", "run time us", "stack free", "switches"))
+    for t in sorted(dump.tasks, key=lambda t: -t.permille):
+        print("  %-3d %-16s %4d %-9s %7.1f %12d %10d %9d" % (
+            t.number, t.name, t.priority, STATE_NAMES.get(t.state, t.state), t.permille / 10.0,
+            t.runtime * 1000000 // dump.hz, t.stack_free, t.switches))
+    if dump.heaps:
+        print("  %-6s %8s %8s %10s %8s %7s %6s %9s %9s %6s" % (
+            "heap", "size", "free", "high-water", "largest", "blocks", "frag %", "pool", "pool free", "misses"))
+    for h in dump.heaps:
+        print("  %-6s %8d %8d %10d %8d %7d %6.1f %9d %9d %6d" % (
+            h.region, h.size, h.free, h.size - h.free_min, h.largest, h.free_blocks, h.frag / 10.0,
+            h.pool_size, h.pool_free, h.misses))
+
+
+def print_summary(slices, names, irq_names):
+    groups = {}
+    for kind, ident, start, dur in slices:
+        groups.setdefault((kind, ident), []).append(dur)
+    print("  %-20s %8s %10s %10s %10s" % ("slice", "count", "min us", "avg us", "max us"))
+    for (kind, ident), durs in sorted(groups.items()):
+        label = names.get(ident, "task%d" % ident) if kind == "task" else \
+            "ISR " + irq_names.get(ident, "IRQ%d" % ident)
+        print("  %-20s %8d %10.1f %10.1f %10.1f" % (
+            label, len(durs), min(durs), sum(durs) / len(durs), max(durs)))
+
+
+def print_timeline(slices, marks, gaps, names, irq_names):
+    rows = [(start, "%-4s %-16s %10.1f us" % (
+        kind, names.get(ident, "task%d" % ident) if kind == "task" else irq_names.get(ident, "IRQ%d" % ident),
+        dur)) for kind, ident, start, dur in slices]
+    rows += [(t, "mark %s arg %d" % (MARK_NAMES.get(ident, ident), arg) if typ == EVT_MARK else
+              "mark type %d id %d arg %d" % (typ, ident, arg)) for typ, ident, arg, t in marks]
+    rows += [(t, "---- %d events lost ----" % n) for t, n in gaps]
+    rows.sort(key=lambda r: r[0])
+    for t, text in rows:
+        print("%14.1f  %s" % (t, text))
+
+
+def chrome_trace(slices, marks, names, irq_names):
+    trace = []
+    for kind, ident, start, dur in slices:
+        if kind == "task":
+            trace.append({"name": names.get(ident, "task%d" % ident), "ph": "X", "pid": 1,
+                          "tid": 1, "ts": start, "dur": dur})
+        else:
+            trace.append({"name": irq_names.get(ident, "IRQ%d" % ident), "ph": "X", "pid": 1,
+                          "tid": 2, "ts": start, "dur": dur})
+    for typ, ident, arg, t in marks:
+        name = "stack overflow %s" % names.get(ident, ident) if typ == EVT_OVERFLOW else \
+            "mark %s" % MARK_NAMES.get(ident, ident)
+        trace.append({"name": name, "ph": "i", "s": "g", "pid": 1, "tid": 1, "ts": t,
+                      "args": {"arg": arg}})
+    trace.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "tasks"}})
+    trace.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": 2, "args": {"name": "interrupts"}})
+    return {"traceEvents": trace, "displayTimeUnit": "ns"}
+
+
+def capture_udp(parser, port, duration):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", port))
+    sock.settimeout(0.5)
+    end = time.monotonic() + duration if duration else None
+    try:
+        while end is None or time.monotonic() < end:
+            try:
+                data, _ = sock.recvfrom(2048)
+            except socket.timeout:
+                continue
+            parser.feed(data.decode("latin-1"))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("files", nargs="*", help="captured USART or UDP output")
+    parser.add_argument("--udp", type=int, metavar="PORT", help="receive dumps live on this UDP port")
+    parser.add_argument("--duration", type=float, default=0.0,
+                        help="seconds to receive with --udp (default: until Ctrl-C)")
+    parser.add_argument("--irq", action="append", default=[], metavar="N=NAME",
+                        help="name an IRQ number in the output")
+    parser.add_argument("--all", action="store_true", help="print the statistics of every dump")
+    parser.add_argument("--timeline", action="store_true", help="print the timeline as text")
+    parser.add_argument("--chrome", metavar="FILE", help="write a Chrome trace-event JSON file")
+    args = parser.parse_args()
+
+    irq_names = dict(IRQ_NAMES)
+    for item in args.irq:
+        num, _, name = item.partition("=")
+        irq_names[int(num, 0)] = name
+
+    p = Parser()
+    if args.udp:
+        capture_udp(p, args.udp, args.duration)
+    for name in args.files:
+        with open(name, "r", encoding="latin-1") as f:
+            p.feed(f.read())
+    p.feed("\n")
+    if not p.dumps:
+        sys.exit("rtos_trace_decode: no complete dump found")
+
+    for d in (p.dumps if args.all else p.dumps[-1:]):
+        print_stats(d)
+        print()
+
+    names = task_names(p.dumps)
+    events = unwrap(e for d in p.dumps for e in d.events)
+    slices, marks, gaps = build_timeline(events, p.dumps[-1].hz)
+    print("%d dumps, %d events, %d gaps" % (len(p.dumps), len(events), len(gaps)))
+    print_summary(slices, names, irq_names)
+    for typ, ident, arg, t in marks:
+        if typ == EVT_OVERFLOW:
+            print("stack overflow in %s at %.1f us" % (names.get(ident, "task%d" % ident), t))
+
+    if args.timeline:
+        print()
+        print_timeline(slices, marks, gaps, names, irq_names)
+    if args.chrome:
+        with open(args.chrome, "w") as f:
+            json.dump(chrome_trace(slices, marks, names, irq_names), f)
+        print("wrote %s" % args.chrome)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,81 @@
+/*
+ * uart_log_host.h: the part of the GD32F4xx firmware library and CMSIS that
+ * uart_log.c uses, for building it on a PC with -DUART_LOG_HOST.
+ *
+ * The exclusive accesses, the barrier, the exception state, the DMA channel
+ * and the USART are implemented by uart_log_stress.c.
+ */
+
+#ifndef UART_LOG_HOST_H
+#define UART_LOG_HOST_H
+
+#include <stdint.h>
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus;
+
+typedef struct {
+    uint32_t periph_addr;
+    uint32_t periph_inc;
+    uint32_t memory0_addr;
+    uint32_t memory_inc;
+    uint32_t periph_memory_width;
+    uint32_t circular_mode;
+    uint32_t direction;
+    uint32_t number;
+    uint32_t priority;
+} dma_single_data_parameter_struct;
+
+#define DMA1                            1U
+#define DMA_CH7                         7U
+#define DMA_SUBPERI4                    4U
+#define DMA1_Channel7_IRQn              70
+#define DMA_MEMORY_0                    0U
+#define DMA_MEMORY_TO_PERIPH            0x40U
+#define DMA_MEMORY_INCREASE_ENABLE      0x400U
+#define DMA_PERIPH_INCREASE_DISABLE     0U
+#define DMA_PERIPH_WIDTH_8BIT           0U
+#define DMA_PRIORITY_LOW                0U
+#define DMA_FLAG_FEE                    0x01U
+#define DMA_FLAG_SDE                    0x04U
+#define DMA_FLAG_TAE                    0x08U
+#define DMA_FLAG_HTF                    0x10U
+#define DMA_FLAG_FTF                    0x20U
+#define DMA_INT_FTF                     0x10U
+#define DMA_INT_FLAG_FTF                0x20U
+#define RCU_DMA1                        22U
+#define USART_TRANSMIT_DMA_ENABLE       0x80U
+#define USART_FLAG_TC                   6U
+
+#define EVAL_COM0                       0U
+#define USART_DATA(usartx)              (host_usart_data[usartx])
+
+extern volatile uint32_t host_usart_data[1];
+
+/* exclusives, barrier and exception state of the Cortex-M4 */
+uint32_t __LDREXW(volatile uint32_t *addr);
+uint32_t __STREXW(uint32_t value, volatile uint32_t *addr);
+void __CLREX(void);
+void __DMB(void);
+uint32_t __get_IPSR(void);
+uint32_t __get_PRIMASK(void);
+
+/* the TX DMA channel and the USART */
+void rcu_periph_clock_enable(uint32_t periph);
+void dma_deinit(uint32_t dma_periph, uint32_t channelx);
+void dma_single_data_para_struct_init(dma_single_data_parameter_struct *init_struct);
+void dma_single_data_mode_init(uint32_t dma_periph, uint32_t channelx, dma_single_data_parameter_struct *init_struct);
+void dma_channel_subperipheral_select(uint32_t dma_periph, uint32_t channelx, uint32_t sub_periph);
+void dma_circulation_disable(uint32_t dma_periph, uint32_t channelx);
+void dma_interrupt_enable(uint32_t dma_periph, uint32_t channelx, uint32_t source);
+void dma_channel_disable(uint32_t dma_periph, uint32_t channelx);
+void dma_channel_enable(uint32_t dma_periph, uint32_t channelx);
+void dma_flag_clear(uint32_t dma_periph, uint32_t channelx, uint32_t flag);
+void dma_memory_address_config(uint32_t dma_periph, uint32_t channelx, uint8_t memory_flag, uint32_t address);
+void dma_transfer_number_config(uint32_t dma_periph, uint32_t channelx, uint32_t number);
+FlagStatus dma_interrupt_flag_get(uint32_t dma_periph, uint32_t channelx, uint32_t interrupt);
+void dma_interrupt_flag_clear(uint32_t dma_periph, uint32_t channelx, uint32_t interrupt);
+void nvic_irq_enable(int nvic_irq, uint8_t nvic_irq_pre_priority, uint8_t nvic_irq_sub_priority);
+void usart_dma_transmit_config(uint32_t usart_periph, uint32_t dmacmd);
+FlagStatus usart_flag_get(uint32_t usart_periph, uint32_t flag);
+
+#endif /* UART_LOG_HOST_H */
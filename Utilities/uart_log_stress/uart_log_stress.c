@@ -0,0 +1,678 @@
+/*
+ * uart_log_stress: multi-producer stress test of the UART log ring on a PC.
+ *
+ * The 04_USART_Printf demo queues log messages from any context into one ring
+ * (uart_log.c) with LDREX/STREX reservations, and a DMA channel drains the
+ * ring into the USART. This tool builds the same source for the host with
+ * UART_LOG_HOST, where the exclusives are compare-and-swap on the reserved
+ * value, and a thread plays the DMA channel: it takes the transfer log_kick()
+ * configured, hands the bytes to a checker and raises the transfer complete
+ * interrupt by calling uart_log_dma_irq_handler() itself.
+ *
+ * Every producer is a thread that sends numbered messages of random length
+ * carrying its number, the sequence number, the length and a pattern that
+ * depends on all three. Some of the producers run as interrupt handlers, for
+ * which the blocking policy drops instead of waiting. The checker verifies
+ * that no message is torn or interleaved with another, and at the end that
+ * every producer's messages arrived in order, that exactly the ones whose
+ * uart_log_write() returned 0 are missing, and that no transfer was started
+ * on a busy channel.
+ *
+ * Before the producers start, the DMA is held while the ring is filled with
+ * messages of a fixed length, which must raise high_water to exactly the
+ * bytes queued and drop exactly the messages that do not fit. After the run
+ * the messages, bytes, dropped, dropped_bytes and dma_transfers counters
+ * must match what the producers and the DMA thread counted, and high_water
+ * must stay within the ring and cover the longest transfer. The exit status
+ * is 1 on the first error.
+ *
+ * The target has one core and the ring relies on that, so all threads are
+ * bound to one CPU. Besides wherever the scheduler preempts them, a thread
+ * gives up the CPU at random exclusive accesses and barriers, which are the
+ * edges of the reservation, the copy and the commit, as an interrupt there
+ * would. The ring address goes to the DMA as 32 bits like on the target,
+ * hence -no-pie.
+ *
+ * Build:
+ *     cc -O2 -Wall -Wno-pointer-to-int-cast -pthread -no-pie -DUART_LOG_HOST -I. \
+ *        -I../../Projects/GD32F450I_EVAL/04_USART_Printf/Application/Core/Inc \
+ *        -o uart_log_stress uart_log_stress.c \
+ *        ../../Projects/GD32F450I_EVAL/04_USART_Printf/Application/Core/Src/uart_log.c
+ *
+ * Example:
+ *     uart_log_stress
+ *     uart_log_stress --producers 8 --isr 2 --messages 200000 --policy block
+ *     uart_log_stress --size 18,3000 --baud 921600 --messages 2000
+ */
+
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "uart_log_host.h"
+#include "uart_log.h"
+
+#define MAX_PRODUCERS   32
+#define MSG_HEAD        17U             /* "pp ssssssss llll " */
+#define MSG_MIN         (MSG_HEAD + 1U)
+#define MSG_MAX         9999U
+#define HOLD_LEN        100U            /* message length while the DMA is held */
+#define MAX_ERRORS      10
+
+typedef struct {
+    pthread_t thread;
+    unsigned id;
+    int isr;
+    uint32_t sent;                      /* messages attempted */
+    uint8_t *queued;                    /* per sequence number: uart_log_write() took it */
+    uint64_t queued_num, queued_bytes;
+    uint64_t dropped_num, dropped_bytes;
+    uint64_t wrong_drops, wrong_returns;
+    uint32_t *recv;                     /* sequence numbers in the order they arrived */
+    uint32_t recv_num;
+    unsigned long long rng;
+} producer_struct;
+
+volatile uint32_t host_usart_data[1];
+
+static producer_struct prod[MAX_PRODUCERS + 1];
+static unsigned producers = 4, isr_producers = 1;
+static uint32_t messages = 100000, size_min = MSG_MIN, size_max = 200;
+static uint32_t policy = UART_LOG_POLICY_DROP;
+static unsigned long baud;
+
+/* the simulated DMA channel */
+static uint32_t dma_addr, dma_number;
+static int dma_enabled, dma_ftf, dma_hold, dma_stop;
+static uint64_t dma_transfers, dma_bytes;
+static uint32_t dma_max;
+
+/* the checker, only run by the DMA thread */
+static char line[MSG_MAX + 1];
+static uint32_t line_len;
+static int errors;
+
+/* reservation of the exclusive monitor and the exception state, per thread */
+static __thread volatile uint32_t *res_addr;
+static __thread uint32_t res_value;
+static __thread uint32_t ipsr;
+static __thread unsigned long long preempt_rng = 2463534242ULL;
+static unsigned preempt = 4;
+
+static void fail(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void fail(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (__atomic_fetch_add(&errors, 1, __ATOMIC_SEQ_CST) < MAX_ERRORS) {
+        va_start(ap, fmt);
+        fputs("uart_log_stress: ", stderr);
+        vfprintf(stderr, fmt, ap);
+        fputc('\n', stderr);
+        va_end(ap);
+    }
+}
+
+/* an interrupt arriving at this instruction, one in preempt times */
+static void preempt_point(void)
+{
+    preempt_rng ^= preempt_rng << 13;
+    preempt_rng ^= preempt_rng >> 7;
+    preempt_rng ^= preempt_rng << 17;
+    if ((preempt != 0) && ((preempt_rng >> 16) % preempt == 0)) {
+        sched_yield();
+    }
+}
+
+uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    res_addr = addr;
+    res_value = __atomic_load_n(addr, __ATOMIC_SEQ_CST);
+    preempt_point();
+    return res_value;
+}
+
+uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t expected = res_value;
+
+    if (res_addr != addr) {
+        return 1;
+    }
+    res_addr = NULL;
+    if (!__atomic_compare_exchange_n(addr, &expected, value, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return 1;
+    }
+    preempt_point();
+    return 0;
+}
+
+void __CLREX(void)
+{
+    res_addr = NULL;
+}
+
+void __DMB(void)
+{
+    preempt_point();
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+uint32_t __get_IPSR(void)
+{
+    return ipsr;
+}
+
+/* only asked by the loops waiting for the DMA, where the interrupt would get the core */
+uint32_t __get_PRIMASK(void)
+{
+    sched_yield();
+    return 0;
+}
+
+void rcu_periph_clock_enable(uint32_t periph)
+{
+    (void)periph;
+}
+
+void dma_deinit(uint32_t dma_periph, uint32_t channelx)
+{
+    (void)dma_periph;
+    (void)channelx;
+}
+
+void dma_single_data_para_struct_init(dma_single_data_parameter_struct *init_struct)
+{
+    memset(init_struct, 0, sizeof(*init_struct));
+}
+
+void dma_single_data_mode_init(uint32_t dma_periph, uint32_t channelx, dma_single_data_parameter_struct *init_struct)
+{
+    (void)dma_periph;
+    (void)channelx;
+    dma_addr = init_struct->memory0_addr;
+    dma_number = init_struct->number;
+}
+
+void dma_channel_subperipheral_select(uint32_t dma_periph, uint32_t channelx, uint32_t sub_periph)
+{
+    (void)dma_periph;
+    (void)channelx;
+    (void)sub_periph;
+}
+
+void dma_circulation_disable(uint32_t dma_periph, uint32_t channelx)
+{
+    (void)dma_periph;
+    (void)channelx;
+}
+
+void dma_interrupt_enable(uint32_t dma_periph, uint32_t channelx, uint32_t source)
+{
+    (void)dma_periph;
+    (void)channelx;
+    (void)source;
+}
+
+void dma_channel_disable(uint32_t dma_periph, uint32_t channelx)
+{
+    (void)dma_periph;
+    (void)channelx;
+    /* disabling a running channel would cut a transfer short */
+    if (__atomic_load_n(&dma_enabled, __ATOMIC_ACQUIRE)) {
+        fail("channel disabled during a transfer");
+    }
+}
+
+void dma_channel_enable(uint32_t dma_periph, uint32_t channelx)
+{
+    (void)dma_periph;
+    (void)channelx;
+    if (dma_number == 0) {
+        fail("transfer of 0 bytes started");
+    }
+    if (__atomic_exchange_n(&dma_enabled, 1, __ATOMIC_ACQ_REL)) {
+        fail("transfer started on a busy channel");
+    }
+}
+
+void dma_flag_clear(uint32_t dma_periph, uint32_t channelx, uint32_t flag)
+{
+    (void)dma_periph;
+    (void)channelx;
+    if (flag & DMA_FLAG_FTF) {
+        __atomic_store_n(&dma_ftf, 0, __ATOMIC_RELEASE);
+    }
+}
+
+void dma_memory_address_config(uint32_t dma_periph, uint32_t channelx, uint8_t memory_flag, uint32_t address)
+{
+    (void)dma_periph;
+    (void)channelx;
+    (void)memory_flag;
+    dma_addr = address;
+}
+
+void dma_transfer_number_config(uint32_t dma_periph, uint32_t channelx, uint32_t number)
+{
+    (void)dma_periph;
+    (void)channelx;
+    dma_number = number;
+}
+
+FlagStatus dma_interrupt_flag_get(uint32_t dma_periph, uint32_t channelx, uint32_t interrupt)
+{
+    (void)dma_periph;
+    (void)channelx;
+    (void)interrupt;
+    return __atomic_load_n(&dma_ftf, __ATOMIC_ACQUIRE) ? SET : RESET;
+}
+
+void dma_interrupt_flag_clear(uint32_t dma_periph, uint32_t channelx, uint32_t interrupt)
+{
+    (void)dma_periph;
+    (void)channelx;
+    (void)interrupt;
+    __atomic_store_n(&dma_ftf, 0, __ATOMIC_RELEASE);
+}
+
+void nvic_irq_enable(int nvic_irq, uint8_t nvic_irq_pre_priority, uint8_t nvic_irq_sub_priority)
+{
+    (void)nvic_irq;
+    (void)nvic_irq_pre_priority;
+    (void)nvic_irq_sub_priority;
+}
+
+void usart_dma_transmit_config(uint32_t usart_periph, uint32_t dmacmd)
+{
+    (void)usart_periph;
+    (void)dmacmd;
+}
+
+FlagStatus usart_flag_get(uint32_t usart_periph, uint32_t flag)
+{
+    (void)usart_periph;
+    (void)flag;
+    return SET;
+}
+
+static unsigned rng(producer_struct *p)
+{
+    p->rng ^= p->rng << 13;
+    p->rng ^= p->rng >> 7;
+    p->rng ^= p->rng << 17;
+    return (unsigned)(p->rng >> 16);
+}
+
+static char pattern(unsigned id, uint32_t seq, uint32_t i)
+{
+    return (char)('a' + (id * 7U + seq * 13U + i) % 26U);
+}
+
+/* "pp ssssssss llll " and a pattern up to the newline */
+static void message_make(char *buf, unsigned id, uint32_t seq, uint32_t len)
+{
+    char head[MSG_HEAD + 1];
+
+    snprintf(head, sizeof(head), "%02u %08" PRIx32 " %04" PRIu32 " ", id, seq, len);
+    memcpy(buf, head, MSG_HEAD);
+    for (uint32_t i = MSG_HEAD; i < len - 1; i++) {
+        buf[i] = pattern(id, seq, i);
+    }
+    buf[len - 1] = '\n';
+}
+
+static int message_check(const char *msg, uint32_t len)
+{
+    unsigned id;
+    uint32_t seq, mlen;
+    int n = 0;
+
+    if ((len < MSG_MIN) || (sscanf(msg, "%2u %8" SCNx32 " %4" SCNu32 "%n", &id, &seq, &mlen, &n) != 3) ||
+            (n != (int)MSG_HEAD - 1) || (msg[n] != ' ') || (mlen != len) || (id > producers)) {
+        return -1;
+    }
+    for (uint32_t i = MSG_HEAD; i < len - 1; i++) {
+        if (msg[i] != pattern(id, seq, i)) {
+            return -1;
+        }
+    }
+    if (prod[id].recv_num >= messages) {
+        return -1;
+    }
+    prod[id].recv[prod[id].recv_num++] = seq;
+    return 0;
+}
+
+static void check_bytes(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (line_len >= MSG_MAX) {
+            fail("torn message, %u bytes without a newline", (unsigned)line_len);
+            line_len = 0;
+        }
+        line[line_len++] = (char)data[i];
+        if (data[i] == '\n') {
+            line[line_len] = '\0';
+            if (message_check(line, line_len) != 0) {
+                fail("torn message of %u bytes: %.40s", (unsigned)line_len, line);
+            }
+            line_len = 0;
+        }
+    }
+}
+
+static void *dma_thread(void *arg)
+{
+    (void)arg;
+    ipsr = 16 + DMA1_Channel7_IRQn;
+
+    while (!__atomic_load_n(&dma_stop, __ATOMIC_ACQUIRE)) {
+        if (!__atomic_load_n(&dma_enabled, __ATOMIC_ACQUIRE) || __atomic_load_n(&dma_hold, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+            continue;
+        }
+
+        check_bytes((const uint8_t *)(uintptr_t)dma_addr, dma_number);
+        dma_transfers++;
+        dma_bytes += dma_number;
+        if (dma_number > dma_max) {
+            dma_max = dma_number;
+        }
+        if (baud != 0) {
+            unsigned long long ns = dma_number * 10ULL * 1000000000ULL / baud;
+            struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+            nanosleep(&ts, NULL);
+        }
+
+        /* transfer complete */
+        __atomic_store_n(&dma_enabled, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&dma_ftf, 1, __ATOMIC_RELEASE);
+        uart_log_dma_irq_handler();
+    }
+    return NULL;
+}
+
+static uint32_t producer_send(producer_struct *p, uint32_t len, char *buf)
+{
+    uint32_t seq = p->sent++, ret;
+
+    message_make(buf, p->id, seq, len);
+    ret = uart_log_write(buf, len);
+    if (ret == len) {
+        p->queued[seq] = 1;
+        p->queued_num++;
+        p->queued_bytes += len;
+    } else if (ret == 0) {
+        p->dropped_num++;
+        p->dropped_bytes += len;
+    } else {
+        p->wrong_returns++;
+    }
+    return ret;
+}
+
+static void *producer_thread(void *arg)
+{
+    producer_struct *p = arg;
+    char buf[MSG_MAX];
+
+    ipsr = p->isr ? 16 + p->id : 0;
+    preempt_rng = p->rng;
+    while (p->sent < messages) {
+        uint32_t len = size_min + rng(p) % (size_max - size_min + 1);
+
+        if (producer_send(p, len, buf) == 0) {
+            /* only interrupts and messages larger than the ring may be dropped while blocking */
+            if ((policy == UART_LOG_POLICY_BLOCK) && !p->isr && (len <= UART_LOG_BUF_SIZE)) {
+                p->wrong_drops++;
+            }
+            /* let the DMA make room before the next one */
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static int hold_check(void)
+{
+    producer_struct *p = &prod[producers];
+    uart_log_stats_struct st;
+    uint32_t fit = UART_LOG_BUF_SIZE / HOLD_LEN, rest = UART_LOG_BUF_SIZE - fit * HOLD_LEN, queued = 0;
+    char buf[UART_LOG_BUF_SIZE];
+
+    __atomic_store_n(&dma_hold, 1, __ATOMIC_RELEASE);
+    while (producer_send(p, HOLD_LEN, buf) != 0) {
+        queued++;
+    }
+    uart_log_stats_get(&st);
+    if ((queued != fit) || (st.messages != fit) || (st.high_water != fit * HOLD_LEN) ||
+            (st.dropped != 1) || (st.dropped_bytes != HOLD_LEN)) {
+        fail("DMA held: %u of %u messages queued, high_water %u, dropped %u of %u bytes",
+             (unsigned)queued, (unsigned)fit, (unsigned)st.high_water, (unsigned)st.dropped, (unsigned)st.dropped_bytes);
+        return -1;
+    }
+    if (rest >= MSG_MIN) {
+        if ((producer_send(p, rest, buf) != rest) || (uart_log_stats_get(&st), st.high_water != UART_LOG_BUF_SIZE)) {
+            fail("DMA held: the last %u bytes of the ring not filled, high_water %u", (unsigned)rest,
+                 (unsigned)st.high_water);
+            return -1;
+        }
+    }
+    if ((producer_send(p, MSG_MIN, buf) != 0) || (uart_log_stats_get(&st), st.dropped != 2)) {
+        fail("DMA held: message queued into a full ring");
+        return -1;
+    }
+    __atomic_store_n(&dma_hold, 0, __ATOMIC_RELEASE);
+    uart_log_flush();
+    return 0;
+}
+
+static void order_check(producer_struct *p)
+{
+    uint32_t k = 0;
+
+    for (uint32_t seq = 0; seq < p->sent; seq++) {
+        if (!p->queued[seq]) {
+            continue;
+        }
+        if (k >= p->recv_num) {
+            fail("producer %u: message %u lost", p->id, (unsigned)seq);
+            return;
+        }
+        if (p->recv[k] != seq) {
+            fail("producer %u: message %u arrived where %u was expected", p->id, (unsigned)p->recv[k], (unsigned)seq);
+            return;
+        }
+        k++;
+    }
+    if (k != p->recv_num) {
+        fail("producer %u: %u messages arrived that were dropped", p->id, (unsigned)(p->recv_num - k));
+    }
+}
+
+static void flush_stalled(int sig)
+{
+    static const char msg[] = "uart_log_stress: the ring did not drain, committed messages left behind\n";
+
+    (void)sig;
+    (void)!write(2, msg, sizeof(msg) - 1);
+    _exit(1);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [options]\n"
+            "  --producers N     producer threads, at most %u (4)\n"
+            "  --isr N           producers running as interrupt handlers (1)\n"
+            "  --messages N      messages per producer (100000)\n"
+            "  --size MIN,MAX    message length, %u to %u (%u,200)\n"
+            "  --policy P        drop or block (drop)\n"
+            "  --preempt N       switch threads at one in N exclusive accesses and barriers, 0 never (4)\n"
+            "  --baud B          pace the DMA like a USART at B baud (unpaced)\n"
+            "  --seed S          random seed\n",
+            name, MAX_PRODUCERS, MSG_MIN, MSG_MAX, MSG_MIN);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long long seed = 88172645463325252ULL;
+    uart_log_stats_struct s0, s1;
+    uint64_t queued = 0, queued_bytes = 0, dropped = 0, dropped_bytes = 0;
+    struct timespec t0, t1;
+    pthread_t dma;
+    cpu_set_t cpus;
+    double sec;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--producers") && (i + 1 < argc)) {
+            producers = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--isr") && (i + 1 < argc)) {
+            isr_producers = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--messages") && (i + 1 < argc)) {
+            messages = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--size") && (i + 1 < argc) &&
+                   (sscanf(argv[i + 1], "%" SCNu32 ",%" SCNu32, &size_min, &size_max) == 2)) {
+            i++;
+        } else if (!strcmp(argv[i], "--policy") && (i + 1 < argc)) {
+            i++;
+            if (!strcmp(argv[i], "block")) {
+                policy = UART_LOG_POLICY_BLOCK;
+            } else if (strcmp(argv[i], "drop")) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "--preempt") && (i + 1 < argc)) {
+            preempt = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--baud") && (i + 1 < argc)) {
+            baud = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && (i + 1 < argc)) {
+            seed = strtoull(argv[++i], NULL, 0) | 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((producers == 0) || (producers > MAX_PRODUCERS) || (isr_producers > producers) || (messages == 0) ||
+            (messages > 0x10000000U) || (size_min < MSG_MIN) || (size_max < size_min) || (size_max > MSG_MAX)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if ((uintptr_t)&host_usart_data > UINT32_MAX) {
+        fprintf(stderr, "uart_log_stress: data above 4 GB, build with -no-pie\n");
+        return 2;
+    }
+
+    CPU_ZERO(&cpus);
+    CPU_SET(sched_getcpu(), &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+        perror("uart_log_stress: sched_setaffinity");
+        return 2;
+    }
+
+    for (unsigned i = 0; i <= producers; i++) {
+        prod[i].id = i;
+        prod[i].isr = i < isr_producers;
+        prod[i].rng = seed + i * 0x9E3779B97F4A7C15ULL;
+        prod[i].queued = calloc(messages, 1);
+        prod[i].recv = calloc(messages, sizeof(uint32_t));
+        if ((prod[i].queued == NULL) || (prod[i].recv == NULL)) {
+            fprintf(stderr, "uart_log_stress: out of memory\n");
+            return 2;
+        }
+    }
+
+    uart_log_init();
+    pthread_create(&dma, NULL, dma_thread, NULL);
+    if ((messages >= UART_LOG_BUF_SIZE / HOLD_LEN + 3) && (hold_check() != 0)) {
+        __atomic_store_n(&dma_hold, 0, __ATOMIC_RELEASE);
+    }
+    uart_log_stats_get(&s0);
+
+    uart_log_policy_set(policy);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (unsigned i = 0; i < producers; i++) {
+        pthread_create(&prod[i].thread, NULL, producer_thread, &prod[i]);
+    }
+    for (unsigned i = 0; i < producers; i++) {
+        pthread_join(prod[i].thread, NULL);
+    }
+    /* a message committed without a DMA transfer to pick it up would hang here */
+    signal(SIGALRM, flush_stalled);
+    alarm(10 + (unsigned)((baud != 0) ? UART_LOG_BUF_SIZE * 10ULL / baud : 0));
+    uart_log_flush();
+    alarm(0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    __atomic_store_n(&dma_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(dma, NULL);
+    uart_log_stats_get(&s1);
+    sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    if (line_len != 0) {
+        fail("%u bytes of an unfinished message at the end", (unsigned)line_len);
+    }
+    for (unsigned i = 0; i <= producers; i++) {
+        order_check(&prod[i]);
+        if (i < producers) {
+            queued += prod[i].queued_num;
+            queued_bytes += prod[i].queued_bytes;
+            dropped += prod[i].dropped_num;
+            dropped_bytes += prod[i].dropped_bytes;
+        }
+        if (prod[i].wrong_returns != 0) {
+            fail("producer %u: uart_log_write() returned neither 0 nor the length", i);
+        }
+    }
+
+    if ((s1.messages - s0.messages != queued) || (s1.bytes - s0.bytes != queued_bytes)) {
+        fail("messages %u bytes %u counted, %" PRIu64 " and %" PRIu64 " queued",
+             (unsigned)(s1.messages - s0.messages), (unsigned)(s1.bytes - s0.bytes), queued, queued_bytes);
+    }
+    if ((s1.dropped - s0.dropped != dropped) || (s1.dropped_bytes - s0.dropped_bytes != dropped_bytes)) {
+        fail("dropped %u of %u bytes counted, %" PRIu64 " of %" PRIu64 " dropped",
+             (unsigned)(s1.dropped - s0.dropped), (unsigned)(s1.dropped_bytes - s0.dropped_bytes), dropped,
+             dropped_bytes);
+    }
+    if ((s1.dma_transfers != dma_transfers) || ((uint64_t)s1.bytes != dma_bytes)) {
+        fail("dma_transfers %u counted, %" PRIu64 " transfers of %" PRIu64 " bytes done, %u bytes queued",
+             (unsigned)s1.dma_transfers, dma_transfers, dma_bytes, (unsigned)s1.bytes);
+    }
+    if ((s1.high_water > UART_LOG_BUF_SIZE) || (s1.high_water < dma_max)) {
+        fail("high_water %u with a ring of %u bytes and a transfer of %u", (unsigned)s1.high_water,
+             UART_LOG_BUF_SIZE, (unsigned)dma_max);
+    }
+    if (policy == UART_LOG_POLICY_DROP) {
+        if (s1.blocked != 0) {
+            fail("%u messages blocked with the drop policy", (unsigned)s1.blocked);
+        }
+    } else {
+        for (unsigned i = isr_producers; i < producers; i++) {
+            if (prod[i].wrong_drops != 0) {
+                fail("producer %u: %" PRIu64 " messages dropped in thread mode with the block policy", i,
+                     prod[i].wrong_drops);
+            }
+        }
+    }
+
+    printf("%u producers (%u as interrupts), %s policy, %.2f s\n", producers, isr_producers,
+           (policy == UART_LOG_POLICY_BLOCK) ? "block" : "drop", sec);
+    printf("%" PRIu64 " messages queued, %" PRIu64 " dropped, %u blocked, %.0f messages/s, %.1f MB/s\n", queued,
+           dropped, (unsigned)(s1.blocked - s0.blocked), (double)queued / sec, (double)queued_bytes / sec / 1e6);
+    printf("%u DMA transfers of %.1f bytes on average, at most %u, high_water %u of %u\n",
+           (unsigned)s1.dma_transfers, (double)dma_bytes / (double)(dma_transfers ? dma_transfers : 1),
+           (unsigned)dma_max, (unsigned)s1.high_water, UART_LOG_BUF_SIZE);
+    if (errors != 0) {
+        return 1;
+    }
+    printf("no message torn, reordered or lost, counters match\n");
+    return 0;
+}
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+udp_pps: measures the echo rate of the UDP echo demos in packets per second.
+
+The tool keeps a window of datagrams in flight to the echo port of the board,
+each one carrying a sequence number and its send time, and counts the echoes
+which come back. It prints the echo rate, the loss and the round trip times
+once per second and a summary at the end. Run it once against a build with
+LWIP_TCPIP_CORE_LOCKING=0 and once against the default build to compare the
+message passing and the core locking lwIP ports.
+
+Example:
+    udp_pps.py 192.168.0.10 --window 8 --duration 20
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+HEADER = struct.Struct("<Id")
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100.0))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("host", help="IP address of the board")
+    parser.add_argument("--port", type=int, default=1025, help="UDP echo port (default 1025)")
+    parser.add_argument("--size", type=int, default=32,
+                        help="datagram size, at most 50 for the demo echo buffer (default 32)")
+    parser.add_argument("--window", type=int, default=4, help="datagrams in flight (default 4)")
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds to run (default 10)")
+    parser.add_argument("--timeout", type=float, default=0.2,
+                        help="seconds after which a datagram counts as lost (default 0.2)")
+    args = parser.parse_args()
+
+    if args.size < HEADER.size:
+        sys.exit("udp_pps: --size must be at least %d" % HEADER.size)
+    padding = b"\0" * (args.size - HEADER.size)
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.connect((args.host, args.port))
+    sock.setblocking(False)
+
+    inflight = {}
+    seq = 0
+    total_sent = total_recv = total_lost = 0
+    rtts = []
+    second_recv = 0
+    second_rtts = []
+    start = time.monotonic()
+    next_report = start + 1.0
+
+    try:
+        while True:
+            now = time.monotonic()
+            if now - start >= args.duration:
+                break
+            # refill the window
+            while len(inflight) < args.window:
+                inflight[seq] = now
+                sock.send(HEADER.pack(seq, now) + padding)
+                seq = (seq + 1) & 0xFFFFFFFF
+                total_sent += 1
+            # collect echoes
+            try:
+                while True:
+                    data = sock.recv(2048)
+                    if len(data) < HEADER.size:
+                        continue
+                    rseq, sent = HEADER.unpack_from(data)
+                    if inflight.pop(rseq, None) is None:
+                        continue
+                    rtt = (time.monotonic() - sent) * 1e6
+                    rtts.append(rtt)
+                    second_rtts.append(rtt)
+                    total_recv += 1
+                    second_recv += 1
+            except (BlockingIOError, ConnectionRefusedError):
+                pass
+            # expire lost datagrams
+            now = time.monotonic()
+            for s in [s for s, t in inflight.items() if now - t > args.timeout]:
+                del inflight[s]
+                total_lost += 1
+            if now >= next_report:
+                print("%6.1f s  %7d pps  rtt p50 %7.1f us  p99 %7.1f us  lost %d" % (
+                    now - start, second_recv, percentile(second_rtts, 50), percentile(second_rtts, 99), total_lost))
+                second_recv = 0
+                second_rtts = []
+                next_report += 1.0
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+
+    elapsed = time.monotonic() - start
+    print("sent %d, echoed %d, lost %d in %.1f s: %.0f pps, rtt p50 %.1f us, p99 %.1f us" % (
+        total_sent, total_recv, total_lost, elapsed, total_recv / elapsed,
+        percentile(rtts, 50), percentile(rtts, 99)))
+
+
+if __name__ == "__main__":
+    main()